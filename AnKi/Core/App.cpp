@@ -27,6 +27,7 @@
 #include <AnKi/Script/ScriptManager.h>
 #include <AnKi/Resource/ResourceFilesystem.h>
 #include <AnKi/Resource/AsyncLoader.h>
+#include <AnKi/Resource/TextureStreamer.h>
 #include <AnKi/Core/GpuMemoryPools.h>
 #include <AnKi/Ui/UiManager.h>
 #include <AnKi/Ui/Canvas.h>
@@ -254,6 +255,7 @@ Error App::initInternal(AllocAlignedCallback allocCb, void* allocCbUserData)
 	// ThreadPool
 	//
 	m_threadHive = m_heapAlloc.newInstance<ThreadHive>(m_config->getCoreJobThreadCount(), m_heapAlloc, true);
+	m_threadHive->setDefaultGrainSize(m_config->getCoreJobGrainSize());
 
 	//
 	// Graphics API
@@ -437,6 +439,9 @@ Error App::mainLoop()
 			// Update
 			ANKI_CHECK(m_input->handleEvents());
 
+			// Nothing is rendering at that point so the streamed textures can change
+			m_resources->getTextureStreamer().update();
+
 			// User update
 			ANKI_CHECK(userMainLoop(quit, crntTime - prevUpdateTime));
 
@@ -458,9 +463,7 @@ Error App::mainLoop()
 			);
 			ANKI_CHECK(m_renderer->render(rqueue, presentableTex));
 
-			// Pause and sync async loader. That will force all tasks before the pause to finish in this frame.
-			m_resources->getAsyncLoader().pause();
-
+			// The async loader keeps running. GrManager and the TransferGpuAllocator are thread-safe
 			m_gr->swapBuffers();
 			m_stagingMem->endFrame();
 
@@ -469,9 +472,6 @@ Error App::mainLoop()
 			ANKI_TRACE_INC_COUNTER(RESOURCE_ASYNC_TASKS, asyncTaskCount - m_resourceCompletedAsyncTaskCount);
 			m_resourceCompletedAsyncTaskCount = asyncTaskCount;
 
-			// Now resume the loader
-			m_resources->getAsyncLoader().resume();
-
 			// Sleep
 			const Second endTime = HighRezTimer::getCurrentTime();
 			const Second frameTime = endTime - startTime;
@@ -494,6 +494,8 @@ Error App::mainLoop()
 				statsUi.setPhysicsTime(m_scene->getStats().m_physicsUpdate);
 
 				statsUi.setGpuTime(m_renderer->getStats().m_renderingGpuTime);
+				statsUi.setRenderTargetMemory(m_renderer->getStats().m_renderTargetMemory,
+											  m_renderer->getStats().m_aliasedRenderTargetMemory);
 				if(m_maliHwCounters)
 				{
 					MaliHwCountersOut out;
@@ -511,6 +513,13 @@ Error App::mainLoop()
 				BuddyAllocatorBuilderStats vertMemStats;
 				m_vertexMem->getMemoryStats(vertMemStats);
 				statsUi.setGlobalVertexMemoryPoolStats(vertMemStats);
+				for(StagingGpuMemoryType type = StagingGpuMemoryType::UNIFORM; type < StagingGpuMemoryType::COUNT;
+					++type)
+				{
+					StagingGpuMemoryPoolStats stagingStats;
+					m_stagingMem->getStats(type, stagingStats);
+					statsUi.setStagingGpuMemoryPoolStats(type, stagingStats);
+				}
 
 				statsUi.setDrawableCount(rqueue.countAllRenderables());
 			}
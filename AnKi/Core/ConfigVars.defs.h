@@ -19,6 +19,7 @@ ANKI_CONFIG_VAR_U32(WindowFullscreen, 1, 0, 2, "0: windowed, 1: borderless fulls
 
 ANKI_CONFIG_VAR_U32(CoreTargetFps, 60u, 30u, MAX_U32, "Target FPS")
 ANKI_CONFIG_VAR_U32(CoreJobThreadCount, max(2u, getCpuCoresCount() / 2u), 2u, 1024u, "Number of job thread")
+ANKI_CONFIG_VAR_U32(CoreJobGrainSize, 1u, 1u, 64u * 1024u, "Min number of elements a parallel-for job processes")
 ANKI_CONFIG_VAR_BOOL(CoreDisplayStats, false, "Display stats")
 ANKI_CONFIG_VAR_BOOL(CoreClearCaches, false, "Clear all caches")
 ANKI_CONFIG_VAR_BOOL(CoreVerboseLog, false, "Verbose logging")
@@ -66,20 +66,70 @@ void VertexGpuMemoryPool::free(PtrSize size, PtrSize offset)
 	m_buddyAllocator.free(U32(offset), size, 4);
 }
 
+/// The blocks of the StagingGpuMemoryPool a thread sub-allocates from.
+class StagingGpuMemoryThreadBlocks
+{
+public:
+	class Block
+	{
+	public:
+		const BufferPtr* m_buff = nullptr;
+		U8* m_mappedMem = nullptr;
+		PtrSize m_offset = 0;
+		PtrSize m_end = 0;
+	};
+
+	U32 m_poolUuid = 0;
+	U64 m_frame = MAX_U64;
+	Array<Block, U(StagingGpuMemoryType::COUNT)> m_blocks;
+};
+
+static thread_local StagingGpuMemoryThreadBlocks g_stagingThreadBlocks;
+static Atomic<U32> g_stagingPoolUuid = {1};
+
+static const Array<const char*, U(StagingGpuMemoryType::COUNT)> g_stagingConfigVarNames = {
+	{"CoreUniformPerFrameMemorySize", "CoreStoragePerFrameMemorySize", "CoreVertexPerFrameMemorySize",
+	 "CoreTextureBufferPerFrameMemorySize"}};
+
+/// Release the overflow chunks that haven't been used for that many frames.
+constexpr U64 OVERFLOW_CHUNK_MAX_IDLE_FRAMES = 300;
+
 StagingGpuMemoryPool::~StagingGpuMemoryPool()
 {
 	m_gr->finish();
 
-	for(auto& it : m_perFrameBuffers)
+	for(StagingGpuMemoryType usage = StagingGpuMemoryType::UNIFORM; usage < StagingGpuMemoryType::COUNT; ++usage)
 	{
-		it.m_buff->unmap();
-		it.m_buff.reset(nullptr);
+		PerFrameBuffer& buff = m_perFrameBuffers[usage];
+
+		// Let the user know if the memory is way more than needed. Ignore short runs
+		const PtrSize perFrameSize = buff.m_size / MAX_FRAMES_IN_FLIGHT;
+		if(m_frame > OVERFLOW_CHUNK_MAX_IDLE_FRAMES && buff.m_highWatermark * 4 < perFrameSize)
+		{
+			ANKI_CORE_LOGI(
+				"Staging memory of %s was underutilized (peak %zu out of %zu per frame). Consider setting it "
+				"to %zu",
+				g_stagingConfigVarNames[usage], buff.m_highWatermark, perFrameSize, getSuggestedSize(usage));
+		}
+
+		for(OverflowChunk& chunk : buff.m_overflowChunks)
+		{
+			if(chunk.m_buff)
+			{
+				chunk.m_buff->unmap();
+				chunk.m_buff.reset(nullptr);
+			}
+		}
+
+		buff.m_buff->unmap();
+		buff.m_buff.reset(nullptr);
 	}
 }
 
 Error StagingGpuMemoryPool::init(GrManager* gr, const ConfigSet& cfg)
 {
 	m_gr = gr;
+	m_uuid = g_stagingPoolUuid.fetchAdd(1);
 
 	m_perFrameBuffers[StagingGpuMemoryType::UNIFORM].m_size = cfg.getCoreUniformPerFrameMemorySize();
 	m_perFrameBuffers[StagingGpuMemoryType::STORAGE].m_size = cfg.getCoreStoragePerFrameMemorySize();
@@ -109,42 +159,185 @@ void StagingGpuMemoryPool::initBuffer(StagingGpuMemoryType type, U32 alignment,
 	PerFrameBuffer& perframe = m_perFrameBuffers[type];
 
 	perframe.m_buff = gr.newBuffer(BufferInitInfo(perframe.m_size, usage, BufferMapAccessBit::WRITE, "Staging"));
-	perframe.m_alloc.init(perframe.m_size, alignment, maxAllocSize);
 	perframe.m_mappedMem = static_cast<U8*>(perframe.m_buff->map(0, perframe.m_size, BufferMapAccessBit::WRITE));
+
+	// The thread blocks are bigger than the max allocation size so the allocator shouldn't check it
+	perframe.m_alloc.init(perframe.m_size, alignment);
+
+	perframe.m_alignment = alignment;
+	perframe.m_maxAllocSize = maxAllocSize;
+	perframe.m_usage = usage;
+
+	// Small enough to not waste too much memory when many threads hold a block
+	const PtrSize perFrameSize = perframe.m_size / MAX_FRAMES_IN_FLIGHT;
+	perframe.m_threadBlockSize = getAlignedRoundDown(alignment, min<PtrSize>(64_KB, perFrameSize / 64));
+	perframe.m_threadBlockSize = max<PtrSize>(perframe.m_threadBlockSize, alignment);
 }
 
-void* StagingGpuMemoryPool::allocateFrame(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token)
+Bool StagingGpuMemoryPool::allocateOverflow(PtrSize size, StagingGpuMemoryType usage, SharedAllocation& out)
 {
 	PerFrameBuffer& buff = m_perFrameBuffers[usage];
-	const Error err = buff.m_alloc.allocate(size, token.m_offset);
-	if(err)
+	LockGuard<Mutex> lock(buff.m_overflowMtx);
+
+	OverflowChunk* chunk = nullptr;
+
+	// Try the chunks this frame already uses
+	for(OverflowChunk& c : buff.m_overflowChunks)
 	{
-		ANKI_CORE_LOGF("Out of staging GPU memory. Usage: %u", U32(usage));
+		if(c.m_buff && c.m_lastUsedFrame == m_frame && c.m_offset + size <= c.m_size)
+		{
+			chunk = &c;
+			break;
+		}
 	}
 
-	token.m_buffer = buff.m_buff;
-	token.m_range = size;
-	token.m_type = usage;
+	// Recycle a chunk the GPU is done with
+	if(!chunk)
+	{
+		for(OverflowChunk& c : buff.m_overflowChunks)
+		{
+			if(c.m_buff && c.m_lastUsedFrame + MAX_FRAMES_IN_FLIGHT <= m_frame && size <= c.m_size)
+			{
+				chunk = &c;
+				chunk->m_offset = 0;
+				chunk->m_lastUsedFrame = m_frame;
+				break;
+			}
+		}
+	}
+
+	// Create a new chunk
+	if(!chunk)
+	{
+		for(OverflowChunk& c : buff.m_overflowChunks)
+		{
+			if(!c.m_buff)
+			{
+				chunk = &c;
+				break;
+			}
+		}
+
+		if(!chunk)
+		{
+			return false;
+		}
+
+		// Half the per frame size is a decent guess for a spike
+		chunk->m_size = max(size, getAlignedRoundUp(buff.m_alignment, buff.m_size / (MAX_FRAMES_IN_FLIGHT * 2)));
+		chunk->m_buff =
+			m_gr->newBuffer(BufferInitInfo(chunk->m_size, buff.m_usage, BufferMapAccessBit::WRITE, "Staging overflow"));
+		chunk->m_mappedMem = static_cast<U8*>(chunk->m_buff->map(0, chunk->m_size, BufferMapAccessBit::WRITE));
+		chunk->m_offset = 0;
+		chunk->m_lastUsedFrame = m_frame;
+
+		ANKI_CORE_LOGI("Created staging overflow chunk of %zu bytes for %s", chunk->m_size,
+					   g_stagingConfigVarNames[usage]);
+	}
 
-	return buff.m_mappedMem + token.m_offset;
+	out.m_buff = &chunk->m_buff;
+	out.m_mappedMem = chunk->m_mappedMem;
+	out.m_offset = chunk->m_offset;
+	chunk->m_offset += size;
+
+	return true;
 }
 
-void* StagingGpuMemoryPool::tryAllocateFrame(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token)
+Bool StagingGpuMemoryPool::allocateShared(PtrSize size, StagingGpuMemoryType usage, SharedAllocation& out)
 {
 	PerFrameBuffer& buff = m_perFrameBuffers[usage];
-	const Error err = buff.m_alloc.allocate(size, token.m_offset);
+
+	PtrSize offset;
+	const Error err = buff.m_alloc.allocate(size, offset);
 	if(!err)
 	{
-		token.m_buffer = buff.m_buff;
-		token.m_range = size;
-		token.m_type = usage;
-		return buff.m_mappedMem + token.m_offset;
+		out.m_buff = &buff.m_buff;
+		out.m_mappedMem = buff.m_mappedMem;
+		out.m_offset = offset;
 	}
-	else
+	else if(!allocateOverflow(size, usage, out))
+	{
+		return false;
+	}
+
+	buff.m_frameUsedSize.fetchAdd(size);
+	return true;
+}
+
+void* StagingGpuMemoryPool::allocateInternal(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token)
+{
+	PerFrameBuffer& buff = m_perFrameBuffers[usage];
+	ANKI_ASSERT(buff.m_mappedMem && size > 0);
+	ANKI_ASSERT(size <= buff.m_maxAllocSize && "Too high!");
+
+	const PtrSize alignedSize = getAlignedRoundUp(buff.m_alignment, size);
+
+	SharedAllocation alloc;
+	if(alignedSize <= buff.m_threadBlockSize / 4)
+	{
+		// Small allocation, sub-allocate from the block of this thread
+		StagingGpuMemoryThreadBlocks& tls = g_stagingThreadBlocks;
+		if(tls.m_poolUuid != m_uuid || tls.m_frame != m_frame)
+		{
+			tls = {};
+			tls.m_poolUuid = m_uuid;
+			tls.m_frame = m_frame;
+		}
+
+		StagingGpuMemoryThreadBlocks::Block& block = tls.m_blocks[usage];
+		if(block.m_offset + alignedSize > block.m_end)
+		{
+			SharedAllocation blockAlloc;
+			if(!allocateShared(buff.m_threadBlockSize, usage, blockAlloc))
+			{
+				return nullptr;
+			}
+
+			block.m_buff = blockAlloc.m_buff;
+			block.m_mappedMem = blockAlloc.m_mappedMem;
+			block.m_offset = blockAlloc.m_offset;
+			block.m_end = blockAlloc.m_offset + buff.m_threadBlockSize;
+		}
+
+		alloc.m_buff = block.m_buff;
+		alloc.m_mappedMem = block.m_mappedMem;
+		alloc.m_offset = block.m_offset;
+		block.m_offset += alignedSize;
+	}
+	else if(!allocateShared(alignedSize, usage, alloc))
 	{
-		token = {};
 		return nullptr;
 	}
+
+	ANKI_ASSERT(isAligned(buff.m_alignment, alloc.m_offset));
+	token.m_buffer = *alloc.m_buff;
+	token.m_offset = alloc.m_offset;
+	token.m_range = size;
+	token.m_type = usage;
+
+	return alloc.m_mappedMem + alloc.m_offset;
+}
+
+void* StagingGpuMemoryPool::allocateFrame(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token)
+{
+	void* out = allocateInternal(size, usage, token);
+	if(ANKI_UNLIKELY(out == nullptr))
+	{
+		ANKI_CORE_LOGF("Out of staging GPU memory. Usage: %u", U32(usage));
+	}
+
+	return out;
+}
+
+void* StagingGpuMemoryPool::tryAllocateFrame(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token)
+{
+	void* out = allocateInternal(size, usage, token);
+	if(out == nullptr)
+	{
+		token = {};
+	}
+
+	return out;
 }
 
 void StagingGpuMemoryPool::endFrame()
@@ -169,8 +362,64 @@ void StagingGpuMemoryPool::endFrame()
 			}
 
 			buff.m_alloc.endFrame();
+
+			// Telemetry
+			const PtrSize usedSize = buff.m_frameUsedSize.exchange(0);
+			buff.m_lastFrameUsedSize = usedSize;
+			buff.m_highWatermark = max(buff.m_highWatermark, usedSize);
+
+			const PtrSize perFrameSize = buff.m_size / MAX_FRAMES_IN_FLIGHT;
+			if(usedSize > perFrameSize && !buff.m_overflowReported)
+			{
+				buff.m_overflowReported = true;
+				ANKI_CORE_LOGW("Staging memory of %s overflowed (%zu needed, %zu per frame available). Consider "
+							   "setting it to %zu",
+							   g_stagingConfigVarNames[usage], usedSize, perFrameSize, getSuggestedSize(usage));
+			}
+
+			// Release the overflow chunks that are not needed any more. The GPU is done with them
+			for(OverflowChunk& chunk : buff.m_overflowChunks)
+			{
+				if(chunk.m_buff && chunk.m_lastUsedFrame + OVERFLOW_CHUNK_MAX_IDLE_FRAMES < m_frame)
+				{
+					chunk.m_buff->unmap();
+					chunk.m_buff.reset(nullptr);
+					chunk.m_mappedMem = nullptr;
+					chunk.m_size = 0;
+					chunk.m_offset = 0;
+				}
+			}
 		}
 	}
+
+	++m_frame;
+}
+
+void StagingGpuMemoryPool::getStats(StagingGpuMemoryType usage, StagingGpuMemoryPoolStats& stats) const
+{
+	const PerFrameBuffer& buff = m_perFrameBuffers[usage];
+
+	stats.m_perFrameSize = buff.m_size / MAX_FRAMES_IN_FLIGHT;
+	stats.m_lastFrameUsedSize = buff.m_lastFrameUsedSize;
+	stats.m_highWatermark = buff.m_highWatermark;
+	stats.m_overflowMemorySize = 0;
+	stats.m_overflowChunkCount = 0;
+	for(const OverflowChunk& chunk : buff.m_overflowChunks)
+	{
+		if(chunk.m_buff)
+		{
+			stats.m_overflowMemorySize += chunk.m_size;
+			++stats.m_overflowChunkCount;
+		}
+	}
+}
+
+PtrSize StagingGpuMemoryPool::getSuggestedSize(StagingGpuMemoryType usage) const
+{
+	// The config var covers all the frames in flight. Add some headroom on top
+	const PtrSize highWatermark = m_perFrameBuffers[usage].m_highWatermark;
+	const PtrSize size = (highWatermark + highWatermark / 4) * MAX_FRAMES_IN_FLIGHT;
+	return max<PtrSize>(getAlignedRoundUp(1_MB, size), 1_MB);
 }
 
 } // end namespace anki
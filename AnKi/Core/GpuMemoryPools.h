@@ -9,6 +9,7 @@
 #include <AnKi/Gr/Buffer.h>
 #include <AnKi/Gr/Utils/FrameGpuAllocator.h>
 #include <AnKi/Util/BuddyAllocatorBuilder.h>
+#include <AnKi/Util/Thread.h>
 
 namespace anki {
 
@@ -91,7 +92,20 @@ public:
 	}
 };
 
-/// Manages staging GPU memory.
+/// Staging memory statistics of a single StagingGpuMemoryType.
+class StagingGpuMemoryPoolStats
+{
+public:
+	PtrSize m_perFrameSize = 0; ///< The part of the ring buffer that is available to a single frame.
+	PtrSize m_lastFrameUsedSize = 0; ///< The memory the last frame used, overflow included.
+	PtrSize m_highWatermark = 0; ///< The most memory a single frame ever used, overflow included.
+	PtrSize m_overflowMemorySize = 0; ///< The memory of the overflow chunks that are alive.
+	U32 m_overflowChunkCount = 0;
+};
+
+/// Manages staging GPU memory. Every type has a ring buffer that is split to MAX_FRAMES_IN_FLIGHT parts. The threads
+/// grab small blocks from the ring buffer and sub-allocate from them without touching any shared state. If the ring
+/// buffer runs out the pool will create overflow chunks to cover the spike.
 class StagingGpuMemoryPool
 {
 public:
@@ -109,13 +123,33 @@ public:
 
 	/// Allocate staging memory for various operations. The memory will be reclaimed at the begining of the
 	/// N-(MAX_FRAMES_IN_FLIGHT-1) frame.
+	/// @note Thread-safe.
 	void* allocateFrame(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token);
 
 	/// Allocate staging memory for various operations. The memory will be reclaimed at the begining of the
 	/// N-(MAX_FRAMES_IN_FLIGHT-1) frame.
+	/// @note Thread-safe.
 	void* tryAllocateFrame(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token);
 
+	void getStats(StagingGpuMemoryType usage, StagingGpuMemoryPoolStats& stats) const;
+
+	/// Get a value for the config var of that type that would have covered the worst frame so far without overflowing.
+	PtrSize getSuggestedSize(StagingGpuMemoryType usage) const;
+
 private:
+	static constexpr U32 MAX_OVERFLOW_CHUNKS = 8;
+
+	/// Memory that gets created when the ring buffer is not enough.
+	class OverflowChunk
+	{
+	public:
+		BufferPtr m_buff;
+		U8* m_mappedMem = nullptr;
+		PtrSize m_size = 0;
+		PtrSize m_offset = 0;
+		U64 m_lastUsedFrame = 0;
+	};
+
 	class PerFrameBuffer
 	{
 	public:
@@ -123,13 +157,43 @@ private:
 		BufferPtr m_buff;
 		U8* m_mappedMem = nullptr; ///< Cache it
 		FrameGpuAllocator m_alloc;
+
+		U32 m_alignment = 0;
+		PtrSize m_maxAllocSize = 0;
+		PtrSize m_threadBlockSize = 0; ///< The size of the blocks the threads sub-allocate from.
+		BufferUsageBit m_usage = BufferUsageBit::NONE;
+
+		Array<OverflowChunk, MAX_OVERFLOW_CHUNKS> m_overflowChunks;
+		Mutex m_overflowMtx;
+
+		Atomic<PtrSize> m_frameUsedSize = {0}; ///< Memory taken from the ring buffer or the overflow chunks.
+		PtrSize m_lastFrameUsedSize = 0;
+		PtrSize m_highWatermark = 0;
+		Bool m_overflowReported = false;
+	};
+
+	/// Memory that was taken from the shared ring buffer or an overflow chunk.
+	class SharedAllocation
+	{
+	public:
+		const BufferPtr* m_buff = nullptr;
+		U8* m_mappedMem = nullptr;
+		PtrSize m_offset = 0;
 	};
 
 	GrManager* m_gr = nullptr;
 	Array<PerFrameBuffer, U(StagingGpuMemoryType::COUNT)> m_perFrameBuffers;
+	U64 m_frame = 0;
+	U32 m_uuid = 0; ///< Unique per pool. It's used to invalidate the thread local blocks of dead pools.
 
 	void initBuffer(StagingGpuMemoryType type, U32 alignment, PtrSize maxAllocSize, BufferUsageBit usage,
 					GrManager& gr);
+
+	void* allocateInternal(PtrSize size, StagingGpuMemoryType usage, StagingGpuMemoryToken& token);
+
+	Bool allocateShared(PtrSize size, StagingGpuMemoryType usage, SharedAllocation& out);
+
+	Bool allocateOverflow(PtrSize size, StagingGpuMemoryType usage, SharedAllocation& out);
 };
 /// @}
 
@@ -110,8 +110,22 @@ void StatsUi::build(CanvasPtr canvas)
 		labelBytes(m_grStats.m_deviceMemoryAllocated, "Device");
 		labelBytes(m_grStats.m_deviceMemoryInUse, "Device in use");
 		labelUint(m_grStats.m_deviceMemoryAllocationCount, "Device allocations");
+		labelBytes(m_grStats.m_deviceMemoryUsage, "Device usage");
+		labelBytes(m_grStats.m_deviceMemoryBudget, "Device budget");
 		labelBytes(m_globalVertexPoolStats.m_userAllocatedSize, "Vertex/Index GPU memory");
 		labelBytes(m_globalVertexPoolStats.m_realAllocatedSize, "Actual Vertex/Index GPU memory");
+		labelBytes(m_stagingPoolStats[StagingGpuMemoryType::UNIFORM].m_highWatermark, "Staging uniforms peak");
+		labelBytes(m_stagingPoolStats[StagingGpuMemoryType::STORAGE].m_highWatermark, "Staging storage peak");
+		labelBytes(m_stagingPoolStats[StagingGpuMemoryType::VERTEX].m_highWatermark, "Staging vertex peak");
+		labelBytes(m_stagingPoolStats[StagingGpuMemoryType::TEXTURE].m_highWatermark, "Staging texture peak");
+		PtrSize stagingOverflowMem = 0;
+		for(const StagingGpuMemoryPoolStats& stats : m_stagingPoolStats)
+		{
+			stagingOverflowMem += stats.m_overflowMemorySize;
+		}
+		labelBytes(stagingOverflowMem, "Staging overflow");
+		labelBytes(m_renderTargetMem, "Render targets");
+		labelBytes(m_aliasedRenderTargetMem, "Render targets saved by aliasing");
 
 		ImGui::Text("----");
 		ImGui::Text("Vulkan:");
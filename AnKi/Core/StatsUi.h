@@ -6,6 +6,7 @@
 #pragma once
 
 #include <AnKi/Core/Common.h>
+#include <AnKi/Core/GpuMemoryPools.h>
 #include <AnKi/Ui/UiImmediateModeBuilder.h>
 #include <AnKi/Util/BuddyAllocatorBuilder.h>
 #include <AnKi/Gr/GrManager.h>
@@ -105,6 +106,17 @@ public:
 		m_globalVertexPoolStats = stats;
 	}
 
+	void setStagingGpuMemoryPoolStats(StagingGpuMemoryType type, const StagingGpuMemoryPoolStats& stats)
+	{
+		m_stagingPoolStats[type] = stats;
+	}
+
+	void setRenderTargetMemory(PtrSize total, PtrSize aliased)
+	{
+		m_renderTargetMem = total;
+		m_aliasedRenderTargetMem = aliased;
+	}
+
 private:
 	static constexpr U32 BUFFERED_FRAMES = 16;
 
@@ -154,6 +166,9 @@ private:
 	U64 m_allocCount = 0;
 	U64 m_freeCount = 0;
 	BuddyAllocatorBuilderStats m_globalVertexPoolStats = {};
+	Array<StagingGpuMemoryPoolStats, U(StagingGpuMemoryType::COUNT)> m_stagingPoolStats;
+	PtrSize m_renderTargetMem = 0;
+	PtrSize m_aliasedRenderTargetMem = 0;
 
 	// GR
 	GrManagerStats m_grStats = {};
@@ -325,6 +325,17 @@ public:
 
 	void drawArraysIndirect(PrimitiveTopology topology, U32 drawCount, PtrSize offset, const BufferPtr& indirectBuff);
 
+	/// Same as drawElementsIndirect but the number of drawcalls is read from a U32 in countBuff. The drawcalls that
+	/// will be executed are min(countBuff[countBuffOffset], maxDrawCount).
+	/// @note Requires GpuDeviceCapabilities::m_drawIndirectCount.
+	void drawElementsIndirectCount(PrimitiveTopology topology, U32 maxDrawCount, PtrSize offset,
+								   const BufferPtr& indirectBuff, PtrSize countBuffOffset, const BufferPtr& countBuff);
+
+	/// Same as drawArraysIndirect but the number of drawcalls is read from a U32 in countBuff.
+	/// @note Requires GpuDeviceCapabilities::m_drawIndirectCount.
+	void drawArraysIndirectCount(PrimitiveTopology topology, U32 maxDrawCount, PtrSize offset,
+								 const BufferPtr& indirectBuff, PtrSize countBuffOffset, const BufferPtr& countBuff);
+
 	void dispatchCompute(U32 groupCountX, U32 groupCountY, U32 groupCountZ);
 
 	/// Trace rays.
@@ -386,6 +397,13 @@ public:
 	/// @param texView The texture view that points to a surface or volume to write to.
 	void copyBufferToTextureView(const BufferPtr& buff, PtrSize offset, PtrSize range, const TextureViewPtr& texView);
 
+	/// Copy a surface or a volume to another surface or volume of the same size and format.
+	/// @param srcView The texture view that points to a surface or volume to read from. Its texture should be in
+	///                TRANSFER_SOURCE usage.
+	/// @param dstView The texture view that points to a surface or volume to write to. Its texture should be in
+	///                TRANSFER_DESTINATION usage.
+	void copyTextureViewToTextureView(const TextureViewPtr& srcView, const TextureViewPtr& dstView);
+
 	/// Fill a buffer with some value.
 	/// @param[in,out] buff The buffer to fill.
 	/// @param offset From where to start filling. Must be multiple of 4.
@@ -422,9 +440,12 @@ public:
 	/// @param[in] jitterOffset Jittering offset that was applied during the generation of sourceTexture
 	/// @param[in] motionVectorsScale Any scale factor that might need to be applied to the motionVectorsTexture (i.e UV
 	///                               space to Pixel space conversion)
+	/// @param[in] renderSize The size of the top left part of the inputs that was rendered. Zero means the whole
+	///                       inColor.
 	void upscale(const GrUpscalerPtr& upscaler, const TextureViewPtr& inColor, const TextureViewPtr& outUpscaledColor,
 				 const TextureViewPtr& motionVectors, const TextureViewPtr& depth, const TextureViewPtr& exposure,
-				 const Bool resetAccumulation, const Vec2& jitterOffset, const Vec2& motionVectorsScale);
+				 const Bool resetAccumulation, const Vec2& jitterOffset, const Vec2& motionVectorsScale,
+				 const UVec2& renderSize = UVec2(0u));
 
 	/// @}
 
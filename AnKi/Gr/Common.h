@@ -186,6 +186,12 @@ public:
 
 	/// DLSS.
 	Bool m_dlss = false;
+
+	/// Has a compute queue that runs in parallel with the graphics queue.
+	Bool m_asyncCompute = false;
+
+	/// Supports drawcalls that read their count from a buffer and indirect drawcalls with a non-zero baseInstance.
+	Bool m_drawIndirectCount = false;
 };
 ANKI_END_PACKED_STRUCT
 
@@ -193,6 +199,10 @@ ANKI_END_PACKED_STRUCT
 template<typename T>
 using GrAllocator = HeapAllocator<T>;
 
+/// Called when the device memory gets close to its budget.
+/// @param bytesToFree How much memory should be released to get out of the danger zone.
+using GrMemoryPressureCallback = void (*)(PtrSize bytesToFree, void* userData);
+
 /// Clear values for textures or attachments.
 class ClearValue
 {
@@ -12,11 +12,17 @@ ANKI_CONFIG_VAR_BOOL(GrVsync, false, "Enable or not vsync")
 
 ANKI_CONFIG_VAR_PTR_SIZE(GrDiskShaderCacheMaxSize, 128_MB, 1_MB, 1_GB, "Max size of the pipeline cache file")
 
+ANKI_CONFIG_VAR_U32(GrPipelinePrecompileThreadCount, 2, 0, 16,
+					"Threads that create the pipelines of the pipeline manifest in the background. 0 disables it")
+
 ANKI_CONFIG_VAR_BOOL(GrRayTracing, false, "Try enabling ray tracing")
 ANKI_CONFIG_VAR_BOOL(Gr64bitAtomics, true, "Enable or not 64bit atomics")
 ANKI_CONFIG_VAR_BOOL(GrSamplerFilterMinMax, true, "Enable or not min/max sample filtering")
 ANKI_CONFIG_VAR_BOOL(GrVrs, false, "Enable or not VRS")
 ANKI_CONFIG_VAR_BOOL(GrAsyncCompute, true, "Enable or not async compute")
+ANKI_CONFIG_VAR_BOOL(GrRenderGraphAliasing, true, "Share textures between render targets with disjoint lifetimes")
+ANKI_CONFIG_VAR_U32(GrRenderGraphRecordingThreadCount, 8, 1, 64,
+					"Split the passes of the RenderGraph to that many command buffers that are recorded in parallel")
 
 ANKI_CONFIG_VAR_U8(GrVkMinor, 1, 1, 1, "Vulkan minor version")
 ANKI_CONFIG_VAR_U8(GrVkMajor, 1, 1, 1, "Vulkan major version")
@@ -220,10 +220,11 @@ enum class TextureUsageBit : U32
 	FRAMEBUFFER_ATTACHMENT_WRITE = 1 << 13,
 	FRAMEBUFFER_SHADING_RATE = 1 << 14,
 
-	TRANSFER_DESTINATION = 1 << 15,
-	GENERATE_MIPMAPS = 1 << 16,
+	TRANSFER_SOURCE = 1 << 15,
+	TRANSFER_DESTINATION = 1 << 16,
+	GENERATE_MIPMAPS = 1 << 17,
 
-	PRESENT = 1 << 17,
+	PRESENT = 1 << 18,
 
 	// Derived
 	ALL_SAMPLED = SAMPLED_GEOMETRY | SAMPLED_FRAGMENT | SAMPLED_COMPUTE | SAMPLED_TRACE_RAYS,
@@ -235,10 +236,10 @@ enum class TextureUsageBit : U32
 				   | IMAGE_FRAGMENT_READ | IMAGE_FRAGMENT_WRITE | FRAMEBUFFER_ATTACHMENT_READ
 				   | FRAMEBUFFER_ATTACHMENT_WRITE | FRAMEBUFFER_SHADING_RATE,
 	ALL_COMPUTE = SAMPLED_COMPUTE | IMAGE_COMPUTE_READ | IMAGE_COMPUTE_WRITE,
-	ALL_TRANSFER = TRANSFER_DESTINATION | GENERATE_MIPMAPS,
+	ALL_TRANSFER = TRANSFER_SOURCE | TRANSFER_DESTINATION | GENERATE_MIPMAPS,
 
 	ALL_READ = ALL_SAMPLED | IMAGE_GEOMETRY_READ | IMAGE_FRAGMENT_READ | IMAGE_COMPUTE_READ | IMAGE_TRACE_RAYS_READ
-			   | FRAMEBUFFER_ATTACHMENT_READ | FRAMEBUFFER_SHADING_RATE | PRESENT | GENERATE_MIPMAPS,
+			   | FRAMEBUFFER_ATTACHMENT_READ | FRAMEBUFFER_SHADING_RATE | PRESENT | GENERATE_MIPMAPS | TRANSFER_SOURCE,
 	ALL_WRITE = IMAGE_GEOMETRY_WRITE | IMAGE_FRAGMENT_WRITE | IMAGE_COMPUTE_WRITE | IMAGE_TRACE_RAYS_WRITE
 				| FRAMEBUFFER_ATTACHMENT_WRITE | TRANSFER_DESTINATION | GENERATE_MIPMAPS,
 
@@ -449,6 +450,8 @@ enum class BufferUsageBit : U64
 	ACCELERATION_STRUCTURE_BUILD = 1ull << 27ull, ///< Will be used as a position or index buffer in a BLAS build.
 	SBT = 1ull << 28ull, ///< Will be used as SBT in a traceRays() command.
 
+	HOST_READ = 1ull << 29ull, ///< The CPU will map and read it. Use it in a barrier after the GPU writes the buffer.
+
 	// Derived
 	ALL_UNIFORM = UNIFORM_GEOMETRY | UNIFORM_FRAGMENT | UNIFORM_COMPUTE | UNIFORM_TRACE_RAYS,
 	ALL_STORAGE = STORAGE_GEOMETRY_READ | STORAGE_GEOMETRY_WRITE | STORAGE_FRAGMENT_READ | STORAGE_FRAGMENT_WRITE
@@ -472,7 +475,7 @@ enum class BufferUsageBit : U64
 	ALL_READ = ALL_UNIFORM | STORAGE_GEOMETRY_READ | STORAGE_FRAGMENT_READ | STORAGE_COMPUTE_READ
 			   | STORAGE_TRACE_RAYS_READ | TEXTURE_GEOMETRY_READ | TEXTURE_FRAGMENT_READ | TEXTURE_COMPUTE_READ
 			   | TEXTURE_TRACE_RAYS_READ | INDEX | VERTEX | INDIRECT_COMPUTE | INDIRECT_DRAW | INDIRECT_TRACE_RAYS
-			   | TRANSFER_SOURCE | ACCELERATION_STRUCTURE_BUILD | SBT,
+			   | TRANSFER_SOURCE | ACCELERATION_STRUCTURE_BUILD | SBT | HOST_READ,
 	ALL_WRITE = STORAGE_GEOMETRY_WRITE | STORAGE_FRAGMENT_WRITE | STORAGE_COMPUTE_WRITE | STORAGE_TRACE_RAYS_WRITE
 				| TEXTURE_GEOMETRY_WRITE | TEXTURE_FRAGMENT_WRITE | TEXTURE_COMPUTE_WRITE | TEXTURE_TRACE_RAYS_WRITE
 				| TRANSFER_DESTINATION,
@@ -41,10 +41,22 @@ public:
 	PtrSize m_hostMemoryAllocated = 0;
 	PtrSize m_hostMemoryInUse = 0;
 	U32 m_hostMemoryAllocationCount = 0;
+	PtrSize m_deviceMemoryBudget = 0;
+	PtrSize m_deviceMemoryUsage = 0; ///< Might include the memory of other processes.
+	U32 m_evacuatingMemoryChunkCount = 0;
 
 	U32 m_commandBufferCount = 0;
 };
 
+/// Progress of the background creation of the pipelines that the previous runs came across.
+class PipelinePrecompileProgress
+{
+public:
+	U32 m_manifestPipelineCount = 0; ///< All the pipelines of the manifest.
+	U32 m_queuedPipelineCount = 0; ///< The pipelines whose programs have been created so far.
+	U32 m_createdPipelineCount = 0; ///< When it reaches m_queuedPipelineCount there is nothing left to do.
+};
+
 /// The graphics manager, owner of all graphics objects.
 class GrManager
 {
@@ -89,6 +101,14 @@ public:
 
 	GrManagerStats getStats() const;
 
+	/// Use it to hold the loading screen until the pipelines are ready.
+	/// @note Thread-safe.
+	PipelinePrecompileProgress getPipelinePrecompileProgress() const;
+
+	/// Set a callback that will be called from swapBuffers() when the device memory gets close to its budget. The
+	/// callback should be cheap, it's better to defer the actual work.
+	void setMemoryPressureCallback(GrMemoryPressureCallback callback, void* userData);
+
 	ANKI_INTERNAL GrAllocator<U8>& getAllocator()
 	{
 		return m_alloc;
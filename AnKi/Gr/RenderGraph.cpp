@@ -9,6 +9,8 @@
 #include <AnKi/Gr/Sampler.h>
 #include <AnKi/Gr/Framebuffer.h>
 #include <AnKi/Gr/CommandBuffer.h>
+#include <AnKi/Gr/Fence.h>
+#include <AnKi/Core/ConfigSet.h>
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Util/BitSet.h>
 #include <AnKi/Util/File.h>
@@ -24,6 +26,24 @@ static inline U32 getTextureSurfOrVolCount(const TexturePtr& tex)
 	return tex->getMipmapCount() * tex->getLayerCount() * (textureTypeIsCube(tex->getTextureType()) ? 6 : 1);
 }
 
+/// An estimation of the memory a render target needs. Doesn't take into account alignment and compression.
+static PtrSize computeRenderTargetMemorySize(const TextureInitInfo& init)
+{
+	const FormatInfo formatInfo = getFormatInfo(init.m_format);
+	const PtrSize faceCount = textureTypeIsCube(init.m_type) ? 6 : 1;
+
+	PtrSize size = 0;
+	for(U32 mip = 0; mip < init.m_mipmapCount; ++mip)
+	{
+		const PtrSize width = max(init.m_width >> mip, 1u);
+		const PtrSize height = max(init.m_height >> mip, 1u);
+		const PtrSize depth = (init.m_type == TextureType::_3D) ? max(init.m_depth >> mip, 1u) : 1;
+		size += width * height * depth * formatInfo.m_texelSize;
+	}
+
+	return size * faceCount * init.m_layerCount * max<PtrSize>(init.m_samples, 1);
+}
+
 /// Contains some extra things for render targets.
 class RenderGraph::RT
 {
@@ -31,6 +51,11 @@ public:
 	DynamicArray<TextureUsageBit> m_surfOrVolUsages;
 	DynamicArray<U16> m_lastBatchThatTransitionedIt;
 	TexturePtr m_texture; ///< Hold a reference.
+	U32 m_aliasedRtIdx = MAX_U32; ///< The RT that used the same texture before this one in the same frame.
+	U16 m_firstBatch = MAX_U16; ///< The first batch that uses the RT.
+	U16 m_lastBatch = 0; ///< The last batch that uses the RT.
+	Bool m_usedByGeneralQueue = false;
+	Bool m_usedByAsyncQueue = false;
 	Bool m_imported;
 };
 
@@ -120,8 +145,12 @@ public:
 	TextureUsageBit m_dsUsage = TextureUsageBit::NONE; ///< For beginRender pass
 
 	U32 m_batchIdx ANKI_DEBUG_CODE(= MAX_U32);
+	U32 m_cmdbIdx ANKI_DEBUG_CODE(= MAX_U32);
 	Bool m_drawsToPresentable = false;
 
+	Second m_cpuTime = 0.0;
+	DynamicArray<Second> m_secondLevelCpuTimes; ///< One per 2nd level cmdb since they are recorded in parallel.
+
 	FramebufferPtr& fb()
 	{
 		return m_secondLevelCmdbInitInfo.m_framebuffer;
@@ -142,7 +171,7 @@ public:
 	DynamicArray<TextureBarrier> m_textureBarriersBefore;
 	DynamicArray<BufferBarrier> m_bufferBarriersBefore;
 	DynamicArray<ASBarrier> m_asBarriersBefore;
-	CommandBuffer* m_cmdb; ///< Someone else holds the ref already so have a ptr here.
+	Bool m_async = false; ///< Runs in the async compute queue.
 };
 
 /// The RenderGraph build context.
@@ -157,10 +186,30 @@ public:
 	DynamicArray<Buffer> m_buffers;
 	DynamicArray<AS> m_as;
 
-	DynamicArray<CommandBufferPtr> m_graphicsCmdbs;
+	/// A 1st level command buffer of the graph. It contains a range of the passes of a queue. The passes are in the
+	/// order of the batches.
+	class Cmdb
+	{
+	public:
+		CommandBufferPtr m_cmdb; ///< Created by the thread that records it.
+		FencePtr m_signalFence;
+		U32 m_firstBatch = MAX_U32;
+		U32 m_firstPass = MAX_U32; ///< Index in the m_passIndices of the m_firstBatch.
+		U32 m_passCount = 0;
+		U32 m_waitCmdbIdx = MAX_U32; ///< Wait for that cmdb of the other queue before starting.
+		Bool m_signal = false; ///< Some cmdb of the other queue waits for this one.
+		Bool m_async = false;
+		Bool m_writeStartTimestamp = false;
+	};
+
+	DynamicArray<Cmdb> m_cmdbs; ///< In the order they will be flushed.
+	TimestampQueryPtr m_startTimestamp;
 
 	Bool m_gatherStatistics = false;
 
+	PtrSize m_renderTargetMemory = 0;
+	PtrSize m_aliasedRenderTargetMemory = 0;
+
 	BakeContext(const StackAllocator<U8>& alloc)
 		: m_alloc(alloc)
 	{
@@ -277,6 +326,14 @@ RenderGraph::~RenderGraph()
 
 	m_fbCache.destroy(getAllocator());
 
+	for(GraphStructureCacheEntry& entry : m_graphStructureCache)
+	{
+		entry.m_passBatchIndices.destroy(getAllocator());
+	}
+	m_graphStructureCache.destroy(getAllocator());
+
+	m_statistics.m_passes.destroy(getAllocator());
+
 	for(auto& it : m_importedRenderTargets)
 	{
 		it.m_surfOrVolLastUsages.destroy(getAllocator());
@@ -359,10 +416,12 @@ void RenderGraph::reset()
 	{
 		p.fb().reset(nullptr);
 		p.m_secondLevelCmdbs.destroy(m_ctx->m_alloc);
+		p.m_secondLevelCpuTimes.destroy(m_ctx->m_alloc);
 		p.m_callback.destroy(m_ctx->m_alloc);
 	}
 
-	m_ctx->m_graphicsCmdbs.destroy(m_ctx->m_alloc);
+	m_ctx->m_cmdbs.destroy(m_ctx->m_alloc);
+	m_ctx->m_startTimestamp.reset(nullptr);
 
 	m_ctx->m_alloc = StackAllocator<U8>();
 	m_ctx = nullptr;
@@ -415,26 +474,18 @@ TexturePtr RenderGraph::getOrCreateRenderTarget(const TextureInitInfo& initInf,
 }
 
 FramebufferPtr RenderGraph::getOrCreateFramebuffer(const FramebufferDescription& fbDescr,
-												   const RenderTargetHandle* rtHandles, CString name,
-												   Bool& drawsToPresentable)
+												   const RenderTargetHandle* rtHandles, CString name)
 {
 	ANKI_ASSERT(rtHandles);
 	U64 hash = fbDescr.m_hash;
 	ANKI_ASSERT(hash > 0);
 
-	drawsToPresentable = false;
-
 	// Create a hash that includes the render targets
 	Array<U64, MAX_COLOR_ATTACHMENTS + 2> uuids;
 	U count = 0;
 	for(U i = 0; i < fbDescr.m_colorAttachmentCount; ++i)
 	{
 		uuids[count++] = m_ctx->m_rts[rtHandles[i].m_idx].m_texture->getUuid();
-
-		if(!!(m_ctx->m_rts[rtHandles[i].m_idx].m_texture->getTextureUsage() & TextureUsageBit::PRESENT))
-		{
-			drawsToPresentable = true;
-		}
 	}
 
 	if(!!fbDescr.m_depthStencilAttachment.m_aspect)
@@ -692,66 +743,18 @@ RenderGraph::BakeContext* RenderGraph::newContext(const RenderGraphDescription&
 	// Allocate
 	BakeContext* ctx = alloc.newInstance<BakeContext>(alloc);
 
-	// Init the resources
+	// Init the resources. The transient render targets will get a texture after the batches are known
 	ctx->m_rts.create(alloc, descr.m_renderTargets.getSize());
 	for(U32 rtIdx = 0; rtIdx < ctx->m_rts.getSize(); ++rtIdx)
 	{
 		RT& outRt = ctx->m_rts[rtIdx];
 		const RenderGraphDescription::RT& inRt = descr.m_renderTargets[rtIdx];
 
-		const Bool imported = inRt.m_importedTex.isCreated();
-		if(imported)
+		outRt.m_imported = inRt.m_importedTex.isCreated();
+		if(outRt.m_imported)
 		{
-			// It's imported
 			outRt.m_texture = inRt.m_importedTex;
 		}
-		else
-		{
-			// Need to create new
-
-			// Create a new TextureInitInfo with the derived usage
-			TextureInitInfo initInf = inRt.m_initInfo;
-			initInf.m_usage = inRt.m_usageDerivedByDeps;
-			ANKI_ASSERT(initInf.m_usage != TextureUsageBit::NONE && "Probably not referenced by any pass");
-
-			// Create the new hash
-			const U64 hash = appendHash(&initInf.m_usage, sizeof(initInf.m_usage), inRt.m_hash);
-
-			// Get or create the texture
-			outRt.m_texture = getOrCreateRenderTarget(initInf, hash);
-		}
-
-		// Init the usage
-		const U32 surfOrVolumeCount = getTextureSurfOrVolCount(outRt.m_texture);
-		outRt.m_surfOrVolUsages.create(alloc, surfOrVolumeCount, TextureUsageBit::NONE);
-		if(imported && inRt.m_importedAndUndefinedUsage)
-		{
-			// Get the usage from previous frames
-
-			// Create a new hash because our hash map dislikes concurent keys.
-			const U64 uuid = outRt.m_texture->getUuid();
-			const U64 hash = computeHash(&uuid, sizeof(uuid));
-
-			auto it = m_importedRenderTargets.find(hash);
-			ANKI_ASSERT(it != m_importedRenderTargets.getEnd() && "Can't find the imported RT");
-
-			ANKI_ASSERT(it->m_surfOrVolLastUsages.getSize() == surfOrVolumeCount);
-			for(U32 surfOrVolIdx = 0; surfOrVolIdx < surfOrVolumeCount; ++surfOrVolIdx)
-			{
-				outRt.m_surfOrVolUsages[surfOrVolIdx] = it->m_surfOrVolLastUsages[surfOrVolIdx];
-			}
-		}
-		else if(imported)
-		{
-			// Set the usage that was given by the user
-			for(U32 surfOrVolIdx = 0; surfOrVolIdx < surfOrVolumeCount; ++surfOrVolIdx)
-			{
-				outRt.m_surfOrVolUsages[surfOrVolIdx] = inRt.m_importedLastKnownUsage;
-			}
-		}
-
-		outRt.m_lastBatchThatTransitionedIt.create(alloc, surfOrVolumeCount, MAX_U16);
-		outRt.m_imported = imported;
 	}
 
 	// Buffers
@@ -779,7 +782,8 @@ RenderGraph::BakeContext* RenderGraph::newContext(const RenderGraphDescription&
 	return ctx;
 }
 
-void RenderGraph::initRenderPassesAndSetDeps(const RenderGraphDescription& descr, StackAllocator<U8>& alloc)
+void RenderGraph::initRenderPassesAndSetDeps(const RenderGraphDescription& descr, StackAllocator<U8>& alloc,
+											 Bool setDeps)
 {
 	BakeContext& ctx = *m_ctx;
 	const U32 passCount = descr.m_passes.getSize();
@@ -814,12 +818,17 @@ void RenderGraph::initRenderPassesAndSetDeps(const RenderGraphDescription& descr
 
 			if(graphicsPass.hasFramebuffer())
 			{
-				Bool drawsToPresentable;
-				outPass.fb() = getOrCreateFramebuffer(graphicsPass.m_fbDescr, &graphicsPass.m_rtHandles[0],
-													  inPass.m_name.cstr(), drawsToPresentable);
+				// Only imported textures can be presented
+				for(U32 i = 0; i < graphicsPass.m_fbDescr.m_colorAttachmentCount; ++i)
+				{
+					const TexturePtr& tex = descr.m_renderTargets[graphicsPass.m_rtHandles[i].m_idx].m_importedTex;
+					if(tex.isCreated() && !!(tex->getTextureUsage() & TextureUsageBit::PRESENT))
+					{
+						outPass.m_drawsToPresentable = true;
+					}
+				}
 
 				outPass.m_fbRenderArea = graphicsPass.m_fbRenderArea;
-				outPass.m_drawsToPresentable = drawsToPresentable;
 			}
 			else
 			{
@@ -832,7 +841,7 @@ void RenderGraph::initRenderPassesAndSetDeps(const RenderGraphDescription& descr
 		}
 
 		// Set dependencies by checking all previous subpasses.
-		U32 prevPassIdx = passIdx;
+		U32 prevPassIdx = (setDeps) ? passIdx : 0;
 		while(prevPassIdx--)
 		{
 			const RenderPassDescriptionBase& prevPass = *descr.m_passes[prevPassIdx];
@@ -844,70 +853,448 @@ void RenderGraph::initRenderPassesAndSetDeps(const RenderGraphDescription& descr
 	}
 }
 
-void RenderGraph::initBatches()
+void RenderGraph::initBatches(const RenderGraphDescription& descr, const GraphStructureCacheEntry* cachedStructure)
 {
 	ANKI_ASSERT(m_ctx);
 
-	U passesAssignedToBatchCount = 0;
-	const U passCount = m_ctx->m_passes.getSize();
+	const U32 passCount = m_ctx->m_passes.getSize();
 	ANKI_ASSERT(passCount > 0);
-	Bool setTimestamp = m_ctx->m_gatherStatistics;
-	while(passesAssignedToBatchCount < passCount)
+
+	if(cachedStructure)
 	{
-		m_ctx->m_batches.emplaceBack(m_ctx->m_alloc);
-		Batch& batch = m_ctx->m_batches.getBack();
+		// The batches are known, just put the passes in them
+		ANKI_ASSERT(cachedStructure->m_passBatchIndices.getSize() == passCount);
+		m_ctx->m_batches.create(m_ctx->m_alloc, cachedStructure->m_batchCount);
 
-		Bool drawsToPresentable = false;
+		for(U32 batchIdx = 0; batchIdx < cachedStructure->m_batchCount; ++batchIdx)
+		{
+			m_ctx->m_batches[batchIdx].m_async = cachedStructure->m_asyncBatchMask.get(batchIdx);
+		}
+
+		for(U32 passIdx = 0; passIdx < passCount; ++passIdx)
+		{
+			const U32 batchIdx = cachedStructure->m_passBatchIndices[passIdx];
+			m_ctx->m_batches[batchIdx].m_passIndices.emplaceBack(m_ctx->m_alloc, passIdx);
+			m_ctx->m_passIsInBatch.set(passIdx);
+			m_ctx->m_passes[passIdx].m_batchIdx = batchIdx;
+		}
+	}
+	else
+	{
+		const Bool asyncCompute = getManager().getDeviceCapabilities().m_asyncCompute;
+
+		U32 passesAssignedToBatchCount = 0;
+		while(passesAssignedToBatchCount < passCount)
+		{
+			// Gather the passes that can run now
+			BitSet<MAX_RENDER_GRAPH_PASSES, U64> readyMask(false);
+			for(U32 i = 0; i < passCount; ++i)
+			{
+				if(!m_ctx->m_passIsInBatch.get(i) && !passHasUnmetDependencies(*m_ctx, i))
+				{
+					readyMask.set(i);
+				}
+			}
+
+			// Move the async compute passes to a batch of their own. Not if they share resources with the passes of
+			// the general queue since the queues will have to wait for each other anyway
+			BitSet<MAX_RENDER_GRAPH_PASSES, U64> asyncMask(false);
+			if(asyncCompute)
+			{
+				BitSet<MAX_RENDER_GRAPH_RENDER_TARGETS, U64> generalRtMask(false);
+				BitSet<MAX_RENDER_GRAPH_BUFFERS, U64> generalBuffMask(false);
+				BitSet<MAX_RENDER_GRAPH_ACCELERATION_STRUCTURES, U32> generalAsMask(false);
+				auto addToGeneral = [&](const RenderPassDescriptionBase& pass) {
+					generalRtMask |= pass.m_readRtMask | pass.m_writeRtMask;
+					generalBuffMask |= pass.m_readBuffMask | pass.m_writeBuffMask;
+					generalAsMask |= pass.m_readAsMask | pass.m_writeAsMask;
+				};
+
+				for(U32 i = 0; i < passCount; ++i)
+				{
+					if(readyMask.get(i) && !descr.m_passes[i]->m_asyncComputeEligible)
+					{
+						addToGeneral(*descr.m_passes[i]);
+					}
+				}
+
+				for(U32 i = 0; i < passCount; ++i)
+				{
+					const RenderPassDescriptionBase& pass = *descr.m_passes[i];
+					if(!readyMask.get(i) || !pass.m_asyncComputeEligible)
+					{
+						continue;
+					}
+
+					if(!!(generalRtMask & (pass.m_readRtMask | pass.m_writeRtMask))
+					   || !!(generalBuffMask & (pass.m_readBuffMask | pass.m_writeBuffMask))
+					   || !!(generalAsMask & (pass.m_readAsMask | pass.m_writeAsMask)))
+					{
+						addToGeneral(pass);
+					}
+					else
+					{
+						asyncMask.set(i);
+					}
+				}
+
+				if(asyncMask == readyMask)
+				{
+					// Nothing to overlap with
+					asyncMask.unsetAll();
+				}
+			}
+
+			// Create the batches. The async first so the general queue will have work to do while waiting for them
+			for(Bool async : {true, false})
+			{
+				const BitSet<MAX_RENDER_GRAPH_PASSES, U64> batchMask = (async) ? asyncMask : (readyMask & ~asyncMask);
+				if(!batchMask)
+				{
+					continue;
+				}
+
+				Batch& batch = *m_ctx->m_batches.emplaceBack(m_ctx->m_alloc);
+				batch.m_async = async;
+
+				for(U32 i = 0; i < passCount; ++i)
+				{
+					if(batchMask.get(i))
+					{
+						batch.m_passIndices.emplaceBack(m_ctx->m_alloc, i);
+						m_ctx->m_passes[i].m_batchIdx = m_ctx->m_batches.getSize() - 1;
+						++passesAssignedToBatchCount;
+					}
+				}
+			}
+
+			// Mark the passes done
+			m_ctx->m_passIsInBatch |= readyMask;
+		}
+	}
+}
 
-		for(U32 i = 0; i < passCount; ++i)
+void RenderGraph::initCommandBuffers(const RenderGraphDescription& descr)
+{
+	BakeContext& ctx = *m_ctx;
+	const U32 batchCount = ctx.m_batches.getSize();
+
+	// Find the batch of the other queue every batch needs to wait for. That's the last batch of the other queue that
+	// touched the same resources. The queues use the resources concurrently so no ownership transfers are needed
+	DynamicArrayAuto<U32> waitBatches(ctx.m_alloc, batchCount, MAX_U32);
+	DynamicArrayAuto<U16> rtLastBatch(ctx.m_alloc, ctx.m_rts.getSize(), MAX_U16);
+	DynamicArrayAuto<U16> buffLastBatch(ctx.m_alloc, ctx.m_buffers.getSize(), MAX_U16);
+	DynamicArrayAuto<U16> asLastBatch(ctx.m_alloc, ctx.m_as.getSize(), MAX_U16);
+	U32 lastAsyncBatch = MAX_U32;
+
+	for(U32 batchIdx = 0; batchIdx < batchCount; ++batchIdx)
+	{
+		const Batch& batch = ctx.m_batches[batchIdx];
+
+		auto visit = [&](U16& lastBatch) {
+			if(lastBatch != MAX_U16 && ctx.m_batches[lastBatch].m_async != batch.m_async)
+			{
+				waitBatches[batchIdx] =
+					(waitBatches[batchIdx] == MAX_U32) ? lastBatch : max<U32>(waitBatches[batchIdx], lastBatch);
+			}
+		};
+
+		for(U32 passIdx : batch.m_passIndices)
 		{
-			if(!m_ctx->m_passIsInBatch.get(i) && !passHasUnmetDependencies(*m_ctx, i))
+			const RenderPassDescriptionBase& pass = *descr.m_passes[passIdx];
+			for(const RenderPassDependency& dep : pass.m_rtDeps)
 			{
-				// Add to the batch
-				++passesAssignedToBatchCount;
-				batch.m_passIndices.emplaceBack(m_ctx->m_alloc, i);
+				visit(rtLastBatch[dep.m_texture.m_handle.m_idx]);
+			}
 
-				// Will batch draw to the swapchain?
-				drawsToPresentable = drawsToPresentable || m_ctx->m_passes[i].m_drawsToPresentable;
+			for(const RenderPassDependency& dep : pass.m_buffDeps)
+			{
+				visit(buffLastBatch[dep.m_buffer.m_handle.m_idx]);
+			}
+
+			for(const RenderPassDependency& dep : pass.m_asDeps)
+			{
+				visit(asLastBatch[dep.m_as.m_handle.m_idx]);
 			}
 		}
 
+		for(U32 passIdx : batch.m_passIndices)
+		{
+			const RenderPassDescriptionBase& pass = *descr.m_passes[passIdx];
+			for(const RenderPassDependency& dep : pass.m_rtDeps)
+			{
+				rtLastBatch[dep.m_texture.m_handle.m_idx] = U16(batchIdx);
+			}
+
+			for(const RenderPassDependency& dep : pass.m_buffDeps)
+			{
+				buffLastBatch[dep.m_buffer.m_handle.m_idx] = U16(batchIdx);
+			}
+
+			for(const RenderPassDependency& dep : pass.m_asDeps)
+			{
+				asLastBatch[dep.m_as.m_handle.m_idx] = U16(batchIdx);
+			}
+		}
+
+		if(batch.m_async)
+		{
+			lastAsyncBatch = batchIdx;
+		}
+	}
+
+	// The general queue should wait for all the async work before the end of the frame
+	ANKI_ASSERT(!ctx.m_batches.getBack().m_async);
+	if(lastAsyncBatch != MAX_U32)
+	{
+		U32& wait = waitBatches[batchCount - 1];
+		wait = (wait == MAX_U32) ? lastAsyncBatch : max(wait, lastAsyncBatch);
+	}
+
+	// Split the batches to command buffers. Every command buffer will be recorded by a different thread so try to
+	// balance the number of passes between them
+	const U32 recordingThreadCount = getManager().getConfig().getGrRenderGraphRecordingThreadCount();
+	const U32 passesPerCmdb = max(1u, (ctx.m_passes.getSize() + recordingThreadCount - 1) / recordingThreadCount);
+
+	DynamicArrayAuto<U32> batchLastCmdbs(ctx.m_alloc, batchCount, MAX_U32);
+	Array<U32, 2> crntCmdbs = {MAX_U32, MAX_U32}; ///< The cmdb of the general and the async queue.
+	Array<U32, 2> queueWaitCmdbs = {MAX_U32, MAX_U32}; ///< The last cmdb of the other queue each queue waited for.
+	Bool setTimestamp = ctx.m_gatherStatistics;
+	for(U32 batchIdx = 0; batchIdx < batchCount; ++batchIdx)
+	{
+		const Batch& batch = ctx.m_batches[batchIdx];
+		const U32 queue = (batch.m_async) ? 1 : 0;
+		U32& crntCmdb = crntCmdbs[queue];
+
+		// Will batch draw to the swapchain?
+		Bool drawsToPresentable = false;
+		for(U32 passIdx : batch.m_passIndices)
+		{
+			drawsToPresentable = drawsToPresentable || ctx.m_passes[passIdx].m_drawsToPresentable;
+		}
+
 		// Get or create cmdb for the batch.
 		// Create a new cmdb if the batch is writing to swapchain. This will help Vulkan to have a dependency of the
 		// swap chain image acquire to the 2nd command buffer instead of adding it to a single big cmdb.
-		if(m_ctx->m_graphicsCmdbs.isEmpty() || drawsToPresentable)
+		Bool newCmdb = crntCmdb == MAX_U32 || drawsToPresentable;
+
+		const U32 waitBatch = waitBatches[batchIdx];
+		if(waitBatch != MAX_U32)
 		{
-			CommandBufferInitInfo cmdbInit;
-			cmdbInit.m_flags = CommandBufferFlag::GENERAL_WORK;
-			CommandBufferPtr cmdb = getManager().newCommandBuffer(cmdbInit);
+			const U32 waitCmdb = batchLastCmdbs[waitBatch];
+			if(queueWaitCmdbs[queue] == MAX_U32 || queueWaitCmdbs[queue] < waitCmdb)
+			{
+				// The cmdb of the other queue has to signal a fence. Nothing more can go into it since it might need
+				// to wait for this queue
+				ctx.m_cmdbs[waitCmdb].m_signal = true;
+				crntCmdbs[1 - queue] = MAX_U32;
+
+				// A cmdb can only wait at its start
+				queueWaitCmdbs[queue] = waitCmdb;
+				newCmdb = true;
+			}
+		}
+
+		for(U32 i = 0; i < batch.m_passIndices.getSize(); ++i)
+		{
+			if(newCmdb || ctx.m_cmdbs[crntCmdb].m_passCount >= passesPerCmdb)
+			{
+				newCmdb = false;
 
-			m_ctx->m_graphicsCmdbs.emplaceBack(m_ctx->m_alloc, cmdb);
+				crntCmdb = ctx.m_cmdbs.getSize();
+				BakeContext::Cmdb& outCmdb = *ctx.m_cmdbs.emplaceBack(ctx.m_alloc);
+				outCmdb.m_firstBatch = batchIdx;
+				outCmdb.m_firstPass = i;
 
-			batch.m_cmdb = cmdb.get();
+				// Semaphore waits don't apply to the later submissions so all cmdbs of the queue have to wait
+				outCmdb.m_waitCmdbIdx = queueWaitCmdbs[queue];
+				outCmdb.m_async = batch.m_async;
 
-			// Maybe write a timestamp
-			if(ANKI_UNLIKELY(setTimestamp))
+				// Maybe write a timestamp
+				if(ANKI_UNLIKELY(setTimestamp && !batch.m_async))
+				{
+					setTimestamp = false;
+					outCmdb.m_writeStartTimestamp = true;
+				}
+			}
+
+			ctx.m_passes[batch.m_passIndices[i]].m_cmdbIdx = crntCmdb;
+			++ctx.m_cmdbs[crntCmdb].m_passCount;
+		}
+
+		batchLastCmdbs[batchIdx] = crntCmdb;
+	}
+}
+
+U64 RenderGraph::computeGraphStructureHash(const RenderGraphDescription& descr)
+{
+	static_assert(sizeof(RenderPassDependency::TextureInfo)
+					  == sizeof(U32) + sizeof(TextureUsageBit) + sizeof(TextureSubresourceInfo),
+				  "Should be hashable");
+
+	const U32 passCount = descr.m_passes.getSize();
+	U64 hash = computeHash(&passCount, sizeof(passCount));
+
+	for(const RenderPassDescriptionBase* pass : descr.m_passes)
+	{
+		const Array<U32, 4> depCounts = {pass->m_rtDeps.getSize(), pass->m_buffDeps.getSize(), pass->m_asDeps.getSize(),
+										 pass->m_asyncComputeEligible};
+		hash = appendHash(&depCounts[0], sizeof(depCounts), hash);
+
+		for(const RenderPassDependency& dep : pass->m_rtDeps)
+		{
+			hash = appendHash(&dep.m_texture, sizeof(dep.m_texture), hash);
+		}
+
+		for(const RenderPassDependency& dep : pass->m_buffDeps)
+		{
+			const Array<U64, 2> toHash = {dep.m_buffer.m_handle.m_idx, U64(dep.m_buffer.m_usage)};
+			hash = appendHash(&toHash[0], sizeof(toHash), hash);
+		}
+
+		for(const RenderPassDependency& dep : pass->m_asDeps)
+		{
+			const Array<U32, 2> toHash = {dep.m_as.m_handle.m_idx, U32(dep.m_as.m_usage)};
+			hash = appendHash(&toHash[0], sizeof(toHash), hash);
+		}
+	}
+
+	return hash;
+}
+
+void RenderGraph::initRenderTargets(const RenderGraphDescription& descr)
+{
+	BakeContext& ctx = *m_ctx;
+	const U32 rtCount = ctx.m_rts.getSize();
+
+	// Find the lifetime of the render targets
+	for(U32 batchIdx = 0; batchIdx < ctx.m_batches.getSize(); ++batchIdx)
+	{
+		for(U32 passIdx : ctx.m_batches[batchIdx].m_passIndices)
+		{
+			for(const RenderPassDependency& dep : descr.m_passes[passIdx]->m_rtDeps)
 			{
-				setTimestamp = false;
-				TimestampQueryPtr query = getManager().newTimestampQuery();
-				cmdb->resetTimestampQuery(query);
-				cmdb->writeTimestamp(query);
+				RT& rt = ctx.m_rts[dep.m_texture.m_handle.m_idx];
+				rt.m_firstBatch = min(rt.m_firstBatch, U16(batchIdx));
+				rt.m_lastBatch = max(rt.m_lastBatch, U16(batchIdx));
+				rt.m_usedByGeneralQueue = rt.m_usedByGeneralQueue || !ctx.m_batches[batchIdx].m_async;
+				rt.m_usedByAsyncQueue = rt.m_usedByAsyncQueue || ctx.m_batches[batchIdx].m_async;
+			}
+		}
+	}
+
+	// Visit the transient RTs in the order they are first used
+	DynamicArrayAuto<U32> transientRts(ctx.m_alloc);
+	for(U32 rtIdx = 0; rtIdx < rtCount; ++rtIdx)
+	{
+		if(!ctx.m_rts[rtIdx].m_imported)
+		{
+			transientRts.emplaceBack(rtIdx);
+		}
+	}
+
+	std::sort(transientRts.getBegin(), transientRts.getEnd(), [&](U32 a, U32 b) {
+		return ctx.m_rts[a].m_firstBatch < ctx.m_rts[b].m_firstBatch;
+	});
+
+	/// A texture and the last RT that used it.
+	class TextureOwner
+	{
+	public:
+		U64 m_hash;
+		U32 m_rtIdx;
+	};
+
+	DynamicArrayAuto<TextureOwner> owners(ctx.m_alloc);
+	const Bool aliasing = getManager().getConfig().getGrRenderGraphAliasing();
+
+	for(U32 rtIdx : transientRts)
+	{
+		RT& outRt = ctx.m_rts[rtIdx];
+		const RenderGraphDescription::RT& inRt = descr.m_renderTargets[rtIdx];
 
-				m_statistics.m_nextTimestamp = (m_statistics.m_nextTimestamp + 1) % MAX_TIMESTAMPS_BUFFERED;
-				m_statistics.m_timestamps[m_statistics.m_nextTimestamp * 2] = query;
+		// Create a new TextureInitInfo with the derived usage
+		TextureInitInfo initInf = inRt.m_initInfo;
+		initInf.m_usage = inRt.m_usageDerivedByDeps;
+		ANKI_ASSERT(initInf.m_usage != TextureUsageBit::NONE && "Probably not referenced by any pass");
+
+		// Create the new hash
+		const U64 hash = appendHash(&initInf.m_usage, sizeof(initInf.m_usage), inRt.m_hash);
+
+		const PtrSize memorySize = computeRenderTargetMemorySize(initInf);
+		ctx.m_renderTargetMemory += memorySize;
+
+		// Try to use the texture of another RT that is no longer needed. Textures are only shared between RTs with the
+		// same init info since we can't place textures at arbitrary memory. They are also only shared between RTs that
+		// are used by a single and the same queue. The batches of different queues overlap and the waits between the
+		// queues are per RT, they know nothing about the texture the RTs share
+		TextureOwner* owner = nullptr;
+		const Bool singleQueue = outRt.m_usedByGeneralQueue != outRt.m_usedByAsyncQueue;
+		if(aliasing && singleQueue)
+		{
+			for(TextureOwner& o : owners)
+			{
+				const RT& ownerRt = ctx.m_rts[o.m_rtIdx];
+				if(o.m_hash == hash && ownerRt.m_lastBatch < outRt.m_firstBatch
+				   && ownerRt.m_usedByGeneralQueue == outRt.m_usedByGeneralQueue
+				   && ownerRt.m_usedByAsyncQueue == outRt.m_usedByAsyncQueue)
+				{
+					owner = &o;
+					break;
+				}
 			}
 		}
+
+		if(owner)
+		{
+			outRt.m_texture = ctx.m_rts[owner->m_rtIdx].m_texture;
+			outRt.m_aliasedRtIdx = owner->m_rtIdx;
+			owner->m_rtIdx = rtIdx;
+
+			ctx.m_aliasedRenderTargetMemory += memorySize;
+		}
 		else
 		{
-			batch.m_cmdb = m_ctx->m_graphicsCmdbs.getBack().get();
+			outRt.m_texture = getOrCreateRenderTarget(initInf, hash);
+			owners.emplaceBack(TextureOwner{hash, rtIdx});
 		}
+	}
+
+	// Init the usage
+	for(U32 rtIdx = 0; rtIdx < rtCount; ++rtIdx)
+	{
+		RT& outRt = ctx.m_rts[rtIdx];
+		const RenderGraphDescription::RT& inRt = descr.m_renderTargets[rtIdx];
 
-		// Mark batch's passes done
-		for(U32 passIdx : m_ctx->m_batches.getBack().m_passIndices)
+		const U32 surfOrVolumeCount = getTextureSurfOrVolCount(outRt.m_texture);
+		outRt.m_surfOrVolUsages.create(ctx.m_alloc, surfOrVolumeCount, TextureUsageBit::NONE);
+		if(outRt.m_imported && inRt.m_importedAndUndefinedUsage)
 		{
-			m_ctx->m_passIsInBatch.set(passIdx);
-			m_ctx->m_passes[passIdx].m_batchIdx = m_ctx->m_batches.getSize() - 1;
+			// Get the usage from previous frames
+
+			// Create a new hash because our hash map dislikes concurent keys.
+			const U64 uuid = outRt.m_texture->getUuid();
+			const U64 hash = computeHash(&uuid, sizeof(uuid));
+
+			auto it = m_importedRenderTargets.find(hash);
+			ANKI_ASSERT(it != m_importedRenderTargets.getEnd() && "Can't find the imported RT");
+
+			ANKI_ASSERT(it->m_surfOrVolLastUsages.getSize() == surfOrVolumeCount);
+			for(U32 surfOrVolIdx = 0; surfOrVolIdx < surfOrVolumeCount; ++surfOrVolIdx)
+			{
+				outRt.m_surfOrVolUsages[surfOrVolIdx] = it->m_surfOrVolLastUsages[surfOrVolIdx];
+			}
 		}
+		else if(outRt.m_imported)
+		{
+			// Set the usage that was given by the user
+			for(U32 surfOrVolIdx = 0; surfOrVolIdx < surfOrVolumeCount; ++surfOrVolIdx)
+			{
+				outRt.m_surfOrVolUsages[surfOrVolIdx] = inRt.m_importedLastKnownUsage;
+			}
+		}
+
+		outRt.m_lastBatchThatTransitionedIt.create(ctx.m_alloc, surfOrVolumeCount, MAX_U16);
 	}
 }
 
@@ -930,6 +1317,9 @@ void RenderGraph::initGraphicsPasses(const RenderGraphDescription& descr, StackA
 
 			if(graphicsPass.hasFramebuffer())
 			{
+				outPass.fb() =
+					getOrCreateFramebuffer(graphicsPass.m_fbDescr, &graphicsPass.m_rtHandles[0], inPass.m_name.cstr());
+
 				// Init the usage bits
 				TextureUsageBit usage;
 				for(U i = 0; i < graphicsPass.m_fbDescr.m_colorAttachmentCount; ++i)
@@ -956,6 +1346,7 @@ void RenderGraph::initGraphicsPasses(const RenderGraphDescription& descr, StackA
 				if(inPass.m_secondLevelCmdbsCount)
 				{
 					outPass.m_secondLevelCmdbs.create(alloc, inPass.m_secondLevelCmdbsCount);
+					outPass.m_secondLevelCpuTimes.create(alloc, inPass.m_secondLevelCmdbsCount, 0.0);
 					CommandBufferInitInfo& cmdbInit = outPass.m_secondLevelCmdbInitInfo;
 					cmdbInit.m_flags = CommandBufferFlag::GENERAL_WORK | CommandBufferFlag::SECOND_LEVEL;
 					ANKI_ASSERT(cmdbInit.m_framebuffer.isCreated());
@@ -1012,7 +1403,17 @@ void RenderGraph::setTextureBarrier(Batch& batch, const RenderPassDependency& de
 	iterateSurfsOrVolumes(
 		rt.m_texture, dep.m_texture.m_subresource, [&](U32 surfOrVolIdx, const TextureSurfaceInfo& surf) {
 			TextureUsageBit& crntUsage = rt.m_surfOrVolUsages[surfOrVolIdx];
-			if(crntUsage != depUsage)
+
+			// The first time a shared texture is used continue from the usage of the previous RT. This way the barrier
+			// will also wait for the work of the previous RT
+			Bool aliasingBarrier = false;
+			if(crntUsage == TextureUsageBit::NONE && rt.m_aliasedRtIdx != MAX_U32)
+			{
+				crntUsage = getAliasedUsage(rt, surfOrVolIdx);
+				aliasingBarrier = crntUsage != TextureUsageBit::NONE;
+			}
+
+			if(crntUsage != depUsage || aliasingBarrier)
 			{
 				// Check if we can merge barriers
 				if(rt.m_lastBatchThatTransitionedIt[surfOrVolIdx] == batchIdx)
@@ -1049,6 +1450,26 @@ void RenderGraph::setTextureBarrier(Batch& batch, const RenderPassDependency& de
 		});
 }
 
+TextureUsageBit RenderGraph::getAliasedUsage(const RT& rt, U32 surfOrVolIdx) const
+{
+	// Walk the chain of the RTs that used the same texture. Some might have not touched this surface
+	U32 rtIdx = rt.m_aliasedRtIdx;
+	while(rtIdx != MAX_U32)
+	{
+		const RT& other = m_ctx->m_rts[rtIdx];
+		ANKI_ASSERT(other.m_texture == rt.m_texture);
+
+		if(other.m_surfOrVolUsages[surfOrVolIdx] != TextureUsageBit::NONE)
+		{
+			return other.m_surfOrVolUsages[surfOrVolIdx];
+		}
+
+		rtIdx = other.m_aliasedRtIdx;
+	}
+
+	return TextureUsageBit::NONE;
+}
+
 void RenderGraph::setBatchBarriers(const RenderGraphDescription& descr)
 {
 	BakeContext& ctx = *m_ctx;
@@ -1211,11 +1632,66 @@ void RenderGraph::compileNewGraph(const RenderGraphDescription& descr, StackAllo
 	BakeContext& ctx = *newContext(descr, alloc);
 	m_ctx = &ctx;
 
+	// Most frames have the same passes with the same dependencies as some previous frame. Skip the expensive
+	// dependency and batch computations for those
+	GraphStructureCacheEntry* cachedStructure = nullptr;
+	U64 structureHash = 0;
+	if(!ANKI_DBG_RENDER_GRAPH)
+	{
+		structureHash = computeGraphStructureHash(descr);
+		auto it = m_graphStructureCache.find(structureHash);
+		if(it != m_graphStructureCache.getEnd())
+		{
+			cachedStructure = &(*it);
+			cachedStructure->m_lastUsedVersion = m_version;
+		}
+	}
+
 	// Init the passes and find the dependencies between passes
-	initRenderPassesAndSetDeps(descr, alloc);
+	initRenderPassesAndSetDeps(descr, alloc, cachedStructure == nullptr);
 
 	// Walk the graph and create pass batches
-	initBatches();
+	initBatches(descr, cachedStructure);
+
+	if(!cachedStructure && !ANKI_DBG_RENDER_GRAPH)
+	{
+		auto it = m_graphStructureCache.emplace(getAllocator(), structureHash);
+		it->m_lastUsedVersion = m_version;
+		it->m_batchCount = ctx.m_batches.getSize();
+		for(U32 batchIdx = 0; batchIdx < ctx.m_batches.getSize(); ++batchIdx)
+		{
+			it->m_asyncBatchMask.set(batchIdx, ctx.m_batches[batchIdx].m_async);
+		}
+		it->m_passBatchIndices.create(getAllocator(), ctx.m_passes.getSize());
+		for(U32 passIdx = 0; passIdx < ctx.m_passes.getSize(); ++passIdx)
+		{
+			it->m_passBatchIndices[passIdx] = U16(ctx.m_passes[passIdx].m_batchIdx);
+		}
+	}
+
+	// Split the batches to command buffers and create the waits between the queues
+	initCommandBuffers(descr);
+	m_statistics.m_primaryCommandBufferCount = ctx.m_cmdbs.getSize();
+
+	if(ctx.m_gatherStatistics)
+	{
+		m_statistics.m_passes.resize(getAllocator(), ctx.m_passes.getSize());
+		for(U32 passIdx = 0; passIdx < ctx.m_passes.getSize(); ++passIdx)
+		{
+			const CString name = descr.m_passes[passIdx]->m_name;
+			RenderGraphPassStatistics& stats = m_statistics.m_passes[passIdx];
+			const U32 len = min<U32>(name.getLength(), stats.m_name.getSize() - 1);
+			memcpy(&stats.m_name[0], name.cstr(), len);
+			stats.m_name[len] = '\0';
+			stats.m_cpuTime = 0.0;
+			stats.m_commandBufferIndex = MAX_U32;
+		}
+	}
+
+	// Now that the lifetimes are known create the textures of the render targets
+	initRenderTargets(descr);
+	m_statistics.m_renderTargetMemory = ctx.m_renderTargetMemory;
+	m_statistics.m_aliasedRenderTargetMemory = ctx.m_aliasedRenderTargetMemory;
 
 	// Now that we know the batches every pass belongs init the graphics passes
 	initGraphicsPasses(descr, alloc);
@@ -1275,7 +1751,13 @@ void RenderGraph::runSecondLevel(U32 threadIdx)
 
 			{
 				ANKI_TRACE_SCOPED_EVENT(GR_RENDER_GRAPH_CALLBACK);
+				const Second startTime = (m_ctx->m_gatherStatistics) ? HighRezTimer::getCurrentTime() : 0.0;
 				p.m_callback(ctx);
+
+				if(m_ctx->m_gatherStatistics)
+				{
+					p.m_secondLevelCpuTimes[threadIdx] = HighRezTimer::getCurrentTime() - startTime;
+				}
 			}
 
 			ctx.m_commandBuffer->flush();
@@ -1283,42 +1765,81 @@ void RenderGraph::runSecondLevel(U32 threadIdx)
 	}
 }
 
-void RenderGraph::run() const
+U32 RenderGraph::getPrimaryCommandBufferCount() const
+{
+	ANKI_ASSERT(m_ctx);
+	return m_ctx->m_cmdbs.getSize();
+}
+
+void RenderGraph::run(U32 primaryCommandBufferIdx)
 {
 	ANKI_TRACE_SCOPED_EVENT(GR_RENDER_GRAPH_RUN);
 	ANKI_ASSERT(m_ctx);
 
+	// Create the cmdb here since the command pools can't be used by multiple threads
+	BakeContext::Cmdb& outCmdb = m_ctx->m_cmdbs[primaryCommandBufferIdx];
+	ANKI_ASSERT(!outCmdb.m_cmdb.isCreated());
+	CommandBufferInitInfo cmdbInit;
+	cmdbInit.m_flags = (outCmdb.m_async) ? CommandBufferFlag::COMPUTE_WORK : CommandBufferFlag::GENERAL_WORK;
+	outCmdb.m_cmdb = getManager().newCommandBuffer(cmdbInit);
+
 	RenderPassWorkContext ctx;
 	ctx.m_rgraph = this;
 	ctx.m_currentSecondLevelCommandBufferIndex = 0;
 	ctx.m_secondLevelCommandBufferCount = 0;
+	ctx.m_commandBuffer = outCmdb.m_cmdb;
+	CommandBufferPtr& cmdb = ctx.m_commandBuffer;
 
-	for(const Batch& batch : m_ctx->m_batches)
+	if(ANKI_UNLIKELY(outCmdb.m_writeStartTimestamp))
 	{
-		ctx.m_commandBuffer.reset(batch.m_cmdb);
-		CommandBufferPtr& cmdb = ctx.m_commandBuffer;
+		TimestampQueryPtr query = getManager().newTimestampQuery();
+		cmdb->resetTimestampQuery(query);
+		cmdb->writeTimestamp(query);
+		m_ctx->m_startTimestamp = query;
+	}
 
-		// Set the barriers
-		for(const TextureBarrier& barrier : batch.m_textureBarriersBefore)
-		{
-			cmdb->setTextureSurfaceBarrier(m_ctx->m_rts[barrier.m_idx].m_texture, barrier.m_usageBefore,
-										   barrier.m_usageAfter, barrier.m_surface);
-		}
-		for(const BufferBarrier& barrier : batch.m_bufferBarriersBefore)
+	U32 batchIdx = outCmdb.m_firstBatch;
+	U32 firstPass = outCmdb.m_firstPass;
+	U32 passCount = outCmdb.m_passCount;
+	while(passCount > 0)
+	{
+		const Batch& batch = m_ctx->m_batches[batchIdx];
+		if(batch.m_async != outCmdb.m_async)
 		{
-			const Buffer& b = m_ctx->m_buffers[barrier.m_idx];
-			cmdb->setBufferBarrier(b.m_buffer, barrier.m_usageBefore, barrier.m_usageAfter, b.m_offset, b.m_range);
+			// Belongs to the other queue
+			ANKI_ASSERT(firstPass == 0);
+			++batchIdx;
+			continue;
 		}
-		for(const ASBarrier& barrier : batch.m_asBarriersBefore)
+
+		// Set the barriers. Only the cmdb that contains the 1st pass of the batch does that
+		if(firstPass == 0)
 		{
-			cmdb->setAccelerationStructureBarrier(m_ctx->m_as[barrier.m_idx].m_as, barrier.m_usageBefore,
-												  barrier.m_usageAfter);
+			for(const TextureBarrier& barrier : batch.m_textureBarriersBefore)
+			{
+				cmdb->setTextureSurfaceBarrier(m_ctx->m_rts[barrier.m_idx].m_texture, barrier.m_usageBefore,
+											   barrier.m_usageAfter, barrier.m_surface);
+			}
+			for(const BufferBarrier& barrier : batch.m_bufferBarriersBefore)
+			{
+				const Buffer& b = m_ctx->m_buffers[barrier.m_idx];
+				cmdb->setBufferBarrier(b.m_buffer, barrier.m_usageBefore, barrier.m_usageAfter, b.m_offset, b.m_range);
+			}
+			for(const ASBarrier& barrier : batch.m_asBarriersBefore)
+			{
+				cmdb->setAccelerationStructureBarrier(m_ctx->m_as[barrier.m_idx].m_as, barrier.m_usageBefore,
+													  barrier.m_usageAfter);
+			}
 		}
 
 		// Call the passes
-		for(U32 passIdx : batch.m_passIndices)
+		for(; firstPass < batch.m_passIndices.getSize() && passCount > 0; ++firstPass, --passCount)
 		{
-			const Pass& pass = m_ctx->m_passes[passIdx];
+			const U32 passIdx = batch.m_passIndices[firstPass];
+			Pass& pass = m_ctx->m_passes[passIdx];
+			ANKI_ASSERT(pass.m_cmdbIdx == primaryCommandBufferIdx);
+
+			const Second startTime = (m_ctx->m_gatherStatistics) ? HighRezTimer::getCurrentTime() : 0.0;
 
 			if(pass.fb().isCreated())
 			{
@@ -1347,7 +1868,23 @@ void RenderGraph::run() const
 			{
 				cmdb->endRenderPass();
 			}
+
+			if(m_ctx->m_gatherStatistics)
+			{
+				pass.m_cpuTime = HighRezTimer::getCurrentTime() - startTime;
+			}
 		}
+
+		++batchIdx;
+		firstPass = 0;
+	}
+}
+
+void RenderGraph::run()
+{
+	for(U32 i = 0; i < getPrimaryCommandBufferCount(); ++i)
+	{
+		run(i);
 	}
 }
 
@@ -1355,22 +1892,55 @@ void RenderGraph::flush()
 {
 	ANKI_TRACE_SCOPED_EVENT(GR_RENDER_GRAPH_FLUSH);
 
-	for(U32 i = 0; i < m_ctx->m_graphicsCmdbs.getSize(); ++i)
+	if(ANKI_UNLIKELY(m_ctx->m_gatherStatistics))
 	{
-		if(ANKI_UNLIKELY(m_ctx->m_gatherStatistics && i == m_ctx->m_graphicsCmdbs.getSize() - 1))
+		m_statistics.m_nextTimestamp = (m_statistics.m_nextTimestamp + 1) % MAX_TIMESTAMPS_BUFFERED;
+		m_statistics.m_timestamps[m_statistics.m_nextTimestamp * 2] = m_ctx->m_startTimestamp;
+
+		ANKI_ASSERT(m_statistics.m_passes.getSize() == m_ctx->m_passes.getSize());
+		for(U32 passIdx = 0; passIdx < m_ctx->m_passes.getSize(); ++passIdx)
+		{
+			const Pass& pass = m_ctx->m_passes[passIdx];
+			RenderGraphPassStatistics& stats = m_statistics.m_passes[passIdx];
+
+			stats.m_cpuTime = pass.m_cpuTime;
+			for(Second t : pass.m_secondLevelCpuTimes)
+			{
+				stats.m_cpuTime += t;
+			}
+
+			stats.m_commandBufferIndex = pass.m_cmdbIdx;
+		}
+	}
+
+	for(U32 i = 0; i < m_ctx->m_cmdbs.getSize(); ++i)
+	{
+		BakeContext::Cmdb& cmdb = m_ctx->m_cmdbs[i];
+		ANKI_ASSERT(cmdb.m_cmdb.isCreated() && "Forgot to call run()");
+
+		if(ANKI_UNLIKELY(m_ctx->m_gatherStatistics && i == m_ctx->m_cmdbs.getSize() - 1))
 		{
 			// Write a timestamp before the last flush
 
 			TimestampQueryPtr query = getManager().newTimestampQuery();
-			m_ctx->m_graphicsCmdbs[i]->resetTimestampQuery(query);
-			m_ctx->m_graphicsCmdbs[i]->writeTimestamp(query);
+			cmdb.m_cmdb->resetTimestampQuery(query);
+			cmdb.m_cmdb->writeTimestamp(query);
 
 			m_statistics.m_timestamps[m_statistics.m_nextTimestamp * 2 + 1] = query;
 			m_statistics.m_cpuStartTimes[m_statistics.m_nextTimestamp] = HighRezTimer::getCurrentTime();
 		}
 
-		// Flush
-		m_ctx->m_graphicsCmdbs[i]->flush();
+		// Flush. The cmdb it waits for is flushed already
+		ConstWeakArray<FencePtr> waitFences;
+		if(cmdb.m_waitCmdbIdx != MAX_U32)
+		{
+			ANKI_ASSERT(cmdb.m_waitCmdbIdx < i);
+			const FencePtr& fence = m_ctx->m_cmdbs[cmdb.m_waitCmdbIdx].m_signalFence;
+			ANKI_ASSERT(fence.isCreated());
+			waitFences = ConstWeakArray<FencePtr>(&fence, 1);
+		}
+
+		cmdb.m_cmdb->flush(waitFences, (cmdb.m_signal) ? &cmdb.m_signalFence : nullptr);
 	}
 }
 
@@ -1429,6 +1999,23 @@ void RenderGraph::periodicCleanup()
 	{
 		ANKI_GR_LOGI("Cleaned %u render targets", rtsCleanedCount);
 	}
+
+	// Forget the graphs that haven't been used since the last cleanup. Erasing invalidates the iterators so start over
+	Bool erased = true;
+	while(erased)
+	{
+		erased = false;
+		for(auto it = m_graphStructureCache.getBegin(); it != m_graphStructureCache.getEnd(); ++it)
+		{
+			if(it->m_lastUsedVersion + PERIODIC_CLEANUP_EVERY < m_version)
+			{
+				it->m_passBatchIndices.destroy(getAllocator());
+				m_graphStructureCache.erase(getAllocator(), it);
+				erased = true;
+				break;
+			}
+		}
+	}
 }
 
 void RenderGraph::getStatistics(RenderGraphStatistics& statistics) const
@@ -1453,6 +2040,11 @@ void RenderGraph::getStatistics(RenderGraphStatistics& statistics) const
 		statistics.m_gpuTime = -1.0;
 		statistics.m_cpuStartTime = -1.0;
 	}
+
+	statistics.m_renderTargetMemory = m_statistics.m_renderTargetMemory;
+	statistics.m_aliasedRenderTargetMemory = m_statistics.m_aliasedRenderTargetMemory;
+	statistics.m_primaryCommandBufferCount = m_statistics.m_primaryCommandBufferCount;
+	statistics.m_passes = m_statistics.m_passes;
 }
 
 #if ANKI_DBG_RENDER_GRAPH
@@ -1485,6 +2077,7 @@ StringAuto RenderGraph::textureUsageToStr(StackAllocator<U8>& alloc, TextureUsag
 	ANKI_TEX_USAGE(IMAGE_TRACE_RAYS_WRITE);
 	ANKI_TEX_USAGE(FRAMEBUFFER_ATTACHMENT_READ);
 	ANKI_TEX_USAGE(FRAMEBUFFER_ATTACHMENT_WRITE);
+	ANKI_TEX_USAGE(TRANSFER_SOURCE);
 	ANKI_TEX_USAGE(TRANSFER_DESTINATION);
 	ANKI_TEX_USAGE(GENERATE_MIPMAPS);
 	ANKI_TEX_USAGE(PRESENT);
@@ -360,6 +360,7 @@ protected:
 
 	Function<void(RenderPassWorkContext&)> m_callback;
 	U32 m_secondLevelCmdbsCount = 0;
+	Bool m_asyncComputeEligible = false;
 
 	DynamicArray<RenderPassDependency> m_rtDeps;
 	DynamicArray<RenderPassDependency> m_buffDeps;
@@ -480,6 +481,14 @@ class ComputeRenderPassDescription : public RenderPassDescriptionBase
 	template<typename, typename>
 	friend class GenericPoolAllocator;
 
+public:
+	/// Allow the pass to run in the async compute queue in parallel with the graphics work of the graph. The pass
+	/// should only record compute and transfer work. It's ignored if there is no async compute queue.
+	void setAsyncComputeEligible(Bool eligible = true)
+	{
+		m_asyncComputeEligible = eligible;
+	}
+
 private:
 	ComputeRenderPassDescription(RenderGraphDescription* descr)
 		: RenderPassDescriptionBase(Type::NO_GRAPHICS, descr)
@@ -599,6 +608,16 @@ private:
 	}
 };
 
+/// CPU statistics of a single pass.
+/// @memberof RenderGraphStatistics
+class RenderGraphPassStatistics
+{
+public:
+	Array<Char, 64> m_name; ///< Truncated if it's too long.
+	Second m_cpuTime; ///< Time spent in the callbacks of the pass. Includes the 2nd level command buffers.
+	U32 m_commandBufferIndex; ///< The 1st level command buffer the pass was recorded to.
+};
+
 /// Statistics.
 /// @memberof RenderGraph
 class RenderGraphStatistics
@@ -606,6 +625,13 @@ class RenderGraphStatistics
 public:
 	Second m_gpuTime; ///< Time spent in the GPU.
 	Second m_cpuStartTime; ///< Time the work was submited from the CPU (almost)
+	PtrSize m_renderTargetMemory; ///< The memory of the non-imported render targets of the last graph.
+	PtrSize m_aliasedRenderTargetMemory; ///< How much of m_renderTargetMemory is shared with other render targets.
+	U32 m_primaryCommandBufferCount; ///< The 1st level command buffers of the last graph. They are recorded in
+									 ///< parallel.
+
+	/// The CPU time of the passes of the last graph. It's valid until the next RenderGraph::compileNewGraph.
+	ConstWeakArray<RenderGraphPassStatistics> m_passes;
 };
 
 /// Accepts a descriptor of the frame's render passes and sets the dependencies between them.
@@ -642,8 +668,15 @@ public:
 	/// @name 3rd step methods
 	/// @{
 
-	/// Will call a number of RenderPassWorkCallback that populate 1st level command buffers.
-	void run() const;
+	/// Get the number of 1st level command buffers. Each one can be populated by a different thread.
+	U32 getPrimaryCommandBufferCount() const;
+
+	/// Will call a number of RenderPassWorkCallback that populate a 1st level command buffer. It's thread-safe for
+	/// different command buffers. The command buffer is created by the calling thread.
+	void run(U32 primaryCommandBufferIdx);
+
+	/// Populate all 1st level command buffers in the calling thread.
+	void run();
 	/// @}
 
 	/// @name 3rd step methods
@@ -687,6 +720,17 @@ private:
 		U32 m_texturesInUse = 0;
 	};
 
+	/// The part of a compiled graph that only depends on the passes and their dependencies. It's the same between most
+	/// frames.
+	class GraphStructureCacheEntry
+	{
+	public:
+		DynamicArray<U16> m_passBatchIndices; ///< The batch of each pass.
+		U32 m_batchCount = 0;
+		BitSet<MAX_RENDER_GRAPH_PASSES, U64> m_asyncBatchMask{false}; ///< Batches that go to the async compute queue.
+		U64 m_lastUsedVersion = 0;
+	};
+
 	/// Info on imported render targets that are kept between runs.
 	class ImportedRenderTargetInfo
 	{
@@ -697,6 +741,7 @@ private:
 	HashMap<U64, RenderTargetCacheEntry> m_renderTargetCache; ///< Non-imported render targets.
 	HashMap<U64, FramebufferPtr> m_fbCache; ///< Framebuffer cache.
 	HashMap<U64, ImportedRenderTargetInfo> m_importedRenderTargets;
+	HashMap<U64, GraphStructureCacheEntry> m_graphStructureCache; ///< Cache of the batches keyed on the passes.
 
 	BakeContext* m_ctx = nullptr;
 	U64 m_version = 0;
@@ -708,6 +753,10 @@ private:
 		Array<TimestampQueryPtr, MAX_TIMESTAMPS_BUFFERED * 2> m_timestamps;
 		Array<Second, MAX_TIMESTAMPS_BUFFERED> m_cpuStartTimes;
 		U8 m_nextTimestamp = 0;
+		PtrSize m_renderTargetMemory = 0;
+		PtrSize m_aliasedRenderTargetMemory = 0;
+		U32 m_primaryCommandBufferCount = 0;
+		DynamicArray<RenderGraphPassStatistics> m_passes;
 	} m_statistics;
 
 	RenderGraph(GrManager* manager, CString name);
@@ -717,18 +766,23 @@ private:
 	[[nodiscard]] static RenderGraph* newInstance(GrManager* manager);
 
 	BakeContext* newContext(const RenderGraphDescription& descr, StackAllocator<U8>& alloc);
-	void initRenderPassesAndSetDeps(const RenderGraphDescription& descr, StackAllocator<U8>& alloc);
-	void initBatches();
+	void initRenderPassesAndSetDeps(const RenderGraphDescription& descr, StackAllocator<U8>& alloc, Bool setDeps);
+	void initBatches(const RenderGraphDescription& descr, const GraphStructureCacheEntry* cachedStructure);
+	void initCommandBuffers(const RenderGraphDescription& descr);
+	void initRenderTargets(const RenderGraphDescription& descr);
 	void initGraphicsPasses(const RenderGraphDescription& descr, StackAllocator<U8>& alloc);
 	void setBatchBarriers(const RenderGraphDescription& descr);
 
 	TexturePtr getOrCreateRenderTarget(const TextureInitInfo& initInf, U64 hash);
 	FramebufferPtr getOrCreateFramebuffer(const FramebufferDescription& fbDescr, const RenderTargetHandle* rtHandles,
-										  CString name, Bool& drawsToPresentableTex);
+										  CString name);
 
 	/// Every N number of frames clean unused cached items.
 	void periodicCleanup();
 
+	/// Hash everything that affects the dependencies between passes.
+	static U64 computeGraphStructureHash(const RenderGraphDescription& descr);
+
 	ANKI_HOT static Bool passADependsOnB(const RenderPassDescriptionBase& a, const RenderPassDescriptionBase& b);
 
 	static Bool overlappingTextureSubresource(const TextureSubresourceInfo& suba, const TextureSubresourceInfo& subb);
@@ -737,6 +791,9 @@ private:
 
 	void setTextureBarrier(Batch& batch, const RenderPassDependency& consumer);
 
+	/// Get the last usage of a surface of a texture that is shared between render targets.
+	TextureUsageBit getAliasedUsage(const RT& rt, U32 surfOrVolIdx) const;
+
 	template<typename TFunc>
 	static void iterateSurfsOrVolumes(const TexturePtr& tex, const TextureSubresourceInfo& subresource, TFunc func);
 
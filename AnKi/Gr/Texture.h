@@ -242,6 +242,11 @@ public:
 		return subresource.m_faceCount == 1 && subresource.m_mipmapCount == 1 && subresource.m_layerCount == 1;
 	}
 
+	/// The memory of the texture sits in a mostly empty block that the driver would like to release. Re-creating the
+	/// texture and dropping this one will help with fragmentation.
+	/// @note It's thread-safe.
+	Bool wantsRelocation() const;
+
 protected:
 	U32 m_width = 0;
 	U32 m_height = 0;
@@ -291,6 +291,11 @@ VkPipelineStageFlags BufferImpl::computePplineStage(BufferUsageBit usage)
 		stageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
 	}
 
+	if(!!(usage & BufferUsageBit::HOST_READ))
+	{
+		stageMask |= VK_PIPELINE_STAGE_HOST_BIT;
+	}
+
 	if(!stageMask)
 	{
 		stageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
@@ -361,6 +366,11 @@ VkAccessFlags BufferImpl::computeAccessMask(BufferUsageBit usage)
 		mask |= VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
 	}
 
+	if(!!(usage & BufferUsageBit::HOST_READ))
+	{
+		mask |= VK_ACCESS_HOST_READ_BIT;
+	}
+
 	return mask;
 }
 
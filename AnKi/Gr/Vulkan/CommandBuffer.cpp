@@ -292,6 +292,22 @@ void CommandBuffer::drawElementsIndirect(PrimitiveTopology topology, U32 drawCou
 	self.drawElementsIndirectInternal(topology, drawCount, offset, buff);
 }
 
+void CommandBuffer::drawArraysIndirectCount(PrimitiveTopology topology, U32 maxDrawCount, PtrSize offset,
+											const BufferPtr& indirectBuff, PtrSize countBuffOffset,
+											const BufferPtr& countBuff)
+{
+	ANKI_VK_SELF(CommandBufferImpl);
+	self.drawArraysIndirectCountInternal(topology, maxDrawCount, offset, indirectBuff, countBuffOffset, countBuff);
+}
+
+void CommandBuffer::drawElementsIndirectCount(PrimitiveTopology topology, U32 maxDrawCount, PtrSize offset,
+											  const BufferPtr& indirectBuff, PtrSize countBuffOffset,
+											  const BufferPtr& countBuff)
+{
+	ANKI_VK_SELF(CommandBufferImpl);
+	self.drawElementsIndirectCountInternal(topology, maxDrawCount, offset, indirectBuff, countBuffOffset, countBuff);
+}
+
 void CommandBuffer::dispatchCompute(U32 groupCountX, U32 groupCountY, U32 groupCountZ)
 {
 	ANKI_VK_SELF(CommandBufferImpl);
@@ -336,6 +352,12 @@ void CommandBuffer::copyBufferToTextureView(const BufferPtr& buff, PtrSize offse
 	self.copyBufferToTextureViewInternal(buff, offset, range, texView);
 }
 
+void CommandBuffer::copyTextureViewToTextureView(const TextureViewPtr& srcView, const TextureViewPtr& dstView)
+{
+	ANKI_VK_SELF(CommandBufferImpl);
+	self.copyTextureViewToTextureViewInternal(srcView, dstView);
+}
+
 void CommandBuffer::fillBuffer(const BufferPtr& buff, PtrSize offset, PtrSize size, U32 value)
 {
 	ANKI_VK_SELF(CommandBufferImpl);
@@ -365,11 +387,11 @@ void CommandBuffer::buildAccelerationStructure(const AccelerationStructurePtr& a
 void CommandBuffer::upscale(const GrUpscalerPtr& upscaler, const TextureViewPtr& inColor,
 							const TextureViewPtr& outUpscaledColor, const TextureViewPtr& motionVectors,
 							const TextureViewPtr& depth, const TextureViewPtr& exposure, const Bool resetAccumulation,
-							const Vec2& jitterOffset, const Vec2& motionVectorsScale)
+							const Vec2& jitterOffset, const Vec2& motionVectorsScale, const UVec2& renderSize)
 {
 	ANKI_VK_SELF(CommandBufferImpl);
 	self.upscaleInternal(upscaler, inColor, outUpscaledColor, motionVectors, depth, exposure, resetAccumulation,
-						 jitterOffset, motionVectorsScale);
+						 jitterOffset, motionVectorsScale, renderSize);
 }
 
 void CommandBuffer::setTextureBarrier(const TexturePtr& tex, TextureUsageBit prevUsage, TextureUsageBit nextUsage,
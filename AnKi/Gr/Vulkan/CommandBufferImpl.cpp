@@ -711,6 +711,61 @@ void CommandBufferImpl::copyBufferToTextureViewInternal(const BufferPtr& buff, P
 	m_microCmdb->pushObjectRef(buff);
 }
 
+void CommandBufferImpl::copyTextureViewToTextureViewInternal(const TextureViewPtr& srcView,
+															 const TextureViewPtr& dstView)
+{
+	commandCommon();
+
+	const TextureViewImpl& srcViewImpl = static_cast<const TextureViewImpl&>(*srcView);
+	const TextureViewImpl& dstViewImpl = static_cast<const TextureViewImpl&>(*dstView);
+	const TextureImpl& srcTex = srcViewImpl.getTextureImpl();
+	const TextureImpl& dstTex = dstViewImpl.getTextureImpl();
+	ANKI_ASSERT(srcTex.usageValid(TextureUsageBit::TRANSFER_SOURCE));
+	ANKI_ASSERT(dstTex.usageValid(TextureUsageBit::TRANSFER_DESTINATION));
+	ANKI_ASSERT(srcTex.isSubresourceGoodForCopyFromBuffer(srcViewImpl.getSubresource()));
+	ANKI_ASSERT(dstTex.isSubresourceGoodForCopyFromBuffer(dstViewImpl.getSubresource()));
+	ANKI_ASSERT(srcTex.getFormat() == dstTex.getFormat());
+	ANKI_ASSERT(srcTex.getTextureType() == dstTex.getTextureType());
+	const Bool is3D = srcTex.getTextureType() == TextureType::_3D;
+
+	auto fillSubresource = [is3D](const TextureViewImpl& view, VkImageSubresourceLayers& out) {
+		const TextureImpl& tex = view.getTextureImpl();
+		const TextureSubresourceInfo& subresource = view.getSubresource();
+
+		out.aspectMask = convertImageAspect(subresource.m_depthStencilAspect);
+		out.mipLevel = subresource.m_firstMipmap;
+		out.baseArrayLayer =
+			(is3D) ? tex.computeVkArrayLayer(TextureVolumeInfo(subresource.m_firstMipmap))
+				   : tex.computeVkArrayLayer(TextureSurfaceInfo(subresource.m_firstMipmap, subresource.m_firstFace, 0,
+																 subresource.m_firstLayer));
+		out.layerCount = 1;
+	};
+
+	VkImageCopy region;
+	fillSubresource(srcViewImpl, region.srcSubresource);
+	fillSubresource(dstViewImpl, region.dstSubresource);
+	region.srcOffset = {0, 0, 0};
+	region.dstOffset = {0, 0, 0};
+
+	// Compute the sizes of the mip
+	const U32 srcMip = region.srcSubresource.mipLevel;
+	region.extent.width = srcTex.getWidth() >> srcMip;
+	region.extent.height = srcTex.getHeight() >> srcMip;
+	region.extent.depth = (is3D) ? (srcTex.getDepth() >> srcMip) : 1u;
+	ANKI_ASSERT(region.extent.width && region.extent.height && region.extent.depth);
+
+	[[maybe_unused]] const U32 dstMip = region.dstSubresource.mipLevel;
+	ANKI_ASSERT(region.extent.width == (dstTex.getWidth() >> dstMip));
+	ANKI_ASSERT(region.extent.height == (dstTex.getHeight() >> dstMip));
+
+	ANKI_CMD(vkCmdCopyImage(m_handle, srcTex.m_imageHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstTex.m_imageHandle,
+							VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region),
+			 ANY_OTHER_COMMAND);
+
+	m_microCmdb->pushObjectRef(srcView);
+	m_microCmdb->pushObjectRef(dstView);
+}
+
 void CommandBufferImpl::rebindDynamicState()
 {
 	m_viewportDirty = true;
@@ -816,7 +871,7 @@ void CommandBufferImpl::upscaleInternal(const GrUpscalerPtr& upscaler, const Tex
 										const TextureViewPtr& outUpscaledColor, const TextureViewPtr& motionVectors,
 										const TextureViewPtr& depth, const TextureViewPtr& exposure,
 										const Bool resetAccumulation, const Vec2& jitterOffset,
-										const Vec2& motionVectorsScale)
+										const Vec2& motionVectorsScale, const UVec2& renderSize)
 {
 #if ANKI_DLSS
 	ANKI_ASSERT(getGrManagerImpl().getDeviceCapabilities().m_dlss);
@@ -841,8 +896,13 @@ void CommandBufferImpl::upscaleInternal(const GrUpscalerPtr& upscaler, const Tex
 
 	const U32 mipLevel = srcViewImpl.getSubresource().m_firstMipmap;
 	const NVSDK_NGX_Coordinates renderingOffset = {0, 0};
-	const NVSDK_NGX_Dimensions renderingSize = {srcViewImpl.getTextureImpl().getWidth() >> mipLevel,
-												srcViewImpl.getTextureImpl().getHeight() >> mipLevel};
+	NVSDK_NGX_Dimensions renderingSize = {srcViewImpl.getTextureImpl().getWidth() >> mipLevel,
+										  srcViewImpl.getTextureImpl().getHeight() >> mipLevel};
+	if(renderSize != UVec2(0u))
+	{
+		ANKI_ASSERT(renderSize.x() <= renderingSize.Width && renderSize.y() <= renderingSize.Height);
+		renderingSize = {renderSize.x(), renderSize.y()};
+	}
 
 	NVSDK_NGX_VK_DLSS_Eval_Params vkDlssEvalParams;
 	memset(&vkDlssEvalParams, 0, sizeof(vkDlssEvalParams));
@@ -885,6 +945,7 @@ void CommandBufferImpl::upscaleInternal(const GrUpscalerPtr& upscaler, const Tex
 	(void)resetAccumulation;
 	(void)jitterOffset;
 	(void)motionVectorsScale;
+	(void)renderSize;
 #endif
 }
 
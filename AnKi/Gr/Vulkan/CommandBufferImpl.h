@@ -309,6 +309,12 @@ public:
 
 	void drawElementsIndirectInternal(PrimitiveTopology topology, U32 drawCount, PtrSize offset, const BufferPtr& buff);
 
+	void drawArraysIndirectCountInternal(PrimitiveTopology topology, U32 maxDrawCount, PtrSize offset,
+										 const BufferPtr& buff, PtrSize countBuffOffset, const BufferPtr& countBuff);
+
+	void drawElementsIndirectCountInternal(PrimitiveTopology topology, U32 maxDrawCount, PtrSize offset,
+										   const BufferPtr& buff, PtrSize countBuffOffset, const BufferPtr& countBuff);
+
 	void dispatchComputeInternal(U32 groupCountX, U32 groupCountY, U32 groupCountZ);
 
 	void traceRaysInternal(const BufferPtr& sbtBuffer, PtrSize sbtBufferOffset, U32 sbtRecordSize,
@@ -394,6 +400,8 @@ public:
 	void copyBufferToTextureViewInternal(const BufferPtr& buff, PtrSize offset, PtrSize range,
 										 const TextureViewPtr& texView);
 
+	void copyTextureViewToTextureViewInternal(const TextureViewPtr& srcView, const TextureViewPtr& dstView);
+
 	void copyBufferToBufferInternal(const BufferPtr& src, PtrSize srcOffset, const BufferPtr& dst, PtrSize dstOffset,
 									PtrSize range);
 
@@ -402,7 +410,7 @@ public:
 	void upscaleInternal(const GrUpscalerPtr& upscaler, const TextureViewPtr& inColor,
 						 const TextureViewPtr& outUpscaledColor, const TextureViewPtr& motionVectors,
 						 const TextureViewPtr& depth, const TextureViewPtr& exposure, const Bool resetAccumulation,
-						 const Vec2& jitterOffset, const Vec2& motionVectorsScale);
+						 const Vec2& jitterOffset, const Vec2& motionVectorsScale, const UVec2& renderSize);
 
 	void setPushConstantsInternal(const void* data, U32 dataSize);
 
@@ -542,6 +550,11 @@ private:
 						 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess, VkImageLayout newLayout, VkImage img,
 						 const VkImageSubresourceRange& range);
 
+	/// The async compute queue doesn't support the graphics stages. Work of the other queue is synchronized with
+	/// semaphores so it's safe to drop those stages.
+	void restrictBarrierToQueue(VkPipelineStageFlags& srcStage, VkAccessFlags& srcAccess,
+								VkPipelineStageFlags& dstStage, VkAccessFlags& dstAccess) const;
+
 	void beginRecording();
 
 	Bool flipViewport() const;
@@ -85,6 +85,42 @@ inline void CommandBufferImpl::setStencilReferenceInternal(FaceSelectionBit face
 	}
 }
 
+inline void CommandBufferImpl::restrictBarrierToQueue(VkPipelineStageFlags& srcStage, VkAccessFlags& srcAccess,
+													  VkPipelineStageFlags& dstStage, VkAccessFlags& dstAccess) const
+{
+	if(m_microCmdb->getVulkanQueueType() != VulkanQueueType::COMPUTE)
+	{
+		return;
+	}
+
+	constexpr VkPipelineStageFlags computeStages =
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+		| VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT
+		| VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR
+		| VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
+
+	constexpr VkAccessFlags computeAccesses =
+		VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+		| VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+		| VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT
+		| VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+	srcStage &= computeStages;
+	srcAccess &= computeAccesses;
+	dstStage &= computeStages;
+	dstAccess &= computeAccesses;
+
+	if(srcStage == 0)
+	{
+		srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	}
+
+	if(dstStage == 0)
+	{
+		dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	}
+}
+
 inline void CommandBufferImpl::setImageBarrier(VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
 											   VkImageLayout prevLayout, VkPipelineStageFlags dstStage,
 											   VkAccessFlags dstAccess, VkImageLayout newLayout, VkImage img,
@@ -92,6 +128,7 @@ inline void CommandBufferImpl::setImageBarrier(VkPipelineStageFlags srcStage, Vk
 {
 	ANKI_ASSERT(img);
 	commandCommon();
+	restrictBarrierToQueue(srcStage, srcAccess, dstStage, dstAccess);
 
 	VkImageMemoryBarrier inf = {};
 	inf.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -211,6 +248,7 @@ inline void CommandBufferImpl::setBufferBarrierInternal(VkPipelineStageFlags src
 {
 	ANKI_ASSERT(buff);
 	commandCommon();
+	restrictBarrierToQueue(srcStage, srcAccess, dstStage, dstAccess);
 
 	VkBufferMemoryBarrier b = {};
 	b.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
@@ -268,6 +306,7 @@ CommandBufferImpl::setAccelerationStructureBarrierInternal([[maybe_unused]] cons
 	VkPipelineStageFlags dstStage;
 	VkAccessFlags dstAccess;
 	AccelerationStructureImpl::computeBarrierInfo(prevUsage, nextUsage, srcStage, srcAccess, dstStage, dstAccess);
+	restrictBarrierToQueue(srcStage, srcAccess, dstStage, dstAccess);
 
 #if ANKI_BATCH_COMMANDS
 	flushBatches(CommandBufferCommandType::SET_BARRIER);
@@ -337,6 +376,50 @@ inline void CommandBufferImpl::drawElementsIndirectInternal(PrimitiveTopology to
 			 ANY_OTHER_COMMAND);
 }
 
+inline void CommandBufferImpl::drawArraysIndirectCountInternal(PrimitiveTopology topology, U32 maxDrawCount,
+															   PtrSize offset, const BufferPtr& buff,
+															   PtrSize countBuffOffset, const BufferPtr& countBuff)
+{
+	ANKI_ASSERT(getGrManagerImpl().getDeviceCapabilities().m_drawIndirectCount);
+	m_state.setPrimitiveTopology(topology);
+	drawcallCommon();
+	const BufferImpl& impl = static_cast<const BufferImpl&>(*buff);
+	ANKI_ASSERT(impl.usageValid(BufferUsageBit::INDIRECT_DRAW));
+	ANKI_ASSERT((offset % 4) == 0);
+	ANKI_ASSERT((offset + sizeof(DrawArraysIndirectInfo) * maxDrawCount) <= impl.getSize());
+
+	const BufferImpl& countImpl = static_cast<const BufferImpl&>(*countBuff);
+	ANKI_ASSERT(countImpl.usageValid(BufferUsageBit::INDIRECT_DRAW));
+	ANKI_ASSERT((countBuffOffset % 4) == 0);
+	ANKI_ASSERT((countBuffOffset + sizeof(U32)) <= countImpl.getSize());
+
+	ANKI_CMD(vkCmdDrawIndirectCountKHR(m_handle, impl.getHandle(), offset, countImpl.getHandle(), countBuffOffset,
+									   maxDrawCount, sizeof(DrawArraysIndirectInfo)),
+			 ANY_OTHER_COMMAND);
+}
+
+inline void CommandBufferImpl::drawElementsIndirectCountInternal(PrimitiveTopology topology, U32 maxDrawCount,
+																 PtrSize offset, const BufferPtr& buff,
+																 PtrSize countBuffOffset, const BufferPtr& countBuff)
+{
+	ANKI_ASSERT(getGrManagerImpl().getDeviceCapabilities().m_drawIndirectCount);
+	m_state.setPrimitiveTopology(topology);
+	drawcallCommon();
+	const BufferImpl& impl = static_cast<const BufferImpl&>(*buff);
+	ANKI_ASSERT(impl.usageValid(BufferUsageBit::INDIRECT_DRAW));
+	ANKI_ASSERT((offset % 4) == 0);
+	ANKI_ASSERT((offset + sizeof(DrawElementsIndirectInfo) * maxDrawCount) <= impl.getSize());
+
+	const BufferImpl& countImpl = static_cast<const BufferImpl&>(*countBuff);
+	ANKI_ASSERT(countImpl.usageValid(BufferUsageBit::INDIRECT_DRAW));
+	ANKI_ASSERT((countBuffOffset % 4) == 0);
+	ANKI_ASSERT((countBuffOffset + sizeof(U32)) <= countImpl.getSize());
+
+	ANKI_CMD(vkCmdDrawIndexedIndirectCountKHR(m_handle, impl.getHandle(), offset, countImpl.getHandle(),
+											  countBuffOffset, maxDrawCount, sizeof(DrawElementsIndirectInfo)),
+			 ANY_OTHER_COMMAND);
+}
+
 inline void CommandBufferImpl::dispatchComputeInternal(U32 groupCountX, U32 groupCountY, U32 groupCountZ)
 {
 	ANKI_ASSERT(m_computeProg);
@@ -418,6 +418,11 @@ VkImageUsageFlags convertTextureUsage(const TextureUsageBit ak, const Format for
 		out |= VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
 	}
 
+	if(!!(ak & TextureUsageBit::TRANSFER_SOURCE))
+	{
+		out |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
+
 	if(!!(ak & TextureUsageBit::TRANSFER_DESTINATION))
 	{
 		out |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
@@ -90,7 +90,9 @@ enum class VulkanExtensions : U32
 	EXT_TEXTURE_COMPRESSION_ASTC_HDR = 1 << 25,
 	NVX_BINARY_IMPORT = 1 << 26,
 	NVX_IMAGE_VIEW_HANDLE = 1 << 27,
-	KHR_PUSH_DESCRIPTOR = 1 << 28
+	KHR_PUSH_DESCRIPTOR = 1 << 28,
+	EXT_MEMORY_BUDGET = 1 << 29,
+	KHR_DRAW_INDIRECT_COUNT = 1 << 30
 };
 ANKI_ENUM_ALLOW_NUMERIC_OPERATIONS(VulkanExtensions)
 
@@ -121,8 +123,8 @@ constexpr Second MAX_FENCE_OR_SEMAPHORE_WAIT_TIME = 10.0;
 class PrivateBufferUsageBit
 {
 public:
-	static constexpr BufferUsageBit ACCELERATION_STRUCTURE_BUILD_SCRATCH = BufferUsageBit(1ull << 29ull);
-	static constexpr BufferUsageBit ACCELERATION_STRUCTURE = static_cast<BufferUsageBit>(1ull << 30ull);
+	static constexpr BufferUsageBit ACCELERATION_STRUCTURE_BUILD_SCRATCH = BufferUsageBit(1ull << 30ull);
+	static constexpr BufferUsageBit ACCELERATION_STRUCTURE = static_cast<BufferUsageBit>(1ull << 31ull);
 
 	static constexpr BufferUsageBit ALL_PRIVATE = ACCELERATION_STRUCTURE_BUILD_SCRATCH | ACCELERATION_STRUCTURE;
 };
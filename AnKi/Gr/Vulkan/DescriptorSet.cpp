@@ -7,7 +7,7 @@
 #include <AnKi/Gr/Buffer.h>
 #include <AnKi/Gr/Vulkan/BufferImpl.h>
 #include <AnKi/Util/List.h>
-#include <AnKi/Util/HashMap.h>
+#include <AnKi/Util/FlatHashMap.h>
 #include <AnKi/Util/Tracer.h>
 #include <algorithm>
 
@@ -34,15 +34,19 @@ public:
 	/// @note It's thread-safe.
 	void unbindTexture(U32 idx)
 	{
-		unbindCommon(idx, m_freeTexIndices, m_freeTexIndexCount);
+		unbindCommon(idx, 0, m_freeTexIndices, m_freeTexIndexCount);
 	}
 
 	/// @note It's thread-safe.
 	void unbindUniformTexelBuffer(U32 idx)
 	{
-		unbindCommon(idx, m_freeTexelBufferIndices, m_freeTexelBufferIndexCount);
+		unbindCommon(idx, 1, m_freeTexelBufferIndices, m_freeTexelBufferIndexCount);
 	}
 
+	/// Write the descriptors that were bound since the last flush. Call it before submitting work that might use them.
+	/// @note It's thread-safe.
+	void flushWrites();
+
 	DescriptorSet getDescriptorSet() const
 	{
 		ANKI_ASSERT(m_dset);
@@ -65,13 +69,30 @@ private:
 	VkDescriptorSet m_dset = VK_NULL_HANDLE;
 	Mutex m_mtx;
 
+	/// Min heaps of free indices. Lower indices are handed out first to minimize fragmentation.
 	DynamicArray<U16> m_freeTexIndices;
 	DynamicArray<U16> m_freeTexelBufferIndices;
 
 	U16 m_freeTexIndexCount = MAX_U16;
 	U16 m_freeTexelBufferIndexCount = MAX_U16;
 
-	void unbindCommon(U32 idx, DynamicArray<U16>& freeIndices, U16& freeIndexCount);
+	/// A descriptor waiting for flushWrites().
+	class PendingWrite
+	{
+	public:
+		VkDescriptorImageInfo m_imageInfo;
+		VkBufferView m_bufferView;
+		U16 m_idx;
+		U16 m_binding;
+	};
+
+	DynamicArray<PendingWrite> m_pendingWrites;
+	DynamicArray<VkWriteDescriptorSet> m_writeInfos;
+	U32 m_pendingWriteCount = 0;
+
+	void unbindCommon(U32 idx, U32 binding, DynamicArray<U16>& freeIndices, U16& freeIndexCount);
+
+	PendingWrite& newPendingWrite();
 };
 
 /// Descriptor set internal class.
@@ -108,8 +129,13 @@ public:
 		out = tryFindSet(hash);
 		if(out == nullptr)
 		{
+			ANKI_TRACE_INC_COUNTER(VK_DESCRIPTOR_SET_CACHE_MISS, 1);
 			ANKI_CHECK(newSet(hash, bindings, tmpAlloc, out));
 		}
+		else
+		{
+			ANKI_TRACE_INC_COUNTER(VK_DESCRIPTOR_SET_CACHE_HIT, 1);
+		}
 
 		return Error::NONE;
 	}
@@ -122,7 +148,7 @@ private:
 	U32 m_lastPoolFreeDSCount = 0;
 
 	IntrusiveList<DS> m_list; ///< At the left of the list are the least used sets.
-	HashMap<U64, DS*> m_hashmap;
+	FlatHashMap<U64, DS*> m_hashmap;
 
 	[[nodiscard]] const DS* tryFindSet(U64 hash);
 	Error newSet(U64 hash, const Array<AnyBindingExtended, MAX_BINDINGS_PER_DESCRIPTOR_SET>& bindings,
@@ -191,6 +217,8 @@ DescriptorSetFactory::BindlessDescriptorSet::~BindlessDescriptorSet()
 
 	m_freeTexIndices.destroy(m_alloc);
 	m_freeTexelBufferIndices.destroy(m_alloc);
+	m_pendingWrites.destroy(m_alloc);
+	m_writeInfos.destroy(m_alloc);
 }
 
 Error DescriptorSetFactory::BindlessDescriptorSet::init(const GrAllocator<U8>& alloc, VkDevice dev,
@@ -267,9 +295,10 @@ Error DescriptorSetFactory::BindlessDescriptorSet::init(const GrAllocator<U8>& a
 		m_freeTexIndices.create(m_alloc, bindlessTextureCount);
 		m_freeTexIndexCount = U16(m_freeTexIndices.getSize());
 
+		// Sorted is a valid heap
 		for(U32 i = 0; i < m_freeTexIndices.getSize(); ++i)
 		{
-			m_freeTexIndices[i] = U16(m_freeTexIndices.getSize() - i - 1);
+			m_freeTexIndices[i] = U16(i);
 		}
 
 		m_freeTexelBufferIndices.create(m_alloc, bindlessTextureBuffers);
@@ -277,7 +306,7 @@ Error DescriptorSetFactory::BindlessDescriptorSet::init(const GrAllocator<U8>& a
 
 		for(U32 i = 0; i < m_freeTexelBufferIndices.getSize(); ++i)
 		{
-			m_freeTexelBufferIndices[i] = U16(m_freeTexelBufferIndices.getSize() - i - 1);
+			m_freeTexelBufferIndices[i] = U16(i);
 		}
 	}
 
@@ -292,27 +321,20 @@ U32 DescriptorSetFactory::BindlessDescriptorSet::bindTexture(const VkImageView v
 	LockGuard<Mutex> lock(m_mtx);
 	ANKI_ASSERT(m_freeTexIndexCount > 0 && "Out of indices");
 
-	// Pop the index
+	// Pop the smallest index
+	std::pop_heap(&m_freeTexIndices[0], &m_freeTexIndices[0] + m_freeTexIndexCount, std::greater<U16>());
 	--m_freeTexIndexCount;
 	const U16 idx = m_freeTexIndices[m_freeTexIndexCount];
 	ANKI_ASSERT(idx < m_freeTexIndices.getSize());
 
-	// Update the set
-	VkDescriptorImageInfo imageInf = {};
-	imageInf.imageView = view;
-	imageInf.imageLayout = layout;
-
-	VkWriteDescriptorSet write = {};
-	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	write.pNext = nullptr;
-	write.dstSet = m_dset;
-	write.dstBinding = 0;
-	write.descriptorCount = 1;
-	write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-	write.dstArrayElement = idx;
-	write.pImageInfo = &imageInf;
-
-	vkUpdateDescriptorSets(m_dev, 1, &write, 0, nullptr);
+	// Defer the update of the set
+	PendingWrite& write = newPendingWrite();
+	write.m_imageInfo = {};
+	write.m_imageInfo.imageView = view;
+	write.m_imageInfo.imageLayout = layout;
+	write.m_bufferView = VK_NULL_HANDLE;
+	write.m_idx = idx;
+	write.m_binding = 0;
 
 	return idx;
 }
@@ -323,46 +345,101 @@ U32 DescriptorSetFactory::BindlessDescriptorSet::bindUniformTexelBuffer(VkBuffer
 	LockGuard<Mutex> lock(m_mtx);
 	ANKI_ASSERT(m_freeTexelBufferIndexCount > 0 && "Out of indices");
 
-	// Pop the index
+	// Pop the smallest index
+	std::pop_heap(&m_freeTexelBufferIndices[0], &m_freeTexelBufferIndices[0] + m_freeTexelBufferIndexCount,
+				  std::greater<U16>());
 	--m_freeTexelBufferIndexCount;
 	const U16 idx = m_freeTexelBufferIndices[m_freeTexelBufferIndexCount];
 	ANKI_ASSERT(idx < m_freeTexelBufferIndices.getSize());
 
-	// Update the set
-	VkWriteDescriptorSet write = {};
-	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	write.pNext = nullptr;
-	write.dstSet = m_dset;
-	write.dstBinding = 1;
-	write.descriptorCount = 1;
-	write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-	write.dstArrayElement = idx;
-	write.pTexelBufferView = &view;
-
-	vkUpdateDescriptorSets(m_dev, 1, &write, 0, nullptr);
+	// Defer the update of the set
+	PendingWrite& write = newPendingWrite();
+	write.m_imageInfo = {};
+	write.m_bufferView = view;
+	write.m_idx = idx;
+	write.m_binding = 1;
 
 	return idx;
 }
 
-void DescriptorSetFactory::BindlessDescriptorSet::unbindCommon(U32 idx, DynamicArray<U16>& freeIndices,
+void DescriptorSetFactory::BindlessDescriptorSet::unbindCommon(U32 idx, U32 binding, DynamicArray<U16>& freeIndices,
 															   U16& freeIndexCount)
 {
 	LockGuard<Mutex> lock(m_mtx);
 
 	ANKI_ASSERT(idx < freeIndices.getSize());
 	ANKI_ASSERT(freeIndexCount < freeIndices.getSize());
+	ANKI_ASSERT(std::find(&freeIndices[0], &freeIndices[0] + freeIndexCount, U16(idx))
+					== &freeIndices[0] + freeIndexCount
+				&& "Already unbound");
 
 	freeIndices[freeIndexCount] = U16(idx);
 	++freeIndexCount;
+	std::push_heap(&freeIndices[0], &freeIndices[0] + freeIndexCount, std::greater<U16>());
 
-	// Sort the free indices to minimize fragmentation
-	std::sort(&freeIndices[0], &freeIndices[0] + freeIndexCount, std::greater<U16>());
+	// The view might get destroyed soon, drop its write if it's still pending
+	for(U32 i = 0; i < m_pendingWriteCount; ++i)
+	{
+		if(m_pendingWrites[i].m_idx == idx && m_pendingWrites[i].m_binding == binding)
+		{
+			m_pendingWrites[i] = m_pendingWrites[m_pendingWriteCount - 1];
+			--m_pendingWriteCount;
+			break;
+		}
+	}
+}
 
-	// Make sure there are no duplicates
-	for(U32 i = 1; i < freeIndexCount; ++i)
+DescriptorSetFactory::BindlessDescriptorSet::PendingWrite&
+DescriptorSetFactory::BindlessDescriptorSet::newPendingWrite()
+{
+	if(m_pendingWriteCount == m_pendingWrites.getSize())
 	{
-		ANKI_ASSERT(freeIndices[i] != freeIndices[i - 1]);
+		m_pendingWrites.resize(m_alloc, max<U32>(16, m_pendingWriteCount * 2));
 	}
+
+	return m_pendingWrites[m_pendingWriteCount++];
+}
+
+void DescriptorSetFactory::BindlessDescriptorSet::flushWrites()
+{
+	LockGuard<Mutex> lock(m_mtx);
+
+	if(m_pendingWriteCount == 0)
+	{
+		return;
+	}
+
+	if(m_writeInfos.getSize() < m_pendingWriteCount)
+	{
+		m_writeInfos.resize(m_alloc, m_pendingWrites.getSize());
+	}
+
+	for(U32 i = 0; i < m_pendingWriteCount; ++i)
+	{
+		const PendingWrite& pending = m_pendingWrites[i];
+		VkWriteDescriptorSet& write = m_writeInfos[i];
+		write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_dset;
+		write.dstBinding = pending.m_binding;
+		write.descriptorCount = 1;
+		write.dstArrayElement = pending.m_idx;
+
+		if(pending.m_binding == 0)
+		{
+			write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+			write.pImageInfo = &pending.m_imageInfo;
+		}
+		else
+		{
+			write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+			write.pTexelBufferView = &pending.m_bufferView;
+		}
+	}
+
+	vkUpdateDescriptorSets(m_dev, m_pendingWriteCount, &m_writeInfos[0], 0, nullptr);
+	ANKI_TRACE_INC_COUNTER(VK_DESCRIPTOR_SET_BINDLESS_WRITES, m_pendingWriteCount);
+	m_pendingWriteCount = 0;
 }
 
 DescriptorSetFactory::DSAllocator::~DSAllocator()
@@ -453,29 +530,22 @@ Error DescriptorSetFactory::DSAllocator::newSet(
 {
 	DS* out = nullptr;
 
-	// First try to see if there are unused to recycle
+	// First try to recycle. The list is sorted by the frame of last use so only the front can be old enough
 	const U64 crntFrame = m_layoutEntry->m_factory->m_frameCount;
-	auto it = m_list.getBegin();
-	const auto end = m_list.getEnd();
-	while(it != end)
+	if(!m_list.isEmpty() && crntFrame - m_list.getFront().m_lastFrameUsed > DESCRIPTOR_FRAME_BUFFERING)
 	{
-		DS* set = &(*it);
-		U64 frameDiff = crntFrame - set->m_lastFrameUsed;
-		if(frameDiff > DESCRIPTOR_FRAME_BUFFERING)
-		{
-			// Found something, recycle
-			auto it2 = m_hashmap.find(set->m_hash);
-			ANKI_ASSERT(it2 != m_hashmap.getEnd());
-			m_hashmap.erase(m_layoutEntry->m_factory->m_alloc, it2);
-			m_list.erase(set);
+		DS* set = &m_list.getFront();
 
-			m_list.pushBack(set);
-			m_hashmap.emplace(m_layoutEntry->m_factory->m_alloc, hash, set);
+		auto it = m_hashmap.find(set->m_hash);
+		ANKI_ASSERT(it != m_hashmap.getEnd());
+		m_hashmap.erase(m_layoutEntry->m_factory->m_alloc, it);
+		m_list.erase(set);
 
-			out = set;
-			break;
-		}
-		++it;
+		m_list.pushBack(set);
+		m_hashmap.emplace(m_layoutEntry->m_factory->m_alloc, hash, set);
+		ANKI_TRACE_INC_COUNTER(VK_DESCRIPTOR_SET_RECYCLE, 1);
+
+		out = set;
 	}
 
 	if(out == nullptr)
@@ -1179,4 +1249,10 @@ void DescriptorSetFactory::unbindBindlessUniformTexelBuffer(U32 idx)
 	m_bindless->unbindUniformTexelBuffer(idx);
 }
 
+void DescriptorSetFactory::flushBindlessWrites()
+{
+	ANKI_ASSERT(m_bindless);
+	m_bindless->flushWrites();
+}
+
 } // end namespace anki
@@ -391,6 +391,10 @@ public:
 	/// @note It's thread-safe.
 	void unbindBindlessUniformTexelBuffer(U32 idx);
 
+	/// The bindless descriptors are written in batches. Call it before submitting any work.
+	/// @note It's thread-safe.
+	void flushBindlessWrites();
+
 private:
 	class BindlessDescriptorSet;
 	class DSAllocator;
@@ -60,9 +60,43 @@ Error FramebufferImpl::init(const FramebufferInitInfo& init)
 	// Create the FB
 	ANKI_CHECK(initFbs(init));
 
+	initCompatibleRenderPassInfo(init);
+
 	return Error::NONE;
 }
 
+void FramebufferImpl::initCompatibleRenderPassInfo(const FramebufferInitInfo& init)
+{
+	CompatibleRenderPassInfo& info = m_compatibleRenderpassInfo;
+
+	for(U32 i = 0; i < init.m_colorAttachmentCount; ++i)
+	{
+		info.m_colorFormats[i] =
+			static_cast<const TextureViewImpl&>(*init.m_colorAttachments[i].m_textureView).getTextureImpl().getFormat();
+	}
+	info.m_colorAttachmentCount = m_colorAttCount;
+
+	if(hasDepthStencil())
+	{
+		info.m_depthStencilFormat = static_cast<const TextureViewImpl&>(*init.m_depthStencilAttachment.m_textureView)
+										.getTextureImpl()
+										.getFormat();
+		info.m_aspect = m_aspect;
+	}
+
+	if(hasSri())
+	{
+		info.m_sriFormat =
+			static_cast<const TextureViewImpl&>(*init.m_shadingRateImage.m_textureView).getTextureImpl().getFormat();
+		info.m_sriTexelWidth = U16(init.m_shadingRateImage.m_texelWidth);
+		info.m_sriTexelHeight = U16(init.m_shadingRateImage.m_texelHeight);
+	}
+
+	info.m_presentable = m_presentableTex;
+
+	m_compatibleRenderpassHash = computeHash(&info, sizeof(info));
+}
+
 void FramebufferImpl::initClearValues(const FramebufferInitInfo& init)
 {
 	for(U i = 0; i < m_colorAttCount; ++i)
@@ -19,6 +19,24 @@ class FramebufferAttachmentInfo;
 /// @addtogroup vulkan
 /// @{
 
+/// The part of a framebuffer that defines renderpass compatibility for pipelines. Contrary to the VkRenderPass it stays
+/// the same between runs.
+class CompatibleRenderPassInfo
+{
+public:
+	Array<Format, MAX_COLOR_ATTACHMENTS> m_colorFormats = {};
+	Format m_depthStencilFormat = Format::NONE;
+	Format m_sriFormat = Format::NONE;
+	U8 m_colorAttachmentCount = 0;
+	DepthStencilAspectBit m_aspect = DepthStencilAspectBit::NONE;
+	Bool m_presentable = false;
+	U8 m_padding = 0;
+	U16 m_sriTexelWidth = 0;
+	U16 m_sriTexelHeight = 0;
+};
+static_assert(sizeof(CompatibleRenderPassInfo) == sizeof(Format) * (MAX_COLOR_ATTACHMENTS + 2) + sizeof(U32) * 2,
+			  "Packed because it will be hashed");
+
 /// Framebuffer implementation.
 class FramebufferImpl final : public Framebuffer, public VulkanObject<Framebuffer, FramebufferImpl>
 {
@@ -39,6 +57,18 @@ public:
 		return m_compatibleRenderpassHandle;
 	}
 
+	const CompatibleRenderPassInfo& getCompatibleRenderPassInfo() const
+	{
+		return m_compatibleRenderpassInfo;
+	}
+
+	/// Hash of getCompatibleRenderPassInfo(). Framebuffers with the same hash can share pipelines.
+	U64 getCompatibleRenderPassHash() const
+	{
+		ANKI_ASSERT(m_compatibleRenderpassHash);
+		return m_compatibleRenderpassHash;
+	}
+
 	/// Use it for binding. It's thread-safe
 	VkRenderPass getRenderPassHandle(const Array<VkImageLayout, MAX_COLOR_ATTACHMENTS>& colorLayouts,
 									 VkImageLayout dsLayout, VkImageLayout shadingRateImageLayout);
@@ -130,6 +160,9 @@ private:
 		TextureViewPtr m_sri;
 	} m_viewRefs;
 
+	CompatibleRenderPassInfo m_compatibleRenderpassInfo;
+	U64 m_compatibleRenderpassHash = 0;
+
 	// VK objects
 	VkRenderPass m_compatibleRenderpassHandle = VK_NULL_HANDLE; ///< Compatible renderpass. Good for pipeline creation.
 	HashMap<U64, VkRenderPass> m_renderpassHandles;
@@ -147,6 +180,7 @@ private:
 	Error initFbs(const FramebufferInitInfo& init);
 	void initRpassCreateInfo(const FramebufferInitInfo& init);
 	void initClearValues(const FramebufferInitInfo& init);
+	void initCompatibleRenderPassInfo(const FramebufferInitInfo& init);
 	void setupAttachmentDescriptor(const FramebufferAttachmentInfo& att, VkAttachmentDescription2& desc,
 								   VkImageLayout layout) const;
 
@@ -4,6 +4,7 @@
 // http://www.anki3d.org/LICENSE
 
 #include <AnKi/Gr/Vulkan/GpuMemoryManager.h>
+#include <AnKi/Util/Tracer.h>
 
 namespace anki {
 
@@ -18,6 +19,15 @@ static constexpr Array<GpuMemoryManagerClassInfo, 7> CLASSES{{{4_KB, 256_KB},
 /// Special classes for the ReBAR memory. Have that as a special case because it's so limited and needs special care.
 static constexpr Array<GpuMemoryManagerClassInfo, 3> REBAR_CLASSES{{{1_MB, 1_MB}, {12_MB, 12_MB}, {24_MB, 24_MB}}};
 
+/// Start complaining when the usage of a device heap goes beyond that portion of the budget.
+static constexpr F64 MEMORY_PRESSURE_THRESHOLD = 0.9;
+
+/// When complaining ask to go down to that portion of the budget. Leave a gap to avoid complaining every frame.
+static constexpr F64 MEMORY_PRESSURE_TARGET = 0.8;
+
+/// Without VK_EXT_memory_budget assume the application can use that portion of the heaps.
+static constexpr F64 FALLBACK_HEAP_BUDGET = 0.8;
+
 Error GpuMemoryManagerInterface::allocateChunk(U32 classIdx, GpuMemoryManagerChunk*& chunk)
 {
 	VkMemoryAllocateInfo ci = {};
@@ -77,7 +87,8 @@ void GpuMemoryManager::destroy()
 	m_callocs.destroy(m_alloc);
 }
 
-void GpuMemoryManager::init(VkPhysicalDevice pdev, VkDevice dev, GrAllocator<U8> alloc, Bool exposeBufferGpuAddress)
+void GpuMemoryManager::init(VkPhysicalDevice pdev, VkDevice dev, GrAllocator<U8> alloc, Bool exposeBufferGpuAddress,
+							Bool memoryBudgetExtension)
 {
 	ANKI_ASSERT(pdev);
 	ANKI_ASSERT(dev);
@@ -119,7 +130,14 @@ void GpuMemoryManager::init(VkPhysicalDevice pdev, VkDevice dev, GrAllocator<U8>
 	vkGetPhysicalDeviceMemoryProperties(pdev, &m_memoryProperties);
 
 	m_alloc = alloc;
+	m_pdev = pdev;
 	m_dev = dev;
+	m_memoryBudgetExtension = memoryBudgetExtension;
+
+	for(Atomic<PtrSize>& size : m_dedicatedHeapMemory)
+	{
+		size.setNonAtomically(0);
+	}
 
 	m_callocs.create(alloc, m_memoryProperties.memoryTypeCount);
 	for(U32 memTypeIdx = 0; memTypeIdx < m_callocs.getSize(); ++memTypeIdx)
@@ -201,6 +219,7 @@ void GpuMemoryManager::allocateMemoryDedicated(U32 memTypeIdx, PtrSize size, VkI
 
 	m_dedicatedAllocatedMemory.fetchAdd(size);
 	m_dedicatedAllocationCount.fetchAdd(1);
+	m_dedicatedHeapMemory[m_memoryProperties.memoryTypes[memTypeIdx].heapIndex].fetchAdd(size);
 }
 
 void GpuMemoryManager::freeMemory(GpuMemoryHandle& handle)
@@ -215,6 +234,8 @@ void GpuMemoryManager::freeMemory(GpuMemoryHandle& handle)
 
 		[[maybe_unused]] const U32 count = m_dedicatedAllocationCount.fetchSub(1);
 		ANKI_ASSERT(count > 0);
+
+		m_dedicatedHeapMemory[m_memoryProperties.memoryTypes[handle.m_memTypeIdx].heapIndex].fetchSub(handle.m_size);
 	}
 	else
 	{
@@ -298,6 +319,7 @@ void GpuMemoryManager::getStats(GpuMemoryManagerStats& stats) const
 			stats.m_deviceMemoryAllocated += cstats.m_allocatedSize;
 			stats.m_deviceMemoryInUse += cstats.m_inUseSize;
 			stats.m_deviceMemoryAllocationCount += cstats.m_chunkCount;
+			stats.m_evacuatingChunkCount += cstats.m_evacuatingChunkCount;
 		}
 		else
 		{
@@ -312,6 +334,99 @@ void GpuMemoryManager::getStats(GpuMemoryManagerStats& stats) const
 	stats.m_deviceMemoryAllocated += dedicatedAllocatedMemory;
 	stats.m_deviceMemoryInUse += dedicatedAllocatedMemory;
 	stats.m_deviceMemoryAllocationCount += m_dedicatedAllocationCount.load();
+
+	stats.m_deviceMemoryBudget = m_deviceMemoryBudget.load();
+	stats.m_deviceMemoryUsage = m_deviceMemoryUsage.load();
+}
+
+void GpuMemoryManager::endFrame()
+{
+	ANKI_TRACE_SCOPED_EVENT(VK_MEMORY_BUDGET);
+
+	// Get the budget of the heaps
+	Array<PtrSize, VK_MAX_MEMORY_HEAPS> budgets;
+	Array<PtrSize, VK_MAX_MEMORY_HEAPS> usages;
+	if(m_memoryBudgetExtension)
+	{
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProps = {};
+		budgetProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2 props = {};
+		props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		props.pNext = &budgetProps;
+		vkGetPhysicalDeviceMemoryProperties2(m_pdev, &props);
+
+		for(U32 heapIdx = 0; heapIdx < m_memoryProperties.memoryHeapCount; ++heapIdx)
+		{
+			budgets[heapIdx] = budgetProps.heapBudget[heapIdx];
+			usages[heapIdx] = budgetProps.heapUsage[heapIdx];
+		}
+	}
+	else
+	{
+		// Only our allocations are known. Assume that the rest of the system doesn't use much
+		for(U32 heapIdx = 0; heapIdx < m_memoryProperties.memoryHeapCount; ++heapIdx)
+		{
+			budgets[heapIdx] = PtrSize(F64(m_memoryProperties.memoryHeaps[heapIdx].size) * FALLBACK_HEAP_BUDGET);
+			usages[heapIdx] = m_dedicatedHeapMemory[heapIdx].load();
+		}
+
+		for(U32 memTypeIdx = 0; memTypeIdx < m_callocs.getSize(); ++memTypeIdx)
+		{
+			ClassAllocatorBuilderStats cstats;
+			m_callocs[memTypeIdx].getStats(cstats);
+			usages[m_memoryProperties.memoryTypes[memTypeIdx].heapIndex] += cstats.m_allocatedSize;
+		}
+	}
+
+	// Check the pressure of the device heaps
+	PtrSize deviceBudget = 0;
+	PtrSize deviceUsage = 0;
+	PtrSize bytesToFree = 0;
+	for(U32 heapIdx = 0; heapIdx < m_memoryProperties.memoryHeapCount; ++heapIdx)
+	{
+		if(!(m_memoryProperties.memoryHeaps[heapIdx].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+		{
+			continue;
+		}
+
+		deviceBudget += budgets[heapIdx];
+		deviceUsage += usages[heapIdx];
+
+		if(F64(usages[heapIdx]) > F64(budgets[heapIdx]) * MEMORY_PRESSURE_THRESHOLD)
+		{
+			bytesToFree += usages[heapIdx] - PtrSize(F64(budgets[heapIdx]) * MEMORY_PRESSURE_TARGET);
+		}
+	}
+
+	m_deviceMemoryBudget.store(deviceBudget);
+	m_deviceMemoryUsage.store(deviceUsage);
+
+	if(bytesToFree > 0 && m_pressureCallback)
+	{
+		m_pressureCallback(bytesToFree, m_pressureCallbackUserData);
+	}
+
+	// Chunks that are mostly empty will be released if their owners move their allocations elsewhere
+	for(ClassAllocator& calloc : m_callocs)
+	{
+		if(calloc.getInterface().m_isDeviceMemory)
+		{
+			calloc.updateEvacuation();
+		}
+	}
+}
+
+Bool GpuMemoryManager::isEvacuating(const GpuMemoryHandle& handle) const
+{
+	ANKI_ASSERT(handle);
+
+	if(handle.isDedicated())
+	{
+		return false;
+	}
+
+	return m_callocs[handle.m_memTypeIdx].isEvacuating(handle.m_chunk);
 }
 
 } // end namespace anki
@@ -114,6 +114,9 @@ public:
 	PtrSize m_hostMemoryAllocated;
 	PtrSize m_hostMemoryInUse;
 	U32 m_hostMemoryAllocationCount;
+	PtrSize m_deviceMemoryBudget; ///< What the driver allows the application to use.
+	PtrSize m_deviceMemoryUsage; ///< What the driver thinks the application uses.
+	U32 m_evacuatingChunkCount;
 };
 
 /// Dynamic GPU memory allocator for all types.
@@ -130,7 +133,8 @@ public:
 
 	GpuMemoryManager& operator=(const GpuMemoryManager&) = delete; // Non-copyable
 
-	void init(VkPhysicalDevice pdev, VkDevice dev, GrAllocator<U8> alloc, Bool exposeBufferGpuAddress);
+	void init(VkPhysicalDevice pdev, VkDevice dev, GrAllocator<U8> alloc, Bool exposeBufferGpuAddress,
+			  Bool memoryBudgetExtension);
 
 	void destroy();
 
@@ -152,11 +156,25 @@ public:
 	/// Get some statistics.
 	void getStats(GpuMemoryManagerStats& stats) const;
 
+	void setMemoryPressureCallback(GrMemoryPressureCallback callback, void* userData)
+	{
+		m_pressureCallback = callback;
+		m_pressureCallbackUserData = userData;
+	}
+
+	/// Re-evaluate the budget of the heaps, notify about memory pressure and pick the chunks that will be emptied.
+	void endFrame();
+
+	/// The allocation lives in a chunk that is being emptied. Its owner should re-allocate it when convenient.
+	/// @note It's thread-safe.
+	Bool isEvacuating(const GpuMemoryHandle& handle) const;
+
 private:
 	using ClassAllocator = ClassAllocatorBuilder<GpuMemoryManagerChunk, GpuMemoryManagerInterface, Mutex>;
 
 	GrAllocator<U8> m_alloc;
 
+	VkPhysicalDevice m_pdev = VK_NULL_HANDLE;
 	VkDevice m_dev = VK_NULL_HANDLE;
 
 	DynamicArray<ClassAllocator> m_callocs;
@@ -167,6 +185,14 @@ private:
 	// Dedicated allocation stats
 	Atomic<PtrSize> m_dedicatedAllocatedMemory = {0};
 	Atomic<U32> m_dedicatedAllocationCount = {0};
+	Array<Atomic<PtrSize>, VK_MAX_MEMORY_HEAPS> m_dedicatedHeapMemory;
+
+	// Budget
+	Bool m_memoryBudgetExtension = false;
+	GrMemoryPressureCallback m_pressureCallback = nullptr;
+	void* m_pressureCallbackUserData = nullptr;
+	Atomic<PtrSize> m_deviceMemoryBudget = {0};
+	Atomic<PtrSize> m_deviceMemoryUsage = {0};
 };
 /// @}
 
@@ -100,12 +100,27 @@ GrManagerStats GrManager::getStats() const
 	out.m_hostMemoryAllocated = memStats.m_hostMemoryAllocated;
 	out.m_hostMemoryInUse = memStats.m_hostMemoryInUse;
 	out.m_hostMemoryAllocationCount = memStats.m_hostMemoryAllocationCount;
+	out.m_deviceMemoryBudget = memStats.m_deviceMemoryBudget;
+	out.m_deviceMemoryUsage = memStats.m_deviceMemoryUsage;
+	out.m_evacuatingMemoryChunkCount = memStats.m_evacuatingChunkCount;
 
 	out.m_commandBufferCount = self.getCommandBufferFactory().getCreatedCommandBufferCount();
 
 	return out;
 }
 
+PipelinePrecompileProgress GrManager::getPipelinePrecompileProgress() const
+{
+	ANKI_VK_SELF_CONST(GrManagerImpl);
+	return self.getPipelineManifest().getProgress();
+}
+
+void GrManager::setMemoryPressureCallback(GrMemoryPressureCallback callback, void* userData)
+{
+	ANKI_VK_SELF(GrManagerImpl);
+	self.getGpuMemoryManager().setMemoryPressureCallback(callback, userData);
+}
+
 #define ANKI_NEW_GR_OBJECT(type) \
 	type##Ptr GrManager::new##type(const type##InitInfo& init) \
 	{ \
@@ -133,7 +148,6 @@ ANKI_NEW_GR_OBJECT(Texture)
 ANKI_NEW_GR_OBJECT(TextureView)
 ANKI_NEW_GR_OBJECT(Sampler)
 ANKI_NEW_GR_OBJECT(Shader)
-ANKI_NEW_GR_OBJECT(ShaderProgram)
 ANKI_NEW_GR_OBJECT(CommandBuffer)
 ANKI_NEW_GR_OBJECT(Framebuffer)
 ANKI_NEW_GR_OBJECT_NO_INIT_INFO(OcclusionQuery)
@@ -145,4 +159,19 @@ ANKI_NEW_GR_OBJECT(GrUpscaler)
 #undef ANKI_NEW_GR_OBJECT
 #undef ANKI_NEW_GR_OBJECT_NO_INIT_INFO
 
+ShaderProgramPtr GrManager::newShaderProgram(const ShaderProgramInitInfo& init)
+{
+	ShaderProgramPtr ptr(ShaderProgram::newInstance(this, init));
+	if(ANKI_UNLIKELY(!ptr.isCreated()))
+	{
+		ANKI_VK_LOGF("Failed to create a ShaderProgram object");
+	}
+
+	// Start creating the pipelines that the previous runs came across
+	ANKI_VK_SELF(GrManagerImpl);
+	self.getPipelineManifest().precompile(ptr);
+
+	return ptr;
+}
+
 } // end namespace anki
@@ -44,6 +44,7 @@ GrManagerImpl::~GrManagerImpl()
 
 	// 3rd THING: The destroy everything that has a reference to GrObjects.
 	m_cmdbFactory.destroy();
+	m_pplineManifest.destroy();
 
 	for(PerFrame& frame : m_perFrame)
 	{
@@ -143,6 +144,7 @@ Error GrManagerImpl::initInternal(const GrManagerInitInfo& init)
 	m_crntSwapchain = m_swapchainFactory.newInstance();
 
 	ANKI_CHECK(m_pplineCache.init(m_device, m_physicalDevice, init.m_cacheDirectory, *m_config, getAllocator()));
+	ANKI_CHECK(m_pplineManifest.init(this, init.m_cacheDirectory, *m_config));
 
 	ANKI_CHECK(initMemory());
 
@@ -602,6 +604,7 @@ Error GrManagerImpl::initDevice(const GrManagerInitInfo& init)
 	}
 	else
 	{
+		m_capabilities.m_asyncCompute = true;
 		ANKI_VK_LOGI("Async compute is enabled");
 	}
 
@@ -776,6 +779,16 @@ Error GrManagerImpl::initDevice(const GrManagerInitInfo& init)
 				m_extensions |= VulkanExtensions::NVX_IMAGE_VIEW_HANDLE;
 				extensionsToEnable[extensionsToEnableCount++] = extensionName.cstr();
 			}
+			else if(extensionName == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)
+			{
+				m_extensions |= VulkanExtensions::EXT_MEMORY_BUDGET;
+				extensionsToEnable[extensionsToEnableCount++] = extensionName.cstr();
+			}
+			else if(extensionName == VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)
+			{
+				m_extensions |= VulkanExtensions::KHR_DRAW_INDIRECT_COUNT;
+				extensionsToEnable[extensionsToEnableCount++] = extensionName.cstr();
+			}
 		}
 
 		ANKI_VK_LOGI("Will enable the following device extensions:");
@@ -801,6 +814,13 @@ Error GrManagerImpl::initDevice(const GrManagerInitInfo& init)
 		ci.pEnabledFeatures = &m_devFeatures;
 	}
 
+	m_capabilities.m_drawIndirectCount =
+		!!(m_extensions & VulkanExtensions::KHR_DRAW_INDIRECT_COUNT) && m_devFeatures.drawIndirectFirstInstance;
+	if(!m_capabilities.m_drawIndirectCount)
+	{
+		ANKI_VK_LOGI(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME " or drawIndirectFirstInstance is not supported");
+	}
+
 #if ANKI_PLATFORM_MOBILE
 	if(!(m_extensions & VulkanExtensions::EXT_TEXTURE_COMPRESSION_ASTC_HDR))
 	{
@@ -1133,7 +1153,8 @@ Error GrManagerImpl::initMemory()
 	}
 
 	m_gpuMemManager.init(m_physicalDevice, m_device, getAllocator(),
-						 !!(m_extensions & VulkanExtensions::KHR_BUFFER_DEVICE_ADDRESS));
+						 !!(m_extensions & VulkanExtensions::KHR_BUFFER_DEVICE_ADDRESS),
+						 !!(m_extensions & VulkanExtensions::EXT_MEMORY_BUDGET));
 
 	return Error::NONE;
 }
@@ -1303,6 +1324,8 @@ void GrManagerImpl::endFrame()
 
 	m_descrFactory.endFrame();
 
+	m_gpuMemManager.endFrame();
+
 	// Finalize
 	++m_frame;
 }
@@ -1413,6 +1436,9 @@ void GrManagerImpl::flushCommandBuffer(MicroCommandBufferPtr cmdb, Bool cmdbRend
 			frame.m_queueWroteToSwapchainImage = cmdb->getVulkanQueueType();
 		}
 
+		// The bindless descriptors that the command buffer might use have to be written before submitting
+		m_descrFactory.flushBindlessWrites();
+
 		// Submit
 		ANKI_TRACE_SCOPED_EVENT(VK_QUEUE_SUBMIT);
 		ANKI_VK_CHECKF(vkQueueSubmit(m_queues[cmdb->getVulkanQueueType()], 1, &submit, fence->getHandle()));
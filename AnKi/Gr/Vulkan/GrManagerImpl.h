@@ -18,6 +18,7 @@
 #include <AnKi/Gr/Vulkan/SwapchainFactory.h>
 #include <AnKi/Gr/Vulkan/PipelineLayout.h>
 #include <AnKi/Gr/Vulkan/PipelineCache.h>
+#include <AnKi/Gr/Vulkan/PipelineManifest.h>
 #include <AnKi/Gr/Vulkan/DescriptorSet.h>
 #include <AnKi/Gr/Vulkan/FrameGarbageCollector.h>
 #include <AnKi/Util/HashMap.h>
@@ -149,6 +150,16 @@ public:
 		return m_pplineCache.m_cacheHandle;
 	}
 
+	PipelineManifest& getPipelineManifest()
+	{
+		return m_pplineManifest;
+	}
+
+	const PipelineManifest& getPipelineManifest() const
+	{
+		return m_pplineManifest;
+	}
+
 	PipelineLayoutFactory& getPipelineLayoutFactory()
 	{
 		return m_pplineLayoutFactory;
@@ -324,6 +335,7 @@ private:
 	QueryFactory m_timestampQueryFactory;
 
 	PipelineCache m_pplineCache;
+	PipelineManifest m_pplineManifest;
 
 	FrameGarbageCollector m_frameGarbageCollector;
 
@@ -22,6 +22,8 @@ void PipelineStateTracker::reset()
 	m_fbStencil = false;
 	m_defaultFb = false;
 	m_fbColorAttachmentMask.unsetAll();
+	m_rpassInfo = nullptr;
+	m_rpassHash = 0;
 }
 
 Bool PipelineStateTracker::updateHashes()
@@ -33,7 +35,7 @@ Bool PipelineStateTracker::updateHashes()
 	{
 		m_dirty.m_prog = false;
 		stateDirty = true;
-		m_hashes.m_prog = m_state.m_prog->getUuid();
+		m_hashes.m_prog = m_state.m_prog->getStableHash();
 	}
 
 	// Rpass
@@ -41,7 +43,7 @@ Bool PipelineStateTracker::updateHashes()
 	{
 		m_dirty.m_rpass = false;
 		stateDirty = true;
-		m_hashes.m_rpass = ptrToNumber(m_state.m_rpass);
+		m_hashes.m_rpass = m_rpassHash;
 	}
 
 	// Vertex
@@ -465,6 +467,53 @@ void PipelineFactory::getOrCreatePipeline(PipelineStateTracker& state, Pipeline&
 
 	// Create it for real
 	PipelineInternal pp;
+	if(ANKI_UNLIKELY(createPipeline(state, pp.m_handle)))
+	{
+		ANKI_VK_LOGF("Failed to create pipeline: %s", state.m_state.m_prog->getName().cstr());
+	}
+
+	ANKI_TRACE_INC_COUNTER(VK_PIPELINES_CACHE_MISS, 1);
+
+	m_pplines.emplace(m_alloc, hash, pp);
+	ppline.m_handle = pp.m_handle;
+
+	// Remember it for the next runs
+	m_manifest->recordPipeline(state, hash);
+}
+
+Error PipelineFactory::precreatePipeline(PipelineStateTracker& state)
+{
+	U64 hash;
+	Bool stateDirty;
+	state.flush(hash, stateDirty);
+
+	{
+		RLockGuard<RWMutex> lock(m_pplinesMtx);
+		if(m_pplines.find(hash) != m_pplines.getEnd())
+		{
+			return Error::NONE;
+		}
+	}
+
+	// Create it without holding the lock. Someone might create the same pipeline in the meantime but it's unlikely
+	PipelineInternal pp;
+	ANKI_CHECK(createPipeline(state, pp.m_handle));
+
+	WLockGuard<RWMutex> lock(m_pplinesMtx);
+	if(m_pplines.find(hash) != m_pplines.getEnd())
+	{
+		vkDestroyPipeline(m_dev, pp.m_handle, nullptr);
+	}
+	else
+	{
+		m_pplines.emplace(m_alloc, hash, pp);
+	}
+
+	return Error::NONE;
+}
+
+Error PipelineFactory::createPipeline(PipelineStateTracker& state, VkPipeline& handle)
+{
 	const VkGraphicsPipelineCreateInfo& ci = state.updatePipelineCreateInfo();
 
 	{
@@ -477,7 +526,7 @@ void PipelineFactory::getOrCreatePipeline(PipelineStateTracker& state, Pipeline&
 		}
 #endif
 
-		ANKI_VK_CHECKF(vkCreateGraphicsPipelines(m_dev, m_pplineCache, 1, &ci, nullptr, &pp.m_handle));
+		const VkResult res = vkCreateGraphicsPipelines(m_dev, m_pplineCache, 1, &ci, nullptr, &handle);
 
 #if ANKI_PLATFORM_MOBILE
 		if(m_globalCreatePipelineMtx)
@@ -485,16 +534,19 @@ void PipelineFactory::getOrCreatePipeline(PipelineStateTracker& state, Pipeline&
 			m_globalCreatePipelineMtx->unlock();
 		}
 #endif
-	}
 
-	ANKI_TRACE_INC_COUNTER(VK_PIPELINES_CACHE_MISS, 1);
-
-	m_pplines.emplace(m_alloc, hash, pp);
-	ppline.m_handle = pp.m_handle;
+		if(ANKI_UNLIKELY(res < 0))
+		{
+			ANKI_VK_LOGE("vkCreateGraphicsPipelines() failed (VkResult: %s)", vkResultToString(res));
+			return Error::FUNCTION_FAILED;
+		}
+	}
 
 	// Print shader info
-	state.m_state.m_prog->getGrManagerImpl().printPipelineShaderInfo(pp.m_handle, state.m_state.m_prog->getName(),
-																	 state.m_state.m_prog->getStages(), hash);
+	state.m_state.m_prog->getGrManagerImpl().printPipelineShaderInfo(
+		handle, state.m_state.m_prog->getName(), state.m_state.m_prog->getStages(), state.m_hashes.m_superHash);
+
+	return Error::NONE;
 }
 
 } // end namespace anki
@@ -10,10 +10,13 @@
 #include <AnKi/Gr/Vulkan/ShaderProgramImpl.h>
 #include <AnKi/Gr/Framebuffer.h>
 #include <AnKi/Gr/Vulkan/FramebufferImpl.h>
-#include <AnKi/Util/HashMap.h>
+#include <AnKi/Util/FlatHashMap.h>
 
 namespace anki {
 
+// Forward
+class PipelineManifest;
+
 /// @addtogroup vulkan
 /// @{
 
@@ -156,6 +159,7 @@ public:
 class PipelineStateTracker
 {
 	friend class PipelineFactory;
+	friend class PipelineManifest;
 
 public:
 	PipelineStateTracker()
@@ -354,16 +358,33 @@ public:
 	}
 
 	void beginRenderPass(const FramebufferImpl* fb)
+	{
+		beginRenderPass(fb->getCompatibleRenderPassInfo(), fb->getCompatibleRenderPassHash(),
+						fb->getCompatibleRenderPass());
+	}
+
+	/// @param info It should outlive the render pass.
+	/// @param infoHash The hash of the info.
+	/// @param rpass A renderpass compatible with the info.
+	void beginRenderPass(const CompatibleRenderPassInfo& info, U64 infoHash, VkRenderPass rpass)
 	{
 		ANKI_ASSERT(m_state.m_rpass == VK_NULL_HANDLE);
-		Bool d, s;
-		fb->getAttachmentInfo(m_fbColorAttachmentMask, d, s);
-		m_fbDepth = d;
-		m_fbStencil = s;
-		m_defaultFb = fb->hasPresentableTexture();
+		m_fbColorAttachmentMask.unsetAll();
+		for(U32 i = 0; i < info.m_colorAttachmentCount; ++i)
+		{
+			m_fbColorAttachmentMask.set(i);
+		}
+		m_fbDepth = !!(info.m_aspect & DepthStencilAspectBit::DEPTH);
+		m_fbStencil = !!(info.m_aspect & DepthStencilAspectBit::STENCIL);
+		m_defaultFb = info.m_presentable;
+		m_rpassInfo = &info;
 
-		m_state.m_rpass = fb->getCompatibleRenderPass();
-		m_dirty.m_rpass = true;
+		m_state.m_rpass = rpass;
+		if(m_rpassHash != infoHash)
+		{
+			m_rpassHash = infoHash;
+			m_dirty.m_rpass = true;
+		}
 	}
 
 	void endRenderPass()
@@ -472,6 +493,8 @@ private:
 	Bool m_fbStencil = false;
 	Bool m_defaultFb = false;
 	BitSet<MAX_COLOR_ATTACHMENTS, U8> m_fbColorAttachmentMask = {false};
+	const CompatibleRenderPassInfo* m_rpassInfo = nullptr;
+	U64 m_rpassHash = 0;
 
 	class Hashes
 	{
@@ -549,7 +572,7 @@ public:
 	{
 	}
 
-	void init(GrAllocator<U8> alloc, VkDevice dev, VkPipelineCache pplineCache
+	void init(GrAllocator<U8> alloc, VkDevice dev, VkPipelineCache pplineCache, PipelineManifest* manifest
 #if ANKI_PLATFORM_MOBILE
 			  ,
 			  Mutex* globalCreatePipelineMtx
@@ -559,6 +582,7 @@ public:
 		m_alloc = alloc;
 		m_dev = dev;
 		m_pplineCache = pplineCache;
+		m_manifest = manifest;
 #if ANKI_PLATFORM_MOBILE
 		m_globalCreatePipelineMtx = globalCreatePipelineMtx;
 #endif
@@ -569,6 +593,10 @@ public:
 	/// @note Thread-safe.
 	void getOrCreatePipeline(PipelineStateTracker& state, Pipeline& ppline, Bool& stateDirty);
 
+	/// Create the pipeline ahead of time. It doesn't block getOrCreatePipeline() while the pipeline is being created.
+	/// @note Thread-safe.
+	Error precreatePipeline(PipelineStateTracker& state);
+
 private:
 	class PipelineInternal;
 	class Hasher;
@@ -576,12 +604,15 @@ private:
 	GrAllocator<U8> m_alloc;
 	VkDevice m_dev = VK_NULL_HANDLE;
 	VkPipelineCache m_pplineCache = VK_NULL_HANDLE;
+	PipelineManifest* m_manifest = nullptr;
 
-	HashMap<U64, PipelineInternal, Hasher> m_pplines;
+	FlatHashMap<U64, PipelineInternal, Hasher> m_pplines;
 	RWMutex m_pplinesMtx;
 #if ANKI_PLATFORM_MOBILE
 	Mutex* m_globalCreatePipelineMtx = nullptr;
 #endif
+
+	Error createPipeline(PipelineStateTracker& state, VkPipeline& handle);
 };
 /// @}
 
@@ -0,0 +1,440 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Gr/Vulkan/PipelineManifest.h>
+#include <AnKi/Gr/Vulkan/Pipeline.h>
+#include <AnKi/Gr/Vulkan/GrManagerImpl.h>
+#include <AnKi/Core/ConfigSet.h>
+#include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/File.h>
+#include <AnKi/Util/Tracer.h>
+#include <algorithm>
+
+namespace anki {
+
+static constexpr Array<U8, 8> MANIFEST_MAGIC = {{'A', 'N', 'K', 'I', 'P', 'S', 'O', '1'}};
+
+/// The on disk representation of a pipeline. It has nothing that changes between runs.
+class PipelineManifest::Entry
+{
+public:
+	U64 m_pipelineHash;
+	U64 m_programHash;
+	U64 m_rpassHash;
+	CompatibleRenderPassInfo m_rpass;
+	VertexPipelineState m_vertex;
+	InputAssemblerPipelineState m_inputAssembler;
+	RasterizerPipelineState m_rasterizer;
+	DepthPipelineState m_depth;
+	StencilPipelineState m_stencil;
+	ColorPipelineState m_color;
+};
+
+class PipelineManifest::Header
+{
+public:
+	Array<U8, 8> m_magic;
+	U32 m_entrySize;
+	U32 m_entryCount;
+};
+
+/// The entries of a program that wait to be created.
+class PipelineManifest::Job
+{
+public:
+	ShaderProgramPtr m_prog;
+	U32 m_crntEntry = 0;
+	U32 m_endEntry = 0;
+};
+
+PipelineManifest::PipelineManifest()
+{
+}
+
+PipelineManifest::~PipelineManifest()
+{
+	ANKI_ASSERT(m_threads.getSize() == 0 && m_rpasses.isEmpty() && "Forgot to call destroy()");
+}
+
+Error PipelineManifest::init(GrManagerImpl* manager, CString cacheDir, const ConfigSet& cfg)
+{
+	ANKI_ASSERT(manager && cacheDir);
+	m_manager = manager;
+	m_filename.sprintf(m_manager->getAllocator(), "%s/PipelineManifest", cacheDir.cstr());
+
+	if(load())
+	{
+		ANKI_VK_LOGW("Failed to load the pipeline manifest. Will start a new one: %s", m_filename.cstr());
+		m_loadedEntries.destroy(m_manager->getAllocator());
+		m_knownPipelines.destroy(m_manager->getAllocator());
+	}
+
+	const U32 threadCount = cfg.getGrPipelinePrecompileThreadCount();
+	if(threadCount && m_loadedEntries.getSize())
+	{
+		m_threads.create(m_manager->getAllocator(), threadCount);
+		for(U32 i = 0; i < threadCount; ++i)
+		{
+			m_threads[i] = m_manager->getAllocator().newInstance<Thread>("anki_pplprecomp");
+			m_threads[i]->start(this, threadCallback);
+		}
+	}
+
+	return Error::NONE;
+}
+
+void PipelineManifest::destroy()
+{
+	if(m_manager == nullptr)
+	{
+		return;
+	}
+
+	GrAllocator<U8> alloc = m_manager->getAllocator();
+
+	// Stop the threads
+	{
+		LockGuard<Mutex> lock(m_jobsMtx);
+		m_quit = true;
+		m_jobsCondVar.notifyAll();
+	}
+
+	for(Thread* thread : m_threads)
+	{
+		[[maybe_unused]] const Error err = thread->join();
+		alloc.deleteInstance(thread);
+	}
+
+	m_threads.destroy(alloc);
+	m_jobs.destroy(alloc);
+
+	// Store
+	if(store())
+	{
+		ANKI_VK_LOGE("An error occurred while storing the pipeline manifest to disk. Will ignore");
+	}
+
+	for(VkRenderPass rpass : m_rpasses)
+	{
+		vkDestroyRenderPass(m_manager->getDevice(), rpass, nullptr);
+	}
+
+	m_rpasses.destroy(alloc);
+	m_loadedEntries.destroy(alloc);
+	m_newEntries.destroy(alloc);
+	m_knownPipelines.destroy(alloc);
+	m_filename.destroy(alloc);
+	m_manager = nullptr;
+}
+
+Error PipelineManifest::load()
+{
+	if(!fileExists(m_filename.toCString()))
+	{
+		ANKI_VK_LOGI("Pipeline manifest not found: %s", m_filename.cstr());
+		return Error::NONE;
+	}
+
+	File file;
+	ANKI_CHECK(file.open(m_filename.toCString(), FileOpenFlag::BINARY | FileOpenFlag::READ));
+
+	Header header;
+	if(file.getSize() < sizeof(header))
+	{
+		return Error::USER_DATA;
+	}
+
+	ANKI_CHECK(file.read(&header, sizeof(header)));
+
+	if(memcmp(&header.m_magic[0], &MANIFEST_MAGIC[0], MANIFEST_MAGIC.getSize()) != 0
+	   || header.m_entrySize != sizeof(Entry)
+	   || file.getSize() != sizeof(header) + PtrSize(header.m_entryCount) * sizeof(Entry))
+	{
+		ANKI_VK_LOGI("Pipeline manifest is not compatible: %s", m_filename.cstr());
+		return Error::NONE;
+	}
+
+	if(header.m_entryCount == 0)
+	{
+		return Error::NONE;
+	}
+
+	GrAllocator<U8> alloc = m_manager->getAllocator();
+	m_loadedEntries.create(alloc, header.m_entryCount);
+	ANKI_CHECK(file.read(&m_loadedEntries[0], m_loadedEntries.getSizeInBytes()));
+
+	// Sort them so the entries of a program can be found fast
+	std::sort(m_loadedEntries.getBegin(), m_loadedEntries.getEnd(), [](const Entry& a, const Entry& b) {
+		return a.m_programHash < b.m_programHash;
+	});
+
+	for(const Entry& entry : m_loadedEntries)
+	{
+		if(m_knownPipelines.find(entry.m_pipelineHash) == m_knownPipelines.getEnd())
+		{
+			m_knownPipelines.emplace(alloc, entry.m_pipelineHash, true);
+		}
+	}
+
+	ANKI_VK_LOGI("Loaded %u pipelines from the pipeline manifest", m_loadedEntries.getSize());
+	return Error::NONE;
+}
+
+Error PipelineManifest::store()
+{
+	if(m_newEntries.getSize() == 0)
+	{
+		return Error::NONE;
+	}
+
+	File file;
+	ANKI_CHECK(file.open(m_filename.toCString(), FileOpenFlag::BINARY | FileOpenFlag::WRITE));
+
+	Header header;
+	header.m_magic = MANIFEST_MAGIC;
+	header.m_entrySize = sizeof(Entry);
+	header.m_entryCount = m_loadedEntries.getSize() + m_newEntries.getSize();
+	ANKI_CHECK(file.write(&header, sizeof(header)));
+
+	if(m_loadedEntries.getSize())
+	{
+		ANKI_CHECK(file.write(&m_loadedEntries[0], m_loadedEntries.getSizeInBytes()));
+	}
+
+	ANKI_CHECK(file.write(&m_newEntries[0], m_newEntries.getSizeInBytes()));
+
+	ANKI_VK_LOGI("Stored %u pipelines to the pipeline manifest (%u new)", header.m_entryCount, m_newEntries.getSize());
+	return Error::NONE;
+}
+
+void PipelineManifest::precompile(const ShaderProgramPtr& prog)
+{
+	const ShaderProgramImpl& progImpl = static_cast<const ShaderProgramImpl&>(*prog);
+	if(m_threads.getSize() == 0 || !progImpl.isGraphics())
+	{
+		return;
+	}
+
+	const U64 progHash = progImpl.getStableHash();
+	const Entry* begin = std::lower_bound(m_loadedEntries.getBegin(), m_loadedEntries.getEnd(), progHash,
+										  [](const Entry& entry, U64 hash) {
+											  return entry.m_programHash < hash;
+										  });
+	const Entry* end = begin;
+	while(end != m_loadedEntries.getEnd() && end->m_programHash == progHash)
+	{
+		++end;
+	}
+
+	if(begin == end)
+	{
+		return;
+	}
+
+	LockGuard<Mutex> lock(m_jobsMtx);
+	Job& job = *m_jobs.emplaceBack(m_manager->getAllocator());
+	job.m_prog = prog;
+	job.m_crntEntry = U32(begin - m_loadedEntries.getBegin());
+	job.m_endEntry = U32(end - m_loadedEntries.getBegin());
+
+	m_queuedPipelineCount.fetchAdd(job.m_endEntry - job.m_crntEntry);
+	m_jobsCondVar.notifyAll();
+}
+
+void PipelineManifest::recordPipeline(const PipelineStateTracker& state, U64 pipelineHash)
+{
+	ANKI_ASSERT(state.m_rpassInfo);
+
+	LockGuard<Mutex> lock(m_entriesMtx);
+
+	if(m_knownPipelines.find(pipelineHash) != m_knownPipelines.getEnd())
+	{
+		return;
+	}
+
+	m_knownPipelines.emplace(m_manager->getAllocator(), pipelineHash, true);
+
+	Entry& entry = *m_newEntries.emplaceBack(m_manager->getAllocator());
+	zeroMemory(entry); // Zero the padding as well to have a deterministic file
+	entry.m_pipelineHash = pipelineHash;
+	entry.m_programHash = state.m_state.m_prog->getStableHash();
+	entry.m_rpassHash = state.m_rpassHash;
+	entry.m_rpass = *state.m_rpassInfo;
+	entry.m_vertex = state.m_state.m_vertex;
+	entry.m_inputAssembler = state.m_state.m_inputAssembler;
+	entry.m_rasterizer = state.m_state.m_rasterizer;
+	entry.m_depth = state.m_state.m_depth;
+	entry.m_stencil = state.m_state.m_stencil;
+	entry.m_color = state.m_state.m_color;
+}
+
+Error PipelineManifest::threadCallback(ThreadCallbackInfo& info)
+{
+	PipelineManifest& self = *static_cast<PipelineManifest*>(info.m_userData);
+	self.threadWorker();
+	return Error::NONE;
+}
+
+void PipelineManifest::threadWorker()
+{
+	while(true)
+	{
+		ShaderProgramPtr prog;
+		U32 entryIdx;
+
+		{
+			// Wait for something
+			LockGuard<Mutex> lock(m_jobsMtx);
+			while(!m_quit && m_firstJob == m_jobs.getSize())
+			{
+				m_jobsCondVar.wait(m_jobsMtx);
+			}
+
+			if(m_quit)
+			{
+				break;
+			}
+
+			Job& job = m_jobs[m_firstJob];
+			prog = job.m_prog;
+			entryIdx = job.m_crntEntry++;
+
+			if(job.m_crntEntry == job.m_endEntry)
+			{
+				job.m_prog.reset(nullptr);
+				++m_firstJob;
+
+				if(m_firstJob == m_jobs.getSize())
+				{
+					m_jobs.destroy(m_manager->getAllocator());
+					m_firstJob = 0;
+				}
+			}
+		}
+
+		if(createPipeline(static_cast<ShaderProgramImpl&>(*prog), m_loadedEntries[entryIdx]))
+		{
+			ANKI_VK_LOGW("Failed to create a pipeline of the pipeline manifest: %s", prog->getName().cstr());
+		}
+
+		// Count the failures as well, there is nothing more to do for them
+		m_createdPipelineCount.fetchAdd(1);
+	}
+}
+
+Error PipelineManifest::createPipeline(ShaderProgramImpl& prog, const Entry& entry)
+{
+	ANKI_TRACE_SCOPED_EVENT(VK_PIPELINE_PRECOMPILE);
+
+	VkRenderPass rpass;
+	ANKI_CHECK(getOrCreateRenderPass(entry.m_rpass, entry.m_rpassHash, rpass));
+
+	// Replay the state
+	PipelineStateTracker state;
+	state.bindShaderProgram(&prog);
+	state.beginRenderPass(entry.m_rpass, entry.m_rpassHash, rpass);
+
+	state.m_state.m_vertex = entry.m_vertex;
+	state.m_state.m_inputAssembler = entry.m_inputAssembler;
+	state.m_state.m_rasterizer = entry.m_rasterizer;
+	state.m_state.m_depth = entry.m_depth;
+	state.m_state.m_stencil = entry.m_stencil;
+	state.m_state.m_color = entry.m_color;
+
+	state.m_set.m_attribs = state.m_shaderAttributeMask;
+	for(U32 i = 0; i < MAX_VERTEX_ATTRIBUTES; ++i)
+	{
+		if(state.m_shaderAttributeMask.get(i))
+		{
+			state.m_set.m_vertBindings.set(entry.m_vertex.m_attributes[i].m_binding);
+		}
+	}
+
+	ANKI_CHECK(prog.getPipelineFactory().precreatePipeline(state));
+	state.endRenderPass();
+
+	return Error::NONE;
+}
+
+Error PipelineManifest::getOrCreateRenderPass(const CompatibleRenderPassInfo& info, U64 infoHash, VkRenderPass& rpass)
+{
+	LockGuard<Mutex> lock(m_rpassesMtx);
+
+	auto it = m_rpasses.find(infoHash);
+	if(it != m_rpasses.getEnd())
+	{
+		rpass = *it;
+		return Error::NONE;
+	}
+
+	// Only the formats matter for compatibility, the rest can be anything
+	Array<VkAttachmentDescription2, MAX_COLOR_ATTACHMENTS + 2> attachments = {};
+	Array<VkAttachmentReference2, MAX_COLOR_ATTACHMENTS + 2> references = {};
+	U32 attachmentCount = 0;
+	auto addAttachment = [&](Format format, VkImageLayout layout) {
+		VkAttachmentDescription2& desc = attachments[attachmentCount];
+		desc.sType = VK_STRUCTURE_TYPE_ATTACHMENT_DESCRIPTION_2;
+		desc.format = convertFormat(format);
+		desc.samples = VK_SAMPLE_COUNT_1_BIT;
+		desc.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		desc.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		desc.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		desc.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		desc.initialLayout = layout;
+		desc.finalLayout = layout;
+
+		VkAttachmentReference2& ref = references[attachmentCount];
+		ref.sType = VK_STRUCTURE_TYPE_ATTACHMENT_REFERENCE_2;
+		ref.attachment = attachmentCount;
+		ref.layout = layout;
+
+		++attachmentCount;
+	};
+
+	for(U32 i = 0; i < info.m_colorAttachmentCount; ++i)
+	{
+		addAttachment(info.m_colorFormats[i], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+	}
+
+	if(!!info.m_aspect)
+	{
+		addAttachment(info.m_depthStencilFormat, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+	}
+
+	VkSubpassDescription2 subpass = {};
+	subpass.sType = VK_STRUCTURE_TYPE_SUBPASS_DESCRIPTION_2;
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = info.m_colorAttachmentCount;
+	subpass.pColorAttachments = (info.m_colorAttachmentCount) ? &references[0] : nullptr;
+	subpass.pDepthStencilAttachment = (!!info.m_aspect) ? &references[info.m_colorAttachmentCount] : nullptr;
+
+	VkFragmentShadingRateAttachmentInfoKHR sriInfo = {};
+	if(info.m_sriFormat != Format::NONE)
+	{
+		const U32 sriAttachmentIdx = attachmentCount;
+		addAttachment(info.m_sriFormat, VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR);
+
+		sriInfo.sType = VK_STRUCTURE_TYPE_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR;
+		sriInfo.shadingRateAttachmentTexelSize.width = info.m_sriTexelWidth;
+		sriInfo.shadingRateAttachmentTexelSize.height = info.m_sriTexelHeight;
+		sriInfo.pFragmentShadingRateAttachment = &references[sriAttachmentIdx];
+
+		subpass.pNext = &sriInfo;
+	}
+
+	VkRenderPassCreateInfo2 ci = {};
+	ci.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO_2;
+	ci.pAttachments = &attachments[0];
+	ci.attachmentCount = attachmentCount;
+	ci.subpassCount = 1;
+	ci.pSubpasses = &subpass;
+
+	ANKI_VK_CHECK(vkCreateRenderPass2KHR(m_manager->getDevice(), &ci, nullptr, &rpass));
+	m_rpasses.emplace(m_manager->getAllocator(), infoHash, rpass);
+
+	return Error::NONE;
+}
+
+} // end namespace anki
@@ -0,0 +1,97 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Gr/Vulkan/Common.h>
+#include <AnKi/Gr/GrManager.h>
+#include <AnKi/Util/HashMap.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/Thread.h>
+
+namespace anki {
+
+// Forward
+class ConfigSet;
+class GrManagerImpl;
+class PipelineStateTracker;
+class CompatibleRenderPassInfo;
+class ShaderProgramImpl;
+
+/// @addtogroup vulkan
+/// @{
+
+/// On disk list of the graphics pipelines that have been created. The pipelines of the list get re-created in the
+/// background as soon as their programs get created. That way they will be ready before they are first used.
+class PipelineManifest
+{
+public:
+	PipelineManifest();
+
+	~PipelineManifest();
+
+	Error init(GrManagerImpl* manager, CString cacheDir, const ConfigSet& cfg);
+
+	/// Stop the background creation and write the manifest to disk.
+	void destroy();
+
+	/// Queue the pipelines of the manifest that belong to that program.
+	/// @note Thread-safe.
+	void precompile(const ShaderProgramPtr& prog);
+
+	/// Add a pipeline to the manifest.
+	/// @note Thread-safe.
+	void recordPipeline(const PipelineStateTracker& state, U64 pipelineHash);
+
+	/// @note Thread-safe.
+	PipelinePrecompileProgress getProgress() const
+	{
+		PipelinePrecompileProgress out;
+		out.m_manifestPipelineCount = m_loadedEntries.getSize();
+		out.m_queuedPipelineCount = m_queuedPipelineCount.load();
+		out.m_createdPipelineCount = m_createdPipelineCount.load();
+		return out;
+	}
+
+private:
+	class Entry;
+	class Header;
+	class Job;
+
+	GrManagerImpl* m_manager = nullptr;
+	String m_filename;
+
+	DynamicArray<Entry> m_loadedEntries; ///< The entries read from the disk. Sorted by program.
+	DynamicArray<Entry> m_newEntries; ///< The entries added in this run.
+	HashMap<U64, Bool> m_knownPipelines; ///< The hashes of all entries.
+	Mutex m_entriesMtx;
+
+	HashMap<U64, VkRenderPass> m_rpasses;
+	Mutex m_rpassesMtx;
+
+	DynamicArray<Thread*> m_threads;
+	DynamicArray<Job> m_jobs;
+	U32 m_firstJob = 0;
+	Mutex m_jobsMtx;
+	ConditionVariable m_jobsCondVar;
+	Bool m_quit = false;
+
+	Atomic<U32> m_queuedPipelineCount = {0};
+	Atomic<U32> m_createdPipelineCount = {0};
+
+	Error load();
+	Error store();
+
+	static Error threadCallback(ThreadCallbackInfo& info);
+
+	void threadWorker();
+
+	Error createPipeline(ShaderProgramImpl& prog, const Entry& entry);
+
+	Error getOrCreateRenderPass(const CompatibleRenderPassInfo& info, U64 infoHash, VkRenderPass& rpass);
+};
+/// @}
+
+} // end namespace anki
@@ -116,6 +116,13 @@ Error ShaderImpl::init(const ShaderInitInfo& inf)
 		}
 	}
 
+	m_stableHash = computeHash(&inf.m_binary[0], inf.m_binary.getSize());
+	m_stableHash = appendHash(&m_shaderType, sizeof(m_shaderType), m_stableHash);
+	if(m_specConstInfo.dataSize)
+	{
+		m_stableHash = appendHash(m_specConstInfo.pData, m_specConstInfo.dataSize, m_stableHash);
+	}
+
 	return Error::NONE;
 }
 
@@ -28,6 +28,7 @@ public:
 	Array<BitSet<MAX_BINDINGS_PER_DESCRIPTOR_SET, U8>, MAX_DESCRIPTOR_SETS> m_activeBindingMask = {
 		{{false}, {false}, {false}}};
 	U32 m_pushConstantsSize = 0;
+	U64 m_stableHash = 0; ///< Hash of the binary and the spec constants. It's the same between runs.
 
 	ShaderImpl(GrManager* manager, CString name)
 		: Shader(manager, name)
@@ -100,6 +100,12 @@ Error ShaderProgramImpl::init(const ShaderProgramInitInfo& inf)
 
 	ANKI_ASSERT(m_shaders.getSize() > 0);
 
+	for(const ShaderPtr& shader : m_shaders)
+	{
+		const U64 shaderHash = static_cast<const ShaderImpl&>(*shader).m_stableHash;
+		m_stableHash = (m_stableHash) ? appendHash(&shaderHash, sizeof(shaderHash), m_stableHash) : shaderHash;
+	}
+
 	// Merge bindings
 	//
 	Array2d<DescriptorBinding, MAX_DESCRIPTOR_SETS, MAX_BINDINGS_PER_DESCRIPTOR_SET> bindings;
@@ -223,7 +229,8 @@ Error ShaderProgramImpl::init(const ShaderProgramInitInfo& inf)
 	{
 		m_graphics.m_pplineFactory = getAllocator().newInstance<PipelineFactory>();
 		m_graphics.m_pplineFactory->init(getGrManagerImpl().getAllocator(), getGrManagerImpl().getDevice(),
-										 getGrManagerImpl().getPipelineCache()
+										 getGrManagerImpl().getPipelineCache(),
+										 &getGrManagerImpl().getPipelineManifest()
 #if ANKI_PLATFORM_MOBILE
 											 ,
 										 getGrManagerImpl().getGlobalCreatePipelineMutex()
@@ -88,6 +88,13 @@ public:
 		return m_rt.m_ppline;
 	}
 
+	/// A hash of the shaders that stays the same between runs.
+	U64 getStableHash() const
+	{
+		ANKI_ASSERT(m_stableHash);
+		return m_stableHash;
+	}
+
 	ShaderTypeBit getStages() const
 	{
 		ANKI_ASSERT(!!m_stages);
@@ -109,6 +116,7 @@ public:
 private:
 	DynamicArray<ShaderPtr> m_shaders;
 	ShaderTypeBit m_stages = ShaderTypeBit::NONE;
+	U64 m_stableHash = 0;
 
 	PipelineLayout m_pplineLayout = {};
 	Array<DescriptorSetLayout, MAX_DESCRIPTOR_SETS> m_descriptorSetLayouts;
@@ -5,6 +5,7 @@
 
 #include <AnKi/Gr/Texture.h>
 #include <AnKi/Gr/Vulkan/TextureImpl.h>
+#include <AnKi/Gr/Vulkan/GrManagerImpl.h>
 #include <AnKi/Gr/GrManager.h>
 
 namespace anki {
@@ -21,4 +22,10 @@ Texture* Texture::newInstance(GrManager* manager, const TextureInitInfo& init)
 	return impl;
 }
 
+Bool Texture::wantsRelocation() const
+{
+	ANKI_VK_SELF_CONST(TextureImpl);
+	return self.m_memHandle && self.getGrManagerImpl().getGpuMemoryManager().isEvacuating(self.m_memHandle);
+}
+
 } // end namespace anki
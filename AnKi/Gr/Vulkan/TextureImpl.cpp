@@ -453,6 +453,12 @@ void TextureImpl::computeBarrierInfo(TextureUsageBit usage, Bool src, U32 level,
 		}
 	}
 
+	if(!!(usage & TextureUsageBit::TRANSFER_SOURCE))
+	{
+		stages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+		accesses |= VK_ACCESS_TRANSFER_READ_BIT;
+	}
+
 	if(!!(usage & TextureUsageBit::TRANSFER_DESTINATION))
 	{
 		stages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
@@ -540,6 +546,10 @@ VkImageLayout TextureImpl::computeLayout(TextureUsageBit usage, U level) const
 			out = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 		}
 	}
+	else if(usage == TextureUsageBit::TRANSFER_SOURCE)
+	{
+		out = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	}
 	else if(usage == TextureUsageBit::TRANSFER_DESTINATION)
 	{
 		out = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
@@ -7,5 +7,6 @@
 
 #include <AnKi/Importer/GltfImporter.h>
 #include <AnKi/Importer/ImageImporter.h>
+#include <AnKi/Importer/PakImporter.h>
 
 /// @defgroup importer Importers
@@ -65,7 +65,7 @@ static Error findConstantColorsInImage(CString fname, Vec4& constantColor, Gener
 	ANKI_ASSERT(iloader.getColorFormat() == ImageBinaryColorFormat::RGBA8);
 	ANKI_ASSERT(iloader.getCompression() == ImageBinaryDataCompression::RAW);
 
-	const U8Vec4* data = reinterpret_cast<const U8Vec4*>(&iloader.getSurface(0, 0, 0).m_data[0]);
+	const U8Vec4* data = reinterpret_cast<const U8Vec4*>(iloader.getSurface(0, 0, 0).getData().getBegin());
 	ConstWeakArray<U8Vec4> pixels(data, iloader.getWidth() * iloader.getHeight());
 
 	const F32 epsilon = 1.0f / 255.0f;
@@ -0,0 +1,244 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Importer/PakImporter.h>
+#include <AnKi/Resource/PakArchive.h>
+#include <AnKi/Util/Compression.h>
+#include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/File.h>
+#include <AnKi/Util/Hash.h>
+#include <algorithm>
+
+namespace anki {
+
+namespace {
+
+class PakImporterFile
+{
+public:
+	StringAuto m_filename;
+	U64 m_hash;
+
+	PakImporterFile(GenericMemoryPoolAllocator<U8> alloc)
+		: m_filename(alloc)
+	{
+	}
+};
+
+class PakImporterContext
+{
+public:
+	File m_file;
+	PtrSize m_offset = 0;
+
+	Error write(const void* data, PtrSize size)
+	{
+		ANKI_CHECK(m_file.write(data, size));
+		m_offset += size;
+		return Error::NONE;
+	}
+
+	Error align()
+	{
+		static constexpr Array<U8, PAK_ALIGNMENT> zeros = {};
+		const PtrSize padding = getAlignedRoundUp(PAK_ALIGNMENT, m_offset) - m_offset;
+		return (padding) ? write(&zeros[0], padding) : Error::NONE;
+	}
+};
+
+} // end anonymous namespace
+
+/// Compress only if it saves more than that.
+static constexpr F64 MIN_COMPRESSION_GAIN = 0.1;
+
+Error importPak(const PakImporterConfig& config)
+{
+	GenericMemoryPoolAllocator<U8> alloc = config.m_allocator;
+
+	if(config.m_blockSize == 0)
+	{
+		ANKI_IMPORTER_LOGE("Wrong block size");
+		return Error::USER_DATA;
+	}
+
+	// Gather the files
+	DynamicArrayAuto<PakImporterFile> files(alloc);
+	ANKI_CHECK(walkDirectoryTree(config.m_inputDirectory, alloc, [&](const CString& fname, Bool isDir) -> Error {
+		if(isDir)
+		{
+			return Error::NONE;
+		}
+
+		for(const CString& s : config.m_excludedStrings)
+		{
+			if(fname.find(s) != CString::NPOS)
+			{
+				return Error::NONE;
+			}
+		}
+
+		PakImporterFile& file = *files.emplaceBack(alloc);
+		file.m_filename.create(fname);
+		file.m_hash = computeHash(fname.cstr(), fname.getLength());
+		return Error::NONE;
+	}));
+
+	// Sort them the way the archive will search them
+	std::sort(files.getBegin(), files.getEnd(), [](const PakImporterFile& a, const PakImporterFile& b) {
+		return (a.m_hash != b.m_hash) ? a.m_hash < b.m_hash : a.m_filename < b.m_filename;
+	});
+
+	// Write the data. The header will be written at the end
+	PakImporterContext ctx;
+	ANKI_CHECK(ctx.m_file.open(config.m_outFilename, FileOpenFlag::WRITE | FileOpenFlag::BINARY));
+
+	PakHeader header = {};
+	ANKI_CHECK(ctx.write(&header, sizeof(header)));
+
+	DynamicArrayAuto<PakEntry> entries(alloc);
+	DynamicArrayAuto<PakBlock> blocks(alloc);
+	DynamicArrayAuto<U8, PtrSize> filenames(alloc);
+	DynamicArrayAuto<U8, PtrSize> data(alloc);
+	DynamicArrayAuto<U8, PtrSize> compressedData(alloc);
+	DynamicArrayAuto<U8, PtrSize> compressedBlock(alloc);
+	compressedBlock.create(computeCompressedBufferMaxSize(config.m_blockSize));
+	PtrSize compressedFileCount = 0;
+
+	for(const PakImporterFile& f : files)
+	{
+		StringAuto fullFilename(alloc);
+		fullFilename.sprintf("%s/%s", config.m_inputDirectory.cstr(), f.m_filename.cstr());
+
+		File inFile;
+		ANKI_CHECK(inFile.open(fullFilename, FileOpenFlag::READ | FileOpenFlag::BINARY));
+		const PtrSize size = inFile.getSize();
+		data.resize(size);
+		if(size)
+		{
+			ANKI_CHECK(inFile.read(&data[0], size));
+		}
+
+		PakEntry& entry = *entries.emplaceBack();
+		entry = {};
+		entry.m_filenameHash = f.m_hash;
+		entry.m_size = size;
+		entry.m_filenameOffset = U32(filenames.getSize());
+		entry.m_filenameLength = f.m_filename.getLength();
+		entry.m_codec = PakCodec::RAW;
+
+		const PtrSize filenameOffset = filenames.getSize();
+		filenames.resize(filenameOffset + f.m_filename.getLength() + 1);
+		memcpy(&filenames[filenameOffset], f.m_filename.cstr(), f.m_filename.getLength() + 1);
+
+		// Try to compress it block by block
+		if(config.m_compress && size > 0)
+		{
+			const U32 firstBlock = blocks.getSize();
+			PtrSize compressedDataSize = 0;
+
+			for(PtrSize blockBegin = 0; blockBegin < size; blockBegin += config.m_blockSize)
+			{
+				const PtrSize blockSize = min<PtrSize>(config.m_blockSize, size - blockBegin);
+				const ConstWeakArray<U8, PtrSize> in(&data[blockBegin], blockSize);
+
+				PtrSize compressedSize;
+				ANKI_CHECK(compressBuffer(in, WeakArray<U8, PtrSize>(compressedBlock), compressedSize));
+
+				PakBlock& block = *blocks.emplaceBack();
+				block.m_offset = compressedDataSize; // Relative for now
+				block.m_uncompressedSize = U32(blockSize);
+
+				const U8* blockData;
+				if(compressedSize < blockSize)
+				{
+					block.m_compressedSize = U32(compressedSize);
+					blockData = &compressedBlock[0];
+				}
+				else
+				{
+					// Incompressible, store it as is
+					block.m_compressedSize = U32(blockSize);
+					blockData = in.getBegin();
+				}
+
+				compressedDataSize += block.m_compressedSize;
+				if(compressedData.getSize() < compressedDataSize)
+				{
+					compressedData.resize(compressedDataSize);
+				}
+				memcpy(&compressedData[block.m_offset], blockData, block.m_compressedSize);
+			}
+
+			if(F64(compressedDataSize) < F64(size) * (1.0 - MIN_COMPRESSION_GAIN))
+			{
+				for(U32 i = firstBlock; i < blocks.getSize(); ++i)
+				{
+					blocks[i].m_offset += ctx.m_offset;
+				}
+
+				entry.m_codec = PakCodec::LZ;
+				entry.m_firstBlock = firstBlock;
+				ANKI_CHECK(ctx.write(&compressedData[0], compressedDataSize));
+				++compressedFileCount;
+			}
+			else
+			{
+				// Not worth it
+				blocks.resize(firstBlock);
+			}
+		}
+
+		if(entry.m_codec == PakCodec::RAW)
+		{
+			ANKI_CHECK(ctx.align());
+			entry.m_offset = ctx.m_offset;
+			if(size)
+			{
+				ANKI_CHECK(ctx.write(&data[0], size));
+			}
+		}
+
+		ANKI_IMPORTER_LOGV("Packed %s (%s)", f.m_filename.cstr(),
+						   (entry.m_codec == PakCodec::RAW) ? "uncompressed" : "compressed");
+	}
+
+	// Write the tables
+	ANKI_CHECK(ctx.align());
+	header.m_blocksOffset = ctx.m_offset;
+	if(blocks.getSize())
+	{
+		ANKI_CHECK(ctx.write(&blocks[0], blocks.getSizeInBytes()));
+	}
+
+	ANKI_CHECK(ctx.align());
+	header.m_entriesOffset = ctx.m_offset;
+	if(entries.getSize())
+	{
+		ANKI_CHECK(ctx.write(&entries[0], entries.getSizeInBytes()));
+	}
+
+	header.m_filenamesOffset = ctx.m_offset;
+	header.m_filenamesSize = filenames.getSize();
+	if(filenames.getSize())
+	{
+		ANKI_CHECK(ctx.write(&filenames[0], filenames.getSize()));
+	}
+
+	// Write the header
+	memcpy(&header.m_magic[0], PAK_MAGIC, header.m_magic.getSize());
+	header.m_entryCount = entries.getSize();
+	header.m_blockCount = blocks.getSize();
+	header.m_blockSize = config.m_blockSize;
+
+	ANKI_CHECK(ctx.m_file.seek(0, FileSeekOrigin::BEGINNING));
+	ANKI_CHECK(ctx.m_file.write(&header, sizeof(header)));
+
+	ANKI_IMPORTER_LOGI("Packed %u files (%zu compressed) into %s", entries.getSize(), compressedFileCount,
+					   config.m_outFilename.cstr());
+
+	return Error::NONE;
+}
+
+} // end namespace anki
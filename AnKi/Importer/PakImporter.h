@@ -0,0 +1,35 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Importer/Common.h>
+#include <AnKi/Util/String.h>
+#include <AnKi/Util/WeakArray.h>
+
+namespace anki {
+
+/// @addtogroup importer
+/// @{
+
+/// Config for importPak().
+/// @relates importPak.
+class PakImporterConfig
+{
+public:
+	GenericMemoryPoolAllocator<U8> m_allocator;
+	CString m_inputDirectory;
+	CString m_outFilename;
+	ConstWeakArray<CString> m_excludedStrings; ///< Skip the files that contain one of those strings.
+	U32 m_blockSize = 64 * 1024; ///< The unit of compression and random access.
+	Bool m_compress = true; ///< If false all files will be stored uncompressed.
+};
+
+/// Packs all the files of a directory into an .ankipak archive. Files that don't compress well are stored
+/// uncompressed so they can be used in place.
+Error importPak(const PakImporterConfig& config);
+/// @}
+
+} // end namespace anki
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <AnKi/Util/StdTypes.h>
+#include <AnKi/Util/Array.h>
 
 #if ANKI_SIMD_SSE
 #	include <smmintrin.h>
@@ -46,4 +47,241 @@ public:
 };
 #endif
 
+/// @name Minimal 4-wide float operations for code that works on arrays of floats.
+/// @{
+#if ANKI_SIMD_SSE
+using F32x4 = __m128;
+using MaskX4 = __m128;
+
+inline ANKI_FORCE_INLINE F32x4 splatF32x4(F32 x)
+{
+	return _mm_set1_ps(x);
+}
+
+inline ANKI_FORCE_INLINE F32x4 setF32x4(F32 a, F32 b, F32 c, F32 d)
+{
+	return _mm_setr_ps(a, b, c, d);
+}
+
+inline ANKI_FORCE_INLINE F32x4 loadF32x4(const F32* ptr)
+{
+	return _mm_loadu_ps(ptr);
+}
+
+inline ANKI_FORCE_INLINE void storeF32x4(F32* ptr, F32x4 v)
+{
+	_mm_storeu_ps(ptr, v);
+}
+
+inline ANKI_FORCE_INLINE F32x4 addF32x4(F32x4 a, F32x4 b)
+{
+	return _mm_add_ps(a, b);
+}
+
+inline ANKI_FORCE_INLINE F32x4 mulF32x4(F32x4 a, F32x4 b)
+{
+	return _mm_mul_ps(a, b);
+}
+
+inline ANKI_FORCE_INLINE F32x4 minF32x4(F32x4 a, F32x4 b)
+{
+	return _mm_min_ps(a, b);
+}
+
+inline ANKI_FORCE_INLINE F32x4 maxF32x4(F32x4 a, F32x4 b)
+{
+	return _mm_max_ps(a, b);
+}
+
+inline ANKI_FORCE_INLINE MaskX4 greaterEqualF32x4(F32x4 a, F32x4 b)
+{
+	return _mm_cmpge_ps(a, b);
+}
+
+inline ANKI_FORCE_INLINE MaskX4 lessF32x4(F32x4 a, F32x4 b)
+{
+	return _mm_cmplt_ps(a, b);
+}
+
+inline ANKI_FORCE_INLINE MaskX4 andMaskX4(MaskX4 a, MaskX4 b)
+{
+	return _mm_and_ps(a, b);
+}
+
+/// Pick a where the mask is set and b everywhere else.
+inline ANKI_FORCE_INLINE F32x4 selectF32x4(MaskX4 mask, F32x4 a, F32x4 b)
+{
+	return _mm_blendv_ps(b, a, mask);
+}
+
+inline ANKI_FORCE_INLINE Bool anyMaskX4(MaskX4 mask)
+{
+	return _mm_movemask_ps(mask) != 0;
+}
+
+inline ANKI_FORCE_INLINE F32 horizontalMinF32x4(F32x4 v)
+{
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
+
+inline ANKI_FORCE_INLINE F32 horizontalMaxF32x4(F32x4 v)
+{
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
+#elif ANKI_SIMD_NEON
+using F32x4 = float32x4_t;
+using MaskX4 = uint32x4_t;
+
+inline ANKI_FORCE_INLINE F32x4 splatF32x4(F32 x)
+{
+	return vdupq_n_f32(x);
+}
+
+inline ANKI_FORCE_INLINE F32x4 setF32x4(F32 a, F32 b, F32 c, F32 d)
+{
+	const Array<F32, 4> arr = {a, b, c, d};
+	return vld1q_f32(&arr[0]);
+}
+
+inline ANKI_FORCE_INLINE F32x4 loadF32x4(const F32* ptr)
+{
+	return vld1q_f32(ptr);
+}
+
+inline ANKI_FORCE_INLINE void storeF32x4(F32* ptr, F32x4 v)
+{
+	vst1q_f32(ptr, v);
+}
+
+inline ANKI_FORCE_INLINE F32x4 addF32x4(F32x4 a, F32x4 b)
+{
+	return vaddq_f32(a, b);
+}
+
+inline ANKI_FORCE_INLINE F32x4 mulF32x4(F32x4 a, F32x4 b)
+{
+	return vmulq_f32(a, b);
+}
+
+inline ANKI_FORCE_INLINE F32x4 minF32x4(F32x4 a, F32x4 b)
+{
+	return vminq_f32(a, b);
+}
+
+inline ANKI_FORCE_INLINE F32x4 maxF32x4(F32x4 a, F32x4 b)
+{
+	return vmaxq_f32(a, b);
+}
+
+inline ANKI_FORCE_INLINE MaskX4 greaterEqualF32x4(F32x4 a, F32x4 b)
+{
+	return vcgeq_f32(a, b);
+}
+
+inline ANKI_FORCE_INLINE MaskX4 lessF32x4(F32x4 a, F32x4 b)
+{
+	return vcltq_f32(a, b);
+}
+
+inline ANKI_FORCE_INLINE MaskX4 andMaskX4(MaskX4 a, MaskX4 b)
+{
+	return vandq_u32(a, b);
+}
+
+/// Pick a where the mask is set and b everywhere else.
+inline ANKI_FORCE_INLINE F32x4 selectF32x4(MaskX4 mask, F32x4 a, F32x4 b)
+{
+	return vbslq_f32(mask, a, b);
+}
+
+inline ANKI_FORCE_INLINE Bool anyMaskX4(MaskX4 mask)
+{
+	return vmaxvq_u32(mask) != 0;
+}
+
+inline ANKI_FORCE_INLINE F32 horizontalMinF32x4(F32x4 v)
+{
+	return vminvq_f32(v);
+}
+
+inline ANKI_FORCE_INLINE F32 horizontalMaxF32x4(F32x4 v)
+{
+	return vmaxvq_f32(v);
+}
+#else
+using F32x4 = Array<F32, 4>;
+using MaskX4 = Array<Bool, 4>;
+
+inline F32x4 splatF32x4(F32 x)
+{
+	return {x, x, x, x};
+}
+
+inline F32x4 setF32x4(F32 a, F32 b, F32 c, F32 d)
+{
+	return {a, b, c, d};
+}
+
+inline F32x4 loadF32x4(const F32* ptr)
+{
+	return {ptr[0], ptr[1], ptr[2], ptr[3]};
+}
+
+inline void storeF32x4(F32* ptr, F32x4 v)
+{
+	memcpy(ptr, &v[0], sizeof(v));
+}
+
+#	define ANKI_F32X4_OP(name_, resultType_, expr_) \
+		inline resultType_ name_(F32x4 a, F32x4 b) \
+		{ \
+			resultType_ out; \
+			for(U32 i = 0; i < 4; ++i) \
+			{ \
+				out[i] = expr_; \
+			} \
+			return out; \
+		}
+
+ANKI_F32X4_OP(addF32x4, F32x4, a[i] + b[i])
+ANKI_F32X4_OP(mulF32x4, F32x4, a[i] * b[i])
+ANKI_F32X4_OP(minF32x4, F32x4, min(a[i], b[i]))
+ANKI_F32X4_OP(maxF32x4, F32x4, max(a[i], b[i]))
+ANKI_F32X4_OP(greaterEqualF32x4, MaskX4, a[i] >= b[i])
+ANKI_F32X4_OP(lessF32x4, MaskX4, a[i] < b[i])
+
+#	undef ANKI_F32X4_OP
+
+inline MaskX4 andMaskX4(MaskX4 a, MaskX4 b)
+{
+	return {a[0] && b[0], a[1] && b[1], a[2] && b[2], a[3] && b[3]};
+}
+
+/// Pick a where the mask is set and b everywhere else.
+inline F32x4 selectF32x4(MaskX4 mask, F32x4 a, F32x4 b)
+{
+	return {mask[0] ? a[0] : b[0], mask[1] ? a[1] : b[1], mask[2] ? a[2] : b[2], mask[3] ? a[3] : b[3]};
+}
+
+inline Bool anyMaskX4(MaskX4 mask)
+{
+	return mask[0] || mask[1] || mask[2] || mask[3];
+}
+
+inline F32 horizontalMinF32x4(F32x4 v)
+{
+	return min(min(v[0], v[1]), min(v[2], v[3]));
+}
+
+inline F32 horizontalMaxF32x4(F32x4 v)
+{
+	return max(max(v[0], v[1]), max(v[2], v[3]));
+}
+#endif
+/// @}
+
 } // end namespace anki
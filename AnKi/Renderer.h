@@ -21,6 +21,7 @@
 #include <AnKi/Renderer/RenderQueue.h>
 #include <AnKi/Renderer/IndirectSpecular.h>
 #include <AnKi/Renderer/ProbeReflections.h>
+#include <AnKi/Renderer/ProbeBaker.h>
 #include <AnKi/Renderer/Dbg.h>
 #include <AnKi/Renderer/Drawer.h>
 #include <AnKi/Renderer/UiStage.h>
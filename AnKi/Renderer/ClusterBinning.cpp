@@ -37,8 +37,6 @@ Error ClusterBinning::init()
 	variantInitInfo.addConstant("TILE_COUNT_X", m_r->getTileCounts().x());
 	variantInitInfo.addConstant("TILE_COUNT_Y", m_r->getTileCounts().y());
 	variantInitInfo.addConstant("Z_SPLIT_COUNT", m_r->getZSplitCount());
-	variantInitInfo.addConstant("RENDERING_SIZE",
-								UVec2(m_r->getInternalResolution().x(), m_r->getInternalResolution().y()));
 
 	const ShaderProgramResourceVariant* variant;
 	m_prog->getOrCreateVariant(variantInitInfo, variant);
@@ -66,6 +64,7 @@ void ClusterBinning::populateRenderGraph(RenderingContext& ctx)
 	{
 		RenderGraphDescription& rgraph = ctx.m_renderGraphDescr;
 		ComputeRenderPassDescription& pass = rgraph.newComputeRenderPass("Cluster Binning");
+		pass.setAsyncComputeEligible();
 
 		pass.newDependency(
 			RenderPassDependency(ctx.m_clusteredShading.m_clustersBufferHandle, BufferUsageBit::STORAGE_COMPUTE_WRITE));
@@ -416,6 +415,8 @@ void ClusterBinning::writeClustererBuffersTask()
 		ClusteredShadingUniforms& unis = *static_cast<ClusteredShadingUniforms*>(cs.m_clusteredShadingUniformsAddress);
 
 		unis.m_renderingSize = Vec2(F32(m_r->getInternalResolution().x()), F32(m_r->getInternalResolution().y()));
+		unis.m_renderingUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+		unis.m_halfRenderingUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax(2);
 
 		unis.m_time = F32(HighRezTimer::getCurrentTime());
 		unis.m_frame = m_r->getFrameCount() & MAX_U32;
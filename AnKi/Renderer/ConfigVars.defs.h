@@ -17,6 +17,14 @@ ANKI_CONFIG_VAR_F32(RInternalRenderScaling, 1.0f, 0.5f, 1.0f,
 					"A factor over the requested swapchain resolution. Applies to all passes up to TAA")
 ANKI_CONFIG_VAR_F32(RRenderScaling, 1.0f, 0.5f, 8.0f,
 					"A factor over the requested swapchain resolution. Applies to post-processing and UI")
+ANKI_CONFIG_VAR_BOOL(RDynamicResolution, false,
+					 "Lower the internal render scaling when the GPU time is over RDynamicResolutionTargetGpuTime")
+ANKI_CONFIG_VAR_F32(RDynamicResolutionMinScaling, 0.5f, 0.25f, 1.0f,
+					"The min internal render scaling of dynamic resolution. The max is RInternalRenderScaling")
+ANKI_CONFIG_VAR_U8(RDynamicResolutionLevelCount, 4, 2, 16,
+				   "Number of internal render scaling steps between the min and the max of dynamic resolution")
+ANKI_CONFIG_VAR_F32(RDynamicResolutionTargetGpuTime, 16.0f, 1.0f, 1000.0f,
+					"The GPU frame time in ms that dynamic resolution aims for")
 
 ANKI_CONFIG_VAR_F32(RVolumetricLightingAccumulationQualityXY, 4.0f, 1.0f, 16.0f,
 					"Quality of XY dimensions of volumetric lights")
@@ -26,6 +34,8 @@ ANKI_CONFIG_VAR_U32(RVolumetricLightingAccumulationFinalZSplit, 26, 1, 256,
 					"Final cluster split that will recieve volumetric lights")
 
 ANKI_CONFIG_VAR_BOOL(RDbgEnabled, false, "Enable or not debugging")
+ANKI_CONFIG_VAR_BOOL(RGpuVisibility, false,
+					 "Cull the renderables of the GBuffer and the shadows on the GPU and draw them indirectly")
 
 // VRS
 ANKI_CONFIG_VAR_BOOL(RVrs, true, "Enable VRS in multiple passes")
@@ -66,6 +76,10 @@ ANKI_CONFIG_VAR_U32(RShadowMappingTileCountPerRowOrColumn, 16, 1, 256,
 ANKI_CONFIG_VAR_U32(RShadowMappingScratchTileCountX, 4 * (MAX_SHADOW_CASCADES2 + 2), 1, 256,
 					"Number of tiles of the scratch buffer in X")
 ANKI_CONFIG_VAR_U32(RShadowMappingScratchTileCountY, 4, 1, 256, "Number of tiles of the scratch buffer in Y")
+ANKI_CONFIG_VAR_BOOL(RShadowMappingStaticCache, !ANKI_PLATFORM_MOBILE,
+					 "Cache the shadows of the static geometry of the point and spot lights")
+ANKI_CONFIG_VAR_U32(RShadowMappingStaticCacheTileCountPerRowOrColumn, 8, 1, 256,
+					"The static cache will have this number squared number of tiles")
 
 // Probe reflections
 ANKI_CONFIG_VAR_U32(RProbeReflectionResolution, 128, 4, 2048, "Reflection probe face resolution")
@@ -73,6 +87,11 @@ ANKI_CONFIG_VAR_U32(RProbeReflectionIrradianceResolution, 16, 4, 2048, "Reflecti
 ANKI_CONFIG_VAR_U32(RProbeRefectionMaxCachedProbes, 32, 4, 256, "Max cached number of reflection probes")
 ANKI_CONFIG_VAR_U32(RProbeReflectionShadowMapResolution, 64, 4, 2048, "Reflection probe shadow resolution")
 
+// Probe baking
+ANKI_CONFIG_VAR_STRING(RProbeBakeDirectory, "",
+					   "If not empty the static probes are rendered and stored in that directory instead of loaded. "
+					   "The baked probes are loaded from the RsrcDataPaths so the directory should be one of them")
+
 // Lens flare
 ANKI_CONFIG_VAR_U8(RLensFlareMaxSpritesPerFlare, 8, 4, 255, "Max sprites per lens flare")
 ANKI_CONFIG_VAR_U8(RLensFlareMaxFlares, 16, 8, 255, "Max flare count")
@@ -31,7 +31,8 @@ Error Dbg::init()
 	ANKI_R_LOGV("Initializing DBG");
 
 	// RT descr
-	m_rtDescr = m_r->create2DRenderTargetDescription(m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
+	m_rtDescr = m_r->create2DRenderTargetDescription(m_r->getMaxInternalResolution().x(),
+													 m_r->getMaxInternalResolution().y(),
 													 DBG_COLOR_ATTACHMENT_PIXEL_FORMAT, "Dbg");
 	m_rtDescr.bake();
 
@@ -179,7 +180,8 @@ void Dbg::populateRenderGraph(RenderingContext& ctx)
 					 run(rgraphCtx, ctx);
 				 });
 
-	pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_rt}, m_r->getGBuffer().getDepthRt());
+	pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_rt}, m_r->getGBuffer().getDepthRt(), {}, 0, 0,
+							m_r->getInternalResolution().x(), m_r->getInternalResolution().y());
 
 	pass.newDependency({m_runCtx.m_rt, TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE});
 	pass.newDependency({m_r->getGBuffer().getDepthRt(),
@@ -6,6 +6,7 @@
 #include <AnKi/Renderer/DepthDownscale.h>
 #include <AnKi/Renderer/Renderer.h>
 #include <AnKi/Renderer/GBuffer.h>
+#include <AnKi/Renderer/GpuVisibility.h>
 #include <AnKi/Core/ConfigSet.h>
 
 #if ANKI_COMPILER_GCC_COMPATIBLE
@@ -39,8 +40,9 @@ DepthDownscale::~DepthDownscale()
 
 Error DepthDownscale::initInternal()
 {
-	const U32 width = m_r->getInternalResolution().x() >> 1;
-	const U32 height = m_r->getInternalResolution().y() >> 1;
+	// The HiZ covers the whole viewport whatever the internal resolution is
+	const U32 width = m_r->getMaxInternalResolution().x() >> 1;
+	const U32 height = m_r->getMaxInternalResolution().y() >> 1;
 
 	m_mipCount = computeMaxMipmapCount2d(width, height, HIERARCHICAL_Z_MIN_HEIGHT);
 
@@ -53,6 +55,9 @@ Error DepthDownscale::initInternal()
 	const Bool preferCompute = getConfig().getRPreferCompute();
 	const Bool supportsReductionSampler = getGrManager().getDeviceCapabilities().m_samplingFilterMinMax;
 
+	// The occlusion culling of the GPU visibility needs a true max depth chain
+	m_conservative = m_r->getGpuVisibility().getEnabled();
+
 	// Create RT descr
 	{
 		TextureUsageBit usage = TextureUsageBit::ALL_SAMPLED;
@@ -77,6 +82,7 @@ Error DepthDownscale::initInternal()
 
 		ShaderProgramResourceVariantInitInfo variantInitInfo(m_prog);
 		variantInitInfo.addMutation("WAVE_OPERATIONS", 0);
+		variantInitInfo.addMutation("CONSERVATIVE", m_conservative);
 
 		const ShaderProgramResourceVariant* variant;
 		m_prog->getOrCreateVariant(variantInitInfo, variant);
@@ -88,6 +94,7 @@ Error DepthDownscale::initInternal()
 
 		ShaderProgramResourceVariantInitInfo variantInitInfo(m_prog);
 		variantInitInfo.addMutation("REDUCTION_SAMPLER", supportsReductionSampler);
+		variantInitInfo.addMutation("CONSERVATIVE", m_conservative);
 
 		const ShaderProgramResourceVariant* variant;
 		m_prog->getOrCreateVariant(variantInitInfo, variant);
@@ -187,6 +194,7 @@ void DepthDownscale::populateRenderGraph(RenderingContext& ctx)
 		// Do it with compute
 
 		ComputeRenderPassDescription& pass = rgraph.newComputeRenderPass("HiZ");
+		pass.setAsyncComputeEligible();
 
 		pass.newDependency(RenderPassDependency(m_r->getGBuffer().getDepthRt(), TextureUsageBit::SAMPLED_COMPUTE,
 												TextureSubresourceInfo(DepthStencilAspectBit::DEPTH)));
@@ -260,14 +268,15 @@ void DepthDownscale::runCompute(RenderPassWorkContext& rgraphCtx)
 	varAU2(dispatchThreadGroupCountXY);
 	varAU2(workGroupOffset); // needed if Left and Top are not 0,0
 	varAU2(numWorkGroupsAndMips);
-	varAU4(rectInfo) = initAU4(0, 0, m_r->getInternalResolution().x(), m_r->getInternalResolution().y());
+	varAU4(rectInfo) = initAU4(0, 0, m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y());
 	SpdSetup(dispatchThreadGroupCountXY, workGroupOffset, numWorkGroupsAndMips, rectInfo);
 	SpdSetup(dispatchThreadGroupCountXY, workGroupOffset, numWorkGroupsAndMips, rectInfo, m_mipCount);
 
 	DepthDownscaleUniforms pc;
 	pc.m_workgroupCount = numWorkGroupsAndMips[0];
 	pc.m_mipmapCount = numWorkGroupsAndMips[1];
-	pc.m_srcTexSizeOverOne = 1.0f / Vec2(m_r->getInternalResolution());
+	pc.m_srcTexSizeOverOne = 1.0f / Vec2(m_r->getMaxInternalResolution());
+	pc.m_srcUvScaleAndMax = computeSrcUvScaleAndMax();
 	pc.m_lastMipWidth = m_lastMipSize.x();
 
 	cmdb->setPushConstants(&pc, sizeof(pc));
@@ -305,12 +314,29 @@ void DepthDownscale::runCompute(RenderPassWorkContext& rgraphCtx)
 	cmdb->bindStorageBuffer(0, 2, m_counterBuffer, 0, MAX_PTR_SIZE);
 	cmdb->bindStorageBuffer(0, 3, m_clientBuffer, 0, MAX_PTR_SIZE);
 
-	cmdb->bindSampler(0, 4, m_r->getSamplers().m_trilinearClamp);
+	const SamplerPtr& sampler =
+		(m_conservative) ? m_r->getSamplers().m_nearestNearestClamp : m_r->getSamplers().m_trilinearClamp;
+	cmdb->bindSampler(0, 4, sampler);
 	rgraphCtx.bindTexture(0, 5, m_r->getGBuffer().getDepthRt(), TextureSubresourceInfo(DepthStencilAspectBit::DEPTH));
 
 	cmdb->dispatchCompute(dispatchThreadGroupCountXY[0], dispatchThreadGroupCountXY[1], 1);
 }
 
+Vec4 DepthDownscale::computeSrcUvScaleAndMax() const
+{
+	// Don't clamp to the center of the last rendered texel. The 1st reduction reads 2x2 texels so clamp one more half
+	// texel and never touch the parts of the depth buffer that were not rendered. The conservative compute reduction
+	// reads single texels so it doesn't need that
+	const Vec4 scaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	if(m_conservative && getConfig().getRPreferCompute())
+	{
+		return scaleAndMax;
+	}
+
+	const Vec2 halfTexel = 0.5f / Vec2(m_r->getMaxInternalResolution());
+	return Vec4(scaleAndMax.xy(), scaleAndMax.zw() - halfTexel);
+}
+
 void DepthDownscale::runGraphics(U32 mip, RenderPassWorkContext& rgraphCtx)
 {
 	CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
@@ -344,10 +370,19 @@ void DepthDownscale::runGraphics(U32 mip, RenderPassWorkContext& rgraphCtx)
 
 	cmdb->bindStorageBuffer(0, 2, m_clientBuffer, 0, MAX_PTR_SIZE);
 
-	const UVec4 pc((mip != m_mipCount - 1) ? 0 : m_lastMipSize.x());
+	class
+	{
+	public:
+		Vec4 m_uvScaleAndMax;
+
+		Vec3 m_padding;
+		U32 m_lastMipWidth;
+	} pc;
+	pc.m_uvScaleAndMax = (mip == 0) ? computeSrcUvScaleAndMax() : Vec4(1.0f);
+	pc.m_lastMipWidth = (mip != m_mipCount - 1) ? 0 : m_lastMipSize.x();
 	cmdb->setPushConstants(&pc, sizeof(pc));
 
-	const UVec2 size = (m_r->getInternalResolution() / 2) >> mip;
+	const UVec2 size = (m_r->getMaxInternalResolution() / 2) >> mip;
 	cmdb->setViewport(0, 0, size.x(), size.y());
 	cmdb->drawArrays(PrimitiveTopology::TRIANGLES, 3);
 }
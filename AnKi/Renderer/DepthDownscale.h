@@ -33,7 +33,8 @@ public:
 	/// Populate the rendergraph.
 	void populateRenderGraph(RenderingContext& ctx);
 
-	/// Return a FP color render target with hierarchical Z (min Z) in it's mips.
+	/// Return a FP color render target with hierarchical Z (max Z) in it's mips. The 1st mip holds the average depth
+	/// unless isConservative() is true.
 	RenderTargetHandle getHiZRt() const
 	{
 		return m_runCtx.m_hizRt;
@@ -44,6 +45,12 @@ public:
 		return m_mipCount;
 	}
 
+	/// If true all the mips of the HiZ hold the max depth of the texels they cover.
+	Bool isConservative() const
+	{
+		return m_conservative;
+	}
+
 	void getClientDepthMapInfo(F32*& depthValues, U32& width, U32& height) const
 	{
 		width = m_lastMipSize.x();
@@ -73,6 +80,7 @@ private:
 
 	UVec2 m_lastMipSize;
 	U32 m_mipCount = 0;
+	Bool m_conservative = false;
 
 	class
 	{
@@ -84,6 +92,8 @@ private:
 
 	void runCompute(RenderPassWorkContext& rgraphCtx);
 	void runGraphics(U32 mip, RenderPassWorkContext& rgraphCtx);
+
+	Vec4 computeSrcUvScaleAndMax() const;
 };
 /// @}
 
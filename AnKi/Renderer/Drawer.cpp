@@ -7,6 +7,8 @@
 #include <AnKi/Renderer/RenderQueue.h>
 #include <AnKi/Resource/ImageResource.h>
 #include <AnKi/Renderer/Renderer.h>
+#include <AnKi/Renderer/GpuVisibility.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Util/Logger.h>
 #include <AnKi/Shaders/Include/MaterialTypes.h>
@@ -39,12 +41,9 @@ RenderableDrawer::~RenderableDrawer()
 {
 }
 
-void RenderableDrawer::drawRange(RenderingTechnique technique, const RenderableDrawerArguments& args,
-								 const RenderableQueueElement* begin, const RenderableQueueElement* end,
-								 CommandBufferPtr& cmdb)
+void RenderableDrawer::setupDrawContext(RenderingTechnique technique, const RenderableDrawerArguments& args,
+										CommandBufferPtr& cmdb, RenderQueueDrawContext& ctx)
 {
-	ANKI_ASSERT(begin && end && begin < end);
-
 	// Allocate, set and bind global uniforms
 	{
 		StagingGpuMemoryToken globalUniformsToken;
@@ -64,19 +63,30 @@ void RenderableDrawer::drawRange(RenderingTechnique technique, const RenderableD
 	// More globals
 	cmdb->bindAllBindless(MATERIAL_SET_BINDLESS);
 	cmdb->bindSampler(MATERIAL_SET_GLOBAL, MATERIAL_BINDING_TRILINEAR_REPEAT_SAMPLER, args.m_sampler);
+	cmdb->bindStorageBuffer(MATERIAL_SET_GLOBAL, MATERIAL_BINDING_GPU_SCENE, m_r->getGpuSceneUpdate().getBuffer(), 0,
+							MAX_PTR_SIZE);
 
 	// Set a few things
+	ctx.m_viewMatrix = args.m_viewMatrix;
+	ctx.m_viewProjectionMatrix = args.m_viewProjectionMatrix;
+	ctx.m_projectionMatrix = Mat4::getIdentity(); // TODO
+	ctx.m_previousViewProjectionMatrix = args.m_previousViewProjectionMatrix;
+	ctx.m_cameraTransform = args.m_cameraTransform;
+	ctx.m_stagingGpuAllocator = &m_r->getStagingGpuMemory();
+	ctx.m_commandBuffer = cmdb;
+	ctx.m_key = RenderingKey(technique, 0, 1, false, false);
+	ctx.m_debugDraw = false;
+	ctx.m_sampler = args.m_sampler;
+}
+
+void RenderableDrawer::drawRange(RenderingTechnique technique, const RenderableDrawerArguments& args,
+								 const RenderableQueueElement* begin, const RenderableQueueElement* end,
+								 CommandBufferPtr& cmdb)
+{
+	ANKI_ASSERT(begin && end && begin < end);
+
 	Context ctx;
-	ctx.m_queueCtx.m_viewMatrix = args.m_viewMatrix;
-	ctx.m_queueCtx.m_viewProjectionMatrix = args.m_viewProjectionMatrix;
-	ctx.m_queueCtx.m_projectionMatrix = Mat4::getIdentity(); // TODO
-	ctx.m_queueCtx.m_previousViewProjectionMatrix = args.m_previousViewProjectionMatrix;
-	ctx.m_queueCtx.m_cameraTransform = args.m_cameraTransform;
-	ctx.m_queueCtx.m_stagingGpuAllocator = &m_r->getStagingGpuMemory();
-	ctx.m_queueCtx.m_commandBuffer = cmdb;
-	ctx.m_queueCtx.m_key = RenderingKey(technique, 0, 1, false, false);
-	ctx.m_queueCtx.m_debugDraw = false;
-	ctx.m_queueCtx.m_sampler = args.m_sampler;
+	setupDrawContext(technique, args, cmdb, ctx.m_queueCtx);
 
 	ANKI_ASSERT(args.m_minLod < MAX_LOD_COUNT && args.m_maxLod < MAX_LOD_COUNT && args.m_minLod <= args.m_maxLod);
 	ctx.m_minLod = U8(args.m_minLod);
@@ -93,6 +103,51 @@ void RenderableDrawer::drawRange(RenderingTechnique technique, const RenderableD
 	flushDrawcall(ctx);
 }
 
+void RenderableDrawer::drawGpuScene(RenderingTechnique technique, const RenderableDrawerArguments& args,
+									const GpuVisibilityOutput& visibility, CommandBufferPtr& cmdb)
+{
+	ANKI_ASSERT(technique == RenderingTechnique::GBUFFER || technique == RenderingTechnique::SHADOW);
+
+	RenderQueueDrawContext ctx;
+	setupDrawContext(technique, args, cmdb, ctx);
+
+	// The baseInstance of the drawcalls points to the RenderableGpuView indices the GPU visibility wrote
+	cmdb->bindStorageBuffer(MATERIAL_SET_LOCAL, MATERIAL_BINDING_RENDERABLE_GPU_VIEW_INDICES, visibility.m_buffer,
+							visibility.m_instanceIndicesOffset, visibility.m_instanceIndicesRange);
+
+	RenderQueueGpuVisibilityInfo gpuVisibilityInfo;
+	gpuVisibilityInfo.m_buffer = visibility.m_buffer;
+	ctx.m_gpuVisibility = &gpuVisibilityInfo;
+
+	// The shaders can't know which instances moved so always write the velocity
+	ctx.m_key.setVelocity(technique == RenderingTechnique::GBUFFER);
+
+	const U32 lodCount = visibility.m_maxLod - visibility.m_minLod + 1;
+	for(U32 lod = visibility.m_minLod; lod <= visibility.m_maxLod; ++lod)
+	{
+		const U32 lodIdx = lod - visibility.m_minLod;
+		ctx.m_key.setLod(lod);
+
+		for(const GpuSceneDrawGroupQueueElement& group : visibility.m_drawGroups)
+		{
+			if(technique == RenderingTechnique::SHADOW && !group.m_castsShadow)
+			{
+				continue;
+			}
+
+			// Same layout as in GpuVisibility.ankiprog
+			const U32 firstDrawcall = group.m_firstInstance * lodCount + lodIdx * group.m_instanceCount;
+			gpuVisibilityInfo.m_drawcallsOffset =
+				visibility.m_drawcallsOffset + firstDrawcall * sizeof(DrawElementsIndirectInfo);
+			gpuVisibilityInfo.m_drawcallCountOffset =
+				visibility.m_drawcallCountsOffset + (group.m_index * lodCount + lodIdx) * sizeof(U32);
+			gpuVisibilityInfo.m_maxDrawcallCount = group.m_instanceCount;
+
+			group.m_callback(ctx, ConstWeakArray<void*>(const_cast<void**>(&group.m_userData), 1));
+		}
+	}
+}
+
 void RenderableDrawer::flushDrawcall(Context& ctx)
 {
 	ctx.m_queueCtx.m_key.setLod(ctx.m_cachedRenderElementLods[0]);
@@ -13,6 +13,8 @@ namespace anki {
 
 // Forward
 class Renderer;
+class GpuVisibilityOutput;
+class RenderQueueDrawContext;
 
 /// @addtogroup renderer
 /// @{
@@ -48,11 +50,20 @@ public:
 	void drawRange(RenderingTechnique technique, const RenderableDrawerArguments& args,
 				   const RenderableQueueElement* begin, const RenderableQueueElement* end, CommandBufferPtr& cmdb);
 
+	/// Draw the instances of the GPU scene that the GPU visibility found visible. It draws one LOD at a time and the
+	/// draw groups of every LOD are sorted per material. The LODs of the RenderableDrawerArguments are ignored.
+	void drawGpuScene(RenderingTechnique technique, const RenderableDrawerArguments& args,
+					  const GpuVisibilityOutput& visibility, CommandBufferPtr& cmdb);
+
 private:
 	class Context;
 
 	Renderer* m_r;
 
+	/// Bind the global uniforms and resources of the materials and set the common members of a draw context.
+	void setupDrawContext(RenderingTechnique technique, const RenderableDrawerArguments& args, CommandBufferPtr& cmdb,
+						  RenderQueueDrawContext& ctx);
+
 	void flushDrawcall(Context& ctx);
 
 	void drawSingle(Context& ctx);
@@ -0,0 +1,99 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Renderer/DynamicResolution.h>
+
+namespace anki {
+
+void DynamicResolution::init(F32 minScaling, F32 maxScaling, U32 levelCount, Second targetGpuTime)
+{
+	ANKI_ASSERT(minScaling > 0.0f && minScaling <= maxScaling);
+	ANKI_ASSERT(targetGpuTime > 0.0);
+
+	m_minScaling = minScaling;
+	m_maxScaling = maxScaling;
+	m_targetGpuTime = targetGpuTime;
+	m_levelCount = (minScaling < maxScaling) ? max(levelCount, 2u) : 1;
+	m_crntLevel = m_levelCount - 1;
+	m_candidateLevel = m_crntLevel;
+	m_candidateFrameCount = 0;
+	m_framesToIgnore = 0;
+	m_avgGpuTime = -1.0;
+}
+
+F32 DynamicResolution::computeLevelScaling(U32 level) const
+{
+	ANKI_ASSERT(level < max(m_levelCount, 1u));
+	if(m_levelCount <= 1)
+	{
+		return m_maxScaling;
+	}
+
+	return m_minScaling + (m_maxScaling - m_minScaling) * F32(level) / F32(m_levelCount - 1);
+}
+
+Bool DynamicResolution::update(Second gpuTime)
+{
+	if(!isEnabled() || gpuTime < 0.0)
+	{
+		return false;
+	}
+
+	if(m_framesToIgnore > 0)
+	{
+		--m_framesToIgnore;
+		return false;
+	}
+
+	// Smooth it a bit. Single frames can spike for unrelated reasons
+	m_avgGpuTime = (m_avgGpuTime < 0.0) ? gpuTime : mix(m_avgGpuTime, gpuTime, 0.2);
+
+	// Assume that the GPU time is proportional to the pixel count. Find the biggest level that hits the target
+	const F32 crntScaling = getScaling();
+	U32 desiredLevel = 0;
+	for(U32 level = m_levelCount - 1; level > 0; --level)
+	{
+		const F32 scaling = computeLevelScaling(level);
+		const F32 pixelRatio = (scaling * scaling) / (crntScaling * crntScaling);
+		const Second estimatedGpuTime = m_avgGpuTime * pixelRatio;
+
+		const Second target = (level > m_crntLevel) ? m_targetGpuTime * UPSCALE_HEADROOM : m_targetGpuTime;
+		if(estimatedGpuTime <= target)
+		{
+			desiredLevel = level;
+			break;
+		}
+	}
+
+	if(desiredLevel == m_crntLevel)
+	{
+		m_candidateFrameCount = 0;
+		return false;
+	}
+
+	// Wait for the same decision for a few frames before acting on it
+	if(desiredLevel != m_candidateLevel)
+	{
+		m_candidateLevel = desiredLevel;
+		m_candidateFrameCount = 0;
+	}
+
+	++m_candidateFrameCount;
+	const U32 framesToWait = (desiredLevel < m_crntLevel) ? FRAMES_BEFORE_DOWNSCALE : FRAMES_BEFORE_UPSCALE;
+	if(m_candidateFrameCount < framesToWait)
+	{
+		return false;
+	}
+
+	const F32 newScaling = computeLevelScaling(desiredLevel);
+	m_avgGpuTime *= (newScaling * newScaling) / (crntScaling * crntScaling);
+	m_crntLevel = desiredLevel;
+	m_candidateFrameCount = 0;
+	m_framesToIgnore = FRAMES_TO_SETTLE;
+
+	return true;
+}
+
+} // end namespace anki
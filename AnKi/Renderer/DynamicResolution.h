@@ -0,0 +1,72 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Renderer/Common.h>
+
+namespace anki {
+
+/// @addtogroup renderer
+/// @{
+
+/// Picks the internal render scaling based on the GPU frame time. The scaling is quantized into a few levels between
+/// a min and a max and it changes only when the GPU time stays off target for a number of frames.
+class DynamicResolution
+{
+public:
+	DynamicResolution() = default;
+
+	DynamicResolution(const DynamicResolution&) = delete; // Non-copyable
+
+	DynamicResolution& operator=(const DynamicResolution&) = delete; // Non-copyable
+
+	/// Initialize. The scaling will start from the max.
+	void init(F32 minScaling, F32 maxScaling, U32 levelCount, Second targetGpuTime);
+
+	/// Feed the GPU time of a frame.
+	/// @param gpuTime The GPU time. Negative if not available.
+	/// @return True if the scaling changed.
+	Bool update(Second gpuTime);
+
+	F32 getScaling() const
+	{
+		return computeLevelScaling(m_crntLevel);
+	}
+
+	Bool isEnabled() const
+	{
+		return m_levelCount > 1;
+	}
+
+private:
+	/// Frames to wait before going to a lower level.
+	static constexpr U32 FRAMES_BEFORE_DOWNSCALE = 8;
+
+	/// Frames to wait before going to a higher level. It's bigger than FRAMES_BEFORE_DOWNSCALE so it doesn't oscillate.
+	static constexpr U32 FRAMES_BEFORE_UPSCALE = 60;
+
+	/// Frames to ignore after a change. The GPU time of those frames is still the one of the previous scaling.
+	static constexpr U32 FRAMES_TO_SETTLE = 8;
+
+	/// Go up only if the estimated GPU time of the higher level is less than that factor of the target.
+	static constexpr F32 UPSCALE_HEADROOM = 0.85f;
+
+	F32 m_minScaling = 1.0f;
+	F32 m_maxScaling = 1.0f;
+	Second m_targetGpuTime = 0.0;
+	Second m_avgGpuTime = -1.0;
+
+	U32 m_levelCount = 0;
+	U32 m_crntLevel = 0;
+	U32 m_candidateLevel = 0;
+	U32 m_candidateFrameCount = 0;
+	U32 m_framesToIgnore = 0;
+
+	F32 computeLevelScaling(U32 level) const;
+};
+/// @}
+
+} // end namespace anki
@@ -167,8 +167,19 @@ void FinalComposite::run(RenderingContext& ctx, RenderPassWorkContext& rgraphCtx
 			rgraphCtx.bindColorTexture(0, 9, m_r->getDbg().getRt());
 		}
 
-		const UVec4 frameCount(m_r->getFrameCount() & MAX_U32);
-		cmdb->setPushConstants(&frameCount, sizeof(frameCount));
+		class
+		{
+		public:
+			Vec4 m_renderingUvScaleAndMax;
+
+			Vec2 m_motionVectorsTexelSize;
+			F32 m_padding0;
+			U32 m_frameCount;
+		} pc;
+		pc.m_renderingUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+		pc.m_motionVectorsTexelSize = 1.0f / Vec2(m_r->getMaxInternalResolution());
+		pc.m_frameCount = m_r->getFrameCount() & MAX_U32;
+		cmdb->setPushConstants(&pc, sizeof(pc));
 	}
 	else
 	{
@@ -8,6 +8,7 @@
 #include <AnKi/Renderer/RenderQueue.h>
 #include <AnKi/Renderer/VrsSriGeneration.h>
 #include <AnKi/Renderer/Scale.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
 #include <AnKi/Util/Logger.h>
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Core/ConfigSet.h>
@@ -31,8 +32,8 @@ Error GBuffer::init()
 
 Error GBuffer::initInternal()
 {
-	ANKI_R_LOGV("Initializing GBuffer. Resolution %ux%u", m_r->getInternalResolution().x(),
-				m_r->getInternalResolution().y());
+	ANKI_R_LOGV("Initializing GBuffer. Resolution %ux%u", m_r->getMaxInternalResolution().x(),
+				m_r->getMaxInternalResolution().y());
 
 	// RTs
 	static const Array<const char*, 2> depthRtNames = {{"GBuffer depth #0", "GBuffer depth #1"}};
@@ -40,7 +41,7 @@ Error GBuffer::initInternal()
 	{
 		const TextureUsageBit usage = TextureUsageBit::ALL_SAMPLED | TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT;
 		TextureInitInfo texinit =
-			m_r->create2DRenderTargetInitInfo(m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
+			m_r->create2DRenderTargetInitInfo(m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y(),
 											  m_r->getDepthNoStencilFormat(), usage, depthRtNames[i]);
 
 		m_depthRts[i] = m_r->createAndClearRenderTarget(texinit, TextureUsageBit::SAMPLED_FRAGMENT);
@@ -50,9 +51,9 @@ Error GBuffer::initInternal()
 		{"GBuffer rt0", "GBuffer rt1", "GBuffer rt2", "GBuffer rt3"}};
 	for(U i = 0; i < GBUFFER_COLOR_ATTACHMENT_COUNT; ++i)
 	{
-		m_colorRtDescrs[i] =
-			m_r->create2DRenderTargetDescription(m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
-												 GBUFFER_COLOR_ATTACHMENT_PIXEL_FORMATS[i], rtNames[i]);
+		const UVec2 rez = m_r->getMaxInternalResolution();
+		m_colorRtDescrs[i] = m_r->create2DRenderTargetDescription(
+			rez.x(), rez.y(), GBUFFER_COLOR_ATTACHMENT_PIXEL_FORMATS[i], rtNames[i]);
 		m_colorRtDescrs[i].bake();
 	}
 
@@ -97,7 +98,8 @@ void GBuffer::runInThread(const RenderingContext& ctx, RenderPassWorkContext& rg
 
 	// Get some stuff
 	const U32 earlyZCount = ctx.m_renderQueue->m_earlyZRenderables.getSize();
-	const U32 problemSize = ctx.m_renderQueue->m_renderables.getSize() + earlyZCount;
+	const U32 renderableCount = ctx.m_renderQueue->m_renderables.getSize();
+	const U32 problemSize = earlyZCount + renderableCount + ((m_runCtx.m_gpuVisibilityEnabled) ? 1 : 0);
 	U32 start, end;
 	splitThreadedProblem(threadId, threadCount, problemSize, start, end);
 	ANKI_ASSERT(end != start);
@@ -108,7 +110,10 @@ void GBuffer::runInThread(const RenderingContext& ctx, RenderPassWorkContext& rg
 	const I32 earlyZStart = max(I32(start), 0);
 	const I32 earlyZEnd = min(I32(end), I32(earlyZCount));
 	const I32 colorStart = max(I32(start) - I32(earlyZCount), 0);
-	const I32 colorEnd = I32(end) - I32(earlyZCount);
+	const I32 colorEnd = min(I32(end) - I32(earlyZCount), I32(renderableCount));
+
+	// The GPU scene is the last element of the problem
+	const Bool drawGpuScene = m_runCtx.m_gpuVisibilityEnabled && end == problemSize;
 
 	cmdb->setRasterizationOrder(RasterizationOrder::RELAXED);
 
@@ -141,7 +146,7 @@ void GBuffer::runInThread(const RenderingContext& ctx, RenderPassWorkContext& rg
 										ctx.m_renderQueue->m_earlyZRenderables.getBegin() + earlyZEnd, cmdb);
 
 		// Restore state for the color write
-		if(colorStart < colorEnd)
+		if(colorStart < colorEnd || drawGpuScene)
 		{
 			for(U32 i = 0; i < GBUFFER_COLOR_ATTACHMENT_COUNT; ++i)
 			{
@@ -151,15 +156,24 @@ void GBuffer::runInThread(const RenderingContext& ctx, RenderPassWorkContext& rg
 	}
 
 	// Do the color writes
-	if(colorStart < colorEnd)
+	if(colorStart < colorEnd || drawGpuScene)
 	{
 		cmdb->setDepthCompareOperation(CompareOperation::LESS_EQUAL);
+	}
 
-		ANKI_ASSERT(colorStart < colorEnd && colorEnd <= I32(ctx.m_renderQueue->m_renderables.getSize()));
+	if(colorStart < colorEnd)
+	{
+		ANKI_ASSERT(colorEnd <= I32(renderableCount));
 		m_r->getSceneDrawer().drawRange(RenderingTechnique::GBUFFER, args,
 										ctx.m_renderQueue->m_renderables.getBegin() + colorStart,
 										ctx.m_renderQueue->m_renderables.getBegin() + colorEnd, cmdb);
 	}
+
+	// Draw the visible instances of the GPU scene
+	if(drawGpuScene)
+	{
+		m_r->getSceneDrawer().drawGpuScene(RenderingTechnique::GBUFFER, args, m_runCtx.m_gpuVisibility, cmdb);
+	}
 }
 
 void GBuffer::populateRenderGraph(RenderingContext& ctx)
@@ -219,13 +233,30 @@ void GBuffer::populateRenderGraph(RenderingContext& ctx)
 		sriRt = m_r->getVrsSriGeneration().getSriRt();
 	}
 
+	// Let the GPU cull the instances of the GPU scene. The rest of the renderables are drawn as usual
+	m_runCtx.m_gpuVisibilityEnabled =
+		m_r->getGpuVisibility().getEnabled() && ctx.m_renderQueue->m_gpuScene.m_drawGroups.getSize() > 0;
+	if(m_runCtx.m_gpuVisibilityEnabled)
+	{
+		GpuVisibilityInput in;
+		in.m_viewProjectionMatrix = ctx.m_matrices.m_viewProjection;
+		in.m_cameraOrigin = ctx.m_matrices.m_cameraTransform.getTranslationPart();
+		in.m_technique = RenderingTechnique::GBUFFER;
+		in.m_hizTest = true;
+
+		m_r->getGpuVisibility().populateRenderGraph("GBuffer visibility", ConstWeakArray<GpuVisibilityInput>(&in, 1),
+													ctx, WeakArray<GpuVisibilityOutput>(&m_runCtx.m_gpuVisibility, 1));
+	}
+
 	// Create pass
 	GraphicsRenderPassDescription& pass = rgraph.newGraphicsRenderPass("GBuffer");
 
 	pass.setFramebufferInfo(m_fbDescr, ConstWeakArray<RenderTargetHandle>(&rts[0], GBUFFER_COLOR_ATTACHMENT_COUNT),
-							m_runCtx.m_crntFrameDepthRt, sriRt);
+							m_runCtx.m_crntFrameDepthRt, sriRt, 0, 0, m_r->getInternalResolution().x(),
+							m_r->getInternalResolution().y());
 	pass.setWork(computeNumberOfSecondLevelCommandBuffers(ctx.m_renderQueue->m_earlyZRenderables.getSize()
-														  + ctx.m_renderQueue->m_renderables.getSize()),
+														  + ctx.m_renderQueue->m_renderables.getSize()
+														  + ((m_runCtx.m_gpuVisibilityEnabled) ? 1 : 0)),
 				 [this, &ctx](RenderPassWorkContext& rgraphCtx) {
 					 runInThread(ctx, rgraphCtx);
 				 });
@@ -239,10 +270,19 @@ void GBuffer::populateRenderGraph(RenderingContext& ctx)
 	pass.newDependency(
 		RenderPassDependency(m_runCtx.m_crntFrameDepthRt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, subresource));
 
+	pass.newDependency(
+		RenderPassDependency(m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ));
+
 	if(enableVrs)
 	{
 		pass.newDependency(RenderPassDependency(sriRt, TextureUsageBit::FRAMEBUFFER_SHADING_RATE));
 	}
+
+	if(m_runCtx.m_gpuVisibilityEnabled)
+	{
+		pass.newDependency(RenderPassDependency(m_runCtx.m_gpuVisibility.m_bufferHandle,
+												BufferUsageBit::INDIRECT_DRAW | BufferUsageBit::STORAGE_GEOMETRY_READ));
+	}
 }
 
 } // end namespace anki
@@ -0,0 +1,112 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Renderer/GpuSceneUpdate.h>
+#include <AnKi/Renderer/Renderer.h>
+#include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Util/Tracer.h>
+
+namespace anki {
+
+GpuSceneUpdate::~GpuSceneUpdate()
+{
+}
+
+Error GpuSceneUpdate::init()
+{
+	ANKI_CHECK(getResourceManager().loadResource("ShaderBinaries/GpuSceneUpdate.ankiprogbin", m_prog));
+
+	ShaderProgramResourceVariantInitInfo variantInitInfo(m_prog);
+	variantInitInfo.addMutation("INSTANCES", 0);
+	const ShaderProgramResourceVariant* variant;
+	m_prog->getOrCreateVariant(variantInitInfo, variant);
+	m_renderablesGrProg = variant->getProgram();
+
+	variantInitInfo.addMutation("INSTANCES", 1);
+	m_prog->getOrCreateVariant(variantInitInfo, variant);
+	m_instancesGrProg = variant->getProgram();
+
+	return Error::NONE;
+}
+
+void GpuSceneUpdate::populateRenderGraph(RenderingContext& ctx)
+{
+	ANKI_TRACE_SCOPED_EVENT(R_GPU_SCENE_UPDATE);
+	RenderGraphDescription& rgraph = ctx.m_renderGraphDescr;
+	const GpuSceneQueueElement& gpuScene = ctx.m_renderQueue->m_gpuScene;
+
+	// The draws of the previous frame read it so that's the usage it had
+	m_runCtx.m_buffer = (gpuScene.m_buffer) ? BufferPtr(gpuScene.m_buffer) : m_r->getDummyBuffer();
+	m_runCtx.m_bufferHandle = rgraph.importBuffer(m_runCtx.m_buffer, BufferUsageBit::STORAGE_GEOMETRY_READ);
+
+	// Same for the instances and the GPU visibility
+	m_runCtx.m_instancesBuffer.reset(gpuScene.m_instancesBuffer);
+	m_runCtx.m_instancesBufferHandle = {};
+	if(m_runCtx.m_instancesBuffer.isCreated())
+	{
+		m_runCtx.m_instancesBufferHandle =
+			rgraph.importBuffer(m_runCtx.m_instancesBuffer, BufferUsageBit::STORAGE_COMPUTE_READ);
+	}
+
+	const ConstWeakArray<GpuSceneRenderableUpdate> updates = gpuScene.m_updates;
+	const ConstWeakArray<GpuSceneInstanceUpdate> instanceUpdates = gpuScene.m_instanceUpdates;
+	if(updates.getSize() == 0 && instanceUpdates.getSize() == 0)
+	{
+		return;
+	}
+
+	// Copy the updates to GPU visible memory
+	StagingGpuMemoryToken updatesToken;
+	if(updates.getSize())
+	{
+		void* mem = allocateStorage<void*>(updates.getSizeInBytes(), updatesToken);
+		memcpy(mem, &updates[0], updates.getSizeInBytes());
+	}
+
+	StagingGpuMemoryToken instanceUpdatesToken;
+	if(instanceUpdates.getSize())
+	{
+		void* mem = allocateStorage<void*>(instanceUpdates.getSizeInBytes(), instanceUpdatesToken);
+		memcpy(mem, &instanceUpdates[0], instanceUpdates.getSizeInBytes());
+	}
+
+	ComputeRenderPassDescription& pass = rgraph.newComputeRenderPass("GPU scene update");
+
+	pass.setWork([this, updates, updatesToken, instanceUpdates,
+				  instanceUpdatesToken](RenderPassWorkContext& rgraphCtx) {
+		CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
+		scatter(updates, m_renderablesGrProg, m_runCtx.m_buffer, updatesToken, cmdb);
+		scatter(instanceUpdates, m_instancesGrProg, m_runCtx.m_instancesBuffer, instanceUpdatesToken, cmdb);
+	});
+
+	pass.newDependency({m_runCtx.m_bufferHandle, BufferUsageBit::STORAGE_COMPUTE_WRITE});
+	if(m_runCtx.m_instancesBufferHandle.isValid())
+	{
+		pass.newDependency({m_runCtx.m_instancesBufferHandle, BufferUsageBit::STORAGE_COMPUTE_WRITE});
+	}
+}
+
+template<typename TUpdate>
+void GpuSceneUpdate::scatter(ConstWeakArray<TUpdate> updates, const ShaderProgramPtr& prog, const BufferPtr& buffer,
+							 const StagingGpuMemoryToken& updatesToken, CommandBufferPtr& cmdb)
+{
+	const U32 updateCount = updates.getSize();
+	if(updateCount == 0)
+	{
+		return;
+	}
+
+	cmdb->bindShaderProgram(prog);
+	cmdb->bindStorageBuffer(0, 0, updatesToken.m_buffer, updatesToken.m_offset, updatesToken.m_range);
+	cmdb->bindStorageBuffer(0, 1, buffer, 0, MAX_PTR_SIZE);
+
+	const UVec4 pc(updateCount);
+	cmdb->setPushConstants(&pc, sizeof(pc));
+
+	constexpr U32 WORKGROUP_SIZE = 64;
+	cmdb->dispatchCompute((updateCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+}
+
+} // end namespace anki
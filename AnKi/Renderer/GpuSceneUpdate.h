@@ -0,0 +1,75 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Renderer/RendererObject.h>
+
+namespace anki {
+
+/// @addtogroup renderer
+/// @{
+
+/// Uploads the RenderableGpuViews and the GpuSceneInstances that changed this frame to the persistent GPU scene.
+class GpuSceneUpdate : public RendererObject
+{
+public:
+	GpuSceneUpdate(Renderer* r)
+		: RendererObject(r)
+	{
+	}
+
+	~GpuSceneUpdate();
+
+	Error init();
+
+	/// Populate the rendergraph. Call it before anything that draws renderables.
+	void populateRenderGraph(RenderingContext& ctx);
+
+	/// The GPU scene of this frame. It should be bound to MATERIAL_BINDING_GPU_SCENE.
+	const BufferPtr& getBuffer() const
+	{
+		return m_runCtx.m_buffer;
+	}
+
+	/// The passes that draw renderables should depend on it with BufferUsageBit::STORAGE_GEOMETRY_READ.
+	BufferHandle getBufferHandle() const
+	{
+		return m_runCtx.m_bufferHandle;
+	}
+
+	/// The GpuSceneInstances of this frame. It's invalid if GPU driven rendering is disabled.
+	const BufferPtr& getInstancesBuffer() const
+	{
+		return m_runCtx.m_instancesBuffer;
+	}
+
+	/// The GPU visibility should depend on it with BufferUsageBit::STORAGE_COMPUTE_READ.
+	BufferHandle getInstancesBufferHandle() const
+	{
+		return m_runCtx.m_instancesBufferHandle;
+	}
+
+private:
+	ShaderProgramResourcePtr m_prog;
+	ShaderProgramPtr m_renderablesGrProg;
+	ShaderProgramPtr m_instancesGrProg;
+
+	class
+	{
+	public:
+		BufferPtr m_buffer;
+		BufferHandle m_bufferHandle;
+		BufferPtr m_instancesBuffer;
+		BufferHandle m_instancesBufferHandle;
+	} m_runCtx; ///< Run context.
+
+	template<typename TUpdate>
+	static void scatter(ConstWeakArray<TUpdate> updates, const ShaderProgramPtr& prog, const BufferPtr& buffer,
+						const StagingGpuMemoryToken& updatesToken, CommandBufferPtr& cmdb);
+};
+/// @}
+
+} // end namespace anki
@@ -0,0 +1,230 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Renderer/GpuVisibility.h>
+#include <AnKi/Renderer/Renderer.h>
+#include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Renderer/DepthDownscale.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
+#include <AnKi/Core/ConfigSet.h>
+#include <AnKi/Util/Tracer.h>
+
+namespace anki {
+
+class GpuVisibility::Job
+{
+public:
+	Mat4 m_viewProjectionMatrix;
+	Mat4 m_hizViewProjectionMatrix;
+	Vec3 m_cameraOrigin;
+	PtrSize m_drawcallsOffset;
+	PtrSize m_drawcallCountsOffset;
+	PtrSize m_instanceIndicesOffset;
+	U32 m_drawcallCount; ///< The max number of drawcalls of all the LODs.
+	U32 m_drawcallCountCount;
+	U32 m_minLod;
+	U32 m_maxLod;
+	Bool m_shadowCastersOnly;
+	Bool m_hizTest;
+};
+
+GpuVisibility::~GpuVisibility()
+{
+}
+
+Error GpuVisibility::init()
+{
+	m_enabled = getConfig().getRGpuVisibility() && getGrManager().getDeviceCapabilities().m_drawIndirectCount;
+	if(!m_enabled)
+	{
+		return Error::NONE;
+	}
+
+	ANKI_R_LOGV("Initializing GPU visibility");
+
+	const Error err = getResourceManager().loadResource("ShaderBinaries/GpuVisibility.ankiprogbin", m_prog);
+	if(err)
+	{
+		ANKI_R_LOGE("Failed to initialize GPU visibility");
+		return err;
+	}
+
+	const ShaderProgramResourceVariant* variant;
+	m_prog->getOrCreateVariant(variant);
+	m_grProg = variant->getProgram();
+
+	return Error::NONE;
+}
+
+void GpuVisibility::populateRenderGraph(CString passName, ConstWeakArray<GpuVisibilityInput> inputs,
+										RenderingContext& ctx, WeakArray<GpuVisibilityOutput> outputs)
+{
+	ANKI_TRACE_SCOPED_EVENT(R_GPU_VISIBILITY);
+	ANKI_ASSERT(m_enabled);
+	ANKI_ASSERT(inputs.getSize() > 0 && inputs.getSize() == outputs.getSize());
+	const GpuSceneQueueElement& gpuScene = ctx.m_renderQueue->m_gpuScene;
+	ANKI_ASSERT(gpuScene.m_drawGroups.getSize() > 0);
+
+	// The passes of the previous frames are done with those offsets
+	if(m_runCtx.m_frame != m_r->getFrameCount())
+	{
+		m_runCtx.m_frame = m_r->getFrameCount();
+		m_runCtx.m_bufferHandle = {};
+		m_runCtx.m_bufferOffset = 0;
+
+		// The draw groups are the same for all the passes of the frame. The unused ones have zero instances
+		GpuVisibilityDrawGroup* groups = allocateStorage<GpuVisibilityDrawGroup*>(
+			gpuScene.m_drawGroupCount * sizeof(GpuVisibilityDrawGroup), m_runCtx.m_drawGroupsToken);
+		memset(groups, 0, gpuScene.m_drawGroupCount * sizeof(GpuVisibilityDrawGroup));
+		for(const GpuSceneDrawGroupQueueElement& el : gpuScene.m_drawGroups)
+		{
+			GpuVisibilityDrawGroup& group = groups[el.m_index];
+			for(U32 lod = 0; lod < MAX_LOD_COUNT; ++lod)
+			{
+				group.m_firstIndices[lod] = el.m_firstIndices[lod];
+				group.m_indexCounts[lod] = el.m_indexCounts[lod];
+			}
+			group.m_firstInstance = el.m_firstInstance;
+			group.m_instanceCount = el.m_instanceCount;
+			group.m_castsShadow = el.m_castsShadow;
+		}
+	}
+
+	// Compute the memory needed for the drawcalls, the counts and the indices. Every LOD of a group has room for all
+	// the instances of the group
+	const PtrSize alignment = getGrManager().getDeviceCapabilities().m_storageBufferBindOffsetAlignment;
+	PtrSize size = 0;
+	for(const GpuVisibilityInput& in : inputs)
+	{
+		ANKI_ASSERT(in.m_minLod <= in.m_maxLod && in.m_maxLod < MAX_LOD_COUNT);
+		const U32 lodCount = in.m_maxLod - in.m_minLod + 1;
+		const U32 drawcallCount = gpuScene.m_drawGroupInstanceCount * lodCount;
+		size += getAlignedRoundUp(alignment, gpuScene.m_drawGroupCount * lodCount * sizeof(U32));
+		size += getAlignedRoundUp(alignment, drawcallCount * sizeof(DrawElementsIndirectInfo));
+		size += getAlignedRoundUp(alignment, drawcallCount * sizeof(U32));
+	}
+
+	// Grow the buffer if needed. The passes that were added before will keep the old one alive
+	BufferPtr& buffer = m_buffers[m_r->getFrameCount() % MAX_FRAMES_IN_FLIGHT];
+	if(!buffer.isCreated() || m_runCtx.m_bufferOffset + size > buffer->getSize())
+	{
+		BufferInitInfo buffInit("GpuVisibility");
+		buffInit.m_size = max<PtrSize>((buffer.isCreated()) ? buffer->getSize() * 2 : 64_KB, size);
+		buffInit.m_usage = BufferUsageBit::INDIRECT_DRAW | BufferUsageBit::STORAGE_COMPUTE_WRITE
+						   | BufferUsageBit::STORAGE_GEOMETRY_READ | BufferUsageBit::TRANSFER_DESTINATION;
+		buffer = getGrManager().newBuffer(buffInit);
+
+		m_runCtx.m_bufferHandle = {};
+		m_runCtx.m_bufferOffset = 0;
+	}
+
+	if(!m_runCtx.m_bufferHandle.isValid())
+	{
+		m_runCtx.m_bufferHandle = ctx.m_renderGraphDescr.importBuffer(buffer, BufferUsageBit::NONE);
+	}
+
+	// Allocate the memory of the jobs
+	const Bool hizValid = m_r->getFrameCount() > 0;
+	Job* jobs = ctx.m_tempAllocator.newArray<Job>(inputs.getSize());
+	for(U32 i = 0; i < inputs.getSize(); ++i)
+	{
+		const GpuVisibilityInput& in = inputs[i];
+		GpuVisibilityOutput& out = outputs[i];
+		Job& job = jobs[i];
+		ANKI_ASSERT(in.m_technique == RenderingTechnique::GBUFFER || in.m_technique == RenderingTechnique::SHADOW);
+		const U32 lodCount = in.m_maxLod - in.m_minLod + 1;
+
+		job.m_viewProjectionMatrix = in.m_viewProjectionMatrix;
+		job.m_hizViewProjectionMatrix = ctx.m_prevMatrices.m_viewProjection;
+		job.m_cameraOrigin = in.m_cameraOrigin;
+		job.m_drawcallCount = gpuScene.m_drawGroupInstanceCount * lodCount;
+		job.m_drawcallCountCount = gpuScene.m_drawGroupCount * lodCount;
+		job.m_minLod = in.m_minLod;
+		job.m_maxLod = in.m_maxLod;
+		job.m_shadowCastersOnly = in.m_technique == RenderingTechnique::SHADOW;
+		job.m_hizTest = in.m_hizTest && hizValid;
+
+		job.m_drawcallCountsOffset = m_runCtx.m_bufferOffset;
+		m_runCtx.m_bufferOffset += getAlignedRoundUp(alignment, job.m_drawcallCountCount * sizeof(U32));
+		job.m_drawcallsOffset = m_runCtx.m_bufferOffset;
+		m_runCtx.m_bufferOffset += getAlignedRoundUp(alignment, job.m_drawcallCount * sizeof(DrawElementsIndirectInfo));
+		job.m_instanceIndicesOffset = m_runCtx.m_bufferOffset;
+		m_runCtx.m_bufferOffset += getAlignedRoundUp(alignment, job.m_drawcallCount * sizeof(U32));
+
+		out.m_drawGroups = gpuScene.m_drawGroups;
+		out.m_buffer = buffer;
+		out.m_bufferHandle = m_runCtx.m_bufferHandle;
+		out.m_drawcallsOffset = job.m_drawcallsOffset;
+		out.m_drawcallCountsOffset = job.m_drawcallCountsOffset;
+		out.m_instanceIndicesOffset = job.m_instanceIndicesOffset;
+		out.m_instanceIndicesRange = job.m_drawcallCount * sizeof(U32);
+		out.m_minLod = in.m_minLod;
+		out.m_maxLod = in.m_maxLod;
+	}
+
+	// Create the pass
+	ComputeRenderPassDescription& pass = ctx.m_renderGraphDescr.newComputeRenderPass(passName);
+
+	pass.setWork([this, jobs, jobCount = inputs.getSize(), buffer, drawGroupsToken = m_runCtx.m_drawGroupsToken,
+				  instanceCount = gpuScene.m_instanceCount](RenderPassWorkContext& rgraphCtx) {
+		run(ConstWeakArray<Job>(jobs, jobCount), buffer, drawGroupsToken, instanceCount, rgraphCtx);
+	});
+
+	pass.newDependency({m_runCtx.m_bufferHandle, BufferUsageBit::STORAGE_COMPUTE_WRITE});
+	pass.newDependency({m_r->getGpuSceneUpdate().getInstancesBufferHandle(), BufferUsageBit::STORAGE_COMPUTE_READ});
+	pass.newDependency({m_r->getDepthDownscale().getHiZRt(), TextureUsageBit::SAMPLED_COMPUTE});
+}
+
+void GpuVisibility::run(ConstWeakArray<Job> jobs, const BufferPtr& buffer,
+						const StagingGpuMemoryToken& drawGroupsToken, U32 instanceCount,
+						RenderPassWorkContext& rgraphCtx)
+{
+	CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
+
+	// Zero the drawcall counts
+	for(const Job& job : jobs)
+	{
+		cmdb->fillBuffer(buffer, job.m_drawcallCountsOffset, job.m_drawcallCountCount * sizeof(U32), 0);
+	}
+
+	const PtrSize firstOffset = jobs[0].m_drawcallCountsOffset;
+	const PtrSize lastOffset = jobs.getBack().m_instanceIndicesOffset + jobs.getBack().m_drawcallCount * sizeof(U32);
+	cmdb->setBufferBarrier(buffer, BufferUsageBit::TRANSFER_DESTINATION, BufferUsageBit::STORAGE_COMPUTE_WRITE,
+						   firstOffset, lastOffset - firstOffset);
+
+	// Cull. The HiZ test needs the max depth in all the mips
+	ANKI_ASSERT(m_r->getDepthDownscale().isConservative());
+	cmdb->bindShaderProgram(m_grProg);
+	cmdb->bindStorageBuffer(0, 1, m_r->getGpuSceneUpdate().getInstancesBuffer(), 0, MAX_PTR_SIZE);
+	cmdb->bindStorageBuffer(0, 2, drawGroupsToken.m_buffer, drawGroupsToken.m_offset, drawGroupsToken.m_range);
+	cmdb->bindSampler(0, 6, m_r->getSamplers().m_nearestNearestClamp);
+	rgraphCtx.bindColorTexture(0, 7, m_r->getDepthDownscale().getHiZRt());
+
+	for(const Job& job : jobs)
+	{
+		GpuVisibilityUniforms* unis =
+			allocateAndBindUniforms<GpuVisibilityUniforms*>(sizeof(GpuVisibilityUniforms), cmdb, 0, 0);
+		unis->m_viewProjectionMatrix = job.m_viewProjectionMatrix;
+		unis->m_hizViewProjectionMatrix = job.m_hizViewProjectionMatrix;
+		unis->m_cameraOrigin = job.m_cameraOrigin;
+		unis->m_instanceCount = instanceCount;
+		unis->m_hizSize = Vec2(m_r->getMaxInternalResolution() / 2u);
+		unis->m_hizMipCount = (job.m_hizTest) ? m_r->getDepthDownscale().getMipmapCount() : 0;
+		unis->m_shadowCastersOnly = job.m_shadowCastersOnly;
+		unis->m_lodDistances = Vec2(getConfig().getLod0MaxDistance(), getConfig().getLod1MaxDistance());
+		unis->m_minLod = job.m_minLod;
+		unis->m_maxLod = job.m_maxLod;
+
+		cmdb->bindStorageBuffer(0, 3, buffer, job.m_drawcallCountsOffset, job.m_drawcallCountCount * sizeof(U32));
+		cmdb->bindStorageBuffer(0, 4, buffer, job.m_drawcallsOffset,
+								job.m_drawcallCount * sizeof(DrawElementsIndirectInfo));
+		cmdb->bindStorageBuffer(0, 5, buffer, job.m_instanceIndicesOffset, job.m_drawcallCount * sizeof(U32));
+
+		constexpr U32 WORKGROUP_SIZE = 64;
+		cmdb->dispatchCompute((instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+	}
+}
+
+} // end namespace anki
@@ -0,0 +1,102 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Renderer/RendererObject.h>
+#include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Shaders/Include/GpuSceneTypes.h>
+
+namespace anki {
+
+/// @addtogroup renderer
+/// @{
+
+/// @memberof GpuVisibility
+class GpuVisibilityInput
+{
+public:
+	Mat4 m_viewProjectionMatrix;
+	Vec3 m_cameraOrigin = Vec3(0.0f); ///< Used to compute the LOD.
+	RenderingTechnique m_technique = RenderingTechnique::GBUFFER; ///< GBUFFER or SHADOW.
+	U32 m_minLod = 0;
+	U32 m_maxLod = MAX_LOD_COUNT - 1;
+	Bool m_hizTest = false; ///< Test against the HiZ of the previous frame. Makes sense only for the main camera.
+};
+
+/// @memberof GpuVisibility
+class GpuVisibilityOutput
+{
+public:
+	/// The draw groups of the GPU scene. Every LOD of a group has its own indirect drawcalls.
+	ConstWeakArray<GpuSceneDrawGroupQueueElement> m_drawGroups;
+
+	BufferPtr m_buffer; ///< Holds the drawcalls, the drawcall counts and the indices of the visible instances.
+
+	/// The passes that draw should depend on it with BufferUsageBit::INDIRECT_DRAW and
+	/// BufferUsageBit::STORAGE_GEOMETRY_READ.
+	BufferHandle m_bufferHandle;
+
+	PtrSize m_drawcallsOffset = 0;
+	PtrSize m_drawcallCountsOffset = 0;
+
+	/// The RenderableGpuView indices of the visible instances. Bind it to MATERIAL_BINDING_RENDERABLE_GPU_VIEW_INDICES.
+	PtrSize m_instanceIndicesOffset = 0;
+	PtrSize m_instanceIndicesRange = 0;
+
+	U32 m_minLod = 0;
+	U32 m_maxLod = 0;
+};
+
+/// Culls the instances of the GPU scene and writes the indirect drawcalls of the visible ones. The instances of a draw
+/// group that have the same LOD become a single indirect count drawcall. See RenderableDrawer::drawGpuScene().
+class GpuVisibility : public RendererObject
+{
+public:
+	GpuVisibility(Renderer* r)
+		: RendererObject(r)
+	{
+	}
+
+	~GpuVisibility();
+
+	Error init();
+
+	/// If true the passes should use GPU visibility.
+	Bool getEnabled() const
+	{
+		return m_enabled;
+	}
+
+	/// Add a compute pass that culls the GPU scene for a few views. Call it before populating the passes that will draw
+	/// them and only if there are draw groups in the GpuSceneQueueElement.
+	void populateRenderGraph(CString passName, ConstWeakArray<GpuVisibilityInput> inputs, RenderingContext& ctx,
+							 WeakArray<GpuVisibilityOutput> outputs);
+
+private:
+	class Job;
+
+	ShaderProgramResourcePtr m_prog;
+	ShaderProgramPtr m_grProg;
+
+	Array<BufferPtr, MAX_FRAMES_IN_FLIGHT> m_buffers;
+
+	Bool m_enabled = false;
+
+	class
+	{
+	public:
+		U64 m_frame = MAX_U64;
+		BufferHandle m_bufferHandle;
+		PtrSize m_bufferOffset = 0;
+		StagingGpuMemoryToken m_drawGroupsToken; ///< An array of GpuVisibilityDrawGroup.
+	} m_runCtx; ///< Run context.
+
+	void run(ConstWeakArray<Job> jobs, const BufferPtr& buffer, const StagingGpuMemoryToken& drawGroupsToken,
+			 U32 instanceCount, RenderPassWorkContext& rgraphCtx);
+};
+/// @}
+
+} // end namespace anki
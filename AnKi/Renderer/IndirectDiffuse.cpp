@@ -30,8 +30,8 @@ Error IndirectDiffuse::init()
 
 Error IndirectDiffuse::initInternal()
 {
-	const UVec2 size = m_r->getInternalResolution() / 2;
-	ANKI_ASSERT((m_r->getInternalResolution() % 2) == UVec2(0u) && "Needs to be dividable for proper upscaling");
+	const UVec2 size = m_r->getMaxInternalResolution() / 2;
+	ANKI_ASSERT((m_r->getMaxInternalResolution() % 2) == UVec2(0u) && "Needs to be dividable for proper upscaling");
 
 	ANKI_R_LOGV("Initializing indirect diffuse. Resolution %ux%u", size.x(), size.y());
 
@@ -230,8 +230,10 @@ void IndirectDiffuse::populateRenderGraph(RenderingContext& ctx)
 		else
 		{
 			GraphicsRenderPassDescription& rpass = rgraph.newGraphicsRenderPass("IndirectDiffuse");
+			const UVec2 viewport = m_r->getInternalResolution() / 2u;
 			rpass.setFramebufferInfo(m_main.m_fbDescr, {m_runCtx.m_mainRtHandles[WRITE]}, {},
-									 (enableVrs) ? m_runCtx.m_sriRt : RenderTargetHandle());
+									 (enableVrs) ? m_runCtx.m_sriRt : RenderTargetHandle(), 0, 0, viewport.x(),
+									 viewport.y());
 			readUsage = TextureUsageBit::SAMPLED_FRAGMENT;
 			writeUsage = TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE;
 			prpass = &rpass;
@@ -292,6 +294,8 @@ void IndirectDiffuse::populateRenderGraph(RenderingContext& ctx)
 			unis.m_sampleCountf = F32(unis.m_sampleCount);
 			unis.m_ssaoBias = getConfig().getRIndirectDiffuseSsaoBias();
 			unis.m_ssaoStrength = getConfig().getRIndirectDiffuseSsaoStrength();
+			unis.m_gbufferUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+			unis.m_prevUvScaleAndMax = m_r->getPreviousInternalResolutionUvScaleAndMax(2);
 			cmdb->setPushConstants(&unis, sizeof(unis));
 
 			if(getConfig().getRPreferCompute())
@@ -332,7 +336,9 @@ void IndirectDiffuse::populateRenderGraph(RenderingContext& ctx)
 		{
 			GraphicsRenderPassDescription& rpass =
 				rgraph.newGraphicsRenderPass((dir == 0) ? "IndirectDiffuseDenoiseH" : "IndirectDiffuseDenoiseV");
-			rpass.setFramebufferInfo(m_denoise.m_fbDescr, {m_runCtx.m_mainRtHandles[!readIdx]});
+			const UVec2 viewport = m_r->getInternalResolution() / 2u;
+			rpass.setFramebufferInfo(m_denoise.m_fbDescr, {m_runCtx.m_mainRtHandles[!readIdx]}, {}, {}, 0, 0,
+									 viewport.x(), viewport.y());
 			readUsage = TextureUsageBit::SAMPLED_FRAGMENT;
 			writeUsage = TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE;
 			prpass = &rpass;
@@ -366,6 +372,7 @@ void IndirectDiffuse::populateRenderGraph(RenderingContext& ctx)
 			unis.m_viewportSizef = Vec2(unis.m_viewportSize);
 			unis.m_sampleCountDiv2 = F32(getConfig().getRIndirectDiffuseDenoiseSampleCount());
 			unis.m_sampleCountDiv2 = max(1.0f, std::round(unis.m_sampleCountDiv2 / 2.0f));
+			unis.m_toDenoiseUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax(2);
 
 			cmdb->setPushConstants(&unis, sizeof(unis));
 
@@ -6,6 +6,8 @@
 #include <AnKi/Renderer/IndirectDiffuseProbes.h>
 #include <AnKi/Renderer/Renderer.h>
 #include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
+#include <AnKi/Renderer/ProbeBaker.h>
 #include <AnKi/Core/ConfigSet.h>
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Collision/Aabb.h>
@@ -38,6 +40,7 @@ public:
 	GlobalIlluminationProbeQueueElement*
 		m_probeToUpdateThisFrame ANKI_DEBUG_CODE(= numberToPtr<GlobalIlluminationProbeQueueElement*>(1));
 	UVec3 m_cellOfTheProbeToUpdateThisFrame ANKI_DEBUG_CODE(= UVec3(MAX_U32));
+	Bool m_probeToUpdateThisFrameIsComplete ANKI_DEBUG_CODE(= false); ///< It's the last cell of the probe.
 
 	Array<RenderTargetHandle, GBUFFER_COLOR_ATTACHMENT_COUNT> m_gbufferColorRts;
 	RenderTargetHandle m_gbufferDepthRt;
@@ -286,6 +289,7 @@ void IndirectDiffuseProbes::populateRenderGraph(RenderingContext& rctx)
 
 		TextureSubresourceInfo subresource(DepthStencilAspectBit::DEPTH);
 		pass.newDependency({giCtx->m_gbufferDepthRt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, subresource});
+		pass.newDependency({m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ});
 	}
 
 	// Shadow pass. Optional
@@ -323,6 +327,7 @@ void IndirectDiffuseProbes::populateRenderGraph(RenderingContext& rctx)
 
 		TextureSubresourceInfo subresource(DepthStencilAspectBit::DEPTH);
 		pass.newDependency({giCtx->m_shadowsRt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, subresource});
+		pass.newDependency({m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ});
 	}
 	else
 	{
@@ -374,6 +379,16 @@ void IndirectDiffuseProbes::populateRenderGraph(RenderingContext& rctx)
 		const U32 probeIdx = U32(giCtx->m_probeToUpdateThisFrame - &giCtx->m_ctx->m_renderQueue->m_giProbes.getFront());
 		pass.newDependency({giCtx->m_irradianceProbeRts[probeIdx], TextureUsageBit::IMAGE_COMPUTE_WRITE});
 	}
+
+	// Store the probe if it's baking and all its cells are rendered
+	const GlobalIlluminationProbeQueueElement& probe = *giCtx->m_probeToUpdateThisFrame;
+	if(m_r->getProbeBaker().isEnabled() && probe.m_bakedImageFilename && giCtx->m_probeToUpdateThisFrameIsComplete)
+	{
+		const U32 probeIdx = U32(&probe - &giCtx->m_ctx->m_renderQueue->m_giProbes.getFront());
+		const UVec3 volumeSize(probe.m_cellCounts.x() * 6, probe.m_cellCounts.y(), probe.m_cellCounts.z());
+		m_r->getProbeBaker().readbackGlobalIlluminationProbe(rctx, giCtx->m_irradianceProbeRts[probeIdx], volumeSize,
+															 probe.m_bakedImageFilename);
+	}
 }
 
 void IndirectDiffuseProbes::prepareProbes(InternalContext& giCtx)
@@ -408,6 +423,37 @@ void IndirectDiffuseProbes::prepareProbes(InternalContext& giCtx)
 
 		GlobalIlluminationProbeQueueElement& probe = ctx.m_renderQueue->m_giProbes[probeIdx];
 
+		// Static probe with an offline bake, use the bake as is and skip the cache
+		if(probe.m_bakedTexture && probe.m_bakedTexture->getWidth() == probe.m_cellCounts.x() * 6
+		   && probe.m_bakedTexture->getHeight() == probe.m_cellCounts.y()
+		   && probe.m_bakedTexture->getDepth() == probe.m_cellCounts.z())
+		{
+			// Probes might share the same bake and it can't be imported twice
+			RenderTargetHandle rt;
+			for(U32 i = 0; i < newListOfProbeCount; ++i)
+			{
+				if(newListOfProbes[i].m_bakedTexture == probe.m_bakedTexture)
+				{
+					rt = volumeRts[i];
+					break;
+				}
+			}
+
+			if(!rt.isValid())
+			{
+				rt = ctx.m_renderGraphDescr.importRenderTarget(TexturePtr(probe.m_bakedTexture),
+															   TextureUsageBit::SAMPLED_FRAGMENT);
+			}
+
+			volumeRts[newListOfProbeCount] = rt;
+			newListOfProbes[newListOfProbeCount++] = probe;
+			continue;
+		}
+		else if(probe.m_bakedTexture)
+		{
+			ANKI_R_LOGW("The baked image of a GI probe doesn't match the probe's cell counts. Will render it");
+		}
+
 		// Find cache entry
 		const U32 cacheEntryIdx = findBestCacheEntry(probe.m_uuid, m_r->getGlobalTimestamp(), m_cacheEntries,
 													 m_probeUuidToCacheEntryIdx, getAllocator());
@@ -496,6 +542,8 @@ void IndirectDiffuseProbes::prepareProbes(InternalContext& giCtx)
 							  giCtx.m_cellOfTheProbeToUpdateThisFrame.z(), giCtx.m_cellOfTheProbeToUpdateThisFrame.y(),
 							  giCtx.m_cellOfTheProbeToUpdateThisFrame.x());
 
+		giCtx.m_probeToUpdateThisFrameIsComplete = entry.m_renderedCells == probe.m_totalCellCount;
+
 		// Inform probe about its next frame
 		if(entry.m_renderedCells == probe.m_totalCellCount)
 		{
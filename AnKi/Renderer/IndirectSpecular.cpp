@@ -32,7 +32,7 @@ Error IndirectSpecular::init()
 
 Error IndirectSpecular::initInternal()
 {
-	const UVec2 size = m_r->getInternalResolution() / 2;
+	const UVec2 size = m_r->getMaxInternalResolution() / 2;
 	const Bool preferCompute = getConfig().getRPreferCompute();
 
 	ANKI_R_LOGV("Initializing indirect specular. Resolution %ux%u", size.x(), size.y());
@@ -126,9 +126,11 @@ void IndirectSpecular::populateRenderGraph(RenderingContext& ctx)
 		else
 		{
 			GraphicsRenderPassDescription& pass = rgraph.newGraphicsRenderPass("SSR");
+			const UVec2 viewport = m_r->getInternalResolution() / 2;
 			pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_rts[WRITE]}, {},
 									(enableVrs) ? m_r->getVrsSriGeneration().getDownscaledSriRt()
-												: RenderTargetHandle());
+												: RenderTargetHandle(),
+									0, 0, viewport.x(), viewport.y());
 
 			ppass = &pass;
 			readUsage = TextureUsageBit::SAMPLED_FRAGMENT;
@@ -171,8 +173,8 @@ void IndirectSpecular::run(const RenderingContext& ctx, RenderPassWorkContext& r
 
 	// Bind uniforms
 	SsrUniforms* unis = allocateAndBindUniforms<SsrUniforms*>(sizeof(SsrUniforms), cmdb, 0, 0);
-	unis->m_depthBufferSize = m_r->getInternalResolution() >> (depthLod + 1);
-	unis->m_framebufferSize = UVec2(m_r->getInternalResolution().x(), m_r->getInternalResolution().y()) / 2;
+	unis->m_depthBufferSize = m_r->getMaxInternalResolution() >> (depthLod + 1);
+	unis->m_framebufferSize = m_r->getInternalResolution() / 2;
 	unis->m_frameCount = m_r->getFrameCount() & MAX_U32;
 	unis->m_depthMipCount = m_r->getDepthDownscale().getMipmapCount();
 	unis->m_maxSteps = getConfig().getRSsrMaxSteps();
@@ -184,6 +186,8 @@ void IndirectSpecular::run(const RenderingContext& ctx, RenderPassWorkContext& r
 	unis->m_invProjMat = ctx.m_matrices.m_projectionJitter.getInverse();
 	unis->m_normalMat = Mat3x4(Vec3(0.0f), ctx.m_matrices.m_view.getRotationPart());
 	unis->m_roughnessCutoff = getConfig().getRSsrRoughnessCutoff();
+	unis->m_gbufferUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	unis->m_prevUvScaleAndMax = m_r->getPreviousInternalResolutionUvScaleAndMax(2);
 
 	// Bind all
 	cmdb->bindSampler(0, 1, m_r->getSamplers().m_trilinearClamp);
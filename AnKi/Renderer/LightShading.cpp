@@ -81,7 +81,7 @@ Error LightShading::initLightShading()
 
 	// Create RT descr
 	m_lightShading.m_rtDescr = m_r->create2DRenderTargetDescription(
-		m_r->getInternalResolution().x(), m_r->getInternalResolution().y(), m_r->getHdrFormat(), "Light Shading");
+		m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y(), m_r->getHdrFormat(), "Light Shading");
 	m_lightShading.m_rtDescr.bake();
 
 	// Create FB descr
@@ -196,6 +196,12 @@ void LightShading::run(const RenderingContext& ctx, RenderPassWorkContext& rgrap
 			rgraphCtx.bindColorTexture(0, 12, m_r->getShadowmapsResolve().getRt());
 		}
 
+		const Vec4 shadowsUvScaleAndMax =
+			(m_r->getRtShadowsEnabled())
+				? m_r->getInternalResolutionUvScaleAndMax()
+				: m_r->getInternalResolutionUvScaleAndMax(m_r->getShadowmapsResolve().getRtDownscale());
+		cmdb->setPushConstants(&shadowsUvScaleAndMax, sizeof(shadowsUvScaleAndMax));
+
 		// Draw
 		drawQuad(cmdb);
 	}
@@ -290,10 +296,12 @@ void LightShading::run(const RenderingContext& ctx, RenderPassWorkContext& rgrap
 		class PushConsts
 		{
 		public:
+			Vec4 m_depthUvScaleAndMax;
 			Vec2 m_padding;
 			F32 m_near;
 			F32 m_far;
 		} regs;
+		regs.m_depthUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
 		regs.m_near = ctx.m_renderQueue->m_cameraNear;
 		regs.m_far = ctx.m_renderQueue->m_cameraFar;
 
@@ -366,7 +374,8 @@ void LightShading::populateRenderGraph(RenderingContext& ctx)
 				 [this, &ctx](RenderPassWorkContext& rgraphCtx) {
 					 run(ctx, rgraphCtx);
 				 });
-	pass.setFramebufferInfo(m_lightShading.m_fbDescr, {m_runCtx.m_rt}, m_r->getGBuffer().getDepthRt(), sriRt);
+	pass.setFramebufferInfo(m_lightShading.m_fbDescr, {m_runCtx.m_rt}, m_r->getGBuffer().getDepthRt(), sriRt, 0, 0,
+							m_r->getInternalResolution().x(), m_r->getInternalResolution().y());
 
 	const TextureUsageBit readUsage = TextureUsageBit::SAMPLED_FRAGMENT;
 
@@ -15,7 +15,7 @@
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Core/ConfigSet.h>
 #include <AnKi/Util/HighRezTimer.h>
-#include <AnKi/Util/ThreadHive.h>
+#include <AnKi/Util/ThreadHiveAlgorithms.h>
 
 namespace anki {
 
@@ -39,9 +39,23 @@ Error MainRenderer::init(const MainRendererInitInfo& inf)
 	m_swapchainResolution = inf.m_swapchainSize;
 	m_rDrawToDefaultFb = inf.m_config->getRRenderScaling() == 1.0f;
 
+	const F32 maxInternalRenderScaling = inf.m_config->getRInternalRenderScaling();
+	if(inf.m_config->getRDynamicResolution())
+	{
+		const F32 minInternalRenderScaling =
+			min(inf.m_config->getRDynamicResolutionMinScaling(), maxInternalRenderScaling);
+		m_dynamicResolution.init(minInternalRenderScaling, maxInternalRenderScaling,
+								 inf.m_config->getRDynamicResolutionLevelCount(),
+								 inf.m_config->getRDynamicResolutionTargetGpuTime() / 1000.0);
+
+		ANKI_R_LOGI("Dynamic resolution enabled. Internal render scaling will be between %f and %f",
+					minInternalRenderScaling, maxInternalRenderScaling);
+	}
+
+	// The render targets are allocated for the max scaling. Dynamic resolution renders into a part of them
 	m_r.reset(m_alloc.newInstance<Renderer>());
 	ANKI_CHECK(m_r->init(inf.m_threadHive, inf.m_resourceManager, inf.m_gr, inf.m_stagingMemory, inf.m_ui, m_alloc,
-						 inf.m_config, inf.m_globTimestamp, m_swapchainResolution));
+						 inf.m_config, inf.m_globTimestamp, m_swapchainResolution, maxInternalRenderScaling));
 
 	// Init other
 	if(!m_rDrawToDefaultFb)
@@ -89,8 +103,7 @@ Error MainRenderer::render(RenderQueue& rqueue, TexturePtr presentTex)
 	// Run renderer
 	RenderingContext ctx(m_frameAlloc);
 	m_runCtx.m_ctx = &ctx;
-	m_runCtx.m_secondaryTaskId.setNonAtomically(0);
-	ctx.m_renderGraphDescr.setStatisticsEnabled(m_statsEnabled);
+	ctx.m_renderGraphDescr.setStatisticsEnabled(m_statsEnabled || m_dynamicResolution.isEnabled());
 
 	RenderTargetHandle presentRt = ctx.m_renderGraphDescr.importRenderTarget(presentTex, TextureUsageBit::NONE);
 
@@ -122,6 +135,9 @@ Error MainRenderer::render(RenderQueue& rqueue, TexturePtr presentTex)
 			cmdb->bindSampler(0, 0, m_r->getSamplers().m_trilinearClamp);
 			rgraphCtx.bindColorTexture(0, 1, m_runCtx.m_ctx->m_outRenderTarget);
 
+			const Vec4 uvScaleAndMax(1.0f);
+			cmdb->setPushConstants(&uvScaleAndMax, sizeof(uvScaleAndMax));
+
 			cmdb->drawArrays(PrimitiveTopology::TRIANGLES, 3);
 		});
 
@@ -143,24 +159,26 @@ Error MainRenderer::render(RenderQueue& rqueue, TexturePtr presentTex)
 	m_rgraph->compileNewGraph(ctx.m_renderGraphDescr, m_frameAlloc);
 
 	// Populate the 2nd level command buffers
-	Array<ThreadHiveTask, ThreadHive::MAX_THREADS> tasks;
-	for(U i = 0; i < m_r->getThreadHive().getThreadCount(); ++i)
-	{
-		tasks[i].m_argument = this;
-		tasks[i].m_callback = [](void* userData, [[maybe_unused]] U32 threadId, [[maybe_unused]] ThreadHive& hive,
-								 [[maybe_unused]] ThreadHiveSemaphore* signalSemaphore) {
-			MainRenderer& self = *static_cast<MainRenderer*>(userData);
-
-			const U32 taskId = self.m_runCtx.m_secondaryTaskId.fetchAdd(1);
-			self.m_rgraph->runSecondLevel(taskId);
-		};
-	}
-	m_r->getThreadHive().submitTasks(&tasks[0], m_r->getThreadHive().getThreadCount());
+	RenderGraph* rgraph = m_rgraph.get();
+	auto runSecondLevel = [rgraph](U32 begin, U32 end, [[maybe_unused]] U32 threadId) {
+		for(U32 i = begin; i < end; ++i)
+		{
+			rgraph->runSecondLevel(i);
+		}
+	};
+	ThreadHiveSemaphore* secondLevelDone =
+		parallelFor(m_r->getThreadHive(), m_r->getThreadHive().getThreadCount(), 1, runSecondLevel);
+
+	// Populate 1st level command buffers. They push the 2nd level ones so wait for them
+	auto runFirstLevel = [rgraph](U32 begin, U32 end, [[maybe_unused]] U32 threadId) {
+		for(U32 i = begin; i < end; ++i)
+		{
+			rgraph->run(i);
+		}
+	};
+	parallelFor(m_r->getThreadHive(), m_rgraph->getPrimaryCommandBufferCount(), 1, runFirstLevel, secondLevelDone);
 	m_r->getThreadHive().waitAllTasks();
 
-	// Populate 1st level command buffers
-	m_rgraph->run();
-
 	// Flush
 	m_rgraph->flush();
 
@@ -177,6 +195,21 @@ Error MainRenderer::render(RenderQueue& rqueue, TexturePtr presentTex)
 		m_rgraph->getStatistics(rgraphStats);
 		m_stats.m_renderingGpuTime = rgraphStats.m_gpuTime;
 		m_stats.m_renderingGpuSubmitTimestamp = rgraphStats.m_cpuStartTime;
+		m_stats.m_renderTargetMemory = rgraphStats.m_renderTargetMemory;
+		m_stats.m_aliasedRenderTargetMemory = rgraphStats.m_aliasedRenderTargetMemory;
+	}
+
+	// Dynamic resolution. The GPU time is a few frames old but it's good enough
+	if(m_dynamicResolution.isEnabled())
+	{
+		RenderGraphStatistics rgraphStats;
+		m_rgraph->getStatistics(rgraphStats);
+		if(m_dynamicResolution.update(rgraphStats.m_gpuTime))
+		{
+			ANKI_R_LOGV("Dynamic resolution changed the internal render scaling to %f. GPU time was %fms",
+						m_dynamicResolution.getScaling(), rgraphStats.m_gpuTime * 1000.0);
+			m_r->setInternalRenderScaling(m_dynamicResolution.getScaling());
+		}
 	}
 
 	return Error::NONE;
@@ -8,6 +8,7 @@
 #include <AnKi/Renderer/Common.h>
 #include <AnKi/Resource/Forward.h>
 #include <AnKi/Renderer/Renderer.h>
+#include <AnKi/Renderer/DynamicResolution.h>
 
 namespace anki {
 
@@ -27,6 +28,8 @@ public:
 	Second m_renderingCpuTime ANKI_DEBUG_CODE(= -1.0);
 	Second m_renderingGpuTime ANKI_DEBUG_CODE(= -1.0);
 	Second m_renderingGpuSubmitTimestamp ANKI_DEBUG_CODE(= -1.0);
+	PtrSize m_renderTargetMemory = 0;
+	PtrSize m_aliasedRenderTargetMemory = 0;
 };
 
 class MainRendererInitInfo
@@ -87,6 +90,7 @@ private:
 	StackAllocator<U8> m_frameAlloc;
 
 	UniquePtr<Renderer> m_r;
+	DynamicResolution m_dynamicResolution;
 	Bool m_rDrawToDefaultFb = false;
 
 	ShaderProgramResourcePtr m_blitProg;
@@ -105,7 +109,6 @@ private:
 	{
 	public:
 		const RenderingContext* m_ctx = nullptr;
-		Atomic<U32> m_secondaryTaskId = {0};
 	} m_runCtx;
 };
 /// @}
@@ -34,15 +34,14 @@ Error MotionVectors::initInternal()
 													 ? "ShaderBinaries/MotionVectorsCompute.ankiprogbin"
 													 : "ShaderBinaries/MotionVectorsRaster.ankiprogbin",
 												 m_prog));
-	ShaderProgramResourceVariantInitInfo variantInitInfo(m_prog);
-	variantInitInfo.addConstant("FB_SIZE", UVec2(m_r->getInternalResolution().x(), m_r->getInternalResolution().y()));
 	const ShaderProgramResourceVariant* variant;
-	m_prog->getOrCreateVariant(variantInitInfo, variant);
+	m_prog->getOrCreateVariant(variant);
 	m_grProg = variant->getProgram();
 
 	// RTs
-	m_motionVectorsRtDescr = m_r->create2DRenderTargetDescription(
-		m_r->getInternalResolution().x(), m_r->getInternalResolution().y(), Format::R16G16_SFLOAT, "MotionVectors");
+	m_motionVectorsRtDescr =
+		m_r->create2DRenderTargetDescription(m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y(),
+											 Format::R16G16_SFLOAT, "MotionVectors");
 	m_motionVectorsRtDescr.bake();
 
 	TextureUsageBit historyLengthUsage = TextureUsageBit::ALL_SAMPLED;
@@ -56,7 +55,7 @@ Error MotionVectors::initInternal()
 	}
 
 	TextureInitInfo historyLengthTexInit =
-		m_r->create2DRenderTargetInitInfo(m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
+		m_r->create2DRenderTargetInitInfo(m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y(),
 										  Format::R8_UNORM, historyLengthUsage, "MotionVectorsHistoryLen#1");
 	m_historyLengthTextures[0] = m_r->createAndClearRenderTarget(historyLengthTexInit, TextureUsageBit::ALL_SAMPLED);
 	historyLengthTexInit.setName("MotionVectorsHistoryLen#2");
@@ -107,7 +106,8 @@ void MotionVectors::populateRenderGraph(RenderingContext& ctx)
 	else
 	{
 		GraphicsRenderPassDescription& pass = rgraph.newGraphicsRenderPass("MotionVectors");
-		pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_motionVectorsRtHandle, m_runCtx.m_historyLengthWriteRtHandle});
+		pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_motionVectorsRtHandle, m_runCtx.m_historyLengthWriteRtHandle},
+								{}, {}, 0, 0, m_r->getInternalResolution().x(), m_r->getInternalResolution().y());
 
 		readUsage = TextureUsageBit::SAMPLED_FRAGMENT;
 		writeUsage = TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE;
@@ -145,12 +145,22 @@ void MotionVectors::run(const RenderingContext& ctx, RenderPassWorkContext& rgra
 		Mat4 m_reprojectionMat;
 		Mat4 m_viewProjectionInvMat;
 		Mat4 m_prevViewProjectionInvMat;
+
+		Vec4 m_uvScaleAndMax;
+		Vec4 m_prevUvScaleAndMax;
+
+		UVec2 m_viewportSize;
+		Vec2 m_texelSize;
 	} * pc;
 	pc = allocateAndBindUniforms<Uniforms*>(sizeof(*pc), cmdb, 0, 5);
 
 	pc->m_reprojectionMat = ctx.m_matrices.m_reprojection;
 	pc->m_viewProjectionInvMat = ctx.m_matrices.m_invertedViewProjectionJitter;
 	pc->m_prevViewProjectionInvMat = ctx.m_prevMatrices.m_invertedViewProjectionJitter;
+	pc->m_uvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	pc->m_prevUvScaleAndMax = m_r->getPreviousInternalResolutionUvScaleAndMax();
+	pc->m_viewportSize = m_r->getInternalResolution();
+	pc->m_texelSize = 1.0f / Vec2(m_r->getMaxInternalResolution());
 
 	if(getConfig().getRPreferCompute())
 	{
@@ -0,0 +1,230 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Renderer/ProbeBaker.h>
+#include <AnKi/Renderer/Renderer.h>
+#include <AnKi/Core/ConfigSet.h>
+#include <AnKi/Util/File.h>
+#include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/Tracer.h>
+
+namespace anki {
+
+/// Create a directory and its missing parents.
+static Error createDirectories(const CString& dir, HeapAllocator<U8> alloc)
+{
+	if(dir.isEmpty() || directoryExists(dir))
+	{
+		return Error::NONE;
+	}
+
+	StringAuto parent(alloc);
+	getParentFilepath(dir, parent);
+	ANKI_CHECK(createDirectories(parent, alloc));
+
+	return createDirectory(dir);
+}
+
+ProbeBaker::~ProbeBaker()
+{
+	for(Readback& readback : m_readbacks)
+	{
+		readback.m_filename.destroy(getAllocator());
+	}
+
+	m_readbacks.destroy(getAllocator());
+}
+
+Error ProbeBaker::init()
+{
+	const CString bakeDir = getConfig().getRProbeBakeDirectory();
+	m_enabled = !bakeDir.isEmpty();
+	if(!m_enabled)
+	{
+		return Error::NONE;
+	}
+
+	ANKI_R_LOGI("Probe baking is enabled. The probes will be stored in: %s", bakeDir.cstr());
+
+	ANKI_CHECK(createDirectories(bakeDir, getAllocator()));
+
+	ANKI_CHECK(getResourceManager().loadResource("ShaderBinaries/ProbeBakeReadback.ankiprogbin", m_prog));
+
+	for(U32 i = 0; i < 2; ++i)
+	{
+		ShaderProgramResourceVariantInitInfo variantInitInfo(m_prog);
+		variantInitInfo.addMutation("TEXTURE_DIMENSIONS", i + 2);
+
+		const ShaderProgramResourceVariant* variant;
+		m_prog->getOrCreateVariant(variantInitInfo, variant);
+		m_grProgs[i] = variant->getProgram();
+	}
+
+	return Error::NONE;
+}
+
+ProbeBaker::Readback& ProbeBaker::newReadback(ImageBinaryType type, const UVec3& size, U32 mipCount, CString filename)
+{
+	ANKI_ASSERT(m_enabled);
+	ANKI_ASSERT(type == ImageBinaryType::CUBE || type == ImageBinaryType::_3D);
+	ANKI_ASSERT(!filename.isEmpty());
+
+	Readback& readback = *m_readbacks.emplaceBack(getAllocator());
+	readback.m_filename.create(getAllocator(), filename);
+	readback.m_frame = m_r->getFrameCount();
+
+	ImageBinaryHeader& header = readback.m_header;
+	header = {};
+	memcpy(&header.m_magic[0], &IMAGE_MAGIC[0], sizeof(header.m_magic));
+	header.m_width = size.x();
+	header.m_height = size.y();
+	header.m_depthOrLayerCount = size.z();
+	header.m_type = type;
+	header.m_colorFormat = ImageBinaryColorFormat::RGBAF32;
+	header.m_compressionMask = ImageBinaryDataCompression::RAW;
+	header.m_isNormal = false;
+	header.m_mipmapCount = mipCount;
+
+	// Compute the size of all the surfaces
+	const U32 faceCount = (type == ImageBinaryType::CUBE) ? 6 : 1;
+	PtrSize texelCount = 0;
+	for(U32 mip = 0; mip < mipCount; ++mip)
+	{
+		texelCount += PtrSize(max(size.x() >> mip, 1u)) * PtrSize(max(size.y() >> mip, 1u))
+					  * PtrSize(max(size.z() >> mip, 1u)) * faceCount;
+	}
+
+	BufferInitInfo buffInit("ProbeBakeReadback");
+	buffInit.m_size = texelCount * sizeof(Vec4);
+	buffInit.m_usage = BufferUsageBit::STORAGE_COMPUTE_WRITE | BufferUsageBit::HOST_READ;
+	buffInit.m_mapAccess = BufferMapAccessBit::READ;
+	readback.m_buffer = getGrManager().newBuffer(buffInit);
+
+	return readback;
+}
+
+void ProbeBaker::readbackReflectionProbe(RenderingContext& ctx, RenderTargetHandle cubeArrRt, U32 cubeArrLayer,
+										 U32 faceSize, U32 mipCount, CString filename)
+{
+	Buffer* buff = newReadback(ImageBinaryType::CUBE, UVec3(faceSize, faceSize, 1), mipCount, filename).m_buffer.get();
+
+	ComputeRenderPassDescription& pass = ctx.m_renderGraphDescr.newComputeRenderPass("ProbeBake refl");
+
+	TextureSubresourceInfo subresource;
+	subresource.m_faceCount = 6;
+	subresource.m_firstLayer = cubeArrLayer;
+	subresource.m_mipmapCount = mipCount;
+	pass.newDependency({cubeArrRt, TextureUsageBit::SAMPLED_COMPUTE, subresource});
+
+	pass.setWork([this, buff, cubeArrRt, cubeArrLayer, faceSize, mipCount](RenderPassWorkContext& rgraphCtx) {
+		ANKI_TRACE_SCOPED_EVENT(R_CUBE_REFL);
+		CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
+
+		cmdb->bindShaderProgram(m_grProgs[0]);
+		cmdb->bindStorageBuffer(0, 1, BufferPtr(buff), 0, MAX_PTR_SIZE);
+
+		// Same order as the .ankitex: All the faces of a mip and then the next mip
+		U32 firstTexel = 0;
+		for(U32 mip = 0; mip < mipCount; ++mip)
+		{
+			const U32 mipSize = max(faceSize >> mip, 1u);
+			for(U32 face = 0; face < 6; ++face)
+			{
+				rgraphCtx.bindTexture(0, 0, cubeArrRt,
+									  TextureSubresourceInfo(TextureSurfaceInfo(mip, 0, face, cubeArrLayer)));
+
+				const UVec4 pc(mipSize, mipSize, 1, firstTexel);
+				cmdb->setPushConstants(&pc, sizeof(pc));
+
+				dispatchPPCompute(cmdb, 8, 8, mipSize, mipSize);
+				firstTexel += mipSize * mipSize;
+			}
+		}
+
+		// Make the writes visible to writeReadback()
+		cmdb->setBufferBarrier(BufferPtr(buff), BufferUsageBit::STORAGE_COMPUTE_WRITE, BufferUsageBit::HOST_READ, 0,
+							   MAX_PTR_SIZE);
+	});
+}
+
+void ProbeBaker::readbackGlobalIlluminationProbe(RenderingContext& ctx, RenderTargetHandle volumeRt,
+												 const UVec3& volumeSize, CString filename)
+{
+	Buffer* buff = newReadback(ImageBinaryType::_3D, volumeSize, 1, filename).m_buffer.get();
+
+	ComputeRenderPassDescription& pass = ctx.m_renderGraphDescr.newComputeRenderPass("ProbeBake GI");
+	pass.newDependency({volumeRt, TextureUsageBit::SAMPLED_COMPUTE});
+
+	pass.setWork([this, buff, volumeRt, volumeSize](RenderPassWorkContext& rgraphCtx) {
+		ANKI_TRACE_SCOPED_EVENT(R_GI);
+		CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
+
+		cmdb->bindShaderProgram(m_grProgs[1]);
+		cmdb->bindStorageBuffer(0, 1, BufferPtr(buff), 0, MAX_PTR_SIZE);
+		rgraphCtx.bindColorTexture(0, 0, volumeRt);
+
+		const UVec4 pc(volumeSize, 0);
+		cmdb->setPushConstants(&pc, sizeof(pc));
+
+		dispatchPPCompute(cmdb, 8, 8, 8, volumeSize.x(), volumeSize.y(), volumeSize.z());
+
+		// Make the writes visible to writeReadback()
+		cmdb->setBufferBarrier(BufferPtr(buff), BufferUsageBit::STORAGE_COMPUTE_WRITE, BufferUsageBit::HOST_READ, 0,
+							   MAX_PTR_SIZE);
+	});
+}
+
+void ProbeBaker::writeCompletedReadbacks()
+{
+	// The readbacks are in submission order so stop at the 1st that might still be in flight
+	while(!m_readbacks.isEmpty() && m_readbacks.getFront().m_frame + MAX_FRAMES_IN_FLIGHT < m_r->getFrameCount())
+	{
+		Readback& readback = m_readbacks.getFront();
+		if(writeReadback(readback))
+		{
+			ANKI_R_LOGE("Failed to store baked probe: %s", readback.m_filename.cstr());
+		}
+
+		readback.m_filename.destroy(getAllocator());
+		m_readbacks.popFront(getAllocator());
+	}
+}
+
+Error ProbeBaker::writeReadback(const Readback& readback) const
+{
+	StringAuto fname(getAllocator());
+	fname.sprintf("%s/%s", getConfig().getRProbeBakeDirectory().cstr(), readback.m_filename.cstr());
+
+	StringAuto dir(getAllocator());
+	getParentFilepath(fname, dir);
+	ANKI_CHECK(createDirectories(dir, getAllocator()));
+
+	const PtrSize dataSize = readback.m_buffer->getSize();
+	const void* data = readback.m_buffer->map(0, dataSize, BufferMapAccessBit::READ);
+	readback.m_buffer->invalidate(0, dataSize);
+
+	File file;
+	Error err = file.open(fname, FileOpenFlag::WRITE | FileOpenFlag::BINARY);
+	if(!err)
+	{
+		err = file.write(&readback.m_header, sizeof(readback.m_header));
+	}
+
+	if(!err)
+	{
+		err = file.write(data, dataSize);
+	}
+
+	readback.m_buffer->unmap();
+
+	if(!err)
+	{
+		ANKI_R_LOGI("Baked probe stored: %s", fname.cstr());
+	}
+
+	return err;
+}
+
+} // end namespace anki
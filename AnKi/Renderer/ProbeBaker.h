@@ -0,0 +1,77 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Renderer/RendererObject.h>
+#include <AnKi/Resource/ImageBinary.h>
+#include <AnKi/Util/List.h>
+
+namespace anki {
+
+/// @addtogroup renderer
+/// @{
+
+/// Offline bake of the reflection and GI probes. When RProbeBakeDirectory is set ProbeReflections and
+/// IndirectDiffuseProbes render every static probe and hand the result to this object. It reads the textures back to
+/// the CPU and a few frames later, when the GPU is done, it writes them as raw .ankitex files. The files are written
+/// relative to RProbeBakeDirectory but they are loaded from the RsrcDataPaths, see Tools/ProbeBaker.
+class ProbeBaker : public RendererObject
+{
+public:
+	ProbeBaker(Renderer* r)
+		: RendererObject(r)
+	{
+	}
+
+	~ProbeBaker();
+
+	Error init();
+
+	/// Returns true if RProbeBakeDirectory is set.
+	Bool isEnabled() const
+	{
+		return m_enabled;
+	}
+
+	/// Write the images whose readback is done. Call it before populating the render graph.
+	void writeCompletedReadbacks();
+
+	/// Read back a layer of a cube array with all its mips.
+	void readbackReflectionProbe(RenderingContext& ctx, RenderTargetHandle cubeArrRt, U32 cubeArrLayer, U32 faceSize,
+								 U32 mipCount, CString filename);
+
+	/// Read back the volume of a GI probe.
+	void readbackGlobalIlluminationProbe(RenderingContext& ctx, RenderTargetHandle volumeRt, const UVec3& volumeSize,
+										 CString filename);
+
+	/// Number of readbacks that are not written yet.
+	U32 getPendingReadbackCount() const
+	{
+		return U32(m_readbacks.getSize());
+	}
+
+private:
+	class Readback
+	{
+	public:
+		BufferPtr m_buffer;
+		String m_filename;
+		ImageBinaryHeader m_header;
+		U64 m_frame;
+	};
+
+	ShaderProgramResourcePtr m_prog;
+	Array<ShaderProgramPtr, 2> m_grProgs; ///< One for 2D and one for 3D.
+	List<Readback> m_readbacks;
+	Bool m_enabled = false;
+
+	Readback& newReadback(ImageBinaryType type, const UVec3& size, U32 mipCount, CString filename);
+
+	Error writeReadback(const Readback& readback) const;
+};
+/// @}
+
+} // end namespace anki
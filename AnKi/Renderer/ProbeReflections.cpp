@@ -8,6 +8,8 @@
 #include <AnKi/Renderer/FinalComposite.h>
 #include <AnKi/Renderer/GBuffer.h>
 #include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
+#include <AnKi/Renderer/ProbeBaker.h>
 #include <AnKi/Core/ConfigSet.h>
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Resource/MeshResource.h>
@@ -48,6 +50,7 @@ Error ProbeReflections::initInternal()
 	ANKI_CHECK(initIrradiance());
 	ANKI_CHECK(initIrradianceToRefl());
 	ANKI_CHECK(initShadowMapping());
+	ANKI_CHECK(initBakedCopy());
 
 	// Load split sum integration LUT
 	ANKI_CHECK(getResourceManager().loadResource("EngineAssets/IblDfg.png", m_integrationLut));
@@ -201,6 +204,17 @@ Error ProbeReflections::initShadowMapping()
 	return Error::NONE;
 }
 
+Error ProbeReflections::initBakedCopy()
+{
+	ANKI_CHECK(getResourceManager().loadResource("ShaderBinaries/BlitCompute.ankiprogbin", m_bakedCopy.m_prog));
+
+	const ShaderProgramResourceVariant* variant;
+	m_bakedCopy.m_prog->getOrCreateVariant(variant);
+	m_bakedCopy.m_grProg = variant->getProgram();
+
+	return Error::NONE;
+}
+
 void ProbeReflections::initCacheEntry(U32 cacheEntryIdx)
 {
 	CacheEntry& cacheEntry = m_cacheEntries[cacheEntryIdx];
@@ -223,6 +237,7 @@ void ProbeReflections::prepareProbes(RenderingContext& ctx, ReflectionProbeQueue
 {
 	probeToUpdateThisFrame = nullptr;
 	probeToUpdateThisFrameCacheEntryIdx = MAX_U32;
+	m_ctx.m_bakedProbeCopies = {};
 
 	if(ANKI_UNLIKELY(ctx.m_renderQueue->m_reflectionProbes.getSize() == 0))
 	{
@@ -236,6 +251,9 @@ void ProbeReflections::prepareProbes(RenderingContext& ctx, ReflectionProbeQueue
 	DynamicArray<ReflectionProbeQueueElement> newListOfProbes;
 	newListOfProbes.create(ctx.m_tempAllocator, ctx.m_renderQueue->m_reflectionProbes.getSize());
 	U32 newListOfProbeCount = 0;
+	DynamicArray<BakedProbeCopy> bakedProbeCopies;
+	bakedProbeCopies.create(ctx.m_tempAllocator, ctx.m_renderQueue->m_reflectionProbes.getSize());
+	U32 bakedProbeCopyCount = 0;
 	Bool foundProbeToUpdateNextFrame = false;
 	for(U32 probeIdx = 0; probeIdx < ctx.m_renderQueue->m_reflectionProbes.getSize(); ++probeIdx)
 	{
@@ -256,7 +274,14 @@ void ProbeReflections::prepareProbes(RenderingContext& ctx, ReflectionProbeQueue
 
 		// Check if we _should_ and _can_ update the probe
 		const Bool needsUpdate = !probeFoundInCache;
-		if(ANKI_UNLIKELY(needsUpdate))
+		if(ANKI_UNLIKELY(needsUpdate) && probe.m_bakedTexture)
+		{
+			// Static probe with an offline bake, copy the bake instead of rendering. It's cheap so no limit per frame
+			bakedProbeCopies[bakedProbeCopyCount].m_bakedTexture = probe.m_bakedTexture;
+			bakedProbeCopies[bakedProbeCopyCount].m_cacheEntryIdx = cacheEntryIdx;
+			++bakedProbeCopyCount;
+		}
+		else if(ANKI_UNLIKELY(needsUpdate))
 		{
 			const Bool canUpdateThisFrame = probeToUpdateThisFrame == nullptr && probe.m_renderQueues[0] != nullptr;
 			const Bool canUpdateNextFrame = !foundProbeToUpdateNextFrame;
@@ -319,6 +344,18 @@ void ProbeReflections::prepareProbes(RenderingContext& ctx, ReflectionProbeQueue
 		ctx.m_renderQueue->m_reflectionProbes = WeakArray<ReflectionProbeQueueElement>();
 		newListOfProbes.destroy(ctx.m_tempAllocator);
 	}
+
+	if(bakedProbeCopyCount > 0)
+	{
+		BakedProbeCopy* firstCopy;
+		U32 copyCount, storage;
+		bakedProbeCopies.moveAndReset(firstCopy, copyCount, storage);
+		m_ctx.m_bakedProbeCopies = WeakArray<BakedProbeCopy>(firstCopy, bakedProbeCopyCount);
+	}
+	else
+	{
+		bakedProbeCopies.destroy(ctx.m_tempAllocator);
+	}
 }
 
 void ProbeReflections::runGBuffer(RenderPassWorkContext& rgraphCtx)
@@ -481,6 +518,56 @@ void ProbeReflections::runIrradianceToRefl(RenderPassWorkContext& rgraphCtx)
 	dispatchPPCompute(cmdb, 8, 8, m_lightShading.m_tileSize, m_lightShading.m_tileSize);
 }
 
+void ProbeReflections::runBakedCopy(RenderPassWorkContext& rgraphCtx)
+{
+	ANKI_TRACE_SCOPED_EVENT(R_CUBE_REFL);
+
+	CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
+
+	cmdb->bindShaderProgram(m_bakedCopy.m_grProg);
+	cmdb->bindSampler(0, 0, m_r->getSamplers().m_trilinearClamp);
+
+	for(const BakedProbeCopy& copy : m_ctx.m_bakedProbeCopies)
+	{
+		const TexturePtr bakedTex(copy.m_bakedTexture);
+
+		for(U32 mip = 0; mip < m_lightShading.m_mipCount; ++mip)
+		{
+			const U32 mipSize = m_lightShading.m_tileSize >> mip;
+
+			// The bake might have a different resolution. Pick the smallest mip that is not smaller than the target and
+			// let the sampler do the rest
+			U32 bakedMip = 0;
+			while(bakedMip + 1 < bakedTex->getMipmapCount() && (bakedTex->getWidth() >> (bakedMip + 1)) >= mipSize)
+			{
+				++bakedMip;
+			}
+
+			class
+			{
+			public:
+				Vec4 m_uvScaleAndMax = Vec4(1.0f);
+				Vec2 m_viewportSize;
+				UVec2 m_viewportSizeU;
+			} pc;
+			pc.m_viewportSize = Vec2(F32(mipSize));
+			pc.m_viewportSizeU = UVec2(mipSize);
+			cmdb->setPushConstants(&pc, sizeof(pc));
+
+			for(U32 faceIdx = 0; faceIdx < 6; ++faceIdx)
+			{
+				TextureViewInitInfo viewInit(bakedTex, TextureSurfaceInfo(bakedMip, 0, faceIdx, 0));
+				cmdb->bindTexture(0, 1, getGrManager().newTextureView(viewInit));
+
+				rgraphCtx.bindImage(0, 2, m_ctx.m_lightShadingRt,
+									TextureSubresourceInfo(TextureSurfaceInfo(mip, 0, faceIdx, copy.m_cacheEntryIdx)));
+
+				dispatchPPCompute(cmdb, 8, 8, mipSize, mipSize);
+			}
+		}
+	}
+}
+
 void ProbeReflections::populateRenderGraph(RenderingContext& rctx)
 {
 	ANKI_TRACE_SCOPED_EVENT(R_CUBE_REFL);
@@ -495,12 +582,29 @@ void ProbeReflections::populateRenderGraph(RenderingContext& rctx)
 	U32 probeToUpdateCacheEntryIdx;
 	prepareProbes(rctx, probeToUpdate, probeToUpdateCacheEntryIdx);
 
+	m_ctx.m_lightShadingRt = rgraph.importRenderTarget(m_lightShading.m_cubeArr, TextureUsageBit::SAMPLED_FRAGMENT);
+
+	// Copy the offline bakes of the static probes that entered the cache
+	if(m_ctx.m_bakedProbeCopies.getSize() > 0)
+	{
+		ComputeRenderPassDescription& pass = rgraph.newComputeRenderPass("CubeRefl baked");
+		pass.setWork([this](RenderPassWorkContext& rgraphCtx) {
+			runBakedCopy(rgraphCtx);
+		});
+
+		for(const BakedProbeCopy& copy : m_ctx.m_bakedProbeCopies)
+		{
+			TextureSubresourceInfo subresource;
+			subresource.m_faceCount = 6;
+			subresource.m_firstLayer = copy.m_cacheEntryIdx;
+			subresource.m_mipmapCount = m_lightShading.m_mipCount;
+			pass.newDependency({m_ctx.m_lightShadingRt, TextureUsageBit::IMAGE_COMPUTE_WRITE, subresource});
+		}
+	}
+
 	// Render a probe if needed
 	if(!probeToUpdate)
 	{
-		// Just import and exit
-
-		m_ctx.m_lightShadingRt = rgraph.importRenderTarget(m_lightShading.m_cubeArr, TextureUsageBit::SAMPLED_FRAGMENT);
 		return;
 	}
 
@@ -545,6 +649,7 @@ void ProbeReflections::populateRenderGraph(RenderingContext& rctx)
 
 		TextureSubresourceInfo subresource(DepthStencilAspectBit::DEPTH);
 		pass.newDependency({m_ctx.m_gbufferDepthRt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, subresource});
+		pass.newDependency({m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ});
 	}
 
 	// Shadow pass. Optional
@@ -589,6 +694,7 @@ void ProbeReflections::populateRenderGraph(RenderingContext& rctx)
 
 		TextureSubresourceInfo subresource(DepthStencilAspectBit::DEPTH);
 		pass.newDependency({m_ctx.m_shadowMapRt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, subresource});
+		pass.newDependency({m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ});
 	}
 	else
 	{
@@ -597,10 +703,6 @@ void ProbeReflections::populateRenderGraph(RenderingContext& rctx)
 
 	// Light shading passes
 	{
-		// RT
-		m_ctx.m_lightShadingRt = rgraph.importRenderTarget(m_lightShading.m_cubeArr, TextureUsageBit::SAMPLED_FRAGMENT);
-
-		// Passes
 		static const Array<CString, 6> passNames = {"CubeRefl LightShad #0", "CubeRefl LightShad #1",
 													"CubeRefl LightShad #2", "CubeRefl LightShad #3",
 													"CubeRefl LightShad #4", "CubeRefl LightShad #5"};
@@ -689,6 +791,14 @@ void ProbeReflections::populateRenderGraph(RenderingContext& rctx)
 			pass.newDependency({m_ctx.m_lightShadingRt, TextureUsageBit::GENERATE_MIPMAPS, subresource});
 		}
 	}
+
+	// Store the probe if it's baking
+	if(m_r->getProbeBaker().isEnabled() && probeToUpdate->m_bakedImageFilename)
+	{
+		m_r->getProbeBaker().readbackReflectionProbe(rctx, m_ctx.m_lightShadingRt, probeToUpdateCacheEntryIdx,
+													 m_lightShading.m_tileSize, m_lightShading.m_mipCount,
+													 probeToUpdate->m_bakedImageFilename);
+	}
 }
 
 void ProbeReflections::runShadowMapping(RenderPassWorkContext& rgraphCtx)
@@ -91,6 +91,13 @@ private:
 		ShaderProgramPtr m_grProg;
 	} m_irradianceToRefl; ///< Apply irradiance back to the reflection.
 
+	class
+	{
+	public:
+		ShaderProgramResourcePtr m_prog;
+		ShaderProgramPtr m_grProg;
+	} m_bakedCopy; ///< Copy the offline bakes to the cube array.
+
 	class
 	{
 	public:
@@ -107,6 +114,14 @@ private:
 		Array<FramebufferDescription, 6> m_lightShadingFbDescrs;
 	};
 
+	/// A probe that will be filled from its offline bake.
+	class BakedProbeCopy
+	{
+	public:
+		Texture* m_bakedTexture;
+		U32 m_cacheEntryIdx;
+	};
+
 	DynamicArray<CacheEntry> m_cacheEntries;
 	HashMap<U64, U32> m_probeUuidToCacheEntryIdx;
 
@@ -119,6 +134,7 @@ private:
 	public:
 		const ReflectionProbeQueueElement* m_probe = nullptr;
 		U32 m_cacheEntryIdx = MAX_U32;
+		WeakArray<BakedProbeCopy> m_bakedProbeCopies;
 
 		Array<RenderTargetHandle, GBUFFER_COLOR_ATTACHMENT_COUNT> m_gbufferColorRts;
 		RenderTargetHandle m_gbufferDepthRt;
@@ -136,6 +152,7 @@ private:
 	Error initIrradiance();
 	Error initIrradianceToRefl();
 	Error initShadowMapping();
+	Error initBakedCopy();
 
 	/// Lazily init the cache entry
 	void initCacheEntry(U32 cacheEntryIdx);
@@ -149,6 +166,7 @@ private:
 	void runMipmappingOfLightShading(U32 faceIdx, RenderPassWorkContext& rgraphCtx);
 	void runIrradiance(RenderPassWorkContext& rgraphCtx);
 	void runIrradianceToRefl(RenderPassWorkContext& rgraphCtx);
+	void runBakedCopy(RenderPassWorkContext& rgraphCtx);
 };
 /// @}
 
@@ -7,12 +7,28 @@
 
 namespace anki {
 
+void RenderQueueDrawContext::drawElements(PrimitiveTopology topology, U32 count, U32 instanceCount, U32 firstIndex,
+										  U32 baseVertex)
+{
+	if(m_gpuVisibility == nullptr)
+	{
+		m_commandBuffer->drawElements(topology, count, instanceCount, firstIndex, baseVertex);
+		return;
+	}
+
+	ANKI_ASSERT(instanceCount == 1 && "The GPU visibility will instance");
+	m_commandBuffer->drawElementsIndirectCount(topology, m_gpuVisibility->m_maxDrawcallCount,
+											   m_gpuVisibility->m_drawcallsOffset, m_gpuVisibility->m_buffer,
+											   m_gpuVisibility->m_drawcallCountOffset, m_gpuVisibility->m_buffer);
+}
+
 PtrSize RenderQueue::countAllRenderables() const
 {
 	PtrSize drawableCount = 0;
 	drawableCount += m_earlyZRenderables.getSize();
 	drawableCount += m_renderables.getSize();
 	drawableCount += m_forwardShadingRenderables.getSize();
+	drawableCount += m_gpuSceneRenderableCount;
 
 	for(const SpotLightQueueElement& slight : m_spotLights)
 	{
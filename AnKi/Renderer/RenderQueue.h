@@ -10,6 +10,7 @@
 #include <AnKi/Ui/Canvas.h>
 #include <AnKi/Shaders/Include/ClusteredShadingTypes.h>
 #include <AnKi/Shaders/Include/ModelTypes.h>
+#include <AnKi/Shaders/Include/GpuSceneTypes.h>
 
 namespace anki {
 
@@ -34,6 +35,16 @@ enum class RenderQueueDebugDrawFlag : U32
 	COUNT
 };
 
+/// The indirect drawcalls the GPU visibility wrote for a RenderQueueDrawContext.
+class RenderQueueGpuVisibilityInfo
+{
+public:
+	BufferPtr m_buffer; ///< Holds the drawcalls and their count.
+	PtrSize m_drawcallsOffset = 0;
+	PtrSize m_drawcallCountOffset = 0;
+	U32 m_maxDrawcallCount = 0;
+};
+
 /// Context that contains variables for drawing and will be passed to RenderQueueDrawCallback.
 class RenderQueueDrawContext final : public RenderingMatrices
 {
@@ -45,6 +56,13 @@ public:
 	StackAllocator<U8> m_frameAllocator;
 	Bool m_debugDraw; ///< If true the drawcall should be drawing some kind of debug mesh.
 	BitSet<U(RenderQueueDebugDrawFlag::COUNT), U32> m_debugDrawFlags = {false};
+
+	/// If not nullptr the GPU visibility built the drawcalls. Use drawElements() to draw.
+	const RenderQueueGpuVisibilityInfo* m_gpuVisibility = nullptr;
+
+	/// Draw all the instances or, if m_gpuVisibility is set, draw the drawcalls of the GPU visibility. In that case the
+	/// count and the first index are already in the drawcalls.
+	void drawElements(PrimitiveTopology topology, U32 count, U32 instanceCount, U32 firstIndex = 0, U32 baseVertex = 0);
 };
 
 /// Draw callback for drawing.
@@ -65,6 +83,8 @@ public:
 
 	U8 m_lod; ///< Don't set this. Visibility will.
 
+	Bool m_static; ///< The geometry never moved and doesn't animate. Don't set this. Visibility will.
+
 	RenderableQueueElement()
 	{
 	}
@@ -213,6 +233,11 @@ public:
 	Vec3 m_aabbMax;
 	U32 m_textureArrayIndex; ///< Renderer internal.
 
+	/// The cube texture of an offline bake. If it's not nullptr the renderer will use that instead of rendering the
+	/// probe. Totaly unsafe but we can't have a smart ptr in here since there will be no deletion.
+	Texture* m_bakedTexture;
+	const Char* m_bakedImageFilename; ///< Where the bake stores the probe. It's nullptr for dynamic probes.
+
 	ReflectionProbeQueueElement()
 	{
 	}
@@ -242,6 +267,10 @@ public:
 	Vec3 m_cellSizes; ///< The cells might not be cubes so have different sizes per dimension.
 	F32 m_fadeDistance;
 
+	/// The volume texture of an offline bake. See ReflectionProbeQueueElement::m_bakedTexture.
+	Texture* m_bakedTexture;
+	const Char* m_bakedImageFilename; ///< Where the bake stores the probe. It's nullptr for dynamic probes.
+
 	GlobalIlluminationProbeQueueElement()
 	{
 	}
@@ -393,6 +422,45 @@ public:
 
 static_assert(std::is_trivially_destructible<SkyboxQueueElement>::value == true, "Should be trivially destructible");
 
+/// The instances of the GPU scene that share a model patch. See GpuVisibilityDrawGroup.
+class GpuSceneDrawGroupQueueElement final
+{
+public:
+	/// It will be called once per LOD with RenderQueueDrawContext::m_gpuVisibility set.
+	RenderQueueDrawCallback m_callback;
+	const void* m_userData;
+
+	Array<U32, MAX_LOD_COUNT> m_firstIndices;
+	Array<U32, MAX_LOD_COUNT> m_indexCounts;
+
+	U32 m_index; ///< The index of the group. It's stable from frame to frame.
+	U32 m_instanceCount;
+	U32 m_firstInstance; ///< See GpuVisibilityDrawGroup::m_firstInstance.
+	Bool m_castsShadow;
+};
+
+static_assert(std::is_trivially_destructible<GpuSceneDrawGroupQueueElement>::value == true,
+			  "Should be trivially destructible");
+
+/// The persistent GPU scene and the updates it needs before this frame gets rendered.
+class GpuSceneQueueElement final
+{
+public:
+	Buffer* m_buffer = nullptr; ///< An array of RenderableGpuView.
+	WeakArray<GpuSceneRenderableUpdate> m_updates;
+
+	/// An array of GpuSceneInstance. It's nullptr if GPU driven rendering is disabled.
+	Buffer* m_instancesBuffer = nullptr;
+	U32 m_instanceCount = 0; ///< Including the unused instances.
+	WeakArray<GpuSceneInstanceUpdate> m_instanceUpdates;
+
+	WeakArray<GpuSceneDrawGroupQueueElement> m_drawGroups; ///< Sorted by material.
+	U32 m_drawGroupCount = 0; ///< The max GpuSceneDrawGroupQueueElement::m_index plus one.
+	U32 m_drawGroupInstanceCount = 0; ///< The sum of the instances of m_drawGroups.
+};
+
+static_assert(std::is_trivially_destructible<GpuSceneQueueElement>::value == true, "Should be trivially destructible");
+
 /// The render queue. This is what the renderer is fed to render.
 class RenderQueue : public RenderingMatrices
 {
@@ -418,9 +486,23 @@ public:
 
 	SkyboxQueueElement m_skybox;
 
+	/// Only the RenderQueue of the main camera has it.
+	GpuSceneQueueElement m_gpuScene;
+
+	/// The number of renderables that are visible but they are not in the queue because the GPU visibility will draw
+	/// them. Those are the GpuSceneInstances.
+	U32 m_gpuSceneRenderableCount = 0;
+
 	/// Applies only if the RenderQueue holds shadow casters. It's the max timesamp of all shadow casters
 	Timestamp m_shadowRenderablesLastUpdateTimestamp = 0;
 
+	/// Applies only if the RenderQueue holds shadow casters. The first m_staticShadowRenderableCount of m_renderables
+	/// are static geometry.
+	U32 m_staticShadowRenderableCount = 0;
+
+	/// Applies only if the RenderQueue holds shadow casters. It's the max timestamp of the static shadow casters.
+	Timestamp m_staticShadowRenderablesLastUpdateTimestamp = 0;
+
 	F32 m_cameraNear;
 	F32 m_cameraFar;
 	F32 m_cameraFovX;
@@ -33,6 +33,7 @@
 #include <AnKi/Renderer/IndirectSpecular.h>
 #include <AnKi/Renderer/VolumetricLightingAccumulation.h>
 #include <AnKi/Renderer/IndirectDiffuseProbes.h>
+#include <AnKi/Renderer/ProbeBaker.h>
 #include <AnKi/Renderer/GenericCompute.h>
 #include <AnKi/Renderer/ShadowmapsResolve.h>
 #include <AnKi/Renderer/RtShadows.h>
@@ -42,6 +43,8 @@
 #include <AnKi/Renderer/Scale.h>
 #include <AnKi/Renderer/IndirectDiffuse.h>
 #include <AnKi/Renderer/VrsSriGeneration.h>
+#include <AnKi/Renderer/GpuVisibility.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
 
 namespace anki {
 
@@ -95,7 +98,7 @@ Renderer::~Renderer()
 
 Error Renderer::init(ThreadHive* hive, ResourceManager* resources, GrManager* gl, StagingGpuMemoryPool* stagingMem,
 					 UiManager* ui, HeapAllocator<U8> alloc, ConfigSet* config, Timestamp* globTimestamp,
-					 UVec2 swapchainSize)
+					 UVec2 swapchainSize, F32 internalRenderScaling)
 {
 	ANKI_TRACE_SCOPED_EVENT(R_INIT);
 
@@ -108,7 +111,7 @@ Error Renderer::init(ThreadHive* hive, ResourceManager* resources, GrManager* gl
 	m_alloc = alloc;
 	m_config = config;
 
-	const Error err = initInternal(swapchainSize);
+	const Error err = initInternal(swapchainSize, internalRenderScaling);
 	if(err)
 	{
 		ANKI_R_LOGE("Failed to initialize the renderer");
@@ -117,7 +120,7 @@ Error Renderer::init(ThreadHive* hive, ResourceManager* resources, GrManager* gl
 	return err;
 }
 
-Error Renderer::initInternal(UVec2 swapchainResolution)
+Error Renderer::initInternal(UVec2 swapchainResolution, F32 internalRenderScaling)
 {
 	m_frameCount = 0;
 
@@ -126,17 +129,18 @@ Error Renderer::initInternal(UVec2 swapchainResolution)
 	alignRoundDown(2, m_postProcessResolution.x());
 	alignRoundDown(2, m_postProcessResolution.y());
 
-	m_internalResolution = UVec2(Vec2(m_postProcessResolution) * m_config->getRInternalRenderScaling());
-	alignRoundDown(2, m_internalResolution.x());
-	alignRoundDown(2, m_internalResolution.y());
+	m_maxInternalResolution = computeInternalResolution(internalRenderScaling);
+	m_internalResolution = m_maxInternalResolution;
+	m_prevInternalResolution = m_maxInternalResolution;
 
 	ANKI_R_LOGI("Initializing offscreen renderer. Resolution %ux%u. Internal resolution %ux%u",
 				m_postProcessResolution.x(), m_postProcessResolution.y(), m_internalResolution.x(),
 				m_internalResolution.y());
 
+	// The tiles cover the max resolution. A lower internal resolution uses less of them
 	m_tileSize = m_config->getRTileSize();
-	m_tileCounts.x() = (m_internalResolution.x() + m_tileSize - 1) / m_tileSize;
-	m_tileCounts.y() = (m_internalResolution.y() + m_tileSize - 1) / m_tileSize;
+	m_tileCounts.x() = (m_maxInternalResolution.x() + m_tileSize - 1) / m_tileSize;
+	m_tileCounts.y() = (m_maxInternalResolution.y() + m_tileSize - 1) / m_tileSize;
 	m_zSplitCount = m_config->getRZSplitCount();
 
 	// A few sanity checks
@@ -170,12 +174,18 @@ Error Renderer::initInternal(UVec2 swapchainResolution)
 	}
 
 	// Init the stages. Careful with the order!!!!!!!!!!
+	m_gpuSceneUpdate.reset(m_alloc.newInstance<GpuSceneUpdate>(this));
+	ANKI_CHECK(m_gpuSceneUpdate->init());
+
 	m_genericCompute.reset(m_alloc.newInstance<GenericCompute>(this));
 	ANKI_CHECK(m_genericCompute->init());
 
 	m_volumetricLightingAccumulation.reset(m_alloc.newInstance<VolumetricLightingAccumulation>(this));
 	ANKI_CHECK(m_volumetricLightingAccumulation->init());
 
+	m_probeBaker.reset(m_alloc.newInstance<ProbeBaker>(this));
+	ANKI_CHECK(m_probeBaker->init());
+
 	m_indirectDiffuseProbes.reset(m_alloc.newInstance<IndirectDiffuseProbes>(this));
 	ANKI_CHECK(m_indirectDiffuseProbes->init());
 
@@ -188,6 +198,9 @@ Error Renderer::initInternal(UVec2 swapchainResolution)
 	m_scale.reset(m_alloc.newInstance<Scale>(this));
 	ANKI_CHECK(m_scale->init());
 
+	m_gpuVisibility.reset(m_alloc.newInstance<GpuVisibility>(this));
+	ANKI_CHECK(m_gpuVisibility->init());
+
 	m_gbuffer.reset(m_alloc.newInstance<GBuffer>(this));
 	ANKI_CHECK(m_gbuffer->init());
 
@@ -277,15 +290,7 @@ Error Renderer::initInternal(UVec2 swapchainResolution)
 		sinit.m_anisotropyLevel = m_config->getRTextureAnisotropy();
 		m_samplers.m_trilinearRepeatAniso = m_gr->newSampler(sinit);
 
-		F32 scalingMipBias = log2(F32(m_internalResolution.x()) / F32(m_postProcessResolution.x()));
-		if(getScale().getUsingGrUpscaler())
-		{
-			// DLSS wants more bias
-			scalingMipBias -= 1.0f;
-		}
-
-		sinit.m_lodBias = scalingMipBias;
-		m_samplers.m_trilinearRepeatAnisoResolutionScalingBias = m_gr->newSampler(sinit);
+		createResolutionScalingSamplers();
 	}
 
 	for(U32 i = 0; i < m_jitterOffsets.getSize(); ++i)
@@ -296,6 +301,46 @@ Error Renderer::initInternal(UVec2 swapchainResolution)
 	return Error::NONE;
 }
 
+UVec2 Renderer::computeInternalResolution(F32 internalRenderScaling) const
+{
+	UVec2 rez = UVec2(Vec2(m_postProcessResolution) * internalRenderScaling);
+	alignRoundDown(2, rez.x());
+	alignRoundDown(2, rez.y());
+	return rez;
+}
+
+void Renderer::createResolutionScalingSamplers()
+{
+	SamplerInitInfo sinit("RendererScalingBias");
+	sinit.m_addressing = SamplingAddressing::REPEAT;
+	sinit.m_minMagFilter = SamplingFilter::LINEAR;
+	sinit.m_mipmapFilter = SamplingFilter::LINEAR;
+	sinit.m_anisotropyLevel = m_config->getRTextureAnisotropy();
+
+	F32 scalingMipBias = log2(F32(m_internalResolution.x()) / F32(m_postProcessResolution.x()));
+	if(getScale().getUsingGrUpscaler())
+	{
+		// DLSS wants more bias
+		scalingMipBias -= 1.0f;
+	}
+
+	sinit.m_lodBias = scalingMipBias;
+	m_samplers.m_trilinearRepeatAnisoResolutionScalingBias = m_gr->newSampler(sinit);
+}
+
+void Renderer::setInternalRenderScaling(F32 internalRenderScaling)
+{
+	UVec2 rez = computeInternalResolution(internalRenderScaling);
+	rez = rez.min(m_maxInternalResolution);
+	rez = rez.max(UVec2(64u));
+
+	if(rez != m_internalResolution)
+	{
+		m_internalResolution = rez;
+		createResolutionScalingSamplers();
+	}
+}
+
 Error Renderer::populateRenderGraph(RenderingContext& ctx)
 {
 	ctx.m_prevMatrices = m_prevMatrices;
@@ -336,6 +381,12 @@ Error Renderer::populateRenderGraph(RenderingContext& ctx)
 		m_resourcesDirty = false;
 	}
 
+	// Store the baked probes that finished rendering a few frames ago
+	if(m_probeBaker->isEnabled())
+	{
+		m_probeBaker->writeCompletedReadbacks();
+	}
+
 	// Import RTs first
 	m_downscaleBlur->importRenderTargets(ctx);
 	m_tonemapping->importRenderTargets(ctx);
@@ -343,6 +394,7 @@ Error Renderer::populateRenderGraph(RenderingContext& ctx)
 	m_vrsSriGeneration->importRenderTargets(ctx);
 
 	// Populate render graph. WARNING Watch the order
+	m_gpuSceneUpdate->populateRenderGraph(ctx);
 	m_genericCompute->populateRenderGraph(ctx);
 	m_clusterBinning->populateRenderGraph(ctx);
 	if(m_accelerationStructureBuilder)
@@ -394,6 +446,7 @@ void Renderer::finalize(const RenderingContext& ctx)
 	++m_frameCount;
 
 	m_prevMatrices = ctx.m_matrices;
+	m_prevInternalResolution = m_internalResolution;
 
 	// Inform about the HiZ map. Do it as late as possible
 	if(ctx.m_renderQueue->m_fillCoverageBufferCallback)
@@ -56,11 +56,43 @@ public:
 		return m_rtShadows.isCreated();
 	}
 
+	/// The resolution the passes up until TAA render at this frame. The render targets of those passes are allocated
+	/// with getMaxInternalResolution() and only their top left getInternalResolution() part is rendered.
 	const UVec2& getInternalResolution() const
 	{
 		return m_internalResolution;
 	}
 
+	/// The resolution of the render targets of the passes up until TAA.
+	const UVec2& getMaxInternalResolution() const
+	{
+		return m_maxInternalResolution;
+	}
+
+	/// The internal resolution of the previous frame. Use it to sample history render targets.
+	const UVec2& getPreviousInternalResolution() const
+	{
+		return m_prevInternalResolution;
+	}
+
+	/// Get the factors that convert [0, 1] viewport UVs to UVs of a render target of the internal resolution. xy is the
+	/// scale and zw the max UV (the center of the last rendered texel). See scaleRenderingUv() in the shaders.
+	/// @param downscale The render target is getMaxInternalResolution() / downscale.
+	Vec4 getInternalResolutionUvScaleAndMax(U32 downscale = 1) const
+	{
+		return computeUvScaleAndMax(m_internalResolution / downscale, m_maxInternalResolution / downscale);
+	}
+
+	/// Same as getInternalResolutionUvScaleAndMax() but for the render targets written in the previous frame.
+	Vec4 getPreviousInternalResolutionUvScaleAndMax(U32 downscale = 1) const
+	{
+		return computeUvScaleAndMax(m_prevInternalResolution / downscale, m_maxInternalResolution / downscale);
+	}
+
+	/// Change the internal resolution. It's a factor over the post processing resolution and it can't go over the one
+	/// given in init(). It takes effect on the next populateRenderGraph().
+	void setInternalRenderScaling(F32 internalRenderScaling);
+
 	const UVec2& getPostProcessResolution() const
 	{
 		return m_postProcessResolution;
@@ -68,13 +100,15 @@ public:
 
 	F32 getAspectRatio() const
 	{
-		return F32(m_internalResolution.x()) / F32(m_internalResolution.y());
+		return F32(m_maxInternalResolution.x()) / F32(m_maxInternalResolution.y());
 	}
 
 	/// Init the renderer.
+	/// @param internalRenderScaling A factor over the post processing resolution. Applies to all passes up to TAA. It's
+	///        the max scaling that setInternalRenderScaling() can set.
 	Error init(ThreadHive* hive, ResourceManager* resources, GrManager* gr, StagingGpuMemoryPool* stagingMem,
 			   UiManager* ui, HeapAllocator<U8> alloc, ConfigSet* config, Timestamp* globTimestamp,
-			   UVec2 swapchainSize);
+			   UVec2 swapchainSize, F32 internalRenderScaling);
 
 	/// This function does all the rendering stages and produces a final result.
 	Error populateRenderGraph(RenderingContext& ctx);
@@ -248,6 +282,8 @@ private:
 	U32 m_zSplitCount = 0;
 
 	UVec2 m_internalResolution = UVec2(0u); ///< The resolution of all passes up until TAA.
+	UVec2 m_maxInternalResolution = UVec2(0u); ///< The size of the render targets of all passes up until TAA.
+	UVec2 m_prevInternalResolution = UVec2(0u);
 	UVec2 m_postProcessResolution = UVec2(0u); ///< The resolution of post processing and following passes.
 
 	RenderableDrawer m_sceneDrawer;
@@ -279,7 +315,17 @@ private:
 	DynamicArray<DebugRtInfo> m_debugRts;
 	String m_currentDebugRtName;
 
-	Error initInternal(UVec2 swapchainSize);
+	Error initInternal(UVec2 swapchainSize, F32 internalRenderScaling);
+
+	UVec2 computeInternalResolution(F32 internalRenderScaling) const;
+
+	void createResolutionScalingSamplers();
+
+	static Vec4 computeUvScaleAndMax(UVec2 renderedSize, UVec2 textureSize)
+	{
+		const Vec2 texSize(textureSize);
+		return Vec4(Vec2(renderedSize) / texSize, (Vec2(renderedSize) - 0.5f) / texSize);
+	}
 };
 /// @}
 
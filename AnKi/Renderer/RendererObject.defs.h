@@ -31,3 +31,6 @@ ANKI_RENDERER_OBJECT_DEF(ClusterBinning, clusterBinning)
 ANKI_RENDERER_OBJECT_DEF(Scale, scale)
 ANKI_RENDERER_OBJECT_DEF(IndirectDiffuse, indirectDiffuse)
 ANKI_RENDERER_OBJECT_DEF(VrsSriGeneration, vrsSriGeneration)
+ANKI_RENDERER_OBJECT_DEF(GpuVisibility, gpuVisibility)
+ANKI_RENDERER_OBJECT_DEF(GpuSceneUpdate, gpuSceneUpdate)
+ANKI_RENDERER_OBJECT_DEF(ProbeBaker, probeBaker)
@@ -66,8 +66,6 @@ Error RtShadows::initInternal()
 	{
 		ANKI_CHECK(getResourceManager().loadResource("ShaderBinaries/RtShadowsDenoise.ankiprogbin", m_denoiseProg));
 		ShaderProgramResourceVariantInitInfo variantInitInfo(m_denoiseProg);
-		variantInitInfo.addConstant("OUT_IMAGE_SIZE",
-									UVec2(m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2));
 		variantInitInfo.addConstant("MIN_SAMPLE_COUNT", 8u);
 		variantInitInfo.addConstant("MAX_SAMPLE_COUNT", 32u);
 		variantInitInfo.addMutation("BLUR_ORIENTATION", 0);
@@ -86,12 +84,8 @@ Error RtShadows::initInternal()
 	{
 		ANKI_CHECK(
 			getResourceManager().loadResource("ShaderBinaries/RtShadowsSvgfVariance.ankiprogbin", m_svgfVarianceProg));
-		ShaderProgramResourceVariantInitInfo variantInitInfo(m_svgfVarianceProg);
-		variantInitInfo.addConstant("FB_SIZE",
-									UVec2(m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2));
-
 		const ShaderProgramResourceVariant* variant;
-		m_svgfVarianceProg->getOrCreateVariant(variantInitInfo, variant);
+		m_svgfVarianceProg->getOrCreateVariant(variant);
 		m_svgfVarianceGrProg = variant->getProgram();
 	}
 
@@ -101,8 +95,6 @@ Error RtShadows::initInternal()
 		ANKI_CHECK(
 			getResourceManager().loadResource("ShaderBinaries/RtShadowsSvgfAtrous.ankiprogbin", m_svgfAtrousProg));
 		ShaderProgramResourceVariantInitInfo variantInitInfo(m_svgfAtrousProg);
-		variantInitInfo.addConstant("FB_SIZE",
-									UVec2(m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2));
 		variantInitInfo.addMutation("LAST_PASS", 0);
 
 		const ShaderProgramResourceVariant* variant;
@@ -117,12 +109,8 @@ Error RtShadows::initInternal()
 	// Upscale program
 	{
 		ANKI_CHECK(getResourceManager().loadResource("ShaderBinaries/RtShadowsUpscale.ankiprogbin", m_upscaleProg));
-		ShaderProgramResourceVariantInitInfo variantInitInfo(m_upscaleProg);
-		variantInitInfo.addConstant("OUT_IMAGE_SIZE",
-									UVec2(m_r->getInternalResolution().x(), m_r->getInternalResolution().y()));
-
 		const ShaderProgramResourceVariant* variant;
-		m_upscaleProg->getOrCreateVariant(variantInitInfo, variant);
+		m_upscaleProg->getOrCreateVariant(variant);
 		m_upscaleGrProg = variant->getProgram();
 	}
 
@@ -130,10 +118,13 @@ Error RtShadows::initInternal()
 	ANKI_CHECK(getResourceManager().loadResource("ShaderBinaries/RtShadowsVisualizeRenderTarget.ankiprogbin",
 												 m_visualizeRenderTargetsProg));
 
+	// The RTs are allocated with the max resolution and the passes render to their top left part
+	const UVec2 maxRez = m_r->getMaxInternalResolution();
+
 	// Quarter rez shadow RT
 	{
 		TextureInitInfo texinit = m_r->create2DRenderTargetInitInfo(
-			m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2, Format::R32G32_UINT,
+			maxRez.x() / 2, maxRez.y() / 2, Format::R32G32_UINT,
 			TextureUsageBit::ALL_SAMPLED | TextureUsageBit::IMAGE_TRACE_RAYS_WRITE
 				| TextureUsageBit::IMAGE_COMPUTE_WRITE,
 			"RtShadows History");
@@ -142,16 +133,15 @@ Error RtShadows::initInternal()
 
 	// Temp shadow RT
 	{
-		m_intermediateShadowsRtDescr = m_r->create2DRenderTargetDescription(m_r->getInternalResolution().x() / 2,
-																			m_r->getInternalResolution().y() / 2,
-																			Format::R32G32_UINT, "RtShadows Tmp");
+		m_intermediateShadowsRtDescr =
+			m_r->create2DRenderTargetDescription(maxRez.x() / 2, maxRez.y() / 2, Format::R32G32_UINT, "RtShadows Tmp");
 		m_intermediateShadowsRtDescr.bake();
 	}
 
 	// Moments RT
 	{
 		TextureInitInfo texinit = m_r->create2DRenderTargetInitInfo(
-			m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2, Format::R32G32_SFLOAT,
+			maxRez.x() / 2, maxRez.y() / 2, Format::R32G32_SFLOAT,
 			TextureUsageBit::ALL_SAMPLED | TextureUsageBit::IMAGE_TRACE_RAYS_WRITE
 				| TextureUsageBit::IMAGE_COMPUTE_WRITE,
 			"RtShadows Moments #1");
@@ -164,17 +154,15 @@ Error RtShadows::initInternal()
 	// Variance RT
 	if(m_useSvgf)
 	{
-		m_varianceRtDescr = m_r->create2DRenderTargetDescription(m_r->getInternalResolution().x() / 2,
-																 m_r->getInternalResolution().y() / 2,
-																 Format::R32_SFLOAT, "RtShadows Variance");
+		m_varianceRtDescr = m_r->create2DRenderTargetDescription(maxRez.x() / 2, maxRez.y() / 2, Format::R32_SFLOAT,
+																 "RtShadows Variance");
 		m_varianceRtDescr.bake();
 	}
 
 	// Final RT
 	{
 		m_upscaledRtDescr =
-			m_r->create2DRenderTargetDescription(m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
-												 Format::R32G32_UINT, "RtShadows Upscaled");
+			m_r->create2DRenderTargetDescription(maxRez.x(), maxRez.y(), Format::R32G32_UINT, "RtShadows Upscaled");
 		m_upscaledRtDescr.bake();
 	}
 
@@ -272,7 +260,7 @@ void RtShadows::populateRenderGraph(RenderingContext& ctx)
 	{
 		ComputeRenderPassDescription& rpass = rgraph.newComputeRenderPass("RtShadows Denoise Horizontal");
 		rpass.setWork([this, &ctx](RenderPassWorkContext& rgraphCtx) {
-			runDenoise(ctx, rgraphCtx);
+			runDenoise(ctx, rgraphCtx, 0);
 		});
 
 		rpass.newDependency(
@@ -292,7 +280,7 @@ void RtShadows::populateRenderGraph(RenderingContext& ctx)
 	{
 		ComputeRenderPassDescription& rpass = rgraph.newComputeRenderPass("RtShadows Denoise Vertical");
 		rpass.setWork([this, &ctx](RenderPassWorkContext& rgraphCtx) {
-			runDenoise(ctx, rgraphCtx);
+			runDenoise(ctx, rgraphCtx, 1);
 		});
 
 		rpass.newDependency(
@@ -330,16 +318,14 @@ void RtShadows::populateRenderGraph(RenderingContext& ctx)
 	// SVGF Atrous
 	if(m_useSvgf)
 	{
-		m_runCtx.m_atrousPassIdx = 0;
-
 		for(U32 i = 0; i < m_atrousPassCount; ++i)
 		{
 			const Bool lastPass = i == U32(m_atrousPassCount - 1);
 			const U32 readRtIdx = (i + 1) & 1;
 
 			ComputeRenderPassDescription& rpass = rgraph.newComputeRenderPass("RtShadows SVGF Atrous");
-			rpass.setWork([this, &ctx](RenderPassWorkContext& rgraphCtx) {
-				runSvgfAtrous(ctx, rgraphCtx);
+			rpass.setWork([this, &ctx, i](RenderPassWorkContext& rgraphCtx) {
+				runSvgfAtrous(ctx, rgraphCtx, i);
 			});
 
 			rpass.newDependency(depthDependency);
@@ -484,37 +470,39 @@ void RtShadows::run(const RenderingContext& ctx, RenderPassWorkContext& rgraphCt
 	{
 		unis.historyRejectFactor[i] = F32(m_runCtx.m_layersWithRejectedHistory.get(i));
 	}
+	unis.uvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	unis.prevHalfUvScaleAndMax = m_r->getPreviousInternalResolutionUvScaleAndMax(2);
 	cmdb->setPushConstants(&unis, sizeof(unis));
 
 	cmdb->traceRays(m_runCtx.m_sbtBuffer, m_runCtx.m_sbtOffset, m_sbtRecordSize, m_runCtx.m_hitGroupCount, 1,
 					m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2, 1);
 }
 
-void RtShadows::runDenoise(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx)
+void RtShadows::runDenoise(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx, U32 orientation)
 {
 	CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
 
-	cmdb->bindShaderProgram((m_runCtx.m_denoiseOrientation == 0) ? m_grDenoiseHorizontalProg : m_grDenoiseVerticalProg);
+	cmdb->bindShaderProgram((orientation == 0) ? m_grDenoiseHorizontalProg : m_grDenoiseVerticalProg);
 
 	cmdb->bindSampler(0, 0, m_r->getSamplers().m_nearestNearestClamp);
 	cmdb->bindSampler(0, 1, m_r->getSamplers().m_trilinearClamp);
-	rgraphCtx.bindColorTexture(0, 2, m_runCtx.m_intermediateShadowsRts[m_runCtx.m_denoiseOrientation]);
+	rgraphCtx.bindColorTexture(0, 2, m_runCtx.m_intermediateShadowsRts[orientation]);
 	rgraphCtx.bindTexture(0, 3, m_r->getDepthDownscale().getHiZRt(), HIZ_HALF_DEPTH);
 	rgraphCtx.bindColorTexture(0, 4, m_r->getGBuffer().getColorRt(2));
 	rgraphCtx.bindColorTexture(0, 5, m_runCtx.m_currentMomentsRt);
 	rgraphCtx.bindColorTexture(0, 6, m_r->getMotionVectors().getHistoryLengthRt());
 
-	rgraphCtx.bindImage(
-		0, 7, (m_runCtx.m_denoiseOrientation == 0) ? m_runCtx.m_intermediateShadowsRts[1] : m_runCtx.m_historyRt);
+	rgraphCtx.bindImage(0, 7, (orientation == 0) ? m_runCtx.m_intermediateShadowsRts[1] : m_runCtx.m_historyRt);
 
 	RtShadowsDenoiseUniforms unis;
 	unis.invViewProjMat = ctx.m_matrices.m_invertedViewProjectionJitter;
 	unis.time = F32(m_r->getGlobalTimestamp());
+	unis.outImageSize = m_r->getInternalResolution() / 2;
+	unis.uvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	unis.halfUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax(2);
 	cmdb->setPushConstants(&unis, sizeof(unis));
 
 	dispatchPPCompute(cmdb, 8, 8, m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2);
-
-	m_runCtx.m_denoiseOrientation = !m_runCtx.m_denoiseOrientation;
 }
 
 void RtShadows::runSvgfVariance(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx)
@@ -534,18 +522,30 @@ void RtShadows::runSvgfVariance(const RenderingContext& ctx, RenderPassWorkConte
 	rgraphCtx.bindImage(0, 6, m_runCtx.m_intermediateShadowsRts[1]);
 	rgraphCtx.bindImage(0, 7, m_runCtx.m_varianceRts[1]);
 
-	const Mat4& invProjMat = ctx.m_matrices.m_projectionJitter.getInverse();
-	cmdb->setPushConstants(&invProjMat, sizeof(invProjMat));
+	class
+	{
+	public:
+		Mat4 m_invProjMat;
+		Vec4 m_uvScaleAndMax;
+		Vec4 m_halfUvScaleAndMax;
+		UVec2 m_fbSize;
+		UVec2 m_padding0;
+	} pc;
+	pc.m_invProjMat = ctx.m_matrices.m_projectionJitter.getInverse();
+	pc.m_uvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	pc.m_halfUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax(2);
+	pc.m_fbSize = m_r->getInternalResolution() / 2;
+	cmdb->setPushConstants(&pc, sizeof(pc));
 
 	dispatchPPCompute(cmdb, 8, 8, m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2);
 }
 
-void RtShadows::runSvgfAtrous(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx)
+void RtShadows::runSvgfAtrous(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx, U32 passIdx)
 {
 	CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
 
-	const Bool lastPass = m_runCtx.m_atrousPassIdx == m_atrousPassCount - 1;
-	const U32 readRtIdx = (m_runCtx.m_atrousPassIdx + 1) & 1;
+	const Bool lastPass = passIdx == U32(m_atrousPassCount - 1);
+	const U32 readRtIdx = (passIdx + 1) & 1;
 
 	if(lastPass)
 	{
@@ -573,12 +573,20 @@ void RtShadows::runSvgfAtrous(const RenderingContext& ctx, RenderPassWorkContext
 		rgraphCtx.bindImage(0, 5, m_runCtx.m_historyRt);
 	}
 
-	const Mat4& invProjMat = ctx.m_matrices.m_projectionJitter.getInverse();
-	cmdb->setPushConstants(&invProjMat, sizeof(invProjMat));
+	class
+	{
+	public:
+		Mat4 m_invProjMat;
+		Vec4 m_halfUvScaleAndMax;
+		UVec2 m_fbSize;
+		UVec2 m_padding0;
+	} pc;
+	pc.m_invProjMat = ctx.m_matrices.m_projectionJitter.getInverse();
+	pc.m_halfUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax(2);
+	pc.m_fbSize = m_r->getInternalResolution() / 2;
+	cmdb->setPushConstants(&pc, sizeof(pc));
 
 	dispatchPPCompute(cmdb, 8, 8, m_r->getInternalResolution().x() / 2, m_r->getInternalResolution().y() / 2);
-
-	++m_runCtx.m_atrousPassIdx;
 }
 
 void RtShadows::runUpscale(RenderPassWorkContext& rgraphCtx)
@@ -595,6 +603,19 @@ void RtShadows::runUpscale(RenderPassWorkContext& rgraphCtx)
 	rgraphCtx.bindTexture(0, 4, m_r->getDepthDownscale().getHiZRt(), HIZ_HALF_DEPTH);
 	rgraphCtx.bindTexture(0, 5, m_r->getGBuffer().getDepthRt(), TextureSubresourceInfo(DepthStencilAspectBit::DEPTH));
 
+	class
+	{
+	public:
+		Vec4 m_fullDepthUvScaleAndMax;
+		Vec4 m_quarterShadowsUvScaleAndMax;
+		UVec2 m_outImageSize;
+		UVec2 m_padding0;
+	} pc;
+	pc.m_fullDepthUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+	pc.m_quarterShadowsUvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax(2);
+	pc.m_outImageSize = m_r->getInternalResolution();
+	cmdb->setPushConstants(&pc, sizeof(pc));
+
 	dispatchPPCompute(cmdb, 8, 8, m_r->getInternalResolution().x(), m_r->getInternalResolution().y());
 }
 
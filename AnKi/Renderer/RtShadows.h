@@ -113,17 +113,14 @@ public:
 		U32 m_hitGroupCount = 0;
 
 		BitSet<MAX_RT_SHADOW_LAYERS, U8> m_layersWithRejectedHistory = {false};
-
-		U8 m_atrousPassIdx = 0;
-		U8 m_denoiseOrientation = 0;
 	} m_runCtx;
 
 	Error initInternal();
 
 	void run(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx);
-	void runDenoise(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx);
+	void runDenoise(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx, U32 orientation);
 	void runSvgfVariance(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx);
-	void runSvgfAtrous(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx);
+	void runSvgfAtrous(const RenderingContext& ctx, RenderPassWorkContext& rgraphCtx, U32 passIdx);
 	void runUpscale(RenderPassWorkContext& rgraphCtx);
 
 	void buildSbt(RenderingContext& ctx);
@@ -38,7 +38,9 @@ Scale::~Scale()
 
 Error Scale::init()
 {
-	const Bool needsScaling = m_r->getPostProcessResolution() != m_r->getInternalResolution();
+	// With dynamic resolution the internal resolution changes every few frames so always scale
+	const Bool needsScaling = m_r->getPostProcessResolution() != m_r->getMaxInternalResolution()
+							  || getConfig().getRDynamicResolution();
 	const Bool needsSharpening = getConfig().getRSharpness() > 0.0f;
 	if(!needsScaling && !needsSharpening)
 	{
@@ -108,7 +110,7 @@ Error Scale::init()
 	else if(m_upscalingMethod == UpscalingMethod::GR)
 	{
 		GrUpscalerInitInfo inf;
-		inf.m_sourceTextureResolution = m_r->getInternalResolution();
+		inf.m_sourceTextureResolution = m_r->getMaxInternalResolution();
 		inf.m_targetTextureResolution = m_r->getPostProcessResolution();
 		inf.m_upscalerType = GrUpscalerType::DLSS_2;
 		inf.m_qualityMode = GrUpscalerQualityMode(dlssQuality - 1);
@@ -350,27 +352,32 @@ void Scale::runFsrOrBilinearScaling(RenderPassWorkContext& rgraphCtx)
 			UVec2 m_padding;
 		} pc;
 
-		const Vec2 inRez(m_r->getInternalResolution());
+		// The input is rendered in the top left part of the TAA RT
+		const Vec2 inViewport(m_r->getInternalResolution());
+		const Vec2 inRez(m_r->getMaxInternalResolution());
 		const Vec2 outRez(m_r->getPostProcessResolution());
-		FsrEasuCon(&pc.m_fsrConsts0[0], &pc.m_fsrConsts1[0], &pc.m_fsrConsts2[0], &pc.m_fsrConsts3[0], inRez.x(),
-				   inRez.y(), inRez.x(), inRez.y(), outRez.x(), outRez.y());
+		FsrEasuCon(&pc.m_fsrConsts0[0], &pc.m_fsrConsts1[0], &pc.m_fsrConsts2[0], &pc.m_fsrConsts3[0], inViewport.x(),
+				   inViewport.y(), inRez.x(), inRez.y(), outRez.x(), outRez.y());
 
 		pc.m_viewportSize = m_r->getPostProcessResolution();
 
 		cmdb->setPushConstants(&pc, sizeof(pc));
 	}
-	else if(preferCompute)
+	else
 	{
 		class
 		{
 		public:
+			Vec4 m_uvScaleAndMax;
 			Vec2 m_viewportSize;
 			UVec2 m_viewportSizeU;
 		} pc;
+		pc.m_uvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
 		pc.m_viewportSize = Vec2(m_r->getPostProcessResolution());
 		pc.m_viewportSizeU = m_r->getPostProcessResolution();
 
-		cmdb->setPushConstants(&pc, sizeof(pc));
+		// The raster variant only has the UV scale
+		cmdb->setPushConstants(&pc, (preferCompute) ? sizeof(pc) : sizeof(pc.m_uvScaleAndMax));
 	}
 
 	if(preferCompute)
@@ -434,6 +441,8 @@ void Scale::runRcasSharpening(RenderPassWorkContext& rgraphCtx)
 
 void Scale::runGrUpscaling(RenderingContext& ctx, RenderPassWorkContext& rgraphCtx)
 {
+	// The upscaler was created with the max resolution. Only the top left part of the inputs is rendered so pass that
+	// size as well
 	const Vec2 srcRes(m_r->getInternalResolution());
 	const Bool reset = m_r->getFrameCount() == 0;
 	const Vec2 mvScale = srcRes; // UV space to Pixel space factor
@@ -449,7 +458,7 @@ void Scale::runGrUpscaling(RenderingContext& ctx, RenderPassWorkContext& rgraphC
 	TextureViewPtr dstView = rgraphCtx.createTextureView(m_runCtx.m_upscaledHdrRt);
 
 	cmdb->upscale(m_grUpscaler, srcView, dstView, motionVectorsView, depthView, exposureView, reset, jitterOffset,
-				  mvScale);
+				  mvScale, m_r->getInternalResolution());
 }
 
 void Scale::runTonemapping(RenderPassWorkContext& rgraphCtx)
@@ -6,6 +6,7 @@
 #include <AnKi/Renderer/ShadowMapping.h>
 #include <AnKi/Renderer/Renderer.h>
 #include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Renderer/GpuSceneUpdate.h>
 #include <AnKi/Core/ConfigSet.h>
 #include <AnKi/Util/ThreadHive.h>
 #include <AnKi/Util/Tracer.h>
@@ -21,6 +22,7 @@ public:
 	U32 m_renderableElementCount;
 	U32 m_threadPoolTaskIdx;
 	U32 m_renderQueueElementsLod;
+	U32 m_gpuVisibilityIdx; ///< Index to Scratch::m_gpuVisibility. Valid if it draws the GPU scene.
 };
 
 class ShadowMapping::Scratch::LightToRenderToScratchInfo
@@ -28,7 +30,16 @@ class ShadowMapping::Scratch::LightToRenderToScratchInfo
 public:
 	UVec4 m_viewport;
 	RenderQueue* m_renderQueue;
-	U32 m_drawcallCount;
+	U32 m_firstRenderableElement; ///< The static casters may be skipped.
+	U32 m_drawcallCount; ///< If the light has GPU scene casters they are one more drawcall after the renderables.
+	U32 m_renderQueueElementsLod;
+};
+
+class ShadowMapping::StaticCache::WorkItem
+{
+public:
+	UVec4 m_viewport;
+	RenderQueue* m_renderQueue; ///< The first RenderQueue::m_staticShadowRenderableCount renderables will be drawn.
 	U32 m_renderQueueElementsLod;
 };
 
@@ -38,11 +49,21 @@ public:
 	Vec4 m_uvInBounds; ///< Bounds used to avoid blurring neighbour tiles.
 	Vec4 m_uvIn; ///< UV + size that point to the scratch buffer.
 	UVec4 m_viewportOut; ///< Viewport in the atlas RT.
+	Vec2 m_staticCacheUvScale; ///< Transforms the scratch UV to the static cache UV.
+	Vec2 m_staticCacheUvTranslation;
+	U32 m_inputs; ///< Mask of EVSM_INPUT_SCRATCH and EVSM_INPUT_STATIC_CACHE.
 	Bool m_blur;
 };
 
+/// The drawcalls of a shadow render queue. The casters of the GPU scene count as one drawcall.
+static U32 getShadowDrawcallCount(const RenderQueue& rqueue)
+{
+	return rqueue.m_renderables.getSize() + ((rqueue.m_gpuSceneRenderableCount > 0) ? 1 : 0);
+}
+
 ShadowMapping::~ShadowMapping()
 {
+	m_scratch.m_gpuVisibility.destroy(getAllocator());
 }
 
 Error ShadowMapping::init()
@@ -144,10 +165,43 @@ Error ShadowMapping::initAtlas()
 	return Error::NONE;
 }
 
+Error ShadowMapping::initStaticCache()
+{
+	if(!getConfig().getRShadowMappingStaticCache())
+	{
+		return Error::NONE;
+	}
+
+	m_staticCache.m_tileCountBothAxis = getConfig().getRShadowMappingStaticCacheTileCountPerRowOrColumn();
+	const U32 tileResolution = getConfig().getRShadowMappingTileResolution();
+
+	// RT
+	TextureInitInfo texinit = m_r->create2DRenderTargetInitInfo(
+		tileResolution * m_staticCache.m_tileCountBothAxis, tileResolution * m_staticCache.m_tileCountBothAxis,
+		m_r->getDepthNoStencilFormat(),
+		TextureUsageBit::ALL_SAMPLED | TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, "SM static cache");
+	ClearValue clearVal;
+	clearVal.m_depthStencil.m_depth = 1.0f;
+	m_staticCache.m_tex = m_r->createAndClearRenderTarget(texinit, TextureUsageBit::SAMPLED_FRAGMENT, clearVal);
+
+	// Tiles
+	m_staticCache.m_tileAlloc.init(getAllocator(), m_staticCache.m_tileCountBothAxis,
+								   m_staticCache.m_tileCountBothAxis, MAX_LOD_COUNT, true);
+
+	// FB. The render area of every pass is a single tile so only that will be cleared
+	m_staticCache.m_fbDescr.m_depthStencilAttachment.m_loadOperation = AttachmentLoadOperation::CLEAR;
+	m_staticCache.m_fbDescr.m_depthStencilAttachment.m_clearValue.m_depthStencil.m_depth = 1.0f;
+	m_staticCache.m_fbDescr.m_depthStencilAttachment.m_aspect = DepthStencilAspectBit::DEPTH;
+	m_staticCache.m_fbDescr.bake();
+
+	return Error::NONE;
+}
+
 Error ShadowMapping::initInternal()
 {
 	ANKI_CHECK(initScratch());
 	ANKI_CHECK(initAtlas());
+	ANKI_CHECK(initStaticCache());
 	return Error::NONE;
 }
 
@@ -175,14 +229,35 @@ void ShadowMapping::runAtlas(RenderPassWorkContext& rgraphCtx)
 		uni.m_uvMin = workItem.m_uvInBounds.xy();
 		uni.m_uvMax = workItem.m_uvInBounds.xy() + workItem.m_uvInBounds.zw();
 
+		uni.m_staticCacheUvScale = workItem.m_staticCacheUvScale;
+		uni.m_staticCacheUvTranslation = workItem.m_staticCacheUvTranslation;
+
 		uni.m_blur = workItem.m_blur;
+		uni.m_inputs = workItem.m_inputs;
 	}
 
 	cmdb->bindShaderProgram(m_atlas.m_resolveGrProg);
 
 	// Continue
 	cmdb->bindSampler(0, 1, m_r->getSamplers().m_trilinearClamp);
-	rgraphCtx.bindTexture(0, 2, m_scratch.m_rt, TextureSubresourceInfo(DepthStencilAspectBit::DEPTH));
+
+	if(m_scratch.m_workItems.getSize())
+	{
+		rgraphCtx.bindTexture(0, 2, m_scratch.m_rt, TextureSubresourceInfo(DepthStencilAspectBit::DEPTH));
+	}
+	else
+	{
+		cmdb->bindTexture(0, 2, m_r->getDummyTextureView2d());
+	}
+
+	if(m_staticCache.m_sampledThisFrame)
+	{
+		rgraphCtx.bindTexture(0, 4, m_staticCache.m_rt, TextureSubresourceInfo(DepthStencilAspectBit::DEPTH));
+	}
+	else
+	{
+		cmdb->bindTexture(0, 4, m_r->getDummyTextureView2d());
+	}
 
 	if(getConfig().getRPreferCompute())
 	{
@@ -229,12 +304,56 @@ void ShadowMapping::runShadowMapping(RenderPassWorkContext& rgraphCtx)
 		args.m_sampler = m_r->getSamplers().m_trilinearRepeatAniso;
 		args.m_minLod = args.m_maxLod = work.m_renderQueueElementsLod;
 
-		m_r->getSceneDrawer().drawRange(RenderingTechnique::SHADOW, args,
-										work.m_renderQueue->m_renderables.getBegin() + work.m_firstRenderableElement,
-										work.m_renderQueue->m_renderables.getBegin() + work.m_firstRenderableElement
-											+ work.m_renderableElementCount,
-										cmdb);
+		// The GPU scene is the element after the last renderable
+		const U32 renderableCount = work.m_renderQueue->m_renderables.getSize();
+		const U32 end = work.m_firstRenderableElement + work.m_renderableElementCount;
+		const U32 cpuEnd = min(end, renderableCount);
+
+		if(work.m_firstRenderableElement < cpuEnd)
+		{
+			m_r->getSceneDrawer().drawRange(RenderingTechnique::SHADOW, args,
+											work.m_renderQueue->m_renderables.getBegin()
+												+ work.m_firstRenderableElement,
+											work.m_renderQueue->m_renderables.getBegin() + cpuEnd, cmdb);
+		}
+
+		if(end > renderableCount)
+		{
+			m_r->getSceneDrawer().drawGpuScene(RenderingTechnique::SHADOW, args,
+											   m_scratch.m_gpuVisibility[work.m_gpuVisibilityIdx], cmdb);
+		}
+	}
+}
+
+void ShadowMapping::runStaticCache(const StaticCache::WorkItem& work, RenderPassWorkContext& rgraphCtx)
+{
+	ANKI_TRACE_SCOPED_EVENT(R_SM);
+
+	CommandBufferPtr& cmdb = rgraphCtx.m_commandBuffer;
+
+	U32 start, end;
+	splitThreadedProblem(rgraphCtx.m_currentSecondLevelCommandBufferIndex, rgraphCtx.m_secondLevelCommandBufferCount,
+						 work.m_renderQueue->m_staticShadowRenderableCount, start, end);
+	if(start == end)
+	{
+		return;
 	}
+
+	cmdb->setViewport(work.m_viewport[0], work.m_viewport[1], work.m_viewport[2], work.m_viewport[3]);
+	cmdb->setScissor(work.m_viewport[0], work.m_viewport[1], work.m_viewport[2], work.m_viewport[3]);
+
+	// Everything the light sees is drawn so don't use the GPU visibility
+	RenderableDrawerArguments args;
+	args.m_viewMatrix = work.m_renderQueue->m_viewMatrix;
+	args.m_cameraTransform = Mat3x4::getIdentity(); // Don't care
+	args.m_viewProjectionMatrix = work.m_renderQueue->m_viewProjectionMatrix;
+	args.m_previousViewProjectionMatrix = Mat4::getIdentity(); // Don't care
+	args.m_sampler = m_r->getSamplers().m_trilinearRepeatAniso;
+	args.m_minLod = args.m_maxLod = work.m_renderQueueElementsLod;
+
+	m_r->getSceneDrawer().drawRange(RenderingTechnique::SHADOW, args,
+									work.m_renderQueue->m_renderables.getBegin() + start,
+									work.m_renderQueue->m_renderables.getBegin() + end, cmdb);
 }
 
 void ShadowMapping::populateRenderGraph(RenderingContext& ctx)
@@ -247,9 +366,51 @@ void ShadowMapping::populateRenderGraph(RenderingContext& ctx)
 
 	// Build the render graph
 	RenderGraphDescription& rgraph = ctx.m_renderGraphDescr;
+
+	if(ANKI_LIKELY(m_atlas.m_rtImportedOnce))
+	{
+		m_atlas.m_rt = rgraph.importRenderTarget(m_atlas.m_tex);
+	}
+	else
+	{
+		m_atlas.m_rt = rgraph.importRenderTarget(m_atlas.m_tex, TextureUsageBit::SAMPLED_FRAGMENT);
+		m_atlas.m_rtImportedOnce = true;
+	}
+
+	if(m_atlas.m_resolveWorkItems.getSize() == 0)
+	{
+		// No need for shadowmapping passes
+		return;
+	}
+
+	// Will have to create render passes
+
 	if(m_scratch.m_workItems.getSize())
 	{
-		// Will have to create render passes
+		// Let the GPU cull the GPU scene casters of the lights. Only one work item of a light draws them
+		DynamicArrayAuto<GpuVisibilityInput> inputs(ctx.m_tempAllocator);
+		for(Scratch::WorkItem& work : m_scratch.m_workItems)
+		{
+			if(work.m_firstRenderableElement + work.m_renderableElementCount
+			   > work.m_renderQueue->m_renderables.getSize())
+			{
+				work.m_gpuVisibilityIdx = inputs.getSize();
+
+				GpuVisibilityInput& in = *inputs.emplaceBack();
+				in.m_viewProjectionMatrix = work.m_renderQueue->m_viewProjectionMatrix;
+				in.m_technique = RenderingTechnique::SHADOW;
+				in.m_minLod = in.m_maxLod = work.m_renderQueueElementsLod;
+			}
+		}
+
+		m_scratch.m_gpuVisibility.resize(getAllocator(), inputs.getSize());
+		if(inputs.getSize())
+		{
+			ANKI_ASSERT(m_r->getGpuVisibility().getEnabled() && ctx.m_renderQueue->m_gpuScene.m_drawGroups.getSize());
+			m_r->getGpuVisibility().populateRenderGraph(
+				"SM visibility", inputs, ctx,
+				WeakArray<GpuVisibilityOutput>(m_scratch.m_gpuVisibility.getBegin(), inputs.getSize()));
+		}
 
 		// Scratch pass
 		{
@@ -270,60 +431,87 @@ void ShadowMapping::populateRenderGraph(RenderingContext& ctx)
 
 			TextureSubresourceInfo subresource = TextureSubresourceInfo(DepthStencilAspectBit::DEPTH);
 			pass.newDependency({m_scratch.m_rt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT, subresource});
-		}
+			pass.newDependency({m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ});
 
-		// Atlas pass
-		{
-			if(ANKI_LIKELY(m_atlas.m_rtImportedOnce))
+			if(m_scratch.m_gpuVisibility.getSize())
 			{
-				m_atlas.m_rt = rgraph.importRenderTarget(m_atlas.m_tex);
-			}
-			else
-			{
-				m_atlas.m_rt = rgraph.importRenderTarget(m_atlas.m_tex, TextureUsageBit::SAMPLED_FRAGMENT);
-				m_atlas.m_rtImportedOnce = true;
+				// All the lights share the same buffer
+				pass.newDependency({m_scratch.m_gpuVisibility[0].m_bufferHandle,
+									BufferUsageBit::INDIRECT_DRAW | BufferUsageBit::STORAGE_GEOMETRY_READ});
 			}
+		}
+	}
 
-			if(getConfig().getRPreferCompute())
-			{
-				ComputeRenderPassDescription& pass = rgraph.newComputeRenderPass("EVSM resolve");
+	// Static cache passes. One per tile because each one clears its tile
+	if(m_staticCache.m_sampledThisFrame)
+	{
+		if(ANKI_LIKELY(m_staticCache.m_rtImportedOnce))
+		{
+			m_staticCache.m_rt = rgraph.importRenderTarget(m_staticCache.m_tex);
+		}
+		else
+		{
+			m_staticCache.m_rt = rgraph.importRenderTarget(m_staticCache.m_tex, TextureUsageBit::SAMPLED_FRAGMENT);
+			m_staticCache.m_rtImportedOnce = true;
+		}
 
-				pass.setWork([this](RenderPassWorkContext& rgraphCtx) {
-					runAtlas(rgraphCtx);
-				});
+		for(U32 i = 0; i < m_staticCache.m_workItems.getSize(); ++i)
+		{
+			const StaticCache::WorkItem& work = m_staticCache.m_workItems[i];
 
-				pass.newDependency(RenderPassDependency(m_scratch.m_rt, TextureUsageBit::SAMPLED_COMPUTE,
-														TextureSubresourceInfo(DepthStencilAspectBit::DEPTH)));
-				pass.newDependency(RenderPassDependency(m_atlas.m_rt, TextureUsageBit::IMAGE_COMPUTE_WRITE));
-			}
-			else
-			{
-				GraphicsRenderPassDescription& pass = rgraph.newGraphicsRenderPass("EVSM resolve");
-				pass.setFramebufferInfo(m_atlas.m_fbDescr, {m_atlas.m_rt});
-
-				pass.setWork([this](RenderPassWorkContext& rgraphCtx) {
-					runAtlas(rgraphCtx);
-				});
-
-				pass.newDependency(RenderPassDependency(m_scratch.m_rt, TextureUsageBit::SAMPLED_FRAGMENT,
-														TextureSubresourceInfo(DepthStencilAspectBit::DEPTH)));
-				pass.newDependency(
-					RenderPassDependency(m_atlas.m_rt, TextureUsageBit::FRAMEBUFFER_ATTACHMENT_READ
-														   | TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE));
-			}
+			GraphicsRenderPassDescription& pass = rgraph.newGraphicsRenderPass("SM static cache");
+			pass.setFramebufferInfo(m_staticCache.m_fbDescr, {}, m_staticCache.m_rt, {}, work.m_viewport[0],
+									work.m_viewport[1], work.m_viewport[2], work.m_viewport[3]);
+
+			const U32 threadCount =
+				computeNumberOfSecondLevelCommandBuffers(work.m_renderQueue->m_staticShadowRenderableCount);
+			pass.setWork(threadCount, [this, i](RenderPassWorkContext& rgraphCtx) {
+				runStaticCache(m_staticCache.m_workItems[i], rgraphCtx);
+			});
+
+			pass.newDependency({m_staticCache.m_rt, TextureUsageBit::ALL_FRAMEBUFFER_ATTACHMENT,
+								TextureSubresourceInfo(DepthStencilAspectBit::DEPTH)});
+			pass.newDependency({m_r->getGpuSceneUpdate().getBufferHandle(), BufferUsageBit::STORAGE_GEOMETRY_READ});
 		}
 	}
-	else
+
+	// Atlas pass
 	{
-		// No need for shadowmapping passes, just import the atlas
-		if(ANKI_LIKELY(m_atlas.m_rtImportedOnce))
+		const Bool preferCompute = getConfig().getRPreferCompute();
+		const TextureUsageBit sampledUsage =
+			(preferCompute) ? TextureUsageBit::SAMPLED_COMPUTE : TextureUsageBit::SAMPLED_FRAGMENT;
+
+		RenderPassDescriptionBase* pass;
+		if(preferCompute)
 		{
-			m_atlas.m_rt = rgraph.importRenderTarget(m_atlas.m_tex);
+			ComputeRenderPassDescription& cpass = rgraph.newComputeRenderPass("EVSM resolve");
+			cpass.newDependency(RenderPassDependency(m_atlas.m_rt, TextureUsageBit::IMAGE_COMPUTE_WRITE));
+			pass = &cpass;
 		}
 		else
 		{
-			m_atlas.m_rt = rgraph.importRenderTarget(m_atlas.m_tex, TextureUsageBit::SAMPLED_FRAGMENT);
-			m_atlas.m_rtImportedOnce = true;
+			GraphicsRenderPassDescription& gpass = rgraph.newGraphicsRenderPass("EVSM resolve");
+			gpass.setFramebufferInfo(m_atlas.m_fbDescr, {m_atlas.m_rt});
+			gpass.newDependency(
+				RenderPassDependency(m_atlas.m_rt, TextureUsageBit::FRAMEBUFFER_ATTACHMENT_READ
+													   | TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE));
+			pass = &gpass;
+		}
+
+		pass->setWork([this](RenderPassWorkContext& rgraphCtx) {
+			runAtlas(rgraphCtx);
+		});
+
+		if(m_scratch.m_workItems.getSize())
+		{
+			pass->newDependency(RenderPassDependency(m_scratch.m_rt, sampledUsage,
+													 TextureSubresourceInfo(DepthStencilAspectBit::DEPTH)));
+		}
+
+		if(m_staticCache.m_sampledThisFrame)
+		{
+			pass->newDependency(RenderPassDependency(m_staticCache.m_rt, sampledUsage,
+													 TextureSubresourceInfo(DepthStencilAspectBit::DEPTH)));
 		}
 	}
 }
@@ -401,11 +589,11 @@ void ShadowMapping::chooseLod(const Vec4& cameraOrigin, const SpotLightQueueElem
 	}
 }
 
-TileAllocatorResult ShadowMapping::allocateTilesAndScratchTiles(U64 lightUuid, U32 faceCount, const U64* faceTimestamps,
-																const U32* faceIndices, const U32* drawcallsCount,
-																const U32* lods, UVec4* atlasTileViewports,
-																UVec4* scratchTileViewports,
-																TileAllocatorResult* subResults)
+TileAllocatorResult ShadowMapping::allocateTilesAndScratchTiles(
+	U64 lightUuid, U32 faceCount, const U64* faceTimestamps, const U32* faceIndices, const U32* drawcallsCount,
+	const U32* lods, const U64* staticFaceTimestamps, const U32* staticDrawcallsCount, UVec4* atlasTileViewports,
+	UVec4* scratchTileViewports, UVec4* staticCacheTileViewports, TileAllocatorResult* subResults,
+	TileAllocatorResult* staticCacheSubResults)
 {
 	ANKI_ASSERT(lightUuid > 0);
 	ANKI_ASSERT(faceCount > 0);
@@ -443,6 +631,26 @@ TileAllocatorResult ShadowMapping::allocateTilesAndScratchTiles(U64 lightUuid, U
 		atlasTileViewports[i] = UVec4(tileRanges) * m_atlas.m_tileResolution;
 	}
 
+	// Allocate static cache tiles for the faces that need rendering. If that fails the static casters will be rendered
+	// in the scratch buffer like the rest
+	const Bool useStaticCache = m_staticCache.m_tex.isCreated() && staticFaceTimestamps;
+	for(U i = 0; i < faceCount && staticCacheSubResults; ++i)
+	{
+		staticCacheSubResults[i] = TileAllocatorResult::ALLOCATION_FAILED;
+		staticCacheTileViewports[i] = UVec4(0u);
+		if(!useStaticCache || subResults[i] == TileAllocatorResult::CACHED || staticDrawcallsCount[i] == 0)
+		{
+			continue;
+		}
+
+		Array<U32, 4> tileRanges;
+		staticCacheSubResults[i] =
+			m_staticCache.m_tileAlloc.allocate(m_r->getGlobalTimestamp(), staticFaceTimestamps[i], lightUuid,
+											   faceIndices[i], staticDrawcallsCount[i], lods[i], tileRanges);
+
+		staticCacheTileViewports[i] = UVec4(tileRanges) * m_atlas.m_tileResolution;
+	}
+
 	// Allocate scratch tiles
 	for(U i = 0; i < faceCount; ++i)
 	{
@@ -453,6 +661,15 @@ TileAllocatorResult ShadowMapping::allocateTilesAndScratchTiles(U64 lightUuid, U
 
 		ANKI_ASSERT(subResults[i] == TileAllocatorResult::ALLOCATION_SUCCEEDED);
 
+		if(staticCacheSubResults && staticCacheSubResults[i] != TileAllocatorResult::ALLOCATION_FAILED
+		   && staticDrawcallsCount[i] == drawcallsCount[i])
+		{
+			// Only static casters, the scratch won't be sampled. Use a viewport with the right size for the resolve
+			scratchTileViewports[i] = UVec4(0, 0, atlasTileViewports[i][2], atlasTileViewports[i][3]);
+			res = subResults[i];
+			continue;
+		}
+
 		Array<U32, 4> tileRanges;
 		res = m_scratch.m_tileAlloc.allocate(m_r->getGlobalTimestamp(), faceTimestamps[i], lightUuid, faceIndices[i],
 											 drawcallsCount[i], lods[i], tileRanges);
@@ -462,10 +679,15 @@ TileAllocatorResult ShadowMapping::allocateTilesAndScratchTiles(U64 lightUuid, U
 			ANKI_R_LOGW("Don't have enough space in the scratch shadow mapping buffer. "
 						"If you see this message too often increase r_shadowMappingScratchTileCountX/Y");
 
-			// Invalidate atlas tiles
+			// Invalidate atlas tiles and the static cache tiles that won't be rendered
 			for(U j = 0; j < faceCount; ++j)
 			{
 				m_atlas.m_tileAlloc.invalidateCache(lightUuid, faceIndices[j]);
+
+				if(useStaticCache)
+				{
+					m_staticCache.m_tileAlloc.invalidateCache(lightUuid, faceIndices[j]);
+				}
 			}
 
 			return res;
@@ -495,6 +717,8 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 	DynamicArrayAuto<Scratch::LightToRenderToScratchInfo> lightsToRender(ctx.m_tempAllocator);
 	U32 drawcallCount = 0;
 	DynamicArrayAuto<Atlas::ResolveWorkItem> atlasWorkItems(ctx.m_tempAllocator);
+	DynamicArrayAuto<StaticCache::WorkItem> staticCacheWorkItems(ctx.m_tempAllocator);
+	m_staticCache.m_sampledThisFrame = false;
 
 	// First thing, allocate an empty tile for empty faces of point lights
 	UVec4 emptyTileViewport;
@@ -519,7 +743,7 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 #endif
 	}
 
-	// Process the directional light first.
+	// Process the directional light first. Its cascades follow the camera so it doesn't use the static cache
 	if(ctx.m_renderQueue->m_directionalLight.m_shadowCascadeCount > 0)
 	{
 		DirectionalLightQueueElement& light = ctx.m_renderQueue->m_directionalLight;
@@ -539,7 +763,7 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		for(U32 cascade = 0; cascade < light.m_shadowCascadeCount; ++cascade)
 		{
 			ANKI_ASSERT(light.m_shadowRenderQueues[cascade]);
-			if(light.m_shadowRenderQueues[cascade]->m_renderables.getSize() > 0)
+			if(getShadowDrawcallCount(*light.m_shadowRenderQueues[cascade]) > 0)
 			{
 				// Cascade with drawcalls, will need tiles
 
@@ -559,8 +783,8 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		const Bool allocationFailed =
 			activeCascades == 0
 			|| allocateTilesAndScratchTiles(light.m_uuid, activeCascades, &timestamps[0], &cascadeIndices[0],
-											&drawcallCounts[0], &lods[0], &atlasViewports[0], &scratchViewports[0],
-											&subResults[0])
+											&drawcallCounts[0], &lods[0], nullptr, nullptr, &atlasViewports[0],
+											&scratchViewports[0], nullptr, &subResults[0], nullptr)
 				   == TileAllocatorResult::ALLOCATION_FAILED;
 
 		if(!allocationFailed)
@@ -569,7 +793,7 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 
 			for(U cascade = 0; cascade < light.m_shadowCascadeCount; ++cascade)
 			{
-				if(light.m_shadowRenderQueues[cascade]->m_renderables.getSize() > 0)
+				if(getShadowDrawcallCount(*light.m_shadowRenderQueues[cascade]) > 0)
 				{
 					// Cascade with drawcalls, push some work for it
 
@@ -579,9 +803,10 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 
 					// Push work
 					newScratchAndAtlasResloveRenderWorkItems(
-						atlasViewports[activeCascades], scratchViewports[activeCascades], blurAtlass[activeCascades],
+						atlasViewports[activeCascades], scratchViewports[activeCascades], UVec4(0u),
+						TileAllocatorResult::ALLOCATION_FAILED, blurAtlass[activeCascades],
 						light.m_shadowRenderQueues[cascade], renderQueueElementsLods[activeCascades], lightsToRender,
-						atlasWorkItems, drawcallCount);
+						staticCacheWorkItems, atlasWorkItems, drawcallCount);
 
 					++activeCascades;
 				}
@@ -618,6 +843,10 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		Array<UVec4, 6> scratchViewports;
 		Array<TileAllocatorResult, 6> subResults;
 		Array<U32, 6> lods;
+		Array<U64, 6> staticTimestamps;
+		Array<U32, 6> staticDrawcallCounts;
+		Array<UVec4, 6> staticCacheViewports;
+		Array<TileAllocatorResult, 6> staticCacheSubResults;
 		U32 numOfFacesThatHaveDrawcalls = 0;
 
 		Bool blurAtlas;
@@ -627,7 +856,7 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		for(U32 face = 0; face < 6; ++face)
 		{
 			ANKI_ASSERT(light.m_shadowRenderQueues[face]);
-			if(light.m_shadowRenderQueues[face]->m_renderables.getSize())
+			if(getShadowDrawcallCount(*light.m_shadowRenderQueues[face]))
 			{
 				// Has renderables, need to allocate tiles for it so add it to the arrays
 
@@ -635,7 +864,12 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 				timestamps[numOfFacesThatHaveDrawcalls] =
 					light.m_shadowRenderQueues[face]->m_shadowRenderablesLastUpdateTimestamp;
 
-				drawcallCounts[numOfFacesThatHaveDrawcalls] = light.m_shadowRenderQueues[face]->m_renderables.getSize();
+				drawcallCounts[numOfFacesThatHaveDrawcalls] = getShadowDrawcallCount(*light.m_shadowRenderQueues[face]);
+
+				staticTimestamps[numOfFacesThatHaveDrawcalls] =
+					light.m_shadowRenderQueues[face]->m_staticShadowRenderablesLastUpdateTimestamp;
+				staticDrawcallCounts[numOfFacesThatHaveDrawcalls] =
+					light.m_shadowRenderQueues[face]->m_staticShadowRenderableCount;
 
 				lods[numOfFacesThatHaveDrawcalls] = lod;
 
@@ -646,8 +880,9 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		const Bool allocationFailed =
 			numOfFacesThatHaveDrawcalls == 0
 			|| allocateTilesAndScratchTiles(light.m_uuid, numOfFacesThatHaveDrawcalls, &timestamps[0], &faceIndices[0],
-											&drawcallCounts[0], &lods[0], &atlasViewports[0], &scratchViewports[0],
-											&subResults[0])
+											&drawcallCounts[0], &lods[0], &staticTimestamps[0],
+											&staticDrawcallCounts[0], &atlasViewports[0], &scratchViewports[0],
+											&staticCacheViewports[0], &subResults[0], &staticCacheSubResults[0])
 				   == TileAllocatorResult::ALLOCATION_FAILED;
 
 		if(!allocationFailed)
@@ -663,7 +898,7 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 			numOfFacesThatHaveDrawcalls = 0;
 			for(U face = 0; face < 6; ++face)
 			{
-				if(light.m_shadowRenderQueues[face]->m_renderables.getSize())
+				if(getShadowDrawcallCount(*light.m_shadowRenderQueues[face]))
 				{
 					// Has drawcalls, asigned it to a tile
 
@@ -677,8 +912,10 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 					if(subResults[numOfFacesThatHaveDrawcalls] != TileAllocatorResult::CACHED)
 					{
 						newScratchAndAtlasResloveRenderWorkItems(
-							atlasViewport, scratchViewport, blurAtlas, light.m_shadowRenderQueues[face],
-							renderQueueElementsLod, lightsToRender, atlasWorkItems, drawcallCount);
+							atlasViewport, scratchViewport, staticCacheViewports[numOfFacesThatHaveDrawcalls],
+							staticCacheSubResults[numOfFacesThatHaveDrawcalls], blurAtlas,
+							light.m_shadowRenderQueues[face], renderQueueElementsLod, lightsToRender,
+							staticCacheWorkItems, atlasWorkItems, drawcallCount);
 					}
 
 					++numOfFacesThatHaveDrawcalls;
@@ -716,7 +953,9 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		TileAllocatorResult subResult = TileAllocatorResult::ALLOCATION_FAILED;
 		UVec4 atlasViewport;
 		UVec4 scratchViewport;
-		const U32 localDrawcallCount = light.m_shadowRenderQueue->m_renderables.getSize();
+		UVec4 staticCacheViewport(0u);
+		TileAllocatorResult staticCacheSubResult = TileAllocatorResult::ALLOCATION_FAILED;
+		const U32 localDrawcallCount = getShadowDrawcallCount(*light.m_shadowRenderQueue);
 
 		Bool blurAtlas;
 		U32 lod, renderQueueElementsLod;
@@ -726,7 +965,9 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 			localDrawcallCount == 0
 			|| allocateTilesAndScratchTiles(
 				   light.m_uuid, 1, &light.m_shadowRenderQueue->m_shadowRenderablesLastUpdateTimestamp, &faceIdx,
-				   &localDrawcallCount, &lod, &atlasViewport, &scratchViewport, &subResult)
+				   &localDrawcallCount, &lod, &light.m_shadowRenderQueue->m_staticShadowRenderablesLastUpdateTimestamp,
+				   &light.m_shadowRenderQueue->m_staticShadowRenderableCount, &atlasViewport, &scratchViewport,
+				   &staticCacheViewport, &subResult, &staticCacheSubResult)
 				   == TileAllocatorResult::ALLOCATION_FAILED;
 
 		if(!allocationFailed)
@@ -738,9 +979,10 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 
 			if(subResult != TileAllocatorResult::CACHED)
 			{
-				newScratchAndAtlasResloveRenderWorkItems(atlasViewport, scratchViewport, blurAtlas,
-														 light.m_shadowRenderQueue, renderQueueElementsLod,
-														 lightsToRender, atlasWorkItems, drawcallCount);
+				newScratchAndAtlasResloveRenderWorkItems(atlasViewport, scratchViewport, staticCacheViewport,
+														 staticCacheSubResult, blurAtlas, light.m_shadowRenderQueue,
+														 renderQueueElementsLod, lightsToRender, staticCacheWorkItems,
+														 atlasWorkItems, drawcallCount);
 			}
 		}
 		else
@@ -777,10 +1019,12 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 				Scratch::WorkItem workItem;
 				workItem.m_viewport = lightToRender->m_viewport;
 				workItem.m_renderQueue = lightToRender->m_renderQueue;
-				workItem.m_firstRenderableElement = lightToRender->m_drawcallCount - lightToRenderDrawcallCount;
+				workItem.m_firstRenderableElement = lightToRender->m_firstRenderableElement
+													+ lightToRender->m_drawcallCount - lightToRenderDrawcallCount;
 				workItem.m_renderableElementCount = workItemDrawcallCount;
 				workItem.m_threadPoolTaskIdx = taskId;
 				workItem.m_renderQueueElementsLod = lightToRender->m_renderQueueElementsLod;
+				workItem.m_gpuVisibilityIdx = MAX_U32; // Set when populating the render graph
 				workItems.emplaceBack(workItem);
 
 				// Decrease the drawcall counts for the task and the light
@@ -803,43 +1047,109 @@ void ShadowMapping::processLights(RenderingContext& ctx, U32& threadCountForScra
 		ANKI_ASSERT(lightsToRender.getSize() <= workItems.getSize());
 
 		// All good, store the work items for the threads to pick up
-		{
-			Scratch::WorkItem* items;
-			U32 itemSize;
-			U32 itemStorageSize;
-			workItems.moveAndReset(items, itemSize, itemStorageSize);
+		Scratch::WorkItem* items;
+		U32 itemSize;
+		U32 itemStorageSize;
+		workItems.moveAndReset(items, itemSize, itemStorageSize);
 
-			ANKI_ASSERT(items && itemSize && itemStorageSize);
-			m_scratch.m_workItems = WeakArray<Scratch::WorkItem>(items, itemSize);
-
-			Atlas::ResolveWorkItem* atlasItems;
-			atlasWorkItems.moveAndReset(atlasItems, itemSize, itemStorageSize);
-			ANKI_ASSERT(atlasItems && itemSize && itemStorageSize);
-			m_atlas.m_resolveWorkItems = WeakArray<Atlas::ResolveWorkItem>(atlasItems, itemSize);
-		}
+		ANKI_ASSERT(items && itemSize && itemStorageSize);
+		m_scratch.m_workItems = WeakArray<Scratch::WorkItem>(items, itemSize);
 	}
 	else
 	{
 		m_scratch.m_workItems = WeakArray<Scratch::WorkItem>();
+	}
+
+	// Store the rest of the work items. There may be lights that only need the static cache and not the scratch
+	if(atlasWorkItems.getSize())
+	{
+		Atlas::ResolveWorkItem* atlasItems;
+		U32 itemSize;
+		U32 itemStorageSize;
+		atlasWorkItems.moveAndReset(atlasItems, itemSize, itemStorageSize);
+		ANKI_ASSERT(atlasItems && itemSize && itemStorageSize);
+		m_atlas.m_resolveWorkItems = WeakArray<Atlas::ResolveWorkItem>(atlasItems, itemSize);
+	}
+	else
+	{
 		m_atlas.m_resolveWorkItems = WeakArray<Atlas::ResolveWorkItem>();
 	}
+
+	if(staticCacheWorkItems.getSize())
+	{
+		StaticCache::WorkItem* staticItems;
+		U32 itemSize;
+		U32 itemStorageSize;
+		staticCacheWorkItems.moveAndReset(staticItems, itemSize, itemStorageSize);
+		ANKI_ASSERT(staticItems && itemSize && itemStorageSize);
+		m_staticCache.m_workItems = WeakArray<StaticCache::WorkItem>(staticItems, itemSize);
+	}
+	else
+	{
+		m_staticCache.m_workItems = WeakArray<StaticCache::WorkItem>();
+	}
 }
 
 void ShadowMapping::newScratchAndAtlasResloveRenderWorkItems(
-	const UVec4& atlasViewport, const UVec4& scratchVewport, Bool blurAtlas, RenderQueue* lightRenderQueue,
-	U32 renderQueueElementsLod, DynamicArrayAuto<Scratch::LightToRenderToScratchInfo>& scratchWorkItem,
-	DynamicArrayAuto<Atlas::ResolveWorkItem>& atlasResolveWorkItem, U32& drawcallCount) const
+	const UVec4& atlasViewport, const UVec4& scratchVewport, const UVec4& staticCacheViewport,
+	TileAllocatorResult staticCacheResult, Bool blurAtlas, RenderQueue* lightRenderQueue, U32 renderQueueElementsLod,
+	DynamicArrayAuto<Scratch::LightToRenderToScratchInfo>& scratchWorkItem,
+	DynamicArrayAuto<StaticCache::WorkItem>& staticCacheWorkItems,
+	DynamicArrayAuto<Atlas::ResolveWorkItem>& atlasResolveWorkItem, U32& drawcallCount)
 {
-	// Scratch work item
+	const Bool useStaticCache = staticCacheResult != TileAllocatorResult::ALLOCATION_FAILED;
+	const U32 staticDrawcallCount = (useStaticCache) ? lightRenderQueue->m_staticShadowRenderableCount : 0;
+	const U32 dynamicDrawcallCount = getShadowDrawcallCount(*lightRenderQueue) - staticDrawcallCount;
+	U32 inputs = 0;
+
+	// Scratch work item. The static casters are skipped if they are in the static cache
+	if(dynamicDrawcallCount)
 	{
 		Scratch::LightToRenderToScratchInfo toRender;
 		toRender.m_renderQueue = lightRenderQueue;
 		toRender.m_viewport = scratchVewport;
-		toRender.m_drawcallCount = lightRenderQueue->m_renderables.getSize();
+		toRender.m_firstRenderableElement = staticDrawcallCount;
+		toRender.m_drawcallCount = dynamicDrawcallCount;
 		toRender.m_renderQueueElementsLod = renderQueueElementsLod;
 
 		scratchWorkItem.emplaceBack(toRender);
-		drawcallCount += lightRenderQueue->m_renderables.getSize();
+		drawcallCount += dynamicDrawcallCount;
+		inputs |= EVSM_INPUT_SCRATCH;
+	}
+
+	// Static cache work item
+	if(useStaticCache)
+	{
+		ANKI_ASSERT(staticDrawcallCount > 0);
+
+		if(staticCacheResult == TileAllocatorResult::ALLOCATION_SUCCEEDED)
+		{
+			StaticCache::WorkItem staticWork;
+			staticWork.m_viewport = staticCacheViewport;
+			staticWork.m_renderQueue = lightRenderQueue;
+			staticWork.m_renderQueueElementsLod = renderQueueElementsLod;
+			staticCacheWorkItems.emplaceBack(staticWork);
+		}
+
+		m_staticCache.m_sampledThisFrame = true;
+		inputs |= EVSM_INPUT_STATIC_CACHE;
+	}
+
+	ANKI_ASSERT(inputs);
+
+	// Static cache UV = scratch UV * scale + translation
+	const F32 scratchAtlasWidth = F32(m_scratch.m_tileCountX * m_scratch.m_tileResolution);
+	const F32 scratchAtlasHeight = F32(m_scratch.m_tileCountY * m_scratch.m_tileResolution);
+	Vec2 staticCacheUvScale(1.0f);
+	Vec2 staticCacheUvTranslation(0.0f);
+	if(useStaticCache)
+	{
+		ANKI_ASSERT(staticCacheViewport[2] == scratchVewport[2] && staticCacheViewport[3] == scratchVewport[3]);
+		const F32 staticCacheSize = F32(m_staticCache.m_tex->getWidth());
+		staticCacheUvScale = Vec2(scratchAtlasWidth, scratchAtlasHeight) / staticCacheSize;
+		staticCacheUvTranslation = (Vec2(F32(staticCacheViewport[0]), F32(staticCacheViewport[1]))
+									- Vec2(F32(scratchVewport[0]), F32(scratchVewport[1])))
+								   / staticCacheSize;
 	}
 
 	// Atlas resolve work items
@@ -849,9 +1159,6 @@ void ShadowMapping::newScratchAndAtlasResloveRenderWorkItems(
 	{
 		for(U32 y = 0; y < tilesY; ++y)
 		{
-			const F32 scratchAtlasWidth = F32(m_scratch.m_tileCountX * m_scratch.m_tileResolution);
-			const F32 scratchAtlasHeight = F32(m_scratch.m_tileCountY * m_scratch.m_tileResolution);
-
 			Atlas::ResolveWorkItem atlasItem;
 
 			atlasItem.m_uvInBounds[0] = F32(scratchVewport[0]) / scratchAtlasWidth;
@@ -869,6 +1176,9 @@ void ShadowMapping::newScratchAndAtlasResloveRenderWorkItems(
 			atlasItem.m_viewportOut[2] = atlasViewport[2] / tilesX;
 			atlasItem.m_viewportOut[3] = atlasViewport[3] / tilesY;
 
+			atlasItem.m_staticCacheUvScale = staticCacheUvScale;
+			atlasItem.m_staticCacheUvTranslation = staticCacheUvTranslation;
+			atlasItem.m_inputs = inputs;
 			atlasItem.m_blur = blurAtlas;
 
 			atlasResolveWorkItem.emplaceBack(atlasItem);
@@ -9,6 +9,7 @@
 #include <AnKi/Gr.h>
 #include <AnKi/Resource/ImageResource.h>
 #include <AnKi/Renderer/TileAllocator.h>
+#include <AnKi/Renderer/GpuVisibility.h>
 
 namespace anki {
 
@@ -91,6 +92,8 @@ private:
 		WeakArray<WorkItem> m_workItems;
 		U32 m_maxViewportWidth = 0;
 		U32 m_maxViewportHeight = 0;
+
+		DynamicArray<GpuVisibilityOutput> m_gpuVisibility; ///< One per light render queue with GPU scene casters.
 	} m_scratch;
 
 	Error initScratch();
@@ -98,6 +101,35 @@ private:
 	void runShadowMapping(RenderPassWorkContext& rgraphCtx);
 	/// @}
 
+	/// @name Static cache stuff
+	/// @{
+
+	/// Holds the depth of the static shadow casters of the point and spot lights. It's rendered only when the static
+	/// geometry changes and the dynamic casters are combined with it during the EVSM resolve.
+	class StaticCache
+	{
+	public:
+		class WorkItem;
+
+		TileAllocator m_tileAlloc;
+
+		TexturePtr m_tex; ///< Size (m_tileResolution*m_tileCountBothAxis)^2. Not created if the cache is disabled.
+		RenderTargetHandle m_rt;
+		Bool m_rtImportedOnce = false;
+
+		U32 m_tileCountBothAxis = 0;
+
+		FramebufferDescription m_fbDescr;
+
+		WeakArray<WorkItem> m_workItems; ///< One per tile to render.
+		Bool m_sampledThisFrame = false;
+	} m_staticCache;
+
+	Error initStaticCache();
+
+	void runStaticCache(const StaticCache::WorkItem& work, RenderPassWorkContext& rgraphCtx);
+	/// @}
+
 	/// @name Misc & common
 	/// @{
 
@@ -110,17 +142,28 @@ private:
 	void chooseLod(const Vec4& cameraOrigin, const SpotLightQueueElement& light, Bool& blurAtlas, U32& tileBufferLod,
 				   U32& renderQueueElementsLod) const;
 
-	/// Try to allocate a number of scratch tiles and regular tiles.
+	/// Try to allocate a number of scratch tiles and regular tiles. If the static info is present it will also try to
+	/// allocate static cache tiles for the faces that have static casters.
+	/// @param staticFaceTimestamps Optional.
+	/// @param staticDrawcallsCount Optional.
+	/// @param[out] staticCacheTileViewports Optional.
+	/// @param[out] staticCacheSubResults Optional. ALLOCATION_FAILED if the face doesn't use the static cache.
 	TileAllocatorResult allocateTilesAndScratchTiles(U64 lightUuid, U32 faceCount, const U64* faceTimestamps,
 													 const U32* faceIndices, const U32* drawcallsCount, const U32* lods,
+													 const U64* staticFaceTimestamps, const U32* staticDrawcallsCount,
 													 UVec4* atlasTileViewports, UVec4* scratchTileViewports,
-													 TileAllocatorResult* subResults);
+													 UVec4* staticCacheTileViewports,
+													 TileAllocatorResult* subResults,
+													 TileAllocatorResult* staticCacheSubResults);
 
-	/// Add new work to render to scratch buffer and atlas buffer.
+	/// Add new work to render to scratch buffer, static cache and atlas buffer.
+	/// @param staticCacheResult ALLOCATION_FAILED if the static cache is not used.
 	void newScratchAndAtlasResloveRenderWorkItems(
-		const UVec4& atlasViewport, const UVec4& scratchVewport, Bool blurAtlas, RenderQueue* lightRenderQueue,
+		const UVec4& atlasViewport, const UVec4& scratchVewport, const UVec4& staticCacheViewport,
+		TileAllocatorResult staticCacheResult, Bool blurAtlas, RenderQueue* lightRenderQueue,
 		U32 renderQueueElementsLod, DynamicArrayAuto<Scratch::LightToRenderToScratchInfo>& scratchWorkItem,
-		DynamicArrayAuto<Atlas::ResolveWorkItem>& atlasResolveWorkItem, U32& drawcallCount) const;
+		DynamicArrayAuto<StaticCache::WorkItem>& staticCacheWorkItems,
+		DynamicArrayAuto<Atlas::ResolveWorkItem>& atlasResolveWorkItem, U32& drawcallCount);
 
 	/// Iterate lights and create work items.
 	void processLights(RenderingContext& ctx, U32& threadCountForScratchPass);
@@ -30,8 +30,8 @@ Error ShadowmapsResolve::init()
 Error ShadowmapsResolve::initInternal()
 {
 	m_quarterRez = getConfig().getRSmResolveQuarterRez();
-	const U32 width = m_r->getInternalResolution().x() / (m_quarterRez + 1);
-	const U32 height = m_r->getInternalResolution().y() / (m_quarterRez + 1);
+	const U32 width = m_r->getMaxInternalResolution().x() / (m_quarterRez + 1);
+	const U32 height = m_r->getMaxInternalResolution().y() / (m_quarterRez + 1);
 
 	ANKI_R_LOGV("Initializing shadowmaps resolve. Resolution %ux%u", width, height);
 
@@ -48,10 +48,6 @@ Error ShadowmapsResolve::initInternal()
 													 : "ShaderBinaries/ShadowmapsResolveRaster.ankiprogbin",
 												 m_prog));
 	ShaderProgramResourceVariantInitInfo variantInitInfo(m_prog);
-	if(getConfig().getRPreferCompute())
-	{
-		variantInitInfo.addConstant("FB_SIZE", UVec2(width, height));
-	}
 	variantInitInfo.addConstant("TILE_COUNTS", m_r->getTileCounts());
 	variantInitInfo.addConstant("Z_SPLIT_COUNT", m_r->getZSplitCount());
 	variantInitInfo.addConstant("TILE_SIZE", m_r->getTileSize());
@@ -88,7 +84,8 @@ void ShadowmapsResolve::populateRenderGraph(RenderingContext& ctx)
 	else
 	{
 		GraphicsRenderPassDescription& rpass = rgraph.newGraphicsRenderPass("SM resolve");
-		rpass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_rt});
+		const UVec2 viewportSize = m_r->getInternalResolution() / (m_quarterRez + 1);
+		rpass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_rt}, {}, {}, 0, 0, viewportSize.x(), viewportSize.y());
 
 		rpass.setWork([this, &ctx](RenderPassWorkContext& rgraphCtx) {
 			run(ctx, rgraphCtx);
@@ -131,14 +128,28 @@ void ShadowmapsResolve::run(const RenderingContext& ctx, RenderPassWorkContext&
 							  TextureSubresourceInfo(DepthStencilAspectBit::DEPTH));
 	}
 
+	// The HiZ covers the whole viewport, the depth buffer doesn't
+	const UVec2 viewportSize = m_r->getInternalResolution() / (m_quarterRez + 1);
+	class
+	{
+	public:
+		Vec4 m_depthUvScaleAndMax;
+
+		UVec2 m_viewportSize;
+		UVec2 m_padding0;
+	} pc;
+	pc.m_depthUvScaleAndMax = (m_quarterRez) ? Vec4(1.0f) : m_r->getInternalResolutionUvScaleAndMax();
+	pc.m_viewportSize = viewportSize;
+	cmdb->setPushConstants(&pc, sizeof(pc));
+
 	if(getConfig().getRPreferCompute())
 	{
 		rgraphCtx.bindImage(0, 7, m_runCtx.m_rt, TextureSubresourceInfo());
-		dispatchPPCompute(cmdb, 8, 8, m_rtDescr.m_width, m_rtDescr.m_height);
+		dispatchPPCompute(cmdb, 8, 8, viewportSize.x(), viewportSize.y());
 	}
 	else
 	{
-		cmdb->setViewport(0, 0, m_rtDescr.m_width, m_rtDescr.m_height);
+		cmdb->setViewport(0, 0, viewportSize.x(), viewportSize.y());
 		cmdb->drawArrays(PrimitiveTopology::TRIANGLES, 3);
 	}
 }
@@ -42,6 +42,12 @@ public:
 		return m_runCtx.m_rt;
 	}
 
+	/// The RT is of the internal resolution divided by that factor.
+	U32 getRtDownscale() const
+	{
+		return m_quarterRez + 1;
+	}
+
 public:
 	ShaderProgramResourcePtr m_prog;
 	ShaderProgramPtr m_grProg;
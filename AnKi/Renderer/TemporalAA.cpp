@@ -49,12 +49,6 @@ Error TemporalAA::initInternal()
 		variantInitInfo.addMutation("VARIANCE_CLIPPING", 1);
 		variantInitInfo.addMutation("YCBCR", 0);
 
-		if(getConfig().getRPreferCompute())
-		{
-			variantInitInfo.addConstant("FB_SIZE",
-										UVec2(m_r->getInternalResolution().x(), m_r->getInternalResolution().y()));
-		}
-
 		const ShaderProgramResourceVariant* variant;
 		m_prog->getOrCreateVariant(variantInitInfo, variant);
 		m_grProg = variant->getProgram();
@@ -67,14 +61,14 @@ Error TemporalAA::initInternal()
 												   : TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE;
 
 		TextureInitInfo texinit =
-			m_r->create2DRenderTargetInitInfo(m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
+			m_r->create2DRenderTargetInitInfo(m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y(),
 											  m_r->getHdrFormat(), usage, "TemporalAA");
 
 		m_rtTextures[i] = m_r->createAndClearRenderTarget(texinit, TextureUsageBit::SAMPLED_FRAGMENT);
 	}
 
 	m_tonemappedRtDescr = m_r->create2DRenderTargetDescription(
-		m_r->getInternalResolution().x(), m_r->getInternalResolution().y(),
+		m_r->getMaxInternalResolution().x(), m_r->getMaxInternalResolution().y(),
 		(getGrManager().getDeviceCapabilities().m_unalignedBbpTextureFormats) ? Format::R8G8B8_UNORM
 																			  : Format::R8G8B8A8_UNORM,
 		"TemporalAA Tonemapped");
@@ -125,7 +119,8 @@ void TemporalAA::populateRenderGraph(RenderingContext& ctx)
 	else
 	{
 		GraphicsRenderPassDescription& pass = rgraph.newGraphicsRenderPass("TemporalAA");
-		pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_renderRt, m_runCtx.m_tonemappedRt});
+		pass.setFramebufferInfo(m_fbDescr, {m_runCtx.m_renderRt, m_runCtx.m_tonemappedRt}, {}, {}, 0, 0,
+								m_r->getInternalResolution().x(), m_r->getInternalResolution().y());
 
 		pass.newDependency(RenderPassDependency(m_runCtx.m_renderRt, TextureUsageBit::FRAMEBUFFER_ATTACHMENT_WRITE));
 		pass.newDependency(
@@ -155,6 +150,19 @@ void TemporalAA::populateRenderGraph(RenderingContext& ctx)
 		rgraphCtx.bindColorTexture(0, 4, m_r->getMotionVectors().getMotionVectorsRt());
 		rgraphCtx.bindImage(0, 5, m_r->getTonemapping().getRt());
 
+		class
+		{
+		public:
+			Vec4 m_uvScaleAndMax;
+			Vec4 m_prevUvScaleAndMax;
+			UVec2 m_viewportSize;
+			UVec2 m_padding0;
+		} pc;
+		pc.m_uvScaleAndMax = m_r->getInternalResolutionUvScaleAndMax();
+		pc.m_prevUvScaleAndMax = m_r->getPreviousInternalResolutionUvScaleAndMax();
+		pc.m_viewportSize = m_r->getInternalResolution();
+		cmdb->setPushConstants(&pc, sizeof(pc));
+
 		if(getConfig().getRPreferCompute())
 		{
 			rgraphCtx.bindImage(0, 6, m_runCtx.m_renderRt, TextureSubresourceInfo());
@@ -10,7 +10,6 @@
 namespace anki {
 
 AsyncLoader::AsyncLoader()
-	: m_thread("anki_asyload")
 {
 }
 
@@ -18,23 +17,35 @@ AsyncLoader::~AsyncLoader()
 {
 	stop();
 
-	if(!m_taskQueue.isEmpty())
+	Bool warned = false;
+	for(IntrusiveList<AsyncLoaderTask>& queue : m_taskQueues)
 	{
-		ANKI_RESOURCE_LOGW("Stoping loading thread while there is work to do");
+		if(!queue.isEmpty() && !warned)
+		{
+			ANKI_RESOURCE_LOGW("Stoping loading threads while there is work to do");
+			warned = true;
+		}
 
-		while(!m_taskQueue.isEmpty())
+		while(!queue.isEmpty())
 		{
-			AsyncLoaderTask* task = &m_taskQueue.getFront();
-			m_taskQueue.popFront();
+			AsyncLoaderTask* task = &queue.getFront();
+			queue.popFront();
 			m_alloc.deleteInstance(task);
 		}
 	}
 }
 
-void AsyncLoader::init(const HeapAllocator<U8>& alloc)
+void AsyncLoader::init(const HeapAllocator<U8>& alloc, U32 threadCount)
 {
+	ANKI_ASSERT(threadCount > 0);
 	m_alloc = alloc;
-	m_thread.start(this, threadCallback);
+
+	m_threads.create(m_alloc, threadCount);
+	for(U32 i = 0; i < threadCount; ++i)
+	{
+		m_threads[i] = m_alloc.newInstance<Thread>("anki_asyload");
+		m_threads[i]->start(this, threadCallback);
+	}
 }
 
 void AsyncLoader::stop()
@@ -42,29 +53,34 @@ void AsyncLoader::stop()
 	{
 		LockGuard<Mutex> lock(m_mtx);
 		m_quit = true;
-		m_condVar.notifyOne();
+		m_condVar.notifyAll();
 	}
 
-	[[maybe_unused]] Error err = m_thread.join();
+	for(Thread* thread : m_threads)
+	{
+		[[maybe_unused]] Error err = thread->join();
+		m_alloc.deleteInstance(thread);
+	}
+
+	m_threads.destroy(m_alloc);
 }
 
 void AsyncLoader::pause()
 {
+	LockGuard<Mutex> lock(m_mtx);
+	m_paused = true;
+
+	while(m_runningTaskCount > 0)
 	{
-		LockGuard<Mutex> lock(m_mtx);
-		m_paused = true;
-		m_sync = true;
-		m_condVar.notifyOne();
+		m_idleCondVar.wait(m_mtx);
 	}
-
-	m_barrier.wait();
 }
 
 void AsyncLoader::resume()
 {
 	LockGuard<Mutex> lock(m_mtx);
 	m_paused = false;
-	m_condVar.notifyOne();
+	m_condVar.notifyAll();
 }
 
 Error AsyncLoader::threadCallback(ThreadCallbackInfo& info)
@@ -73,6 +89,21 @@ Error AsyncLoader::threadCallback(ThreadCallbackInfo& info)
 	return self.threadWorker();
 }
 
+AsyncLoaderTask* AsyncLoader::popTask()
+{
+	for(IntrusiveList<AsyncLoaderTask>& queue : m_taskQueues)
+	{
+		if(!queue.isEmpty())
+		{
+			AsyncLoaderTask* task = &queue.getFront();
+			queue.popFront();
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
 Error AsyncLoader::threadWorker()
 {
 	Error err = Error::NONE;
@@ -80,50 +111,39 @@ Error AsyncLoader::threadWorker()
 	while(!err)
 	{
 		AsyncLoaderTask* task = nullptr;
-		Bool quit = false;
-		Bool sync = false;
 
 		{
 			// Wait for something
 			LockGuard<Mutex> lock(m_mtx);
-			while((m_taskQueue.isEmpty() || m_paused) && !m_quit && !m_sync)
+			while(!m_quit && (m_paused || (task = popTask()) == nullptr))
 			{
 				m_condVar.wait(m_mtx);
 			}
 
-			// Do some work
 			if(m_quit)
 			{
-				quit = true;
-			}
-			else if(m_sync)
-			{
-				sync = true;
-				m_sync = false;
-			}
-			else
-			{
-				task = &m_taskQueue.getFront();
-				m_taskQueue.popFront();
+				break;
 			}
-		}
 
-		if(quit)
-		{
-			break;
+			++m_runningTaskCount;
 		}
-		else if(sync)
+
+		ANKI_ASSERT(task);
+		AsyncLoaderTaskContext ctx;
+
+		if(task->isCancelled())
 		{
-			m_barrier.wait();
+			m_cancelledTaskCount.fetchAdd(1);
 		}
 		else
 		{
 			// Exec the task
-			ANKI_ASSERT(task);
-			AsyncLoaderTaskContext ctx;
-
 			{
-				ANKI_TRACE_SCOPED_EVENT(RSRC_ASYNC_TASK);
+#if ANKI_ENABLE_TRACE
+				static constexpr Array<const char*, U32(AsyncLoaderPriority::COUNT)> EVENT_NAMES = {
+					"RSRC_ASYNC_TASK_HIGH", "RSRC_ASYNC_TASK_MEDIUM", "RSRC_ASYNC_TASK_LOW"};
+				TracerScopedEvent traceEvent(EVENT_NAMES[task->m_priority]);
+#endif
 				err = (*task)(ctx);
 			}
 
@@ -135,41 +155,50 @@ Error AsyncLoader::threadWorker()
 			{
 				ANKI_RESOURCE_LOGE("Async loader task failed");
 			}
+		}
 
-			// Do other stuff
-			if(ctx.m_resubmitTask)
-			{
-				LockGuard<Mutex> lock(m_mtx);
-				m_taskQueue.pushBack(task);
-			}
-			else
-			{
-				// Delete the task
-				m_alloc.deleteInstance(task);
-			}
+		// Do other stuff
+		LockGuard<Mutex> lock(m_mtx);
 
-			if(ctx.m_pause)
-			{
-				LockGuard<Mutex> lock(m_mtx);
-				m_paused = true;
-			}
+		if(ctx.m_resubmitTask && !task->isCancelled())
+		{
+			m_taskQueues[task->m_priority].pushBack(task);
+			m_condVar.notifyOne();
+		}
+		else
+		{
+			// Delete the task
+			m_alloc.deleteInstance(task);
+		}
+
+		if(ctx.m_pause)
+		{
+			m_paused = true;
+		}
+
+		ANKI_ASSERT(m_runningTaskCount > 0);
+		--m_runningTaskCount;
+		if(m_runningTaskCount == 0)
+		{
+			m_idleCondVar.notifyAll();
 		}
 	}
 
 	return err;
 }
 
-void AsyncLoader::submitTask(AsyncLoaderTask* task)
+void AsyncLoader::submitTask(AsyncLoaderTask* task, AsyncLoaderPriority priority)
 {
 	ANKI_ASSERT(task);
+	task->m_priority = priority;
 
 	// Append task to the list
 	LockGuard<Mutex> lock(m_mtx);
-	m_taskQueue.pushBack(task);
+	m_taskQueues[priority].pushBack(task);
 
 	if(!m_paused)
 	{
-		// Wake up the thread if it's not paused
+		// Wake up a thread if it's not paused
 		m_condVar.notifyOne();
 	}
 }
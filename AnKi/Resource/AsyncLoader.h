@@ -8,6 +8,7 @@
 #include <AnKi/Resource/Common.h>
 #include <AnKi/Util/Thread.h>
 #include <AnKi/Util/List.h>
+#include <AnKi/Util/DynamicArray.h>
 
 namespace anki {
 
@@ -17,6 +18,18 @@ class AsyncLoader;
 /// @addtogroup resource
 /// @{
 
+/// The priority of an AsyncLoaderTask. Tasks of higher priority are always picked first.
+enum class AsyncLoaderPriority : U8
+{
+	HIGH, ///< Needed right now. For example it's visible.
+	MEDIUM, ///< Will be needed soon. For example prefetching.
+	LOW, ///< Background work.
+
+	COUNT,
+	FIRST = 0
+};
+ANKI_ENUM_ALLOW_NUMERIC_OPERATIONS(AsyncLoaderPriority)
+
 class AsyncLoaderTaskContext
 {
 public:
@@ -30,15 +43,39 @@ public:
 /// Interface for tasks for the AsyncLoader.
 class AsyncLoaderTask : public IntrusiveListEnabled<AsyncLoaderTask>
 {
+	friend class AsyncLoader;
+
 public:
 	virtual ~AsyncLoaderTask()
 	{
 	}
 
 	virtual Error operator()(AsyncLoaderTaskContext& ctx) = 0;
+
+	/// Cancel the task. If it hasn't started it will be deleted without running. Thread-safe.
+	void cancel()
+	{
+		m_cancelled.store(true);
+	}
+
+	/// If it returns true the task will be deleted without running. Override it to cancel tasks whose work is no
+	/// longer needed (for example the resource was dropped).
+	virtual Bool isCancelled() const
+	{
+		return m_cancelled.load();
+	}
+
+	AsyncLoaderPriority getPriority() const
+	{
+		return m_priority;
+	}
+
+private:
+	Atomic<Bool> m_cancelled = {false};
+	AsyncLoaderPriority m_priority = AsyncLoaderPriority::MEDIUM;
 };
 
-/// Asynchronous resource loader.
+/// Asynchronous resource loader. It runs the tasks in a number of worker threads.
 class AsyncLoader
 {
 public:
@@ -46,10 +83,10 @@ public:
 
 	~AsyncLoader();
 
-	void init(const HeapAllocator<U8>& alloc);
+	void init(const HeapAllocator<U8>& alloc, U32 threadCount = 1);
 
 	/// Submit a task.
-	void submitTask(AsyncLoaderTask* task);
+	void submitTask(AsyncLoaderTask* task, AsyncLoaderPriority priority = AsyncLoaderPriority::MEDIUM);
 
 	/// Create a new asynchronous loading task.
 	template<typename TTask, typename... TArgs>
@@ -65,8 +102,8 @@ public:
 		submitTask(newTask<TTask>(std::forward<TArgs>(args)...));
 	}
 
-	/// Pause the loader. This method will block the caller for the current async task to finish. The rest of the
-	/// tasks in the queue will not be executed until resume is called.
+	/// Pause the loader. This method will block the caller until the tasks that are currently running finish. The
+	/// rest of the tasks in the queues will not be executed until resume is called.
 	void pause();
 
 	/// Resume the async loading.
@@ -83,25 +120,40 @@ public:
 		return m_completedTaskCount.load();
 	}
 
+	/// Get the total number of tasks that got cancelled before running.
+	U64 getCancelledTaskCount() const
+	{
+		return m_cancelledTaskCount.load();
+	}
+
+	U32 getThreadCount() const
+	{
+		return m_threads.getSize();
+	}
+
 private:
 	HeapAllocator<U8> m_alloc;
-	Thread m_thread;
-	Barrier m_barrier = {2};
+	DynamicArray<Thread*> m_threads;
 
 	Mutex m_mtx;
-	ConditionVariable m_condVar;
-	IntrusiveList<AsyncLoaderTask> m_taskQueue;
+	ConditionVariable m_condVar; ///< Wakes up the workers.
+	ConditionVariable m_idleCondVar; ///< Signaled when the last running task finishes.
+	Array<IntrusiveList<AsyncLoaderTask>, U32(AsyncLoaderPriority::COUNT)> m_taskQueues;
+	U32 m_runningTaskCount = 0;
 	Bool m_quit = false;
 	Bool m_paused = false;
-	Bool m_sync = false;
 
 	Atomic<U64> m_completedTaskCount = {0};
+	Atomic<U64> m_cancelledTaskCount = {0};
 
 	/// Thread callback
 	static Error threadCallback(ThreadCallbackInfo& info);
 
 	Error threadWorker();
 
+	/// Pop the task with the highest priority. Needs to be called with m_mtx locked.
+	AsyncLoaderTask* popTask();
+
 	void stop();
 };
 /// @}
@@ -14,4 +14,12 @@ ANKI_CONFIG_VAR_STRING(RsrcDataPathExcludedStrings, "AndroidProject",
 					   "A list of string separated by : that will be used to exclude paths from rsrc_dataPaths")
 ANKI_CONFIG_VAR_PTR_SIZE(RsrcTransferScratchMemorySize, 256_MB, 1_MB, 4_GB,
 						 "Memory that is used fot texture and buffer uploads")
+ANKI_CONFIG_VAR_U32(RsrcAsyncLoaderThreadCount, 2u, 1u, 16u, "The number of threads of the async resource loader")
+ANKI_CONFIG_VAR_BOOL(RsrcTextureStreaming, false,
+					 "Stream the mips of big textures depending on how big they appear on the screen")
+ANKI_CONFIG_VAR_U32(RsrcTextureStreamingMinSize, 128u, 64u, 4096u,
+					"Streamed textures will initially load and never evict the mips bellow that size")
+ANKI_CONFIG_VAR_PTR_SIZE(RsrcTextureStreamingBudget, 1_GB, 32_MB, 64_GB, "The GPU memory budget of streamed textures")
+ANKI_CONFIG_VAR_BOOL(RsrcMemoryMapFiles, true,
+					 "Memory map the loose resource files instead of reading them. Avoids copies while loading")
 ANKI_CONFIG_VAR_BOOL(RsrcForceFullFpPrecision, false, "Force full floating point precision")
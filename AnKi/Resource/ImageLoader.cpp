@@ -189,6 +189,17 @@ public:
 		ANKI_ASSERT(!"Not Implemented");
 		return MAX_PTR_SIZE;
 	}
+
+	virtual Bool isInMemory() const
+	{
+		return false;
+	}
+
+	virtual Error readInPlace([[maybe_unused]] PtrSize size, [[maybe_unused]] ConstWeakArray<U8, PtrSize>& out)
+	{
+		ANKI_ASSERT(!"Not Implemented");
+		return Error::FUNCTION_FAILED;
+	}
 };
 
 class ImageLoader::RsrcFile : public FileInterface
@@ -210,6 +221,16 @@ public:
 	{
 		return m_rfile->getSize();
 	}
+
+	Bool isInMemory() const final
+	{
+		return m_rfile->getContents().getSize() > 0;
+	}
+
+	Error readInPlace(PtrSize size, ConstWeakArray<U8, PtrSize>& out) final
+	{
+		return m_rfile->readInPlace(size, out);
+	}
 };
 
 class ImageLoader::SystemFile : public FileInterface
@@ -388,12 +409,12 @@ Error ImageLoader::loadTga(FileInterface& fs, U32& width, U32& height, U32& bpp,
 	return Error::NONE;
 }
 
-Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
+Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize, U32 minImageSize,
 								 ImageBinaryDataCompression& preferredCompression,
 								 DynamicArray<ImageLoaderSurface>& surfaces, DynamicArray<ImageLoaderVolume>& volumes,
-								 GenericMemoryPoolAllocator<U8>& alloc, U32& width, U32& height, U32& depth,
-								 U32& layerCount, U32& mipCount, ImageBinaryType& imageType,
-								 ImageBinaryColorFormat& colorFormat, UVec2& astcBlockSize)
+								 GenericMemoryPoolAllocator<U8>& alloc, U32& width, U32& height, U32& fullWidth,
+								 U32& fullHeight, U32& depth, U32& layerCount, U32& mipCount,
+								 ImageBinaryType& imageType, ImageBinaryColorFormat& colorFormat, UVec2& astcBlockSize)
 {
 	//
 	// Read and check the header
@@ -462,6 +483,8 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 
 	// Set a few things
 	colorFormat = header.m_colorFormat;
+	fullWidth = header.m_width;
+	fullHeight = header.m_height;
 	imageType = header.m_type;
 	astcBlockSize = UVec2(header.m_astcBlockSizeX, header.m_astcBlockSizeY);
 
@@ -551,6 +574,7 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 	//
 
 	// Allocate the surfaces
+	ANKI_ASSERT(minImageSize < maxImageSize);
 	mipCount = 0;
 	if(header.m_type != ImageBinaryType::_3D)
 	{
@@ -559,6 +583,16 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 		U32 mipHeight = header.m_height;
 		for(U32 mip = 0; mip < header.m_mipmapCount; mip++)
 		{
+			// Check if this mipmap can be skipped because of size
+			const U32 mipSize = max(mipWidth, mipHeight);
+			if(mipSize <= minImageSize)
+			{
+				// The rest of the mips are even smaller
+				break;
+			}
+
+			const Bool skipMip = mipSize > maxImageSize && mip != header.m_mipmapCount - 1;
+
 			for(U32 l = 0; l < layerCount; l++)
 			{
 				for(U32 f = 0; f < faceCount; ++f)
@@ -567,17 +601,21 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 						calcSurfaceSize(mipWidth, mipHeight, preferredCompression, header.m_colorFormat,
 										UVec2(header.m_astcBlockSizeX, header.m_astcBlockSizeY));
 
-					// Check if this mipmap can be skipped because of size
-					if(max(mipWidth, mipHeight) <= maxImageSize || mip == header.m_mipmapCount - 1)
+					if(!skipMip)
 					{
 						ImageLoaderSurface& surf = *surfaces.emplaceBack(alloc);
 						surf.m_width = mipWidth;
 						surf.m_height = mipHeight;
 
-						surf.m_data.create(alloc, dataSize);
-						ANKI_CHECK(file.read(&surf.m_data[0], dataSize));
-
-						mipCount = max(header.m_mipmapCount - mip, mipCount);
+						if(file.isInMemory())
+						{
+							ANKI_CHECK(file.readInPlace(dataSize, surf.m_mappedData));
+						}
+						else
+						{
+							surf.m_data.create(alloc, dataSize);
+							ANKI_CHECK(file.read(&surf.m_data[0], dataSize));
+						}
 					}
 					else
 					{
@@ -586,10 +624,21 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 				}
 			}
 
+			if(!skipMip)
+			{
+				++mipCount;
+			}
+
 			mipWidth /= 2;
 			mipHeight /= 2;
 		}
 
+		if(surfaces.getSize() == 0)
+		{
+			ANKI_RESOURCE_LOGE("No mip left to load");
+			return Error::USER_DATA;
+		}
+
 		width = surfaces[0].m_width;
 		height = surfaces[0].m_height;
 		depth = MAX_U32;
@@ -605,17 +654,25 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 				U32(calcVolumeSize(mipWidth, mipHeight, mipDepth, preferredCompression, header.m_colorFormat));
 
 			// Check if this mipmap can be skipped because of size
-			if(max(max(mipWidth, mipHeight), mipDepth) <= maxImageSize || mip == header.m_mipmapCount - 1)
+			const U32 mipSize = max(max(mipWidth, mipHeight), mipDepth);
+			if((mipSize <= maxImageSize || mip == header.m_mipmapCount - 1) && mipSize > minImageSize)
 			{
 				ImageLoaderVolume& vol = *volumes.emplaceBack(alloc);
 				vol.m_width = mipWidth;
 				vol.m_height = mipHeight;
 				vol.m_depth = mipDepth;
 
-				vol.m_data.create(alloc, dataSize);
-				ANKI_CHECK(file.read(&vol.m_data[0], dataSize));
+				if(file.isInMemory())
+				{
+					ANKI_CHECK(file.readInPlace(dataSize, vol.m_mappedData));
+				}
+				else
+				{
+					vol.m_data.create(alloc, dataSize);
+					ANKI_CHECK(file.read(&vol.m_data[0], dataSize));
+				}
 
-				mipCount = max(header.m_mipmapCount - mip, mipCount);
+				++mipCount;
 			}
 			else
 			{
@@ -627,6 +684,12 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 			mipDepth /= 2;
 		}
 
+		if(volumes.getSize() == 0)
+		{
+			ANKI_RESOURCE_LOGE("No mip left to load");
+			return Error::USER_DATA;
+		}
+
 		width = volumes[0].m_width;
 		height = volumes[0].m_height;
 		depth = volumes[0].m_depth;
@@ -638,11 +701,20 @@ Error ImageLoader::loadAnkiImage(FileInterface& file, U32 maxImageSize,
 Error ImageLoader::loadStb(Bool isFloat, FileInterface& fs, U32& width, U32& height, DynamicArray<U8, PtrSize>& data,
 						   GenericMemoryPoolAllocator<U8>& alloc)
 {
-	// Read the file
-	DynamicArrayAuto<U8, PtrSize> fileData(alloc);
+	// Read the file or use its memory directly
+	DynamicArrayAuto<U8, PtrSize> fileDataStorage(alloc);
+	ConstWeakArray<U8, PtrSize> fileData;
 	const PtrSize fileSize = fs.getSize();
-	fileData.create(fileSize);
-	ANKI_CHECK(fs.read(&fileData[0], fileSize));
+	if(fs.isInMemory())
+	{
+		ANKI_CHECK(fs.readInPlace(fileSize, fileData));
+	}
+	else
+	{
+		fileDataStorage.create(fileSize);
+		ANKI_CHECK(fs.read(&fileDataStorage[0], fileSize));
+		fileData = fileDataStorage;
+	}
 
 	// Use STB to read the image
 	int stbw, stbh, comp;
@@ -676,16 +748,20 @@ Error ImageLoader::loadStb(Bool isFloat, FileInterface& fs, U32& width, U32& hei
 	return Error::NONE;
 }
 
-Error ImageLoader::load(ResourceFilePtr rfile, const CString& filename, U32 maxImageSize)
+Error ImageLoader::load(ResourceFilePtr rfile, const CString& filename, U32 maxImageSize, U32 minImageSize)
 {
 	RsrcFile file;
 	file.m_rfile = rfile;
 
-	const Error err = loadInternal(file, filename, maxImageSize);
+	const Error err = loadInternal(file, filename, maxImageSize, minImageSize);
 	if(err)
 	{
 		ANKI_RESOURCE_LOGE("Failed to read image: %s", filename.cstr());
 	}
+	else
+	{
+		m_file = std::move(file.m_rfile);
+	}
 
 	return err;
 }
@@ -695,7 +771,7 @@ Error ImageLoader::load(const CString& filename, U32 maxImageSize)
 	SystemFile file;
 	ANKI_CHECK(file.m_file.open(filename, FileOpenFlag::READ | FileOpenFlag::BINARY));
 
-	const Error err = loadInternal(file, filename, maxImageSize);
+	const Error err = loadInternal(file, filename, maxImageSize, 0);
 	if(err)
 	{
 		ANKI_RESOURCE_LOGE("Failed to read image: %s", filename.cstr());
@@ -704,8 +780,13 @@ Error ImageLoader::load(const CString& filename, U32 maxImageSize)
 	return err;
 }
 
-Error ImageLoader::loadInternal(FileInterface& file, const CString& filename, U32 maxImageSize)
+Error ImageLoader::loadInternal(FileInterface& file, const CString& filename, U32 maxImageSize, U32 minImageSize)
 {
+	// Forget the previous image
+	destroy();
+	m_fullWidth = 0;
+	m_fullHeight = 0;
+
 	// get the extension
 	StringAuto ext(m_alloc);
 	getFilepathExtension(filename, ext);
@@ -754,8 +835,9 @@ Error ImageLoader::loadInternal(FileInterface& file, const CString& filename, U3
 		m_compression = ImageBinaryDataCompression::S3TC;
 #endif
 
-		ANKI_CHECK(loadAnkiImage(file, maxImageSize, m_compression, m_surfaces, m_volumes, m_alloc, m_width, m_height,
-								 m_depth, m_layerCount, m_mipmapCount, m_imageType, m_colorFormat, m_astcBlockSize));
+		ANKI_CHECK(loadAnkiImage(file, maxImageSize, minImageSize, m_compression, m_surfaces, m_volumes, m_alloc,
+								 m_width, m_height, m_fullWidth, m_fullHeight, m_depth, m_layerCount, m_mipmapCount,
+								 m_imageType, m_colorFormat, m_astcBlockSize));
 	}
 	else if(ext == "png" || ext == "jpg")
 	{
@@ -791,6 +873,13 @@ Error ImageLoader::loadInternal(FileInterface& file, const CString& filename, U3
 		return Error::USER_DATA;
 	}
 
+	if(m_fullWidth == 0)
+	{
+		// Only AnKi images can skip mips
+		m_fullWidth = m_width;
+		m_fullHeight = m_height;
+	}
+
 	return Error::NONE;
 }
 
@@ -843,6 +932,8 @@ void ImageLoader::destroy()
 	}
 
 	m_volumes.destroy(m_alloc);
+
+	m_file.reset(nullptr);
 }
 
 } // end namespace anki
@@ -19,6 +19,12 @@ public:
 	U32 m_width;
 	U32 m_height;
 	DynamicArray<U8, PtrSize> m_data;
+	ConstWeakArray<U8, PtrSize> m_mappedData; ///< Points to the file's memory if the file was in memory.
+
+	ConstWeakArray<U8, PtrSize> getData() const
+	{
+		return (m_mappedData.getSize()) ? m_mappedData : ConstWeakArray<U8, PtrSize>(m_data);
+	}
 };
 
 /// An image volume
@@ -30,6 +36,12 @@ public:
 	U32 m_height;
 	U32 m_depth;
 	DynamicArray<U8, PtrSize> m_data;
+	ConstWeakArray<U8, PtrSize> m_mappedData; ///< Points to the file's memory if the file was in memory.
+
+	ConstWeakArray<U8, PtrSize> getData() const
+	{
+		return (m_mappedData.getSize()) ? m_mappedData : ConstWeakArray<U8, PtrSize>(m_data);
+	}
 };
 
 /// Loads bitmaps from regular system files or resource files. Supported formats are .tga and .ankitex.
@@ -74,6 +86,18 @@ public:
 		return m_height;
 	}
 
+	/// The width of the first mip in the file. It's bigger than getWidth() if maxImageSize skipped some mips.
+	U32 getFullWidth() const
+	{
+		return m_fullWidth;
+	}
+
+	/// The height of the first mip in the file. It's bigger than getHeight() if maxImageSize skipped some mips.
+	U32 getFullHeight() const
+	{
+		return m_fullHeight;
+	}
+
 	U32 getDepth() const
 	{
 		ANKI_ASSERT(m_imageType == ImageBinaryType::_3D);
@@ -103,8 +127,12 @@ public:
 
 	const ImageLoaderVolume& getVolume(U32 level) const;
 
-	/// Load a resource image file.
-	Error load(ResourceFilePtr file, const CString& filename, U32 maxImageSize = MAX_U32);
+	/// Load a resource image file. If the file is in memory (see ResourceFile::getContents()) the surfaces will point
+	/// to the file's memory instead of holding a copy.
+	/// @param maxImageSize Skip the mips that are bigger than that.
+	/// @param minImageSize Skip the mips that are smaller or equal to that. Only AnKi images support it. Used to load
+	///                     only the mips that are missing from a streamed texture.
+	Error load(ResourceFilePtr file, const CString& filename, U32 maxImageSize = MAX_U32, U32 minImageSize = 0);
 
 	/// Load a system image file.
 	Error load(const CString& filename, U32 maxImageSize = MAX_U32);
@@ -116,6 +144,9 @@ private:
 
 	GenericMemoryPoolAllocator<U8> m_alloc;
 
+	/// Keep the file alive because the surfaces might point to its memory.
+	ResourceFilePtr m_file;
+
 	/// [mip][depth or face or layer]. Loader doesn't support cube arrays ATM so face and layer won't be used at the
 	/// same time.
 	DynamicArray<ImageLoaderSurface> m_surfaces;
@@ -125,6 +156,8 @@ private:
 	U32 m_mipmapCount = 0;
 	U32 m_width = 0;
 	U32 m_height = 0;
+	U32 m_fullWidth = 0;
+	U32 m_fullHeight = 0;
 	U32 m_depth = 0;
 	U32 m_layerCount = 0;
 	UVec2 m_astcBlockSize = UVec2(0u);
@@ -146,13 +179,14 @@ private:
 	static Error loadStb(Bool isFloat, FileInterface& fs, U32& width, U32& height, DynamicArray<U8, PtrSize>& data,
 						 GenericMemoryPoolAllocator<U8>& alloc);
 
-	static Error loadAnkiImage(FileInterface& file, U32 maxImageSize, ImageBinaryDataCompression& preferredCompression,
+	static Error loadAnkiImage(FileInterface& file, U32 maxImageSize, U32 minImageSize,
+							   ImageBinaryDataCompression& preferredCompression,
 							   DynamicArray<ImageLoaderSurface>& surfaces, DynamicArray<ImageLoaderVolume>& volumes,
-							   GenericMemoryPoolAllocator<U8>& alloc, U32& width, U32& height, U32& depth,
-							   U32& layerCount, U32& mipCount, ImageBinaryType& imageType,
+							   GenericMemoryPoolAllocator<U8>& alloc, U32& width, U32& height, U32& fullWidth,
+							   U32& fullHeight, U32& depth, U32& layerCount, U32& mipCount, ImageBinaryType& imageType,
 							   ImageBinaryColorFormat& colorFormat, UVec2& astcBlockSize);
 
-	Error loadInternal(FileInterface& file, const CString& filename, U32 maxImageSize);
+	Error loadInternal(FileInterface& file, const CString& filename, U32 maxImageSize, U32 minImageSize);
 };
 
 } // end namespace anki
@@ -7,8 +7,10 @@
 #include <AnKi/Resource/ImageLoader.h>
 #include <AnKi/Resource/ResourceManager.h>
 #include <AnKi/Resource/AsyncLoader.h>
+#include <AnKi/Resource/TextureStreamer.h>
 #include <AnKi/Core/ConfigSet.h>
 #include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/Tracer.h>
 
 namespace anki {
 
@@ -34,9 +36,11 @@ class ImageResource::TexUploadTask : public AsyncLoaderTask
 {
 public:
 	ImageResource::LoadingContext m_ctx;
+	ImageResourcePtr m_image; ///< Keep it alive and know if it's been dropped.
 
-	TexUploadTask(GenericMemoryPoolAllocator<U8> alloc)
+	TexUploadTask(ImageResource* image, GenericMemoryPoolAllocator<U8> alloc)
 		: m_ctx(alloc)
+		, m_image(image)
 	{
 	}
 
@@ -44,26 +48,189 @@ public:
 	{
 		return ImageResource::load(m_ctx);
 	}
+
+	Bool isCancelled() const final
+	{
+		// If the task holds the only reference then no one needs the image. Unregister it at the same time so no one
+		// can pick it up without the data
+		return AsyncLoaderTask::isCancelled() || m_image->getManager().unregisterResourceIfUnused(m_image.get());
+	}
+
+	GenericMemoryPoolAllocator<U8> getAllocator() const
+	{
+		return m_image->getManager().getAsyncLoader().getAllocator();
+	}
+};
+
+/// Creates a texture with a different number of mips for a streamed image.
+class ImageResource::StreamingTask : public AsyncLoaderTask
+{
+public:
+	ImageResourcePtr m_image;
+	TexturePtr m_oldTex; ///< The texture at the time of the submission.
+	U32 m_size;
+	Bool m_ran = false;
+
+	StreamingTask(ImageResource* image, U32 size)
+		: m_image(image)
+		, m_oldTex(image->m_tex)
+		, m_size(size)
+	{
+	}
+
+	~StreamingTask()
+	{
+		if(!m_ran)
+		{
+			// Cancelled. Let the streamer know that it shouldn't wait for it
+			LockGuard<SpinLock> lock(m_image->m_streaming.m_mtx);
+			m_image->m_streaming.m_cancelled = true;
+		}
+	}
+
+	Error operator()([[maybe_unused]] AsyncLoaderTaskContext& ctx) final
+	{
+		m_ran = true;
+		ImageResource& image = *m_image;
+		const Error err = run(image);
+
+		LockGuard<SpinLock> lock(image.m_streaming.m_mtx);
+		if(err)
+		{
+			// Don't return the error, it will stop the loader thread. Let the streamer know instead
+			ANKI_RESOURCE_LOGE("Failed to stream image: %s", image.m_streaming.m_filename.cstr());
+			image.m_streaming.m_failed = true;
+		}
+		else
+		{
+			image.m_streaming.m_newTex = std::move(m_newTex);
+			image.m_streaming.m_newSize = m_size;
+		}
+
+		return Error::NONE;
+	}
+
+	Bool isCancelled() const final
+	{
+		// Same as TexUploadTask. An image that is picked up at the same time shouldn't miss the swap
+		return AsyncLoaderTask::isCancelled() || m_image->getManager().unregisterResourceIfUnused(m_image.get());
+	}
+
+private:
+	TexturePtr m_newTex;
+
+	Error run(ImageResource& image)
+	{
+		ANKI_TRACE_SCOPED_EVENT(RSRC_IMAGE_STREAM);
+		const CString filename = image.m_streaming.m_filename;
+		GrManager& gr = image.getManager().getGrManager();
+
+		// The sizes are powers of two so the new texture is the old one with some mips added or removed on the top
+		const U32 oldSize = max(m_oldTex->getWidth(), m_oldTex->getHeight());
+		ANKI_ASSERT(isPowerOfTwo(oldSize) && isPowerOfTwo(m_size));
+		const I32 mipDelta = I32(log2(m_size)) - I32(log2(oldSize));
+		ANKI_ASSERT(I32(m_oldTex->getMipmapCount()) + mipDelta > 0);
+
+		GenericMemoryPoolAllocator<U8> alloc = image.getManager().getAsyncLoader().getAllocator();
+		StringAuto filenameExt(alloc);
+		getFilepathFilename(filename, filenameExt);
+
+		TextureInitInfo init(filenameExt);
+		init.m_width = (mipDelta >= 0) ? (m_oldTex->getWidth() << mipDelta) : (m_oldTex->getWidth() >> -mipDelta);
+		init.m_height = (mipDelta >= 0) ? (m_oldTex->getHeight() << mipDelta) : (m_oldTex->getHeight() >> -mipDelta);
+		init.m_format = m_oldTex->getFormat();
+		init.m_type = TextureType::_2D;
+		init.m_mipmapCount = U8(I32(m_oldTex->getMipmapCount()) + mipDelta);
+		init.m_usage = TextureUsageBit::ALL_SAMPLED | TextureUsageBit::TRANSFER_DESTINATION
+					   | TextureUsageBit::TRANSFER_SOURCE;
+		TexturePtr newTex = image.newTexture(init);
+
+		// Load only the mips that the old texture doesn't have
+		if(mipDelta > 0)
+		{
+			LoadingContext ctx(alloc);
+			ResourceFilePtr file;
+			ANKI_CHECK(image.openFileInMemory(filename, file));
+			ANKI_CHECK(ctx.m_loader.load(file, filename, m_size, oldSize));
+			ANKI_ASSERT(ctx.m_loader.getMipmapCount() == U32(mipDelta));
+			ANKI_ASSERT(ctx.m_loader.getWidth() == init.m_width && ctx.m_loader.getHeight() == init.m_height);
+
+			ctx.m_faces = 1;
+			ctx.m_layerCount = 1;
+			ctx.m_gr = &gr;
+			ctx.m_trfAlloc = &image.getManager().getTransferGpuAllocator();
+			ctx.m_texType = init.m_type;
+			ctx.m_tex = newTex;
+			ANKI_CHECK(ImageResource::load(ctx));
+		}
+
+		// Copy the rest of the mips from the old texture
+		CommandBufferInitInfo cmdbInit;
+		cmdbInit.m_flags = CommandBufferFlag::GENERAL_WORK | CommandBufferFlag::SMALL_BATCH;
+		CommandBufferPtr cmdb = gr.newCommandBuffer(cmdbInit);
+
+		const U32 firstCopiedMip = U32(max(mipDelta, 0));
+		for(U32 mip = firstCopiedMip; mip < init.m_mipmapCount; ++mip)
+		{
+			const TextureSurfaceInfo oldSurf(U32(I32(mip) - mipDelta), 0, 0, 0);
+			const TextureSurfaceInfo newSurf(mip, 0, 0, 0);
+			cmdb->setTextureSurfaceBarrier(m_oldTex, TextureUsageBit::ALL_SAMPLED, TextureUsageBit::TRANSFER_SOURCE,
+										   oldSurf);
+			cmdb->setTextureSurfaceBarrier(newTex, TextureUsageBit::NONE, TextureUsageBit::TRANSFER_DESTINATION,
+										   newSurf);
+		}
+
+		for(U32 mip = firstCopiedMip; mip < init.m_mipmapCount; ++mip)
+		{
+			const TextureSurfaceInfo oldSurf(U32(I32(mip) - mipDelta), 0, 0, 0);
+			const TextureSurfaceInfo newSurf(mip, 0, 0, 0);
+			TextureViewPtr oldView = gr.newTextureView(TextureViewInitInfo(m_oldTex, oldSurf, "RsrcTmp"));
+			TextureViewPtr newView = gr.newTextureView(TextureViewInitInfo(newTex, newSurf, "RsrcTmp"));
+			cmdb->copyTextureViewToTextureView(oldView, newView);
+		}
+
+		for(U32 mip = firstCopiedMip; mip < init.m_mipmapCount; ++mip)
+		{
+			const TextureSurfaceInfo oldSurf(U32(I32(mip) - mipDelta), 0, 0, 0);
+			const TextureSurfaceInfo newSurf(mip, 0, 0, 0);
+			cmdb->setTextureSurfaceBarrier(m_oldTex, TextureUsageBit::TRANSFER_SOURCE, TextureUsageBit::ALL_SAMPLED,
+										   oldSurf);
+			cmdb->setTextureSurfaceBarrier(newTex, TextureUsageBit::TRANSFER_DESTINATION, TextureUsageBit::ALL_SAMPLED,
+										   newSurf);
+		}
+
+		cmdb->flush();
+
+		m_newTex = std::move(newTex);
+		return Error::NONE;
+	}
 };
 
 ImageResource::~ImageResource()
 {
+	if(m_streaming.m_indexInStreamer != MAX_U32)
+	{
+		getManager().getTextureStreamer().unregisterImage(this);
+	}
+
+	m_streaming.m_filename.destroy(getAllocator());
 }
 
 Error ImageResource::load(const ResourceFilename& filename, Bool async)
 {
-	TexUploadTask* task;
+	UniquePtr<TexUploadTask> task;
 	LoadingContext* ctx;
 	LoadingContext localCtx(getTempAllocator());
 
 	if(async)
 	{
-		task = getManager().getAsyncLoader().newTask<TexUploadTask>(getManager().getAsyncLoader().getAllocator());
+		task.reset(
+			getManager().getAsyncLoader().newTask<TexUploadTask>(this, getManager().getAsyncLoader().getAllocator()));
 		ctx = &task->m_ctx;
 	}
 	else
 	{
-		task = nullptr;
+		task.reset(nullptr);
 		ctx = &localCtx;
 	}
 	ImageLoader& loader = ctx->m_loader;
@@ -75,11 +242,101 @@ Error ImageResource::load(const ResourceFilename& filename, Bool async)
 	init.m_usage = TextureUsageBit::ALL_SAMPLED | TextureUsageBit::TRANSFER_DESTINATION;
 	U32 faces = 0;
 
+	// Big AnKi images that are loaded async can be streamed. Start with the smaller mips in that case
+	const U32 maxImageSize = getConfig().getRsrcMaxImageSize();
+	Bool streamed = false;
+	if(async && getConfig().getRsrcTextureStreaming())
+	{
+		StringAuto ext(getTempAllocator());
+		getFilepathExtension(filename, ext);
+		streamed = ext == "ankitex";
+	}
+	const U32 initialImageSize =
+		(streamed) ? min(maxImageSize, getConfig().getRsrcTextureStreamingMinSize()) : maxImageSize;
+
+	// Have the whole file in memory so the loader can point to the surfaces instead of copying them
 	ResourceFilePtr file;
-	ANKI_CHECK(openFile(filename, file));
+	ANKI_CHECK(openFileInMemory(filename, file));
+
+	{
+		ANKI_TRACE_SCOPED_EVENT(RSRC_IMAGE_DECODE);
+		ANKI_CHECK(loader.load(file, filename, initialImageSize));
+	}
+
+	// Compute the size of the first mip when fully loaded
+	U32 fullWidth = loader.getFullWidth();
+	U32 fullHeight = loader.getFullHeight();
+	while(max(fullWidth, fullHeight) > maxImageSize && fullWidth > loader.getWidth())
+	{
+		fullWidth >>= 1;
+		fullHeight >>= 1;
+	}
+
+	streamed = streamed && fullWidth > loader.getWidth();
+
+	if(streamed && loader.getImageType() != ImageBinaryType::_2D)
+	{
+		// Only 2D images are streamed. Load it again with all the mips
+		streamed = false;
+		ANKI_CHECK(openFileInMemory(filename, file));
+		ANKI_TRACE_SCOPED_EVENT(RSRC_IMAGE_DECODE);
+		ANKI_CHECK(loader.load(file, filename, maxImageSize));
+	}
+
+	ANKI_CHECK(initTextureInitInfo(loader, init, faces));
 
-	ANKI_CHECK(loader.load(file, filename, getConfig().getRsrcMaxImageSize()));
+	// The streaming copies the mips of the texture to the next ones
+	if(streamed)
+	{
+		init.m_usage |= TextureUsageBit::TRANSFER_SOURCE;
+	}
 
+	// Create the texture
+	m_tex = newTexture(init);
+
+	// Set the context
+	ctx->m_faces = faces;
+	ctx->m_layerCount = init.m_layerCount;
+	ctx->m_gr = &getManager().getGrManager();
+	ctx->m_trfAlloc = &getManager().getTransferGpuAllocator();
+	ctx->m_texType = init.m_type;
+	ctx->m_tex = m_tex;
+
+	// Upload the data
+	if(async)
+	{
+		getManager().getAsyncLoader().submitTask(task.get());
+		TexUploadTask* pTask;
+		task.moveAndReset(pTask);
+	}
+	else
+	{
+		ANKI_CHECK(load(*ctx));
+	}
+
+	m_size = UVec3(init.m_width, init.m_height, init.m_depth);
+	m_layerCount = init.m_layerCount;
+
+	// Create the texture view
+	TextureViewInitInfo viewInit(m_tex, "Rsrc");
+	m_texView = getManager().getGrManager().newTextureView(viewInit);
+
+	// Hand it to the streamer
+	if(streamed)
+	{
+		m_streaming.m_filename.create(getAllocator(), filename);
+		m_streaming.m_fullSize = UVec2(fullWidth, fullHeight);
+		m_streaming.m_maxSize = max(fullWidth, fullHeight);
+		m_streaming.m_minSize = max(init.m_width, init.m_height);
+		m_streaming.m_residentSize = m_streaming.m_minSize;
+		getManager().getTextureStreamer().registerImage(this);
+	}
+
+	return Error::NONE;
+}
+
+Error ImageResource::initTextureInitInfo(const ImageLoader& loader, TextureInitInfo& init, U32& faces)
+{
 	// Various sizes
 	init.m_width = loader.getWidth();
 	init.m_height = loader.getHeight();
@@ -203,8 +460,12 @@ Error ImageResource::load(const ResourceFilename& filename, Bool async)
 	// mipmapsCount
 	init.m_mipmapCount = U8(loader.getMipmapCount());
 
-	// Create the texture
-	m_tex = getManager().getGrManager().newTexture(init);
+	return Error::NONE;
+}
+
+TexturePtr ImageResource::newTexture(const TextureInitInfo& init)
+{
+	TexturePtr tex = getManager().getGrManager().newTexture(init);
 
 	// Transition it. TODO remove that eventually
 	{
@@ -217,43 +478,83 @@ Error ImageResource::load(const ResourceFilename& filename, Bool async)
 		subresource.m_layerCount = init.m_layerCount;
 		subresource.m_mipmapCount = init.m_mipmapCount;
 
-		cmdb->setTextureBarrier(m_tex, TextureUsageBit::NONE, TextureUsageBit::ALL_SAMPLED, subresource);
+		cmdb->setTextureBarrier(tex, TextureUsageBit::NONE, TextureUsageBit::ALL_SAMPLED, subresource);
 
 		FencePtr outFence;
 		cmdb->flush({}, &outFence);
 		outFence->clientWait(60.0_sec);
 	}
 
-	// Set the context
-	ctx->m_faces = faces;
-	ctx->m_layerCount = init.m_layerCount;
-	ctx->m_gr = &getManager().getGrManager();
-	ctx->m_trfAlloc = &getManager().getTransferGpuAllocator();
-	ctx->m_texType = init.m_type;
-	ctx->m_tex = m_tex;
+	return tex;
+}
 
-	// Upload the data
-	if(async)
+U32 ImageResource::getOrCreateBindlessTextureIndex()
+{
+	LockGuard<SpinLock> lock(m_streaming.m_mtx);
+	if(m_bindlessIndex == MAX_U32)
 	{
-		getManager().getAsyncLoader().submitTask(task);
+		m_bindlessIndex = m_texView->getOrCreateBindlessTextureIndex();
 	}
-	else
+
+	return m_bindlessIndex;
+}
+
+void ImageResource::submitStreamingTask(U32 size, AsyncLoaderPriority priority)
+{
+	ANKI_ASSERT(isStreamed() && !m_streaming.m_taskInFlight);
+	m_streaming.m_taskInFlight = true;
+	m_streaming.m_pendingSize = size;
+
+	AsyncLoader& loader = getManager().getAsyncLoader();
+	loader.submitTask(loader.newTask<StreamingTask>(this, size), priority);
+}
+
+Bool ImageResource::swapStreamedTexture()
+{
+	if(!m_streaming.m_taskInFlight)
 	{
-		ANKI_CHECK(load(*ctx));
+		return false;
 	}
 
-	m_size = UVec3(init.m_width, init.m_height, init.m_depth);
-	m_layerCount = init.m_layerCount;
+	LockGuard<SpinLock> lock(m_streaming.m_mtx);
 
-	// Create the texture view
-	TextureViewInitInfo viewInit(m_tex, "Rsrc");
-	m_texView = getManager().getGrManager().newTextureView(viewInit);
+	if(m_streaming.m_cancelled)
+	{
+		m_streaming.m_cancelled = false;
+		m_streaming.m_taskInFlight = false;
+		return false;
+	}
 
-	return Error::NONE;
+	if(m_streaming.m_failed)
+	{
+		ANKI_RESOURCE_LOGW("Will stop streaming image: %s", m_streaming.m_filename.cstr());
+		m_streaming.m_disabled = true;
+		m_streaming.m_taskInFlight = false;
+		return false;
+	}
+
+	if(!m_streaming.m_newTex.isCreated())
+	{
+		// Still loading
+		return false;
+	}
+
+	m_tex = std::move(m_streaming.m_newTex);
+	m_size = UVec3(m_tex->getWidth(), m_tex->getHeight(), 1);
+	m_texView = getManager().getGrManager().newTextureView(TextureViewInitInfo(m_tex, "Rsrc"));
+	if(m_bindlessIndex != MAX_U32)
+	{
+		m_bindlessIndex = m_texView->getOrCreateBindlessTextureIndex();
+	}
+
+	m_streaming.m_residentSize = m_streaming.m_newSize;
+	m_streaming.m_taskInFlight = false;
+	return true;
 }
 
 Error ImageResource::load(LoadingContext& ctx)
 {
+	ANKI_TRACE_SCOPED_EVENT(RSRC_IMAGE_UPLOAD);
 	const U32 copyCount = ctx.m_layerCount * ctx.m_faces * ctx.m_loader.getMipmapCount();
 
 	for(U32 b = 0; b < copyCount; b += MAX_COPIES_BEFORE_FLUSH)
@@ -300,8 +601,8 @@ Error ImageResource::load(LoadingContext& ctx)
 			if(ctx.m_texType == TextureType::_3D)
 			{
 				const auto& vol = ctx.m_loader.getVolume(mip);
-				surfOrVolSize = vol.m_data.getSize();
-				surfOrVolData = &vol.m_data[0];
+				surfOrVolSize = vol.getData().getSize();
+				surfOrVolData = vol.getData().getBegin();
 
 				allocationSize = computeVolumeSize(ctx.m_tex->getWidth() >> mip, ctx.m_tex->getHeight() >> mip,
 												   ctx.m_tex->getDepth() >> mip, ctx.m_tex->getFormat());
@@ -309,8 +610,8 @@ Error ImageResource::load(LoadingContext& ctx)
 			else
 			{
 				const auto& surf = ctx.m_loader.getSurface(mip, face, layer);
-				surfOrVolSize = surf.m_data.getSize();
-				surfOrVolData = &surf.m_data[0];
+				surfOrVolSize = surf.getData().getSize();
+				surfOrVolData = surf.getData().getBegin();
 
 				allocationSize = computeSurfaceSize(ctx.m_tex->getWidth() >> mip, ctx.m_tex->getHeight() >> mip,
 													ctx.m_tex->getFormat());
@@ -6,10 +6,14 @@
 #pragma once
 
 #include <AnKi/Resource/ResourceObject.h>
+#include <AnKi/Resource/AsyncLoader.h>
 #include <AnKi/Gr.h>
 
 namespace anki {
 
+// Forward
+class ImageLoader;
+
 /// @addtogroup resource
 /// @{
 
@@ -17,8 +21,14 @@ namespace anki {
 ///
 /// It loads or creates an image and then loads it in the GPU. It supports compressed and uncompressed TGAs, PNGs, JPEG
 /// and AnKi's image format.
+///
+/// Big 2D AnKi images that are loaded asynchronously are streamed. Only their smaller mips are loaded initially and the
+/// TextureStreamer recreates the texture with more or less mips depending on the requests of requestStreamingSize().
+/// The mips that the old texture has are copied on the GPU and only the missing mips are read from the file.
 class ImageResource : public ResourceObject
 {
+	friend class TextureStreamer;
+
 public:
 	ImageResource(ResourceManager* manager)
 		: ResourceObject(manager)
@@ -31,17 +41,32 @@ public:
 	Error load(const ResourceFilename& filename, Bool async);
 
 	/// Get the texture.
+	/// @note Streamed images swap their texture between frames so don't hold onto it for longer than a frame.
 	const TexturePtr& getTexture() const
 	{
 		return m_tex;
 	}
 
 	/// Get the texture view.
+	/// @note Streamed images swap their texture view between frames so don't hold onto it for longer than a frame.
 	const TextureViewPtr& getTextureView() const
 	{
 		return m_texView;
 	}
 
+	/// Same as TextureView::getOrCreateBindlessTextureIndex() but it also makes sure that the texture views that will
+	/// be created by streaming will have a bindless index.
+	U32 getOrCreateBindlessTextureIndex();
+
+	/// Get the bindless index of the current texture view. getOrCreateBindlessTextureIndex() should have been called.
+	U32 getBindlessTextureIndex() const
+	{
+		ANKI_ASSERT(m_bindlessIndex != MAX_U32);
+		return m_bindlessIndex;
+	}
+
+	/// The size of the first mip of the texture. If the image is streamed it's the size of the current texture and it
+	/// changes along with it (see getTexture()).
 	U32 getWidth() const
 	{
 		ANKI_ASSERT(m_size.x());
@@ -66,18 +91,76 @@ public:
 		return m_layerCount;
 	}
 
+	Bool isStreamed() const
+	{
+		return m_streaming.m_maxSize > 0;
+	}
+
+	/// Ask for the image to have at least that many texels in its biggest dimension. Visibility calls that every frame
+	/// for the visible objects.
+	/// @note It's thread-safe.
+	void requestStreamingSize(U32 size)
+	{
+		if(isStreamed())
+		{
+			m_streaming.m_requestedSize.max(size);
+		}
+	}
+
 private:
 	static constexpr U32 MAX_COPIES_BEFORE_FLUSH = 4;
 
 	class TexUploadTask;
+	class StreamingTask;
 	class LoadingContext;
 
+	/// The state of streamed images. The TextureStreamer owns most of it.
+	class Streaming
+	{
+	public:
+		String m_filename; ///< Keep a copy because the ResourceObject's is set after the load().
+		UVec2 m_fullSize = UVec2(0u); ///< The size of the first mip when fully loaded.
+		U32 m_maxSize = 0; ///< The max size of the first mip that can be loaded. Zero if it's not streamed.
+		U32 m_minSize = 0; ///< The size of the first mip that was initially loaded. Never goes bellow that.
+		U32 m_residentSize = 0; ///< The size of the first mip of m_tex.
+		U32 m_pendingSize = 0; ///< The size that the in-flight StreamingTask will load.
+		U32 m_desiredSize = 0; ///< The size that the streamer wants.
+		Atomic<U32> m_requestedSize = {0}; ///< The max size requested in the current frame.
+		U64 m_lastRequestFrame = 0; ///< Zero if it was never requested.
+		U32 m_indexInStreamer = MAX_U32;
+		Bool m_taskInFlight = false; ///< Only the streamer's thread touches it.
+		Bool m_disabled = false;
+
+		/// The result of the StreamingTask.
+		/// @{
+		SpinLock m_mtx;
+		TexturePtr m_newTex;
+		U32 m_newSize = 0;
+		Bool m_failed = false;
+		Bool m_cancelled = false;
+		/// @}
+	};
+
 	TexturePtr m_tex;
 	TextureViewPtr m_texView;
 	UVec3 m_size = UVec3(0u);
 	U32 m_layerCount = 0;
+	U32 m_bindlessIndex = MAX_U32;
+	Streaming m_streaming;
 
 	[[nodiscard]] static Error load(LoadingContext& ctx);
+
+	[[nodiscard]] static Error initTextureInitInfo(const ImageLoader& loader, TextureInitInfo& init, U32& faces);
+
+	TexturePtr newTexture(const TextureInitInfo& init);
+
+	/// Submit an async task that will create a texture with the first mip being @a size. The mips of the current
+	/// texture will be copied to the new one.
+	void submitStreamingTask(U32 size, AsyncLoaderPriority priority);
+
+	/// Use the texture that the last StreamingTask created. Called by the TextureStreamer between frames.
+	/// @return True if there was a new texture.
+	Bool swapStreamedTexture();
 };
 /// @}
 
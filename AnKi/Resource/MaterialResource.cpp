@@ -131,6 +131,7 @@ MaterialResource::~MaterialResource()
 	}
 
 	m_textures.destroy(getAllocator());
+	m_streamedImages.destroy(getAllocator());
 
 	for(MaterialVariable& var : m_vars)
 	{
@@ -700,7 +701,14 @@ Error MaterialResource::parseInput(XmlElement inputEl, Bool async, BitSet<128>&
 		ANKI_CHECK(inputEl.getAttributeText("value", texfname));
 		ANKI_CHECK(getManager().loadResource(texfname, foundVar->m_image, async));
 
-		m_textures.emplaceBack(getAllocator(), foundVar->m_image->getTexture());
+		if(foundVar->m_image->isStreamed())
+		{
+			m_streamedImages.emplaceBack(getAllocator(), foundVar->m_image.get());
+		}
+		else
+		{
+			m_textures.emplaceBack(getAllocator(), foundVar->m_image->getTexture());
+		}
 	}
 	else if(foundVar->m_dataType == ShaderVariableDataType::U32)
 	{
@@ -725,7 +733,12 @@ Error MaterialResource::parseInput(XmlElement inputEl, Bool async, BitSet<128>&
 		{
 			ANKI_CHECK(getManager().loadResource(value, foundVar->m_image, async));
 
-			foundVar->m_U32 = foundVar->m_image->getTextureView()->getOrCreateBindlessTextureIndex();
+			foundVar->m_U32 = foundVar->m_image->getOrCreateBindlessTextureIndex();
+
+			if(foundVar->m_image->isStreamed())
+			{
+				m_streamedImages.emplaceBack(getAllocator(), foundVar->m_image.get());
+			}
 		}
 		else
 		{
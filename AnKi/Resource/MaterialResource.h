@@ -247,11 +247,22 @@ public:
 	}
 
 	/// Get all GPU resources of this material. Will be used for GPU refcounting.
+	/// @note The textures of the streamed images are not included since they change.
 	ConstWeakArray<TexturePtr> getAllTextures() const
 	{
 		return m_textures;
 	}
 
+	/// Forward the request to all the streamed images of the material. See ImageResource::requestStreamingSize().
+	/// @note It's thread-safe.
+	void requestTextureStreamingSize(U32 size) const
+	{
+		for(ImageResource* image : m_streamedImages)
+		{
+			image->requestStreamingSize(size);
+		}
+	}
+
 	/// @note It's thread-safe.
 	const MaterialVariant& getOrCreateVariant(const RenderingKey& key) const;
 
@@ -281,6 +292,7 @@ private:
 	Bool m_supportsSkinning = false;
 
 	DynamicArray<TexturePtr> m_textures;
+	DynamicArray<ImageResource*> m_streamedImages; ///< Weak pointers, the variables hold the references.
 
 	void* m_prefilledLocalUniforms = nullptr;
 	U32 m_localUniformsSize = 0;
@@ -10,6 +10,7 @@
 #include <AnKi/Core/GpuMemoryPools.h>
 #include <AnKi/Util/Functions.h>
 #include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/Tracer.h>
 
 namespace anki {
 
@@ -42,6 +43,14 @@ public:
 		return m_ctx.m_mesh->loadAsync(m_ctx.m_loader);
 	}
 
+	Bool isCancelled() const final
+	{
+		// If the task holds the only reference then no one needs the mesh. Unregister it at the same time so no one can
+		// pick it up without the data
+		return AsyncLoaderTask::isCancelled()
+			   || m_ctx.m_mesh->getManager().unregisterResourceIfUnused(m_ctx.m_mesh.get());
+	}
+
 	GenericMemoryPoolAllocator<U8> getAllocator() const
 	{
 		return m_ctx.m_mesh->getManager().getAsyncLoader().getAllocator();
@@ -267,8 +276,9 @@ Error MeshResource::load(const ResourceFilename& filename, Bool async)
 	return Error::NONE;
 }
 
-Error MeshResource::loadAsync(MeshBinaryLoader& loader) const
+Error MeshResource::loadAsync(MeshBinaryLoader& loader)
 {
+	ANKI_TRACE_SCOPED_EVENT(RSRC_MESH_UPLOAD);
 	GrManager& gr = getManager().getGrManager();
 	TransferGpuAllocator& transferAlloc = getManager().getTransferGpuAllocator();
 	Array<TransferGpuAllocatorHandle, 2> handles;
@@ -281,6 +291,19 @@ Error MeshResource::loadAsync(MeshBinaryLoader& loader) const
 	cmdb->setBufferBarrier(m_vertexBuffer, BufferUsageBit::VERTEX, BufferUsageBit::TRANSFER_DESTINATION, 0,
 						   MAX_PTR_SIZE);
 
+	// Keep a CPU copy of the indices, the positions and the UVs to compute the UV density. Reading back from the
+	// staging memory is slow
+	const Bool computeDensity = isVertexAttributePresent(VertexAttributeId::POSITION)
+								&& isVertexAttributePresent(VertexAttributeId::UV0)
+								&& m_attributes[VertexAttributeId::POSITION].m_format == Format::R32G32B32_SFLOAT
+								&& m_attributes[VertexAttributeId::UV0].m_format == Format::R32G32_SFLOAT;
+	const AttribInfo& posAttrib = m_attributes[VertexAttributeId::POSITION];
+	const AttribInfo& uvAttrib = m_attributes[VertexAttributeId::UV0];
+	HeapAllocator<U8> alloc = getManager().getAsyncLoader().getAllocator();
+	DynamicArrayAuto<U8, PtrSize> cpuIndices(alloc);
+	DynamicArrayAuto<U8, PtrSize> cpuPositionBuffer(alloc);
+	DynamicArrayAuto<U8, PtrSize> cpuUvBuffer(alloc);
+
 	// Write index buffer
 	{
 		const PtrSize indexBufferSize = PtrSize(m_indexCount) * ((m_indexType == IndexType::U32) ? 4 : 2);
@@ -289,7 +312,16 @@ Error MeshResource::loadAsync(MeshBinaryLoader& loader) const
 		void* data = handles[1].getMappedMemory();
 		ANKI_ASSERT(data);
 
-		ANKI_CHECK(loader.storeIndexBuffer(data, indexBufferSize));
+		if(computeDensity)
+		{
+			cpuIndices.create(indexBufferSize);
+			ANKI_CHECK(loader.storeIndexBuffer(&cpuIndices[0], indexBufferSize));
+			memcpy(data, &cpuIndices[0], indexBufferSize);
+		}
+		else
+		{
+			ANKI_CHECK(loader.storeIndexBuffer(data, indexBufferSize));
+		}
 
 		cmdb->copyBufferToBuffer(handles[1].getBuffer(), handles[1].getOffset(), m_vertexBuffer, m_indexBufferOffset,
 								 handles[1].getRange());
@@ -306,10 +338,22 @@ Error MeshResource::loadAsync(MeshBinaryLoader& loader) const
 		for(U32 i = 0; i < m_vertexBufferInfos.getSize(); ++i)
 		{
 			alignRoundUp(MESH_BINARY_BUFFER_ALIGNMENT, offset);
-			ANKI_CHECK(
-				loader.storeVertexBuffer(i, data + offset, PtrSize(m_vertexBufferInfos[i].m_stride) * m_vertexCount));
-
-			offset += PtrSize(m_vertexBufferInfos[i].m_stride) * m_vertexCount;
+			const PtrSize size = PtrSize(m_vertexBufferInfos[i].m_stride) * m_vertexCount;
+
+			if(computeDensity && (posAttrib.m_buffIdx == i || uvAttrib.m_buffIdx == i))
+			{
+				DynamicArrayAuto<U8, PtrSize>& cpuBuffer =
+					(posAttrib.m_buffIdx == i) ? cpuPositionBuffer : cpuUvBuffer;
+				cpuBuffer.create(size);
+				ANKI_CHECK(loader.storeVertexBuffer(i, &cpuBuffer[0], size));
+				memcpy(data + offset, &cpuBuffer[0], size);
+			}
+			else
+			{
+				ANKI_CHECK(loader.storeVertexBuffer(i, data + offset, size));
+			}
+
+			offset += size;
 		}
 
 		ANKI_ASSERT(offset == m_vertexBuffersSize);
@@ -348,7 +392,66 @@ Error MeshResource::loadAsync(MeshBinaryLoader& loader) const
 	transferAlloc.release(handles[0], fence);
 	transferAlloc.release(handles[1], fence);
 
+	if(computeDensity)
+	{
+		// Positions and UVs might share a buffer
+		const DynamicArrayAuto<U8, PtrSize>& uvBuffer =
+			(posAttrib.m_buffIdx == uvAttrib.m_buffIdx) ? cpuPositionBuffer : cpuUvBuffer;
+
+		computeUvDensity(cpuIndices,
+						 ConstWeakArray<U8, PtrSize>(&cpuPositionBuffer[posAttrib.m_relativeOffset],
+													 cpuPositionBuffer.getSize() - posAttrib.m_relativeOffset),
+						 m_vertexBufferInfos[posAttrib.m_buffIdx].m_stride,
+						 ConstWeakArray<U8, PtrSize>(&uvBuffer[uvAttrib.m_relativeOffset],
+													 uvBuffer.getSize() - uvAttrib.m_relativeOffset),
+						 m_vertexBufferInfos[uvAttrib.m_buffIdx].m_stride);
+	}
+
 	return Error::NONE;
 }
 
+void MeshResource::computeUvDensity(ConstWeakArray<U8, PtrSize> indices, ConstWeakArray<U8, PtrSize> positions,
+									PtrSize positionStride, ConstWeakArray<U8, PtrSize> uvs, PtrSize uvStride)
+{
+	ANKI_TRACE_SCOPED_EVENT(RSRC_MESH_UV_DENSITY);
+
+	auto getIndex = [&](U32 i) -> U32 {
+		if(m_indexType == IndexType::U16)
+		{
+			return *reinterpret_cast<const U16*>(&indices[PtrSize(i) * sizeof(U16)]);
+		}
+		else
+		{
+			return *reinterpret_cast<const U32*>(&indices[PtrSize(i) * sizeof(U32)]);
+		}
+	};
+
+	// The ratio of the areas of all the triangles in UV space and in model space
+	F64 positionArea = 0.0;
+	F64 uvArea = 0.0;
+	for(U32 i = 0; i < m_indexCount; i += 3)
+	{
+		Array<Vec3, 3> p;
+		Array<Vec2, 3> uv;
+		for(U32 v = 0; v < 3; ++v)
+		{
+			const U32 idx = getIndex(i + v);
+			ANKI_ASSERT(idx < m_vertexCount);
+			memcpy(&p[v], &positions[idx * positionStride], sizeof(Vec3));
+			memcpy(&uv[v], &uvs[idx * uvStride], sizeof(Vec2));
+		}
+
+		positionArea += F64((p[1] - p[0]).cross(p[2] - p[0]).getLength()) / 2.0;
+
+		const Vec2 uvEdge0 = uv[1] - uv[0];
+		const Vec2 uvEdge1 = uv[2] - uv[0];
+		uvArea += F64(absolute(uvEdge0.x() * uvEdge1.y() - uvEdge0.y() * uvEdge1.x())) / 2.0;
+	}
+
+	if(positionArea > 0.0 && uvArea > 0.0)
+	{
+		m_uvDensity.store(F32(sqrt(uvArea / positionArea)));
+	}
+}
+
 } // end namespace anki
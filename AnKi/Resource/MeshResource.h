@@ -122,6 +122,14 @@ public:
 		return m_vertexBuffer;
 	}
 
+	/// The average length in UV0 space of a unit of length in model space. Multiplied by the size of a texture it gives
+	/// the texel density. Zero if it's unknown or the mesh hasn't finished loading.
+	/// @note It's thread-safe.
+	F32 getUvDensity() const
+	{
+		return m_uvDensity.load();
+	}
+
 private:
 	class LoadTask;
 	class LoadContext;
@@ -165,11 +173,16 @@ private:
 
 	Aabb m_aabb;
 
+	Atomic<F32> m_uvDensity = {0.0f};
+
 	// RT
 	AccelerationStructurePtr m_blas;
 	MeshGpuDescriptor m_meshGpuDescriptor;
 
-	Error loadAsync(MeshBinaryLoader& loader) const;
+	Error loadAsync(MeshBinaryLoader& loader);
+
+	void computeUvDensity(ConstWeakArray<U8, PtrSize> indices, ConstWeakArray<U8, PtrSize> positions,
+						  PtrSize positionStride, ConstWeakArray<U8, PtrSize> uvs, PtrSize uvStride);
 };
 /// @}
 
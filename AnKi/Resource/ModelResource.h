@@ -112,6 +112,14 @@ public:
 	/// Get information for rendering.
 	void getRenderingInfo(const RenderingKey& key, ModelRenderingInfo& inf) const;
 
+	/// Get the indices a LOD draws. They are the same as the ones getRenderingInfo() returns for that LOD.
+	void getIndexRange(U32 lod, U32& firstIndex, U32& indexCount) const
+	{
+		const U32 meshLod = min<U32>(lod, m_meshLodCount - 1);
+		firstIndex = m_indexBufferInfos[meshLod].m_firstIndex;
+		indexCount = m_indexBufferInfos[meshLod].m_indexCount;
+	}
+
 	/// Get the ray tracing info.
 	void getRayTracingInfo(const RenderingKey& key, ModelRayTracingInfo& info) const;
 
@@ -0,0 +1,146 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Resource/PakArchive.h>
+#include <AnKi/Util/Compression.h>
+#include <AnKi/Util/Hash.h>
+#include <AnKi/Util/Tracer.h>
+#include <algorithm>
+
+namespace anki {
+
+Error PakArchive::open(const CString& filename)
+{
+	ANKI_CHECK(m_file.open(filename));
+	m_contents = m_file.getContents();
+
+	// Header
+	if(m_contents.getSize() < sizeof(PakHeader))
+	{
+		ANKI_RESOURCE_LOGE("Archive is too small: %s", filename.cstr());
+		return Error::USER_DATA;
+	}
+
+	PakHeader header;
+	memcpy(&header, m_contents.getBegin(), sizeof(header));
+
+	if(memcmp(&header.m_magic[0], PAK_MAGIC, header.m_magic.getSize()) != 0)
+	{
+		ANKI_RESOURCE_LOGE("Wrong archive magic: %s", filename.cstr());
+		return Error::USER_DATA;
+	}
+
+	if(header.m_blockSize == 0)
+	{
+		ANKI_RESOURCE_LOGE("Wrong block size: %s", filename.cstr());
+		return Error::USER_DATA;
+	}
+
+	auto checkRange = [&](U64 offset, U64 size) -> Bool {
+		return offset <= m_contents.getSize() && size <= m_contents.getSize() - offset;
+	};
+
+	if(!checkRange(header.m_blocksOffset, U64(header.m_blockCount) * sizeof(PakBlock))
+	   || !checkRange(header.m_entriesOffset, U64(header.m_entryCount) * sizeof(PakEntry))
+	   || !checkRange(header.m_filenamesOffset, header.m_filenamesSize)
+	   || (header.m_blocksOffset % alignof(PakBlock)) != 0 || (header.m_entriesOffset % alignof(PakEntry)) != 0)
+	{
+		ANKI_RESOURCE_LOGE("Corrupted archive header: %s", filename.cstr());
+		return Error::USER_DATA;
+	}
+
+	// The tables are used in place
+	m_blockSize = header.m_blockSize;
+	m_blocks = ConstWeakArray<PakBlock>(
+		reinterpret_cast<const PakBlock*>(m_contents.getBegin() + header.m_blocksOffset), header.m_blockCount);
+	m_entries = ConstWeakArray<PakEntry>(
+		reinterpret_cast<const PakEntry*>(m_contents.getBegin() + header.m_entriesOffset), header.m_entryCount);
+	m_filenames = ConstWeakArray<U8, PtrSize>(m_contents.getBegin() + header.m_filenamesOffset, header.m_filenamesSize);
+
+	// Validate the entries once so reading doesn't have to
+	for(const PakEntry& entry : m_entries)
+	{
+		Bool valid = U64(entry.m_filenameOffset) + entry.m_filenameLength < m_filenames.getSize()
+					 && m_filenames[entry.m_filenameOffset + entry.m_filenameLength] == 0;
+
+		if(entry.m_codec == PakCodec::RAW)
+		{
+			valid = valid && checkRange(entry.m_offset, entry.m_size);
+		}
+		else if(entry.m_codec == PakCodec::LZ)
+		{
+			const U64 blockCount = (entry.m_size + m_blockSize - 1) / m_blockSize;
+			valid = valid && U64(entry.m_firstBlock) + blockCount <= m_blocks.getSize();
+
+			for(U64 i = 0; i < blockCount && valid; ++i)
+			{
+				const PakBlock& block = m_blocks[U32(entry.m_firstBlock + i)];
+				const U64 uncompressedSize = min<U64>(m_blockSize, entry.m_size - i * m_blockSize);
+				valid = block.m_uncompressedSize == uncompressedSize && block.m_compressedSize <= uncompressedSize
+						&& checkRange(block.m_offset, block.m_compressedSize);
+			}
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if(!valid)
+		{
+			ANKI_RESOURCE_LOGE("Corrupted archive entry: %s", filename.cstr());
+			return Error::USER_DATA;
+		}
+	}
+
+	return Error::NONE;
+}
+
+const PakEntry* PakArchive::findEntry(const CString& filename) const
+{
+	const PtrSize length = filename.getLength();
+	const U64 hash = computeHash(filename.cstr(), length);
+
+	// Binary search the first entry with that hash
+	const PakEntry* it =
+		std::lower_bound(m_entries.getBegin(), m_entries.getEnd(), hash, [](const PakEntry& entry, U64 hash) {
+			return entry.m_filenameHash < hash;
+		});
+
+	for(; it != m_entries.getEnd() && it->m_filenameHash == hash; ++it)
+	{
+		if(it->m_filenameLength == length && getEntryFilename(*it) == filename)
+		{
+			return it;
+		}
+	}
+
+	return nullptr;
+}
+
+Error PakArchive::readBlock(const PakEntry& entry, U32 block, WeakArray<U8, PtrSize> out, PtrSize& outSize) const
+{
+	ANKI_TRACE_SCOPED_EVENT(RSRC_FILE_READ);
+	ANKI_ASSERT(entry.m_codec == PakCodec::LZ);
+	ANKI_ASSERT(PtrSize(block) * m_blockSize < entry.m_size);
+
+	const PakBlock& b = m_blocks[entry.m_firstBlock + block];
+	ANKI_ASSERT(out.getSize() >= b.m_uncompressedSize);
+	const ConstWeakArray<U8, PtrSize> in(&m_contents[b.m_offset], b.m_compressedSize);
+	outSize = b.m_uncompressedSize;
+
+	if(b.m_compressedSize == b.m_uncompressedSize)
+	{
+		// Incompressible block, stored as is
+		memcpy(out.getBegin(), in.getBegin(), outSize);
+	}
+	else
+	{
+		ANKI_CHECK(decompressBuffer(in, WeakArray<U8, PtrSize>(out.getBegin(), outSize)));
+	}
+
+	return Error::NONE;
+}
+
+} // end namespace anki
@@ -0,0 +1,150 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Resource/Common.h>
+#include <AnKi/Util/File.h>
+#include <AnKi/Util/Atomic.h>
+#include <AnKi/Util/Ptr.h>
+
+namespace anki {
+
+/// @addtogroup resource
+/// @{
+
+static constexpr const char* PAK_MAGIC = "ANKIPAK1";
+
+/// The alignment of the data of the entries and of the tables inside a .ankipak.
+constexpr U32 PAK_ALIGNMENT = 16;
+
+/// How an entry of a .ankipak is stored.
+enum class PakCodec : U32
+{
+	RAW, ///< Stored as is. The data are contiguous.
+	LZ, ///< Split in blocks and each block compressed with compressBuffer().
+};
+
+/// The header of a .ankipak. The file layout is: header, data of the entries, blocks, entries, filenames.
+class PakHeader
+{
+public:
+	Array<U8, 8> m_magic;
+	U32 m_entryCount;
+	U32 m_blockCount;
+	U32 m_blockSize; ///< The uncompressed size of the blocks. The last block of an entry can be smaller.
+	U32 m_padding;
+	U64 m_blocksOffset; ///< Where the PakBlock array starts.
+	U64 m_entriesOffset; ///< Where the PakEntry array starts.
+	U64 m_filenamesOffset; ///< Where the filenames start. They are null terminated.
+	U64 m_filenamesSize;
+};
+static_assert(sizeof(PakHeader) == 56, "Should be packed");
+
+/// A file inside a .ankipak. The entries are sorted by m_filenameHash and then by filename.
+class PakEntry
+{
+public:
+	U64 m_filenameHash; ///< computeHash() of the filename without the null terminator.
+	U64 m_size; ///< Uncompressed size.
+	U64 m_offset; ///< Where the data start if the codec is PakCodec::RAW.
+	U32 m_filenameOffset; ///< Offset in the filenames.
+	U32 m_filenameLength;
+	U32 m_firstBlock; ///< The first PakBlock if the codec is PakCodec::LZ.
+	PakCodec m_codec;
+};
+static_assert(sizeof(PakEntry) == 40, "Should be packed");
+
+/// A compressed block of a PakEntry.
+class PakBlock
+{
+public:
+	U64 m_offset;
+	U32 m_compressedSize; ///< If it's equal to the uncompressed size the block is not compressed.
+	U32 m_uncompressedSize;
+};
+static_assert(sizeof(PakBlock) == 16, "Should be packed");
+
+/// A .ankipak archive. The archive is memory mapped and its table of contents is used in place so opening it is cheap.
+/// Finding a file is a binary search and reading it doesn't involve any system calls.
+class PakArchive
+{
+public:
+	PakArchive(GenericMemoryPoolAllocator<U8> alloc)
+		: m_alloc(alloc)
+	{
+	}
+
+	PakArchive(const PakArchive&) = delete; // Non-copyable
+
+	~PakArchive() = default;
+
+	PakArchive& operator=(const PakArchive&) = delete; // Non-copyable
+
+	Error open(const CString& filename);
+
+	/// Find a file. Returns nullptr if it's not there.
+	const PakEntry* findEntry(const CString& filename) const;
+
+	ConstWeakArray<PakEntry> getEntries() const
+	{
+		return m_entries;
+	}
+
+	CString getEntryFilename(const PakEntry& entry) const
+	{
+		return reinterpret_cast<const Char*>(&m_filenames[entry.m_filenameOffset]);
+	}
+
+	/// Get the data of an uncompressed entry.
+	ConstWeakArray<U8, PtrSize> getRawData(const PakEntry& entry) const
+	{
+		ANKI_ASSERT(entry.m_codec == PakCodec::RAW);
+		return ConstWeakArray<U8, PtrSize>((entry.m_size) ? &m_contents[entry.m_offset] : nullptr, entry.m_size);
+	}
+
+	U32 getBlockSize() const
+	{
+		return m_blockSize;
+	}
+
+	/// Decompress a single block of a compressed entry.
+	/// @param entry The entry.
+	/// @param block The index of the block relative to the entry's first block.
+	/// @param[out] out Where to write the block. It should be at least getBlockSize() big.
+	/// @param[out] outSize The uncompressed size of the block.
+	Error readBlock(const PakEntry& entry, U32 block, WeakArray<U8, PtrSize> out, PtrSize& outSize) const;
+
+	GenericMemoryPoolAllocator<U8> getAllocator() const
+	{
+		return m_alloc;
+	}
+
+	void retain() const
+	{
+		m_refcount.fetchAdd(1);
+	}
+
+	I32 release() const
+	{
+		return m_refcount.fetchSub(1);
+	}
+
+private:
+	GenericMemoryPoolAllocator<U8> m_alloc;
+	mutable Atomic<I32> m_refcount = {0};
+	MemoryMappedFile m_file;
+	ConstWeakArray<U8, PtrSize> m_contents;
+	ConstWeakArray<PakEntry> m_entries;
+	ConstWeakArray<PakBlock> m_blocks;
+	ConstWeakArray<U8, PtrSize> m_filenames;
+	U32 m_blockSize = 0;
+};
+
+/// PakArchive smart pointer.
+using PakArchivePtr = IntrusivePtr<PakArchive>;
+/// @}
+
+} // end namespace anki
@@ -57,6 +57,128 @@ public:
 	}
 };
 
+/// A file that all of its contents are in memory. The memory is either a memory mapped file or a copy of another file.
+class MemoryResourceFile final : public ResourceFile
+{
+public:
+	MemoryMappedFile m_mappedFile;
+	DynamicArray<U8, PtrSize> m_ownedData;
+	ConstWeakArray<U8, PtrSize> m_contents;
+	PtrSize m_pos = 0;
+
+	MemoryResourceFile(GenericMemoryPoolAllocator<U8> alloc)
+		: ResourceFile(alloc)
+	{
+	}
+
+	~MemoryResourceFile()
+	{
+		m_ownedData.destroy(getAllocator());
+	}
+
+	Error map(const CString& filename)
+	{
+		ANKI_CHECK(m_mappedFile.open(filename));
+		m_contents = m_mappedFile.getContents();
+		return Error::NONE;
+	}
+
+	Error readAll(ResourceFile& file)
+	{
+		const PtrSize size = file.getSize();
+		m_ownedData.create(getAllocator(), size);
+		ANKI_CHECK(file.read(m_ownedData.getBegin(), size));
+		m_contents = ConstWeakArray<U8, PtrSize>(m_ownedData.getBegin(), size);
+		return Error::NONE;
+	}
+
+	Error read(void* buff, PtrSize size) override
+	{
+		ANKI_TRACE_SCOPED_EVENT(RSRC_FILE_READ);
+		ConstWeakArray<U8, PtrSize> data;
+		ANKI_CHECK(readInPlace(size, data));
+		if(size)
+		{
+			memcpy(buff, data.getBegin(), size);
+		}
+		return Error::NONE;
+	}
+
+	Error readInPlace(PtrSize size, ConstWeakArray<U8, PtrSize>& out) override
+	{
+		if(m_pos + size > m_contents.getSize())
+		{
+			ANKI_RESOURCE_LOGE("Trying to read past the end of the file");
+			return Error::FILE_ACCESS;
+		}
+
+		out = ConstWeakArray<U8, PtrSize>((size) ? m_contents.getBegin() + m_pos : nullptr, size);
+		m_pos += size;
+		return Error::NONE;
+	}
+
+	Error readAllText(StringAuto& out) override
+	{
+		if(m_contents.getSize() == 0)
+		{
+			return Error::FUNCTION_FAILED;
+		}
+
+		out.create('?', m_contents.getSize());
+		memcpy(&out[0], m_contents.getBegin(), m_contents.getSize());
+		m_pos = m_contents.getSize();
+		return Error::NONE;
+	}
+
+	Error readU32(U32& u) override
+	{
+		// Assume machine and file have same endianness
+		return read(&u, sizeof(u));
+	}
+
+	Error readF32(F32& f) override
+	{
+		// Assume machine and file have same endianness
+		return read(&f, sizeof(f));
+	}
+
+	Error seek(PtrSize offset, FileSeekOrigin origin) override
+	{
+		PtrSize newPos;
+		switch(origin)
+		{
+		case FileSeekOrigin::BEGINNING:
+			newPos = offset;
+			break;
+		case FileSeekOrigin::CURRENT:
+			newPos = m_pos + offset;
+			break;
+		default:
+			ANKI_ASSERT(origin == FileSeekOrigin::END);
+			newPos = m_contents.getSize() + offset;
+		}
+
+		if(newPos > m_contents.getSize())
+		{
+			ANKI_RESOURCE_LOGE("Trying to seek past the end of the file");
+			return Error::FILE_ACCESS;
+		}
+
+		m_pos = newPos;
+		return Error::NONE;
+	}
+
+	PtrSize getSize() const override
+	{
+		return m_contents.getSize();
+	}
+
+	ConstWeakArray<U8, PtrSize> getContents() const override
+	{
+		return m_contents;
+	}
+};
+
 /// ZIP file
 class ZipResourceFile final : public ResourceFile
 {
@@ -192,6 +314,158 @@ public:
 	}
 };
 
+/// A file inside an .ankipak archive.
+class PakResourceFile final : public ResourceFile
+{
+public:
+	PakArchivePtr m_pak;
+	const PakEntry* m_entry = nullptr;
+	PtrSize m_pos = 0;
+
+	/// The last decompressed block. Used when the entry is compressed.
+	DynamicArray<U8, PtrSize> m_block;
+	PtrSize m_blockSize = 0;
+	U32 m_blockIdx = MAX_U32;
+
+	PakResourceFile(GenericMemoryPoolAllocator<U8> alloc)
+		: ResourceFile(alloc)
+	{
+	}
+
+	~PakResourceFile()
+	{
+		m_block.destroy(getAllocator());
+	}
+
+	Error read(void* buff, PtrSize size) override
+	{
+		if(m_pos + size > m_entry->m_size)
+		{
+			ANKI_RESOURCE_LOGE("Trying to read past the end of the file");
+			return Error::FILE_ACCESS;
+		}
+
+		if(m_entry->m_codec == PakCodec::RAW)
+		{
+			ANKI_TRACE_SCOPED_EVENT(RSRC_FILE_READ);
+			if(size)
+			{
+				memcpy(buff, &m_pak->getRawData(*m_entry)[m_pos], size);
+			}
+			m_pos += size;
+			return Error::NONE;
+		}
+
+		// Compressed, decompress the blocks that contain the range
+		U8* out = static_cast<U8*>(buff);
+		const PtrSize blockSize = m_pak->getBlockSize();
+		while(size > 0)
+		{
+			const U32 blockIdx = U32(m_pos / blockSize);
+			if(blockIdx != m_blockIdx)
+			{
+				if(m_block.getSize() == 0)
+				{
+					m_block.create(getAllocator(), blockSize);
+				}
+
+				m_blockIdx = MAX_U32;
+				ANKI_CHECK(m_pak->readBlock(*m_entry, blockIdx, WeakArray<U8, PtrSize>(m_block), m_blockSize));
+				m_blockIdx = blockIdx;
+			}
+
+			const PtrSize offsetInBlock = m_pos - PtrSize(blockIdx) * blockSize;
+			const PtrSize toCopy = min(size, m_blockSize - offsetInBlock);
+			memcpy(out, &m_block[offsetInBlock], toCopy);
+
+			out += toCopy;
+			m_pos += toCopy;
+			size -= toCopy;
+		}
+
+		return Error::NONE;
+	}
+
+	Error readInPlace(PtrSize size, ConstWeakArray<U8, PtrSize>& out) override
+	{
+		if(m_entry->m_codec != PakCodec::RAW)
+		{
+			return ResourceFile::readInPlace(size, out);
+		}
+
+		if(m_pos + size > m_entry->m_size)
+		{
+			ANKI_RESOURCE_LOGE("Trying to read past the end of the file");
+			return Error::FILE_ACCESS;
+		}
+
+		out = ConstWeakArray<U8, PtrSize>((size) ? &m_pak->getRawData(*m_entry)[m_pos] : nullptr, size);
+		m_pos += size;
+		return Error::NONE;
+	}
+
+	Error readAllText(StringAuto& out) override
+	{
+		if(m_entry->m_size == 0)
+		{
+			return Error::FUNCTION_FAILED;
+		}
+
+		out.create('?', m_entry->m_size);
+		m_pos = 0;
+		return read(&out[0], m_entry->m_size);
+	}
+
+	Error readU32(U32& u) override
+	{
+		// Assume machine and file have same endianness
+		return read(&u, sizeof(u));
+	}
+
+	Error readF32(F32& f) override
+	{
+		// Assume machine and file have same endianness
+		return read(&f, sizeof(f));
+	}
+
+	Error seek(PtrSize offset, FileSeekOrigin origin) override
+	{
+		// Seeking is free, reading will decompress only the blocks it needs
+		PtrSize newPos;
+		switch(origin)
+		{
+		case FileSeekOrigin::BEGINNING:
+			newPos = offset;
+			break;
+		case FileSeekOrigin::CURRENT:
+			newPos = m_pos + offset;
+			break;
+		default:
+			ANKI_ASSERT(origin == FileSeekOrigin::END);
+			newPos = m_entry->m_size + offset;
+		}
+
+		if(newPos > m_entry->m_size)
+		{
+			ANKI_RESOURCE_LOGE("Trying to seek past the end of the file");
+			return Error::FILE_ACCESS;
+		}
+
+		m_pos = newPos;
+		return Error::NONE;
+	}
+
+	PtrSize getSize() const override
+	{
+		return m_entry->m_size;
+	}
+
+	ConstWeakArray<U8, PtrSize> getContents() const override
+	{
+		return (m_entry->m_codec == PakCodec::RAW) ? m_pak->getRawData(*m_entry) : ConstWeakArray<U8, PtrSize>();
+	}
+};
+
 ResourceFilesystem::~ResourceFilesystem()
 {
 	for(Path& p : m_paths)
@@ -206,6 +480,8 @@ ResourceFilesystem::~ResourceFilesystem()
 
 Error ResourceFilesystem::init(const ConfigSet& config, const CString& cacheDir)
 {
+	m_memoryMapFiles = config.getRsrcMemoryMapFiles();
+
 	StringListAuto paths(m_alloc);
 	paths.splitString(config.getRsrcDataPaths(), ':');
 
@@ -253,6 +529,42 @@ Error ResourceFilesystem::init(const ConfigSet& config, const CString& cacheDir)
 	return Error::NONE;
 }
 
+Error ResourceFilesystem::openLooseFile(const CString& filename, ResourceFile*& rfile)
+{
+	if(m_memoryMapFiles)
+	{
+		MemoryResourceFile* file = m_alloc.newInstance<MemoryResourceFile>(m_alloc);
+		rfile = file;
+		ANKI_CHECK(file->map(filename));
+	}
+	else
+	{
+		CResourceFile* file = m_alloc.newInstance<CResourceFile>(m_alloc);
+		rfile = file;
+		ANKI_CHECK(file->m_file.open(filename, FileOpenFlag::READ));
+	}
+
+	return Error::NONE;
+}
+
+Error ResourceFilesystem::openFileInMemory(const ResourceFilename& filename, ResourceFilePtr& file,
+										   ConstWeakArray<U8, PtrSize>& contents)
+{
+	ANKI_CHECK(openFile(filename, file));
+
+	if(file->getContents().getSize() == 0 && file->getSize() > 0)
+	{
+		// Not memory mapped, read it
+		MemoryResourceFile* memFile = m_alloc.newInstance<MemoryResourceFile>(m_alloc);
+		ResourceFilePtr memFilePtr(memFile);
+		ANKI_CHECK(memFile->readAll(*file));
+		file = std::move(memFilePtr);
+	}
+
+	contents = file->getContents();
+	return Error::NONE;
+}
+
 void ResourceFilesystem::addCachePath(const CString& path)
 {
 	Path p;
@@ -266,6 +578,7 @@ Error ResourceFilesystem::addNewPath(const CString& filepath, const StringListAu
 {
 	U32 fileCount = 0; // Count files manually because it's slower to get that number from the list
 	static const CString extension(".ankizip");
+	static const CString pakExtension(".ankipak");
 
 	auto rejectPath = [&](CString p) -> Bool {
 		for(const String& s : excludedStrings)
@@ -325,6 +638,20 @@ Error ResourceFilesystem::addNewPath(const CString& filepath, const StringListAu
 
 		path.m_isArchive = true;
 	}
+	else if((pos = filepath.find(pakExtension)) != CString::NPOS
+			&& pos == filepath.getLength() - pakExtension.getLength())
+	{
+		// It's a pak archive, the table of contents is loaded once. The excluded strings were taken into account when
+		// the archive was packed
+		path.m_pak.reset(m_alloc.newInstance<PakArchive>(m_alloc));
+		ANKI_CHECK(path.m_pak->open(filepath));
+
+		for(const PakEntry& entry : path.m_pak->getEntries())
+		{
+			path.m_files.pushBackSprintf(m_alloc, "%s", path.m_pak->getEntryFilename(entry).cstr());
+			++fileCount;
+		}
+	}
 	else
 	{
 		// It's simple directory
@@ -399,11 +726,19 @@ Error ResourceFilesystem::openFileInternal(const ResourceFilename& filename, Res
 			if(fileExists(newFname.toCString()))
 			{
 				// In cache
-
-				CResourceFile* file = m_alloc.newInstance<CResourceFile>(m_alloc);
+				ANKI_CHECK(openLooseFile(newFname, rfile));
+			}
+		}
+		else if(p.m_pak)
+		{
+			// In pak archive. Binary search, no need to iterate the files
+			const PakEntry* entry = p.m_pak->findEntry(filename);
+			if(entry)
+			{
+				PakResourceFile* file = m_alloc.newInstance<PakResourceFile>(m_alloc);
 				rfile = file;
-
-				ANKI_CHECK(file->m_file.open(&newFname[0], FileOpenFlag::READ));
+				file->m_pak = p.m_pak;
+				file->m_entry = entry;
 			}
 		}
 		else
@@ -430,9 +765,7 @@ Error ResourceFilesystem::openFileInternal(const ResourceFilename& filename, Res
 					StringAuto newFname(m_alloc);
 					newFname.sprintf("%s/%s", &p.m_path[0], &filename[0]);
 
-					CResourceFile* file = m_alloc.newInstance<CResourceFile>(m_alloc);
-					rfile = file;
-					ANKI_CHECK(file->m_file.open(newFname, FileOpenFlag::READ));
+					ANKI_CHECK(openLooseFile(newFname, rfile));
 
 #if 0
 					printf("Opening asset %s\n", &newFname[0]);
@@ -450,16 +783,13 @@ Error ResourceFilesystem::openFileInternal(const ResourceFilename& filename, Res
 	// File not found? On Win/Linux try to find it outside the resource dirs. On Android try the archive
 	if(!rfile)
 	{
+#if ANKI_OS_ANDROID
 		CResourceFile* file = m_alloc.newInstance<CResourceFile>(m_alloc);
 		rfile = file;
+		ANKI_CHECK(file->m_file.open(filename, FileOpenFlag::READ | FileOpenFlag::SPECIAL));
+#else
+		ANKI_CHECK(openLooseFile(filename, rfile));
 
-		FileOpenFlag openFlags = FileOpenFlag::READ;
-#if ANKI_OS_ANDROID
-		openFlags |= FileOpenFlag::SPECIAL;
-#endif
-		ANKI_CHECK(file->m_file.open(filename, openFlags));
-
-#if !ANKI_OS_ANDROID
 		ANKI_RESOURCE_LOGW(
 			"Loading resource outside the resource paths/archives. This is only OK for tools and debugging: %s",
 			filename.cstr());
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <AnKi/Resource/Common.h>
+#include <AnKi/Resource/PakArchive.h>
 #include <AnKi/Util/String.h>
 #include <AnKi/Util/StringList.h>
 #include <AnKi/Util/File.h>
@@ -56,6 +57,21 @@ public:
 	/// Get the size of the file.
 	virtual PtrSize getSize() const = 0;
 
+	/// Get the contents of the whole file without copying them. It's empty if the file is not in memory.
+	/// @see ResourceFilesystem::openFileInMemory
+	virtual ConstWeakArray<U8, PtrSize> getContents() const
+	{
+		return ConstWeakArray<U8, PtrSize>();
+	}
+
+	/// Same as read() but instead of copying it returns a pointer to the file's memory. It's valid for as long as the
+	/// file is alive. Only works if the file is in memory.
+	virtual Error readInPlace([[maybe_unused]] PtrSize size, [[maybe_unused]] ConstWeakArray<U8, PtrSize>& out)
+	{
+		ANKI_ASSERT(!"Not in memory");
+		return Error::FUNCTION_FAILED;
+	}
+
 	void retain() const
 	{
 		m_refcount.fetchAdd(1);
@@ -99,6 +115,11 @@ public:
 	/// Search the path list to find the file. Then open the file for reading. It's thread-safe.
 	Error openFile(const ResourceFilename& filename, ResourceFilePtr& file);
 
+	/// Same as openFile() but the whole file will be in memory and @a contents will point to it. Loose files are memory
+	/// mapped so there are no copies involved. Archived files are read in memory. It's thread-safe.
+	Error openFileInMemory(const ResourceFilename& filename, ResourceFilePtr& file,
+						   ConstWeakArray<U8, PtrSize>& contents);
+
 	/// Iterate all the filenames from all paths provided.
 	template<typename TFunc>
 	Error iterateAllFilenames(TFunc func) const
@@ -121,6 +142,7 @@ private:
 	public:
 		StringList m_files; ///< Files inside the directory.
 		String m_path; ///< A directory or an archive.
+		PakArchivePtr m_pak; ///< Set if it's an .ankipak archive.
 		Bool m_isArchive = false;
 		Bool m_isCache = false;
 
@@ -139,6 +161,7 @@ private:
 		{
 			m_files = std::move(b.m_files);
 			m_path = std::move(b.m_path);
+			m_pak = std::move(b.m_pak);
 			m_isArchive = b.m_isArchive;
 			m_isCache = b.m_isCache;
 			return *this;
@@ -148,12 +171,15 @@ private:
 	GenericMemoryPoolAllocator<U8> m_alloc;
 	List<Path> m_paths;
 	String m_cacheDir;
+	Bool m_memoryMapFiles = true;
 
 	/// Add a filesystem path or an archive. The path is read-only.
 	Error addNewPath(const CString& path, const StringListAuto& excludedStrings);
 
 	Error openFileInternal(const ResourceFilename& filename, ResourceFile*& rfile);
 
+	Error openLooseFile(const CString& filename, ResourceFile*& rfile);
+
 	void addCachePath(const CString& path);
 };
 /// @}
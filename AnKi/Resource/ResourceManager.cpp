@@ -6,6 +6,7 @@
 #include <AnKi/Resource/ResourceManager.h>
 #include <AnKi/Resource/AsyncLoader.h>
 #include <AnKi/Resource/ShaderProgramResourceSystem.h>
+#include <AnKi/Resource/TextureStreamer.h>
 #include <AnKi/Resource/AnimationResource.h>
 #include <AnKi/Util/Logger.h>
 #include <AnKi/Core/ConfigSet.h>
@@ -34,8 +35,20 @@ ResourceManager::~ResourceManager()
 	ANKI_RESOURCE_LOGI("Destroying resource manager");
 
 	m_alloc.deleteInstance(m_asyncLoader);
+
+	if(m_textureStreamer)
+	{
+		m_gr->setMemoryPressureCallback(nullptr, nullptr);
+	}
+	m_alloc.deleteInstance(m_textureStreamer);
 	m_alloc.deleteInstance(m_shaderProgramSystem);
 	m_alloc.deleteInstance(m_transferGpuAlloc);
+
+	for(ThreadTempAllocator* tmpAlloc : m_tmpAllocs)
+	{
+		m_alloc.deleteInstance(tmpAlloc);
+	}
+	m_tmpAllocs.destroy(m_alloc);
 }
 
 Error ResourceManager::init(ResourceManagerInitInfo& init)
@@ -49,7 +62,8 @@ Error ResourceManager::init(ResourceManagerInitInfo& init)
 	m_vertexMem = init.m_vertexMemory;
 	m_alloc = ResourceAllocator<U8>(init.m_allocCallback, init.m_allocCallbackData, "Resources");
 
-	m_tmpAlloc = TempResourceAllocator<U8>(init.m_allocCallback, init.m_allocCallbackData, 10_MB);
+	m_allocCallback = init.m_allocCallback;
+	m_allocCallbackData = init.m_allocCallbackData;
 
 	// Init type resource managers
 #define ANKI_INSTANTIATE_RESOURCE(rsrc_, ptr_) TypeResourceManager<rsrc_>::init(m_alloc);
@@ -58,9 +72,16 @@ Error ResourceManager::init(ResourceManagerInitInfo& init)
 #undef ANKI_INSTANTIATE_RESOURCE
 #undef ANKI_INSTANSIATE_RESOURCE_DELIMITER
 
-	// Init the thread
+	// Init the threads
 	m_asyncLoader = m_alloc.newInstance<AsyncLoader>();
-	m_asyncLoader->init(m_alloc);
+	m_asyncLoader->init(m_alloc, m_config->getRsrcAsyncLoaderThreadCount());
+
+	m_textureStreamer = m_alloc.newInstance<TextureStreamer>(this);
+	m_gr->setMemoryPressureCallback(
+		[](PtrSize bytesToFree, void* userData) {
+			static_cast<TextureStreamer*>(userData)->notifyMemoryPressure(bytesToFree);
+		},
+		m_textureStreamer);
 
 	m_transferGpuAlloc = m_alloc.newInstance<TransferGpuAllocator>();
 	ANKI_CHECK(m_transferGpuAlloc->init(m_config->getRsrcTransferScratchMemorySize(), m_gr, m_alloc));
@@ -72,6 +93,32 @@ Error ResourceManager::init(ResourceManagerInitInfo& init)
 	return Error::NONE;
 }
 
+TempResourceAllocator<U8>& ResourceManager::getTempAllocator()
+{
+	const ThreadId tid = Thread::getCurrentThreadId();
+
+	{
+		RLockGuard<RWMutex> lock(m_tmpAllocsMtx);
+		for(ThreadTempAllocator* tmpAlloc : m_tmpAllocs)
+		{
+			if(tmpAlloc->m_tid == tid)
+			{
+				return tmpAlloc->m_alloc;
+			}
+		}
+	}
+
+	// 1st time this thread asks, create one. No-one else can create the allocator of this thread so no need to search
+	// again
+	ThreadTempAllocator* tmpAlloc = m_alloc.newInstance<ThreadTempAllocator>();
+	tmpAlloc->m_tid = tid;
+	tmpAlloc->m_alloc = TempResourceAllocator<U8>(m_allocCallback, m_allocCallbackData, 10_MB);
+
+	WLockGuard<RWMutex> lock(m_tmpAllocsMtx);
+	m_tmpAllocs.emplaceBack(m_alloc, tmpAlloc);
+	return tmpAlloc->m_alloc;
+}
+
 U64 ResourceManager::getAsyncTaskCompletedCount() const
 {
 	return m_asyncLoader->getCompletedTaskCount();
@@ -83,26 +130,25 @@ Error ResourceManager::loadResource(const CString& filename, ResourcePtr<T>& out
 	ANKI_ASSERT(!out.isCreated() && "Already loaded");
 
 	Error err = Error::NONE;
-	++m_loadRequestCount;
+	m_loadRequestCount.fetchAdd(1);
 
 	T* const other = findLoadedResource<T>(filename);
 
 	if(other)
 	{
-		// Found
+		// Found. Decrement because findLoadedResource() incremented the refcount
 		out.reset(other);
+		other->release();
 	}
 	else
 	{
-		// Allocate ptr
-		T* ptr = m_alloc.newInstance<T>(this);
-		ANKI_ASSERT(ptr->getRefcount() == 0);
-
-		// Increment the refcount in that case where async jobs increment it and decrement it in the scope of a load()
-		ptr->retain();
+		// Allocate ptr. Hold it with a ResourcePtr because async jobs might retain it inside load() and they should be
+		// the ones deleting it if the load fails or if another thread loads the same resource in the meantime
+		ResourcePtr<T> ptr(m_alloc.newInstance<T>(this));
+		ptr->setFilename(filename);
 
 		// Populate the ptr. Use a block to cleanup temp_pool allocations
-		auto& pool = m_tmpAlloc.getMemoryPool();
+		auto& pool = getTempAllocator().getMemoryPool();
 
 		{
 			[[maybe_unused]] const U allocsCountBefore = pool.getAllocationCount();
@@ -111,15 +157,13 @@ Error ResourceManager::loadResource(const CString& filename, ResourcePtr<T>& out
 			if(err)
 			{
 				ANKI_RESOURCE_LOGE("Failed to load resource: %s", &filename[0]);
-				m_alloc.deleteInstance(ptr);
 				return err;
 			}
 
 			ANKI_ASSERT(pool.getAllocationCount() == allocsCountBefore && "Forgot to deallocate");
 		}
 
-		ptr->setFilename(filename);
-		ptr->setUuid(++m_uuid);
+		ptr->setUuid(m_uuid.fetchAdd(1) + 1);
 
 		// Reset the memory pool if no-one is using it.
 		// NOTE: Check because resources load other resources
@@ -129,11 +173,17 @@ Error ResourceManager::loadResource(const CString& filename, ResourcePtr<T>& out
 		}
 
 		// Register resource
-		registerResource(ptr);
-		out.reset(ptr);
+		T* const raced = registerResource(ptr.get());
+		if(ANKI_UNLIKELY(raced))
+		{
+			// Some other thread loaded the same resource in the meantime. Use that one. Ours will be deleted when its
+			// async jobs drop their references
+			out.reset(raced);
+			raced->release();
+			return err;
+		}
 
-		// Decrement because of the increment happened a few lines above
-		ptr->release();
+		out = std::move(ptr);
 	}
 
 	return err;
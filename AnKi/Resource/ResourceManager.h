@@ -6,9 +6,10 @@
 #pragma once
 
 #include <AnKi/Resource/TransferGpuAllocator.h>
-#include <AnKi/Util/List.h>
+#include <AnKi/Util/FlatHashMap.h>
 #include <AnKi/Util/Functions.h>
 #include <AnKi/Util/String.h>
+#include <AnKi/Util/Thread.h>
 
 namespace anki {
 
@@ -22,11 +23,14 @@ class ResourceManagerModel;
 class ShaderCompilerCache;
 class ShaderProgramResourceSystem;
 class VertexGpuMemoryPool;
+class TextureStreamer;
 
 /// @addtogroup resource
 /// @{
 
-/// Manage resources of a certain type
+/// Manage resources of a certain type. The resources are indexed by their filename. The keys point to the filename
+/// stored in the resource itself so there are no string copies.
+/// @note All methods are thread-safe.
 template<typename Type>
 class TypeResourceManager
 {
@@ -41,50 +45,88 @@ protected:
 		m_ptrs.destroy(m_alloc);
 	}
 
+	/// Find a resource and increase its refcount.
+	/// @return The resource or nullptr if it's not loaded or if it's about to be deleted.
 	Type* findLoadedResource(const CString& filename)
 	{
-		auto it = find(filename);
-		return (it != m_ptrs.end()) ? *it : nullptr;
+		RLockGuard<RWMutex> lock(m_mtx);
+		auto it = m_ptrs.find(filename);
+		return (it != m_ptrs.getEnd() && (*it)->tryRetain()) ? *it : nullptr;
 	}
 
-	void registerResource(Type* ptr)
+	/// Register a resource. If another thread registered a resource with the same filename in the meantime the other
+	/// resource will be returned with its refcount increased.
+	/// @return nullptr if the resource was registered or the other resource.
+	Type* registerResource(Type* ptr)
 	{
-		ANKI_ASSERT(find(ptr->getFilename()) == m_ptrs.getEnd());
-		m_ptrs.pushBack(m_alloc, ptr);
+		WLockGuard<RWMutex> lock(m_mtx);
+
+		auto it = m_ptrs.find(ptr->getFilename());
+		if(it != m_ptrs.getEnd())
+		{
+			if((*it)->tryRetain())
+			{
+				return *it;
+			}
+
+			// The old one is about to be deleted, replace it. Its unregisterResource() will leave the new one alone
+			m_ptrs.erase(m_alloc, it);
+		}
+
+		m_ptrs.emplace(m_alloc, ptr->getFilename(), ptr);
+		return nullptr;
 	}
 
 	void unregisterResource(Type* ptr)
 	{
-		auto it = find(ptr->getFilename());
-		ANKI_ASSERT(it != m_ptrs.end());
-		m_ptrs.erase(m_alloc, it);
-	}
+		WLockGuard<RWMutex> lock(m_mtx);
 
-	void init(ResourceAllocator<U8> alloc)
-	{
-		m_alloc = alloc;
+		// Not found if the resource failed to load or if it lost a loading race with another thread
+		auto it = m_ptrs.find(ptr->getFilename());
+		if(it != m_ptrs.getEnd() && *it == ptr)
+		{
+			m_ptrs.erase(m_alloc, it);
+		}
 	}
 
-private:
-	using Container = List<Type*>;
-
-	ResourceAllocator<U8> m_alloc;
-	Container m_ptrs;
-
-	typename Container::Iterator find(const CString& filename)
+	/// Unregister a resource if the caller holds its only reference. The check happens under the lock so
+	/// findLoadedResource() can't pick up the resource at the same time. Async tasks use it to decide if the resource
+	/// they load is abandoned.
+	/// @return True if the caller held the only reference. The resource can't be found after that.
+	Bool unregisterResourceIfUnused(Type* ptr)
 	{
-		typename Container::Iterator it;
+		WLockGuard<RWMutex> lock(m_mtx);
 
-		for(it = m_ptrs.getBegin(); it != m_ptrs.getEnd(); ++it)
+		// The only reference can't be duplicated by others so it's safe to test it under the lock
+		if(ptr->getRefcount() > 1)
 		{
-			if((*it)->getFilename() == filename)
-			{
-				break;
-			}
+			return false;
 		}
 
-		return it;
+		auto it = m_ptrs.find(ptr->getFilename());
+		if(it != m_ptrs.getEnd() && *it == ptr)
+		{
+			m_ptrs.erase(m_alloc, it);
+		}
+
+		return true;
+	}
+
+	U32 getLoadedResourceCount() const
+	{
+		RLockGuard<RWMutex> lock(m_mtx);
+		return m_ptrs.getSize();
 	}
+
+	void init(ResourceAllocator<U8> alloc)
+	{
+		m_alloc = alloc;
+	}
+
+private:
+	ResourceAllocator<U8> m_alloc;
+	FlatHashMap<CString, Type*> m_ptrs;
+	mutable RWMutex m_mtx;
 };
 
 class ResourceManagerInitInfo
@@ -124,9 +166,17 @@ public:
 	Error init(ResourceManagerInitInfo& init);
 
 	/// Load a resource.
+	/// @note It's thread-safe.
 	template<typename T>
 	Error loadResource(const CString& filename, ResourcePtr<T>& out, Bool async = true);
 
+	/// Get the number of loaded resources of a type.
+	template<typename T>
+	U32 getLoadedResourceCount() const
+	{
+		return TypeResourceManager<T>::getLoadedResourceCount();
+	}
+
 	// Internals:
 
 	ANKI_INTERNAL ResourceAllocator<U8>& getAllocator()
@@ -134,10 +184,9 @@ public:
 		return m_alloc;
 	}
 
-	ANKI_INTERNAL TempResourceAllocator<U8>& getTempAllocator()
-	{
-		return m_tmpAlloc;
-	}
+	/// Get the temp allocator of the calling thread. Every thread gets its own so a thread can reset it without
+	/// racing with the loads of the other threads.
+	ANKI_INTERNAL TempResourceAllocator<U8>& getTempAllocator();
 
 	ANKI_INTERNAL GrManager& getGrManager()
 	{
@@ -169,9 +218,9 @@ public:
 	}
 
 	template<typename T>
-	ANKI_INTERNAL void registerResource(T* ptr)
+	ANKI_INTERNAL T* registerResource(T* ptr)
 	{
-		TypeResourceManager<T>::registerResource(ptr);
+		return TypeResourceManager<T>::registerResource(ptr);
 	}
 
 	template<typename T>
@@ -180,6 +229,13 @@ public:
 		TypeResourceManager<T>::unregisterResource(ptr);
 	}
 
+	/// @copydoc TypeResourceManager::unregisterResourceIfUnused
+	template<typename T>
+	ANKI_INTERNAL Bool unregisterResourceIfUnused(T* ptr)
+	{
+		return TypeResourceManager<T>::unregisterResourceIfUnused(ptr);
+	}
+
 	ANKI_INTERNAL AsyncLoader& getAsyncLoader()
 	{
 		return *m_asyncLoader;
@@ -188,12 +244,18 @@ public:
 	/// Get the number of times loadResource() was called.
 	ANKI_INTERNAL U64 getLoadingRequestCount() const
 	{
-		return m_loadRequestCount;
+		return m_loadRequestCount.load();
 	}
 
 	/// Get the total number of completed async tasks.
 	ANKI_INTERNAL U64 getAsyncTaskCompletedCount() const;
 
+	TextureStreamer& getTextureStreamer()
+	{
+		ANKI_ASSERT(m_textureStreamer);
+		return *m_textureStreamer;
+	}
+
 	/// Return the container of program libraries.
 	const ShaderProgramResourceSystem& getShaderProgramResourceSystem() const
 	{
@@ -213,18 +275,29 @@ public:
 	}
 
 private:
+	class ThreadTempAllocator
+	{
+	public:
+		ThreadId m_tid;
+		TempResourceAllocator<U8> m_alloc;
+	};
+
 	GrManager* m_gr = nullptr;
 	PhysicsWorld* m_physics = nullptr;
 	ResourceFilesystem* m_fs = nullptr;
 	ConfigSet* m_config = nullptr;
 	ResourceAllocator<U8> m_alloc;
-	TempResourceAllocator<U8> m_tmpAlloc;
+	AllocAlignedCallback m_allocCallback = nullptr;
+	void* m_allocCallbackData = nullptr;
+	DynamicArray<ThreadTempAllocator*> m_tmpAllocs;
+	RWMutex m_tmpAllocsMtx;
 	AsyncLoader* m_asyncLoader = nullptr; ///< Async loading thread
 	ShaderProgramResourceSystem* m_shaderProgramSystem = nullptr;
 	VertexGpuMemoryPool* m_vertexMem = nullptr;
-	U64 m_uuid = 0;
-	U64 m_loadRequestCount = 0;
+	Atomic<U64> m_uuid = {0};
+	Atomic<U64> m_loadRequestCount = {0};
 	TransferGpuAllocator* m_transferGpuAlloc = nullptr;
+	TextureStreamer* m_textureStreamer = nullptr;
 };
 /// @}
 
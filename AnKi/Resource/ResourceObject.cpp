@@ -35,6 +35,12 @@ Error ResourceObject::openFile(const CString& filename, ResourceFilePtr& file)
 	return m_manager->getFilesystem().openFile(filename, file);
 }
 
+Error ResourceObject::openFileInMemory(const CString& filename, ResourceFilePtr& file)
+{
+	ConstWeakArray<U8, PtrSize> contents;
+	return m_manager->getFilesystem().openFileInMemory(filename, file, contents);
+}
+
 Error ResourceObject::openFileReadAllText(const CString& filename, StringAuto& text)
 {
 	// Load file
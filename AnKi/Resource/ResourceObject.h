@@ -47,6 +47,22 @@ public:
 		return m_refcount.fetchSub(1);
 	}
 
+	/// Increment the refcount only if it's not zero. A zero refcount means that the resource is about to be deleted.
+	/// @return True if the refcount was incremented.
+	Bool tryRetain() const
+	{
+		I32 count = m_refcount.load();
+		while(count > 0)
+		{
+			if(m_refcount.compareExchange(count, count + 1))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	I32 getRefcount() const
 	{
 		return m_refcount.load();
@@ -83,6 +99,9 @@ public:
 
 	ANKI_INTERNAL Error openFile(const ResourceFilename& filename, ResourceFilePtr& file);
 
+	/// @see ResourceFilesystem::openFileInMemory
+	ANKI_INTERNAL Error openFileInMemory(const ResourceFilename& filename, ResourceFilePtr& file);
+
 	ANKI_INTERNAL Error openFileReadAllText(const ResourceFilename& filename, StringAuto& file);
 
 	ANKI_INTERNAL Error openFileParseXml(const ResourceFilename& filename, XmlDocument& xml);
@@ -0,0 +1,272 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Resource/TextureStreamer.h>
+#include <AnKi/Resource/ImageResource.h>
+#include <AnKi/Resource/ResourceManager.h>
+#include <AnKi/Core/ConfigSet.h>
+#include <AnKi/Util/Tracer.h>
+#include <algorithm>
+
+namespace anki {
+
+namespace {
+
+class StreamingCandidate
+{
+public:
+	ImageResource* m_image;
+	U32 m_size;
+	U64 m_lastRequestFrame;
+};
+
+} // end anonymous namespace
+
+TextureStreamer::TextureStreamer(ResourceManager* manager)
+	: m_manager(manager)
+{
+	ANKI_ASSERT(manager);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	ANKI_ASSERT(m_images.getSize() == 0 && "Forgot to delete some images");
+	m_images.destroy(m_manager->getAllocator());
+}
+
+void TextureStreamer::registerImage(ImageResource* image)
+{
+	ANKI_ASSERT(image && image->isStreamed());
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(image->m_streaming.m_indexInStreamer == MAX_U32);
+	image->m_streaming.m_indexInStreamer = m_images.getSize();
+	m_images.emplaceBack(m_manager->getAllocator(), image);
+}
+
+void TextureStreamer::unregisterImage(ImageResource* image)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	const U32 idx = image->m_streaming.m_indexInStreamer;
+	ANKI_ASSERT(idx < m_images.getSize() && m_images[idx] == image);
+
+	// Swap with the last
+	m_images[idx] = m_images.getBack();
+	m_images[idx]->m_streaming.m_indexInStreamer = idx;
+	m_images.popBack(m_manager->getAllocator());
+
+	image->m_streaming.m_indexInStreamer = MAX_U32;
+}
+
+PtrSize TextureStreamer::computeTextureMemory(const ImageResource& image, U32 size)
+{
+	// Both the full size and the size are powers of two so scaling keeps the aspect ratio
+	const UVec2 fullSize = image.m_streaming.m_fullSize;
+	const U32 fullMaxSize = max(fullSize.x(), fullSize.y());
+	ANKI_ASSERT(size <= fullMaxSize);
+	const FormatInfo formatInfo = getFormatInfo(image.getTexture()->getFormat());
+	const U32 width = max(fullSize.x() / (fullMaxSize / size), max<U32>(1, formatInfo.m_blockWidth));
+	const U32 height = max(fullSize.y() / (fullMaxSize / size), max<U32>(1, formatInfo.m_blockHeight));
+
+	// Add a third for the rest of the mip chain
+	const PtrSize firstMip = computeSurfaceSize(width, height, image.getTexture()->getFormat());
+	return firstMip + firstMip / 3;
+}
+
+void TextureStreamer::update()
+{
+	ANKI_TRACE_SCOPED_EVENT(RSRC_TEXTURE_STREAMING);
+	++m_frame;
+
+	// Keep the images alive while working on them. The images that are in the process of being deleted are skipped
+	DynamicArrayAuto<ImageResourcePtr> images(m_manager->getAllocator());
+	{
+		LockGuard<Mutex> lock(m_mtx);
+		images.resizeStorage(m_images.getSize());
+		for(ImageResource* image : m_images)
+		{
+			if(image->tryRetain())
+			{
+				images.emplaceBack(image);
+				image->release();
+			}
+		}
+	}
+
+	// Only look for images to relocate when the GrManager wants to release some memory
+	const Bool relocate = m_manager->getGrManager().getStats().m_evacuatingMemoryChunkCount > 0;
+
+	DynamicArrayAuto<StreamingCandidate> upgrades(m_manager->getAllocator());
+	DynamicArrayAuto<StreamingCandidate> evictions(m_manager->getAllocator());
+	DynamicArrayAuto<StreamingCandidate> pressureEvictions(m_manager->getAllocator());
+	DynamicArrayAuto<ImageResource*> relocations(m_manager->getAllocator());
+	PtrSize projectedMemory = 0;
+	PtrSize inFlightReleasedMemory = 0;
+	m_residentMemory = 0;
+
+	for(ImageResourcePtr& imagePtr : images)
+	{
+		ImageResource& image = *imagePtr;
+		ImageResource::Streaming& streaming = image.m_streaming;
+
+		image.swapStreamedTexture();
+		m_residentMemory += computeTextureMemory(image, streaming.m_residentSize);
+
+		// The requests of the previous frame
+		const U32 requestedSize = streaming.m_requestedSize.exchange(0);
+		if(requestedSize > 0)
+		{
+			streaming.m_lastRequestFrame = m_frame;
+			streaming.m_desiredSize = clamp(nextPowerOfTwo(requestedSize), streaming.m_minSize, streaming.m_maxSize);
+		}
+		else if(streaming.m_lastRequestFrame == 0)
+		{
+			// Never requested. Someone that doesn't go through the visibility tests uses it so load it fully
+			streaming.m_desiredSize = streaming.m_maxSize;
+		}
+		else if(m_frame - streaming.m_lastRequestFrame > FRAMES_BEFORE_EVICTION)
+		{
+			// Hasn't been visible for a while
+			streaming.m_desiredSize = streaming.m_minSize;
+		}
+
+		if(streaming.m_taskInFlight)
+		{
+			// Count the memory of both the textures
+			projectedMemory += computeTextureMemory(image, max(streaming.m_residentSize, streaming.m_pendingSize));
+
+			if(streaming.m_pendingSize < streaming.m_residentSize)
+			{
+				inFlightReleasedMemory += computeTextureMemory(image, streaming.m_residentSize)
+										  - computeTextureMemory(image, streaming.m_pendingSize);
+			}
+			continue;
+		}
+
+		projectedMemory += computeTextureMemory(image, streaming.m_residentSize);
+
+		if(streaming.m_disabled)
+		{
+			continue;
+		}
+
+		if(streaming.m_desiredSize > streaming.m_residentSize)
+		{
+			*upgrades.emplaceBack() = {&image, streaming.m_desiredSize, streaming.m_lastRequestFrame};
+		}
+		else if(streaming.m_desiredSize < streaming.m_residentSize)
+		{
+			*evictions.emplaceBack() = {&image, streaming.m_desiredSize, streaming.m_lastRequestFrame};
+		}
+		else
+		{
+			if(streaming.m_residentSize > streaming.m_minSize)
+			{
+				// If memory is tight it can lose a mip
+				*pressureEvictions.emplaceBack() = {&image, streaming.m_residentSize / 2, streaming.m_lastRequestFrame};
+			}
+
+			if(relocate && image.getTexture()->wantsRelocation())
+			{
+				relocations.emplaceBack(&image);
+			}
+		}
+	}
+
+	// React to the memory pressure of the device by shrinking the budget for a while. Don't count the memory that is
+	// about to be released
+	const PtrSize pressure = m_memoryPressure.exchange(0);
+	if(pressure > inFlightReleasedMemory && m_frame - m_lastPressureFrame > FRAMES_BETWEEN_PRESSURE_REACTIONS)
+	{
+		const PtrSize bytesToFree = pressure - inFlightReleasedMemory;
+		m_pressureBudget = min(m_pressureBudget, projectedMemory - min(projectedMemory, bytesToFree));
+		m_lastPressureFrame = m_frame;
+		ANKI_RESOURCE_LOGW("Device memory pressure. Will limit the texture streaming budget to %zuMB",
+						   m_pressureBudget / PtrSize(1_MB));
+	}
+	else if(m_pressureBudget != MAX_PTR_SIZE && m_frame - m_lastPressureFrame > FRAMES_BEFORE_PRESSURE_RELIEF)
+	{
+		m_pressureBudget = MAX_PTR_SIZE;
+	}
+
+	const PtrSize budget = min(m_manager->getConfig().getRsrcTextureStreamingBudget(), m_pressureBudget);
+
+	if(projectedMemory > budget)
+	{
+		for(const StreamingCandidate& c : pressureEvictions)
+		{
+			*evictions.emplaceBack() = c;
+		}
+	}
+
+	// Upgrade the most recently requested first and evict the least recently requested first
+	std::sort(upgrades.getBegin(), upgrades.getEnd(), [](const StreamingCandidate& a, const StreamingCandidate& b) {
+		return (a.m_lastRequestFrame != b.m_lastRequestFrame) ? a.m_lastRequestFrame > b.m_lastRequestFrame
+															  : a.m_size > b.m_size;
+	});
+
+	std::sort(evictions.getBegin(), evictions.getEnd(), [](const StreamingCandidate& a, const StreamingCandidate& b) {
+		return a.m_lastRequestFrame < b.m_lastRequestFrame;
+	});
+
+	U32 taskCount = 0;
+	U32 evictionIdx = 0;
+	auto evict = [&]() {
+		const StreamingCandidate& c = evictions[evictionIdx++];
+		projectedMemory -= computeTextureMemory(*c.m_image, c.m_image->m_streaming.m_residentSize)
+						   - computeTextureMemory(*c.m_image, c.m_size);
+		c.m_image->submitStreamingTask(c.m_size, AsyncLoaderPriority::LOW);
+		++taskCount;
+	};
+
+	for(const StreamingCandidate& c : upgrades)
+	{
+		const PtrSize extraMemory = computeTextureMemory(*c.m_image, c.m_size)
+									- computeTextureMemory(*c.m_image, c.m_image->m_streaming.m_residentSize);
+
+		while(projectedMemory + extraMemory > budget && evictionIdx < evictions.getSize()
+			  && taskCount < MAX_TASKS_PER_UPDATE)
+		{
+			evict();
+		}
+
+		if(projectedMemory + extraMemory > budget || taskCount >= MAX_TASKS_PER_UPDATE)
+		{
+			break;
+		}
+
+		projectedMemory += extraMemory;
+		c.m_image->submitStreamingTask(c.m_size, (c.m_lastRequestFrame == m_frame) ? AsyncLoaderPriority::HIGH
+																				   : AsyncLoaderPriority::LOW);
+		++taskCount;
+	}
+
+	// The budget might have shrunk, keep evicting
+	while(projectedMemory > budget && evictionIdx < evictions.getSize() && taskCount < MAX_TASKS_PER_UPDATE)
+	{
+		evict();
+	}
+
+	// Stream the same mips again. The new texture will be allocated elsewhere and the old memory will be released
+	U32 relocationCount = 0;
+	for(ImageResource* image : relocations)
+	{
+		if(taskCount >= MAX_TASKS_PER_UPDATE || relocationCount >= MAX_RELOCATIONS_PER_UPDATE)
+		{
+			break;
+		}
+
+		if(image->m_streaming.m_taskInFlight)
+		{
+			// Evicted above
+			continue;
+		}
+
+		image->submitStreamingTask(image->m_streaming.m_residentSize, AsyncLoaderPriority::LOW);
+		++taskCount;
+		++relocationCount;
+	}
+}
+
+} // end namespace anki
@@ -0,0 +1,84 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Resource/Common.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/Thread.h>
+
+namespace anki {
+
+/// @addtogroup resource
+/// @{
+
+/// Decides how many mips the streamed images will have. Images that are requested (see
+/// ImageResource::requestStreamingSize()) get more mips and images that haven't been requested for a while lose mips
+/// when the texture memory budget runs out. Images that were never requested (UI, sky etc) are fully loaded. It also
+/// shrinks the budget when the device runs out of memory and moves images out of the memory blocks that the GrManager
+/// wants to release.
+class TextureStreamer
+{
+public:
+	TextureStreamer(ResourceManager* manager);
+
+	TextureStreamer(const TextureStreamer&) = delete; // Non-copyable
+
+	~TextureStreamer();
+
+	TextureStreamer& operator=(const TextureStreamer&) = delete; // Non-copyable
+
+	/// Swap the textures that finished streaming, read the requests of the previous frame and submit new streaming
+	/// tasks. Call it once per frame, when no one is rendering.
+	void update();
+
+	/// The memory of the streamed textures that are used for rendering.
+	PtrSize getResidentMemory() const
+	{
+		return m_residentMemory;
+	}
+
+	ANKI_INTERNAL void registerImage(ImageResource* image);
+
+	ANKI_INTERNAL void unregisterImage(ImageResource* image);
+
+	/// The device memory is about to run out. It will be handled in the next update().
+	/// @note It's thread-safe.
+	ANKI_INTERNAL void notifyMemoryPressure(PtrSize bytesToFree)
+	{
+		m_memoryPressure.max(bytesToFree);
+	}
+
+private:
+	/// Give a few frames to an image before it becomes a candidate for eviction.
+	static constexpr U64 FRAMES_BEFORE_EVICTION = 60;
+
+	/// Don't stall the async loader with too much streaming work.
+	static constexpr U32 MAX_TASKS_PER_UPDATE = 8;
+
+	/// Relocations are not urgent, they shouldn't eat the streaming tasks.
+	static constexpr U32 MAX_RELOCATIONS_PER_UPDATE = 2;
+
+	/// After reacting to memory pressure give some time to the memory to be released before reacting again.
+	static constexpr U64 FRAMES_BETWEEN_PRESSURE_REACTIONS = 10;
+
+	/// Frames without memory pressure before the budget is restored.
+	static constexpr U64 FRAMES_BEFORE_PRESSURE_RELIEF = 600;
+
+	ResourceManager* m_manager;
+	DynamicArray<ImageResource*> m_images;
+	Mutex m_mtx;
+	U64 m_frame = 0;
+	PtrSize m_residentMemory = 0;
+
+	Atomic<PtrSize> m_memoryPressure = {0};
+	PtrSize m_pressureBudget = MAX_PTR_SIZE;
+	U64 m_lastPressureFrame = 0;
+
+	static PtrSize computeTextureMemory(const ImageResource& image, U32 size);
+};
+/// @}
+
+} // end namespace anki
@@ -8,6 +8,7 @@
 #include <AnKi/Scene/SceneGraph.h>
 #include <AnKi/Resource/ImageResource.h>
 #include <AnKi/Resource/ResourceManager.h>
+#include <AnKi/Core/ConfigSet.h>
 
 namespace anki {
 
@@ -19,6 +20,7 @@ GlobalIlluminationProbeComponent::GlobalIlluminationProbeComponent(SceneNode* no
 	, m_uuid(node->getSceneGraph().getNewUuid())
 	, m_markedForRendering(false)
 	, m_shapeDirty(true)
+	, m_dynamic(false)
 {
 	if(node->getSceneGraph().getResourceManager().loadResource("EngineAssets/GiProbe.ankitex", m_debugImage))
 	{
@@ -26,6 +28,42 @@ GlobalIlluminationProbeComponent::GlobalIlluminationProbeComponent(SceneNode* no
 	}
 }
 
+GlobalIlluminationProbeComponent::~GlobalIlluminationProbeComponent()
+{
+	m_bakedImageFilename.destroy(m_node->getAllocator());
+}
+
+Error GlobalIlluminationProbeComponent::setBakedImageFilename(CString filename)
+{
+	m_bakedImage.reset(nullptr);
+	m_bakedImageFilename.destroy(m_node->getAllocator());
+	if(filename.isEmpty())
+	{
+		return Error::NONE;
+	}
+
+	m_bakedImageFilename.create(m_node->getAllocator(), filename);
+
+	// When baking the image will be written so don't load it
+	SceneGraph& scene = m_node->getSceneGraph();
+	if(!scene.getConfig().getRProbeBakeDirectory().isEmpty())
+	{
+		return Error::NONE;
+	}
+
+	// Load it synchronously. The renderer samples it directly as soon as the probe is visible
+	ANKI_CHECK(scene.getResourceManager().loadResource(filename, m_bakedImage, false));
+
+	if(m_bakedImage->getTexture()->getTextureType() != TextureType::_3D)
+	{
+		ANKI_SCENE_LOGE("The baked image of a GI probe should be a volume: %s", filename.cstr());
+		m_bakedImage.reset(nullptr);
+		return Error::USER_DATA;
+	}
+
+	return Error::NONE;
+}
+
 void GlobalIlluminationProbeComponent::draw(RenderQueueDrawContext& ctx) const
 {
 	const Aabb box = getAabbWorldSpace();
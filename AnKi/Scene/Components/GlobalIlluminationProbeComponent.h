@@ -7,6 +7,7 @@
 
 #include <AnKi/Scene/Components/SceneComponent.h>
 #include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Resource/ImageResource.h>
 #include <AnKi/Collision/Aabb.h>
 
 namespace anki {
@@ -22,6 +23,8 @@ class GlobalIlluminationProbeComponent : public SceneComponent
 public:
 	GlobalIlluminationProbeComponent(SceneNode* node);
 
+	~GlobalIlluminationProbeComponent();
+
 	/// Set the bounding box size.
 	void setBoxVolumeSize(const Vec3& sizeXYZ)
 	{
@@ -64,6 +67,25 @@ public:
 		m_fadeDistance = max(0.0f, dist);
 	}
 
+	/// Dynamic probes are rendered at runtime. The rest use the image of the offline bake if there is one.
+	void setDynamic(Bool dynamic)
+	{
+		m_dynamic = dynamic;
+	}
+
+	Bool getDynamic() const
+	{
+		return m_dynamic;
+	}
+
+	/// Set the .ankitex of the offline bake. See ReflectionProbeComponent::setBakedImageFilename.
+	Error setBakedImageFilename(CString filename);
+
+	CString getBakedImageFilename() const
+	{
+		return m_bakedImageFilename.toCString();
+	}
+
 	/// Returns true if it's marked for update this frame.
 	Bool getMarkedForRendering() const
 	{
@@ -96,6 +118,9 @@ public:
 		el.m_totalCellCount = m_cellCounts.x() * m_cellCounts.y() * m_cellCounts.z();
 		el.m_cellSizes = (m_halfBoxSize * 2.0f) / Vec3(m_cellCounts);
 		el.m_fadeDistance = m_fadeDistance;
+		el.m_bakedTexture = (m_bakedImage.isCreated() && !m_dynamic) ? m_bakedImage->getTexture().get() : nullptr;
+		el.m_bakedImageFilename =
+			(!m_bakedImageFilename.isEmpty() && !m_dynamic) ? m_bakedImageFilename.toCString().cstr() : nullptr;
 	}
 
 	void setWorldPosition(const Vec3& pos)
@@ -122,8 +147,11 @@ private:
 	F32 m_fadeDistance = 0.2f;
 	Bool m_markedForRendering : 1;
 	Bool m_shapeDirty : 1;
+	Bool m_dynamic : 1;
 
 	ImageResourcePtr m_debugImage;
+	ImageResourcePtr m_bakedImage;
+	String m_bakedImageFilename;
 
 	static void giProbeQueueElementFeedbackCallback(Bool fillRenderQueuesOnNextFrame, void* userData,
 													const Vec4& eyeWorldPosition)
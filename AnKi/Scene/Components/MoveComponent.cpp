@@ -14,6 +14,7 @@ MoveComponent::MoveComponent(SceneNode* node)
 	: SceneComponent(node, getStaticClassId())
 	, m_ignoreLocalTransform(false)
 	, m_ignoreParentTransform(false)
+	, m_updatedOnce(false)
 {
 	markForUpdate();
 }
@@ -25,6 +26,14 @@ MoveComponent::~MoveComponent()
 Error MoveComponent::update(SceneComponentUpdateInfo& info, Bool& updated)
 {
 	updated = updateWorldTransform(*info.m_node);
+
+	// Report an update when the node becomes static so whatever depends on isStatic() will notice
+	if(!updated && m_lastMoveTimestamp != 0
+	   && info.m_node->getGlobalTimestamp() - m_lastMoveTimestamp == FRAMES_BEFORE_STATIC)
+	{
+		updated = true;
+	}
+
 	return Error::NONE;
 }
 
@@ -69,6 +78,12 @@ Bool MoveComponent::updateWorldTransform(SceneNode& node)
 
 		// Now it's a good time to cleanse parent
 		m_markedForUpdate = false;
+
+		if(m_updatedOnce)
+		{
+			m_lastMoveTimestamp = node.getGlobalTimestamp();
+		}
+		m_updatedOnce = true;
 	}
 
 	// If this is dirty then make children dirty as well. Don't walk the whole tree because you will re-walk it later
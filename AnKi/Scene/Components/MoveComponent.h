@@ -91,6 +91,14 @@ public:
 		return m_prevWTrf;
 	}
 
+	/// Check if the world transform didn't change for a while. Nodes that never moved after their world transform was
+	/// first computed are static and so are nodes that stopped moving. Static nodes can be cached.
+	/// @param crntTimestamp The current global timestamp.
+	Bool isStatic(Timestamp crntTimestamp) const
+	{
+		return m_lastMoveTimestamp == 0 || crntTimestamp - m_lastMoveTimestamp >= FRAMES_BEFORE_STATIC;
+	}
+
 	Error update(SceneComponentUpdateInfo& info, Bool& updated) override;
 
 	/// @name Mess with the local transform
@@ -154,6 +162,13 @@ private:
 	Bool m_markedForUpdate : 1;
 	Bool m_ignoreLocalTransform : 1;
 	Bool m_ignoreParentTransform : 1;
+	Bool m_updatedOnce : 1;
+
+	/// When the world transform last changed after it was first computed. Zero if it never did.
+	Timestamp m_lastMoveTimestamp = 0;
+
+	/// Number of frames without moving until a node that moved is static again.
+	static constexpr Timestamp FRAMES_BEFORE_STATIC = 60;
 
 	void markForUpdate()
 	{
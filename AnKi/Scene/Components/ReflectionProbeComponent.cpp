@@ -8,6 +8,7 @@
 #include <AnKi/Scene/SceneNode.h>
 #include <AnKi/Resource/ResourceManager.h>
 #include <AnKi/Resource/ImageResource.h>
+#include <AnKi/Core/ConfigSet.h>
 
 namespace anki {
 
@@ -19,6 +20,7 @@ ReflectionProbeComponent::ReflectionProbeComponent(SceneNode* node)
 	, m_uuid(node->getSceneGraph().getNewUuid())
 	, m_markedForRendering(false)
 	, m_markedForUpdate(true)
+	, m_dynamic(false)
 {
 	if(node->getSceneGraph().getResourceManager().loadResource("EngineAssets/Mirror.ankitex", m_debugImage))
 	{
@@ -28,6 +30,38 @@ ReflectionProbeComponent::ReflectionProbeComponent(SceneNode* node)
 
 ReflectionProbeComponent::~ReflectionProbeComponent()
 {
+	m_bakedImageFilename.destroy(m_node->getAllocator());
+}
+
+Error ReflectionProbeComponent::setBakedImageFilename(CString filename)
+{
+	m_bakedImage.reset(nullptr);
+	m_bakedImageFilename.destroy(m_node->getAllocator());
+	if(filename.isEmpty())
+	{
+		return Error::NONE;
+	}
+
+	m_bakedImageFilename.create(m_node->getAllocator(), filename);
+
+	// When baking the image will be written so don't load it
+	SceneGraph& scene = m_node->getSceneGraph();
+	if(!scene.getConfig().getRProbeBakeDirectory().isEmpty())
+	{
+		return Error::NONE;
+	}
+
+	// Load it synchronously. The renderer copies it when the probe comes in view and it has to be there
+	ANKI_CHECK(scene.getResourceManager().loadResource(filename, m_bakedImage, false));
+
+	if(m_bakedImage->getTexture()->getTextureType() != TextureType::CUBE)
+	{
+		ANKI_SCENE_LOGE("The baked image of a reflection probe should be a cube: %s", filename.cstr());
+		m_bakedImage.reset(nullptr);
+		return Error::USER_DATA;
+	}
+
+	return Error::NONE;
 }
 
 void ReflectionProbeComponent::draw(RenderQueueDrawContext& ctx) const
@@ -7,6 +7,7 @@
 
 #include <AnKi/Scene/Components/SceneComponent.h>
 #include <AnKi/Renderer/RenderQueue.h>
+#include <AnKi/Resource/ImageResource.h>
 #include <AnKi/Collision/Aabb.h>
 
 namespace anki {
@@ -57,6 +58,26 @@ public:
 		return m_markedForRendering;
 	}
 
+	/// Dynamic probes are rendered at runtime. The rest use the image of the offline bake if there is one.
+	void setDynamic(Bool dynamic)
+	{
+		m_dynamic = dynamic;
+	}
+
+	Bool getDynamic() const
+	{
+		return m_dynamic;
+	}
+
+	/// Set the .ankitex of the offline bake. It's loaded and used instead of rendering the probe unless the probe is
+	/// dynamic. When baking (see RProbeBakeDirectory) the renderer writes the probe to that filename instead.
+	Error setBakedImageFilename(CString filename);
+
+	CString getBakedImageFilename() const
+	{
+		return m_bakedImageFilename.toCString();
+	}
+
 	void setupReflectionProbeQueueElement(ReflectionProbeQueueElement& el) const
 	{
 		el.m_feedbackCallback = reflectionProbeQueueElementFeedbackCallback;
@@ -66,6 +87,9 @@ public:
 		el.m_aabbMin = -m_halfSize + m_worldPos;
 		el.m_aabbMax = m_halfSize + m_worldPos;
 		el.m_textureArrayIndex = MAX_U32;
+		el.m_bakedTexture = (m_bakedImage.isCreated() && !m_dynamic) ? m_bakedImage->getTexture().get() : nullptr;
+		el.m_bakedImageFilename =
+			(!m_bakedImageFilename.isEmpty() && !m_dynamic) ? m_bakedImageFilename.toCString().cstr() : nullptr;
 		el.m_debugDrawCallback = [](RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData) {
 			ANKI_ASSERT(userData.getSize() == 1);
 			static_cast<const ReflectionProbeComponent*>(userData[0])->draw(ctx);
@@ -87,8 +111,11 @@ private:
 	Vec3 m_halfSize = Vec3(1.0f);
 	Bool m_markedForRendering : 1;
 	Bool m_markedForUpdate : 1;
+	Bool m_dynamic : 1;
 
 	ImageResourcePtr m_debugImage;
+	ImageResourcePtr m_bakedImage;
+	String m_bakedImageFilename;
 
 	static void reflectionProbeQueueElementFeedbackCallback(Bool fillRenderQueuesOnNextFrame, void* userData)
 	{
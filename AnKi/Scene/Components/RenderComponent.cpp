@@ -5,6 +5,7 @@
 
 #include <AnKi/Scene/Components/RenderComponent.h>
 #include <AnKi/Scene/SceneNode.h>
+#include <AnKi/Scene/Components/SpatialComponent.h>
 #include <AnKi/Resource/ImageResource.h>
 #include <AnKi/Resource/ResourceManager.h>
 #include <AnKi/Util/Logger.h>
@@ -14,6 +15,36 @@ namespace anki {
 
 ANKI_SCENE_COMPONENT_STATICS(RenderComponent)
 
+void RenderComponent::setFlags(RenderComponentFlag flags)
+{
+	if(flags != m_flags)
+	{
+		m_flags = flags;
+		markSpatialForUpdate();
+	}
+}
+
+void RenderComponent::initRayTracing(FillRayTracingInstanceQueueElementCallback callback, const void* userData)
+{
+	const Bool supportedRayTracing = getSupportsRayTracing();
+	m_rtCallback = callback;
+	m_rtCallbackUserData = userData;
+
+	if(supportedRayTracing != getSupportsRayTracing())
+	{
+		markSpatialForUpdate();
+	}
+}
+
+void RenderComponent::markSpatialForUpdate()
+{
+	SpatialComponent* spatialc = m_node->tryGetFirstComponentOfType<SpatialComponent>();
+	if(spatialc)
+	{
+		spatialc->markForUpdate();
+	}
+}
+
 void RenderComponent::allocateAndSetupUniforms(const MaterialResourcePtr& mtl, const RenderQueueDrawContext& ctx,
 											   ConstWeakArray<Mat3x4> transforms, ConstWeakArray<Mat3x4> prevTransforms,
 											   StagingGpuMemoryPool& alloc)
@@ -47,6 +78,34 @@ void RenderComponent::allocateAndSetupUniforms(const MaterialResourcePtr& mtl, c
 		}
 	}
 
+	allocateAndSetupLocalUniforms(mtl, ctx, alloc);
+}
+
+void RenderComponent::allocateAndSetupUniforms(const MaterialResourcePtr& mtl, const RenderQueueDrawContext& ctx,
+											   ConstWeakArray<U32> gpuSceneIndices, StagingGpuMemoryPool& alloc)
+{
+	ANKI_ASSERT(gpuSceneIndices.getSize() > 0 && gpuSceneIndices.getSize() <= MAX_INSTANCE_COUNT);
+
+	CommandBufferPtr cmdb = ctx.m_commandBuffer;
+
+	StagingGpuMemoryToken token;
+	U32* indices = static_cast<U32*>(
+		alloc.allocateFrame(gpuSceneIndices.getSizeInBytes(), StagingGpuMemoryType::STORAGE, token));
+	memcpy(indices, &gpuSceneIndices[0], gpuSceneIndices.getSizeInBytes());
+
+	cmdb->bindStorageBuffer(MATERIAL_SET_LOCAL, MATERIAL_BINDING_RENDERABLE_GPU_VIEW_INDICES, token.m_buffer,
+							token.m_offset, token.m_range);
+
+	allocateAndSetupLocalUniforms(mtl, ctx, alloc);
+}
+
+void RenderComponent::allocateAndSetupLocalUniforms(const MaterialResourcePtr& mtl, const RenderQueueDrawContext& ctx,
+													StagingGpuMemoryPool& alloc)
+{
+	CommandBufferPtr cmdb = ctx.m_commandBuffer;
+
+	const U32 set = MATERIAL_SET_LOCAL;
+
 	// Local uniforms
 	const U32 localUniformsUboSize = U32(mtl->getPrefilledLocalUniforms().getSizeInBytes());
 
@@ -68,7 +127,9 @@ void RenderComponent::allocateAndSetupUniforms(const MaterialResourcePtr& mtl, c
 		{
 		case ShaderVariableDataType::U32:
 		{
-			const U32 val = mvar.getValue<U32>();
+			// Streamed images change their bindless index so don't use the cached value
+			const U32 val = (mvar.isBindlessTexture()) ? mvar.getValue<ImageResourcePtr>()->getBindlessTextureIndex()
+													   : mvar.getValue<U32>();
 			memcpy(localUniformsBegin + mvar.getOffsetInLocalUniforms(), &val, sizeof(val));
 			break;
 		}
@@ -35,6 +35,7 @@ class RenderComponent : public SceneComponent
 public:
 	RenderComponent(SceneNode* node)
 		: SceneComponent(node, getStaticClassId())
+		, m_node(node)
 	{
 	}
 
@@ -48,13 +49,13 @@ public:
 		return m_flags;
 	}
 
-	void setFlags(RenderComponentFlag flags)
-	{
-		m_flags = flags;
-	}
+	void setFlags(RenderComponentFlag flags);
 
+	/// Set the flags and remember the material to forward the texture streaming requests.
 	void setFlagsFromMaterial(const MaterialResourcePtr& mtl)
 	{
+		m_mtl = mtl.get();
+
 		RenderComponentFlag flags = !!(mtl->getRenderingTechniques() & RenderingTechniqueBit::FORWARD)
 										? RenderComponentFlag::FORWARD_SHADING
 										: RenderComponentFlag::NONE;
@@ -62,6 +63,12 @@ public:
 		setFlags(flags);
 	}
 
+	/// Remember the mesh to compute the texel density of the texture streaming requests.
+	void setMesh(const MeshResourcePtr& mesh)
+	{
+		m_mesh = mesh.get();
+	}
+
 	void initRaster(RenderQueueDrawCallback callback, const void* userData, U64 mergeKey)
 	{
 		ANKI_ASSERT(callback != nullptr);
@@ -72,10 +79,18 @@ public:
 		m_mergeKey = mergeKey;
 	}
 
-	void initRayTracing(FillRayTracingInstanceQueueElementCallback callback, const void* userData)
+	void initRayTracing(FillRayTracingInstanceQueueElementCallback callback, const void* userData);
+
+	/// If true the component has a GpuSceneInstance so the visibility won't push it to the render queues that the GPU
+	/// visibility draws.
+	void setDrawnByGpuScene(Bool drawnByGpuScene)
+	{
+		m_drawnByGpuScene = drawnByGpuScene;
+	}
+
+	Bool getDrawnByGpuScene() const
 	{
-		m_rtCallback = callback;
-		m_rtCallbackUserData = userData;
+		return m_drawnByGpuScene;
 	}
 
 	void setupRenderableQueueElement(RenderableQueueElement& el) const
@@ -101,18 +116,46 @@ public:
 		return m_rtCallback != nullptr;
 	}
 
+	/// The material that was given in setFlagsFromMaterial(). Might be nullptr.
+	const MaterialResource* getMaterial() const
+	{
+		return m_mtl;
+	}
+
+	/// The mesh that was given in setMesh(). Might be nullptr.
+	const MeshResource* getMesh() const
+	{
+		return m_mesh;
+	}
+
 	/// Helper function.
 	static void allocateAndSetupUniforms(const MaterialResourcePtr& mtl, const RenderQueueDrawContext& ctx,
 										 ConstWeakArray<Mat3x4> transforms, ConstWeakArray<Mat3x4> prevTransforms,
 										 StagingGpuMemoryPool& alloc);
 
+	/// Helper function. Same as above but for renderables that keep their RenderableGpuView in the GPU scene.
+	static void allocateAndSetupUniforms(const MaterialResourcePtr& mtl, const RenderQueueDrawContext& ctx,
+										 ConstWeakArray<U32> gpuSceneIndices, StagingGpuMemoryPool& alloc);
+
+	/// Helper function. Same as above but it doesn't bind the per instance data. Used by the drawcalls that the GPU
+	/// visibility builds, they bind the indices of the instances themselves.
+	static void allocateAndSetupLocalUniforms(const MaterialResourcePtr& mtl, const RenderQueueDrawContext& ctx,
+											  StagingGpuMemoryPool& alloc);
+
 private:
+	SceneNode* m_node;
 	RenderQueueDrawCallback m_callback = nullptr;
 	const void* m_userData = nullptr;
 	U64 m_mergeKey = MAX_U64;
 	FillRayTracingInstanceQueueElementCallback m_rtCallback = nullptr;
 	const void* m_rtCallbackUserData = nullptr;
+	const MaterialResource* m_mtl = nullptr; ///< Weak pointer, the owner of the component holds a reference.
+	const MeshResource* m_mesh = nullptr; ///< Weak pointer, the owner of the component holds a reference.
 	RenderComponentFlag m_flags = RenderComponentFlag::NONE;
+	Bool m_drawnByGpuScene = false;
+
+	/// The flags and the ray tracing support are cached in the CullingDatabase, re-cache them.
+	void markSpatialForUpdate();
 };
 /// @}
 
@@ -6,6 +6,20 @@
 #include <AnKi/Scene/Components/SpatialComponent.h>
 #include <AnKi/Scene/SceneNode.h>
 #include <AnKi/Scene/SceneGraph.h>
+#include <AnKi/Scene/Components/RenderComponent.h>
+#include <AnKi/Scene/Components/LightComponent.h>
+#include <AnKi/Scene/Components/LensFlareComponent.h>
+#include <AnKi/Scene/Components/ReflectionProbeComponent.h>
+#include <AnKi/Scene/Components/DecalComponent.h>
+#include <AnKi/Scene/Components/FogDensityComponent.h>
+#include <AnKi/Scene/Components/GlobalIlluminationProbeComponent.h>
+#include <AnKi/Scene/Components/GenericGpuComputeJobComponent.h>
+#include <AnKi/Scene/Components/UiComponent.h>
+#include <AnKi/Scene/Components/SkyboxComponent.h>
+#include <AnKi/Scene/Components/MoveComponent.h>
+#include <AnKi/Scene/Components/SkinComponent.h>
+#include <AnKi/Scene/Components/ParticleEmitterComponent.h>
+#include <AnKi/Scene/Components/GpuParticleEmitterComponent.h>
 
 namespace anki {
 
@@ -22,6 +36,8 @@ SpatialComponent::SpatialComponent(SceneNode* node)
 	ANKI_ASSERT(node);
 	m_octreeInfo.m_userData = this;
 	setAabbWorldSpace(Aabb(Vec3(-1.0f), Vec3(1.0f)));
+
+	m_cullingIdx = node->getSceneGraph().getCullingDatabase().allocateEntry(this);
 }
 
 SpatialComponent::~SpatialComponent()
@@ -31,6 +47,8 @@ SpatialComponent::~SpatialComponent()
 		m_node->getSceneGraph().getOctree().remove(m_octreeInfo);
 	}
 
+	m_node->getSceneGraph().getCullingDatabase().freeEntry(m_cullingIdx, m_node->getGlobalTimestamp());
+
 	m_convexHullPoints.destroy(m_node->getAllocator());
 }
 
@@ -90,6 +108,8 @@ Error SpatialComponent::update([[maybe_unused]] SceneComponentUpdateInfo& info,
 			m_node->getSceneGraph().getOctree().placeAlwaysVisible(&m_octreeInfo);
 		}
 
+		updateCullingDatabase();
+
 		m_markedForUpdate = false;
 		m_placed = true;
 	}
@@ -99,4 +119,73 @@ Error SpatialComponent::update([[maybe_unused]] SceneComponentUpdateInfo& info,
 	return Error::NONE;
 }
 
+void SpatialComponent::updateCullingDatabase()
+{
+	// Gather the visibility tests this node can take part in. It's what the visibility tests would have computed by
+	// looking at the components of the node
+	FrustumComponentVisibilityTestFlag tests = FrustumComponentVisibilityTestFlag::NONE;
+	RenderComponentFlag renderFlags = RenderComponentFlag::NONE;
+
+	const RenderComponent* rc = m_node->tryGetFirstComponentOfType<RenderComponent>();
+	if(rc)
+	{
+		renderFlags = rc->getFlags();
+		tests |= FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS;
+
+		if(!!(renderFlags & RenderComponentFlag::CASTS_SHADOW))
+		{
+			tests |= FrustumComponentVisibilityTestFlag::SHADOW_CASTERS;
+		}
+
+		if(rc->getSupportsRayTracing())
+		{
+			tests |= FrustumComponentVisibilityTestFlag::ALL_RAY_TRACING;
+		}
+	}
+
+	auto addTest = [&](Bool hasComponent, FrustumComponentVisibilityTestFlag flag) {
+		if(hasComponent)
+		{
+			tests |= flag;
+		}
+	};
+
+	addTest(m_node->tryGetFirstComponentOfType<LightComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::LIGHT_COMPONENTS);
+	addTest(m_node->tryGetFirstComponentOfType<LensFlareComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::LENS_FLARE_COMPONENTS);
+	addTest(m_node->tryGetFirstComponentOfType<ReflectionProbeComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::REFLECTION_PROBES);
+	addTest(m_node->tryGetFirstComponentOfType<DecalComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::DECALS);
+	addTest(m_node->tryGetFirstComponentOfType<FogDensityComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::FOG_DENSITY_COMPONENTS);
+	addTest(m_node->tryGetFirstComponentOfType<GlobalIlluminationProbeComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::GLOBAL_ILLUMINATION_PROBES);
+	addTest(m_node->tryGetFirstComponentOfType<GenericGpuComputeJobComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::GENERIC_COMPUTE_JOB_COMPONENTS);
+	addTest(m_node->tryGetFirstComponentOfType<UiComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::UI_COMPONENTS);
+	addTest(m_node->tryGetFirstComponentOfType<SkyboxComponent>() != nullptr,
+			FrustumComponentVisibilityTestFlag::SKYBOX);
+
+	// Static geometry is what doesn't move and doesn't animate. Renderers can cache it
+	const MoveComponent* movec = m_node->tryGetFirstComponentOfType<MoveComponent>();
+	const Bool staticGeometry = rc && (movec == nullptr || movec->isStatic(m_node->getGlobalTimestamp()))
+								&& m_node->tryGetFirstComponentOfType<SkinComponent>() == nullptr
+								&& m_node->tryGetFirstComponentOfType<ParticleEmitterComponent>() == nullptr
+								&& m_node->tryGetFirstComponentOfType<GpuParticleEmitterComponent>() == nullptr;
+
+	// Set the properties first. If the entry stops being static the DB will record its old AABB
+	CullingDatabase& db = m_node->getSceneGraph().getCullingDatabase();
+	db.setEntryProperties(m_cullingIdx, tests, renderFlags, m_alwaysVisible,
+						  m_collisionObjectType != CollisionShapeType::AABB, staticGeometry,
+						  m_node->getGlobalTimestamp());
+
+	if(!m_alwaysVisible)
+	{
+		db.setEntryAabb(m_cullingIdx, m_derivedAabb);
+	}
+}
+
 } // end namespace anki
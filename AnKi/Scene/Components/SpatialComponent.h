@@ -102,6 +102,7 @@ public:
 	void setAlwaysVisible(Bool alwaysVisible)
 	{
 		m_alwaysVisible = alwaysVisible;
+		m_markedForUpdate = true;
 	}
 
 	/// See if it's always visible or not.
@@ -110,6 +111,19 @@ public:
 		return m_alwaysVisible;
 	}
 
+	/// Re-place it in the visibility structures in the next update. Call it when the other components of the node
+	/// change in a way that affects the visibility tests.
+	void markForUpdate()
+	{
+		m_markedForUpdate = true;
+	}
+
+	/// The index of the spatial in the CullingDatabase.
+	U32 getCullingIndex() const
+	{
+		return m_cullingIdx;
+	}
+
 	Error update(SceneComponentUpdateInfo& info, Bool& updated) override;
 
 private:
@@ -133,10 +147,14 @@ private:
 
 	OctreePlaceable m_octreeInfo;
 
+	U32 m_cullingIdx = MAX_U32;
+
 	Bool m_markedForUpdate : 1;
 	Bool m_placed : 1;
 	Bool m_updateOctreeBounds : 1;
 	Bool m_alwaysVisible : 1;
+
+	void updateCullingDatabase();
 };
 /// @}
 
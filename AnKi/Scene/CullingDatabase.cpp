@@ -0,0 +1,315 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Scene/CullingDatabase.h>
+#include <AnKi/Collision/Aabb.h>
+#include <AnKi/Collision/Functions.h>
+#include <AnKi/Math/Simd.h>
+
+namespace anki {
+
+CullingDatabase::~CullingDatabase()
+{
+	m_minX.destroy(m_alloc);
+	m_minY.destroy(m_alloc);
+	m_minZ.destroy(m_alloc);
+	m_maxX.destroy(m_alloc);
+	m_maxY.destroy(m_alloc);
+	m_maxZ.destroy(m_alloc);
+	m_visibilityTests.destroy(m_alloc);
+	m_renderFlags.destroy(m_alloc);
+	m_entryFlags.destroy(m_alloc);
+	m_spatials.destroy(m_alloc);
+	m_freeEntries.destroy(m_alloc);
+}
+
+U32 CullingDatabase::allocateEntry(SpatialComponent* spatial)
+{
+	ANKI_ASSERT(spatial);
+	LockGuard<Mutex> lock(m_mtx);
+
+	U32 idx;
+	if(m_freeEntries.getSize())
+	{
+		idx = m_freeEntries.getBack();
+		m_freeEntries.popBack(m_alloc);
+	}
+	else
+	{
+		idx = m_spatials.getSize();
+		m_minX.emplaceBack(m_alloc);
+		m_minY.emplaceBack(m_alloc);
+		m_minZ.emplaceBack(m_alloc);
+		m_maxX.emplaceBack(m_alloc);
+		m_maxY.emplaceBack(m_alloc);
+		m_maxZ.emplaceBack(m_alloc);
+		m_visibilityTests.emplaceBack(m_alloc);
+		m_renderFlags.emplaceBack(m_alloc);
+		m_entryFlags.emplaceBack(m_alloc);
+		m_spatials.emplaceBack(m_alloc);
+	}
+
+	// The entry won't take part in any test until its properties are set
+	m_visibilityTests[idx] = FrustumComponentVisibilityTestFlag::NONE;
+	m_renderFlags[idx] = RenderComponentFlag::NONE;
+	m_entryFlags[idx] = EntryFlag::NONE;
+	m_spatials[idx] = spatial;
+
+	return idx;
+}
+
+void CullingDatabase::freeEntry(U32 idx, Timestamp crntTimestamp)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(m_spatials[idx]);
+
+	if(!!(m_entryFlags[idx] & EntryFlag::STATIC_GEOMETRY))
+	{
+		recordStaticGeometryRemoval(idx, crntTimestamp);
+	}
+
+	m_visibilityTests[idx] = FrustumComponentVisibilityTestFlag::NONE;
+	m_spatials[idx] = nullptr;
+	m_freeEntries.emplaceBack(m_alloc, idx);
+}
+
+void CullingDatabase::setEntryAabb(U32 idx, const Aabb& aabb)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(m_spatials[idx]);
+
+	m_minX[idx] = aabb.getMin().x();
+	m_minY[idx] = aabb.getMin().y();
+	m_minZ[idx] = aabb.getMin().z();
+	m_maxX[idx] = aabb.getMax().x();
+	m_maxY[idx] = aabb.getMax().y();
+	m_maxZ[idx] = aabb.getMax().z();
+}
+
+void CullingDatabase::setEntryProperties(U32 idx, FrustumComponentVisibilityTestFlag visibilityTests,
+										 RenderComponentFlag renderFlags, Bool alwaysVisible, Bool exactShapeTest,
+										 Bool staticGeometry, Timestamp crntTimestamp)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(m_spatials[idx]);
+
+	if(!!(m_entryFlags[idx] & EntryFlag::STATIC_GEOMETRY) && !staticGeometry)
+	{
+		recordStaticGeometryRemoval(idx, crntTimestamp);
+	}
+
+	m_visibilityTests[idx] = visibilityTests;
+	m_renderFlags[idx] = renderFlags;
+	m_entryFlags[idx] = (alwaysVisible) ? EntryFlag::ALWAYS_VISIBLE : EntryFlag::NONE;
+	m_entryFlags[idx] |= (exactShapeTest) ? EntryFlag::EXACT_SHAPE_TEST : EntryFlag::NONE;
+	m_entryFlags[idx] |= (staticGeometry) ? EntryFlag::STATIC_GEOMETRY : EntryFlag::NONE;
+}
+
+void CullingDatabase::recordStaticGeometryRemoval(U32 idx, Timestamp crntTimestamp)
+{
+	if(!!(m_entryFlags[idx] & EntryFlag::ALWAYS_VISIBLE))
+	{
+		m_alwaysVisibleStaticGeometryRemovedTimestamp =
+			max(m_alwaysVisibleStaticGeometryRemovedTimestamp, crntTimestamp);
+		return;
+	}
+
+	const Aabb aabb(Vec3(m_minX[idx], m_minY[idx], m_minZ[idx]), Vec3(m_maxX[idx], m_maxY[idx], m_maxZ[idx]));
+
+	if(m_staticGeometryRemovalCount < MAX_STATIC_GEOMETRY_REMOVALS)
+	{
+		StaticGeometryRemoval& removal = m_staticGeometryRemovals[m_staticGeometryRemovalCount++];
+		removal.m_aabb = aabb;
+		removal.m_timestamp = crntTimestamp;
+		return;
+	}
+
+	// Full, merge it with the removal that grows the least. The result is conservative, it covers both
+	auto computeSize = [](const Aabb& box) {
+		const Vec4 extent = box.getMax() - box.getMin();
+		return extent.x() + extent.y() + extent.z();
+	};
+
+	U32 bestIdx = 0;
+	Aabb bestAabb;
+	F32 bestGrowth = MAX_F32;
+	for(U32 i = 0; i < m_staticGeometryRemovalCount; ++i)
+	{
+		const Aabb& other = m_staticGeometryRemovals[i].m_aabb;
+		const Aabb merged(other.getMin().min(aabb.getMin()), other.getMax().max(aabb.getMax()));
+		const F32 growth = computeSize(merged) - computeSize(other);
+		if(growth < bestGrowth)
+		{
+			bestIdx = i;
+			bestAabb = merged;
+			bestGrowth = growth;
+		}
+	}
+
+	m_staticGeometryRemovals[bestIdx].m_aabb = bestAabb;
+	m_staticGeometryRemovals[bestIdx].m_timestamp = max(m_staticGeometryRemovals[bestIdx].m_timestamp, crntTimestamp);
+}
+
+Timestamp CullingDatabase::getStaticGeometryRemovedTimestamp(
+	const Array<Plane, U32(FrustumPlaneType::COUNT)>& planes) const
+{
+	Timestamp timestamp = m_alwaysVisibleStaticGeometryRemovedTimestamp;
+
+	for(U32 i = 0; i < m_staticGeometryRemovalCount; ++i)
+	{
+		const StaticGeometryRemoval& removal = m_staticGeometryRemovals[i];
+		if(removal.m_timestamp <= timestamp)
+		{
+			continue;
+		}
+
+		Bool inside = true;
+		for(const Plane& plane : planes)
+		{
+			inside = inside && testPlane(plane, removal.m_aabb) >= 0.0f;
+		}
+
+		if(inside)
+		{
+			timestamp = removal.m_timestamp;
+		}
+	}
+
+	return timestamp;
+}
+
+U32 CullingDatabase::testFrustum(ConstWeakArray<U32> entries, FrustumComponentVisibilityTestFlag enabledVisibilityTests,
+								 const Array<Plane, U32(FrustumPlaneType::COUNT)>& planes, const Plane& nearPlane,
+								 WeakArray<U32> visibleEntries, WeakArray<F32> distances) const
+{
+	ANKI_ASSERT(visibleEntries.getSize() >= entries.getSize() && distances.getSize() >= entries.getSize());
+
+	// Gather the entries that the frustum cares about. Compact them in the front of the output, the tests below will
+	// overwrite them in place
+	U32 candidateCount = 0;
+	U32 alwaysVisibleCount = 0;
+	for(U32 idx : entries)
+	{
+		if(!(m_visibilityTests[idx] & enabledVisibilityTests))
+		{
+			continue;
+		}
+
+		if(ANKI_UNLIKELY(!!(m_entryFlags[idx] & EntryFlag::ALWAYS_VISIBLE)))
+		{
+			++alwaysVisibleCount;
+		}
+		else
+		{
+			visibleEntries[candidateCount++] = idx;
+		}
+	}
+
+	// For every plane pick the corners of the AABBs that are further along the normal (for the frustum test) or
+	// closer (for the distance)
+	class PlaneInfo
+	{
+	public:
+		Array<const DynamicArray<F32>*, 3> m_positiveCorner;
+		F32x4 m_normalX;
+		F32x4 m_normalY;
+		F32x4 m_normalZ;
+		F32x4 m_negativeOffset;
+	};
+
+	auto initPlaneInfo = [this](const Plane& plane, Bool positiveCorner, PlaneInfo& info) {
+		const Vec4& n = plane.getNormal();
+		const Bool useMax = positiveCorner;
+		info.m_positiveCorner[0] = ((n.x() >= 0.0f) == useMax) ? &m_maxX : &m_minX;
+		info.m_positiveCorner[1] = ((n.y() >= 0.0f) == useMax) ? &m_maxY : &m_minY;
+		info.m_positiveCorner[2] = ((n.z() >= 0.0f) == useMax) ? &m_maxZ : &m_minZ;
+		info.m_normalX = splatF32x4(n.x());
+		info.m_normalY = splatF32x4(n.y());
+		info.m_normalZ = splatF32x4(n.z());
+		info.m_negativeOffset = splatF32x4(-plane.getOffset());
+	};
+
+	Array<PlaneInfo, U32(FrustumPlaneType::COUNT)> planeInfos;
+	for(U32 i = 0; i < planes.getSize(); ++i)
+	{
+		initPlaneInfo(planes[i], true, planeInfos[i]);
+	}
+
+	PlaneInfo nearPlaneInfo;
+	initPlaneInfo(nearPlane, false, nearPlaneInfo);
+
+	auto planeDistance = [](const PlaneInfo& info, const Array<U32, 4>& idx) -> F32x4 {
+		const DynamicArray<F32>& xs = *info.m_positiveCorner[0];
+		const DynamicArray<F32>& ys = *info.m_positiveCorner[1];
+		const DynamicArray<F32>& zs = *info.m_positiveCorner[2];
+
+		const F32x4 x = setF32x4(xs[idx[0]], xs[idx[1]], xs[idx[2]], xs[idx[3]]);
+		const F32x4 y = setF32x4(ys[idx[0]], ys[idx[1]], ys[idx[2]], ys[idx[3]]);
+		const F32x4 z = setF32x4(zs[idx[0]], zs[idx[1]], zs[idx[2]], zs[idx[3]]);
+
+		F32x4 dist = mulF32x4(info.m_normalX, x);
+		dist = addF32x4(dist, mulF32x4(info.m_normalY, y));
+		dist = addF32x4(dist, mulF32x4(info.m_normalZ, z));
+		return addF32x4(dist, info.m_negativeOffset);
+	};
+
+	// Test 4 candidates at a time. The last group repeats the last candidate. The writes never go past the group that
+	// is being tested
+	U32 visibleCount = 0;
+	const F32x4 zero = splatF32x4(0.0f);
+	for(U32 i = 0; i < candidateCount; i += 4)
+	{
+		Array<U32, 4> idx;
+		for(U32 j = 0; j < 4; ++j)
+		{
+			idx[j] = visibleEntries[min(i + j, candidateCount - 1)];
+		}
+
+		// The AABB is outside if it's fully behind one of the planes
+		MaskX4 inside = greaterEqualF32x4(planeDistance(planeInfos[0], idx), zero);
+		for(U32 p = 1; p < planeInfos.getSize(); ++p)
+		{
+			inside = andMaskX4(inside, greaterEqualF32x4(planeDistance(planeInfos[p], idx), zero));
+		}
+
+		if(!anyMaskX4(inside))
+		{
+			continue;
+		}
+
+		Array<F32, 4> insideArr;
+		storeF32x4(&insideArr[0], selectF32x4(inside, splatF32x4(1.0f), zero));
+
+		Array<F32, 4> distArr;
+		storeF32x4(&distArr[0], maxF32x4(planeDistance(nearPlaneInfo, idx), zero));
+
+		for(U32 j = 0; j < min(4u, candidateCount - i); ++j)
+		{
+			if(insideArr[j] != 0.0f)
+			{
+				visibleEntries[visibleCount] = idx[j];
+				distances[visibleCount] = distArr[j];
+				++visibleCount;
+			}
+		}
+	}
+
+	// Append the always visible
+	for(U32 i = 0; i < entries.getSize() && alwaysVisibleCount > 0; ++i)
+	{
+		const U32 idx = entries[i];
+		if(!!(m_visibilityTests[idx] & enabledVisibilityTests) && !!(m_entryFlags[idx] & EntryFlag::ALWAYS_VISIBLE))
+		{
+			visibleEntries[visibleCount] = idx;
+			distances[visibleCount] = 0.0f;
+			++visibleCount;
+			--alwaysVisibleCount;
+		}
+	}
+
+	return visibleCount;
+}
+
+} // end namespace anki
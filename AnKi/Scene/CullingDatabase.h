@@ -0,0 +1,159 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Scene/Common.h>
+#include <AnKi/Scene/Components/FrustumComponent.h>
+#include <AnKi/Scene/Components/RenderComponent.h>
+#include <AnKi/Collision/Aabb.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/Thread.h>
+
+namespace anki {
+
+// Forward
+class SpatialComponent;
+
+/// @addtogroup scene
+/// @{
+
+/// Keeps the data the visibility tests need for every SpatialComponent in packed arrays (structure of arrays) so the
+/// tests can run without touching the scene nodes and their components.
+class CullingDatabase
+{
+public:
+	CullingDatabase() = default;
+
+	CullingDatabase(const CullingDatabase&) = delete; // Non-copyable
+
+	~CullingDatabase();
+
+	CullingDatabase& operator=(const CullingDatabase&) = delete; // Non-copyable
+
+	void init(SceneAllocator<U8> alloc)
+	{
+		m_alloc = alloc;
+	}
+
+	/// @note Thread-safe.
+	U32 allocateEntry(SpatialComponent* spatial);
+
+	/// @param crntTimestamp The current global timestamp.
+	/// @note Thread-safe.
+	void freeEntry(U32 idx, Timestamp crntTimestamp);
+
+	/// Set the AABB of an entry. Ignored if the entry is always visible.
+	/// @note Thread-safe.
+	void setEntryAabb(U32 idx, const Aabb& aabb);
+
+	/// @param visibilityTests The tests of FrustumComponentVisibilityTestFlag the entry can take part.
+	/// @param renderFlags The RenderComponentFlag of the render component of the entry.
+	/// @param alwaysVisible Skip the frustum tests.
+	/// @param exactShapeTest The collision shape is not an AABB and it should be tested after the AABB test.
+	/// @param staticGeometry The node never moved and its geometry doesn't animate.
+	/// @param crntTimestamp The current global timestamp.
+	/// @note Thread-safe.
+	void setEntryProperties(U32 idx, FrustumComponentVisibilityTestFlag visibilityTests,
+							RenderComponentFlag renderFlags, Bool alwaysVisible, Bool exactShapeTest,
+							Bool staticGeometry, Timestamp crntTimestamp);
+
+	/// Test some entries against a frustum. It's done 4 entries at a time.
+	/// @param[in] entries The entries to test.
+	/// @param enabledVisibilityTests Entries that don't have any of those will be skipped.
+	/// @param planes The frustum planes in world space.
+	/// @param nearPlane The entries will compute their distance from that plane.
+	/// @param[out] visibleEntries The entries that pass the tests. Should be as big as entries.
+	/// @param[out] distances The distances of the visible entries from the nearPlane. Should be as big as entries.
+	/// @return The number of visible entries.
+	/// @note Not thread-safe against the setters.
+	U32 testFrustum(ConstWeakArray<U32> entries, FrustumComponentVisibilityTestFlag enabledVisibilityTests,
+					const Array<Plane, U32(FrustumPlaneType::COUNT)>& planes, const Plane& nearPlane,
+					WeakArray<U32> visibleEntries, WeakArray<F32> distances) const;
+
+	SpatialComponent* getSpatialComponent(U32 idx) const
+	{
+		return m_spatials[idx];
+	}
+
+	FrustumComponentVisibilityTestFlag getVisibilityTests(U32 idx) const
+	{
+		return m_visibilityTests[idx];
+	}
+
+	RenderComponentFlag getRenderFlags(U32 idx) const
+	{
+		return m_renderFlags[idx];
+	}
+
+	Bool getAlwaysVisible(U32 idx) const
+	{
+		return !!(m_entryFlags[idx] & EntryFlag::ALWAYS_VISIBLE);
+	}
+
+	Bool getExactShapeTest(U32 idx) const
+	{
+		return !!(m_entryFlags[idx] & EntryFlag::EXACT_SHAPE_TEST);
+	}
+
+	Bool getStaticGeometry(U32 idx) const
+	{
+		return !!(m_entryFlags[idx] & EntryFlag::STATIC_GEOMETRY);
+	}
+
+	/// The last time an entry with static geometry inside a frustum was removed or became dynamic. Whatever cached the
+	/// static entries of that frustum should consider that timestamp since it can't be derived by the timestamps of the
+	/// entries that are left. It's conservative, it might return the timestamp of a removal that was nearby.
+	/// @param planes The frustum planes in world space.
+	/// @note Not thread-safe against the setters.
+	Timestamp getStaticGeometryRemovedTimestamp(const Array<Plane, U32(FrustumPlaneType::COUNT)>& planes) const;
+
+private:
+	enum class EntryFlag : U8
+	{
+		NONE = 0,
+		ALWAYS_VISIBLE = 1 << 0,
+		EXACT_SHAPE_TEST = 1 << 1,
+		STATIC_GEOMETRY = 1 << 2,
+	};
+	ANKI_ENUM_ALLOW_NUMERIC_OPERATIONS_FRIEND(EntryFlag)
+
+	/// Where and when static geometry was removed.
+	class StaticGeometryRemoval
+	{
+	public:
+		Aabb m_aabb;
+		Timestamp m_timestamp;
+	};
+
+	static constexpr U32 MAX_STATIC_GEOMETRY_REMOVALS = 32;
+
+	SceneAllocator<U8> m_alloc;
+
+	DynamicArray<F32> m_minX;
+	DynamicArray<F32> m_minY;
+	DynamicArray<F32> m_minZ;
+	DynamicArray<F32> m_maxX;
+	DynamicArray<F32> m_maxY;
+	DynamicArray<F32> m_maxZ;
+	DynamicArray<FrustumComponentVisibilityTestFlag> m_visibilityTests;
+	DynamicArray<RenderComponentFlag> m_renderFlags;
+	DynamicArray<EntryFlag> m_entryFlags;
+	DynamicArray<SpatialComponent*> m_spatials;
+
+	DynamicArray<U32> m_freeEntries;
+
+	/// The places where static geometry was removed. When it's full the new removals merge with the closest ones.
+	Array<StaticGeometryRemoval, MAX_STATIC_GEOMETRY_REMOVALS> m_staticGeometryRemovals;
+	U32 m_staticGeometryRemovalCount = 0;
+	Timestamp m_alwaysVisibleStaticGeometryRemovedTimestamp = 1; ///< These have no AABB, it applies to all frustums.
+
+	Mutex m_mtx;
+
+	void recordStaticGeometryRemoval(U32 idx, Timestamp crntTimestamp);
+};
+/// @}
+
+} // end namespace anki
@@ -0,0 +1,381 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Scene/GpuScene.h>
+#include <AnKi/Resource/ModelResource.h>
+#include <AnKi/Core/ConfigSet.h>
+#include <AnKi/Gr/GrManager.h>
+#include <AnKi/Util/Tracer.h>
+#include <algorithm>
+
+namespace anki {
+
+constexpr U32 INITIAL_RENDERABLE_COUNT = 1024;
+constexpr U32 INITIAL_INSTANCE_COUNT = 1024;
+
+/// The renderer might still draw a released draw group for a few frames so keep it alive for that long.
+constexpr U64 DRAW_GROUP_DESTRUCTION_DELAY = 2;
+
+class GpuScene::DrawGroup
+{
+public:
+	U64 m_mergeKey = 0;
+	ModelResourcePtr m_model;
+	U32 m_modelPatchIdx = MAX_U32;
+	RenderQueueDrawCallback m_callback = nullptr;
+	U32 m_instanceCount = 0; ///< When it becomes zero the group will be destroyed.
+	U64 m_releaseFrame = 0; ///< The GpuScene::m_frame when m_instanceCount became zero.
+};
+
+static void setUpdate(const RenderableGpuView& view, U32 idx, GpuSceneRenderableUpdate& update)
+{
+	update.m_view = view;
+	update.m_index = idx;
+}
+
+static void setUpdate(const GpuSceneInstance& instance, U32 idx, GpuSceneInstanceUpdate& update)
+{
+	update.m_instance = instance;
+	update.m_index = idx;
+}
+
+template<typename T>
+void GpuScene::Table<T>::destroy(SceneAllocator<U8> alloc)
+{
+	m_entries.destroy(alloc);
+	m_freeEntries.destroy(alloc);
+	m_dirtyEntries.destroy(alloc);
+}
+
+template<typename T>
+U32 GpuScene::Table<T>::allocate(SceneAllocator<U8> alloc)
+{
+	U32 idx;
+	if(m_freeEntries.getSize())
+	{
+		idx = m_freeEntries.getBack();
+		m_freeEntries.popBack(alloc);
+	}
+	else
+	{
+		idx = m_entries.getSize();
+		m_entries.emplaceBack(alloc);
+	}
+
+	return idx;
+}
+
+template<typename T>
+void GpuScene::Table<T>::free(SceneAllocator<U8> alloc, U32 idx)
+{
+	ANKI_ASSERT(idx < m_entries.getSize());
+
+	// If it's dirty it will be uploaded for nothing, that's fine
+	m_freeEntries.emplaceBack(alloc, idx);
+}
+
+template<typename T>
+void GpuScene::Table<T>::markDirty(SceneAllocator<U8> alloc, U32 idx)
+{
+	Entry& entry = m_entries[idx];
+	if(entry.m_dirty)
+	{
+		// Already in the list, the last update wins
+		return;
+	}
+
+	entry.m_dirty = true;
+	if(m_dirtyEntryCount == m_dirtyEntries.getSize())
+	{
+		m_dirtyEntries.resize(alloc, max(64u, m_dirtyEntryCount * 2));
+	}
+
+	m_dirtyEntries[m_dirtyEntryCount++] = idx;
+}
+
+template<typename T>
+template<typename TUpdate>
+WeakArray<TUpdate> GpuScene::Table<T>::flush(SceneAllocator<U8> alloc, SceneFrameAllocator<U8> frameAlloc,
+											 GrManager& gr, CString bufferName)
+{
+	// Grow the buffer. The old one will be kept alive by the frames that use it
+	const PtrSize requiredSize = m_entries.getSize() * sizeof(T);
+	if(requiredSize > m_buffer->getSize())
+	{
+		BufferInitInfo buffInit(bufferName);
+		buffInit.m_size = max(requiredSize, m_buffer->getSize() * 2);
+		buffInit.m_usage = BufferUsageBit::ALL_STORAGE;
+		m_buffer = gr.newBuffer(buffInit);
+
+		// The new buffer is empty, upload everything
+		for(U32 i = 0; i < m_entries.getSize(); ++i)
+		{
+			markDirty(alloc, i);
+		}
+	}
+
+	// Gather the updates
+	TUpdate* updates = nullptr;
+	if(m_dirtyEntryCount)
+	{
+		updates = frameAlloc.newArray<TUpdate>(m_dirtyEntryCount);
+
+		for(U32 i = 0; i < m_dirtyEntryCount; ++i)
+		{
+			const U32 idx = m_dirtyEntries[i];
+			Entry& entry = m_entries[idx];
+			ANKI_ASSERT(entry.m_dirty);
+			entry.m_dirty = false;
+
+			setUpdate(entry.m_value, idx, updates[i]);
+		}
+	}
+
+	const WeakArray<TUpdate> out(updates, m_dirtyEntryCount);
+	m_dirtyEntryCount = 0;
+	return out;
+}
+
+GpuScene::~GpuScene()
+{
+	m_renderables.destroy(m_alloc);
+	m_instances.destroy(m_alloc);
+
+	for(DrawGroup* group : m_drawGroups)
+	{
+		m_alloc.deleteInstance(group);
+	}
+	m_drawGroups.destroy(m_alloc);
+	m_freeDrawGroups.destroy(m_alloc);
+	m_drawGroupIndices.destroy(m_alloc);
+}
+
+Error GpuScene::init(SceneAllocator<U8> alloc, GrManager* gr, const ConfigSet& config)
+{
+	m_alloc = alloc;
+	m_gr = gr;
+
+	BufferInitInfo buffInit("GpuScene");
+	buffInit.m_size = INITIAL_RENDERABLE_COUNT * sizeof(RenderableGpuView);
+	buffInit.m_usage = BufferUsageBit::ALL_STORAGE;
+	m_renderables.m_buffer = m_gr->newBuffer(buffInit);
+
+	m_gpuDrivenRendering = config.getRGpuVisibility() && m_gr->getDeviceCapabilities().m_drawIndirectCount;
+	if(m_gpuDrivenRendering)
+	{
+		buffInit.setName("GpuSceneInstances");
+		buffInit.m_size = INITIAL_INSTANCE_COUNT * sizeof(GpuSceneInstance);
+		m_instances.m_buffer = m_gr->newBuffer(buffInit);
+	}
+
+	return Error::NONE;
+}
+
+U32 GpuScene::allocateRenderable()
+{
+	LockGuard<Mutex> lock(m_mtx);
+	return m_renderables.allocate(m_alloc);
+}
+
+void GpuScene::freeRenderable(U32 idx)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	m_renderables.free(m_alloc, idx);
+}
+
+void GpuScene::updateRenderable(U32 idx, const RenderableGpuView& view)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(idx < m_renderables.m_entries.getSize());
+
+	m_renderables.m_entries[idx].m_value = view;
+	m_renderables.markDirty(m_alloc, idx);
+}
+
+U32 GpuScene::acquireDrawGroup(U64 mergeKey, const ModelResourcePtr& model, U32 modelPatchIdx,
+							   RenderQueueDrawCallback callback)
+{
+	ANKI_ASSERT(m_gpuDrivenRendering);
+	ANKI_ASSERT(callback && modelPatchIdx < model->getModelPatches().getSize());
+	LockGuard<Mutex> lock(m_mtx);
+
+	// A group that was released recently is still there and it can be used again
+	auto it = m_drawGroupIndices.find(mergeKey);
+	if(it != m_drawGroupIndices.getEnd())
+	{
+		DrawGroup& group = *m_drawGroups[*it];
+		ANKI_ASSERT(group.m_model == model && group.m_modelPatchIdx == modelPatchIdx && group.m_callback == callback);
+		++group.m_instanceCount;
+		return *it;
+	}
+
+	DrawGroup* group = m_alloc.newInstance<DrawGroup>();
+	group->m_mergeKey = mergeKey;
+	group->m_model = model;
+	group->m_modelPatchIdx = modelPatchIdx;
+	group->m_callback = callback;
+	group->m_instanceCount = 1;
+
+	U32 idx;
+	if(m_freeDrawGroups.getSize())
+	{
+		idx = m_freeDrawGroups.getBack();
+		m_freeDrawGroups.popBack(m_alloc);
+		ANKI_ASSERT(m_drawGroups[idx] == nullptr);
+		m_drawGroups[idx] = group;
+	}
+	else
+	{
+		idx = m_drawGroups.getSize();
+		m_drawGroups.emplaceBack(m_alloc, group);
+	}
+
+	m_drawGroupIndices.emplace(m_alloc, mergeKey, idx);
+
+	return idx;
+}
+
+void GpuScene::releaseDrawGroup(U32 idx)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(idx < m_drawGroups.getSize() && m_drawGroups[idx] && m_drawGroups[idx]->m_instanceCount > 0);
+
+	// Don't destroy it here, fillRenderQueue() will do it when the renderer is done with it
+	DrawGroup& group = *m_drawGroups[idx];
+	--group.m_instanceCount;
+	group.m_releaseFrame = m_frame;
+}
+
+U32 GpuScene::allocateInstance(U32 renderableIdx, U32 drawGroupIdx, const Aabb& aabbWorld)
+{
+	ANKI_ASSERT(m_gpuDrivenRendering);
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(renderableIdx < m_renderables.m_entries.getSize());
+	ANKI_ASSERT(drawGroupIdx < m_drawGroups.getSize() && m_drawGroups[drawGroupIdx]);
+
+	const U32 idx = m_instances.allocate(m_alloc);
+
+	GpuSceneInstance& instance = m_instances.m_entries[idx].m_value;
+	instance.m_aabbMin = aabbWorld.getMin().xyz();
+	instance.m_renderableGpuViewIndex = renderableIdx;
+	instance.m_aabbMax = aabbWorld.getMax().xyz();
+	instance.m_drawGroupIndex = drawGroupIdx;
+	m_instances.markDirty(m_alloc, idx);
+
+	return idx;
+}
+
+void GpuScene::freeInstance(U32 idx)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(idx < m_instances.m_entries.getSize());
+
+	// The GPU visibility skips the unused instances
+	m_instances.m_entries[idx].m_value.m_drawGroupIndex = MAX_U32;
+	m_instances.markDirty(m_alloc, idx);
+	m_instances.free(m_alloc, idx);
+}
+
+void GpuScene::updateInstance(U32 idx, const Aabb& aabbWorld)
+{
+	LockGuard<Mutex> lock(m_mtx);
+	ANKI_ASSERT(idx < m_instances.m_entries.getSize());
+
+	GpuSceneInstance& instance = m_instances.m_entries[idx].m_value;
+	ANKI_ASSERT(instance.m_drawGroupIndex != MAX_U32);
+	instance.m_aabbMin = aabbWorld.getMin().xyz();
+	instance.m_aabbMax = aabbWorld.getMax().xyz();
+	m_instances.markDirty(m_alloc, idx);
+}
+
+void GpuScene::fillRenderQueue(SceneFrameAllocator<U8> frameAlloc, RenderQueue& rqueue)
+{
+	ANKI_TRACE_SCOPED_EVENT(SCENE_GPU_SCENE);
+	LockGuard<Mutex> lock(m_mtx);
+
+	GpuSceneQueueElement& out = rqueue.m_gpuScene;
+	out.m_updates = m_renderables.flush<GpuSceneRenderableUpdate>(m_alloc, frameAlloc, *m_gr, "GpuScene");
+	out.m_buffer = m_renderables.m_buffer.get();
+
+	if(m_gpuDrivenRendering)
+	{
+		out.m_instanceUpdates =
+			m_instances.flush<GpuSceneInstanceUpdate>(m_alloc, frameAlloc, *m_gr, "GpuSceneInstances");
+		out.m_instancesBuffer = m_instances.m_buffer.get();
+		out.m_instanceCount = m_instances.m_entries.getSize();
+
+		// Destroy the groups that the renderer is done with
+		U32 groupCount = 0;
+		for(U32 idx = 0; idx < m_drawGroups.getSize(); ++idx)
+		{
+			DrawGroup* group = m_drawGroups[idx];
+			if(group && group->m_instanceCount == 0 && m_frame > group->m_releaseFrame + DRAW_GROUP_DESTRUCTION_DELAY)
+			{
+				m_drawGroupIndices.erase(m_alloc, m_drawGroupIndices.find(group->m_mergeKey));
+				m_alloc.deleteInstance(group);
+				m_drawGroups[idx] = nullptr;
+				m_freeDrawGroups.emplaceBack(m_alloc, idx);
+			}
+			else if(group && group->m_instanceCount > 0)
+			{
+				++groupCount;
+			}
+		}
+
+		// Sort the groups per material to bind each program once and reserve space for the drawcalls of each group
+		GpuSceneDrawGroupQueueElement* groups = nullptr;
+		if(groupCount)
+		{
+			groups = frameAlloc.newArray<GpuSceneDrawGroupQueueElement>(groupCount);
+			const MaterialResource** materials = frameAlloc.newArray<const MaterialResource*>(m_drawGroups.getSize());
+
+			U32 count = 0;
+			for(U32 idx = 0; idx < m_drawGroups.getSize(); ++idx)
+			{
+				const DrawGroup* group = m_drawGroups[idx];
+				if(!group || group->m_instanceCount == 0)
+				{
+					continue;
+				}
+
+				const ModelPatch& patch = group->m_model->getModelPatches()[group->m_modelPatchIdx];
+				materials[idx] = patch.getMaterial().get();
+
+				GpuSceneDrawGroupQueueElement& el = groups[count++];
+				el.m_callback = group->m_callback;
+				el.m_userData = &patch;
+				el.m_index = idx;
+				el.m_instanceCount = group->m_instanceCount;
+				el.m_castsShadow = patch.getMaterial()->castsShadow();
+				for(U32 lod = 0; lod < MAX_LOD_COUNT; ++lod)
+				{
+					patch.getIndexRange(lod, el.m_firstIndices[lod], el.m_indexCounts[lod]);
+				}
+			}
+
+			std::sort(groups, groups + groupCount,
+					  [materials](const GpuSceneDrawGroupQueueElement& a, const GpuSceneDrawGroupQueueElement& b) {
+						  return (materials[a.m_index] != materials[b.m_index])
+									 ? materials[a.m_index] < materials[b.m_index]
+									 : a.m_index < b.m_index;
+					  });
+
+			U32 firstInstance = 0;
+			for(U32 i = 0; i < groupCount; ++i)
+			{
+				groups[i].m_firstInstance = firstInstance;
+				firstInstance += groups[i].m_instanceCount;
+			}
+			out.m_drawGroupInstanceCount = firstInstance;
+		}
+
+		out.m_drawGroups = WeakArray<GpuSceneDrawGroupQueueElement>(groups, groupCount);
+		out.m_drawGroupCount = m_drawGroups.getSize();
+	}
+
+	++m_frame;
+}
+
+} // end namespace anki
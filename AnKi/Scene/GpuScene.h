@@ -0,0 +1,141 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Scene/Common.h>
+#include <AnKi/Gr/Buffer.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/HashMap.h>
+#include <AnKi/Util/Thread.h>
+#include <AnKi/Collision/Aabb.h>
+#include <AnKi/Resource/Common.h>
+#include <AnKi/Renderer/RenderQueue.h>
+
+namespace anki {
+
+// Forward
+class ConfigSet;
+
+/// @addtogroup scene
+/// @{
+
+/// Keeps the RenderableGpuView of the renderables in a persistent GPU buffer. Every renderable gets a stable index in
+/// that buffer and only the renderables that changed get uploaded every frame.
+///
+/// If GPU driven rendering is enabled it also keeps a GpuSceneInstance per model patch instance. The instances are
+/// grouped per model patch into draw groups and the GPU visibility builds the drawcalls of the groups from them.
+class GpuScene
+{
+public:
+	GpuScene() = default;
+
+	GpuScene(const GpuScene&) = delete; // Non-copyable
+
+	~GpuScene();
+
+	GpuScene& operator=(const GpuScene&) = delete; // Non-copyable
+
+	Error init(SceneAllocator<U8> alloc, GrManager* gr, const ConfigSet& config);
+
+	/// If true the renderables that have GpuSceneInstances are drawn by the GPU visibility. The visibility won't push
+	/// them to the render queues of the main camera and its shadow casting lights.
+	Bool getGpuDrivenRenderingEnabled() const
+	{
+		return m_gpuDrivenRendering;
+	}
+
+	/// Allocate a RenderableGpuView. Its initial value is undefined until updateRenderable() is called.
+	/// @note Thread-safe.
+	U32 allocateRenderable();
+
+	/// @note Thread-safe.
+	void freeRenderable(U32 idx);
+
+	/// Set a new value to a RenderableGpuView. The GPU will see it in the next frame that gets rendered.
+	/// @note Thread-safe.
+	void updateRenderable(U32 idx, const RenderableGpuView& view);
+
+	/// Get the draw group of a model patch and add one instance to it. The group is created the 1st time.
+	/// @param mergeKey Identifies the model patch. See ModelComponent::getRenderMergeKeys().
+	/// @param callback It draws the visible instances of the group. Its user data is the ModelPatch.
+	/// @note Thread-safe.
+	U32 acquireDrawGroup(U64 mergeKey, const ModelResourcePtr& model, U32 modelPatchIdx,
+						 RenderQueueDrawCallback callback);
+
+	/// Remove one instance from a draw group.
+	/// @note Thread-safe.
+	void releaseDrawGroup(U32 idx);
+
+	/// Allocate a GpuSceneInstance. Only valid if getGpuDrivenRenderingEnabled() is true.
+	/// @param renderableIdx The RenderableGpuView of the instance. See allocateRenderable().
+	/// @param drawGroupIdx See acquireDrawGroup().
+	/// @param aabbWorld The world space bounding box of the instance.
+	/// @note Thread-safe.
+	U32 allocateInstance(U32 renderableIdx, U32 drawGroupIdx, const Aabb& aabbWorld);
+
+	/// @note Thread-safe.
+	void freeInstance(U32 idx);
+
+	/// Set a new world space bounding box to an instance.
+	/// @note Thread-safe.
+	void updateInstance(U32 idx, const Aabb& aabbWorld);
+
+	/// Pass the buffers, the draw groups and the updates of this frame to the renderer.
+	void fillRenderQueue(SceneFrameAllocator<U8> frameAlloc, RenderQueue& rqueue);
+
+private:
+	class DrawGroup;
+
+	/// A CPU copy of a persistent GPU array. Only the elements that changed get uploaded.
+	template<typename T>
+	class Table
+	{
+	public:
+		class Entry
+		{
+		public:
+			T m_value;
+			Bool m_dirty = false;
+		};
+
+		BufferPtr m_buffer;
+		DynamicArray<Entry> m_entries; ///< Needed when the buffer grows.
+		DynamicArray<U32> m_freeEntries;
+		DynamicArray<U32> m_dirtyEntries;
+		U32 m_dirtyEntryCount = 0;
+
+		void destroy(SceneAllocator<U8> alloc);
+
+		U32 allocate(SceneAllocator<U8> alloc);
+
+		void free(SceneAllocator<U8> alloc, U32 idx);
+
+		void markDirty(SceneAllocator<U8> alloc, U32 idx);
+
+		/// Grow the buffer if needed and gather the updates.
+		template<typename TUpdate>
+		WeakArray<TUpdate> flush(SceneAllocator<U8> alloc, SceneFrameAllocator<U8> frameAlloc, GrManager& gr,
+								 CString bufferName);
+	};
+
+	SceneAllocator<U8> m_alloc;
+	GrManager* m_gr = nullptr;
+
+	Table<RenderableGpuView> m_renderables;
+	Table<GpuSceneInstance> m_instances;
+
+	DynamicArray<DrawGroup*> m_drawGroups; ///< Some of them might be nullptr.
+	DynamicArray<U32> m_freeDrawGroups;
+	HashMap<U64, U32> m_drawGroupIndices; ///< Map a merge key to a draw group.
+	U64 m_frame = 0; ///< Counts the fillRenderQueue() calls.
+
+	Mutex m_mtx;
+
+	Bool m_gpuDrivenRendering = false;
+};
+/// @}
+
+} // end namespace anki
@@ -43,6 +43,8 @@ class ModelNode::RenderProxy
 {
 public:
 	ModelNode* m_node = nullptr;
+	U32 m_gpuSceneInstanceIndex = MAX_U32; ///< The GpuSceneInstance of the patch if the GpuScene draws it.
+	U32 m_gpuSceneDrawGroupIndex = MAX_U32;
 };
 
 ModelNode::ModelNode(SceneGraph* scene, CString name)
@@ -55,11 +57,15 @@ ModelNode::ModelNode(SceneGraph* scene, CString name)
 	newComponent<SpatialComponent>();
 	newComponent<RenderComponent>(); // One of many
 	m_renderProxies.create(getAllocator(), 1);
+
+	m_gpuSceneIndex = getSceneGraph().getGpuScene().allocateRenderable();
 }
 
 ModelNode::~ModelNode()
 {
+	releaseGpuSceneInstances();
 	m_renderProxies.destroy(getAllocator());
+	getSceneGraph().getGpuScene().freeRenderable(m_gpuSceneIndex);
 }
 
 void ModelNode::feedbackUpdate()
@@ -103,6 +109,13 @@ void ModelNode::feedbackUpdate()
 		updateSpatial = true;
 	}
 
+	// The GpuScene can't draw skinned patches, re-init if the skin was turned on or off
+	if(skinc.isEnabled() != m_skinnedRenderComponents && !m_deferredRenderComponentUpdate
+	   && modelc.getModelResource()->getModelPatches().getSize() == m_renderProxies.getSize())
+	{
+		initRenderComponents();
+	}
+
 	// Move update
 	if(movec.getTimestamp() == globTimestamp)
 	{
@@ -115,11 +128,31 @@ void ModelNode::feedbackUpdate()
 	{
 		const Aabb aabbWorld = m_aabbLocal.getTransformed(movec.getWorldTransform());
 		getFirstComponentOfType<SpatialComponent>().setAabbWorldSpace(aabbWorld);
+
+		for(const RenderProxy& proxy : m_renderProxies)
+		{
+			if(proxy.m_gpuSceneInstanceIndex != MAX_U32)
+			{
+				getSceneGraph().getGpuScene().updateInstance(proxy.m_gpuSceneInstanceIndex, aabbWorld);
+			}
+		}
 	}
 }
 
 Error ModelNode::frameUpdate([[maybe_unused]] Second prevUpdateTime, [[maybe_unused]] Second crntTime)
 {
+	// Update the GPU scene. Do it one more time after the node stops moving to update the previous transform
+	const MoveComponent& movec = getFirstComponentOfType<MoveComponent>();
+	const Bool moved = movec.getTimestamp() == getGlobalTimestamp();
+	if(moved || m_movedLastFrame)
+	{
+		RenderableGpuView view;
+		view.m_worldTransform = Mat3x4(movec.getWorldTransform());
+		view.m_previousWorldTransform = Mat3x4(movec.getPreviousWorldTransform());
+		getSceneGraph().getGpuScene().updateRenderable(m_gpuSceneIndex, view);
+	}
+	m_movedLastFrame = moved;
+
 	if(ANKI_LIKELY(!m_deferredRenderComponentUpdate))
 	{
 		return Error::NONE;
@@ -163,6 +196,11 @@ void ModelNode::initRenderComponents()
 	ANKI_ASSERT(modelc.getModelResource()->getModelPatches().getSize() == countComponentsOfType<RenderComponent>());
 	ANKI_ASSERT(modelc.getModelResource()->getModelPatches().getSize() == m_renderProxies.getSize());
 
+	releaseGpuSceneInstances();
+
+	GpuScene& gpuScene = getSceneGraph().getGpuScene();
+	m_skinnedRenderComponents = getFirstComponentOfType<SkinComponent>().isEnabled();
+
 	for(U32 patchIdx = 0; patchIdx < model->getModelPatches().getSize(); ++patchIdx)
 	{
 		RenderComponent& rc = getNthComponentOfType<RenderComponent>(patchIdx);
@@ -175,6 +213,7 @@ void ModelNode::initRenderComponents()
 			&m_renderProxies[patchIdx], modelc.getRenderMergeKeys()[patchIdx]);
 
 		rc.setFlagsFromMaterial(model->getModelPatches()[patchIdx].getMaterial());
+		rc.setMesh(model->getModelPatches()[patchIdx].getMesh(0));
 
 		if(!!(model->getModelPatches()[patchIdx].getMaterial()->getRenderingTechniques()
 			  & RenderingTechniqueBit::ALL_RT))
@@ -189,7 +228,82 @@ void ModelNode::initRenderComponents()
 		}
 
 		m_renderProxies[patchIdx].m_node = this;
+
+		// The GpuScene draws the patches that go to the GBuffer and the shadows if they are not skinned
+		const MaterialResourcePtr& mtl = model->getModelPatches()[patchIdx].getMaterial();
+		const Bool drawnByGpuScene = gpuScene.getGpuDrivenRenderingEnabled() && !m_skinnedRenderComponents
+									 && !!(mtl->getRenderingTechniques() & RenderingTechniqueBit::GBUFFER)
+									 && !(rc.getFlags() & RenderComponentFlag::FORWARD_SHADING);
+		if(drawnByGpuScene)
+		{
+			RenderProxy& proxy = m_renderProxies[patchIdx];
+			proxy.m_gpuSceneDrawGroupIndex = gpuScene.acquireDrawGroup(modelc.getRenderMergeKeys()[patchIdx], model,
+																	   patchIdx, drawGpuSceneDrawGroup);
+			proxy.m_gpuSceneInstanceIndex =
+				gpuScene.allocateInstance(m_gpuSceneIndex, proxy.m_gpuSceneDrawGroupIndex,
+										  getFirstComponentOfType<SpatialComponent>().getAabbWorldSpace());
+		}
+
+		rc.setDrawnByGpuScene(drawnByGpuScene);
+	}
+}
+
+void ModelNode::releaseGpuSceneInstances()
+{
+	GpuScene& gpuScene = getSceneGraph().getGpuScene();
+	for(RenderProxy& proxy : m_renderProxies)
+	{
+		if(proxy.m_gpuSceneInstanceIndex != MAX_U32)
+		{
+			gpuScene.freeInstance(proxy.m_gpuSceneInstanceIndex);
+			gpuScene.releaseDrawGroup(proxy.m_gpuSceneDrawGroupIndex);
+			proxy.m_gpuSceneInstanceIndex = MAX_U32;
+			proxy.m_gpuSceneDrawGroupIndex = MAX_U32;
+		}
+	}
+}
+
+void ModelNode::bindModelPatch(const ModelPatch& patch, RenderQueueDrawContext& ctx, ModelRenderingInfo& modelInf)
+{
+	CommandBufferPtr& cmdb = ctx.m_commandBuffer;
+
+	patch.getRenderingInfo(ctx.m_key, modelInf);
+
+	// Program
+	cmdb->bindShaderProgram(modelInf.m_program);
+
+	// Set attributes
+	for(U i = 0; i < modelInf.m_vertexAttributeCount; ++i)
+	{
+		const ModelVertexAttribute& attrib = modelInf.m_vertexAttributes[i];
+		ANKI_ASSERT(attrib.m_format != Format::NONE);
+		cmdb->setVertexAttribute(U32(attrib.m_location), attrib.m_bufferBinding, attrib.m_format,
+								 attrib.m_relativeOffset);
 	}
+
+	// Set vertex buffers
+	for(U32 i = 0; i < modelInf.m_vertexBufferBindingCount; ++i)
+	{
+		const ModelVertexBufferBinding& binding = modelInf.m_vertexBufferBindings[i];
+		cmdb->bindVertexBuffer(i, binding.m_buffer, binding.m_offset, binding.m_stride, VertexStepRate::VERTEX);
+	}
+
+	// Index buffer
+	cmdb->bindIndexBuffer(modelInf.m_indexBuffer, modelInf.m_indexBufferOffset, IndexType::U16);
+}
+
+void ModelNode::drawGpuSceneDrawGroup(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData)
+{
+	ANKI_ASSERT(userData.getSize() == 1 && ctx.m_gpuVisibility && !ctx.m_debugDraw);
+	const ModelPatch& patch = *static_cast<const ModelPatch*>(userData[0]);
+
+	ModelRenderingInfo modelInf;
+	bindModelPatch(patch, ctx, modelInf);
+
+	// The drawer bound the indices of the RenderableGpuViews of the visible instances
+	RenderComponent::allocateAndSetupLocalUniforms(patch.getMaterial(), ctx, *ctx.m_stagingGpuAllocator);
+
+	ctx.drawElements(PrimitiveTopology::TRIANGLES, modelInf.m_indexCount, 1, modelInf.m_firstIndex);
 }
 
 void ModelNode::draw(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData, U32 modelPatchIdx) const
@@ -206,14 +320,10 @@ void ModelNode::draw(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData
 		const ModelPatch& patch = modelc.getModelResource()->getModelPatches()[modelPatchIdx];
 		const SkinComponent& skinc = getFirstComponentOfType<SkinComponent>();
 
-		// Transforms
-		Array<Mat3x4, MAX_INSTANCE_COUNT> trfs;
-		Array<Mat3x4, MAX_INSTANCE_COUNT> prevTrfs;
-		const MoveComponent& movec = getFirstComponentOfType<MoveComponent>();
-		trfs[0] = Mat3x4(movec.getWorldTransform());
-		prevTrfs[0] = Mat3x4(movec.getPreviousWorldTransform());
-		Bool moved = trfs[0] != prevTrfs[0];
-		for(U32 i = 1; i < instanceCount; ++i)
+		// The transforms are in the GPU scene, gather their indices
+		Array<U32, MAX_INSTANCE_COUNT> gpuSceneIndices;
+		Bool moved = false;
+		for(U32 i = 0; i < instanceCount; ++i)
 		{
 			const ModelNode& otherNode = *static_cast<const RenderProxy*>(userData[i])->m_node;
 
@@ -221,17 +331,16 @@ void ModelNode::draw(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData
 				U32(static_cast<const RenderProxy*>(userData[i]) - &otherNode.m_renderProxies[0]);
 			ANKI_ASSERT(otherNodeModelPatchIdx == modelPatchIdx);
 
-			const MoveComponent& otherNodeMovec = otherNode.getFirstComponentOfType<MoveComponent>();
-			trfs[i] = Mat3x4(otherNodeMovec.getWorldTransform());
-			prevTrfs[i] = Mat3x4(otherNodeMovec.getPreviousWorldTransform());
+			gpuSceneIndices[i] = otherNode.m_gpuSceneIndex;
 
-			moved = moved || (trfs[i] != prevTrfs[i]);
+			const MoveComponent& otherNodeMovec = otherNode.getFirstComponentOfType<MoveComponent>();
+			moved = moved || (otherNodeMovec.getWorldTransform() != otherNodeMovec.getPreviousWorldTransform());
 		}
 
 		ctx.m_key.setVelocity(moved && ctx.m_key.getRenderingTechnique() == RenderingTechnique::GBUFFER);
 		ctx.m_key.setSkinned(skinc.isEnabled());
 		ModelRenderingInfo modelInf;
-		patch.getRenderingInfo(ctx.m_key, modelInf);
+		bindModelPatch(patch, ctx, modelInf);
 
 		// Bones storage
 		if(skinc.isEnabled())
@@ -253,37 +362,14 @@ void ModelNode::draw(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData
 									tokenPrev.m_offset, tokenPrev.m_range);
 		}
 
-		// Program
-		cmdb->bindShaderProgram(modelInf.m_program);
-
-		// Uniforms
-		RenderComponent::allocateAndSetupUniforms(
-			modelc.getModelResource()->getModelPatches()[modelPatchIdx].getMaterial(), ctx,
-			ConstWeakArray<Mat3x4>(&trfs[0], instanceCount), ConstWeakArray<Mat3x4>(&prevTrfs[0], instanceCount),
-			*ctx.m_stagingGpuAllocator);
-
-		// Set attributes
-		for(U i = 0; i < modelInf.m_vertexAttributeCount; ++i)
-		{
-			const ModelVertexAttribute& attrib = modelInf.m_vertexAttributes[i];
-			ANKI_ASSERT(attrib.m_format != Format::NONE);
-			cmdb->setVertexAttribute(U32(attrib.m_location), attrib.m_bufferBinding, attrib.m_format,
-									 attrib.m_relativeOffset);
-		}
-
-		// Set vertex buffers
-		for(U32 i = 0; i < modelInf.m_vertexBufferBindingCount; ++i)
-		{
-			const ModelVertexBufferBinding& binding = modelInf.m_vertexBufferBindings[i];
-			cmdb->bindVertexBuffer(i, binding.m_buffer, binding.m_offset, binding.m_stride, VertexStepRate::VERTEX);
-		}
-
-		// Index buffer
-		cmdb->bindIndexBuffer(modelInf.m_indexBuffer, modelInf.m_indexBufferOffset, IndexType::U16);
+		// Uniforms. All the programs that models can use (GBufferGeneric and ForwardShadingFog) read the transforms
+		// from the GPU scene
+		RenderComponent::allocateAndSetupUniforms(patch.getMaterial(), ctx,
+												  ConstWeakArray<U32>(&gpuSceneIndices[0], instanceCount),
+												  *ctx.m_stagingGpuAllocator);
 
 		// Draw
-		cmdb->drawElements(PrimitiveTopology::TRIANGLES, modelInf.m_indexCount, instanceCount, modelInf.m_firstIndex, 0,
-						   0);
+		ctx.drawElements(PrimitiveTopology::TRIANGLES, modelInf.m_indexCount, instanceCount, modelInf.m_firstIndex);
 	}
 	else
 	{
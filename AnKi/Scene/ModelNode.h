@@ -14,6 +14,8 @@ namespace anki {
 // Forward
 class RenderQueueDrawContext;
 class RayTracingInstanceQueueElement;
+class ModelPatch;
+class ModelRenderingInfo;
 
 /// @addtogroup scene
 /// @{
@@ -35,15 +37,27 @@ private:
 	Aabb m_aabbLocal;
 	DynamicArray<RenderProxy> m_renderProxies; ///< The size matches the number of render components.
 
+	U32 m_gpuSceneIndex = MAX_U32;
+
 	Bool m_deferredRenderComponentUpdate = false;
+	Bool m_movedLastFrame = false;
+	Bool m_skinnedRenderComponents = false; ///< The skin state when the render components were initialized.
 
 	void feedbackUpdate();
 
 	void draw(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData, U32 modelPatchIdx) const;
 
+	/// Draw the visible instances of a draw group of the GpuScene. The user data is the ModelPatch.
+	static void drawGpuSceneDrawGroup(RenderQueueDrawContext& ctx, ConstWeakArray<void*> userData);
+
+	/// Get the rendering info and bind the program and the geometry of a model patch.
+	static void bindModelPatch(const ModelPatch& patch, RenderQueueDrawContext& ctx, ModelRenderingInfo& modelInf);
+
 	void setupRayTracingInstanceQueueElement(U32 lod, U32 modelPatchIdx, RayTracingInstanceQueueElement& el) const;
 
 	void initRenderComponents();
+
+	void releaseGpuSceneInstances();
 };
 /// @}
 
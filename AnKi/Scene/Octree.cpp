@@ -56,79 +56,143 @@ public:
 
 Octree::~Octree()
 {
-	ANKI_ASSERT(m_placeableCount == 0);
+	ANKI_ASSERT(m_placeableCount.load() == 0);
 	cleanupInternal();
-	ANKI_ASSERT(m_rootLeaf == nullptr);
+
+	if(m_rootLeaf)
+	{
+		ANKI_ASSERT(!m_rootLeaf->hasChildren());
+		releaseLeaf(m_rootLeaf);
+		m_rootLeaf = nullptr;
+	}
 }
 
 void Octree::init(const Vec3& sceneAabbMin, const Vec3& sceneAabbMax, U32 maxDepth)
 {
 	ANKI_ASSERT(sceneAabbMin < sceneAabbMax);
 	ANKI_ASSERT(maxDepth > 0);
+	ANKI_ASSERT(m_rootLeaf == nullptr);
 
 	m_maxDepth = maxDepth;
 	m_sceneAabbMin = sceneAabbMin;
 	m_sceneAabbMax = sceneAabbMax;
+
+	// Create the root leaf. It will never be deleted so the places don't have to synchronize on it
+	m_rootLeaf = newLeaf();
+	m_rootLeaf->m_aabbMin = m_sceneAabbMin;
+	m_rootLeaf->m_aabbMax = m_sceneAabbMax;
 }
 
 void Octree::place(const Aabb& volume, OctreePlaceable* placeable, Bool updateActualSceneBounds)
 {
 	ANKI_ASSERT(placeable);
+	ANKI_ASSERT(m_rootLeaf && "Forgot to call init()");
 	ANKI_ASSERT(testCollision(volume, Aabb(m_sceneAabbMin, m_sceneAabbMax)) && "volume is outside the scene");
 
-	LockGuard<Mutex> lock(m_globalMtx);
-
-	// Remove the placeable from the Octree
-	removeInternal(*placeable);
+	// Update the actual scene bounds
+	if(updateActualSceneBounds)
+	{
+		growActualSceneBounds(volume);
+	}
 
-	// Create the root leaf
-	if(!m_rootLeaf)
+	// Most moving objects don't leave their leaf from one frame to the next. Don't touch the tree for those
+	if(placedInSameLeaf(volume, *placeable))
 	{
-		m_rootLeaf = newLeaf();
-		m_rootLeaf->m_aabbMin = m_sceneAabbMin;
-		m_rootLeaf->m_aabbMax = m_sceneAabbMax;
+		ANKI_TRACE_INC_COUNTER(OCTREE_SKIPPED_PLACES, 1);
+		return;
 	}
 
-	// And re-place it
-	placeRecursive(volume, placeable, m_rootLeaf, 0);
-	++m_placeableCount;
+	RLockGuard<RWMutex> lock(m_treeMtx);
 
-	// Update the actual scene bounds
-	if(updateActualSceneBounds)
+	// Remove the placeable from the Octree
+	if(!removeInternal(*placeable))
 	{
-		m_actualSceneAabbMin = m_actualSceneAabbMin.min(volume.getMin().xyz());
-		m_actualSceneAabbMax = m_actualSceneAabbMax.max(volume.getMax().xyz());
+		m_placeableCount.fetchAdd(1);
 	}
+
+	// And re-place it
+	placeRecursive(volume, placeable, m_rootLeaf, 0);
 }
 
 void Octree::placeAlwaysVisible(OctreePlaceable* placeable)
 {
 	ANKI_ASSERT(placeable);
+	ANKI_ASSERT(m_rootLeaf && "Forgot to call init()");
 
-	LockGuard<Mutex> lock(m_globalMtx);
+	RLockGuard<RWMutex> lock(m_treeMtx);
 
 	// Remove the placeable from the Octree
-	removeInternal(*placeable);
+	if(!removeInternal(*placeable))
+	{
+		m_placeableCount.fetchAdd(1);
+	}
+
+	link(*placeable, *m_rootLeaf);
+}
+
+void Octree::remove(OctreePlaceable& placeable)
+{
+	Bool cleanup = false;
+	{
+		RLockGuard<RWMutex> lock(m_treeMtx);
+		if(removeInternal(placeable))
+		{
+			const U32 prevCount = m_placeableCount.fetchSub(1);
+			ANKI_ASSERT(prevCount > 0);
+			cleanup = prevCount == 1;
+		}
+	}
+
+	// Cleanup the tree if there are no placeables. Someone might have placed something in the meantime so check again
+	if(cleanup)
+	{
+		WLockGuard<RWMutex> lock(m_treeMtx);
+		if(m_placeableCount.load() == 0)
+		{
+			cleanupInternal();
+		}
+	}
+}
 
-	// Create the root leaf
-	if(!m_rootLeaf)
+void Octree::link(OctreePlaceable& placeable, Leaf& leaf)
+{
+	LeafNode* leafNode = newLeafNode(&leaf);
+	leafNode->m_placeableNode = newPlaceableNode(&placeable);
+
+	// Checks
+#if ANKI_ENABLE_ASSERTIONS
+	for(const LeafNode& node : placeable.m_leafs)
 	{
-		m_rootLeaf = newLeaf();
-		m_rootLeaf->m_aabbMin = m_sceneAabbMin;
-		m_rootLeaf->m_aabbMax = m_sceneAabbMax;
+		ANKI_ASSERT(node.m_leaf != &leaf && "Already binned. That's wrong");
 	}
+#endif
 
-	// Connect placeable and leaf
-	placeable->m_leafs.pushBack(newLeafNode(m_rootLeaf));
-	m_rootLeaf->m_placeables.pushBack(newPlaceableNode(placeable));
+	placeable.m_leafs.pushBack(leafNode);
 
-	++m_placeableCount;
+	LockGuard<SpinLock> lock(leaf.m_lock);
+	leaf.m_placeables.pushBack(leafNode->m_placeableNode);
 }
 
-void Octree::remove(OctreePlaceable& placeable)
+Bool Octree::placedInSameLeaf(const Aabb& volume, const OctreePlaceable& placeable) const
+{
+	// Only the owner of the placeable changes its leaf list so it's safe to look at it
+	if(placeable.m_leafs.isEmpty() || &placeable.m_leafs.getFront() != &placeable.m_leafs.getBack())
+	{
+		return false;
+	}
+
+	// The placement only stops early if the volume is a superset of a leaf so only check the deepest leafs. Also, the
+	// volume should be strictly inside or it will be binned to the neighbours as well
+	const Leaf& leaf = *placeable.m_leafs.getFront().m_leaf;
+	return leaf.m_depth == m_maxDepth && volume.getMin().xyz() > leaf.m_aabbMin
+		   && volume.getMax().xyz() < leaf.m_aabbMax;
+}
+
+void Octree::growActualSceneBounds(const Aabb& volume)
 {
-	LockGuard<Mutex> lock(m_globalMtx);
-	removeInternal(placeable);
+	LockGuard<SpinLock> lock(m_actualSceneBoundsLock);
+	m_actualSceneAabbMin = m_actualSceneAabbMin.min(volume.getMin().xyz());
+	m_actualSceneAabbMax = m_actualSceneAabbMax.max(volume.getMax().xyz());
 }
 
 Bool Octree::volumeTotallyInsideLeaf(const Aabb& volume, const Leaf& leaf)
@@ -155,27 +219,12 @@ void Octree::placeRecursive(const Aabb& volume, OctreePlaceable* placeable, Leaf
 	ANKI_ASSERT(parent);
 	ANKI_ASSERT(testCollision(volume, Aabb(parent->m_aabbMin, parent->m_aabbMax)) && "Should be inside");
 
+	ANKI_ASSERT(parent->m_depth == depth);
+
 	if(depth == m_maxDepth || volumeTotallyInsideLeaf(volume, *parent))
 	{
 		// Need to stop and bin the placeable to the leaf
-
-		// Checks
-#if ANKI_ENABLE_ASSERTIONS
-		for(const LeafNode& node : placeable->m_leafs)
-		{
-			ANKI_ASSERT(node.m_leaf != parent && "Already binned. That's wrong");
-		}
-
-		for(const PlaceableNode& node : parent->m_placeables)
-		{
-			ANKI_ASSERT(node.m_placeable != placeable);
-		}
-#endif
-
-		// Connect placeable and leaf
-		placeable->m_leafs.pushBack(newLeafNode(parent));
-		parent->m_placeables.pushBack(newPlaceableNode(placeable));
-
+		link(*placeable, *parent);
 		return;
 	}
 
@@ -242,21 +291,24 @@ void Octree::placeRecursive(const Aabb& volume, OctreePlaceable* placeable, Leaf
 		{
 			// Inside the leaf, move deeper
 
-			// Create the leaf
-			if(parent->m_children[i] == nullptr)
+			// Create the leaf. Children are never deleted while placing so the leaf can be used without the lock
+			Leaf* child;
 			{
-				Leaf* child = newLeaf();
-
-				// Compute AABB
-				Vec3 childAabbMin, childAabbMax;
-				computeChildAabb(crntBit, parent->m_aabbMin, parent->m_aabbMax, center, child->m_aabbMin,
-								 child->m_aabbMax);
+				LockGuard<SpinLock> lock(parent->m_lock);
+				child = parent->m_children[i];
+				if(child == nullptr)
+				{
+					child = newLeaf();
+					child->m_depth = depth + 1;
+					computeChildAabb(crntBit, parent->m_aabbMin, parent->m_aabbMax, center, child->m_aabbMin,
+									 child->m_aabbMax);
 
-				parent->m_children[i] = child;
+					parent->m_children[i] = child;
+				}
 			}
 
 			// Move deeper
-			placeRecursive(volume, placeable, parent->m_children[i], depth + 1);
+			placeRecursive(volume, placeable, child, depth + 1);
 		}
 	}
 }
@@ -310,43 +362,27 @@ void Octree::computeChildAabb(LeafMask child, const Vec3& parentAabbMin, const V
 	}
 }
 
-void Octree::removeInternal(OctreePlaceable& placeable)
+Bool Octree::removeInternal(OctreePlaceable& placeable)
 {
 	const Bool isPlaced = !placeable.m_leafs.isEmpty();
-	if(isPlaced)
+	while(!placeable.m_leafs.isEmpty())
 	{
-		while(!placeable.m_leafs.isEmpty())
-		{
-			// Pop a leaf node
-			LeafNode* leafNode = placeable.m_leafs.popFront();
-
-			// Iterate the placeables of the leaf
-			[[maybe_unused]] Bool found = false;
-			for(PlaceableNode& placeableNode : leafNode->m_leaf->m_placeables)
-			{
-				if(placeableNode.m_placeable == &placeable)
-				{
-					found = true;
-					leafNode->m_leaf->m_placeables.erase(&placeableNode);
-					releasePlaceableNode(&placeableNode);
-					break;
-				}
-			}
-			ANKI_ASSERT(found);
+		// Pop a leaf node
+		LeafNode* leafNode = placeable.m_leafs.popFront();
+		Leaf& leaf = *leafNode->m_leaf;
+		PlaceableNode* placeableNode = leafNode->m_placeableNode;
+		ANKI_ASSERT(placeableNode && placeableNode->m_placeable == &placeable);
 
-			// Delete the leaf node
-			releaseLeafNode(leafNode);
-		}
-
-		// Cleanup the tree if there are no placeables
-		ANKI_ASSERT(m_placeableCount > 0);
-		--m_placeableCount;
-		if(m_placeableCount == 0)
 		{
-			cleanupInternal();
-			ANKI_ASSERT(m_rootLeaf == nullptr);
+			LockGuard<SpinLock> lock(leaf.m_lock);
+			leaf.m_placeables.erase(placeableNode);
 		}
+
+		releasePlaceableNode(placeableNode);
+		releaseLeafNode(leafNode);
 	}
+
+	return isPlaced;
 }
 
 void Octree::gatherVisibleRecursive(const Plane frustumPlanes[6], U32 testId,
@@ -426,16 +462,11 @@ void Octree::cleanupRecursive(Leaf* leaf, Bool& canDeleteLeafUponReturn)
 
 void Octree::cleanupInternal()
 {
+	// Don't delete the root
 	if(m_rootLeaf)
 	{
 		Bool canDeleteLeaf;
 		cleanupRecursive(m_rootLeaf, canDeleteLeaf);
-
-		if(canDeleteLeaf)
-		{
-			releaseLeaf(m_rootLeaf);
-			m_rootLeaf = nullptr;
-		}
 	}
 }
 
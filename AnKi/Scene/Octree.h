@@ -53,8 +53,10 @@ public:
 
 	void init(const Vec3& sceneAabbMin, const Vec3& sceneAabbMax, U32 maxDepth);
 
-	/// Place or re-place an element in the tree.
-	/// @note It's thread-safe against place and remove methods.
+	/// Place or re-place an element in the tree. If the new volume stays inside the deepest leaf the placeable already
+	/// belongs to the tree is left untouched.
+	/// @note It's thread-safe against place and remove methods. Placing or removing the same placeable from multiple
+	///       threads is not.
 	void place(const Aabb& volume, OctreePlaceable* placeable, Bool updateActualSceneBounds);
 
 	/// Place the placeable somewhere where it's always visible.
@@ -108,7 +110,7 @@ public:
 	/// Get the bounds of the scene as calculated by the objects that were placed inside the Octree.
 	void getActualSceneBounds(Vec3& min, Vec3& max) const
 	{
-		LockGuard<Mutex> lock(m_globalMtx);
+		LockGuard<SpinLock> lock(m_actualSceneBoundsLock);
 		ANKI_ASSERT(m_actualSceneAabbMin.x() < MAX_F32);
 		ANKI_ASSERT(m_actualSceneAabbMax.x() > MIN_F32);
 		min = m_actualSceneAabbMin;
@@ -142,6 +144,8 @@ private:
 		Vec3 m_aabbMin;
 		Vec3 m_aabbMax;
 		Array<Leaf*, 8> m_children = {};
+		SpinLock m_lock; ///< Protects m_placeables and the creation of m_children.
+		U32 m_depth = 0;
 
 #if ANKI_ENABLE_ASSERTIONS
 		~Leaf()
@@ -165,11 +169,13 @@ private:
 	{
 	public:
 		Leaf* m_leaf = nullptr;
+		PlaceableNode* m_placeableNode = nullptr; ///< The node inside m_leaf's list.
 
 #if ANKI_ENABLE_ASSERTIONS
 		~LeafNode()
 		{
 			m_leaf = nullptr;
+			m_placeableNode = nullptr;
 		}
 #endif
 	};
@@ -201,64 +207,90 @@ private:
 	U32 m_maxDepth = 0;
 	Vec3 m_sceneAabbMin = Vec3(0.0f);
 	Vec3 m_sceneAabbMax = Vec3(0.0f);
-	mutable Mutex m_globalMtx;
 
+	/// Place and remove lock it for reading and they synchronize using the leaf locks. Only the cleanup of the tree
+	/// locks it for writing.
+	RWMutex m_treeMtx;
+
+	SpinLock m_allocLock; ///< Protects the object allocators.
 	ObjectAllocatorSameType<Leaf, 256> m_leafAlloc;
 	ObjectAllocatorSameType<LeafNode, 128> m_leafNodeAlloc;
 	ObjectAllocatorSameType<PlaceableNode, 256> m_placeableNodeAlloc;
 
-	Leaf* m_rootLeaf = nullptr;
-	U32 m_placeableCount = 0;
+	Leaf* m_rootLeaf = nullptr; ///< It's always there after init().
+	Atomic<U32> m_placeableCount = {0};
 
 	/// Compute the min of the scene bounds based on what is placed inside the octree.
 	Vec3 m_actualSceneAabbMin = Vec3(MAX_F32);
 	Vec3 m_actualSceneAabbMax = Vec3(MIN_F32);
+	mutable SpinLock m_actualSceneBoundsLock;
 
 	Leaf* newLeaf()
 	{
+		LockGuard<SpinLock> lock(m_allocLock);
 		return m_leafAlloc.newInstance(m_alloc);
 	}
 
 	void releaseLeaf(Leaf* leaf)
 	{
+		LockGuard<SpinLock> lock(m_allocLock);
 		m_leafAlloc.deleteInstance(m_alloc, leaf);
 	}
 
 	PlaceableNode* newPlaceableNode(OctreePlaceable* placeable)
 	{
 		ANKI_ASSERT(placeable);
-		PlaceableNode* out = m_placeableNodeAlloc.newInstance(m_alloc);
+		PlaceableNode* out;
+		{
+			LockGuard<SpinLock> lock(m_allocLock);
+			out = m_placeableNodeAlloc.newInstance(m_alloc);
+		}
 		out->m_placeable = placeable;
 		return out;
 	}
 
 	void releasePlaceableNode(PlaceableNode* placeable)
 	{
+		LockGuard<SpinLock> lock(m_allocLock);
 		m_placeableNodeAlloc.deleteInstance(m_alloc, placeable);
 	}
 
 	LeafNode* newLeafNode(Leaf* leaf)
 	{
 		ANKI_ASSERT(leaf);
-		LeafNode* out = m_leafNodeAlloc.newInstance(m_alloc);
+		LeafNode* out;
+		{
+			LockGuard<SpinLock> lock(m_allocLock);
+			out = m_leafNodeAlloc.newInstance(m_alloc);
+		}
 		out->m_leaf = leaf;
 		return out;
 	}
 
 	void releaseLeafNode(LeafNode* node)
 	{
+		LockGuard<SpinLock> lock(m_allocLock);
 		m_leafNodeAlloc.deleteInstance(m_alloc, node);
 	}
 
 	void placeRecursive(const Aabb& volume, OctreePlaceable* placeable, Leaf* parent, U32 depth);
 
+	/// Connect a placeable and a leaf.
+	void link(OctreePlaceable& placeable, Leaf& leaf);
+
+	/// Check if placing the volume will end up in the same single leaf the placeable already is.
+	Bool placedInSameLeaf(const Aabb& volume, const OctreePlaceable& placeable) const;
+
+	void growActualSceneBounds(const Aabb& volume);
+
 	static Bool volumeTotallyInsideLeaf(const Aabb& volume, const Leaf& leaf);
 
 	static void computeChildAabb(LeafMask child, const Vec3& parentAabbMin, const Vec3& parentAabbMax,
 								 const Vec3& parentAabbCenter, Vec3& childAabbMin, Vec3& childAabbMax);
 
 	/// Remove a placeable from the tree.
-	void removeInternal(OctreePlaceable& placeable);
+	/// @return True if it was placed.
+	Bool removeInternal(OctreePlaceable& placeable);
 
 	static void gatherVisibleRecursive(const Plane frustumPlanes[6], U32 testId,
 									   OctreeNodeVisibilityTestCallback testCallback, void* testCallbackUserData,
@@ -273,7 +305,7 @@ private:
 	/// Remove a leaf.
 	void cleanupRecursive(Leaf* leaf, Bool& canDeleteLeafUponReturn);
 
-	/// Cleanup the tree.
+	/// Cleanup the tree. It needs the m_treeMtx locked for writing.
 	void cleanupInternal();
 
 	/// Debug draw.
@@ -13,26 +13,12 @@
 #include <AnKi/Resource/ResourceManager.h>
 #include <AnKi/Renderer/MainRenderer.h>
 #include <AnKi/Core/ConfigSet.h>
-#include <AnKi/Util/ThreadHive.h>
+#include <AnKi/Util/ThreadHiveAlgorithms.h>
 #include <AnKi/Util/Tracer.h>
 #include <AnKi/Util/HighRezTimer.h>
 
 namespace anki {
 
-const U NODE_UPDATE_BATCH = 10;
-
-class SceneGraph::UpdateSceneNodesCtx
-{
-public:
-	SceneGraph* m_scene = nullptr;
-
-	IntrusiveList<SceneNode>::Iterator m_crntNode;
-	SpinLock m_crntNodeLock;
-
-	Second m_prevUpdateTime;
-	Second m_crntTime;
-};
-
 SceneGraph::SceneGraph()
 {
 }
@@ -45,6 +31,7 @@ SceneGraph::~SceneGraph()
 	});
 
 	deleteNodesMarkedForDeletion();
+	m_nodesDict.destroy(m_alloc);
 
 	if(m_octree)
 	{
@@ -74,6 +61,9 @@ Error SceneGraph::init(AllocAlignedCallback allocCb, void* allocCbData, ThreadHi
 	m_octree = m_alloc.newInstance<Octree>(m_alloc);
 	m_octree->init(m_sceneMin, m_sceneMax, m_config->getSceneOctreeMaxDepth());
 
+	ANKI_CHECK(m_gpuScene.init(m_alloc, m_gr, *m_config));
+	m_cullingDb.init(m_alloc);
+
 	// Init the default main camera
 	ANKI_CHECK(newSceneNode<PerspectiveCameraNode>("mainCamera", m_defaultMainCam));
 	m_defaultMainCam->getFirstComponentOfType<FrustumComponent>().setPerspective(0.1f, 1000.0f, toRad(60.0f),
@@ -207,27 +197,31 @@ Error SceneGraph::update(Second prevUpdateTime, Second crntTime)
 		ANKI_TRACE_SCOPED_EVENT(SCENE_NODES_UPDATE);
 		ANKI_CHECK(m_events.updateAllEvents(prevUpdateTime, crntTime));
 
-		// Then the rest
-		Array<ThreadHiveTask, ThreadHive::MAX_THREADS> tasks;
-		UpdateSceneNodesCtx updateCtx;
-		updateCtx.m_scene = this;
-		updateCtx.m_crntNode = m_nodes.getBegin();
-		updateCtx.m_prevUpdateTime = prevUpdateTime;
-		updateCtx.m_crntTime = crntTime;
-
-		for(U i = 0; i < m_threadHive->getThreadCount(); i++)
+		// Gather the nodes that don't have parent. The children will be updated by their parents
+		DynamicArrayAuto<SceneNode*> rootNodes(m_frameAlloc);
+		rootNodes.resizeStorage(m_nodesCount);
+		for(SceneNode& node : m_nodes)
 		{
-			tasks[i] = ANKI_THREAD_HIVE_TASK(
-				{
-					if(self->m_scene->updateNodes(*self))
-					{
-						ANKI_SCENE_LOGF("Will not recover");
-					}
-				},
-				&updateCtx, nullptr, nullptr);
+			if(node.getParent() == nullptr)
+			{
+				rootNodes.emplaceBack(&node);
+			}
 		}
 
-		m_threadHive->submitTasks(&tasks[0], m_threadHive->getThreadCount());
+		// Then the rest
+		SceneNode** nodes = rootNodes.getBegin();
+		parallelFor(*m_threadHive, rootNodes.getSize(), 0,
+					[nodes, prevUpdateTime, crntTime](U32 begin, U32 end, [[maybe_unused]] U32 threadId) {
+						ANKI_TRACE_SCOPED_EVENT(SCENE_NODES_UPDATE);
+						for(U32 i = begin; i < end; ++i)
+						{
+							if(updateNode(prevUpdateTime, crntTime, *nodes[i]))
+							{
+								ANKI_SCENE_LOGF("Will not recover");
+							}
+						}
+					});
+
 		m_threadHive->waitAllTasks();
 	}
 
@@ -239,6 +233,7 @@ void SceneGraph::doVisibilityTests(RenderQueue& rqueue)
 {
 	m_stats.m_visibilityTestsTime = HighRezTimer::getCurrentTime();
 	doVisibilityTests(*m_mainCam, *this, rqueue);
+	m_gpuScene.fillRenderQueue(m_frameAlloc, rqueue);
 	m_stats.m_visibilityTestsTime = HighRezTimer::getCurrentTime() - m_stats.m_visibilityTestsTime;
 }
 
@@ -306,54 +301,4 @@ Error SceneGraph::updateNode(Second prevTime, Second crntTime, SceneNode& node)
 	return err;
 }
 
-Error SceneGraph::updateNodes(UpdateSceneNodesCtx& ctx) const
-{
-	ANKI_TRACE_SCOPED_EVENT(SCENE_NODES_UPDATE);
-
-	IntrusiveList<SceneNode>::ConstIterator end = m_nodes.getEnd();
-
-	Bool quit = false;
-	Error err = Error::NONE;
-	while(!quit && !err)
-	{
-		// Fetch a batch of scene nodes that don't have parent
-		Array<SceneNode*, NODE_UPDATE_BATCH> batch;
-		U batchSize = 0;
-
-		{
-			LockGuard<SpinLock> lock(ctx.m_crntNodeLock);
-
-			while(1)
-			{
-				if(batchSize == batch.getSize())
-				{
-					break;
-				}
-
-				if(ctx.m_crntNode == end)
-				{
-					quit = true;
-					break;
-				}
-
-				SceneNode& node = *ctx.m_crntNode;
-				if(node.getParent() == nullptr)
-				{
-					batch[batchSize++] = &node;
-				}
-
-				++ctx.m_crntNode;
-			}
-		}
-
-		// Process nodes
-		for(U i = 0; i < batchSize && !err; ++i)
-		{
-			err = updateNode(ctx.m_prevUpdateTime, ctx.m_crntTime, *batch[i]);
-		}
-	}
-
-	return err;
-}
-
 } // end namespace anki
@@ -8,8 +8,10 @@
 #include <AnKi/Scene/Common.h>
 #include <AnKi/Scene/SceneNode.h>
 #include <AnKi/Scene/DebugDrawer.h>
+#include <AnKi/Scene/GpuScene.h>
+#include <AnKi/Scene/CullingDatabase.h>
 #include <AnKi/Math.h>
-#include <AnKi/Util/HashMap.h>
+#include <AnKi/Util/FlatHashMap.h>
 #include <AnKi/Core/App.h>
 #include <AnKi/Scene/Events/EventManager.h>
 #include <AnKi/Resource/Common.h>
@@ -217,6 +219,21 @@ public:
 		return m_debugDrawer;
 	}
 
+	GpuScene& getGpuScene()
+	{
+		return m_gpuScene;
+	}
+
+	CullingDatabase& getCullingDatabase()
+	{
+		return m_cullingDb;
+	}
+
+	const CullingDatabase& getCullingDatabase() const
+	{
+		return m_cullingDb;
+	}
+
 	ANKI_INTERNAL const ConfigSet& getConfig()
 	{
 		ANKI_ASSERT(m_config);
@@ -224,8 +241,6 @@ public:
 	}
 
 private:
-	class UpdateSceneNodesCtx;
-
 	const Timestamp* m_globalTimestamp = nullptr;
 	Timestamp m_timestamp = 0; ///< Cached timestamp
 
@@ -244,7 +259,7 @@ private:
 
 	IntrusiveList<SceneNode> m_nodes;
 	U32 m_nodesCount = 0;
-	HashMap<CString, SceneNode*> m_nodesDict;
+	FlatHashMap<CString, SceneNode*> m_nodesDict;
 
 	SceneNode* m_mainCam = nullptr;
 	Timestamp m_activeCameraChangeTimestamp = 0;
@@ -264,6 +279,8 @@ private:
 	SceneGraphStats m_stats;
 
 	DebugDrawer2 m_debugDrawer;
+	GpuScene m_gpuScene;
+	CullingDatabase m_cullingDb;
 
 	/// Put a node in the appropriate containers
 	Error registerNode(SceneNode* node);
@@ -272,7 +289,6 @@ private:
 	/// Delete the nodes that are marked for deletion
 	void deleteNodesMarkedForDeletion();
 
-	Error updateNodes(UpdateSceneNodesCtx& ctx) const;
 	[[nodiscard]] static Error updateNode(Second prevTime, Second crntTime, SceneNode& node);
 
 	/// Do visibility tests.
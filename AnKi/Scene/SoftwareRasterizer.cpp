@@ -6,10 +6,30 @@
 #include <AnKi/Scene/SoftwareRasterizer.h>
 #include <AnKi/Collision/Aabb.h>
 #include <AnKi/Collision/Functions.h>
+#include <AnKi/Math/Simd.h>
+#include <AnKi/Util/ThreadHiveAlgorithms.h>
 #include <AnKi/Util/Tracer.h>
 
 namespace anki {
 
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	destroyBins();
+	m_depth.destroy(m_alloc);
+	m_tiles.destroy(m_alloc);
+}
+
+void SoftwareRasterizer::destroyBins()
+{
+	for(DynamicArray<U32>& bin : m_bins)
+	{
+		bin.destroy(m_alloc);
+	}
+
+	m_bins.destroy(m_alloc);
+	m_triangles.destroy(m_alloc);
+}
+
 void SoftwareRasterizer::prepare(const Mat4& mv, const Mat4& p, U32 width, U32 height)
 {
 	m_mv = mv;
@@ -19,17 +39,45 @@ void SoftwareRasterizer::prepare(const Mat4& mv, const Mat4& p, U32 width, U32 h
 	extractClipPlanes(p, m_planesL);
 	extractClipPlanes(m_mvp, m_planesW);
 
-	// Reset z buffer
 	ANKI_ASSERT(width > 0 && height > 0);
 	m_width = width;
 	m_height = height;
-	U32 size = width * height;
-	if(m_zbuffer.getSize() < size)
+	m_paddedWidth = getAlignedRoundUp(TILE_SIZE, width);
+	m_paddedHeight = getAlignedRoundUp(TILE_SIZE, height);
+
+	// Reset the depth buffer. The padding is zero so it won't increase the max depth of the tiles
+	const U32 size = m_paddedWidth * m_paddedHeight;
+	if(m_depth.getSize() != size)
+	{
+		m_depth.destroy(m_alloc);
+		m_depth.create(m_alloc, size);
+	}
+
+	memset(&m_depth[0], 0, m_depth.getSizeInBytes());
+	for(U32 y = 0; y < m_height; ++y)
 	{
-		m_zbuffer.destroy(m_alloc);
-		m_zbuffer.create(m_alloc, size);
+		F32* row = &m_depth[y * m_paddedWidth];
+		for(U32 x = 0; x < m_width; ++x)
+		{
+			row[x] = 1.0f;
+		}
 	}
-	memset(&m_zbuffer[0], 0xFF, sizeof(m_zbuffer[0]) * size);
+
+	// Reset the tiles
+	m_tileCounts = UVec2(m_paddedWidth, m_paddedHeight) / TILE_SIZE;
+	const U32 tileCount = m_tileCounts.x() * m_tileCounts.y();
+	if(m_tiles.getSize() != tileCount)
+	{
+		m_tiles.destroy(m_alloc);
+		m_tiles.create(m_alloc, tileCount);
+	}
+
+	updateTiles(UVec2(0u), m_tileCounts);
+
+	// Reset the bins
+	destroyBins();
+	m_binCounts = (UVec2(m_width, m_height) + (BIN_SIZE - 1)) / BIN_SIZE;
+	m_bins.create(m_alloc, m_binCounts.x() * m_binCounts.y());
 }
 
 void SoftwareRasterizer::clipTriangle(const Vec4* inVerts, Vec4* outVerts, U& outVertCount) const
@@ -164,7 +212,12 @@ void SoftwareRasterizer::draw(const F32* verts, U vertCount, U stride, Bool back
 	ANKI_ASSERT(verts && vertCount > 0 && (vertCount % 3) == 0);
 	ANKI_ASSERT(stride >= sizeof(F32) * 3 && (stride % sizeof(F32)) == 0);
 
-	U floatStride = stride / sizeof(F32);
+	// Gather the triangles in a local batch to lock the bins less often
+	Array<ScreenTriangle, 64> batch;
+	U32 batchCount = 0;
+
+	const Vec2 windowSize{F32(m_width), F32(m_height)};
+	const U floatStride = stride / sizeof(F32);
 	const F32* vertsEnd = verts + vertCount * floatStride;
 	while(verts != vertsEnd)
 	{
@@ -199,95 +252,231 @@ void SoftwareRasterizer::draw(const F32* verts, U vertCount, U stride, Bool back
 			continue;
 		}
 
-		// Rasterize
-		Array<Vec4, 3> clip;
+		// To window space
 		for(U j = 0; j < clippedCount; j += 3)
 		{
+			ScreenTriangle& tri = batch[batchCount++];
 			for(U k = 0; k < 3; k++)
 			{
-				clip[k] = m_p * clippedTrisVspace[j + k].xyz1();
-				ANKI_ASSERT(clip[k].w() > 0.0f);
+				const Vec4 clip = m_p * clippedTrisVspace[j + k].xyz1();
+				ANKI_ASSERT(clip.w() > 0.0f);
+
+				const Vec3 ndc = clip.xyz() / clip.w();
+				tri.m_verts[k] = (ndc.xy() / 2.0f + 0.5f) * windowSize;
+				tri.m_depths[k] = ndc.z();
 			}
+		}
 
-			rasterizeTriangle(&clip[0]);
+		if(batchCount + 2 > batch.getSize())
+		{
+			binTriangles(&batch[0], batchCount);
+			batchCount = 0;
 		}
 	}
+
+	if(batchCount)
+	{
+		binTriangles(&batch[0], batchCount);
+	}
 }
 
-Bool SoftwareRasterizer::computeBarycetrinc(const Vec2& a, const Vec2& b, const Vec2& c, const Vec2& p, Vec3& uvw) const
+void SoftwareRasterizer::binTriangles(const ScreenTriangle* tris, U32 triCount)
 {
-	Vec2 dca = c - a;
-	Vec2 dba = b - a;
-	Vec2 dap = a - p;
+	LockGuard<Mutex> lock(m_binMtx);
 
-	Vec3 n(dca.x(), dba.x(), dap.x());
-	Vec3 m(dca.y(), dba.y(), dap.y());
-
-	Vec3 k = n.cross(m);
-
-	Bool skip = false;
-	if(!isZero(k.z()))
+	for(U32 i = 0; i < triCount; ++i)
 	{
-		uvw = Vec3(1.0f - (k.x() + k.y()) / k.z(), k.y() / k.z(), k.x() / k.z());
+		const ScreenTriangle& tri = tris[i];
+
+		const Vec2 bboxMinf = tri.m_verts[0].min(tri.m_verts[1]).min(tri.m_verts[2]);
+		const Vec2 bboxMaxf = tri.m_verts[0].max(tri.m_verts[1]).max(tri.m_verts[2]);
+		const UVec2 bboxMin(U32(clamp(std::floor(bboxMinf.x()), 0.0f, F32(m_width))),
+							U32(clamp(std::floor(bboxMinf.y()), 0.0f, F32(m_height))));
+		const UVec2 bboxMax(U32(clamp(std::ceil(bboxMaxf.x()), 0.0f, F32(m_width))),
+							U32(clamp(std::ceil(bboxMaxf.y()), 0.0f, F32(m_height))));
+		if(bboxMin.x() >= bboxMax.x() || bboxMin.y() >= bboxMax.y())
+		{
+			// Off screen
+			continue;
+		}
 
-		if(uvw.x() < 0.0f || uvw.y() < 0.0f || uvw.z() < 0.0f)
+		const U32 triIdx = m_triangles.getSize();
+		m_triangles.emplaceBack(m_alloc, tri);
+
+		const UVec2 firstBin = bboxMin / BIN_SIZE;
+		const UVec2 lastBin = (bboxMax - 1u) / BIN_SIZE;
+		for(U32 y = firstBin.y(); y <= lastBin.y(); ++y)
 		{
-			skip = true;
+			for(U32 x = firstBin.x(); x <= lastBin.x(); ++x)
+			{
+				m_bins[y * m_binCounts.x() + x].emplaceBack(m_alloc, triIdx);
+			}
 		}
 	}
-	else
+}
+
+void SoftwareRasterizer::rasterize()
+{
+	for(U32 i = 0; i < getBinCount(); ++i)
 	{
-		skip = true;
+		rasterizeBin(i);
 	}
+}
 
-	return skip;
+ThreadHiveSemaphore* SoftwareRasterizer::rasterize(ThreadHive& hive, ThreadHiveSemaphore* waitSemaphore)
+{
+	SoftwareRasterizer* self = this;
+	return parallelFor(
+		hive, getBinCount(), 1,
+		[self](U32 begin, U32 end, [[maybe_unused]] U32 threadId) {
+			for(U32 i = begin; i < end; ++i)
+			{
+				self->rasterizeBin(i);
+			}
+		},
+		waitSemaphore);
 }
 
-void SoftwareRasterizer::rasterizeTriangle(const Vec4* tri)
+void SoftwareRasterizer::rasterizeBin(U32 binIdx)
 {
-	ANKI_ASSERT(tri);
+	const DynamicArray<U32>& bin = m_bins[binIdx];
+	if(bin.getSize() == 0)
+	{
+		return;
+	}
 
-	const Vec2 windowSize{F32(m_width), F32(m_height)};
-	Array<Vec3, 3> ndc;
-	Array<Vec2, 3> window;
-	Vec2 bboxMin(MAX_F32), bboxMax(MIN_F32);
-	for(U i = 0; i < 3; i++)
+	ANKI_TRACE_SCOPED_EVENT(SCENE_RASTERIZER_RASTERIZE_BIN);
+
+	const UVec2 binCoord(binIdx % m_binCounts.x(), binIdx / m_binCounts.x());
+	const UVec2 rectMin = binCoord * BIN_SIZE;
+	const UVec2 rectMax = (rectMin + BIN_SIZE).min(UVec2(m_width, m_height));
+
+	for(U32 triIdx : bin)
 	{
-		ndc[i] = tri[i].xyz() / tri[i].w();
-		window[i] = (ndc[i].xy() / 2.0f + 0.5f) * windowSize;
+		rasterizeTriangle(m_triangles[triIdx], rectMin, rectMax);
+	}
 
-		for(U j = 0; j < 2; j++)
-		{
-			bboxMin[j] = std::floor(min(bboxMin[j], window[i][j]));
-			bboxMin[j] = clamp(bboxMin[j], 0.0f, windowSize[j]);
+	// The bins are aligned to the tiles so the tiles of this bin are not touched by anyone else
+	updateTiles(rectMin / TILE_SIZE, (rectMax + (TILE_SIZE - 1)) / TILE_SIZE);
+}
 
-			bboxMax[j] = std::ceil(max(bboxMax[j], window[i][j]));
-			bboxMax[j] = clamp(bboxMax[j], 0.0f, windowSize[j]);
-		}
+void SoftwareRasterizer::rasterizeTriangle(const ScreenTriangle& tri, UVec2 rectMin, UVec2 rectMax)
+{
+	Vec2 v0 = tri.m_verts[0];
+	Vec2 v1 = tri.m_verts[1];
+	Vec2 v2 = tri.m_verts[2];
+	F32 z0 = tri.m_depths[0];
+	F32 z1 = tri.m_depths[1];
+	F32 z2 = tri.m_depths[2];
+
+	// Make it counter-clockwise so the edge functions are positive inside the triangle
+	F32 area = (v1.x() - v0.x()) * (v2.y() - v0.y()) - (v1.y() - v0.y()) * (v2.x() - v0.x());
+	if(isZero(area))
+	{
+		return;
 	}
 
-	for(F32 y = bboxMin.y() + 0.5f; y < bboxMax.y() + 0.5f; y += 1.0f)
+	if(area < 0.0f)
 	{
-		for(F32 x = bboxMin.x() + 0.5f; x < bboxMax.x() + 0.5f; x += 1.0f)
+		std::swap(v1, v2);
+		std::swap(z1, z2);
+		area = -area;
+	}
+
+	// The edge functions are e(x, y) = A * x + B * y + C. ei is the barycentric of vertex i times the area
+	const F32 a0 = v1.y() - v2.y();
+	const F32 b0 = v2.x() - v1.x();
+	const F32 c0 = (v2.y() - v1.y()) * v1.x() - (v2.x() - v1.x()) * v1.y();
+	const F32 a1 = v2.y() - v0.y();
+	const F32 b1 = v0.x() - v2.x();
+	const F32 c1 = (v0.y() - v2.y()) * v2.x() - (v0.x() - v2.x()) * v2.y();
+	const F32 a2 = v0.y() - v1.y();
+	const F32 b2 = v1.x() - v0.x();
+	const F32 c2 = (v1.y() - v0.y()) * v0.x() - (v1.x() - v0.x()) * v0.y();
+
+	// The depth is linear in window space
+	const F32 invArea = 1.0f / area;
+	const F32 za = (a0 * z0 + a1 * z1 + a2 * z2) * invArea;
+	const F32 zb = (b0 * z0 + b1 * z1 + b2 * z2) * invArea;
+	const F32 zc = (c0 * z0 + c1 * z1 + c2 * z2) * invArea;
+
+	// The pixels to walk
+	const Vec2 bboxMinf = v0.min(v1).min(v2);
+	const Vec2 bboxMaxf = v0.max(v1).max(v2);
+	const U32 xMin = max(rectMin.x(), U32(max(std::floor(bboxMinf.x()), 0.0f)));
+	const U32 yMin = max(rectMin.y(), U32(max(std::floor(bboxMinf.y()), 0.0f)));
+	const U32 xMax = min(rectMax.x(), U32(max(std::ceil(bboxMaxf.x()), 0.0f)));
+	const U32 yMax = min(rectMax.y(), U32(max(std::ceil(bboxMaxf.y()), 0.0f)));
+
+	// Work in groups of 4 pixels aligned to 4. The bins are aligned to 4 so the groups don't cross bins
+	const U32 xStart = xMin & ~3u;
+	const F32x4 laneOffsets = setF32x4(0.5f, 1.5f, 2.5f, 3.5f);
+	const F32x4 xMinx4 = splatF32x4(F32(xMin));
+	const F32x4 xMaxx4 = splatF32x4(F32(xMax));
+	const F32x4 zero = splatF32x4(0.0f);
+	const F32x4 a0x4 = splatF32x4(a0);
+	const F32x4 a1x4 = splatF32x4(a1);
+	const F32x4 a2x4 = splatF32x4(a2);
+	const F32x4 zax4 = splatF32x4(za);
+
+	for(U32 y = yMin; y < yMax; ++y)
+	{
+		const F32 py = F32(y) + 0.5f;
+		const F32x4 e0Row = splatF32x4(b0 * py + c0);
+		const F32x4 e1Row = splatF32x4(b1 * py + c1);
+		const F32x4 e2Row = splatF32x4(b2 * py + c2);
+		const F32x4 zRow = splatF32x4(zb * py + zc);
+		F32* depthRow = &m_depth[y * m_paddedWidth];
+
+		for(U32 x = xStart; x < xMax; x += 4)
 		{
-			Vec2 p(x, y);
-			Vec3 bc;
-			if(!computeBarycetrinc(window[0], window[1], window[2], p, bc))
+			const F32x4 px = addF32x4(splatF32x4(F32(x)), laneOffsets);
+
+			const F32x4 e0 = addF32x4(mulF32x4(a0x4, px), e0Row);
+			const F32x4 e1 = addF32x4(mulF32x4(a1x4, px), e1Row);
+			const F32x4 e2 = addF32x4(mulF32x4(a2x4, px), e2Row);
+
+			MaskX4 mask = andMaskX4(greaterEqualF32x4(e0, zero), greaterEqualF32x4(e1, zero));
+			mask = andMaskX4(mask, greaterEqualF32x4(e2, zero));
+			mask = andMaskX4(mask, andMaskX4(greaterEqualF32x4(px, xMinx4), lessF32x4(px, xMaxx4)));
+			if(!anyMaskX4(mask))
 			{
-				const F32 z0 = ndc[0].z();
-				const F32 z1 = ndc[1].z();
-				const F32 z2 = ndc[2].z();
+				continue;
+			}
 
-				F32 depth = z0 * bc[0] + z1 * bc[1] + z2 * bc[2];
-				ANKI_ASSERT(depth >= 0.0 && depth <= 1.0);
+			const F32x4 z = addF32x4(mulF32x4(zax4, px), zRow);
+			const F32x4 depth = loadF32x4(depthRow + x);
+			storeF32x4(depthRow + x, selectF32x4(mask, minF32x4(depth, z), depth));
+		}
+	}
+}
 
-				// Clamp it to a bit less that 1.0f because 1.0f will produce a 0 depthi
-				depth = min(depth, 1.0f - EPSILON);
+void SoftwareRasterizer::updateTiles(UVec2 tileMin, UVec2 tileMax)
+{
+	static_assert((TILE_SIZE % 4) == 0, "Wrong assumption");
+	static_assert((BIN_SIZE % TILE_SIZE) == 0, "Wrong assumption");
 
-				// Store the min of the current value and new one
-				const U32 depthi = U32(depth * F32(MAX_U32));
-				m_zbuffer[U32(y) * m_width + U32(x)].min(depthi);
+	for(U32 ty = tileMin.y(); ty < tileMax.y(); ++ty)
+	{
+		for(U32 tx = tileMin.x(); tx < tileMax.x(); ++tx)
+		{
+			F32x4 minDepth = splatF32x4(MAX_F32);
+			F32x4 maxDepth = splatF32x4(MIN_F32);
+
+			const F32* tileDepth = &m_depth[ty * TILE_SIZE * m_paddedWidth + tx * TILE_SIZE];
+			for(U32 y = 0; y < TILE_SIZE; ++y)
+			{
+				for(U32 x = 0; x < TILE_SIZE; x += 4)
+				{
+					const F32x4 depth = loadF32x4(tileDepth + y * m_paddedWidth + x);
+					minDepth = minF32x4(minDepth, depth);
+					maxDepth = maxF32x4(maxDepth, depth);
+				}
 			}
+
+			Tile& tile = m_tiles[ty * m_tileCounts.x() + tx];
+			tile.m_minDepth = horizontalMinF32x4(minDepth);
+			tile.m_maxDepth = horizontalMaxF32x4(maxDepth);
 		}
 	}
 }
@@ -354,31 +543,57 @@ Bool SoftwareRasterizer::visibilityTestInternal(const Aabb& aabb) const
 	}
 
 	// Fix the bounds
-	bboxMin.x() = floorf(bboxMin.x());
-	bboxMin.x() = clamp(bboxMin.x(), 0.0f, F32(m_width));
-
-	bboxMax.x() = ceilf(bboxMax.x());
-	bboxMax.x() = clamp(bboxMax.x(), 0.0f, F32(m_width));
-
-	bboxMin.y() = floorf(bboxMin.y());
-	bboxMin.y() = clamp(bboxMin.y(), 0.0f, F32(m_height));
-
-	bboxMax.y() = ceilf(bboxMax.y());
-	bboxMax.y() = clamp(bboxMax.y(), 0.0f, F32(m_height));
+	const U32 xMin = U32(clamp(floorf(bboxMin.x()), 0.0f, F32(m_width)));
+	const U32 xMax = U32(clamp(ceilf(bboxMax.x()), 0.0f, F32(m_width)));
+	const U32 yMin = U32(clamp(floorf(bboxMin.y()), 0.0f, F32(m_height)));
+	const U32 yMax = U32(clamp(ceilf(bboxMax.y()), 0.0f, F32(m_height)));
+	if(xMin >= xMax || yMin >= yMax)
+	{
+		return false;
+	}
 
-	// Loop the tiles
-	F32 minZ = bboxMin.z();
-	for(F32 y = bboxMin.y(); y < bboxMax.y(); y += 1.0f)
+	// Loop the tiles. The pixels are tested only if the tiles can't decide
+	const F32 minZ = bboxMin.z();
+	const F32x4 minZx4 = splatF32x4(minZ);
+	const F32x4 laneOffsets = setF32x4(0.0f, 1.0f, 2.0f, 3.0f);
+	for(U32 ty = yMin / TILE_SIZE; ty <= (yMax - 1) / TILE_SIZE; ++ty)
 	{
-		for(F32 x = bboxMin.x(); x < bboxMax.x(); x += 1.0f)
+		for(U32 tx = xMin / TILE_SIZE; tx <= (xMax - 1) / TILE_SIZE; ++tx)
 		{
-			const U32 idx = U32(y) * m_width + U32(x);
-			const U32 depthi = m_zbuffer[idx].getNonAtomically();
-			const F32 depthf = F32(depthi) / F32(MAX_U32);
-			if(minZ < depthf)
+			const Tile& tile = m_tiles[ty * m_tileCounts.x() + tx];
+			if(minZ >= tile.m_maxDepth)
 			{
+				// All pixels of the tile are in front of the box
+				continue;
+			}
+
+			if(minZ < tile.m_minDepth)
+			{
+				// All pixels of the tile are behind the box
 				return true;
 			}
+
+			const U32 pxMin = max(xMin, tx * TILE_SIZE);
+			const U32 pxMax = min(xMax, (tx + 1) * TILE_SIZE);
+			const U32 pyMin = max(yMin, ty * TILE_SIZE);
+			const U32 pyMax = min(yMax, (ty + 1) * TILE_SIZE);
+			const F32x4 pxMinx4 = splatF32x4(F32(pxMin));
+			const F32x4 pxMaxx4 = splatF32x4(F32(pxMax));
+
+			for(U32 y = pyMin; y < pyMax; ++y)
+			{
+				const F32* depthRow = &m_depth[y * m_paddedWidth];
+				for(U32 x = pxMin & ~3u; x < pxMax; x += 4)
+				{
+					const F32x4 px = addF32x4(splatF32x4(F32(x)), laneOffsets);
+					MaskX4 mask = andMaskX4(greaterEqualF32x4(px, pxMinx4), lessF32x4(px, pxMaxx4));
+					mask = andMaskX4(mask, lessF32x4(minZx4, loadF32x4(depthRow + x)));
+					if(anyMaskX4(mask))
+					{
+						return true;
+					}
+				}
+			}
 		}
 	}
 
@@ -387,19 +602,14 @@ Bool SoftwareRasterizer::visibilityTestInternal(const Aabb& aabb) const
 
 void SoftwareRasterizer::fillDepthBuffer(ConstWeakArray<F32> depthValues)
 {
-	ANKI_ASSERT(m_zbuffer.getSize() == depthValues.getSize());
+	ANKI_ASSERT(m_width * m_height == depthValues.getSize());
 
-	U32 count = depthValues.getSize();
-	while(count--)
+	for(U32 y = 0; y < m_height; ++y)
 	{
-		F32 depth = depthValues[count];
-		ANKI_ASSERT(depth >= 0.0f && depth <= 1.0f);
-
-		depth = min(depth, 1.0f - EPSILON); // See a few lines above why is that
-
-		const U32 depthi = U32(depth * F32(MAX_U32));
-		m_zbuffer[count].setNonAtomically(depthi);
+		memcpy(&m_depth[y * m_paddedWidth], &depthValues[y * m_width], sizeof(F32) * m_width);
 	}
+
+	updateTiles(UVec2(0u), m_tileCounts);
 }
 
 } // end namespace anki
@@ -9,24 +9,35 @@
 #include <AnKi/Math.h>
 #include <AnKi/Collision/Plane.h>
 #include <AnKi/Util/WeakArray.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/Thread.h>
 
 namespace anki {
 
+// Forward
+class ThreadHive;
+class ThreadHiveSemaphore;
+
 /// @addtogroup scene
 /// @{
 
-/// Software rasterizer for visibility tests.
+/// Software rasterizer for visibility tests. The screen is split in bins and draw() assigns the triangles to the bins
+/// they touch. The bins are rasterized independently so they can run in parallel. The depth buffer is also split in
+/// small tiles that keep the min and max depth of their pixels to reject or accept AABBs without touching the pixels.
 class SoftwareRasterizer
 {
 public:
+	/// The size in pixels of the min/max depth tiles.
+	static constexpr U32 TILE_SIZE = 8;
+
+	/// The size in pixels of the bins. Should be a multiple of TILE_SIZE.
+	static constexpr U32 BIN_SIZE = 64;
+
 	SoftwareRasterizer()
 	{
 	}
 
-	~SoftwareRasterizer()
-	{
-		m_zbuffer.destroy(m_alloc);
-	}
+	~SoftwareRasterizer();
 
 	/// Initialize.
 	void init(const GenericMemoryPoolAllocator<U8>& alloc)
@@ -37,7 +48,7 @@ public:
 	/// Prepare for rendering. Call it before every draw.
 	void prepare(const Mat4& mv, const Mat4& p, U32 width, U32 height);
 
-	/// Render some verts.
+	/// Transform, clip and bin some verts. The actual rasterization happens in rasterize().
 	/// @param[in] verts Pointer to the first vertex to draw.
 	/// @param vertCount The number of verts to draw.
 	/// @param stride The stride (in bytes) of the next vertex.
@@ -45,35 +56,80 @@ public:
 	/// @note It's thread-safe against other draw() invocations only.
 	void draw(const F32* verts, U vertCount, U stride, Bool backfaceCulling);
 
+	/// Rasterize the binned triangles of all draw() calls in the calling thread.
+	void rasterize();
+
+	/// Rasterize the binned triangles of all draw() calls. Every bin will be processed by a single ThreadHive thread.
+	/// @return A semaphore that will be signaled when all bins are done. It doesn't block.
+	ThreadHiveSemaphore* rasterize(ThreadHive& hive, ThreadHiveSemaphore* waitSemaphore = nullptr);
+
 	/// Fill the depth buffer with some values.
 	void fillDepthBuffer(ConstWeakArray<F32> depthValues);
 
 	/// Perform visibility tests.
 	/// @param aabb The Aabb in of the cs in world space.
 	/// @return Return true if it's visible and false otherwise.
+	/// @note It's thread-safe.
 	Bool visibilityTest(const Aabb& aabb) const;
 
+	U32 getBinCount() const
+	{
+		return m_binCounts.x() * m_binCounts.y();
+	}
+
 private:
+	/// A triangle in window space.
+	class ScreenTriangle
+	{
+	public:
+		Array<Vec2, 3> m_verts;
+		Vec3 m_depths;
+	};
+
+	/// Min and max depth of a tile.
+	class Tile
+	{
+	public:
+		F32 m_minDepth;
+		F32 m_maxDepth;
+	};
+
 	GenericMemoryPoolAllocator<U8> m_alloc;
 	Mat4 m_mv; ///< ModelView.
 	Mat4 m_p; ///< Projection.
 	Mat4 m_mvp;
 	Array<Plane, 6> m_planesL; ///< In view space.
 	Array<Plane, 6> m_planesW; ///< In world space.
-	U32 m_width;
-	U32 m_height;
-	DynamicArray<Atomic<U32>> m_zbuffer;
-
-	/// @param tri In clip space.
-	void rasterizeTriangle(const Vec4* tri);
-
-	Bool computeBarycetrinc(const Vec2& a, const Vec2& b, const Vec2& c, const Vec2& p, Vec3& uvw) const;
+	U32 m_width = 0;
+	U32 m_height = 0;
+	U32 m_paddedWidth = 0; ///< Aligned to TILE_SIZE. It's also the stride of the depth buffer.
+	U32 m_paddedHeight = 0; ///< Aligned to TILE_SIZE.
+	DynamicArray<F32> m_depth;
+	DynamicArray<Tile> m_tiles;
+	UVec2 m_tileCounts = UVec2(0u);
+	UVec2 m_binCounts = UVec2(0u);
+
+	DynamicArray<ScreenTriangle> m_triangles;
+	DynamicArray<DynamicArray<U32>> m_bins; ///< Indices to m_triangles.
+	Mutex m_binMtx;
 
 	/// Clip triangle in the near plane.
 	/// @note Triangles in view space.
 	void clipTriangle(const Vec4* inTriangle, Vec4* outTriangles, U& outTriangleCount) const;
 
+	/// Append some triangles to the bins they touch.
+	void binTriangles(const ScreenTriangle* tris, U32 triCount);
+
+	void rasterizeBin(U32 binIdx);
+
+	void rasterizeTriangle(const ScreenTriangle& tri, UVec2 rectMin, UVec2 rectMax);
+
+	/// Re-compute the min and max depth of a range of tiles.
+	void updateTiles(UVec2 tileMin, UVec2 tileMax);
+
 	Bool visibilityTestInternal(const Aabb& aabb) const;
+
+	void destroyBins();
 };
 /// @}
 
@@ -19,6 +19,7 @@
 #include <AnKi/Scene/Components/UiComponent.h>
 #include <AnKi/Scene/Components/SkyboxComponent.h>
 #include <AnKi/Renderer/MainRenderer.h>
+#include <AnKi/Resource/MeshResource.h>
 #include <AnKi/Util/Logger.h>
 #include <AnKi/Util/ThreadHive.h>
 #include <AnKi/Core/ConfigSet.h>
@@ -72,6 +73,33 @@ static Bool spatialInsideFrustum(const FrustumComponent& frc, const SpatialCompo
 	}
 }
 
+/// Ask for a texture size that gives one texel per pixel.
+static void requestTextureStreamingSize(const RenderComponent& rc, const SceneNode& node,
+										const SpatialComponent& spatialc, F32 distanceFromCamera, F32 texStreamingScale,
+										const FrustumComponent& primaryFrc)
+{
+	const F32 dist = max(distanceFromCamera, primaryFrc.getNear());
+	const F32 pixelsPerUnit = texStreamingScale / (2.0f * dist);
+	const F32 uvDensity = (rc.getMesh()) ? rc.getMesh()->getUvDensity() : 0.0f;
+
+	F32 size;
+	if(uvDensity > 0.0f)
+	{
+		// A unit of length in world space covers uvDensity/scale of the UV space
+		const MoveComponent* movec = node.tryGetFirstComponentOfType<MoveComponent>();
+		const F32 scale = (movec) ? movec->getWorldTransform().getScale() : 1.0f;
+		size = pixelsPerUnit * scale / uvDensity;
+	}
+	else
+	{
+		// Unknown density, assume that the texture covers the object once
+		const Aabb& aabb = spatialc.getAabbWorldSpace();
+		size = (aabb.getMax() - aabb.getMin()).xyz().getLength() * pixelsPerUnit;
+	}
+
+	rc.getMaterial()->requestTextureStreamingSize(U32(min(size, F32(MAX_U16))));
+}
+
 /// Used to silent warnings
 template<typename TComponent>
 Bool getComponent(SceneNode& node, TComponent*& comp)
@@ -81,7 +109,7 @@ Bool getComponent(SceneNode& node, TComponent*& comp)
 }
 
 void VisibilityContext::submitNewWork(const FrustumComponent& frc, const FrustumComponent& primaryFrustum,
-									  RenderQueue& rqueue, ThreadHive& hive)
+									  Bool gpuSceneDrawn, RenderQueue& rqueue, ThreadHive& hive)
 {
 	ANKI_TRACE_SCOPED_EVENT(SCENE_VIS_SUBMIT_WORK);
 
@@ -133,6 +161,7 @@ void VisibilityContext::submitNewWork(const FrustumComponent& frc, const Frustum
 	frcCtx->m_visCtx = this;
 	frcCtx->m_frc = &frc;
 	frcCtx->m_primaryFrustum = &primaryFrustum;
+	frcCtx->m_gpuSceneDrawn = gpuSceneDrawn;
 	frcCtx->m_queueViews.create(alloc, hive.getThreadCount());
 	frcCtx->m_visTestsSignalSem = hive.newSemaphore(1);
 	frcCtx->m_renderQueue = &rqueue;
@@ -216,13 +245,13 @@ void GatherVisiblesFromOctreeTask::gather(ThreadHive& hive)
 		},
 		[&](void* placeableUserData) {
 			ANKI_ASSERT(placeableUserData);
-			SpatialComponent* scomp = static_cast<SpatialComponent*>(placeableUserData);
+			const SpatialComponent* scomp = static_cast<const SpatialComponent*>(placeableUserData);
 
-			ANKI_ASSERT(m_spatialCount < m_spatials.getSize());
+			ANKI_ASSERT(m_entryCount < m_entries.getSize());
 
-			m_spatials[m_spatialCount++] = scomp;
+			m_entries[m_entryCount++] = scomp->getCullingIndex();
 
-			if(m_spatialCount == m_spatials.getSize())
+			if(m_entryCount == m_entries.getSize())
 			{
 				flush(hive);
 			}
@@ -239,13 +268,13 @@ void GatherVisiblesFromOctreeTask::gather(ThreadHive& hive)
 
 void GatherVisiblesFromOctreeTask::flush(ThreadHive& hive)
 {
-	if(m_spatialCount)
+	if(m_entryCount)
 	{
 		// Create the task
 		VisibilityTestTask* vis =
 			m_frcCtx->m_visCtx->m_scene->getFrameAllocator().newInstance<VisibilityTestTask>(m_frcCtx);
-		memcpy(&vis->m_spatialsToTest[0], &m_spatials[0], sizeof(m_spatials[0]) * m_spatialCount);
-		vis->m_spatialToTestCount = m_spatialCount;
+		memcpy(&vis->m_entriesToTest[0], &m_entries[0], sizeof(m_entries[0]) * m_entryCount);
+		vis->m_entryToTestCount = m_entryCount;
 
 		// Increase the semaphore to block the CombineResultsTask
 		m_frcCtx->m_visTestsSignalSem->increaseSemaphore(1);
@@ -256,7 +285,7 @@ void GatherVisiblesFromOctreeTask::flush(ThreadHive& hive)
 		hive.submitTasks(&task, 1);
 
 		// Clear count
-		m_spatialCount = 0;
+		m_entryCount = 0;
 	}
 }
 
@@ -275,17 +304,36 @@ void VisibilityTestTask::test(ThreadHive& hive, U32 taskId)
 
 	Timestamp& timestamp = m_frcCtx->m_queueViews[taskId].m_timestamp;
 	timestamp = testedNode.getComponentMaxTimestamp();
+	Timestamp& staticTimestamp = m_frcCtx->m_queueViews[taskId].m_staticTimestamp;
+	staticTimestamp = timestamp;
 
 	const Bool wantsEarlyZ = !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::EARLY_Z)
 							 && m_frcCtx->m_visCtx->m_earlyZDist > 0.0f;
 
+	// The texture streaming requests are based on the size of the objects on the screen of the primary frustum
+	F32 texStreamingScale = 0.0f;
+	if(&testedFrc == &primaryFrc && primaryFrc.getFrustumType() == FrustumType::PERSPECTIVE)
+	{
+		texStreamingScale = m_frcCtx->m_visCtx->m_screenHeight / tan(primaryFrc.getFovY() / 2.0f);
+	}
+
+	// Do the AABB tests of all the entries in one go. It only touches the packed data of the CullingDatabase
+	const CullingDatabase& cullingDb = m_frcCtx->m_visCtx->m_scene->getCullingDatabase();
+	const Plane& nearPlane = primaryFrc.getViewPlanes()[FrustumPlaneType::NEAR];
+	Array<U32, MAX_SPATIALS_PER_VIS_TEST> visibleEntries;
+	Array<F32, MAX_SPATIALS_PER_VIS_TEST> distances;
+	const U32 visibleEntryCount = cullingDb.testFrustum(ConstWeakArray<U32>(&m_entriesToTest[0], m_entryToTestCount),
+														enabledVisibilityTests, testedFrc.getViewPlanes(), nearPlane,
+														WeakArray<U32>(visibleEntries), WeakArray<F32>(distances));
+
 	// Iterate
 	RenderQueueView& result = m_frcCtx->m_queueViews[taskId];
-	for(U i = 0; i < m_spatialToTestCount; ++i)
+	for(U32 i = 0; i < visibleEntryCount; ++i)
 	{
-		SpatialComponent* spatialC = m_spatialsToTest[i];
-		ANKI_ASSERT(spatialC);
-		SceneNode& node = spatialC->getSceneNode();
+		const U32 entryIdx = visibleEntries[i];
+		const SpatialComponent* spatialc = cullingDb.getSpatialComponent(entryIdx);
+		ANKI_ASSERT(spatialc);
+		SceneNode& node = const_cast<SceneNode&>(spatialc->getSceneNode());
 
 		// Skip if it is the same
 		if(ANKI_UNLIKELY(&testedNode == &node))
@@ -293,117 +341,159 @@ void VisibilityTestTask::test(ThreadHive& hive, U32 taskId)
 			continue;
 		}
 
-		// Check what components the frustum needs
-		Bool wantNode = false;
-
-		const RenderComponent* rc = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS)
-					&& getComponent(node, rc);
+		// The AABB passed, do the more expensive tests
+		if(!cullingDb.getAlwaysVisible(entryIdx)
+		   && ((cullingDb.getExactShapeTest(entryIdx) && !spatialInsideFrustum(testedFrc, *spatialc))
+			   || !testAgainstRasterizer(spatialc->getAabbWorldSpace())))
+		{
+			continue;
+		}
 
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::SHADOW_CASTERS)
-					&& getComponent(node, rc) && !!(rc->getFlags() & RenderComponentFlag::CASTS_SHADOW);
+		// Get the components the frustum needs. The CullingDatabase knows which ones the node has
+		const FrustumComponentVisibilityTestFlag tests =
+			cullingDb.getVisibilityTests(entryIdx) & enabledVisibilityTests;
+		auto wants = [&](FrustumComponentVisibilityTestFlag flag) {
+			return !!(tests & flag);
+		};
 
 		const RenderComponent* rtRc = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::ALL_RAY_TRACING)
-					&& getComponent(node, rtRc) && rtRc->getSupportsRayTracing();
+		if(wants(FrustumComponentVisibilityTestFlag::ALL_RAY_TRACING))
+		{
+			rtRc = node.tryGetFirstComponentOfType<RenderComponent>();
+		}
+
+		// The node is wanted for one reason or another so push all of its render components
+		const Bool hasRenderComponents =
+			!!(cullingDb.getVisibilityTests(entryIdx) & FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS);
 
 		const LightComponent* lc = nullptr;
-		wantNode |=
-			!!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::LIGHT_COMPONENTS) && getComponent(node, lc);
+		if(wants(FrustumComponentVisibilityTestFlag::LIGHT_COMPONENTS))
+		{
+			getComponent(node, lc);
+		}
 
 		const LensFlareComponent* lfc = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::LENS_FLARE_COMPONENTS)
-					&& getComponent(node, lfc);
+		if(wants(FrustumComponentVisibilityTestFlag::LENS_FLARE_COMPONENTS))
+		{
+			getComponent(node, lfc);
+		}
 
 		const ReflectionProbeComponent* reflc = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::REFLECTION_PROBES)
-					&& getComponent(node, reflc);
+		if(wants(FrustumComponentVisibilityTestFlag::REFLECTION_PROBES))
+		{
+			getComponent(node, reflc);
+		}
 
 		DecalComponent* decalc = nullptr;
-		wantNode |=
-			!!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::DECALS) && getComponent(node, decalc);
+		if(wants(FrustumComponentVisibilityTestFlag::DECALS))
+		{
+			getComponent(node, decalc);
+		}
 
 		const FogDensityComponent* fogc = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::FOG_DENSITY_COMPONENTS)
-					&& getComponent(node, fogc);
+		if(wants(FrustumComponentVisibilityTestFlag::FOG_DENSITY_COMPONENTS))
+		{
+			getComponent(node, fogc);
+		}
 
 		GlobalIlluminationProbeComponent* giprobec = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::GLOBAL_ILLUMINATION_PROBES)
-					&& getComponent(node, giprobec);
+		if(wants(FrustumComponentVisibilityTestFlag::GLOBAL_ILLUMINATION_PROBES))
+		{
+			getComponent(node, giprobec);
+		}
 
 		GenericGpuComputeJobComponent* computec = nullptr;
-		wantNode |= !!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::GENERIC_COMPUTE_JOB_COMPONENTS)
-					&& getComponent(node, computec);
-
-		UiComponent* uic = nullptr;
-		wantNode |=
-			!!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::UI_COMPONENTS) && getComponent(node, uic);
-
-		SkyboxComponent* skyboxc = nullptr;
-		wantNode |=
-			!!(enabledVisibilityTests & FrustumComponentVisibilityTestFlag::SKYBOX) && getComponent(node, skyboxc);
-
-		if(ANKI_UNLIKELY(!wantNode))
+		if(wants(FrustumComponentVisibilityTestFlag::GENERIC_COMPUTE_JOB_COMPONENTS))
 		{
-			// Skip node
-			continue;
+			getComponent(node, computec);
 		}
 
-		const SpatialComponent* spatialc = node.tryGetFirstComponentOfType<SpatialComponent>();
-		if(ANKI_UNLIKELY(spatialc == nullptr))
+		UiComponent* uic = nullptr;
+		if(wants(FrustumComponentVisibilityTestFlag::UI_COMPONENTS))
 		{
-			continue;
+			getComponent(node, uic);
 		}
 
-		if(!spatialc->getAlwaysVisible()
-		   && (!spatialInsideFrustum(testedFrc, *spatialc) || !testAgainstRasterizer(spatialc->getAabbWorldSpace())))
+		SkyboxComponent* skyboxc = nullptr;
+		if(wants(FrustumComponentVisibilityTestFlag::SKYBOX))
 		{
-			continue;
+			getComponent(node, skyboxc);
 		}
 
+		const F32 distanceFromCamera = distances[i];
+		const Bool staticGeometry = cullingDb.getStaticGeometry(entryIdx);
+
 		WeakArray<RenderQueue> nextQueues;
 		WeakArray<FrustumComponent> nextQueueFrustumComponents; // Optional
 
-		node.iterateComponentsOfType<RenderComponent>([&](const RenderComponent& rc) {
-			RenderableQueueElement* el;
-			if(!!(rc.getFlags() & RenderComponentFlag::FORWARD_SHADING))
-			{
-				el = result.m_forwardShadingRenderables.newElement(alloc);
-			}
-			else
-			{
-				el = result.m_renderables.newElement(alloc);
-			}
+		if(hasRenderComponents)
+		{
+			node.iterateComponentsOfType<RenderComponent>([&](const RenderComponent& rc) {
+				if(m_frcCtx->m_gpuSceneDrawn && rc.getDrawnByGpuScene())
+				{
+					// The GPU visibility will draw it. Still request its textures and add it to RT
+					++result.m_gpuSceneRenderableCount;
+
+					if(texStreamingScale > 0.0f && rc.getMaterial())
+					{
+						const F32 dist = !!(rc.getFlags() & RenderComponentFlag::SORT_LAST) ? primaryFrc.getFar()
+																							 : distanceFromCamera;
+						requestTextureStreamingSize(rc, node, *spatialc, dist, texStreamingScale, primaryFrc);
+					}
+
+					if(rtRc)
+					{
+						RayTracingInstanceQueueElement* el = result.m_rayTracingInstances.newElement(alloc);
+						const F32 dist = testPlane(nearPlane, spatialc->getAabbWorldSpace());
+						rc.setupRayTracingInstanceQueueElement(computeLod(primaryFrc, dist), *el);
+					}
+
+					return;
+				}
 
-			rc.setupRenderableQueueElement(*el);
+				RenderableQueueElement* el;
+				if(!!(rc.getFlags() & RenderComponentFlag::FORWARD_SHADING))
+				{
+					el = result.m_forwardShadingRenderables.newElement(alloc);
+				}
+				else
+				{
+					el = result.m_renderables.newElement(alloc);
+				}
 
-			// Compute distance from the frustum
-			const Plane& nearPlane = primaryFrc.getViewPlanes()[FrustumPlaneType::NEAR];
-			el->m_distanceFromCamera = !!(rc.getFlags() & RenderComponentFlag::SORT_LAST)
-										   ? primaryFrc.getFar()
-										   : max(0.0f, testPlane(nearPlane, spatialc->getAabbWorldSpace()));
+				rc.setupRenderableQueueElement(*el);
 
-			el->m_lod = computeLod(primaryFrc, el->m_distanceFromCamera);
+				el->m_distanceFromCamera =
+					!!(rc.getFlags() & RenderComponentFlag::SORT_LAST) ? primaryFrc.getFar() : distanceFromCamera;
 
-			// Add to early Z
-			if(wantsEarlyZ && el->m_distanceFromCamera < m_frcCtx->m_visCtx->m_earlyZDist
-			   && !(rc.getFlags() & RenderComponentFlag::FORWARD_SHADING))
-			{
-				RenderableQueueElement* el2 = result.m_earlyZRenderables.newElement(alloc);
-				*el2 = *el;
-			}
+				el->m_lod = computeLod(primaryFrc, el->m_distanceFromCamera);
+				el->m_static = staticGeometry;
 
-			// Add to RT
-			if(rtRc)
-			{
-				RayTracingInstanceQueueElement* el = result.m_rayTracingInstances.newElement(alloc);
+				if(texStreamingScale > 0.0f && rc.getMaterial())
+				{
+					requestTextureStreamingSize(rc, node, *spatialc, el->m_distanceFromCamera, texStreamingScale,
+												primaryFrc);
+				}
 
-				// Compute the LOD
-				const Plane& nearPlane = primaryFrc.getViewPlanes()[FrustumPlaneType::NEAR];
-				const F32 dist = testPlane(nearPlane, spatialc->getAabbWorldSpace());
-				rc.setupRayTracingInstanceQueueElement(computeLod(primaryFrc, dist), *el);
-			}
-		});
+				// Add to early Z
+				if(wantsEarlyZ && el->m_distanceFromCamera < m_frcCtx->m_visCtx->m_earlyZDist
+				   && !(rc.getFlags() & RenderComponentFlag::FORWARD_SHADING))
+				{
+					RenderableQueueElement* el2 = result.m_earlyZRenderables.newElement(alloc);
+					*el2 = *el;
+				}
+
+				// Add to RT
+				if(rtRc)
+				{
+					RayTracingInstanceQueueElement* el = result.m_rayTracingInstances.newElement(alloc);
+
+					// Compute the LOD. Objects behind the camera need the signed distance
+					const F32 dist = testPlane(nearPlane, spatialc->getAabbWorldSpace());
+					rc.setupRayTracingInstanceQueueElement(computeLod(primaryFrc, dist), *el);
+				}
+			});
+		}
 
 		if(lc)
 		{
@@ -413,11 +503,7 @@ void VisibilityTestTask::test(ThreadHive& hive, U32 taskId)
 			{
 				// Extra check
 
-				// Compute distance from the frustum
-				const Plane& nearPlane = primaryFrc.getViewPlanes()[FrustumPlaneType::NEAR];
-				const F32 distFromFrustum = max(0.0f, testPlane(nearPlane, spatialc->getAabbWorldSpace()));
-
-				castsShadow = distFromFrustum < primaryFrc.getEffectiveShadowDistance();
+				castsShadow = distanceFromCamera < primaryFrc.getEffectiveShadowDistance();
 			}
 
 			switch(lc->getLightComponentType())
@@ -622,23 +708,31 @@ void VisibilityTestTask::test(ThreadHive& hive, U32 taskId)
 		{
 			U32 count = 0;
 
+			// Only the shadows of the lights the GPU scene is drawn for use the GPU visibility. Probes render the
+			// GpuSceneInstances from their render queues like everything else
+			const Bool gpuSceneDrawn = m_frcCtx->m_gpuSceneDrawn && lc != nullptr;
+
 			if(ANKI_LIKELY(nextQueueFrustumComponents.getSize() == 0))
 			{
 				node.iterateComponentsOfType<FrustumComponent>([&](FrustumComponent& frc) {
-					m_frcCtx->m_visCtx->submitNewWork(frc, primaryFrc, nextQueues[count++], hive);
+					m_frcCtx->m_visCtx->submitNewWork(frc, primaryFrc, gpuSceneDrawn, nextQueues[count++], hive);
 				});
 			}
 			else
 			{
 				for(FrustumComponent& frc : nextQueueFrustumComponents)
 				{
-					m_frcCtx->m_visCtx->submitNewWork(frc, primaryFrc, nextQueues[count++], hive);
+					m_frcCtx->m_visCtx->submitNewWork(frc, primaryFrc, gpuSceneDrawn, nextQueues[count++], hive);
 				}
 			}
 		}
 
 		// Update timestamp
 		timestamp = max(timestamp, node.getComponentMaxTimestamp());
+		if(staticGeometry)
+		{
+			staticTimestamp = max(staticTimestamp, node.getComponentMaxTimestamp());
+		}
 	} // end for
 }
 
@@ -649,13 +743,20 @@ void CombineResultsTask::combine()
 	auto alloc = m_frcCtx->m_visCtx->m_scene->getFrameAllocator();
 	RenderQueue& results = *m_frcCtx->m_renderQueue;
 
-	// Compute the timestamp
+	// Compute the timestamps. Static geometry that was removed from this frustum won't be in the views so consider it
+	// as well
 	const U32 threadCount = m_frcCtx->m_queueViews.getSize();
-	results.m_shadowRenderablesLastUpdateTimestamp = 0;
+	const Timestamp staticGeometryRemovedTimestamp =
+		m_frcCtx->m_visCtx->m_scene->getCullingDatabase().getStaticGeometryRemovedTimestamp(
+			m_frcCtx->m_frc->getViewPlanes());
+	results.m_shadowRenderablesLastUpdateTimestamp = staticGeometryRemovedTimestamp;
+	results.m_staticShadowRenderablesLastUpdateTimestamp = staticGeometryRemovedTimestamp;
 	for(U32 i = 0; i < threadCount; ++i)
 	{
 		results.m_shadowRenderablesLastUpdateTimestamp =
 			max(results.m_shadowRenderablesLastUpdateTimestamp, m_frcCtx->m_queueViews[i].m_timestamp);
+		results.m_staticShadowRenderablesLastUpdateTimestamp =
+			max(results.m_staticShadowRenderablesLastUpdateTimestamp, m_frcCtx->m_queueViews[i].m_staticTimestamp);
 	}
 	ANKI_ASSERT(results.m_shadowRenderablesLastUpdateTimestamp);
 
@@ -695,6 +796,8 @@ void CombineResultsTask::combine()
 		{
 			results.m_skybox = m_frcCtx->m_queueViews[i].m_skybox;
 		}
+
+		results.m_gpuSceneRenderableCount += m_frcCtx->m_queueViews[i].m_gpuSceneRenderableCount;
 	}
 
 #undef ANKI_VIS_COMBINE
@@ -713,6 +816,31 @@ void CombineResultsTask::combine()
 		std::sort(results.m_forwardShadingRenderables.getBegin(), results.m_forwardShadingRenderables.getEnd(),
 				  RevDistanceSortFunctor<RenderableQueueElement>());
 	}
+	else
+	{
+		// Static casters first so the shadow mapping can cache them separately from the rest. Keep the order of both
+		U32 staticCount = 0;
+		for(const RenderableQueueElement& el : results.m_renderables)
+		{
+			staticCount += el.m_static;
+		}
+
+		if(staticCount > 0 && staticCount < results.m_renderables.getSize())
+		{
+			RenderableQueueElement* partitioned =
+				alloc.newArray<RenderableQueueElement>(results.m_renderables.getSize());
+			U32 staticIdx = 0;
+			U32 dynamicIdx = staticCount;
+			for(const RenderableQueueElement& el : results.m_renderables)
+			{
+				partitioned[(el.m_static) ? staticIdx++ : dynamicIdx++] = el;
+			}
+
+			results.m_renderables = WeakArray<RenderableQueueElement>(partitioned, results.m_renderables.getSize());
+		}
+
+		results.m_staticShadowRenderableCount = staticCount;
+	}
 
 	std::sort(results.m_giProbes.getBegin(), results.m_giProbes.getEnd());
 
@@ -852,8 +980,9 @@ void SceneGraph::doVisibilityTests(SceneNode& fsn, SceneGraph& scene, RenderQueu
 	VisibilityContext ctx;
 	ctx.m_scene = &scene;
 	ctx.m_earlyZDist = scene.getConfig().getSceneEarlyZDistance();
+	ctx.m_screenHeight = F32(scene.getConfig().getHeight());
 	const FrustumComponent& mainFrustum = fsn.getFirstComponentOfType<FrustumComponent>();
-	ctx.submitNewWork(mainFrustum, mainFrustum, rqueue, hive);
+	ctx.submitNewWork(mainFrustum, mainFrustum, scene.getGpuScene().getGpuDrivenRenderingEnabled(), rqueue, hive);
 
 	const FrustumComponent* extendedFrustum = fsn.tryGetNthComponentOfType<FrustumComponent>(1);
 	if(extendedFrustum)
@@ -863,7 +992,7 @@ void SceneGraph::doVisibilityTests(SceneNode& fsn, SceneGraph& scene, RenderQueu
 			!(extendedFrustum->getEnabledVisibilityTests() & ~FrustumComponentVisibilityTestFlag::ALL_RAY_TRACING));
 
 		rqueue.m_rayTracingQueue = scene.getFrameAllocator().newInstance<RenderQueue>();
-		ctx.submitNewWork(*extendedFrustum, mainFrustum, *rqueue.m_rayTracingQueue, hive);
+		ctx.submitNewWork(*extendedFrustum, mainFrustum, false, *rqueue.m_rayTracingQueue, hive);
 	}
 
 	hive.waitAllTasks();
@@ -108,7 +108,10 @@ public:
 	SkyboxQueueElement m_skybox;
 	Bool m_skyboxSet = false;
 
+	U32 m_gpuSceneRenderableCount = 0;
+
 	Timestamp m_timestamp = 0;
+	Timestamp m_staticTimestamp = 0; ///< Like m_timestamp but only for the static geometry.
 
 	RenderQueueView()
 	{
@@ -127,12 +130,14 @@ public:
 	Atomic<U32> m_testsCount = {0};
 
 	F32 m_earlyZDist = -1.0f; ///< Cache this.
+	F32 m_screenHeight = 0.0f; ///< Cache this.
 
 	List<const FrustumComponent*> m_testedFrcs;
 	Mutex m_mtx;
 
-	void submitNewWork(const FrustumComponent& frc, const FrustumComponent& primaryFrustum, RenderQueue& result,
-					   ThreadHive& hive);
+	/// @param gpuSceneDrawn The renderer will draw the GpuSceneInstances of the frustum with the GPU visibility.
+	void submitNewWork(const FrustumComponent& frc, const FrustumComponent& primaryFrustum, Bool gpuSceneDrawn,
+					   RenderQueue& result, ThreadHive& hive);
 };
 
 /// A context for a specific test of a frustum component.
@@ -145,6 +150,9 @@ public:
 	const FrustumComponent* m_frc = nullptr; ///< This is the frustum to be tested.
 	const FrustumComponent* m_primaryFrustum = nullptr; ///< This is the primary camera frustum.
 
+	/// Don't push the render components that are drawn by the GPU scene. See VisibilityContext::submitNewWork().
+	Bool m_gpuSceneDrawn = false;
+
 	// S/W rasterizer members
 	SoftwareRasterizer* m_r = nullptr;
 	DynamicArray<Vec3> m_verts;
@@ -190,10 +198,10 @@ public:
 	void gather(ThreadHive& hive);
 
 private:
-	Array<SpatialComponent*, MAX_SPATIALS_PER_VIS_TEST> m_spatials;
-	U32 m_spatialCount = 0;
+	Array<U32, MAX_SPATIALS_PER_VIS_TEST> m_entries; ///< Indices to the CullingDatabase.
+	U32 m_entryCount = 0;
 
-	/// Submit tasks to test the m_spatials.
+	/// Submit tasks to test the m_entries.
 	void flush(ThreadHive& hive);
 };
 static_assert(std::is_trivially_destructible<GatherVisiblesFromOctreeTask>::value == true,
@@ -205,8 +213,8 @@ class VisibilityTestTask
 public:
 	FrustumVisibilityContext* m_frcCtx = nullptr;
 
-	Array<SpatialComponent*, MAX_SPATIALS_PER_VIS_TEST> m_spatialsToTest;
-	U32 m_spatialToTestCount = 0;
+	Array<U32, MAX_SPATIALS_PER_VIS_TEST> m_entriesToTest; ///< Indices to the CullingDatabase.
+	U32 m_entryToTestCount = 0;
 
 	VisibilityTestTask(FrustumVisibilityContext* frcCtx)
 		: m_frcCtx(frcCtx)
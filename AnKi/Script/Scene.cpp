@@ -2591,6 +2591,149 @@ static int wrapGlobalIlluminationProbeComponentgetFadeDistance(lua_State* l)
 	return 0;
 }
 
+/// Pre-wrap method GlobalIlluminationProbeComponent::setDynamic.
+static inline int pwrapGlobalIlluminationProbeComponentsetDynamic(lua_State* l)
+{
+	[[maybe_unused]] LuaUserData* ud;
+	[[maybe_unused]] void* voidp;
+	[[maybe_unused]] PtrSize size;
+
+	if(ANKI_UNLIKELY(LuaBinder::checkArgsCount(l, 2)))
+	{
+		return -1;
+	}
+
+	// Get "this" as "self"
+	if(LuaBinder::checkUserData(l, 1, luaUserDataTypeInfoGlobalIlluminationProbeComponent, ud))
+	{
+		return -1;
+	}
+
+	GlobalIlluminationProbeComponent* self = ud->getData<GlobalIlluminationProbeComponent>();
+
+	// Pop arguments
+	Bool arg0;
+	if(ANKI_UNLIKELY(LuaBinder::checkNumber(l, 2, arg0)))
+	{
+		return -1;
+	}
+
+	// Call the method
+	self->setDynamic(arg0);
+
+	return 0;
+}
+
+/// Wrap method GlobalIlluminationProbeComponent::setDynamic.
+static int wrapGlobalIlluminationProbeComponentsetDynamic(lua_State* l)
+{
+	int res = pwrapGlobalIlluminationProbeComponentsetDynamic(l);
+	if(res >= 0)
+	{
+		return res;
+	}
+
+	lua_error(l);
+	return 0;
+}
+
+/// Pre-wrap method GlobalIlluminationProbeComponent::getDynamic.
+static inline int pwrapGlobalIlluminationProbeComponentgetDynamic(lua_State* l)
+{
+	[[maybe_unused]] LuaUserData* ud;
+	[[maybe_unused]] void* voidp;
+	[[maybe_unused]] PtrSize size;
+
+	if(ANKI_UNLIKELY(LuaBinder::checkArgsCount(l, 1)))
+	{
+		return -1;
+	}
+
+	// Get "this" as "self"
+	if(LuaBinder::checkUserData(l, 1, luaUserDataTypeInfoGlobalIlluminationProbeComponent, ud))
+	{
+		return -1;
+	}
+
+	GlobalIlluminationProbeComponent* self = ud->getData<GlobalIlluminationProbeComponent>();
+
+	// Call the method
+	Bool ret = self->getDynamic();
+
+	// Push return value
+	lua_pushboolean(l, ret);
+
+	return 1;
+}
+
+/// Wrap method GlobalIlluminationProbeComponent::getDynamic.
+static int wrapGlobalIlluminationProbeComponentgetDynamic(lua_State* l)
+{
+	int res = pwrapGlobalIlluminationProbeComponentgetDynamic(l);
+	if(res >= 0)
+	{
+		return res;
+	}
+
+	lua_error(l);
+	return 0;
+}
+
+/// Pre-wrap method GlobalIlluminationProbeComponent::setBakedImageFilename.
+static inline int pwrapGlobalIlluminationProbeComponentsetBakedImageFilename(lua_State* l)
+{
+	[[maybe_unused]] LuaUserData* ud;
+	[[maybe_unused]] void* voidp;
+	[[maybe_unused]] PtrSize size;
+
+	if(ANKI_UNLIKELY(LuaBinder::checkArgsCount(l, 2)))
+	{
+		return -1;
+	}
+
+	// Get "this" as "self"
+	if(LuaBinder::checkUserData(l, 1, luaUserDataTypeInfoGlobalIlluminationProbeComponent, ud))
+	{
+		return -1;
+	}
+
+	GlobalIlluminationProbeComponent* self = ud->getData<GlobalIlluminationProbeComponent>();
+
+	// Pop arguments
+	const char* arg0;
+	if(ANKI_UNLIKELY(LuaBinder::checkString(l, 2, arg0)))
+	{
+		return -1;
+	}
+
+	// Call the method
+	Error ret = self->setBakedImageFilename(arg0);
+
+	// Push return value
+	if(ANKI_UNLIKELY(ret))
+	{
+		lua_pushstring(l, "Glue code returned an error");
+		return -1;
+	}
+
+	lua_pushnumber(l, lua_Number(!!ret));
+
+	return 1;
+}
+
+/// Wrap method GlobalIlluminationProbeComponent::setBakedImageFilename.
+static int wrapGlobalIlluminationProbeComponentsetBakedImageFilename(lua_State* l)
+{
+	int res = pwrapGlobalIlluminationProbeComponentsetBakedImageFilename(l);
+	if(res >= 0)
+	{
+		return res;
+	}
+
+	lua_error(l);
+	return 0;
+}
+
 /// Wrap class GlobalIlluminationProbeComponent.
 static inline void wrapGlobalIlluminationProbeComponent(lua_State* l)
 {
@@ -2600,6 +2743,10 @@ static inline void wrapGlobalIlluminationProbeComponent(lua_State* l)
 	LuaBinder::pushLuaCFuncMethod(l, "getCellSize", wrapGlobalIlluminationProbeComponentgetCellSize);
 	LuaBinder::pushLuaCFuncMethod(l, "setFadeDistance", wrapGlobalIlluminationProbeComponentsetFadeDistance);
 	LuaBinder::pushLuaCFuncMethod(l, "getFadeDistance", wrapGlobalIlluminationProbeComponentgetFadeDistance);
+	LuaBinder::pushLuaCFuncMethod(l, "setDynamic", wrapGlobalIlluminationProbeComponentsetDynamic);
+	LuaBinder::pushLuaCFuncMethod(l, "getDynamic", wrapGlobalIlluminationProbeComponentgetDynamic);
+	LuaBinder::pushLuaCFuncMethod(l, "setBakedImageFilename",
+								  wrapGlobalIlluminationProbeComponentsetBakedImageFilename);
 	lua_settop(l, 0);
 }
 
@@ -2710,12 +2857,158 @@ static int wrapReflectionProbeComponentgetBoxVolumeSize(lua_State* l)
 	return 0;
 }
 
+/// Pre-wrap method ReflectionProbeComponent::setDynamic.
+static inline int pwrapReflectionProbeComponentsetDynamic(lua_State* l)
+{
+	[[maybe_unused]] LuaUserData* ud;
+	[[maybe_unused]] void* voidp;
+	[[maybe_unused]] PtrSize size;
+
+	if(ANKI_UNLIKELY(LuaBinder::checkArgsCount(l, 2)))
+	{
+		return -1;
+	}
+
+	// Get "this" as "self"
+	if(LuaBinder::checkUserData(l, 1, luaUserDataTypeInfoReflectionProbeComponent, ud))
+	{
+		return -1;
+	}
+
+	ReflectionProbeComponent* self = ud->getData<ReflectionProbeComponent>();
+
+	// Pop arguments
+	Bool arg0;
+	if(ANKI_UNLIKELY(LuaBinder::checkNumber(l, 2, arg0)))
+	{
+		return -1;
+	}
+
+	// Call the method
+	self->setDynamic(arg0);
+
+	return 0;
+}
+
+/// Wrap method ReflectionProbeComponent::setDynamic.
+static int wrapReflectionProbeComponentsetDynamic(lua_State* l)
+{
+	int res = pwrapReflectionProbeComponentsetDynamic(l);
+	if(res >= 0)
+	{
+		return res;
+	}
+
+	lua_error(l);
+	return 0;
+}
+
+/// Pre-wrap method ReflectionProbeComponent::getDynamic.
+static inline int pwrapReflectionProbeComponentgetDynamic(lua_State* l)
+{
+	[[maybe_unused]] LuaUserData* ud;
+	[[maybe_unused]] void* voidp;
+	[[maybe_unused]] PtrSize size;
+
+	if(ANKI_UNLIKELY(LuaBinder::checkArgsCount(l, 1)))
+	{
+		return -1;
+	}
+
+	// Get "this" as "self"
+	if(LuaBinder::checkUserData(l, 1, luaUserDataTypeInfoReflectionProbeComponent, ud))
+	{
+		return -1;
+	}
+
+	ReflectionProbeComponent* self = ud->getData<ReflectionProbeComponent>();
+
+	// Call the method
+	Bool ret = self->getDynamic();
+
+	// Push return value
+	lua_pushboolean(l, ret);
+
+	return 1;
+}
+
+/// Wrap method ReflectionProbeComponent::getDynamic.
+static int wrapReflectionProbeComponentgetDynamic(lua_State* l)
+{
+	int res = pwrapReflectionProbeComponentgetDynamic(l);
+	if(res >= 0)
+	{
+		return res;
+	}
+
+	lua_error(l);
+	return 0;
+}
+
+/// Pre-wrap method ReflectionProbeComponent::setBakedImageFilename.
+static inline int pwrapReflectionProbeComponentsetBakedImageFilename(lua_State* l)
+{
+	[[maybe_unused]] LuaUserData* ud;
+	[[maybe_unused]] void* voidp;
+	[[maybe_unused]] PtrSize size;
+
+	if(ANKI_UNLIKELY(LuaBinder::checkArgsCount(l, 2)))
+	{
+		return -1;
+	}
+
+	// Get "this" as "self"
+	if(LuaBinder::checkUserData(l, 1, luaUserDataTypeInfoReflectionProbeComponent, ud))
+	{
+		return -1;
+	}
+
+	ReflectionProbeComponent* self = ud->getData<ReflectionProbeComponent>();
+
+	// Pop arguments
+	const char* arg0;
+	if(ANKI_UNLIKELY(LuaBinder::checkString(l, 2, arg0)))
+	{
+		return -1;
+	}
+
+	// Call the method
+	Error ret = self->setBakedImageFilename(arg0);
+
+	// Push return value
+	if(ANKI_UNLIKELY(ret))
+	{
+		lua_pushstring(l, "Glue code returned an error");
+		return -1;
+	}
+
+	lua_pushnumber(l, lua_Number(!!ret));
+
+	return 1;
+}
+
+/// Wrap method ReflectionProbeComponent::setBakedImageFilename.
+static int wrapReflectionProbeComponentsetBakedImageFilename(lua_State* l)
+{
+	int res = pwrapReflectionProbeComponentsetBakedImageFilename(l);
+	if(res >= 0)
+	{
+		return res;
+	}
+
+	lua_error(l);
+	return 0;
+}
+
 /// Wrap class ReflectionProbeComponent.
 static inline void wrapReflectionProbeComponent(lua_State* l)
 {
 	LuaBinder::createClass(l, &luaUserDataTypeInfoReflectionProbeComponent);
 	LuaBinder::pushLuaCFuncMethod(l, "setBoxVolumeSize", wrapReflectionProbeComponentsetBoxVolumeSize);
 	LuaBinder::pushLuaCFuncMethod(l, "getBoxVolumeSize", wrapReflectionProbeComponentgetBoxVolumeSize);
+	LuaBinder::pushLuaCFuncMethod(l, "setDynamic", wrapReflectionProbeComponentsetDynamic);
+	LuaBinder::pushLuaCFuncMethod(l, "getDynamic", wrapReflectionProbeComponentgetDynamic);
+	LuaBinder::pushLuaCFuncMethod(l, "setBakedImageFilename", wrapReflectionProbeComponentsetBakedImageFilename);
 	lua_settop(l, 0);
 }
 
@@ -14,15 +14,18 @@ layout(set = 0, binding = 1) uniform texture2D u_tex;
 #	define USE_COMPUTE 0
 #endif
 
-#if USE_COMPUTE
-layout(set = 0, binding = 2) uniform writeonly image2D u_outImage;
-
 layout(push_constant, std140) uniform b_pc
 {
+	Vec4 u_uvScaleAndMax; ///< In case only a part of the input texture is valid. See scaleRenderingUv().
+#if USE_COMPUTE
 	Vec2 u_viewportSize;
 	UVec2 u_viewportSizeU;
+#endif
 };
 
+#if USE_COMPUTE
+layout(set = 0, binding = 2) uniform writeonly image2D u_outImage;
+
 layout(local_size_x = 8, local_size_y = 8) in;
 #else
 layout(location = 0) in Vec2 in_uv;
@@ -42,7 +45,7 @@ void main()
 	const Vec2 uv = in_uv;
 #endif
 
-	const Vec3 color = textureLod(u_tex, u_linearAnyClampSampler, uv, 0.0).rgb;
+	const Vec3 color = textureLod(u_tex, u_linearAnyClampSampler, scaleRenderingUv(uv, u_uvScaleAndMax), 0.0).rgb;
 
 #if USE_COMPUTE
 	imageStore(u_outImage, IVec2(gl_GlobalInvocationID.xy), Vec4(color, 0.0));
@@ -42,6 +42,7 @@ const F32 OFFSET = 1.25;
 
 layout(set = 0, binding = 1) uniform sampler u_linearAnyClampSampler;
 layout(set = 0, binding = 2) uniform texture2D u_inputTex;
+layout(set = 0, binding = 4) uniform texture2D u_staticCacheTex;
 
 #	if defined(ANKI_COMPUTE_SHADER)
 layout(set = 0, binding = 3) uniform writeonly image2D u_outImg;
@@ -53,9 +54,21 @@ layout(location = 1) flat in I32 in_instanceIndex;
 layout(location = 0) out Vec4 out_moments;
 #	endif
 
-Vec4 computeMoments(Vec2 uv)
+Vec4 computeMoments(EvsmResolveUniforms uni, Vec2 uv)
 {
-	const F32 d = textureLod(u_inputTex, u_linearAnyClampSampler, uv, 0.0).r;
+	// The shadow of the dynamic casters is in the scratch and of the static ones in the static cache. Combine them
+	F32 d = 1.0;
+	if((uni.m_inputs & EVSM_INPUT_SCRATCH) != 0u)
+	{
+		d = textureLod(u_inputTex, u_linearAnyClampSampler, uv, 0.0).r;
+	}
+
+	if((uni.m_inputs & EVSM_INPUT_STATIC_CACHE) != 0u)
+	{
+		const Vec2 staticCacheUv = uv * uni.m_staticCacheUvScale + uni.m_staticCacheUvTranslation;
+		d = min(d, textureLod(u_staticCacheTex, u_linearAnyClampSampler, staticCacheUv, 0.0).r);
+	}
+
 	const Vec2 posAndNeg = evsmProcessDepth(d);
 	return Vec4(posAndNeg.x, posAndNeg.x * posAndNeg.x, posAndNeg.y, posAndNeg.y * posAndNeg.y);
 }
@@ -87,19 +100,19 @@ void main()
 	Vec4 moments;
 	if(uni.m_blur != 0u)
 	{
-		moments = computeMoments(uv) * w0;
-		moments += computeMoments(clamp(uv + Vec2(UV_OFFSET.x, 0.0), minUv, maxUv)) * w1;
-		moments += computeMoments(clamp(uv + Vec2(-UV_OFFSET.x, 0.0), minUv, maxUv)) * w1;
-		moments += computeMoments(clamp(uv + Vec2(0.0, UV_OFFSET.y), minUv, maxUv)) * w1;
-		moments += computeMoments(clamp(uv + Vec2(0.0, -UV_OFFSET.y), minUv, maxUv)) * w1;
-		moments += computeMoments(clamp(uv + Vec2(UV_OFFSET.x, UV_OFFSET.y), minUv, maxUv)) * w2;
-		moments += computeMoments(clamp(uv + Vec2(-UV_OFFSET.x, UV_OFFSET.y), minUv, maxUv)) * w2;
-		moments += computeMoments(clamp(uv + Vec2(UV_OFFSET.x, -UV_OFFSET.y), minUv, maxUv)) * w2;
-		moments += computeMoments(clamp(uv + Vec2(-UV_OFFSET.x, -UV_OFFSET.y), minUv, maxUv)) * w2;
+		moments = computeMoments(uni, uv) * w0;
+		moments += computeMoments(uni, clamp(uv + Vec2(UV_OFFSET.x, 0.0), minUv, maxUv)) * w1;
+		moments += computeMoments(uni, clamp(uv + Vec2(-UV_OFFSET.x, 0.0), minUv, maxUv)) * w1;
+		moments += computeMoments(uni, clamp(uv + Vec2(0.0, UV_OFFSET.y), minUv, maxUv)) * w1;
+		moments += computeMoments(uni, clamp(uv + Vec2(0.0, -UV_OFFSET.y), minUv, maxUv)) * w1;
+		moments += computeMoments(uni, clamp(uv + Vec2(UV_OFFSET.x, UV_OFFSET.y), minUv, maxUv)) * w2;
+		moments += computeMoments(uni, clamp(uv + Vec2(-UV_OFFSET.x, UV_OFFSET.y), minUv, maxUv)) * w2;
+		moments += computeMoments(uni, clamp(uv + Vec2(UV_OFFSET.x, -UV_OFFSET.y), minUv, maxUv)) * w2;
+		moments += computeMoments(uni, clamp(uv + Vec2(-UV_OFFSET.x, -UV_OFFSET.y), minUv, maxUv)) * w2;
 	}
 	else
 	{
-		moments = computeMoments(uv);
+		moments = computeMoments(uni, uv);
 	}
 
 	// Write the results
@@ -136,7 +136,9 @@ void fog(ANKI_RP Vec3 color, ANKI_RP F32 fogAlphaScale, ANKI_RP F32 fogDistanceO
 	const Vec2 screenSize = 1.0 / u_clusteredShading.m_renderingSize;
 
 	const Vec2 texCoords = gl_FragCoord.xy * screenSize;
-	const F32 depth = textureLod(u_gbufferDepthRt, u_linearAnyClampSampler, texCoords, 0.0).r;
+	const F32 depth = textureLod(u_gbufferDepthRt, u_linearAnyClampSampler,
+								 scaleRenderingUv(texCoords, u_clusteredShading.m_renderingUvScaleAndMax), 0.0)
+						  .r;
 	F32 zFeatherFactor;
 
 	const Vec4 fragPosVspace4 =
@@ -677,3 +677,12 @@ Vec3 sRgbToLinear(Vec3 sRgb)
 	const Vec3 lower = sRgb / 12.92;
 	return mix(higher, lower, cutoff);
 }
+
+/// The render targets up until TAA are allocated with the max internal resolution and only their top left part is
+/// rendered. Convert [0, 1] viewport UVs to UVs of such a render target. The result is clamped to the center of the last
+/// rendered texel so linear filtering doesn't read the parts that were not rendered.
+/// @param uvScaleAndMax See Renderer::getInternalResolutionUvScaleAndMax().
+Vec2 scaleRenderingUv(Vec2 uv, Vec4 uvScaleAndMax)
+{
+	return min(uv * uvScaleAndMax.xy, uvScaleAndMax.zw);
+}
@@ -222,10 +222,14 @@ ANKI_SHADER_STATIC_ASSERT(sizeof(CommonMatrices) == _ANKI_SIZEOF_CommonMatrices)
 /// Common uniforms for light shading passes.
 struct ClusteredShadingUniforms
 {
-	Vec2 m_renderingSize;
+	Vec2 m_renderingSize; ///< The internal resolution of this frame.
 	F32 m_time;
 	U32 m_frame;
 
+	/// To sample the render targets of the internal resolution. See scaleRenderingUv().
+	Vec4 m_renderingUvScaleAndMax;
+	Vec4 m_halfRenderingUvScaleAndMax; ///< Same as m_renderingUvScaleAndMax for render targets of half resolution.
+
 	Vec4 m_nearPlaneWSpace;
 
 	Vec3 m_cameraPosition;
@@ -251,7 +255,7 @@ struct ClusteredShadingUniforms
 	/// This are some additive counts used to map a flat index to the index of the specific object.
 	UVec4 m_objectCountsUpTo[CLUSTER_OBJECT_TYPE_COUNT];
 };
-const U32 _ANKI_SIZEOF_ClusteredShadingUniforms = (6u + CLUSTER_OBJECT_TYPE_COUNT) * ANKI_SIZEOF(Vec4)
+const U32 _ANKI_SIZEOF_ClusteredShadingUniforms = (8u + CLUSTER_OBJECT_TYPE_COUNT) * ANKI_SIZEOF(Vec4)
 												  + 2u * ANKI_SIZEOF(CommonMatrices) + ANKI_SIZEOF(DirectionalLight);
 ANKI_SHADER_STATIC_ASSERT(sizeof(ClusteredShadingUniforms) == _ANKI_SIZEOF_ClusteredShadingUniforms);
 
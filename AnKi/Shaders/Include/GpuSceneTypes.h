@@ -9,15 +9,78 @@
 
 ANKI_BEGIN_NAMESPACE
 
+/// The GPU data of a renderable. It lives in the GPU scene or it's uploaded per drawcall.
 struct RenderableGpuView
 {
 	Mat3x4 m_worldTransform;
 	Mat3x4 m_previousWorldTransform;
 };
 
+/// The new value of a RenderableGpuView of the GPU scene.
+struct GpuSceneRenderableUpdate
+{
+	RenderableGpuView m_view;
+
+	U32 m_index; ///< The index of the RenderableGpuView in the GPU scene.
+	U32 m_padding0;
+	U32 m_padding1;
+	U32 m_padding2;
+};
+
 struct SkinGpuView
 {
 	U32 m_tmp;
 };
 
+/// An instance of a model patch that lives in the GPU scene. The GPU visibility culls them and builds the drawcalls.
+struct GpuSceneInstance
+{
+	Vec3 m_aabbMin; ///< World space.
+	U32 m_renderableGpuViewIndex; ///< The RenderableGpuView of the instance.
+
+	Vec3 m_aabbMax; ///< World space.
+	U32 m_drawGroupIndex; ///< The GpuVisibilityDrawGroup of the instance. If it's MAX_U32 the instance is unused.
+};
+
+/// The new value of a GpuSceneInstance of the GPU scene.
+struct GpuSceneInstanceUpdate
+{
+	GpuSceneInstance m_instance;
+
+	U32 m_index; ///< The index of the GpuSceneInstance in the GPU scene.
+	U32 m_padding0;
+	U32 m_padding1;
+	U32 m_padding2;
+};
+
+/// The instances that share a model patch. All the visible instances of a group that have the same LOD become a
+/// single indirect drawcall.
+struct GpuVisibilityDrawGroup
+{
+	UVec4 m_firstIndices; ///< One per LOD.
+	UVec4 m_indexCounts; ///< One per LOD.
+
+	U32 m_firstInstance; ///< The sum of the m_instanceCount of the groups that are drawn before this one.
+	U32 m_instanceCount; ///< The max number of instances the group may have.
+	U32 m_castsShadow;
+	U32 m_padding0;
+};
+
+struct GpuVisibilityUniforms
+{
+	Mat4 m_viewProjectionMatrix;
+	Mat4 m_hizViewProjectionMatrix; ///< The matrix the HiZ was rendered with.
+
+	Vec3 m_cameraOrigin; ///< Used to compute the LOD.
+	U32 m_instanceCount;
+
+	Vec2 m_hizSize; ///< The size of the 1st mip of the HiZ.
+	U32 m_hizMipCount; ///< If it's zero there is no occlusion testing.
+	U32 m_shadowCastersOnly;
+
+	Vec2 m_lodDistances; ///< The max distance of LOD 0 and of LOD 1.
+	U32 m_minLod;
+	U32 m_maxLod;
+};
+
 ANKI_END_NAMESPACE
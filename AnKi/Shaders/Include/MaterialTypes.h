@@ -34,11 +34,15 @@ const U32 MATERIAL_BINDING_LIGHT_VOLUME = 4u;
 const U32 MATERIAL_BINDING_CLUSTER_SHADING_UNIFORMS = 5u;
 const U32 MATERIAL_BINDING_CLUSTER_SHADING_LIGHTS = 6u;
 const U32 MATERIAL_BINDING_CLUSTERS = 9u;
+
+// For renderables that live in the GPU scene:
+const U32 MATERIAL_BINDING_GPU_SCENE = 10u;
 // End global bindings
 
 // Begin local bindings
 const U32 MATERIAL_BINDING_LOCAL_UNIFORMS = 0u;
 const U32 MATERIAL_BINDING_RENDERABLE_GPU_VIEW = 1u;
+const U32 MATERIAL_BINDING_RENDERABLE_GPU_VIEW_INDICES = 1u; ///< Used instead of the above by GPU scene renderables.
 const U32 MATERIAL_BINDING_BONE_TRANSFORMS = 2u;
 const U32 MATERIAL_BINDING_PREVIOUS_BONE_TRANSFORMS = 3u;
 const U32 MATERIAL_BINDING_FIRST_NON_STANDARD_LOCAL = 4u;
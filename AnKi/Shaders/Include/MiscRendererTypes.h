@@ -17,6 +17,10 @@ const F32 EVSM_NEGATIVE_CONSTANT = 5.0f; // EVSM negative constant
 const F32 EVSM_BIAS = 0.01f;
 const F32 EVSM_LIGHT_BLEEDING_REDUCTION = 0.05f;
 
+// The depth inputs of the EVSM resolve
+const U32 EVSM_INPUT_SCRATCH = 1u << 0u;
+const U32 EVSM_INPUT_STATIC_CACHE = 1u << 1u;
+
 struct EvsmResolveUniforms
 {
 	IVec2 m_viewportXY;
@@ -28,10 +32,13 @@ struct EvsmResolveUniforms
 	Vec2 m_uvMin;
 	Vec2 m_uvMax;
 
+	Vec2 m_staticCacheUvScale; ///< Transforms the scratch UV to the static cache UV.
+	Vec2 m_staticCacheUvTranslation;
+
 	U32 m_blur;
+	U32 m_inputs; ///< A mask of EVSM_INPUT_SCRATCH and EVSM_INPUT_STATIC_CACHE.
 	U32 m_padding0;
 	U32 m_padding1;
-	U32 m_padding2;
 };
 
 // RT shadows
@@ -40,6 +47,9 @@ const U32 MAX_RT_SHADOW_LAYERS = 8u;
 struct RtShadowsUniforms
 {
 	F32 historyRejectFactor[MAX_RT_SHADOW_LAYERS]; // 1.0 means reject, 0.0 not reject
+
+	Vec4 uvScaleAndMax; // For the G-buffer and the motion vectors. See scaleRenderingUv()
+	Vec4 prevHalfUvScaleAndMax; // For the history and the moments of the previous frame
 };
 
 struct RtShadowsDenoiseUniforms
@@ -48,8 +58,10 @@ struct RtShadowsDenoiseUniforms
 
 	F32 time;
 	F32 padding0;
-	F32 padding1;
-	F32 padding2;
+	UVec2 outImageSize;
+
+	Vec4 uvScaleAndMax; // For the G-buffer and the history length. See scaleRenderingUv()
+	Vec4 halfUvScaleAndMax; // For the shadows and the moments
 };
 
 // Indirect diffuse
@@ -69,6 +81,9 @@ struct IndirectDiffuseUniforms
 	F32 m_padding0;
 	F32 m_padding1;
 	F32 m_padding2;
+
+	Vec4 m_gbufferUvScaleAndMax; ///< For the G-buffer and the motion vectors. See scaleRenderingUv().
+	Vec4 m_prevUvScaleAndMax; ///< For the history.
 };
 
 struct IndirectDiffuseDenoiseUniforms
@@ -82,6 +97,8 @@ struct IndirectDiffuseDenoiseUniforms
 	F32 m_padding0;
 	F32 m_padding1;
 	F32 m_padding2;
+
+	Vec4 m_toDenoiseUvScaleAndMax; ///< See scaleRenderingUv().
 };
 
 // Lens flare
@@ -99,6 +116,9 @@ struct DepthDownscaleUniforms
 	U32 m_workgroupCount;
 	U32 m_mipmapCount;
 
+	/// The HiZ covers the whole viewport. The depth is rendered into a part of its texture. See scaleRenderingUv().
+	Vec4 m_srcUvScaleAndMax;
+
 	U32 m_lastMipWidth;
 	F32 m_padding0;
 	F32 m_padding1;
@@ -120,6 +140,9 @@ struct SsrUniforms
 	F32 m_roughnessCutoff;
 	U32 m_firstStepPixels;
 
+	Vec4 m_gbufferUvScaleAndMax; ///< For the G-buffer and the motion vectors. See scaleRenderingUv().
+	Vec4 m_prevUvScaleAndMax; ///< For the history.
+
 	Mat4 m_prevViewProjMatMulInvViewProjMat;
 	Mat4 m_projMat;
 	Mat4 m_invProjMat;
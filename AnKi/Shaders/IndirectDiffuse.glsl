@@ -70,9 +70,11 @@ void main()
 #endif
 
 	const Vec2 ndc = UV_TO_NDC(uv);
+	const Vec2 gbufferUv = scaleRenderingUv(uv, u_unis.m_gbufferUvScaleAndMax);
 
 	// Get normal
-	const Vec3 worldNormal = unpackNormalFromGBuffer(textureLod(u_gbufferRt2, u_linearAnyClampSampler, uv, 0.0));
+	const Vec3 worldNormal =
+		unpackNormalFromGBuffer(textureLod(u_gbufferRt2, u_linearAnyClampSampler, gbufferUv, 0.0));
 	const Vec3 viewNormal = (u_clusteredShading.m_matrices.m_view * Vec4(worldNormal, 0.0)).xyz;
 
 	// Get origin
@@ -126,8 +128,9 @@ void main()
 			Vec2 lastFrameUv;
 			if(REPROJECT_LIGHTBUFFER)
 			{
+				const Vec2 motionVectorsUv = scaleRenderingUv(crntFrameUv, u_unis.m_gbufferUvScaleAndMax);
 				lastFrameUv =
-					crntFrameUv + textureLod(u_motionVectorsTex, u_linearAnyClampSampler, crntFrameUv, 0.0).xy;
+					crntFrameUv + textureLod(u_motionVectorsTex, u_linearAnyClampSampler, motionVectorsUv, 0.0).xy;
 			}
 			else
 			{
@@ -214,8 +217,8 @@ void main()
 
 	// Blend color with history
 	{
-		const Vec2 historyUv = uv + textureLod(u_motionVectorsTex, u_linearAnyClampSampler, uv, 0.0).xy;
-		const F32 historyLength = textureLod(u_historyLengthTex, u_linearAnyClampSampler, uv, 0.0).x;
+		const Vec2 historyUv = uv + textureLod(u_motionVectorsTex, u_linearAnyClampSampler, gbufferUv, 0.0).xy;
+		const F32 historyLength = textureLod(u_historyLengthTex, u_linearAnyClampSampler, gbufferUv, 0.0).x;
 
 		const F32 lowestBlendFactor = 0.05;
 		const F32 maxHistoryLength = 16.0;
@@ -226,7 +229,9 @@ void main()
 		// Blend with history
 		if(blendFactor < 1.0)
 		{
-			const ANKI_RP Vec3 history = textureLod(u_historyTex, u_linearAnyClampSampler, historyUv, 0.0).rgb;
+			const ANKI_RP Vec3 history = textureLod(u_historyTex, u_linearAnyClampSampler,
+													scaleRenderingUv(historyUv, u_unis.m_prevUvScaleAndMax), 0.0)
+											 .rgb;
 			outColor = mix(history, outColor, blendFactor);
 		}
 	}
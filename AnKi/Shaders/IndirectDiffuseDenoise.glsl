@@ -82,7 +82,10 @@ void main()
 		// w *= gaussianWeight(0.4, abs(F32(i)) / (u_unis.m_sampleCountDiv2 * 2.0 + 1.0));
 		weight += w;
 
-		color += textureLod(u_toDenoiseTex, u_linearAnyClampSampler, sampleUv, 0.0).xyz * w;
+		color += textureLod(u_toDenoiseTex, u_linearAnyClampSampler,
+							scaleRenderingUv(sampleUv, u_unis.m_toDenoiseUvScaleAndMax), 0.0)
+					 .xyz
+				 * w;
 	}
 
 	// Normalize and store
@@ -59,9 +59,13 @@ void main()
 	const Vec2 uv = in_uv;
 #endif
 
+	const Vec2 gbufferUv = scaleRenderingUv(uv, u_unis.m_gbufferUvScaleAndMax);
+
 	// Read part of the G-buffer
-	const F32 roughness = unpackRoughnessFromGBuffer(textureLod(u_gbufferRt1, u_trilinearClampSampler, uv, 0.0));
-	const Vec3 worldNormal = unpackNormalFromGBuffer(textureLod(u_gbufferRt2, u_trilinearClampSampler, uv, 0.0));
+	const F32 roughness =
+		unpackRoughnessFromGBuffer(textureLod(u_gbufferRt1, u_trilinearClampSampler, gbufferUv, 0.0));
+	const Vec3 worldNormal =
+		unpackNormalFromGBuffer(textureLod(u_gbufferRt2, u_trilinearClampSampler, gbufferUv, 0.0));
 
 	// Get depth
 	const F32 depth = textureLod(u_depthRt, u_trilinearClampSampler, uv, 0.0).r;
@@ -111,9 +115,10 @@ void main()
 	// Reject backfacing
 	ANKI_BRANCH if(ssrAttenuation > 0.0)
 	{
+		const Vec2 hitGbufferUv = scaleRenderingUv(hitPoint.xy, u_unis.m_gbufferUvScaleAndMax);
 		const Vec3 hitNormal =
 			u_unis.m_normalMat
-			* Vec4(unpackNormalFromGBuffer(textureLod(u_gbufferRt2, u_trilinearClampSampler, hitPoint.xy, 0.0)), 0.0);
+			* Vec4(unpackNormalFromGBuffer(textureLod(u_gbufferRt2, u_trilinearClampSampler, hitGbufferUv, 0.0)), 0.0);
 		F32 backFaceAttenuation;
 		rejectBackFaces(reflDir, hitNormal, backFaceAttenuation);
 
@@ -162,8 +167,8 @@ void main()
 
 	// Blend with history
 	{
-		const Vec2 historyUv = uv + textureLod(u_motionVectorsTex, u_trilinearClampSampler, uv, 0.0).xy;
-		const F32 historyLength = textureLod(u_historyLengthTex, u_trilinearClampSampler, uv, 0.0).x;
+		const Vec2 historyUv = uv + textureLod(u_motionVectorsTex, u_trilinearClampSampler, gbufferUv, 0.0).xy;
+		const F32 historyLength = textureLod(u_historyLengthTex, u_trilinearClampSampler, gbufferUv, 0.0).x;
 
 		const F32 lowestBlendFactor = 0.2;
 		const F32 maxHistoryLength = 16.0;
@@ -174,7 +179,9 @@ void main()
 		// Blend with history
 		if(blendFactor < 1.0)
 		{
-			const ANKI_RP Vec3 history = textureLod(u_historyTex, u_trilinearClampSampler, historyUv, 0.0).xyz;
+			const ANKI_RP Vec3 history = textureLod(u_historyTex, u_trilinearClampSampler,
+													scaleRenderingUv(historyUv, u_unis.m_prevUvScaleAndMax), 0.0)
+											 .xyz;
 			outColor = mix(history, outColor, blendFactor);
 		}
 	}
@@ -5,32 +5,29 @@
 
 #pragma once
 
-#include <AnKi/Shaders/Common.glsl>
+#include <AnKi/Shaders/Functions.glsl>
 
 // Perform motion blur.
-ANKI_RP Vec3 motionBlur(texture2D motionVectorsRt, sampler motionVectorsRtSampler, ANKI_RP texture2D toBlurRt,
-						Vec2 toBlurRtSize, sampler toBlurRtSampler, Vec2 uv, U32 maxSamples)
+// motionVectorsUvScaleAndMax: The motion vectors RT is of the internal resolution. See scaleRenderingUv().
+// motionVectorsTexelSize: 1 over the size of the motion vectors RT.
+ANKI_RP Vec3 motionBlur(texture2D motionVectorsRt, sampler motionVectorsRtSampler, Vec4 motionVectorsUvScaleAndMax,
+						Vec2 motionVectorsTexelSize, ANKI_RP texture2D toBlurRt, Vec2 toBlurRtSize,
+						sampler toBlurRtSampler, Vec2 uv, U32 maxSamples)
 {
 	// Compute velocity. Get the max velocity around the curent sample to avoid outlines. TAA's result and the motion
 	// vectors RT do not quite overlap
-	Vec2 velocityMin = textureLod(motionVectorsRt, motionVectorsRtSampler, uv, 0.0).rg;
+	const Vec2 mvUv = scaleRenderingUv(uv, motionVectorsUvScaleAndMax);
+	Vec2 velocityMin = textureLod(motionVectorsRt, motionVectorsRtSampler, mvUv, 0.0).rg;
 	Vec2 velocityMax = velocityMin;
 
-	Vec2 v = textureLodOffset(sampler2D(motionVectorsRt, motionVectorsRtSampler), uv, 0.0, ivec2(-2, -2)).rg;
-	velocityMin = min(velocityMin, v);
-	velocityMax = max(velocityMax, v);
-
-	v = textureLodOffset(sampler2D(motionVectorsRt, motionVectorsRtSampler), uv, 0.0, ivec2(2, 2)).rg;
-	velocityMin = min(velocityMin, v);
-	velocityMax = max(velocityMax, v);
-
-	v = textureLodOffset(sampler2D(motionVectorsRt, motionVectorsRtSampler), uv, 0.0, ivec2(-2, 2)).rg;
-	velocityMin = min(velocityMin, v);
-	velocityMax = max(velocityMax, v);
-
-	v = textureLodOffset(sampler2D(motionVectorsRt, motionVectorsRtSampler), uv, 0.0, ivec2(2, -2)).rg;
-	velocityMin = min(velocityMin, v);
-	velocityMax = max(velocityMax, v);
+	const Vec2 offsets[4] = Vec2[](Vec2(-2.0, -2.0), Vec2(2.0, 2.0), Vec2(-2.0, 2.0), Vec2(2.0, -2.0));
+	ANKI_UNROLL for(U32 i = 0u; i < 4u; ++i)
+	{
+		const Vec2 offsetUv = min(mvUv + offsets[i] * motionVectorsTexelSize, motionVectorsUvScaleAndMax.zw);
+		const Vec2 v = textureLod(motionVectorsRt, motionVectorsRtSampler, offsetUv, 0.0).rg;
+		velocityMin = min(velocityMin, v);
+		velocityMax = max(velocityMax, v);
+	}
 
 	const F32 mag0 = length(velocityMin);
 	const F32 mag1 = length(velocityMax);
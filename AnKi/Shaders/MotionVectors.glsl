@@ -5,7 +5,6 @@
 
 // Calculates the motion vectors that will be used to sample from the previous frame
 
-ANKI_SPECIALIZATION_CONSTANT_UVEC2(FB_SIZE, 0u);
 const F32 MAX_REJECTION_DISTANCE = 0.1; // In meters
 const F32 MAX_HISTORY_LENGTH = 16.0;
 
@@ -22,6 +21,12 @@ struct Uniforms
 	Mat4 m_reprojectionMat;
 	Mat4 m_viewProjectionInvMat;
 	Mat4 m_prevViewProjectionInvMat;
+
+	Vec4 m_uvScaleAndMax; ///< For the current depth and the velocity. See scaleRenderingUv().
+	Vec4 m_prevUvScaleAndMax; ///< For the history depth and the history length.
+
+	UVec2 m_viewportSize;
+	Vec2 m_texelSize; ///< 1 over the size of the render targets.
 };
 
 layout(set = 0, binding = 5, std140, row_major) uniform b_unis
@@ -47,13 +52,24 @@ Vec3 clipToWorld(Vec4 clip, Mat4 clipToWorldMat)
 	return v4.xyz / v4.w;
 }
 
-/// Average the some depth values and unproject.
-Vec3 getAverageWorldPosition(texture2D tex, Vec2 uv, Mat4 clipToWorldMat)
+/// Gather the 2x2 texels around the corners of the texel at uv. The UVs are clamped so the texels are always rendered.
+void gatherAroundTexel(texture2D tex, Vec2 uv, Vec4 uvScaleAndMax, out Vec4 depths1, out Vec4 depths2)
 {
-	const Vec2 halfTexel = (1.0 / Vec2(FB_SIZE)) / 2.0;
+	const Vec2 halfTexel = u_unis.m_texelSize / 2.0;
+	const Vec2 texUv = scaleRenderingUv(uv, uvScaleAndMax);
+	const Vec2 maxGatherUv = uvScaleAndMax.zw - halfTexel;
+
+	depths1 = textureGather(sampler2D(tex, u_linearAnyClampSampler), min(texUv + halfTexel, maxGatherUv), 0);
+	depths2 = textureGather(sampler2D(tex, u_linearAnyClampSampler), min(texUv - halfTexel, maxGatherUv), 0);
+}
 
-	Vec4 depths = textureGather(sampler2D(tex, u_linearAnyClampSampler), uv + halfTexel, 0);
-	depths += textureGather(sampler2D(tex, u_linearAnyClampSampler), uv - halfTexel, 0);
+/// Average the some depth values and unproject.
+Vec3 getAverageWorldPosition(texture2D tex, Vec2 uv, Vec4 uvScaleAndMax, Mat4 clipToWorldMat)
+{
+	Vec4 depths1;
+	Vec4 depths2;
+	gatherAroundTexel(tex, uv, uvScaleAndMax, depths1, depths2);
+	const Vec4 depths = depths1 + depths2;
 
 	const F32 avgDepth = (depths.x + depths.y + depths.z + depths.w) / 8.0;
 
@@ -61,12 +77,12 @@ Vec3 getAverageWorldPosition(texture2D tex, Vec2 uv, Mat4 clipToWorldMat)
 }
 
 /// Get the depths of some neighbour texels, unproject and find the AABB in world space that encloses them.
-void getMinMaxWorldPositions(texture2D tex, Vec2 uv, Mat4 clipToWorldMat, out Vec3 aabbMin, out Vec3 aabbMax)
+void getMinMaxWorldPositions(texture2D tex, Vec2 uv, Vec4 uvScaleAndMax, Mat4 clipToWorldMat, out Vec3 aabbMin,
+							 out Vec3 aabbMax)
 {
-	const Vec2 halfTexel = (1.0 / Vec2(FB_SIZE)) / 2.0;
-
-	const Vec4 depths1 = textureGather(sampler2D(tex, u_linearAnyClampSampler), uv + halfTexel, 0);
-	const Vec4 depths2 = textureGather(sampler2D(tex, u_linearAnyClampSampler), uv - halfTexel, 0);
+	Vec4 depths1;
+	Vec4 depths2;
+	gatherAroundTexel(tex, uv, uvScaleAndMax, depths1, depths2);
 
 	const Vec4 minDepths4 = min(depths1, depths2);
 	const Vec4 maxDepths4 = max(depths1, depths2);
@@ -88,15 +104,17 @@ F32 computeRejectionFactor(Vec2 uv, Vec2 historyUv)
 {
 	Vec3 boxMin;
 	Vec3 boxMax;
-	getMinMaxWorldPositions(u_currentDepthTex, uv, u_unis.m_viewProjectionInvMat, boxMin, boxMax);
+	getMinMaxWorldPositions(u_currentDepthTex, uv, u_unis.m_uvScaleAndMax, u_unis.m_viewProjectionInvMat, boxMin,
+							boxMax);
 
 #if 0
-	const F32 historyDepth = textureLod(u_historyDepthTex, u_linearAnyClampSampler, historyUv, 0.0).r;
+	const F32 historyDepth = textureLod(u_historyDepthTex, u_linearAnyClampSampler,
+										scaleRenderingUv(historyUv, u_unis.m_prevUvScaleAndMax), 0.0).r;
 	const Vec3 historyWorldPos = clipToWorld(Vec4(UV_TO_NDC(historyUv), historyDepth, 1.0), u_unis.m_prevViewProjectionInvMat);
 #else
 	// Average gives more rejection so less ghosting
-	const Vec3 historyWorldPos =
-		getAverageWorldPosition(u_historyDepthTex, historyUv, u_unis.m_prevViewProjectionInvMat);
+	const Vec3 historyWorldPos = getAverageWorldPosition(u_historyDepthTex, historyUv, u_unis.m_prevUvScaleAndMax,
+														 u_unis.m_prevViewProjectionInvMat);
 #endif
 	const Vec3 clampedHistoryWorldPos = clamp(historyWorldPos, boxMin, boxMax);
 
@@ -120,18 +138,19 @@ F32 computeRejectionFactor(Vec2 uv, Vec2 historyUv)
 void main()
 {
 #if defined(ANKI_COMPUTE_SHADER)
-	if(skipOutOfBoundsInvocations(WORKGROUP_SIZE, FB_SIZE))
+	if(skipOutOfBoundsInvocations(WORKGROUP_SIZE, u_unis.m_viewportSize))
 	{
 		return;
 	}
 
-	const Vec2 uv = (Vec2(gl_GlobalInvocationID.xy) + 0.5) / Vec2(FB_SIZE);
+	const Vec2 uv = (Vec2(gl_GlobalInvocationID.xy) + 0.5) / Vec2(u_unis.m_viewportSize);
 #else
 	const Vec2 uv = in_uv;
 #endif
-	const F32 depth = textureLod(u_currentDepthTex, u_linearAnyClampSampler, uv, 0.0).r;
+	const Vec2 texUv = scaleRenderingUv(uv, u_unis.m_uvScaleAndMax);
+	const F32 depth = textureLod(u_currentDepthTex, u_linearAnyClampSampler, texUv, 0.0).r;
 
-	const Vec2 velocity = textureLod(u_velocityTex, u_linearAnyClampSampler, uv, 0.0).rg;
+	const Vec2 velocity = textureLod(u_velocityTex, u_linearAnyClampSampler, texUv, 0.0).rg;
 
 	Vec2 historyUv;
 	if(velocity.x != 1.0)
@@ -155,7 +174,9 @@ void main()
 	}
 	else
 	{
-		historyLength = textureLod(u_historyLengthTex, u_linearAnyClampSampler, historyUv, 0.0).r;
+		historyLength = textureLod(u_historyLengthTex, u_linearAnyClampSampler,
+								   scaleRenderingUv(historyUv, u_unis.m_prevUvScaleAndMax), 0.0)
+							.r;
 		historyLength += 1.0 / MAX_HISTORY_LENGTH;
 	}
 
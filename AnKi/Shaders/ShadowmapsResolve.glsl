@@ -3,7 +3,6 @@
 // Code licensed under the BSD License.
 // http://www.anki3d.org/LICENSE
 
-ANKI_SPECIALIZATION_CONSTANT_UVEC2(FB_SIZE, 0u);
 ANKI_SPECIALIZATION_CONSTANT_UVEC2(TILE_COUNTS, 2u);
 ANKI_SPECIALIZATION_CONSTANT_U32(Z_SPLIT_COUNT, 4u);
 ANKI_SPECIALIZATION_CONSTANT_U32(TILE_SIZE, 5u);
@@ -17,6 +16,14 @@ ANKI_SPECIALIZATION_CONSTANT_U32(TILE_SIZE, 5u);
 layout(set = 0, binding = 5) uniform sampler u_linearAnyClampSampler;
 layout(set = 0, binding = 6) uniform texture2D u_depthRt;
 
+layout(push_constant, std140) uniform b_pc
+{
+	Vec4 u_depthUvScaleAndMax; ///< See scaleRenderingUv().
+
+	UVec2 u_viewportSize;
+	UVec2 u_padding0;
+};
+
 #if defined(ANKI_COMPUTE_SHADER)
 const UVec2 WORKGROUP_SIZE = UVec2(8, 8);
 layout(local_size_x = WORKGROUP_SIZE.x, local_size_y = WORKGROUP_SIZE.y, local_size_z = 1) in;
@@ -29,18 +36,18 @@ layout(location = 0) out Vec4 out_color;
 void main()
 {
 #if defined(ANKI_COMPUTE_SHADER)
-	if(skipOutOfBoundsInvocations(WORKGROUP_SIZE, FB_SIZE))
+	if(skipOutOfBoundsInvocations(WORKGROUP_SIZE, u_viewportSize))
 	{
 		return;
 	}
-	const Vec2 uv = (Vec2(gl_GlobalInvocationID.xy) + 0.5) / Vec2(FB_SIZE);
+	const Vec2 uv = (Vec2(gl_GlobalInvocationID.xy) + 0.5) / Vec2(u_viewportSize);
 #else
 	const Vec2 uv = in_uv;
 #endif
 
 	// World position
 	const Vec2 ndc = UV_TO_NDC(uv);
-	const F32 depth = textureLod(u_depthRt, u_linearAnyClampSampler, uv, 0.0).r;
+	const F32 depth = textureLod(u_depthRt, u_linearAnyClampSampler, scaleRenderingUv(uv, u_depthUvScaleAndMax), 0.0).r;
 	const Vec4 worldPos4 = u_clusteredShading.m_matrices.m_invertedViewProjectionJitter * Vec4(ndc, depth, 1.0);
 	const Vec3 worldPos = worldPos4.xyz / worldPos4.w;
 
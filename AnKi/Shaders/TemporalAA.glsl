@@ -8,7 +8,6 @@
 
 ANKI_SPECIALIZATION_CONSTANT_F32(VARIANCE_CLIPPING_GAMMA, 0u);
 ANKI_SPECIALIZATION_CONSTANT_F32(BLEND_FACTOR, 1u);
-ANKI_SPECIALIZATION_CONSTANT_UVEC2(FB_SIZE, 2u);
 
 #include <AnKi/Shaders/Functions.glsl>
 #include <AnKi/Shaders/PackFunctions.glsl>
@@ -20,6 +19,14 @@ layout(set = 0, binding = 2) uniform ANKI_RP texture2D u_inputRt;
 layout(set = 0, binding = 3) uniform ANKI_RP texture2D u_historyRt;
 layout(set = 0, binding = 4) uniform texture2D u_motionVectorsTex;
 
+layout(push_constant, std140) uniform b_pc
+{
+	Vec4 u_uvScaleAndMax; ///< For the current frame's RTs. See scaleRenderingUv().
+	Vec4 u_prevUvScaleAndMax; ///< For the history.
+	UVec2 u_viewportSize;
+	UVec2 u_padding0;
+};
+
 const U32 TONEMAPPING_SET = 0u;
 const U32 TONEMAPPING_BINDING = 5u;
 #include <AnKi/Shaders/TonemappingResources.glsl>
@@ -36,35 +43,38 @@ layout(location = 0) out Vec3 out_color;
 layout(location = 1) out Vec3 out_tonemappedColor;
 #endif
 
+// Offset by whole texels and clamp so the neighbours are never read from outside the rendered area. The xy - zw of the
+// scale is half a texel
+#define offsetUv(uv, x, y) min((uv) + Vec2(x, y) * 2.0 * (u_uvScaleAndMax.xy - u_uvScaleAndMax.zw), u_uvScaleAndMax.zw)
+
 #if YCBCR
 #	define sample(s, uv) rgbToYCbCr(textureLod(s, u_linearAnyClampSampler, uv, 0.0).rgb)
-#	define sampleOffset(s, uv, x, y) \
-		rgbToYCbCr(textureLodOffset(sampler2D(s, u_linearAnyClampSampler), uv, 0.0, IVec2(x, y)).rgb)
 #else
 #	define sample(s, uv) textureLod(s, u_linearAnyClampSampler, uv, 0.0).rgb
-#	define sampleOffset(s, uv, x, y) textureLodOffset(sampler2D(s, u_linearAnyClampSampler), uv, 0.0, IVec2(x, y)).rgb
 #endif
+#define sampleOffset(s, uv, x, y) sample(s, offsetUv(uv, x, y))
 
 void main()
 {
 #if defined(ANKI_COMPUTE_SHADER)
-	if(skipOutOfBoundsInvocations(WORKGROUP_SIZE, FB_SIZE))
+	if(skipOutOfBoundsInvocations(WORKGROUP_SIZE, u_viewportSize))
 	{
 		return;
 	}
 
-	const Vec2 uv = (Vec2(gl_GlobalInvocationID.xy) + 0.5) / Vec2(FB_SIZE);
+	const Vec2 viewportUv = (Vec2(gl_GlobalInvocationID.xy) + 0.5) / Vec2(u_viewportSize);
 #else
-	const Vec2 uv = in_uv;
+	const Vec2 viewportUv = in_uv;
 #endif
+	const Vec2 uv = scaleRenderingUv(viewportUv, u_uvScaleAndMax);
 
 	const F32 depth = textureLod(u_depthRt, u_linearAnyClampSampler, uv, 0.0).r;
 
 	// Get prev uv coords
-	const Vec2 oldUv = uv + textureLod(u_motionVectorsTex, u_linearAnyClampSampler, uv, 0.0).rg;
+	const Vec2 oldUv = viewportUv + textureLod(u_motionVectorsTex, u_linearAnyClampSampler, uv, 0.0).rg;
 
 	// Read textures
-	Vec3 historyCol = sample(u_historyRt, oldUv);
+	Vec3 historyCol = sample(u_historyRt, scaleRenderingUv(oldUv, u_prevUvScaleAndMax));
 	const Vec3 crntCol = sample(u_inputRt, uv);
 
 	// Remove ghosting by clamping the history color to neighbour's AABB
@@ -32,6 +32,7 @@
 #include <AnKi/Util/Thread.h>
 #include <AnKi/Util/ThreadPool.h>
 #include <AnKi/Util/ThreadHive.h>
+#include <AnKi/Util/ThreadHiveAlgorithms.h>
 #include <AnKi/Util/Visitor.h>
 #include <AnKi/Util/INotify.h>
 #include <AnKi/Util/SparseArray.h>
@@ -40,6 +41,7 @@
 #include <AnKi/Util/Serializer.h>
 #include <AnKi/Util/Xml.h>
 #include <AnKi/Util/F16.h>
+#include <AnKi/Util/Compression.h>
 #include <AnKi/Util/Function.h>
 #include <AnKi/Util/BuddyAllocatorBuilder.h>
 #include <AnKi/Util/StackAllocatorBuilder.h>
@@ -20,6 +20,7 @@ public:
 	PtrSize m_allocatedSize;
 	PtrSize m_inUseSize;
 	U32 m_chunkCount; ///< Can be assosiated with the number of allocations.
+	U32 m_evacuatingChunkCount;
 };
 
 /// This is a convenience class used to build class memory allocators.
@@ -74,6 +75,30 @@ public:
 	/// @param offset The memory offset inside the chunk.
 	void free(TChunk* chunk, PtrSize offset);
 
+	/// Pick, for every class, the sparsest chunk to be emptied if it's not occupied more than a threshold and the rest
+	/// of the chunks of the class have room for its suballocations. New allocations avoid the evacuating chunks so they
+	/// will be released once their owners move their memory elsewhere (see isEvacuating()). If the evacuating chunk
+	/// doesn't lose any suballocation for a number of calls (some owners can't move their memory) the evacuation is
+	/// abandoned and that chunk won't be picked again.
+	/// @note This is thread safe.
+	void updateEvacuation();
+
+	/// Set the parameters of updateEvacuation().
+	/// @param maxOccupancy Only chunks with less than maxOccupancy (in [0, 1]) of their suballocations in use will be
+	///                     evacuated.
+	/// @param maxStallCount The number of updateEvacuation() calls without progress until an evacuation is abandoned.
+	/// @note Not thread safe. Don't call it while calling updateEvacuation.
+	void setEvacuationParameters(F32 maxOccupancy, U32 maxStallCount)
+	{
+		ANKI_ASSERT(maxOccupancy >= 0.0f && maxOccupancy <= 1.0f && maxStallCount > 0);
+		m_evacuationMaxOccupancy = maxOccupancy;
+		m_evacuationMaxStallCount = maxStallCount;
+	}
+
+	/// Check if the owner of an allocation of that chunk should re-allocate it.
+	/// @note This is thread safe.
+	Bool isEvacuating(const TChunk* chunk) const;
+
 	/// Access the interface.
 	/// @note Not thread safe. Don't call it while calling allocate or free.
 	TInterface& getInterface()
@@ -106,6 +131,18 @@ private:
 		/// The max size a suballocation can have.
 		PtrSize m_suballocationSize = 0;
 
+		/// The chunk that is being emptied.
+		TChunk* m_evacuatingChunk = nullptr;
+
+		/// The lowest suballocation count the evacuating chunk had.
+		U32 m_evacuatingChunkMinSuballocationCount = 0;
+
+		/// The number of updateEvacuation() calls that the evacuating chunk didn't lose any suballocation.
+		U32 m_evacuationStallCount = 0;
+
+		/// A chunk whose evacuation was abandoned. It won't be evacuated again.
+		TChunk* m_abandonedChunk = nullptr;
+
 		/// Lock.
 		mutable TLock m_mtx;
 	};
@@ -118,6 +155,9 @@ private:
 	/// All the classes.
 	DynamicArray<Class> m_classes;
 
+	F32 m_evacuationMaxOccupancy = 0.25f;
+	U32 m_evacuationMaxStallCount = 120;
+
 	Class* findClass(PtrSize size, PtrSize alignment);
 
 	Bool isInitialized() const
@@ -95,18 +95,21 @@ Error ClassAllocatorBuilder<TChunk, TInterface, TLock>::allocate(PtrSize size, P
 
 	LockGuard<TLock> lock(cl->m_mtx);
 
-	// Find chunk with free suballocation
-	auto it = cl->m_chunkList.getBegin();
-	const auto end = cl->m_chunkList.getEnd();
-	while(it != end)
+	// Find the fullest chunk with free suballocations. Packing the allocations keeps the rest of the chunks emptier and
+	// gives them a chance to be released
+	for(TChunk& it : cl->m_chunkList)
 	{
-		if(it->m_suballocationCount < maxSuballocationCount)
+		if(it.m_suballocationCount < maxSuballocationCount && &it != cl->m_evacuatingChunk
+		   && (chunk == nullptr || it.m_suballocationCount > chunk->m_suballocationCount))
 		{
-			chunk = &(*it);
-			break;
+			chunk = &it;
 		}
+	}
 
-		++it;
+	// Use the evacuating chunk only if the rest are full. Better than creating a new chunk
+	if(chunk == nullptr && cl->m_evacuatingChunk && cl->m_evacuatingChunk->m_suballocationCount < maxSuballocationCount)
+	{
+		chunk = cl->m_evacuatingChunk;
 	}
 
 	// Create a new chunk if needed
@@ -163,11 +166,96 @@ void ClassAllocatorBuilder<TChunk, TInterface, TLock>::free(TChunk* chunk, PtrSi
 
 	if(chunk->m_suballocationCount == 0)
 	{
+		if(cl.m_evacuatingChunk == chunk)
+		{
+			cl.m_evacuatingChunk = nullptr;
+		}
+
+		if(cl.m_abandonedChunk == chunk)
+		{
+			cl.m_abandonedChunk = nullptr;
+		}
+
 		cl.m_chunkList.erase(chunk);
 		m_interface.freeChunk(chunk);
 	}
 }
 
+template<typename TChunk, typename TInterface, typename TLock>
+void ClassAllocatorBuilder<TChunk, TInterface, TLock>::updateEvacuation()
+{
+	ANKI_ASSERT(isInitialized());
+
+	for(Class& cl : m_classes)
+	{
+		LockGuard<TLock> lock(cl.m_mtx);
+
+		if(cl.m_evacuatingChunk)
+		{
+			if(cl.m_evacuatingChunk->m_suballocationCount < cl.m_evacuatingChunkMinSuballocationCount)
+			{
+				// Still being emptied
+				cl.m_evacuatingChunkMinSuballocationCount = cl.m_evacuatingChunk->m_suballocationCount;
+				cl.m_evacuationStallCount = 0;
+				continue;
+			}
+			else if(++cl.m_evacuationStallCount < m_evacuationMaxStallCount)
+			{
+				// No progress but give it some more time
+				continue;
+			}
+			else
+			{
+				// The rest of the suballocations can't move, give up
+				cl.m_abandonedChunk = cl.m_evacuatingChunk;
+				cl.m_evacuatingChunk = nullptr;
+			}
+		}
+
+		const U32 maxSuballocationCount = U32(cl.m_chunkSize / cl.m_suballocationSize);
+
+		TChunk* sparsest = nullptr;
+		U32 freeSuballocationCount = 0;
+		for(TChunk& chunk : cl.m_chunkList)
+		{
+			freeSuballocationCount += maxSuballocationCount - chunk.m_suballocationCount;
+
+			if(&chunk != cl.m_abandonedChunk
+			   && (sparsest == nullptr || chunk.m_suballocationCount < sparsest->m_suballocationCount))
+			{
+				sparsest = &chunk;
+			}
+		}
+
+		if(sparsest == nullptr
+		   || F32(sparsest->m_suballocationCount) > F32(maxSuballocationCount) * m_evacuationMaxOccupancy)
+		{
+			continue;
+		}
+
+		// The free suballocations of the rest of the chunks
+		freeSuballocationCount -= maxSuballocationCount - sparsest->m_suballocationCount;
+
+		if(freeSuballocationCount >= sparsest->m_suballocationCount)
+		{
+			cl.m_evacuatingChunk = sparsest;
+			cl.m_evacuatingChunkMinSuballocationCount = sparsest->m_suballocationCount;
+			cl.m_evacuationStallCount = 0;
+		}
+	}
+}
+
+template<typename TChunk, typename TInterface, typename TLock>
+Bool ClassAllocatorBuilder<TChunk, TInterface, TLock>::isEvacuating(const TChunk* chunk) const
+{
+	ANKI_ASSERT(isInitialized());
+	ANKI_ASSERT(chunk);
+
+	const Class& cl = *static_cast<const Class*>(chunk->m_class);
+	LockGuard<TLock> lock(cl.m_mtx);
+	return cl.m_evacuatingChunk == chunk;
+}
+
 template<typename TChunk, typename TInterface, typename TLock>
 void ClassAllocatorBuilder<TChunk, TInterface, TLock>::getStats(ClassAllocatorBuilderStats& stats) const
 {
@@ -183,6 +271,8 @@ void ClassAllocatorBuilder<TChunk, TInterface, TLock>::getStats(ClassAllocatorBu
 			stats.m_inUseSize += c.m_suballocationSize * chunk.m_suballocationCount;
 			++stats.m_chunkCount;
 		}
+
+		stats.m_evacuatingChunkCount += (c.m_evacuatingChunk) ? 1 : 0;
 	}
 }
 
@@ -0,0 +1,257 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Util/Compression.h>
+#include <AnKi/Util/Array.h>
+#include <AnKi/Util/Logger.h>
+#include <cstring>
+
+namespace anki {
+
+static constexpr PtrSize MIN_MATCH = 4;
+static constexpr PtrSize LAST_LITERALS = 5; ///< The last bytes are always literals.
+static constexpr PtrSize MATCH_FIND_LIMIT = 12; ///< A match can't start in the last bytes.
+static constexpr PtrSize MAX_OFFSET = 0xFFFF;
+static constexpr U32 HASH_TABLE_BITS = 12;
+static constexpr U32 RUN_MASK = 0xF;
+
+static U32 read32(const U8* ptr)
+{
+	U32 out;
+	memcpy(&out, ptr, sizeof(out));
+	return out;
+}
+
+static U32 hashSequence(U32 sequence)
+{
+	return (sequence * 2654435761u) >> (32u - HASH_TABLE_BITS);
+}
+
+/// Write the extra bytes of a literal or match length.
+static U8* writeLength(PtrSize length, U8* op)
+{
+	while(length >= 0xFF)
+	{
+		*op++ = 0xFF;
+		length -= 0xFF;
+	}
+
+	*op++ = U8(length);
+	return op;
+}
+
+/// Read the extra bytes of a literal or match length.
+static Error readLength(const U8*& ip, const U8* iend, PtrSize& length)
+{
+	U8 b;
+	do
+	{
+		if(ip >= iend)
+		{
+			ANKI_UTIL_LOGE("Corrupted compressed buffer");
+			return Error::FUNCTION_FAILED;
+		}
+
+		b = *ip++;
+		length += b;
+	} while(b == 0xFF);
+
+	return Error::NONE;
+}
+
+/// Write a sequence. Set matchLength to 0 for the last sequence that only has literals.
+static Error writeSequence(const U8* literals, PtrSize literalCount, PtrSize offset, PtrSize matchLength, U8*& op,
+						   const U8* oend)
+{
+	const PtrSize maxSize = 1 + literalCount / 0xFF + 1 + literalCount + 2 + matchLength / 0xFF + 1;
+	if(op + maxSize > oend)
+	{
+		ANKI_UTIL_LOGE("The output buffer is too small");
+		return Error::FUNCTION_FAILED;
+	}
+
+	U8* token = op++;
+
+	if(literalCount >= RUN_MASK)
+	{
+		*token = U8(RUN_MASK << 4u);
+		op = writeLength(literalCount - RUN_MASK, op);
+	}
+	else
+	{
+		*token = U8(literalCount << 4u);
+	}
+
+	memcpy(op, literals, literalCount);
+	op += literalCount;
+
+	if(matchLength == 0)
+	{
+		return Error::NONE;
+	}
+
+	ANKI_ASSERT(offset > 0 && offset <= MAX_OFFSET && matchLength >= MIN_MATCH);
+	*op++ = U8(offset & 0xFF);
+	*op++ = U8(offset >> 8u);
+
+	matchLength -= MIN_MATCH;
+	if(matchLength >= RUN_MASK)
+	{
+		*token |= U8(RUN_MASK);
+		op = writeLength(matchLength - RUN_MASK, op);
+	}
+	else
+	{
+		*token |= U8(matchLength);
+	}
+
+	return Error::NONE;
+}
+
+Error compressBuffer(ConstWeakArray<U8, PtrSize> in, WeakArray<U8, PtrSize> out, PtrSize& compressedSize)
+{
+	const U8* const ibegin = in.getBegin();
+	const U8* const iend = ibegin + in.getSize();
+	const U8* ip = ibegin;
+	const U8* anchor = ibegin;
+	U8* op = out.getBegin();
+	const U8* const oend = op + out.getSize();
+
+	if(in.getSize() > MATCH_FIND_LIMIT)
+	{
+		Array<U32, 1u << HASH_TABLE_BITS> table;
+		memset(&table[0], 0, table.getSizeInBytes());
+
+		const U8* const matchFindLimit = iend - MATCH_FIND_LIMIT;
+		const U8* const matchLimit = iend - LAST_LITERALS;
+
+		while(ip < matchFindLimit)
+		{
+			const U32 sequence = read32(ip);
+			U32& entry = table[hashSequence(sequence)];
+			const U8* ref = ibegin + entry;
+			entry = U32(ip - ibegin);
+
+			if(ref >= ip || PtrSize(ip - ref) > MAX_OFFSET || read32(ref) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			// Found a match, extend it backwards
+			while(ip > anchor && ref > ibegin && ip[-1] == ref[-1])
+			{
+				--ip;
+				--ref;
+			}
+
+			// And forward
+			const U8* matchEnd = ip + MIN_MATCH;
+			const U8* refEnd = ref + MIN_MATCH;
+			while(matchEnd < matchLimit && *matchEnd == *refEnd)
+			{
+				++matchEnd;
+				++refEnd;
+			}
+
+			ANKI_CHECK(
+				writeSequence(anchor, PtrSize(ip - anchor), PtrSize(ip - ref), PtrSize(matchEnd - ip), op, oend));
+
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	// The rest are literals
+	ANKI_CHECK(writeSequence(anchor, PtrSize(iend - anchor), 0, 0, op, oend));
+
+	compressedSize = PtrSize(op - out.getBegin());
+	return Error::NONE;
+}
+
+Error decompressBuffer(ConstWeakArray<U8, PtrSize> in, WeakArray<U8, PtrSize> out)
+{
+	const U8* ip = in.getBegin();
+	const U8* const iend = ip + in.getSize();
+	U8* const obegin = out.getBegin();
+	U8* op = obegin;
+	const U8* const oend = op + out.getSize();
+
+	while(ip < iend)
+	{
+		const U8 token = *ip++;
+
+		// Literals
+		PtrSize literalCount = token >> 4u;
+		if(literalCount == RUN_MASK)
+		{
+			ANKI_CHECK(readLength(ip, iend, literalCount));
+		}
+
+		if(literalCount > PtrSize(iend - ip) || literalCount > PtrSize(oend - op))
+		{
+			ANKI_UTIL_LOGE("Corrupted compressed buffer");
+			return Error::FUNCTION_FAILED;
+		}
+
+		memcpy(op, ip, literalCount);
+		ip += literalCount;
+		op += literalCount;
+
+		if(ip == iend)
+		{
+			// Last sequence
+			break;
+		}
+
+		// Match
+		if(iend - ip < 2)
+		{
+			ANKI_UTIL_LOGE("Corrupted compressed buffer");
+			return Error::FUNCTION_FAILED;
+		}
+
+		const PtrSize offset = PtrSize(ip[0]) | (PtrSize(ip[1]) << 8u);
+		ip += 2;
+
+		PtrSize matchLength = token & RUN_MASK;
+		if(matchLength == RUN_MASK)
+		{
+			ANKI_CHECK(readLength(ip, iend, matchLength));
+		}
+		matchLength += MIN_MATCH;
+
+		if(offset == 0 || offset > PtrSize(op - obegin) || matchLength > PtrSize(oend - op))
+		{
+			ANKI_UTIL_LOGE("Corrupted compressed buffer");
+			return Error::FUNCTION_FAILED;
+		}
+
+		const U8* match = op - offset;
+		if(offset >= matchLength)
+		{
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		}
+		else
+		{
+			// Overlapping, copy byte by byte
+			for(PtrSize i = 0; i < matchLength; ++i)
+			{
+				*op++ = *match++;
+			}
+		}
+	}
+
+	if(op != oend)
+	{
+		ANKI_UTIL_LOGE("The uncompressed size doesn't match the size of the output buffer");
+		return Error::FUNCTION_FAILED;
+	}
+
+	return Error::NONE;
+}
+
+} // end namespace anki
@@ -0,0 +1,35 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Util/WeakArray.h>
+
+namespace anki {
+
+/// @addtogroup util_other
+/// @{
+
+/// Get the worst case size of the output of compressBuffer().
+inline constexpr PtrSize computeCompressedBufferMaxSize(PtrSize uncompressedSize)
+{
+	return uncompressedSize + uncompressedSize / 255 + 16;
+}
+
+/// Compress a buffer using a byte oriented LZ77 codec (the LZ4 block format). It's not compressing much but it's very
+/// fast to decompress.
+/// @param[in] in The data to compress.
+/// @param[out] out Where to write the compressed data. If it's smaller than computeCompressedBufferMaxSize() the
+///                 compression might fail.
+/// @param[out] compressedSize The size of the compressed data.
+Error compressBuffer(ConstWeakArray<U8, PtrSize> in, WeakArray<U8, PtrSize> out, PtrSize& compressedSize);
+
+/// Decompress a buffer that was compressed with compressBuffer().
+/// @param[in] in The compressed data.
+/// @param[out] out Where to write the data. Its size should be exactly the size of the uncompressed data.
+Error decompressBuffer(ConstWeakArray<U8, PtrSize> in, WeakArray<U8, PtrSize> out);
+/// @}
+
+} // end namespace anki
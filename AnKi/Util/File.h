@@ -7,6 +7,7 @@
 
 #include <AnKi/Util/String.h>
 #include <AnKi/Util/Enum.h>
+#include <AnKi/Util/WeakArray.h>
 #include <cstdio>
 
 namespace anki {
@@ -146,6 +147,49 @@ private:
 		m_size = 0;
 	}
 };
+
+/// A read-only file that is mapped to the address space of the process. Reading it doesn't involve any copies, the
+/// pages are served directly from the page cache of the OS.
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile() = default;
+
+	MemoryMappedFile(const MemoryMappedFile&) = delete; // Non-copyable
+
+	MemoryMappedFile& operator=(const MemoryMappedFile&) = delete; // Non-copyable
+
+	~MemoryMappedFile()
+	{
+		close();
+	}
+
+	/// Map a regular file. Empty files can be mapped as well, their contents will be empty.
+	Error open(const CString& filename);
+
+	void close();
+
+	Bool isOpen() const
+	{
+		return m_isOpen;
+	}
+
+	/// Get the whole file. It's valid until the file is closed.
+	ConstWeakArray<U8, PtrSize> getContents() const
+	{
+		ANKI_ASSERT(m_isOpen);
+		return ConstWeakArray<U8, PtrSize>(m_data, m_size);
+	}
+
+private:
+	const U8* m_data = nullptr;
+	PtrSize m_size = 0;
+#if ANKI_OS_WINDOWS
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+	Bool m_isOpen = false;
+};
 /// @}
 
 } // end namespace anki
@@ -9,6 +9,7 @@
 #define _FILE_OFFSET_BITS 64
 
 #include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/File.h>
 #include <AnKi/Util/Assert.h>
 #include <AnKi/Util/Thread.h>
 #include <cstring>
@@ -20,6 +21,8 @@
 #include <cstdlib>
 #include <time.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #if ANKI_OS_ANDROID
 #	include <android_native_app_glue.h>
 #endif
@@ -268,4 +271,58 @@ Error getApplicationPath(StringAuto& out)
 	return Error::NONE;
 }
 
+Error MemoryMappedFile::open(const CString& filename)
+{
+	ANKI_ASSERT(!m_isOpen);
+
+	const int fd = ::open(filename.cstr(), O_RDONLY);
+	if(fd < 0)
+	{
+		ANKI_UTIL_LOGE("open() failed: %s : %s", strerror(errno), filename.cstr());
+		return Error::FILE_ACCESS;
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0)
+	{
+		ANKI_UTIL_LOGE("fstat() failed: %s : %s", strerror(errno), filename.cstr());
+		::close(fd);
+		return Error::FILE_ACCESS;
+	}
+
+	Error err = Error::NONE;
+	if(st.st_size > 0)
+	{
+		void* data = mmap(nullptr, PtrSize(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data == MAP_FAILED)
+		{
+			ANKI_UTIL_LOGE("mmap() failed: %s : %s", strerror(errno), filename.cstr());
+			err = Error::FILE_ACCESS;
+		}
+		else
+		{
+			m_data = static_cast<const U8*>(data);
+			m_size = PtrSize(st.st_size);
+		}
+	}
+
+	// The mapping keeps a reference to the file
+	::close(fd);
+
+	m_isOpen = !err;
+	return err;
+}
+
+void MemoryMappedFile::close()
+{
+	if(m_data)
+	{
+		munmap(const_cast<U8*>(m_data), m_size);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
 } // end namespace anki
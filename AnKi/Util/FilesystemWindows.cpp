@@ -4,6 +4,7 @@
 // http://www.anki3d.org/LICENSE
 
 #include <AnKi/Util/Filesystem.h>
+#include <AnKi/Util/File.h>
 #include <AnKi/Util/Assert.h>
 #include <AnKi/Util/Logger.h>
 #include <AnKi/Util/Win32Minimal.h>
@@ -217,4 +218,70 @@ Error getApplicationPath(StringAuto& out)
 	return Error::NONE;
 }
 
+Error MemoryMappedFile::open(const CString& filename)
+{
+	ANKI_ASSERT(!m_isOpen);
+
+	HANDLE file = CreateFileA(filename.cstr(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							  FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		ANKI_UTIL_LOGE("CreateFileA() failed: %s", filename.cstr());
+		return Error::FILE_ACCESS;
+	}
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size))
+	{
+		ANKI_UTIL_LOGE("GetFileSizeEx() failed: %s", filename.cstr());
+		CloseHandle(file);
+		return Error::FILE_ACCESS;
+	}
+
+	m_file = file;
+	m_isOpen = true;
+
+	if(size.QuadPart > 0)
+	{
+		// Empty files can't be mapped
+		m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* data = (m_mapping) ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if(!data)
+		{
+			ANKI_UTIL_LOGE("Failed to map file: %s", filename.cstr());
+			close();
+			return Error::FILE_ACCESS;
+		}
+
+		m_data = static_cast<const U8*>(data);
+		m_size = PtrSize(size.QuadPart);
+	}
+
+	return Error::NONE;
+}
+
+void MemoryMappedFile::close()
+{
+	if(m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+
+	if(m_mapping)
+	{
+		CloseHandle(m_mapping);
+	}
+
+	if(m_file)
+	{
+		CloseHandle(m_file);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = nullptr;
+	m_isOpen = false;
+}
+
 } // end namespace anki
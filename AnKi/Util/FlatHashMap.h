@@ -0,0 +1,604 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Util/String.h>
+#include <AnKi/Util/HashMap.h>
+#include <utility>
+#if ANKI_SIMD_SSE
+#	include <emmintrin.h>
+#elif ANKI_SIMD_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace anki {
+
+/// @addtogroup util_containers
+/// @{
+
+/// The default hasher of FlatHashMap.
+template<typename TKey>
+class FlatHashMapHasher : public DefaultHasher<TKey>
+{
+};
+
+/// Hashes integers. FlatHashMap uses different bits of the hash for different purposes so the bits are mixed.
+class FlatHashMapIntegerHasher
+{
+public:
+	U64 operator()(U64 a) const
+	{
+		// The finalizer of MurmurHash3
+		a ^= a >> 33u;
+		a *= 0xFF51AFD7ED558CCDull;
+		a ^= a >> 33u;
+		a *= 0xC4CEB9FE1A85EC53ull;
+		a ^= a >> 33u;
+		return a;
+	}
+};
+
+template<>
+class FlatHashMapHasher<U32> : public FlatHashMapIntegerHasher
+{
+};
+
+template<>
+class FlatHashMapHasher<I32> : public FlatHashMapIntegerHasher
+{
+};
+
+template<>
+class FlatHashMapHasher<U64> : public FlatHashMapIntegerHasher
+{
+};
+
+template<>
+class FlatHashMapHasher<I64> : public FlatHashMapIntegerHasher
+{
+};
+
+/// Hashes CString and StringAuto the same way so a map with StringAuto keys can be searched with a CString. String can't
+/// be a key because it's non-copyable and it needs an allocator to be destroyed.
+class FlatHashMapStringHasher
+{
+public:
+	U64 operator()(const CString& str) const
+	{
+		return str.computeHash();
+	}
+};
+
+template<>
+class FlatHashMapHasher<CString> : public FlatHashMapStringHasher
+{
+};
+
+template<>
+class FlatHashMapHasher<StringAuto> : public FlatHashMapStringHasher
+{
+};
+
+/// The default key comparison functor of FlatHashMap.
+template<typename TKey>
+class FlatHashMapKeyEqual
+{
+public:
+	template<typename TOtherKey>
+	Bool operator()(const TKey& a, const TOtherKey& b) const
+	{
+		return a == b;
+	}
+};
+
+/// Compares CString and StringAuto as CString.
+class FlatHashMapStringKeyEqual
+{
+public:
+	Bool operator()(const CString& a, const CString& b) const
+	{
+		return a == b;
+	}
+};
+
+template<>
+class FlatHashMapKeyEqual<CString> : public FlatHashMapStringKeyEqual
+{
+};
+
+template<>
+class FlatHashMapKeyEqual<StringAuto> : public FlatHashMapStringKeyEqual
+{
+};
+
+/// @memberof FlatHashMap
+/// A group of control bytes that are tested in parallel.
+class FlatHashMapGroup
+{
+public:
+	static constexpr U32 SIZE = 16;
+
+	/// The control byte of an empty slot.
+	static constexpr U8 EMPTY = 0x80;
+	/// The control byte of an erased slot (tombstone).
+	static constexpr U8 DELETED = 0xFE;
+	// The control byte of a full slot is the 7 low bits of the hash.
+
+	explicit FlatHashMapGroup(const U8* ctrl)
+	{
+		ANKI_ASSERT(isAligned(SIZE, ctrl));
+#if ANKI_SIMD_SSE
+		m_ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+#elif ANKI_SIMD_NEON
+		m_ctrl = vld1q_u8(ctrl);
+#else
+		m_ctrl = ctrl;
+#endif
+	}
+
+	/// Return a bit mask of the bytes that are equal to b.
+	U32 match(U8 b) const
+	{
+#if ANKI_SIMD_SSE
+		return U32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(char(b)), m_ctrl)));
+#elif ANKI_SIMD_NEON
+		return toBitMask(vceqq_u8(vdupq_n_u8(b), m_ctrl));
+#else
+		U32 mask = 0;
+		for(U32 i = 0; i < SIZE; ++i)
+		{
+			mask |= U32(m_ctrl[i] == b) << i;
+		}
+		return mask;
+#endif
+	}
+
+	U32 matchEmpty() const
+	{
+		return match(EMPTY);
+	}
+
+	/// Return a bit mask of the bytes that are empty or deleted. Both have the high bit set while the full don't.
+	U32 matchEmptyOrDeleted() const
+	{
+#if ANKI_SIMD_SSE
+		return U32(_mm_movemask_epi8(m_ctrl));
+#elif ANKI_SIMD_NEON
+		return toBitMask(vtstq_u8(m_ctrl, vdupq_n_u8(0x80)));
+#else
+		U32 mask = 0;
+		for(U32 i = 0; i < SIZE; ++i)
+		{
+			mask |= U32(m_ctrl[i] >> 7) << i;
+		}
+		return mask;
+#endif
+	}
+
+	/// Get the index of the lowest bit of a mask returned by the match functions.
+	static U32 getLowestBit(U32 mask)
+	{
+		ANKI_ASSERT(mask);
+		return U32(__builtin_ctzll(mask));
+	}
+
+private:
+#if ANKI_SIMD_SSE
+	__m128i m_ctrl;
+#elif ANKI_SIMD_NEON
+	uint8x16_t m_ctrl;
+
+	/// NEON doesn't have movemask. Keep one bit of every byte and add the halves horizontally.
+	static U32 toBitMask(uint8x16_t cmp)
+	{
+		alignas(16) static constexpr U8 BITS[SIZE] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+		const uint8x16_t masked = vandq_u8(cmp, vld1q_u8(BITS));
+		return U32(vaddv_u8(vget_low_u8(masked))) | (U32(vaddv_u8(vget_high_u8(masked))) << 8u);
+	}
+#else
+	const U8* m_ctrl;
+#endif
+};
+
+/// FlatHashMap iterator.
+template<typename TValuePointer, typename TValueReference, typename TKeyReference, typename TMapPointer>
+class FlatHashMapIterator
+{
+	template<typename, typename, typename, typename>
+	friend class FlatHashMap;
+
+	template<typename, typename, typename, typename>
+	friend class FlatHashMapIterator;
+
+public:
+	FlatHashMapIterator() = default;
+
+	FlatHashMapIterator(const FlatHashMapIterator& b) = default;
+
+	/// Allow conversion from iterator to const iterator.
+	template<typename YValuePointer, typename YValueReference, typename YKeyReference, typename YMapPointer>
+	FlatHashMapIterator(const FlatHashMapIterator<YValuePointer, YValueReference, YKeyReference, YMapPointer>& b)
+		: m_map(b.m_map)
+		, m_slotIdx(b.m_slotIdx)
+	{
+	}
+
+	FlatHashMapIterator(TMapPointer map, U32 slotIdx)
+		: m_map(map)
+		, m_slotIdx(slotIdx)
+	{
+		ANKI_ASSERT(map);
+	}
+
+	FlatHashMapIterator& operator=(const FlatHashMapIterator& b) = default;
+
+	TValueReference operator*() const
+	{
+		check();
+		return m_map->m_slots[m_slotIdx].m_value;
+	}
+
+	TValuePointer operator->() const
+	{
+		check();
+		return &m_map->m_slots[m_slotIdx].m_value;
+	}
+
+	/// Get the key of the element.
+	TKeyReference getKey() const
+	{
+		check();
+		return m_map->m_slots[m_slotIdx].m_key;
+	}
+
+	FlatHashMapIterator& operator++()
+	{
+		check();
+		m_slotIdx = m_map->findNextFullSlot(m_slotIdx + 1);
+		return *this;
+	}
+
+	FlatHashMapIterator operator++(int)
+	{
+		FlatHashMapIterator out = *this;
+		++(*this);
+		return out;
+	}
+
+	Bool operator==(const FlatHashMapIterator& b) const
+	{
+		ANKI_ASSERT(m_map == b.m_map);
+		return m_slotIdx == b.m_slotIdx;
+	}
+
+	Bool operator!=(const FlatHashMapIterator& b) const
+	{
+		return !(*this == b);
+	}
+
+private:
+	TMapPointer m_map = nullptr;
+	U32 m_slotIdx = MAX_U32;
+
+	void check() const
+	{
+		ANKI_ASSERT(m_map && m_slotIdx < m_map->m_capacity);
+		ANKI_ASSERT(m_map->isFull(m_map->m_ctrl[m_slotIdx]));
+	}
+};
+
+/// Open addressing hash map that stores the keys along with the values so hash collisions are resolved. It's based on
+/// the "SwissTable" design: Every slot has a control byte that holds 7 bits of the hash (or an empty/deleted marker)
+/// and the lookups test 16 control bytes at once using SIMD. Keys and values are stored in a flat array so it's cache
+/// friendly but the elements move when the map grows.
+/// @note The keys are searched using THasher and TKeyEqual. Both can accept types other than TKey (heterogeneous
+///       lookup). For example a map with StringAuto keys can be searched using a CString.
+template<typename TKey, typename TValue, typename THasher = FlatHashMapHasher<TKey>,
+		 typename TKeyEqual = FlatHashMapKeyEqual<TKey>>
+class FlatHashMap
+{
+	template<typename, typename, typename, typename>
+	friend class FlatHashMapIterator;
+
+public:
+	// Typedefs
+	using Value = TValue;
+	using Key = TKey;
+	using Hasher = THasher;
+	using KeyEqual = TKeyEqual;
+	using Iterator = FlatHashMapIterator<TValue*, TValue&, const TKey&, FlatHashMap*>;
+	using ConstIterator = FlatHashMapIterator<const TValue*, const TValue&, const TKey&, const FlatHashMap*>;
+
+	// Consts
+	/// The number of slots that will be allocated on the first insertion.
+	static constexpr U32 INITIAL_STORAGE_SIZE = 16;
+
+	FlatHashMap() = default;
+
+	/// Move.
+	FlatHashMap(FlatHashMap&& b)
+	{
+		*this = std::move(b);
+	}
+
+	FlatHashMap(const FlatHashMap&) = delete; // Non-copyable
+
+	/// You need to manually destroy the map.
+	/// @see FlatHashMap::destroy
+	~FlatHashMap()
+	{
+		ANKI_ASSERT(m_ctrl == nullptr && "Requires manual destruction");
+	}
+
+	/// Move.
+	FlatHashMap& operator=(FlatHashMap&& b)
+	{
+		ANKI_ASSERT(m_ctrl == nullptr && "Requires manual destruction");
+		m_ctrl = b.m_ctrl;
+		m_slots = b.m_slots;
+		m_capacity = b.m_capacity;
+		m_size = b.m_size;
+		m_growthLeft = b.m_growthLeft;
+		b.resetMembers();
+		return *this;
+	}
+
+	FlatHashMap& operator=(const FlatHashMap&) = delete; // Non-copyable
+
+	/// Get begin.
+	Iterator getBegin()
+	{
+		return Iterator(this, findNextFullSlot(0));
+	}
+
+	/// Get begin.
+	ConstIterator getBegin() const
+	{
+		return ConstIterator(this, findNextFullSlot(0));
+	}
+
+	/// Get end.
+	Iterator getEnd()
+	{
+		return Iterator(this, m_capacity);
+	}
+
+	/// Get end.
+	ConstIterator getEnd() const
+	{
+		return ConstIterator(this, m_capacity);
+	}
+
+	/// Get begin.
+	Iterator begin()
+	{
+		return getBegin();
+	}
+
+	/// Get begin.
+	ConstIterator begin() const
+	{
+		return getBegin();
+	}
+
+	/// Get end.
+	Iterator end()
+	{
+		return getEnd();
+	}
+
+	/// Get end.
+	ConstIterator end() const
+	{
+		return getEnd();
+	}
+
+	/// Return true if map is empty.
+	Bool isEmpty() const
+	{
+		return m_size == 0;
+	}
+
+	U32 getSize() const
+	{
+		return m_size;
+	}
+
+	/// Get the number of slots.
+	U32 getCapacity() const
+	{
+		return m_capacity;
+	}
+
+	/// Destroy the map.
+	template<typename TAllocator>
+	void destroy(TAllocator alloc);
+
+	/// Make sure that the map can hold some number of elements without growing.
+	template<typename TAllocator>
+	void reserve(TAllocator alloc, U32 elementCount);
+
+	/// Construct an element inside the map. If the key already exists nothing will be constructed.
+	/// @return An iterator to the new element or to the element that already had that key.
+	template<typename TAllocator, typename... TArgs>
+	Iterator emplace(TAllocator alloc, const TKey& key, TArgs&&... args);
+
+	/// Erase element.
+	template<typename TAllocator>
+	void erase(TAllocator alloc, Iterator it);
+
+	/// Find a value using a key.
+	template<typename TOtherKey>
+	Iterator find(const TOtherKey& key)
+	{
+		return Iterator(this, findSlot(key, THasher()(key)));
+	}
+
+	/// Find a value using a key.
+	template<typename TOtherKey>
+	ConstIterator find(const TOtherKey& key) const
+	{
+		return ConstIterator(this, findSlot(key, THasher()(key)));
+	}
+
+protected:
+	class Slot
+	{
+	public:
+		TKey m_key;
+		TValue m_value;
+
+		template<typename... TArgs>
+		Slot(const TKey& key, TArgs&&... args)
+			: m_key(key)
+			, m_value(std::forward<TArgs>(args)...)
+		{
+		}
+	};
+
+	U8* m_ctrl = nullptr; ///< The control bytes. One per slot. It's in the same allocation with m_slots.
+	Slot* m_slots = nullptr;
+	U32 m_capacity = 0;
+	U32 m_size = 0;
+	U32 m_growthLeft = 0; ///< How many empty slots can be filled before a rehash.
+
+	void resetMembers()
+	{
+		m_ctrl = nullptr;
+		m_slots = nullptr;
+		m_capacity = 0;
+		m_size = 0;
+		m_growthLeft = 0;
+	}
+
+	static Bool isFull(U8 ctrl)
+	{
+		return (ctrl & 0x80) == 0;
+	}
+
+	static U64 getH1(U64 hash)
+	{
+		return hash >> 7u;
+	}
+
+	static U8 getH2(U64 hash)
+	{
+		return U8(hash & 0x7F);
+	}
+
+	static U32 computeMaxSize(U32 capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	U32 getGroupMask() const
+	{
+		return m_capacity / FlatHashMapGroup::SIZE - 1;
+	}
+
+	U32 findNextFullSlot(U32 slotIdx) const
+	{
+		while(slotIdx < m_capacity && !isFull(m_ctrl[slotIdx]))
+		{
+			++slotIdx;
+		}
+		return slotIdx;
+	}
+
+	/// Return the slot of the key or m_capacity if not found.
+	template<typename TOtherKey>
+	U32 findSlot(const TOtherKey& key, U64 hash) const;
+
+	/// Find an empty or deleted slot for a new element.
+	U32 findInsertSlot(U64 hash) const;
+
+	void setCtrl(U32 slotIdx, U8 ctrl)
+	{
+		m_ctrl[slotIdx] = ctrl;
+	}
+
+	/// Allocate new storage and move the elements there.
+	template<typename TAllocator>
+	void rehash(TAllocator alloc, U32 newCapacity);
+};
+
+/// FlatHashMap with automatic cleanup.
+template<typename TKey, typename TValue, typename THasher = FlatHashMapHasher<TKey>,
+		 typename TKeyEqual = FlatHashMapKeyEqual<TKey>>
+class FlatHashMapAuto : public FlatHashMap<TKey, TValue, THasher, TKeyEqual>
+{
+public:
+	using Base = FlatHashMap<TKey, TValue, THasher, TKeyEqual>;
+
+	FlatHashMapAuto(const GenericMemoryPoolAllocator<U8>& alloc)
+		: m_alloc(alloc)
+	{
+	}
+
+	/// Move.
+	FlatHashMapAuto(FlatHashMapAuto&& b)
+		: Base(std::move(b))
+		, m_alloc(b.m_alloc)
+	{
+	}
+
+	FlatHashMapAuto(const FlatHashMapAuto&) = delete; // Non-copyable
+
+	/// Destructor.
+	~FlatHashMapAuto()
+	{
+		destroy();
+	}
+
+	/// Move.
+	FlatHashMapAuto& operator=(FlatHashMapAuto&& b)
+	{
+		destroy();
+		m_alloc = b.m_alloc;
+		Base::operator=(std::move(b));
+		return *this;
+	}
+
+	FlatHashMapAuto& operator=(const FlatHashMapAuto&) = delete; // Non-copyable
+
+	/// Construct an element inside the map.
+	template<typename... TArgs>
+	typename Base::Iterator emplace(const TKey& key, TArgs&&... args)
+	{
+		return Base::emplace(m_alloc, key, std::forward<TArgs>(args)...);
+	}
+
+	/// Erase element.
+	void erase(typename Base::Iterator it)
+	{
+		Base::erase(m_alloc, it);
+	}
+
+	/// @copydoc FlatHashMap::reserve
+	void reserve(U32 elementCount)
+	{
+		Base::reserve(m_alloc, elementCount);
+	}
+
+	/// Clean up the map.
+	void destroy()
+	{
+		Base::destroy(m_alloc);
+	}
+
+	GenericMemoryPoolAllocator<U8> getAllocator() const
+	{
+		return m_alloc;
+	}
+
+private:
+	GenericMemoryPoolAllocator<U8> m_alloc;
+};
+/// @}
+
+} // end namespace anki
+
+#include <AnKi/Util/FlatHashMap.inl.h>
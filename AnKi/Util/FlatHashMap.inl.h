@@ -0,0 +1,223 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Util/FlatHashMap.h>
+
+namespace anki {
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+template<typename TAllocator>
+void FlatHashMap<TKey, TValue, THasher, TKeyEqual>::destroy(TAllocator alloc)
+{
+	if(m_ctrl)
+	{
+		for(U32 i = 0; i < m_capacity; ++i)
+		{
+			if(isFull(m_ctrl[i]))
+			{
+				m_slots[i].~Slot();
+			}
+		}
+
+		alloc.getMemoryPool().free(m_ctrl);
+	}
+
+	resetMembers();
+}
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+template<typename TOtherKey>
+U32 FlatHashMap<TKey, TValue, THasher, TKeyEqual>::findSlot(const TOtherKey& key, U64 hash) const
+{
+	if(m_size == 0)
+	{
+		return m_capacity;
+	}
+
+	const U8 h2 = getH2(hash);
+	const U32 groupMask = getGroupMask();
+	U32 groupIdx = U32(getH1(hash)) & groupMask;
+
+	// Triangular probing visits all the groups once since the group count is a power of two
+	for(U32 probe = 1; probe <= groupMask + 1; ++probe)
+	{
+		const U32 firstSlot = groupIdx * FlatHashMapGroup::SIZE;
+		const FlatHashMapGroup group(&m_ctrl[firstSlot]);
+
+		U32 mask = group.match(h2);
+		while(mask)
+		{
+			const U32 slotIdx = firstSlot + FlatHashMapGroup::getLowestBit(mask);
+			if(ANKI_LIKELY(TKeyEqual()(m_slots[slotIdx].m_key, key)))
+			{
+				return slotIdx;
+			}
+
+			mask &= mask - 1;
+		}
+
+		// An empty slot means that the key was never pushed further
+		if(group.matchEmpty())
+		{
+			break;
+		}
+
+		groupIdx = (groupIdx + probe) & groupMask;
+	}
+
+	return m_capacity;
+}
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+U32 FlatHashMap<TKey, TValue, THasher, TKeyEqual>::findInsertSlot(U64 hash) const
+{
+	const U32 groupMask = getGroupMask();
+	U32 groupIdx = U32(getH1(hash)) & groupMask;
+
+	for(U32 probe = 1; probe <= groupMask + 1; ++probe)
+	{
+		const U32 firstSlot = groupIdx * FlatHashMapGroup::SIZE;
+		const U32 mask = FlatHashMapGroup(&m_ctrl[firstSlot]).matchEmptyOrDeleted();
+		if(mask)
+		{
+			return firstSlot + FlatHashMapGroup::getLowestBit(mask);
+		}
+
+		groupIdx = (groupIdx + probe) & groupMask;
+	}
+
+	ANKI_ASSERT(!"The load factor should have prevented that");
+	return m_capacity;
+}
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+template<typename TAllocator>
+void FlatHashMap<TKey, TValue, THasher, TKeyEqual>::rehash(TAllocator alloc, U32 newCapacity)
+{
+	ANKI_ASSERT(isPowerOfTwo(newCapacity) && newCapacity >= INITIAL_STORAGE_SIZE);
+	ANKI_ASSERT(computeMaxSize(newCapacity) >= m_size);
+
+	// Allocate the control bytes and the slots in one go
+	const PtrSize slotsOffset = getAlignedRoundUp(alignof(Slot), PtrSize(newCapacity));
+	const PtrSize allocSize = slotsOffset + sizeof(Slot) * newCapacity;
+	const PtrSize alignment = max<PtrSize>(FlatHashMapGroup::SIZE, alignof(Slot));
+	U8* newMem = static_cast<U8*>(alloc.getMemoryPool().allocate(allocSize, alignment));
+	ANKI_ASSERT(newMem);
+
+	U8* const oldCtrl = m_ctrl;
+	Slot* const oldSlots = m_slots;
+	const U32 oldCapacity = m_capacity;
+
+	m_ctrl = newMem;
+	m_slots = reinterpret_cast<Slot*>(newMem + slotsOffset);
+	m_capacity = newCapacity;
+	m_growthLeft = computeMaxSize(newCapacity) - m_size;
+	memset(m_ctrl, FlatHashMapGroup::EMPTY, newCapacity);
+
+	// Move the elements
+	for(U32 i = 0; i < oldCapacity; ++i)
+	{
+		if(!isFull(oldCtrl[i]))
+		{
+			continue;
+		}
+
+		Slot& oldSlot = oldSlots[i];
+		const U64 hash = THasher()(oldSlot.m_key);
+		const U32 slotIdx = findInsertSlot(hash);
+		setCtrl(slotIdx, getH2(hash));
+		::new(&m_slots[slotIdx]) Slot(std::move(oldSlot));
+		oldSlot.~Slot();
+	}
+
+	if(oldCtrl)
+	{
+		alloc.getMemoryPool().free(oldCtrl);
+	}
+}
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+template<typename TAllocator>
+void FlatHashMap<TKey, TValue, THasher, TKeyEqual>::reserve(TAllocator alloc, U32 elementCount)
+{
+	U32 newCapacity = max(m_capacity, INITIAL_STORAGE_SIZE);
+	while(computeMaxSize(newCapacity) < elementCount)
+	{
+		newCapacity *= 2;
+	}
+
+	if(newCapacity != m_capacity)
+	{
+		rehash(alloc, newCapacity);
+	}
+}
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+template<typename TAllocator, typename... TArgs>
+typename FlatHashMap<TKey, TValue, THasher, TKeyEqual>::Iterator
+FlatHashMap<TKey, TValue, THasher, TKeyEqual>::emplace(TAllocator alloc, const TKey& key, TArgs&&... args)
+{
+	const U64 hash = THasher()(key);
+
+	U32 slotIdx = findSlot(key, hash);
+	if(slotIdx != m_capacity)
+	{
+		// Already there
+		return Iterator(this, slotIdx);
+	}
+
+	if(m_capacity == 0)
+	{
+		rehash(alloc, INITIAL_STORAGE_SIZE);
+	}
+
+	slotIdx = findInsertSlot(hash);
+	if(m_growthLeft == 0 && m_ctrl[slotIdx] == FlatHashMapGroup::EMPTY)
+	{
+		// Out of empty slots. If many of the slots are tombstones rehash in place else grow
+		const U32 newCapacity = (m_size < computeMaxSize(m_capacity) / 2) ? m_capacity : m_capacity * 2;
+		rehash(alloc, newCapacity);
+		slotIdx = findInsertSlot(hash);
+	}
+
+	if(m_ctrl[slotIdx] == FlatHashMapGroup::EMPTY)
+	{
+		ANKI_ASSERT(m_growthLeft > 0);
+		--m_growthLeft;
+	}
+
+	setCtrl(slotIdx, getH2(hash));
+	::new(&m_slots[slotIdx]) Slot(key, std::forward<TArgs>(args)...);
+	++m_size;
+
+	return Iterator(this, slotIdx);
+}
+
+template<typename TKey, typename TValue, typename THasher, typename TKeyEqual>
+template<typename TAllocator>
+void FlatHashMap<TKey, TValue, THasher, TKeyEqual>::erase([[maybe_unused]] TAllocator alloc, Iterator it)
+{
+	ANKI_ASSERT(it.m_map == this);
+	it.check();
+	const U32 slotIdx = it.m_slotIdx;
+
+	m_slots[slotIdx].~Slot();
+	--m_size;
+
+	// If the group has an empty slot then no probe sequence continued past it and the slot can become empty again.
+	// Otherwise leave a tombstone
+	const U32 firstSlot = getAlignedRoundDown(FlatHashMapGroup::SIZE, slotIdx);
+	if(FlatHashMapGroup(&m_ctrl[firstSlot]).matchEmpty())
+	{
+		setCtrl(slotIdx, FlatHashMapGroup::EMPTY);
+		++m_growthLeft;
+	}
+	else
+	{
+		setCtrl(slotIdx, FlatHashMapGroup::DELETED);
+	}
+}
+
+} // end namespace anki
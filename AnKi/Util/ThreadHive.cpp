@@ -17,20 +17,144 @@ namespace anki {
 #	define ANKI_HIVE_DEBUG_PRINT(...) ((void)0)
 #endif
 
-class ThreadHive::Thread
+class ThreadHive::Task
+{
+public:
+	Task* m_next; ///< Next in the shared queue or in the semaphore's waiter list.
+
+	ThreadHiveTaskCallback m_cb; ///< Callback that defines the task.
+	void* m_arg; ///< Args for the callback.
+
+	ThreadHiveSemaphore* m_waitSemaphore;
+	ThreadHiveSemaphore* m_signalSemaphore;
+};
+
+/// A fixed size Chase-Lev deque. The owner thread pushes and pops from the bottom, the other threads steal from the
+/// top.
+class ThreadHive::TaskDeque
+{
+public:
+	TaskDeque(GenericMemoryPoolAllocator<U8> alloc)
+	{
+		m_buffer = reinterpret_cast<Atomic<Task*>*>(alloc.allocate(sizeof(Atomic<Task*>) * DEQUE_CAPACITY));
+		for(U32 i = 0; i < DEQUE_CAPACITY; ++i)
+		{
+			m_buffer[i].setNonAtomically(nullptr);
+		}
+	}
+
+	void destroy(GenericMemoryPoolAllocator<U8> alloc)
+	{
+		alloc.deallocate(static_cast<void*>(m_buffer), sizeof(Atomic<Task*>) * DEQUE_CAPACITY);
+		m_buffer = nullptr;
+	}
+
+	/// Push to the bottom. Only the owner can call it.
+	/// @return False if the deque is full.
+	Bool push(Task* task)
+	{
+		const I64 b = m_bottom.load(AtomicMemoryOrder::RELAXED);
+		const I64 t = m_top.load(AtomicMemoryOrder::ACQUIRE);
+		if(b - t >= I64(DEQUE_CAPACITY))
+		{
+			return false;
+		}
+
+		m_buffer[b & (DEQUE_CAPACITY - 1)].store(task, AtomicMemoryOrder::RELAXED);
+		m_bottom.store(b + 1, AtomicMemoryOrder::RELEASE);
+		return true;
+	}
+
+	/// Pop from the bottom. Only the owner can call it.
+	Task* pop()
+	{
+		const I64 b = m_bottom.load(AtomicMemoryOrder::RELAXED) - 1;
+		m_bottom.store(b, AtomicMemoryOrder::RELAXED);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		I64 t = m_top.load(AtomicMemoryOrder::RELAXED);
+
+		Task* task = nullptr;
+		if(t <= b)
+		{
+			task = m_buffer[b & (DEQUE_CAPACITY - 1)].load(AtomicMemoryOrder::RELAXED);
+			if(t == b)
+			{
+				// Last element, race with the thieves
+				const I64 expected = t;
+				while(!m_top.compareExchange(t, t + 1, AtomicMemoryOrder::SEQ_CST, AtomicMemoryOrder::RELAXED))
+				{
+					if(t != expected)
+					{
+						// Lost the race
+						task = nullptr;
+						break;
+					}
+				}
+
+				m_bottom.store(b + 1, AtomicMemoryOrder::RELAXED);
+			}
+		}
+		else
+		{
+			// Empty
+			m_bottom.store(b + 1, AtomicMemoryOrder::RELAXED);
+		}
+
+		return task;
+	}
+
+	/// Steal from the top. Any thread can call it.
+	Task* steal()
+	{
+		I64 t = m_top.load(AtomicMemoryOrder::ACQUIRE);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const I64 b = m_bottom.load(AtomicMemoryOrder::ACQUIRE);
+
+		Task* task = nullptr;
+		if(t < b)
+		{
+			task = m_buffer[t & (DEQUE_CAPACITY - 1)].load(AtomicMemoryOrder::RELAXED);
+			if(!m_top.compareExchange(t, t + 1, AtomicMemoryOrder::SEQ_CST, AtomicMemoryOrder::RELAXED))
+			{
+				// Lost the race with another thief or with the owner
+				task = nullptr;
+			}
+		}
+
+		return task;
+	}
+
+	Bool isEmpty() const
+	{
+		return m_bottom.load(AtomicMemoryOrder::SEQ_CST) <= m_top.load(AtomicMemoryOrder::SEQ_CST);
+	}
+
+private:
+	alignas(ANKI_CACHE_LINE_SIZE) Atomic<I64> m_top = {0};
+	alignas(ANKI_CACHE_LINE_SIZE) Atomic<I64> m_bottom = {0};
+	Atomic<Task*>* m_buffer = nullptr;
+};
+
+class alignas(ANKI_CACHE_LINE_SIZE) ThreadHive::Thread
 {
 public:
 	U32 m_id; ///< An ID
 	anki::Thread m_thread; ///< Runs the workingFunc
 	ThreadHive* m_hive;
+	TaskDeque m_deque;
 
 	/// Constructor
-	Thread(U32 id, ThreadHive* hive, Bool pinToCore)
+	Thread(U32 id, ThreadHive* hive)
 		: m_id(id)
 		, m_thread("anki_threadhive")
 		, m_hive(hive)
+		, m_deque(hive->m_slowAlloc)
 	{
 		ANKI_ASSERT(hive);
+	}
+
+	void start(Bool pinToCore)
+	{
 		m_thread.start(this, threadCallback, ThreadCoreAffinityMask(false).set(m_id, pinToCore));
 	}
 
@@ -40,22 +164,16 @@ private:
 	{
 		Thread& self = *static_cast<Thread*>(info.m_userData);
 
+		m_tlsHive = self.m_hive;
+		m_tlsThreadId = self.m_id;
 		self.m_hive->threadRun(self.m_id);
+		m_tlsHive = nullptr;
 		return Error::NONE;
 	}
 };
 
-class ThreadHive::Task
-{
-public:
-	Task* m_next; ///< Next in the list.
-
-	ThreadHiveTaskCallback m_cb; ///< Callback that defines the task.
-	void* m_arg; ///< Args for the callback.
-
-	ThreadHiveSemaphore* m_waitSemaphore;
-	ThreadHiveSemaphore* m_signalSemaphore;
-};
+thread_local ThreadHive* ThreadHive::m_tlsHive = nullptr;
+thread_local U32 ThreadHive::m_tlsThreadId = MAX_U32;
 
 ThreadHive::ThreadHive(U32 threadCount, GenericMemoryPoolAllocator<U8> alloc, Bool pinToCores)
 	: m_slowAlloc(alloc)
@@ -63,10 +181,19 @@ ThreadHive::ThreadHive(U32 threadCount, GenericMemoryPoolAllocator<U8> alloc, Bo
 			  1024 * 4)
 	, m_threadCount(threadCount)
 {
-	m_threads = reinterpret_cast<Thread*>(m_slowAlloc.allocate(sizeof(Thread) * threadCount));
+	ANKI_ASSERT(threadCount > 0);
+	PtrSize alignment = alignof(Thread);
+	m_threads = reinterpret_cast<Thread*>(m_slowAlloc.allocate(sizeof(Thread) * threadCount, &alignment));
+
+	// Create all the deques before starting any thread because the threads will steal from each other
 	for(U32 i = 0; i < threadCount; ++i)
 	{
-		::new(&m_threads[i]) Thread(i, this, pinToCores);
+		::new(&m_threads[i]) Thread(i, this);
+	}
+
+	for(U32 i = 0; i < threadCount; ++i)
+	{
+		m_threads[i].start(pinToCores);
 	}
 }
 
@@ -87,6 +214,7 @@ ThreadHive::~ThreadHive()
 		while(threadCount-- != 0)
 		{
 			[[maybe_unused]] const Error err = m_threads[threadCount].m_thread.join();
+			m_threads[threadCount].m_deque.destroy(m_slowAlloc);
 			m_threads[threadCount].~Thread();
 		}
 
@@ -94,6 +222,48 @@ ThreadHive::~ThreadHive()
 	}
 }
 
+Bool ThreadHive::addSemaphoreWaiter(ThreadHiveSemaphore& sem, Task& task)
+{
+	PtrSize head = sem.m_waiters.load(AtomicMemoryOrder::ACQUIRE);
+	do
+	{
+		if(head == ThreadHiveSemaphore::FIRED)
+		{
+			return false;
+		}
+
+		task.m_next = numberToPtr<Task*>(head);
+	} while(!sem.m_waiters.compareExchange(head, ptrToNumber(&task), AtomicMemoryOrder::ACQ_REL,
+										   AtomicMemoryOrder::ACQUIRE));
+
+	return true;
+}
+
+void ThreadHive::signalSemaphore(ThreadHiveSemaphore& sem)
+{
+	const U32 prev = sem.m_atomic.fetchSub(1, AtomicMemoryOrder::ACQ_REL);
+	ANKI_ASSERT(prev > 0u);
+	ANKI_HIVE_DEBUG_PRINT("\tsem is %u\n", prev - 1u);
+
+	if(prev == 1)
+	{
+		// Reached zero, schedule everyone that waits on it
+		Task* head = numberToPtr<Task*>(sem.m_waiters.exchange(ThreadHiveSemaphore::FIRED, AtomicMemoryOrder::ACQ_REL));
+		ANKI_ASSERT(ptrToNumber(head) != ThreadHiveSemaphore::FIRED && "Semaphore reached zero twice");
+
+		U32 taskCount = 0;
+		for(Task* task = head; task; task = task->m_next)
+		{
+			++taskCount;
+		}
+
+		if(taskCount)
+		{
+			pushReadyTasks(head, taskCount);
+		}
+	}
+}
+
 void ThreadHive::submitTasks(ThreadHiveTask* tasks, const U32 taskCount)
 {
 	ANKI_ASSERT(tasks && taskCount > 0);
@@ -101,8 +271,12 @@ void ThreadHive::submitTasks(ThreadHiveTask* tasks, const U32 taskCount)
 	// Allocate tasks
 	Task* const htasks = m_alloc.newArray<Task>(taskCount);
 
-	// Initialize tasks
-	Task* prevTask = nullptr;
+	// Count them before any of them gets the chance to run
+	m_pendingTasks.fetchAdd(taskCount, AtomicMemoryOrder::ACQ_REL);
+
+	// Initialize tasks and gather the ones that can run immediately
+	Task* readyHead = nullptr;
+	U32 readyCount = 0;
 	for(U32 i = 0; i < taskCount; ++i)
 	{
 		const ThreadHiveTask& inTask = tasks[i];
@@ -114,136 +288,191 @@ void ThreadHive::submitTasks(ThreadHiveTask* tasks, const U32 taskCount)
 		outTask.m_waitSemaphore = inTask.m_waitSemaphore;
 		outTask.m_signalSemaphore = inTask.m_signalSemaphore;
 
-		// Connect tasks
-		if(prevTask)
+		if(outTask.m_waitSemaphore && addSemaphoreWaiter(*outTask.m_waitSemaphore, outTask))
 		{
-			prevTask->m_next = &outTask;
+			// Parked, it will be scheduled by the semaphore
+			continue;
 		}
-		prevTask = &outTask;
+
+		outTask.m_next = readyHead;
+		readyHead = &outTask;
+		++readyCount;
 	}
 
-	// Push work
+	ANKI_HIVE_DEBUG_PRINT("submit tasks\n");
+
+	if(readyCount)
 	{
-		LockGuard<Mutex> lock(m_mtx);
+		pushReadyTasks(readyHead, readyCount);
+	}
+}
+
+void ThreadHive::pushReadyTasks(Task* head, U32 taskCount)
+{
+	ANKI_ASSERT(head && taskCount > 0);
 
-		if(m_head != nullptr)
+	// If it's one of the hive's threads push to its deque
+	if(m_tlsHive == this)
+	{
+		TaskDeque& deque = m_threads[m_tlsThreadId].m_deque;
+		while(head)
 		{
-			ANKI_ASSERT(m_tail && m_head);
-			m_tail->m_next = &htasks[0];
-			m_tail = &htasks[taskCount - 1];
+			Task* next = head->m_next;
+			if(!deque.push(head))
+			{
+				break;
+			}
+
+			head = next;
 		}
-		else
+	}
+
+	// Push the rest to the shared queue
+	if(head)
+	{
+		Task* tail = head;
+		U32 count = 1;
+		while(tail->m_next)
 		{
-			ANKI_ASSERT(m_tail == nullptr);
-			m_head = &htasks[0];
-			m_tail = &htasks[taskCount - 1];
+			tail = tail->m_next;
+			++count;
 		}
 
-		m_pendingTasks += taskCount;
+		LockGuard<SpinLock> lock(m_sharedMtx);
 
-		ANKI_HIVE_DEBUG_PRINT("submit tasks\n");
+		if(m_sharedHead)
+		{
+			m_sharedTail->m_next = head;
+		}
+		else
+		{
+			m_sharedHead = head;
+		}
+
+		m_sharedTail = tail;
+		m_sharedTaskCount.fetchAdd(count, AtomicMemoryOrder::SEQ_CST);
 	}
 
-	// Notify all threads
-	m_cvar.notifyAll();
+	wakeThreads(taskCount);
 }
 
-void ThreadHive::threadRun(U32 threadId)
+void ThreadHive::wakeThreads(U32 taskCount)
 {
-	Task* task = nullptr;
-
-	while(!waitForWork(threadId, task))
+	// Pairs with the increment of m_sleepingThreads in threadRun(). Either we'll see the sleeper or the sleeper will
+	// see the new tasks
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(m_sleepingThreads.load(AtomicMemoryOrder::SEQ_CST) > 0)
 	{
-		// Run the task
-		ANKI_ASSERT(task && task->m_cb);
-		ANKI_HIVE_DEBUG_PRINT("tid: %lu will exec %p (udata: %p)\n", threadId, static_cast<void*>(task),
-							  static_cast<void*>(task->m_arg));
-		task->m_cb(task->m_arg, threadId, *this, task->m_signalSemaphore);
-
-#if ANKI_EXTRA_CHECKS
-		task->m_cb = nullptr;
-#endif
-
-		// Signal the semaphore as early as possible
-		if(task->m_signalSemaphore)
+		LockGuard<Mutex> lock(m_mtx);
+		if(taskCount > 1)
 		{
-			[[maybe_unused]] const U32 out = task->m_signalSemaphore->m_atomic.fetchSub(1);
-			ANKI_ASSERT(out > 0u);
-			ANKI_HIVE_DEBUG_PRINT("\tsem is %u\n", out - 1u);
+			m_cvar.notifyAll();
+		}
+		else
+		{
+			m_cvar.notifyOne();
 		}
 	}
-
-	ANKI_HIVE_DEBUG_PRINT("tid: %lu thread quits!\n", threadId);
 }
 
-Bool ThreadHive::waitForWork([[maybe_unused]] U32 threadId, Task*& task)
+ThreadHive::Task* ThreadHive::getNewTask(U32 threadId)
 {
-	LockGuard<Mutex> lock(m_mtx);
-
-	ANKI_HIVE_DEBUG_PRINT("tid: %lu locking\n", threadId);
-
-	// Complete the previous task
+	// First try the local deque
+	Task* task = m_threads[threadId].m_deque.pop();
 	if(task)
 	{
-		--m_pendingTasks;
+		return task;
+	}
+
+	// Then the shared queue
+	if(m_sharedTaskCount.load(AtomicMemoryOrder::SEQ_CST) > 0)
+	{
+		LockGuard<SpinLock> lock(m_sharedMtx);
 
-		if(task->m_signalSemaphore || m_pendingTasks == 0)
+		if(m_sharedHead)
 		{
-			// A dependency maybe got resolved or we are out of tasks. Wake them all
-			ANKI_HIVE_DEBUG_PRINT("tid: %lu wake all\n", threadId);
-			m_cvar.notifyAll();
+			task = m_sharedHead;
+			m_sharedHead = task->m_next;
+			if(m_sharedHead == nullptr)
+			{
+				m_sharedTail = nullptr;
+			}
+
+			m_sharedTaskCount.fetchSub(1, AtomicMemoryOrder::SEQ_CST);
+#if ANKI_EXTRA_CHECKS
+			task->m_next = nullptr;
+#endif
+			return task;
 		}
 	}
 
-	while(!m_quit && (task = getNewTask()) == nullptr)
+	// Then steal from the others
+	for(U32 i = 1; i < m_threadCount; ++i)
 	{
-		ANKI_HIVE_DEBUG_PRINT("tid: %lu waiting\n", threadId);
-
-		// Wait if there is no work.
-		m_cvar.wait(m_mtx);
+		const U32 victim = (threadId + i) % m_threadCount;
+		task = m_threads[victim].m_deque.steal();
+		if(task)
+		{
+			return task;
+		}
 	}
 
-	return m_quit;
+	return nullptr;
 }
 
-ThreadHive::Task* ThreadHive::getNewTask()
+void ThreadHive::threadRun(U32 threadId)
 {
-	Task* prevTask = nullptr;
-	Task* task = m_head;
-	while(task)
+	while(true)
 	{
-		// Check if there are dependencies
-		const Bool allDepsCompleted = task->m_waitSemaphore == nullptr || task->m_waitSemaphore->m_atomic.load() == 0;
+		Task* task = getNewTask(threadId);
 
-		if(allDepsCompleted)
+		if(task == nullptr)
 		{
-			// Found something, pop it
-			if(prevTask)
-			{
-				prevTask->m_next = task->m_next;
-			}
+			// No work, sleep
+			LockGuard<Mutex> lock(m_mtx);
+			m_sleepingThreads.fetchAdd(1, AtomicMemoryOrder::SEQ_CST);
 
-			if(m_head == task)
+			while(!m_quit && (task = getNewTask(threadId)) == nullptr)
 			{
-				m_head = task->m_next;
+				ANKI_HIVE_DEBUG_PRINT("tid: %lu waiting\n", threadId);
+				m_cvar.wait(m_mtx);
 			}
 
-			if(m_tail == task)
+			m_sleepingThreads.fetchSub(1, AtomicMemoryOrder::SEQ_CST);
+
+			if(m_quit)
 			{
-				m_tail = prevTask;
+				break;
 			}
+		}
+
+		// Run the task
+		ANKI_ASSERT(task && task->m_cb);
+		ANKI_HIVE_DEBUG_PRINT("tid: %lu will exec %p (udata: %p)\n", threadId, static_cast<void*>(task),
+							  static_cast<void*>(task->m_arg));
+		task->m_cb(task->m_arg, threadId, *this, task->m_signalSemaphore);
 
 #if ANKI_EXTRA_CHECKS
-			task->m_next = nullptr;
+		task->m_cb = nullptr;
 #endif
-			break;
+
+		// Signal the semaphore as early as possible
+		if(task->m_signalSemaphore)
+		{
+			signalSemaphore(*task->m_signalSemaphore);
 		}
 
-		prevTask = task;
-		task = task->m_next;
+		// Complete the task
+		if(m_pendingTasks.fetchSub(1, AtomicMemoryOrder::ACQ_REL) == 1)
+		{
+			// Out of tasks, wake the waitAllTasks()
+			ANKI_HIVE_DEBUG_PRINT("tid: %lu wake all\n", threadId);
+			LockGuard<Mutex> lock(m_mtx);
+			m_waitAllCvar.notifyAll();
+		}
 	}
 
-	return task;
+	ANKI_HIVE_DEBUG_PRINT("tid: %lu thread quits!\n", threadId);
 }
 
 void ThreadHive::waitAllTasks()
@@ -251,13 +480,19 @@ void ThreadHive::waitAllTasks()
 	ANKI_HIVE_DEBUG_PRINT("mt: waiting all\n");
 
 	LockGuard<Mutex> lock(m_mtx);
-	while(m_pendingTasks > 0)
+	while(m_pendingTasks.load(AtomicMemoryOrder::ACQUIRE) > 0)
 	{
-		m_cvar.wait(m_mtx);
+		m_waitAllCvar.wait(m_mtx);
 	}
 
-	m_head = nullptr;
-	m_tail = nullptr;
+#if ANKI_ENABLE_ASSERTIONS
+	ANKI_ASSERT(m_sharedHead == nullptr && m_sharedTaskCount.load() == 0);
+	for(U32 i = 0; i < m_threadCount; ++i)
+	{
+		ANKI_ASSERT(m_threads[i].m_deque.isEmpty());
+	}
+#endif
+
 	m_alloc.getMemoryPool().reset();
 
 	ANKI_HIVE_DEBUG_PRINT("mt: done waiting all\n");
@@ -23,7 +23,8 @@ class ThreadHiveSemaphore
 	friend class ThreadHive;
 
 public:
-	/// Increase the value of the semaphore. It's easy to brake things with that.
+	/// Increase the value of the semaphore. It's easy to brake things with that. The semaphore shouldn't have reached
+	/// zero before that call because the tasks that wait on it might have already been scheduled.
 	/// @note It's thread-safe.
 	void increaseSemaphore(U32 increase)
 	{
@@ -31,8 +32,15 @@ public:
 	}
 
 private:
+	/// Value that marks the waiter list as consumed.
+	static constexpr PtrSize FIRED = MAX_PTR_SIZE;
+
 	Atomic<U32> m_atomic;
 
+	/// Intrusive list of tasks that wait on this semaphore. When the semaphore reaches zero the list will be replaced
+	/// by FIRED and its tasks will be scheduled.
+	Atomic<PtrSize> m_waiters;
+
 	// No need to construct it or delete it
 	ThreadHiveSemaphore() = delete;
 	~ThreadHiveSemaphore() = delete;
@@ -74,8 +82,14 @@ public:
 
 /// A scheduler of small tasks. It takes a number of tasks and schedules them in one of the threads. The tasks can
 /// depend on previously submitted tasks or be completely independent.
+///
+/// It's a work-stealing scheduler. Every thread has its own lock-free deque. Tasks submitted from a hive thread go to
+/// that thread's deque, the rest go to a shared queue. Idle threads steal from the others. Tasks that wait on a
+/// semaphore are parked in the semaphore and they are scheduled when the semaphore reaches zero.
 class ThreadHive
 {
+	friend class ThreadHiveTaskGraph;
+
 public:
 	static const U32 MAX_THREADS = 32;
 
@@ -102,6 +116,7 @@ public:
 		ThreadHiveSemaphore* sem =
 			reinterpret_cast<ThreadHiveSemaphore*>(m_alloc.allocate(sizeof(ThreadHiveSemaphore), &alignment));
 		sem->m_atomic.setNonAtomically(initialValue);
+		sem->m_waiters.setNonAtomically(0);
 		return sem;
 	}
 
@@ -132,32 +147,70 @@ public:
 	/// Wait for all tasks to finish. Will block.
 	void waitAllTasks();
 
+	/// Set the minimum number of elements parallelFor() and friends will process in one go when the caller doesn't
+	/// specify a grain size.
+	void setDefaultGrainSize(U32 grainSize)
+	{
+		ANKI_ASSERT(grainSize > 0);
+		m_defaultGrainSize = grainSize;
+	}
+
+	U32 getDefaultGrainSize() const
+	{
+		return m_defaultGrainSize;
+	}
+
 private:
 	class Thread;
 
 	/// Lightweight task.
 	class Task;
 
+	/// Per thread lock-free deque.
+	class TaskDeque;
+
+	/// The capacity of each thread's deque. When it overflows the tasks will go to the shared queue.
+	static constexpr U32 DEQUE_CAPACITY = 1024;
+
 	GenericMemoryPoolAllocator<U8> m_slowAlloc;
 	StackAllocator<U8> m_alloc;
 	Thread* m_threads = nullptr;
 	U32 m_threadCount = 0;
+	U32 m_defaultGrainSize = 1;
+
+	/// Shared queue for tasks submitted from threads that are not part of the hive.
+	Task* m_sharedHead = nullptr;
+	Task* m_sharedTail = nullptr;
+	Atomic<U32> m_sharedTaskCount = {0};
+	SpinLock m_sharedMtx;
 
-	Task* m_head = nullptr; ///< Head of the task list.
-	Task* m_tail = nullptr; ///< Tail of the task list.
 	Bool m_quit = false;
-	U32 m_pendingTasks = 0;
+	Atomic<U32> m_pendingTasks = {0};
+	Atomic<U32> m_sleepingThreads = {0};
 
 	Mutex m_mtx;
-	ConditionVariable m_cvar;
+	ConditionVariable m_cvar; ///< Sleeping threads wait on that.
+	ConditionVariable m_waitAllCvar; ///< waitAllTasks() waits on that.
+
+	static thread_local ThreadHive* m_tlsHive;
+	static thread_local U32 m_tlsThreadId;
 
 	void threadRun(U32 threadId);
 
-	/// Wait for more tasks.
-	Bool waitForWork(U32 threadId, Task*& task);
+	/// Get a task from the local deque, from the shared queue or steal one.
+	Task* getNewTask(U32 threadId);
+
+	/// Push tasks that are ready to run.
+	void pushReadyTasks(Task* head, U32 taskCount);
+
+	/// Park the task in the semaphore. Returns false if the semaphore has already fired.
+	static Bool addSemaphoreWaiter(ThreadHiveSemaphore& sem, Task& task);
+
+	/// Decrement the semaphore and schedule its waiters if it reached zero.
+	void signalSemaphore(ThreadHiveSemaphore& sem);
 
-	/// Get new work from the queue.
-	Task* getNewTask();
+	/// Wake sleeping threads if there are any.
+	void wakeThreads(U32 taskCount);
 };
 /// @}
 
@@ -0,0 +1,128 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Util/ThreadHiveAlgorithms.h>
+#include <AnKi/Util/Tracer.h>
+#include <cstring>
+
+namespace anki {
+
+class ThreadHiveTaskGraph::Node
+{
+public:
+	void (*m_callback)(void* functor, U32 threadId);
+	void* m_functor;
+	const char* m_name;
+
+	/// The semaphore the node waits on. Its value is the number of dependencies.
+	ThreadHiveSemaphore* m_waitSemaphore;
+
+	/// The nodes that depend on this one.
+	Node** m_dependents;
+	U32 m_dependentCount;
+};
+
+const char* ThreadHiveTaskGraph::copyName(CString name)
+{
+	const U32 len = name.getLength();
+	char* out = static_cast<char*>(m_hive->allocateScratchMemory(len + 1, 1));
+	if(len)
+	{
+		memcpy(out, name.cstr(), len);
+	}
+	out[len] = '\0';
+	return out;
+}
+
+ThreadHiveSemaphore* ThreadHiveTaskGraph::submit(ThreadHiveSemaphore* waitSemaphore)
+{
+	const U32 nodeCount = m_nodes.getSize();
+	if(nodeCount == 0)
+	{
+		return nullptr;
+	}
+
+	// Create the nodes that will live until the tasks are done
+	Node* nodes = static_cast<Node*>(m_hive->allocateScratchMemory(sizeof(Node) * nodeCount, alignof(Node)));
+	DynamicArrayAuto<U32> dependencyCounts(m_nodes.getAllocator(), nodeCount, 0);
+	for(U32 i = 0; i < nodeCount; ++i)
+	{
+		nodes[i].m_callback = m_nodes[i].m_callback;
+		nodes[i].m_functor = m_nodes[i].m_functor;
+		nodes[i].m_name = m_nodes[i].m_name;
+		nodes[i].m_waitSemaphore = waitSemaphore;
+		nodes[i].m_dependents = nullptr;
+		nodes[i].m_dependentCount = 0;
+	}
+
+	for(const Dependency& dep : m_dependencies)
+	{
+		++dependencyCounts[dep.m_node];
+		++nodes[dep.m_dependsOnNode].m_dependentCount;
+	}
+
+	for(U32 i = 0; i < nodeCount; ++i)
+	{
+		if(dependencyCounts[i])
+		{
+			// Node depends on others, it will wait on its own semaphore. The graph's wait semaphore is implicitly
+			// respected because the root nodes wait on it
+			nodes[i].m_waitSemaphore = m_hive->newSemaphore(dependencyCounts[i]);
+		}
+
+		if(nodes[i].m_dependentCount)
+		{
+			nodes[i].m_dependents = static_cast<Node**>(
+				m_hive->allocateScratchMemory(sizeof(Node*) * nodes[i].m_dependentCount, alignof(Node*)));
+			nodes[i].m_dependentCount = 0;
+		}
+	}
+
+	for(const Dependency& dep : m_dependencies)
+	{
+		Node& producer = nodes[dep.m_dependsOnNode];
+		producer.m_dependents[producer.m_dependentCount++] = &nodes[dep.m_node];
+	}
+
+	// Submit
+	ThreadHiveSemaphore* signalSemaphore = m_hive->newSemaphore(nodeCount);
+
+	DynamicArrayAuto<ThreadHiveTask> tasks(m_nodes.getAllocator(), nodeCount);
+	for(U32 i = 0; i < nodeCount; ++i)
+	{
+		tasks[i].m_callback = runNode;
+		tasks[i].m_argument = &nodes[i];
+		tasks[i].m_waitSemaphore = nodes[i].m_waitSemaphore;
+		tasks[i].m_signalSemaphore = signalSemaphore;
+	}
+
+	m_hive->submitTasks(&tasks[0], nodeCount);
+
+	m_nodes.destroy();
+	m_dependencies.destroy();
+
+	return signalSemaphore;
+}
+
+void ThreadHiveTaskGraph::runNode(void* ud, U32 threadId, ThreadHive& hive,
+								  [[maybe_unused]] ThreadHiveSemaphore* signalSemaphore)
+{
+	const Node& node = *static_cast<const Node*>(ud);
+
+	{
+#if ANKI_ENABLE_TRACE
+		TracerScopedEvent traceEvent(node.m_name);
+#endif
+		node.m_callback(node.m_functor, threadId);
+	}
+
+	// Unblock the dependents
+	for(U32 i = 0; i < node.m_dependentCount; ++i)
+	{
+		hive.signalSemaphore(*node.m_dependents[i]->m_waitSemaphore);
+	}
+}
+
+} // end namespace anki
@@ -0,0 +1,216 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#pragma once
+
+#include <AnKi/Util/ThreadHive.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/String.h>
+#include <type_traits>
+
+namespace anki {
+
+/// @addtogroup util_thread
+/// @{
+
+/// @memberof parallelFor
+template<typename TFunc>
+class ParallelForContext
+{
+public:
+	TFunc m_func;
+	Atomic<U32> m_nextElement = {0};
+	U32 m_elementCount;
+	U32 m_grainSize;
+	U32 m_threadCount;
+
+	ParallelForContext(const TFunc& func, U32 elementCount, U32 grainSize, U32 threadCount)
+		: m_func(func)
+		, m_elementCount(elementCount)
+		, m_grainSize(grainSize)
+		, m_threadCount(threadCount)
+	{
+	}
+
+	/// Grab chunks of elements until there are no more. The chunks get smaller as the work runs out (guided
+	/// scheduling) but never smaller than the grain size.
+	void run(U32 threadId)
+	{
+		U32 begin = m_nextElement.load();
+		while(begin < m_elementCount)
+		{
+			const U32 remaining = m_elementCount - begin;
+			const U32 chunk = min(remaining, max(m_grainSize, remaining / (m_threadCount * 2u)));
+			if(m_nextElement.compareExchange(begin, begin + chunk))
+			{
+				m_func(begin, begin + chunk, threadId);
+				begin = m_nextElement.load();
+			}
+		}
+	}
+
+	static void callback(void* ud, U32 threadId, [[maybe_unused]] ThreadHive& hive,
+						 [[maybe_unused]] ThreadHiveSemaphore* signalSemaphore)
+	{
+		static_cast<ParallelForContext*>(ud)->run(threadId);
+	}
+};
+
+/// Split the range [0, elementCount) in chunks and call func(begin, end, threadId) for each chunk in the ThreadHive
+/// threads. The size of the chunks adapts to the remaining work. It doesn't block, use ThreadHive::waitAllTasks() or
+/// the returned semaphore to wait for completion.
+/// @param hive The hive.
+/// @param elementCount The number of elements.
+/// @param grainSize The minimum number of elements per chunk. If zero ThreadHive::getDefaultGrainSize() will be used.
+/// @param func The functor. It will be copied to the hive's scratch memory so it should be trivially destructible.
+/// @param waitSemaphore Optional semaphore to wait before starting.
+/// @return A semaphore that will be signaled when all elements are processed. Null if elementCount is zero.
+template<typename TFunc>
+ThreadHiveSemaphore* parallelFor(ThreadHive& hive, U32 elementCount, U32 grainSize, const TFunc& func,
+								 ThreadHiveSemaphore* waitSemaphore = nullptr)
+{
+	static_assert(std::is_trivially_destructible<TFunc>::value, "The functor won't be destroyed");
+
+	if(elementCount == 0)
+	{
+		return nullptr;
+	}
+
+	grainSize = (grainSize) ? grainSize : hive.getDefaultGrainSize();
+	const U32 taskCount = min(hive.getThreadCount(), (elementCount + grainSize - 1) / grainSize);
+
+	using Ctx = ParallelForContext<TFunc>;
+	Ctx* ctx = static_cast<Ctx*>(hive.allocateScratchMemory(sizeof(Ctx), alignof(Ctx)));
+	::new(ctx) Ctx(func, elementCount, grainSize, hive.getThreadCount());
+
+	ThreadHiveSemaphore* signalSemaphore = hive.newSemaphore(taskCount);
+
+	Array<ThreadHiveTask, ThreadHive::MAX_THREADS> tasks;
+	for(U32 i = 0; i < taskCount; ++i)
+	{
+		tasks[i].m_callback = Ctx::callback;
+		tasks[i].m_argument = ctx;
+		tasks[i].m_waitSemaphore = waitSemaphore;
+		tasks[i].m_signalSemaphore = signalSemaphore;
+	}
+
+	hive.submitTasks(&tasks[0], taskCount);
+
+	return signalSemaphore;
+}
+
+/// Split the range [0, elementCount) in chunks, call T mapFunc(begin, end, threadId) for each chunk in the ThreadHive
+/// threads and combine the results with T reduceFunc(T, T). It blocks until all the work is done.
+/// @note It calls ThreadHive::waitAllTasks() so it can't be called from a ThreadHive task.
+template<typename T, typename TMapFunc, typename TReduceFunc>
+T parallelReduce(ThreadHive& hive, U32 elementCount, U32 grainSize, const T& identity, const TMapFunc& mapFunc,
+				 const TReduceFunc& reduceFunc)
+{
+	Array<T, ThreadHive::MAX_THREADS> partials;
+	for(T& partial : partials)
+	{
+		partial = identity;
+	}
+
+	// Every thread reduces its own chunks so no need to synchronize
+	T* ppartials = &partials[0];
+	const TMapFunc* pmapFunc = &mapFunc;
+	const TReduceFunc* preduceFunc = &reduceFunc;
+	parallelFor(hive, elementCount, grainSize, [ppartials, pmapFunc, preduceFunc](U32 begin, U32 end, U32 threadId) {
+		ppartials[threadId] = (*preduceFunc)(ppartials[threadId], (*pmapFunc)(begin, end, threadId));
+	});
+
+	hive.waitAllTasks();
+
+	T out = identity;
+	for(U32 i = 0; i < hive.getThreadCount(); ++i)
+	{
+		out = reduceFunc(out, partials[i]);
+	}
+
+	return out;
+}
+
+/// A builder of a graph of ThreadHive tasks. Each node is a functor and nodes can depend on any number of other
+/// nodes. ThreadHiveTask can wait on a single semaphore only so this takes care of the fan-in and fan-out.
+class ThreadHiveTaskGraph
+{
+public:
+	ThreadHiveTaskGraph(ThreadHive& hive, GenericMemoryPoolAllocator<U8> alloc)
+		: m_hive(&hive)
+		, m_nodes(alloc)
+		, m_dependencies(alloc)
+	{
+	}
+
+	ThreadHiveTaskGraph(const ThreadHiveTaskGraph&) = delete; // Non-copyable
+
+	ThreadHiveTaskGraph& operator=(const ThreadHiveTaskGraph&) = delete; // Non-copyable
+
+	/// Create a new node that will call func(threadId).
+	/// @param name A name for debugging and tracing.
+	/// @param func The functor. It will be copied to the hive's scratch memory so it should be trivially destructible.
+	/// @return The index of the node.
+	template<typename TFunc>
+	U32 newNode(CString name, const TFunc& func)
+	{
+		static_assert(std::is_trivially_destructible<TFunc>::value, "The functor won't be destroyed");
+
+		TFunc* funcCopy = static_cast<TFunc*>(m_hive->allocateScratchMemory(sizeof(TFunc), alignof(TFunc)));
+		::new(funcCopy) TFunc(func);
+
+		NodeDescription& node = *m_nodes.emplaceBack();
+		node.m_callback = [](void* functor, U32 threadId) {
+			(*static_cast<TFunc*>(functor))(threadId);
+		};
+		node.m_functor = funcCopy;
+		node.m_name = copyName(name);
+
+		return m_nodes.getSize() - 1;
+	}
+
+	/// Make a node depend on another. The other node should have been created before that node.
+	void addDependency(U32 node, U32 dependsOnNode)
+	{
+		ANKI_ASSERT(node < m_nodes.getSize() && dependsOnNode < node);
+		Dependency& dep = *m_dependencies.emplaceBack();
+		dep.m_node = node;
+		dep.m_dependsOnNode = dependsOnNode;
+	}
+
+	/// Submit all the nodes to the hive. The builder can be destroyed afterwards.
+	/// @param waitSemaphore Optional semaphore that the nodes without dependencies will wait on.
+	/// @return A semaphore that will be signaled when all nodes are done. Null if there are no nodes.
+	ThreadHiveSemaphore* submit(ThreadHiveSemaphore* waitSemaphore = nullptr);
+
+private:
+	class NodeDescription
+	{
+	public:
+		void (*m_callback)(void* functor, U32 threadId);
+		void* m_functor;
+		const char* m_name;
+	};
+
+	class Dependency
+	{
+	public:
+		U32 m_node;
+		U32 m_dependsOnNode;
+	};
+
+	class Node;
+
+	ThreadHive* m_hive;
+	DynamicArrayAuto<NodeDescription> m_nodes;
+	DynamicArrayAuto<Dependency> m_dependencies;
+
+	const char* copyName(CString name);
+
+	static void runNode(void* ud, U32 threadId, ThreadHive& hive, ThreadHiveSemaphore* signalSemaphore);
+};
+/// @}
+
+} // end namespace anki
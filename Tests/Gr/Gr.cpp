@@ -1691,6 +1691,22 @@ ANKI_TEST(Gr, RenderGraph)
 	}
 
 	rgraph->compileNewGraph(descr, alloc);
+
+	// Some transient RTs don't overlap and should share textures
+	RenderGraphStatistics stats;
+	rgraph->getStatistics(stats);
+	ANKI_TEST_EXPECT_GT(stats.m_aliasedRenderTargetMemory, 0);
+	ANKI_TEST_EXPECT_LT(stats.m_aliasedRenderTargetMemory, stats.m_renderTargetMemory);
+	ANKI_TEST_EXPECT_GT(stats.m_primaryCommandBufferCount, 0u);
+
+	// Compile the same graph again. This time the batches come from the cache and the result should be the same
+	rgraph->reset();
+	rgraph->compileNewGraph(descr, alloc);
+	RenderGraphStatistics stats2;
+	rgraph->getStatistics(stats2);
+	ANKI_TEST_EXPECT_EQ(stats2.m_aliasedRenderTargetMemory, stats.m_aliasedRenderTargetMemory);
+	ANKI_TEST_EXPECT_EQ(stats2.m_primaryCommandBufferCount, stats.m_primaryCommandBufferCount);
+	rgraph->reset();
 	COMMON_END()
 }
 
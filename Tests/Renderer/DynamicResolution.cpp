@@ -0,0 +1,61 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <Tests/Framework/Framework.h>
+#include <AnKi/Renderer/DynamicResolution.h>
+
+ANKI_TEST(Renderer, DynamicResolution)
+{
+	// Levels: 0.5, 0.75 and 1.0
+	DynamicResolution dres;
+	dres.init(0.5f, 1.0f, 3, 16.0 / 1000.0);
+	ANKI_TEST_EXPECT_EQ(dres.isEnabled(), true);
+	ANKI_TEST_EXPECT_EQ(dres.getScaling(), 1.0f);
+
+	// Missing GPU times change nothing
+	for(U32 i = 0; i < 100; ++i)
+	{
+		ANKI_TEST_EXPECT_EQ(dres.update(-1.0), false);
+	}
+
+	// Way over the target, it should go to the lowest level in a few frames
+	U32 frames = 0;
+	while(!dres.update(30.0 / 1000.0))
+	{
+		++frames;
+		ANKI_TEST_EXPECT_LEQ(frames, 100);
+	}
+	ANKI_TEST_EXPECT_EQ(dres.getScaling(), 0.5f);
+
+	// Right in the middle, it shouldn't move. The middle level would be 15.75ms which is not enough headroom
+	for(U32 i = 0; i < 200; ++i)
+	{
+		ANKI_TEST_EXPECT_EQ(dres.update(7.0 / 1000.0), false);
+	}
+	ANKI_TEST_EXPECT_EQ(dres.getScaling(), 0.5f);
+
+	// A bit lower, it should go up one level but it needs more frames than going down
+	frames = 0;
+	while(!dres.update(5.0 / 1000.0))
+	{
+		++frames;
+		ANKI_TEST_EXPECT_LEQ(frames, 200);
+	}
+	ANKI_TEST_EXPECT_GEQ(frames, 60);
+	ANKI_TEST_EXPECT_EQ(dres.getScaling(), 0.75f);
+
+	// A single spike shouldn't change it
+	for(U32 i = 0; i < 20; ++i)
+	{
+		ANKI_TEST_EXPECT_EQ(dres.update(((i == 10) ? 40.0 : 11.0) / 1000.0), false);
+	}
+	ANKI_TEST_EXPECT_EQ(dres.getScaling(), 0.75f);
+
+	// Disabled if min and max are the same
+	dres.init(1.0f, 1.0f, 4, 16.0 / 1000.0);
+	ANKI_TEST_EXPECT_EQ(dres.isEnabled(), false);
+	ANKI_TEST_EXPECT_EQ(dres.update(100.0 / 1000.0), false);
+	ANKI_TEST_EXPECT_EQ(dres.getScaling(), 1.0f);
+}
@@ -5,6 +5,7 @@
 
 #include <Tests/Framework/Framework.h>
 #include <AnKi/Resource/AsyncLoader.h>
+#include <AnKi/Resource/ResourceManager.h>
 #include <AnKi/Util/HighRezTimer.h>
 #include <AnKi/Util/Atomic.h>
 #include <AnKi/Util/Functions.h>
@@ -98,8 +99,158 @@ public:
 	}
 };
 
+/// Has what TypeResourceManager needs from a resource.
+class FakeResource
+{
+public:
+	mutable Atomic<I32> m_refcount = {0};
+	Atomic<U32> m_loaded = {0};
+
+	Bool tryRetain() const
+	{
+		I32 count = m_refcount.load();
+		while(count > 0)
+		{
+			if(m_refcount.compareExchange(count, count + 1))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	I32 getRefcount() const
+	{
+		return m_refcount.load();
+	}
+
+	CString getFilename() const
+	{
+		return "fake";
+	}
+};
+
+class FakeResourceManager : public TypeResourceManager<FakeResource>
+{
+public:
+	using TypeResourceManager<FakeResource>::init;
+	using TypeResourceManager<FakeResource>::findLoadedResource;
+	using TypeResourceManager<FakeResource>::registerResource;
+	using TypeResourceManager<FakeResource>::unregisterResource;
+	using TypeResourceManager<FakeResource>::unregisterResourceIfUnused;
+};
+
+/// Loads a FakeResource the way the upload tasks of the resources do.
+class FakeResourceLoadTask : public AsyncLoaderTask
+{
+public:
+	FakeResourceManager* m_manager;
+	FakeResource* m_resource;
+	Atomic<U32>* m_done;
+
+	FakeResourceLoadTask(FakeResourceManager* manager, FakeResource* resource, Atomic<U32>* done)
+		: m_manager(manager)
+		, m_resource(resource)
+		, m_done(done)
+	{
+		m_resource->m_refcount.fetchAdd(1);
+	}
+
+	~FakeResourceLoadTask()
+	{
+		m_resource->m_refcount.fetchSub(1);
+		m_done->store(1);
+	}
+
+	Error operator()([[maybe_unused]] AsyncLoaderTaskContext& ctx) final
+	{
+		m_resource->m_loaded.store(1);
+		return Error::NONE;
+	}
+
+	Bool isCancelled() const final
+	{
+		const Bool cancelled = AsyncLoaderTask::isCancelled() || m_manager->unregisterResourceIfUnused(m_resource);
+		if(cancelled)
+		{
+			// Give the finder a chance to pick up the resource before the task is gone
+			HighRezTimer::sleep(0.001);
+		}
+
+		return cancelled;
+	}
+};
+
+class FakeResourceFinder
+{
+public:
+	FakeResourceManager* m_manager;
+	Atomic<U32>* m_done;
+	FakeResource* m_found = nullptr;
+
+	static Error callback(ThreadCallbackInfo& info)
+	{
+		FakeResourceFinder& self = *static_cast<FakeResourceFinder*>(info.m_userData);
+		while(self.m_done->load() == 0 && self.m_found == nullptr)
+		{
+			self.m_found = self.m_manager->findLoadedResource("fake");
+		}
+
+		return Error::NONE;
+	}
+};
+
 } // namespace
 
+ANKI_TEST(Resource, AsyncLoaderAbandonedResource)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+	AsyncLoader loader;
+	loader.init(alloc);
+	FakeResourceManager manager;
+	manager.init(alloc);
+
+	// The last user reference is dropped while the task is pending and another thread looks for the same resource. If
+	// the other thread finds it the task shouldn't skip the loading
+	for(U32 i = 0; i < 100; ++i)
+	{
+		FakeResource resource;
+		resource.m_refcount.store(1);
+		ANKI_TEST_EXPECT_EQ(manager.registerResource(&resource), nullptr);
+
+		Atomic<U32> done = {0};
+		loader.pause();
+		loader.submitNewTask<FakeResourceLoadTask>(&manager, &resource, &done);
+		resource.m_refcount.fetchSub(1);
+		loader.resume();
+
+		FakeResourceFinder finder;
+		finder.m_manager = &manager;
+		finder.m_done = &done;
+		Thread thread("Finder");
+		thread.start(&finder, FakeResourceFinder::callback);
+
+		ANKI_TEST_EXPECT_NO_ERR(thread.join());
+		while(done.load() == 0)
+		{
+			HighRezTimer::sleep(0.0001);
+		}
+
+		if(finder.m_found)
+		{
+			ANKI_TEST_EXPECT_EQ(finder.m_found, &resource);
+			ANKI_TEST_EXPECT_EQ(resource.m_loaded.load(), 1);
+		}
+		else
+		{
+			ANKI_TEST_EXPECT_EQ(manager.findLoadedResource("fake"), nullptr);
+		}
+
+		manager.unregisterResource(&resource);
+	}
+}
+
 ANKI_TEST(Resource, AsyncLoader)
 {
 	HeapAllocator<U8> alloc(allocAligned, nullptr);
@@ -271,4 +422,59 @@ ANKI_TEST(Resource, AsyncLoader)
 		barrier.wait();
 		ANKI_TEST_EXPECT_EQ(counter.load(), 10);
 	}
+
+	// Priorities
+	{
+		AsyncLoader a;
+		a.init(alloc);
+		Atomic<U32> counter = {0};
+		Barrier barrier(2);
+
+		a.pause();
+		a.submitTask(a.newTask<Task>(0.0f, &barrier, &counter, 2), AsyncLoaderPriority::LOW);
+		a.submitTask(a.newTask<Task>(0.0f, nullptr, &counter, 1), AsyncLoaderPriority::MEDIUM);
+		a.submitTask(a.newTask<Task>(0.0f, nullptr, &counter, 0), AsyncLoaderPriority::HIGH);
+		a.resume();
+
+		barrier.wait();
+		a.pause(); // Wait for the last task to finish
+		ANKI_TEST_EXPECT_EQ(a.getCompletedTaskCount(), 3);
+	}
+
+	// Cancellation
+	{
+		AsyncLoader a;
+		a.init(alloc);
+		Atomic<U32> counter = {0};
+		Barrier barrier(2);
+
+		a.pause();
+		Task* task = a.newTask<Task>(0.0f, nullptr, &counter);
+		a.submitTask(task);
+		task->cancel();
+		a.submitNewTask<Task>(0.0f, &barrier, &counter);
+		a.resume();
+
+		barrier.wait();
+		a.pause();
+		ANKI_TEST_EXPECT_EQ(counter.load(), 1);
+		ANKI_TEST_EXPECT_EQ(a.getCancelledTaskCount(), 1);
+	}
+
+	// Many threads. The tasks will meet at the barrier only if they run in parallel
+	{
+		const U32 THREAD_COUNT = 4;
+		AsyncLoader a;
+		a.init(alloc, THREAD_COUNT);
+		Barrier barrier(THREAD_COUNT + 1);
+		Atomic<U32> counter = {0};
+
+		for(U32 i = 0; i < THREAD_COUNT; ++i)
+		{
+			a.submitNewTask<Task>(0.0f, &barrier, &counter);
+		}
+
+		barrier.wait();
+		ANKI_TEST_EXPECT_EQ(counter.load(), THREAD_COUNT);
+	}
 }
@@ -5,6 +5,8 @@
 
 #include <Tests/Framework/Framework.h>
 #include <AnKi/Resource/ResourceFilesystem.h>
+#include <AnKi/Importer/PakImporter.h>
+#include <AnKi/Util/Filesystem.h>
 
 ANKI_TEST(Resource, ResourceFilesystem)
 {
@@ -20,14 +22,140 @@ ANKI_TEST(Resource, ResourceFilesystem)
 		StringAuto txt(alloc);
 		ANKI_TEST_EXPECT_NO_ERR(file->readAllText(txt));
 		ANKI_TEST_EXPECT_EQ(txt, "hello\n");
+
+		// Loose files are memory mapped
+		ConstWeakArray<U8, PtrSize> contents = file->getContents();
+		ANKI_TEST_EXPECT_EQ(contents.getSize(), 6);
+		ANKI_TEST_EXPECT_EQ(memcmp(contents.getBegin(), "hello\n", 6), 0);
+
+		ANKI_TEST_EXPECT_NO_ERR(file->seek(1, FileSeekOrigin::BEGINNING));
+		ConstWeakArray<U8, PtrSize> inPlace;
+		ANKI_TEST_EXPECT_NO_ERR(file->readInPlace(3, inPlace));
+		ANKI_TEST_EXPECT_EQ(inPlace.getBegin(), contents.getBegin() + 1);
+		ANKI_TEST_EXPECT_EQ(inPlace.getSize(), 3);
+
+		Array<char, 2> buff;
+		ANKI_TEST_EXPECT_NO_ERR(file->read(&buff[0], 2));
+		ANKI_TEST_EXPECT_EQ(buff[0], 'o');
+		ANKI_TEST_EXPECT_ERR(file->read(&buff[0], 2), Error::FILE_ACCESS);
 	}
 
 	{
-		ANKI_TEST_EXPECT_NO_ERR(fs.addNewPath("./Tests/Data/Dir.AnKiZLibip", StringListAuto(alloc)));
+		ANKI_TEST_EXPECT_NO_ERR(fs.addNewPath("./Tests/Data/Dir.ankizip", StringListAuto(alloc)));
 		ResourceFilePtr file;
 		ANKI_TEST_EXPECT_NO_ERR(fs.openFile("subdir0/hello.txt", file));
 		StringAuto txt(alloc);
 		ANKI_TEST_EXPECT_NO_ERR(file->readAllText(txt));
 		ANKI_TEST_EXPECT_EQ(txt, "hell\n");
+
+		// Archived files are read in memory
+		ConstWeakArray<U8, PtrSize> contents;
+		ANKI_TEST_EXPECT_NO_ERR(fs.openFileInMemory("subdir0/hello.txt", file, contents));
+		ANKI_TEST_EXPECT_EQ(contents.getSize(), 5);
+		ANKI_TEST_EXPECT_EQ(memcmp(contents.getBegin(), "hell\n", 5), 0);
+		ANKI_TEST_EXPECT_EQ(file->getContents().getBegin(), contents.getBegin());
+	}
+}
+
+ANKI_TEST(Resource, ResourceFilesystemPak)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+
+	// Create some files. One that compresses well and one that doesn't
+	const CString dir = "./PakTest";
+	if(directoryExists(dir))
+	{
+		ANKI_TEST_EXPECT_NO_ERR(removeDirectory(dir, alloc));
+	}
+	ANKI_TEST_EXPECT_NO_ERR(createDirectory(dir));
+	ANKI_TEST_EXPECT_NO_ERR(createDirectory("./PakTest/subdir"));
+
+	DynamicArrayAuto<U8, PtrSize> text(alloc);
+	for(U32 i = 0; i < 20000; ++i)
+	{
+		for(Char c : CString("Lorem ipsum dolor sit amet. "))
+		{
+			text.emplaceBack(U8(c + (i % 5)));
+		}
+	}
+
+	DynamicArrayAuto<U8, PtrSize> noise(alloc);
+	noise.create(30000);
+	for(U8& b : noise)
+	{
+		b = U8(rand());
 	}
+
+	auto writeFile = [](CString filename, const void* data, PtrSize size) {
+		File file;
+		ANKI_TEST_EXPECT_NO_ERR(file.open(filename, FileOpenFlag::WRITE | FileOpenFlag::BINARY));
+		ANKI_TEST_EXPECT_NO_ERR(file.write(data, size));
+	};
+
+	writeFile("./PakTest/subdir/text.txt", &text[0], text.getSize());
+	writeFile("./PakTest/noise.bin", &noise[0], noise.getSize());
+	writeFile("./PakTest/excluded.txt", "123", 3);
+
+	// Pack them
+	Array<CString, 1> excluded = {"excluded"};
+	PakImporterConfig config;
+	config.m_allocator = alloc;
+	config.m_inputDirectory = dir;
+	config.m_outFilename = "./PakTest.ankipak";
+	config.m_excludedStrings = excluded;
+	config.m_blockSize = 4 * 1024;
+	ANKI_TEST_EXPECT_NO_ERR(importPak(config));
+	ANKI_TEST_EXPECT_NO_ERR(removeDirectory(dir, alloc));
+
+	// Read them
+	{
+		ResourceFilesystem fs(alloc);
+		ANKI_TEST_EXPECT_NO_ERR(fs.addNewPath("./PakTest.ankipak", StringListAuto(alloc)));
+
+		U32 count = 0;
+		ANKI_TEST_EXPECT_NO_ERR(fs.iterateAllFilenames([&](CString) {
+			++count;
+			return Error::NONE;
+		}));
+		ANKI_TEST_EXPECT_EQ(count, 2);
+
+		// Compressed file with random access
+		ResourceFilePtr file;
+		ANKI_TEST_EXPECT_NO_ERR(fs.openFile("subdir/text.txt", file));
+		ANKI_TEST_EXPECT_EQ(file->getSize(), text.getSize());
+		ANKI_TEST_EXPECT_EQ(file->getContents().getSize(), 0);
+
+		DynamicArrayAuto<U8, PtrSize> buff(alloc);
+		buff.create(text.getSize());
+		ANKI_TEST_EXPECT_NO_ERR(file->seek(10000, FileSeekOrigin::BEGINNING));
+		ANKI_TEST_EXPECT_NO_ERR(file->read(&buff[0], 9000));
+		ANKI_TEST_EXPECT_EQ(memcmp(&buff[0], &text[10000], 9000), 0);
+
+		ANKI_TEST_EXPECT_NO_ERR(file->seek(text.getSize() - 5, FileSeekOrigin::BEGINNING));
+		ANKI_TEST_EXPECT_NO_ERR(file->read(&buff[0], 5));
+		ANKI_TEST_EXPECT_EQ(memcmp(&buff[0], &text[text.getSize() - 5], 5), 0);
+		ANKI_TEST_EXPECT_ERR(file->read(&buff[0], 1), Error::FILE_ACCESS);
+
+		ANKI_TEST_EXPECT_NO_ERR(file->seek(0, FileSeekOrigin::BEGINNING));
+		ANKI_TEST_EXPECT_NO_ERR(file->read(&buff[0], text.getSize()));
+		ANKI_TEST_EXPECT_EQ(memcmp(&buff[0], &text[0], text.getSize()), 0);
+
+		ConstWeakArray<U8, PtrSize> contents;
+		ANKI_TEST_EXPECT_NO_ERR(fs.openFileInMemory("subdir/text.txt", file, contents));
+		ANKI_TEST_EXPECT_EQ(contents.getSize(), text.getSize());
+		ANKI_TEST_EXPECT_EQ(memcmp(contents.getBegin(), &text[0], text.getSize()), 0);
+
+		// Uncompressed file is used in place
+		ANKI_TEST_EXPECT_NO_ERR(fs.openFile("noise.bin", file));
+		contents = file->getContents();
+		ANKI_TEST_EXPECT_EQ(contents.getSize(), noise.getSize());
+		ANKI_TEST_EXPECT_EQ(memcmp(contents.getBegin(), &noise[0], noise.getSize()), 0);
+
+		ANKI_TEST_EXPECT_NO_ERR(file->seek(100, FileSeekOrigin::BEGINNING));
+		ConstWeakArray<U8, PtrSize> inPlace;
+		ANKI_TEST_EXPECT_NO_ERR(file->readInPlace(10, inPlace));
+		ANKI_TEST_EXPECT_EQ(inPlace.getBegin(), contents.getBegin() + 100);
+	}
+
+	ANKI_TEST_EXPECT_NO_ERR(removeFile("./PakTest.ankipak"));
 }
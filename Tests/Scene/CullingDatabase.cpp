@@ -0,0 +1,161 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <Tests/Framework/Framework.h>
+#include <AnKi/Scene/CullingDatabase.h>
+#include <AnKi/Collision/Aabb.h>
+#include <AnKi/Collision/Plane.h>
+#include <AnKi/Collision/Functions.h>
+
+ANKI_TEST(Scene, CullingDatabase)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+
+	CullingDatabase db;
+	db.init(alloc);
+
+	// A box frustum from -10 to 10 in all axis. The near plane is the +Z face
+	Array<Plane, U32(FrustumPlaneType::COUNT)> planes;
+	planes[FrustumPlaneType::NEAR] = Plane(Vec4(0.0f, 0.0f, -1.0f, 0.0f), -10.0f);
+	planes[FrustumPlaneType::FAR] = Plane(Vec4(0.0f, 0.0f, 1.0f, 0.0f), -10.0f);
+	planes[FrustumPlaneType::LEFT] = Plane(Vec4(1.0f, 0.0f, 0.0f, 0.0f), -10.0f);
+	planes[FrustumPlaneType::RIGHT] = Plane(Vec4(-1.0f, 0.0f, 0.0f, 0.0f), -10.0f);
+	planes[FrustumPlaneType::BOTTOM] = Plane(Vec4(0.0f, 1.0f, 0.0f, 0.0f), -10.0f);
+	planes[FrustumPlaneType::TOP] = Plane(Vec4(0.0f, -1.0f, 0.0f, 0.0f), -10.0f);
+	const Plane& nearPlane = planes[FrustumPlaneType::NEAR];
+
+	// Another box frustum from 15 to 25 that doesn't overlap with the first
+	Array<Plane, U32(FrustumPlaneType::COUNT)> otherPlanes;
+	otherPlanes[FrustumPlaneType::NEAR] = Plane(Vec4(0.0f, 0.0f, -1.0f, 0.0f), -25.0f);
+	otherPlanes[FrustumPlaneType::FAR] = Plane(Vec4(0.0f, 0.0f, 1.0f, 0.0f), 15.0f);
+	otherPlanes[FrustumPlaneType::LEFT] = Plane(Vec4(1.0f, 0.0f, 0.0f, 0.0f), 15.0f);
+	otherPlanes[FrustumPlaneType::RIGHT] = Plane(Vec4(-1.0f, 0.0f, 0.0f, 0.0f), -25.0f);
+	otherPlanes[FrustumPlaneType::BOTTOM] = Plane(Vec4(0.0f, 1.0f, 0.0f, 0.0f), 15.0f);
+	otherPlanes[FrustumPlaneType::TOP] = Plane(Vec4(0.0f, -1.0f, 0.0f, 0.0f), -25.0f);
+
+	// The DB only stores the spatials, it doesn't touch them
+	Array<U8, 64> fakeSpatials;
+	auto fakeSpatial = [&](U32 i) {
+		return reinterpret_cast<SpatialComponent*>(&fakeSpatials[i]);
+	};
+
+	// Simple
+	{
+		const U32 inside = db.allocateEntry(fakeSpatial(0));
+		db.setEntryAabb(inside, Aabb(Vec3(-1.0f, -1.0f, 0.0f), Vec3(1.0f, 1.0f, 2.0f)));
+		db.setEntryProperties(inside, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS, RenderComponentFlag::NONE,
+							  false, false, true, 1);
+
+		const U32 outside = db.allocateEntry(fakeSpatial(1));
+		db.setEntryAabb(outside, Aabb(Vec3(20.0f), Vec3(21.0f)));
+		db.setEntryProperties(outside, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS,
+							  RenderComponentFlag::NONE, false, false, true, 1);
+
+		const U32 otherTests = db.allocateEntry(fakeSpatial(2));
+		db.setEntryAabb(otherTests, Aabb(Vec3(-1.0f), Vec3(1.0f)));
+		db.setEntryProperties(otherTests, FrustumComponentVisibilityTestFlag::LIGHT_COMPONENTS,
+							  RenderComponentFlag::NONE, false, false, true, 1);
+
+		const U32 alwaysVisible = db.allocateEntry(fakeSpatial(3));
+		db.setEntryAabb(alwaysVisible, Aabb(Vec3(100.0f), Vec3(101.0f)));
+		db.setEntryProperties(alwaysVisible, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS,
+							  RenderComponentFlag::NONE, true, false, true, 1);
+
+		const Array<U32, 4> entries = {alwaysVisible, inside, outside, otherTests};
+		Array<U32, 4> visible;
+		Array<F32, 4> distances;
+		const U32 visibleCount = db.testFrustum(entries, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS,
+												planes, nearPlane, visible, distances);
+
+		ANKI_TEST_EXPECT_EQ(visibleCount, 2);
+		ANKI_TEST_EXPECT_EQ(visible[0], inside);
+		ANKI_TEST_EXPECT_NEAR(distances[0], 8.0f, EPSILON);
+		ANKI_TEST_EXPECT_EQ(visible[1], alwaysVisible);
+		ANKI_TEST_EXPECT_EQ(db.getSpatialComponent(inside), fakeSpatial(0));
+
+		// Free and re-allocate, the entry should be recycled. Only the frustum that contained it should notice
+		db.freeEntry(outside, 10);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(planes), 1);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(otherPlanes), 10);
+		ANKI_TEST_EXPECT_EQ(db.allocateEntry(fakeSpatial(4)), outside);
+		ANKI_TEST_EXPECT_EQ(db.getVisibilityTests(outside), FrustumComponentVisibilityTestFlag::NONE);
+
+		// Static geometry that starts moving
+		db.setEntryProperties(inside, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS, RenderComponentFlag::NONE,
+							  false, false, false, 20);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometry(inside), false);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(planes), 20);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(otherPlanes), 10);
+
+		db.freeEntry(inside, 30);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(planes), 20);
+		db.freeEntry(outside, 30);
+		db.freeEntry(otherTests, 30);
+
+		// Always visible entries have no AABB, all frustums should notice
+		db.freeEntry(alwaysVisible, 30);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(planes), 30);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(otherPlanes), 30);
+
+		// Many removals in the second frustum. The old ones will be merged but they shouldn't leak to the first
+		for(U32 i = 0; i < 100; ++i)
+		{
+			const U32 entry = db.allocateEntry(fakeSpatial(5));
+			db.setEntryProperties(entry, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS,
+								  RenderComponentFlag::NONE, false, false, true, 40 + i);
+			db.setEntryAabb(entry, Aabb(Vec3(20.0f + F32(i % 3)), Vec3(21.0f + F32(i % 3))));
+			db.freeEntry(entry, 40 + i);
+		}
+
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(planes), 30);
+		ANKI_TEST_EXPECT_EQ(db.getStaticGeometryRemovedTimestamp(otherPlanes), 139);
+	}
+
+	// Fuzzy, compare against the scalar tests
+	{
+		constexpr U32 ENTRY_COUNT = 61; // Not a multiple of 4 to test the remainder
+		Array<U32, ENTRY_COUNT> entries;
+		Array<Aabb, ENTRY_COUNT> aabbs;
+		for(U32 i = 0; i < ENTRY_COUNT; ++i)
+		{
+			const Vec3 min(getRandomRange(-15.0f, 15.0f), getRandomRange(-15.0f, 15.0f),
+						   getRandomRange(-15.0f, 15.0f));
+			const Vec3 max = min + Vec3(getRandomRange(0.1f, 5.0f));
+			aabbs[i] = Aabb(min, max);
+
+			entries[i] = db.allocateEntry(fakeSpatial(i));
+			db.setEntryAabb(entries[i], aabbs[i]);
+			db.setEntryProperties(entries[i], FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS,
+								  RenderComponentFlag::NONE, false, false, true, 1);
+		}
+
+		Array<U32, ENTRY_COUNT> visible;
+		Array<F32, ENTRY_COUNT> distances;
+		const U32 visibleCount = db.testFrustum(entries, FrustumComponentVisibilityTestFlag::RENDER_COMPONENTS,
+												planes, nearPlane, visible, distances);
+
+		U32 expectedVisibleCount = 0;
+		for(U32 i = 0; i < ENTRY_COUNT; ++i)
+		{
+			Bool expectedInside = true;
+			for(const Plane& plane : planes)
+			{
+				expectedInside = expectedInside && testPlane(plane, aabbs[i]) >= 0.0f;
+			}
+
+			if(!expectedInside)
+			{
+				continue;
+			}
+
+			ANKI_TEST_EXPECT_EQ(visible[expectedVisibleCount], entries[i]);
+			ANKI_TEST_EXPECT_NEAR(distances[expectedVisibleCount], max(0.0f, testPlane(nearPlane, aabbs[i])),
+								  EPSILON * 10.0f);
+			++expectedVisibleCount;
+		}
+
+		ANKI_TEST_EXPECT_EQ(visibleCount, expectedVisibleCount);
+	}
+}
@@ -82,3 +82,91 @@ ANKI_TEST(Scene, Octree)
 	}
 #endif
 }
+
+ANKI_TEST(Scene, OctreeConcurrentPlace)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+
+	Octree octree(alloc);
+	octree.init(Vec3(-100.0f), Vec3(100.0f), 4);
+
+	constexpr U32 THREAD_COUNT = 4;
+	constexpr U32 PLACEABLES_PER_THREAD = 256;
+	constexpr U32 ITERATION_COUNT = 64;
+
+	class Ctx
+	{
+	public:
+		Octree* m_octree;
+		Array<OctreePlaceable, PLACEABLES_PER_THREAD> m_placeables;
+		U32 m_seed;
+	};
+
+	Array<Ctx, THREAD_COUNT> ctxs;
+	Array<Thread*, THREAD_COUNT> threads;
+	for(U32 t = 0; t < THREAD_COUNT; ++t)
+	{
+		ctxs[t].m_octree = &octree;
+		ctxs[t].m_seed = t + 1;
+		for(OctreePlaceable& placeable : ctxs[t].m_placeables)
+		{
+			placeable.m_userData = &placeable;
+		}
+
+		threads[t] = alloc.newInstance<Thread>("OctreeTest");
+		threads[t]->start(&ctxs[t], [](ThreadCallbackInfo& info) -> Error {
+			Ctx& ctx = *static_cast<Ctx*>(info.m_userData);
+
+			for(U32 it = 0; it < ITERATION_COUNT; ++it)
+			{
+				for(U32 i = 0; i < PLACEABLES_PER_THREAD; ++i)
+				{
+					OctreePlaceable& placeable = ctx.m_placeables[i];
+
+					// Move a little or jump somewhere else
+					ctx.m_seed = ctx.m_seed * 1103515245u + 12345u;
+					const F32 center = F32(((ctx.m_seed >> 8) % 180u) + ((it % 8 == 0) ? 0u : i % 10u)) - 90.0f;
+					const F32 extent = (i % 16 == 0) ? 30.0f : 0.25f;
+					const Aabb volume(Vec3(center - extent), Vec3(center + extent));
+
+					if(i % 32 == 0 && it % 2 == 1 && it + 1 < ITERATION_COUNT)
+					{
+						ctx.m_octree->remove(placeable);
+					}
+					else
+					{
+						ctx.m_octree->place(volume, &placeable, true);
+					}
+				}
+			}
+
+			return Error::NONE;
+		});
+	}
+
+	for(Thread* thread : threads)
+	{
+		ANKI_TEST_EXPECT_NO_ERR(thread->join());
+		alloc.deleteInstance(thread);
+	}
+
+	// All of them should be visible once
+	U32 visibleCount = 0;
+	octree.walkTree(
+		0,
+		[](const Aabb&) {
+			return true;
+		},
+		[&](void*) {
+			++visibleCount;
+		});
+	ANKI_TEST_EXPECT_EQ(visibleCount, THREAD_COUNT * PLACEABLES_PER_THREAD);
+
+	for(Ctx& ctx : ctxs)
+	{
+		for(OctreePlaceable& placeable : ctx.m_placeables)
+		{
+			octree.remove(placeable);
+		}
+	}
+}
@@ -0,0 +1,116 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <Tests/Framework/Framework.h>
+#include <AnKi/Scene/SoftwareRasterizer.h>
+#include <AnKi/Collision/Aabb.h>
+#include <AnKi/Util/ThreadHive.h>
+#include <AnKi/Util/HighRezTimer.h>
+#include <AnKi/Util/System.h>
+
+ANKI_TEST(Scene, SoftwareRasterizer)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+
+	const U32 width = 250;
+	const U32 height = 130;
+	const Mat4 proj = Mat4::calculatePerspectiveProjectionMatrix(toRad(90.0f), toRad(60.0f), 0.1f, 100.0f);
+
+	// A wall that covers the left half of the screen
+	{
+		SoftwareRasterizer r;
+		r.init(alloc);
+		r.prepare(Mat4::getIdentity(), proj, width, height);
+
+		const Array<F32, 18> verts = {-100.0f, -100.0f, -10.0f, 0.0f, -100.0f, -10.0f, 0.0f,    100.0f, -10.0f,
+									  -100.0f, -100.0f, -10.0f, 0.0f, 100.0f,  -10.0f, -100.0f, 100.0f, -10.0f};
+		r.draw(&verts[0], 6, sizeof(F32) * 3, false);
+		r.rasterize();
+
+		// Behind the wall
+		ANKI_TEST_EXPECT_EQ(r.visibilityTest(Aabb(Vec3(-5.0f, -1.0f, -21.0f), Vec3(-3.0f, 1.0f, -20.0f))), false);
+
+		// In front of the wall
+		ANKI_TEST_EXPECT_EQ(r.visibilityTest(Aabb(Vec3(-3.0f, -1.0f, -6.0f), Vec3(-1.0f, 1.0f, -5.0f))), true);
+
+		// Behind the wall but it sticks out to the right half
+		ANKI_TEST_EXPECT_EQ(r.visibilityTest(Aabb(Vec3(-5.0f, -1.0f, -21.0f), Vec3(3.0f, 1.0f, -20.0f))), true);
+
+		// Right half only
+		ANKI_TEST_EXPECT_EQ(r.visibilityTest(Aabb(Vec3(3.0f, -1.0f, -21.0f), Vec3(5.0f, 1.0f, -20.0f))), true);
+	}
+
+	// Bench: serial vs ThreadHive rasterization and visibility tests
+	{
+		const U32 triCount = 20000;
+		DynamicArrayAuto<Vec3> verts(alloc);
+		verts.create(triCount * 3);
+		for(U32 i = 0; i < triCount; ++i)
+		{
+			const Vec3 center(getRandomRange(-40.0f, 40.0f), getRandomRange(-25.0f, 25.0f),
+							  getRandomRange(-90.0f, -10.0f));
+			for(U32 j = 0; j < 3; ++j)
+			{
+				verts[i * 3 + j] =
+					center
+					+ Vec3(getRandomRange(-2.0f, 2.0f), getRandomRange(-2.0f, 2.0f), getRandomRange(-0.5f, 0.5f));
+			}
+		}
+
+		const U32 boxCount = 100000;
+		DynamicArrayAuto<Aabb> boxes(alloc);
+		boxes.create(boxCount);
+		for(Aabb& box : boxes)
+		{
+			const Vec3 center(getRandomRange(-50.0f, 50.0f), getRandomRange(-30.0f, 30.0f),
+							  getRandomRange(-95.0f, -5.0f));
+			const Vec3 extend(getRandomRange(0.1f, 2.0f));
+			box = Aabb(center - extend, center + extend);
+		}
+
+		HighRezTimer timer;
+
+		SoftwareRasterizer serial;
+		serial.init(alloc);
+		serial.prepare(Mat4::getIdentity(), proj, width, height);
+		timer.start();
+		serial.draw(&verts[0][0], verts.getSize(), sizeof(Vec3), false);
+		serial.rasterize();
+		timer.stop();
+		const Second serialTime = timer.getElapsedTime();
+
+		ThreadHive hive(getCpuCoresCount(), alloc);
+		SoftwareRasterizer parallel;
+		parallel.init(alloc);
+		parallel.prepare(Mat4::getIdentity(), proj, width, height);
+		timer.start();
+		parallel.draw(&verts[0][0], verts.getSize(), sizeof(Vec3), false);
+		parallel.rasterize(hive);
+		hive.waitAllTasks();
+		timer.stop();
+		const Second parallelTime = timer.getElapsedTime();
+
+		U32 visibleCount = 0;
+		timer.start();
+		for(const Aabb& box : boxes)
+		{
+			visibleCount += serial.visibilityTest(box);
+		}
+		timer.stop();
+		const Second testTime = timer.getElapsedTime();
+
+		// Both should produce the same depth buffer
+		U32 parallelVisibleCount = 0;
+		for(const Aabb& box : boxes)
+		{
+			parallelVisibleCount += parallel.visibilityTest(box);
+		}
+		ANKI_TEST_EXPECT_EQ(visibleCount, parallelVisibleCount);
+
+		ANKI_TEST_LOGI("Rasterize %u triangles: serial %fms, %u threads %fms. Test %u boxes %fms (%u visible)",
+					   triCount, serialTime * 1000.0, hive.getThreadCount(), parallelTime * 1000.0, boxCount,
+					   testTime * 1000.0, visibleCount);
+	}
+}
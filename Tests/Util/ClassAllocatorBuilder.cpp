@@ -216,3 +216,151 @@ ANKI_TEST(Util, ClassAllocatorBuilder)
 		allocations.clear();
 	}
 }
+
+ANKI_TEST(Util, ClassAllocatorBuilderEvacuation)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+	ClassAllocatorBuilder<Chunk, Interface, Mutex> calloc;
+	calloc.init(alloc);
+
+	// Fill 2 chunks of the 1st class
+	const PtrSize size = 256;
+	const U32 allocsPerChunk = U32(16_KB / size);
+	std::vector<std::pair<Chunk*, PtrSize>> allocations;
+	for(U32 i = 0; i < allocsPerChunk * 2; ++i)
+	{
+		Chunk* chunk;
+		PtrSize offset;
+		ANKI_TEST_EXPECT_NO_ERR(calloc.allocate(size, 1, chunk, offset));
+		allocations.push_back({chunk, offset});
+	}
+
+	Chunk* chunkA = allocations.front().first;
+	Chunk* chunkB = allocations.back().first;
+	ANKI_TEST_EXPECT_NEQ(chunkA, chunkB);
+
+	// Leave a few allocations in B and make some room in A
+	std::vector<std::pair<Chunk*, PtrSize>> allocationsA, allocationsB;
+	for(U32 i = 0; i < allocations.size(); ++i)
+	{
+		const Bool inA = allocations[i].first == chunkA;
+		const U32 idx = i % allocsPerChunk;
+		if((inA && idx < 10) || (!inA && idx >= 3))
+		{
+			calloc.free(allocations[i].first, allocations[i].second);
+		}
+		else
+		{
+			(inA ? allocationsA : allocationsB).push_back(allocations[i]);
+		}
+	}
+
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkA), false);
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), false);
+
+	calloc.updateEvacuation();
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkA), false);
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), true);
+
+	// Move the allocations of B. They should end up in A
+	for(auto& a : allocationsB)
+	{
+		Chunk* chunk;
+		PtrSize offset;
+		ANKI_TEST_EXPECT_NO_ERR(calloc.allocate(size, 1, chunk, offset));
+		ANKI_TEST_EXPECT_EQ(chunk, chunkA);
+		allocationsA.push_back({chunk, offset});
+
+		calloc.free(a.first, a.second);
+	}
+
+	ClassAllocatorBuilderStats stats;
+	calloc.getStats(stats);
+	ANKI_TEST_EXPECT_EQ(stats.m_chunkCount, 1);
+	ANKI_TEST_EXPECT_EQ(stats.m_evacuatingChunkCount, 0);
+	ANKI_TEST_EXPECT_EQ(calloc.getInterface().m_crntSize, 16_KB);
+
+	// A single chunk can't be evacuated
+	calloc.updateEvacuation();
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkA), false);
+
+	for(auto& a : allocationsA)
+	{
+		calloc.free(a.first, a.second);
+	}
+}
+
+ANKI_TEST(Util, ClassAllocatorBuilderEvacuationGiveUp)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+	ClassAllocatorBuilder<Chunk, Interface, Mutex> calloc;
+	calloc.init(alloc);
+	calloc.setEvacuationParameters(0.25f, 4);
+
+	// Fill 2 chunks of the 1st class
+	const PtrSize size = 256;
+	const U32 allocsPerChunk = U32(16_KB / size);
+	std::vector<std::pair<Chunk*, PtrSize>> allocations;
+	for(U32 i = 0; i < allocsPerChunk * 2; ++i)
+	{
+		Chunk* chunk;
+		PtrSize offset;
+		ANKI_TEST_EXPECT_NO_ERR(calloc.allocate(size, 1, chunk, offset));
+		allocations.push_back({chunk, offset});
+	}
+
+	Chunk* chunkA = allocations.front().first;
+	Chunk* chunkB = allocations.back().first;
+
+	auto freeAllocations = [&](U32 keepInA, U32 keepInB) {
+		std::vector<std::pair<Chunk*, PtrSize>> kept;
+		U32 keptInA = 0;
+		U32 keptInB = 0;
+		for(auto& a : allocations)
+		{
+			U32& keptCount = (a.first == chunkA) ? keptInA : keptInB;
+			if(keptCount >= ((a.first == chunkA) ? keepInA : keepInB))
+			{
+				calloc.free(a.first, a.second);
+			}
+			else
+			{
+				++keptCount;
+				kept.push_back(a);
+			}
+		}
+		allocations = kept;
+	};
+
+	// B is too full to be evacuated even if A has room for its suballocations
+	freeAllocations(30, 20);
+	calloc.updateEvacuation();
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkA), false);
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), false);
+
+	// Now it's sparse enough
+	freeAllocations(30, 3);
+	calloc.updateEvacuation();
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), true);
+
+	// Nobody moves the allocations of B so it should give up
+	for(U32 i = 0; i < 4; ++i)
+	{
+		ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), true);
+		calloc.updateEvacuation();
+	}
+	ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), false);
+
+	// And never pick it again
+	for(U32 i = 0; i < 10; ++i)
+	{
+		calloc.updateEvacuation();
+		ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkA), false);
+		ANKI_TEST_EXPECT_EQ(calloc.isEvacuating(chunkB), false);
+	}
+
+	for(auto& a : allocations)
+	{
+		calloc.free(a.first, a.second);
+	}
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <Tests/Framework/Framework.h>
+#include <AnKi/Util/Compression.h>
+#include <AnKi/Util/DynamicArray.h>
+
+using namespace anki;
+
+static void roundTrip(ConstWeakArray<U8, PtrSize> in, HeapAllocator<U8> alloc, PtrSize& compressedSize)
+{
+	DynamicArrayAuto<U8, PtrSize> compressed(alloc);
+	compressed.create(computeCompressedBufferMaxSize(in.getSize()));
+	ANKI_TEST_EXPECT_NO_ERR(compressBuffer(in, WeakArray<U8, PtrSize>(compressed), compressedSize));
+	ANKI_TEST_EXPECT_LEQ(compressedSize, compressed.getSize());
+
+	DynamicArrayAuto<U8, PtrSize> decompressed(alloc);
+	decompressed.create(in.getSize() + 1);
+	ANKI_TEST_EXPECT_NO_ERR(
+		decompressBuffer(ConstWeakArray<U8, PtrSize>(&compressed[0], compressedSize),
+						 WeakArray<U8, PtrSize>((in.getSize()) ? &decompressed[0] : nullptr, in.getSize())));
+
+	if(in.getSize())
+	{
+		ANKI_TEST_EXPECT_EQ(memcmp(&decompressed[0], in.getBegin(), in.getSize()), 0);
+	}
+
+	// Wrong output size should fail
+	ANKI_TEST_EXPECT_ANY_ERR(decompressBuffer(ConstWeakArray<U8, PtrSize>(&compressed[0], compressedSize),
+											  WeakArray<U8, PtrSize>(&decompressed[0], in.getSize() + 1)));
+}
+
+ANKI_TEST(Util, Compression)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+	PtrSize compressedSize;
+
+	// Empty and tiny
+	{
+		roundTrip(ConstWeakArray<U8, PtrSize>(), alloc, compressedSize);
+
+		const CString str = "hello";
+		roundTrip(ConstWeakArray<U8, PtrSize>(reinterpret_cast<const U8*>(str.cstr()), str.getLength()), alloc,
+				  compressedSize);
+	}
+
+	// Runs of the same byte. The matches overlap with the output
+	{
+		DynamicArrayAuto<U8, PtrSize> in(alloc);
+		in.create(100 * 1024, 0xAB);
+		roundTrip(in, alloc, compressedSize);
+		ANKI_TEST_EXPECT_LT(compressedSize, in.getSize() / 100);
+	}
+
+	// Text
+	{
+		DynamicArrayAuto<U8, PtrSize> in(alloc);
+		const CString str = "The quick brown fox jumps over the lazy dog. ";
+		for(U32 i = 0; i < 1000; ++i)
+		{
+			for(Char c : str)
+			{
+				in.emplaceBack(U8(c + (i % 3)));
+			}
+		}
+
+		roundTrip(in, alloc, compressedSize);
+		ANKI_TEST_EXPECT_LT(compressedSize, in.getSize() / 4);
+	}
+
+	// Random data don't compress but they shouldn't grow much either
+	{
+		DynamicArrayAuto<U8, PtrSize> in(alloc);
+		in.create(64 * 1024 + 7);
+		for(U8& b : in)
+		{
+			b = U8(rand());
+		}
+
+		roundTrip(in, alloc, compressedSize);
+		ANKI_TEST_EXPECT_LEQ(compressedSize, computeCompressedBufferMaxSize(in.getSize()));
+	}
+
+	// Corrupted input should fail and not crash
+	{
+		Array<U8, 4> in = {0x0F, 0x01, 0x02, 0x03};
+		Array<U8, 64> out;
+		ANKI_TEST_EXPECT_ANY_ERR(decompressBuffer(in, WeakArray<U8, PtrSize>(&out[0], out.getSize())));
+
+		// Offset pointing before the start of the output
+		Array<U8, 4> in2 = {0x10, 'a', 0x05, 0x00};
+		ANKI_TEST_EXPECT_ANY_ERR(decompressBuffer(in2, WeakArray<U8, PtrSize>(&out[0], out.getSize())));
+	}
+}
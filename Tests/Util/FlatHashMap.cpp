@@ -0,0 +1,238 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <Tests/Framework/Framework.h>
+#include <Tests/Util/Foo.h>
+#include <AnKi/Util/FlatHashMap.h>
+#include <AnKi/Util/DynamicArray.h>
+#include <AnKi/Util/HighRezTimer.h>
+#include <unordered_map>
+#include <algorithm>
+
+using namespace anki;
+
+namespace {
+
+/// A bad hasher that forces collisions.
+class CollidingHasher
+{
+public:
+	U64 operator()(int x) const
+	{
+		return U64(x % 4);
+	}
+};
+
+} // end anonymous namespace
+
+ANKI_TEST(Util, FlatHashMap)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+
+	// Simple
+	{
+		FlatHashMap<int, int> map;
+		map.emplace(alloc, 20, 1);
+		map.emplace(alloc, 21, 2);
+		ANKI_TEST_EXPECT_EQ(map.getSize(), 2);
+		ANKI_TEST_EXPECT_EQ(*map.find(20), 1);
+		ANKI_TEST_EXPECT_EQ(*map.find(21), 2);
+		ANKI_TEST_EXPECT_EQ(map.find(22), map.getEnd());
+
+		// Emplacing an existing key returns the old element
+		auto it = map.emplace(alloc, 20, 100);
+		ANKI_TEST_EXPECT_EQ(*it, 1);
+		ANKI_TEST_EXPECT_EQ(it.getKey(), 20);
+		ANKI_TEST_EXPECT_EQ(map.getSize(), 2);
+
+		map.destroy(alloc);
+	}
+
+	// Collisions are resolved by comparing the keys
+	{
+		FlatHashMap<int, int, CollidingHasher> map;
+		for(int i = 0; i < 100; ++i)
+		{
+			map.emplace(alloc, i, i * 10);
+		}
+
+		for(int i = 0; i < 100; ++i)
+		{
+			auto it = map.find(i);
+			ANKI_TEST_EXPECT_NEQ(it, map.getEnd());
+			ANKI_TEST_EXPECT_EQ(*it, i * 10);
+		}
+
+		for(int i = 0; i < 100; i += 2)
+		{
+			map.erase(alloc, map.find(i));
+		}
+
+		for(int i = 0; i < 100; ++i)
+		{
+			ANKI_TEST_EXPECT_EQ(map.find(i) == map.getEnd(), (i % 2) == 0);
+		}
+
+		map.destroy(alloc);
+	}
+
+	// Heterogeneous lookup
+	{
+		FlatHashMapAuto<StringAuto, int> map(alloc);
+		map.emplace(StringAuto(alloc, "hello"), 1);
+		map.emplace(StringAuto(alloc, "world"), 2);
+
+		ANKI_TEST_EXPECT_EQ(*map.find(CString("hello")), 1);
+		ANKI_TEST_EXPECT_EQ(*map.find(CString("world")), 2);
+		ANKI_TEST_EXPECT_EQ(map.find(CString("hell")), map.getEnd());
+		ANKI_TEST_EXPECT_EQ(*map.find(StringAuto(alloc, "world")), 2);
+	}
+
+	// Constructors and destructors
+	{
+		Foo::constructorCallCount = 0;
+		Foo::destructorCallCount = 0;
+
+		FlatHashMap<int, Foo> map;
+		for(int i = 0; i < 1000; ++i)
+		{
+			map.emplace(alloc, i, i);
+		}
+
+		for(int i = 0; i < 500; ++i)
+		{
+			map.erase(alloc, map.find(i));
+		}
+
+		U32 count = 0;
+		for(auto it = map.getBegin(); it != map.getEnd(); ++it)
+		{
+			ANKI_TEST_EXPECT_EQ(it->x, it.getKey());
+			++count;
+		}
+		ANKI_TEST_EXPECT_EQ(count, 500);
+
+		map.destroy(alloc);
+		ANKI_TEST_EXPECT_EQ(Foo::constructorCallCount, Foo::destructorCallCount);
+	}
+
+	// Fuzzy test
+	{
+		const U MAX = 10000;
+		FlatHashMap<int, int> akMap;
+		std::unordered_map<int, int> stdMap;
+
+		for(U i = 0; i < MAX * 4; ++i)
+		{
+			const int num = rand() % MAX;
+			if(rand() % 3 == 0)
+			{
+				auto it = akMap.find(num);
+				ANKI_TEST_EXPECT_EQ(it != akMap.getEnd(), stdMap.find(num) != stdMap.end());
+				if(it != akMap.getEnd())
+				{
+					akMap.erase(alloc, it);
+					stdMap.erase(num);
+				}
+			}
+			else
+			{
+				akMap.emplace(alloc, num, num);
+				stdMap[num] = num;
+			}
+
+			ANKI_TEST_EXPECT_EQ(akMap.getSize(), stdMap.size());
+		}
+
+		for(auto it = akMap.getBegin(); it != akMap.getEnd(); ++it)
+		{
+			ANKI_TEST_EXPECT_NEQ(stdMap.find(it.getKey()), stdMap.end());
+		}
+
+		akMap.destroy(alloc);
+	}
+
+	// Bench it
+	{
+		FlatHashMap<int, int> akMap;
+		HashMap<I64, int> oldMap;
+		std::unordered_map<int, int> stdMap;
+
+		HighRezTimer timer;
+
+		const U32 COUNT = 1024 * 1024;
+		DynamicArrayAuto<int> vals(alloc);
+		vals.create(COUNT);
+		for(U32 i = 0; i < COUNT; ++i)
+		{
+			vals[i] = int(i);
+		}
+		randomShuffle(vals.begin(), vals.end());
+
+		// Insertion
+		{
+			timer.start();
+			for(U32 i = 0; i < COUNT; ++i)
+			{
+				akMap.emplace(alloc, vals[i], vals[i]);
+			}
+			timer.stop();
+			const Second akTime = timer.getElapsedTime();
+
+			timer.start();
+			for(U32 i = 0; i < COUNT; ++i)
+			{
+				oldMap.emplace(alloc, vals[i], vals[i]);
+			}
+			timer.stop();
+			const Second oldTime = timer.getElapsedTime();
+
+			timer.start();
+			for(U32 i = 0; i < COUNT; ++i)
+			{
+				stdMap[vals[i]] = vals[i];
+			}
+			timer.stop();
+			const Second stlTime = timer.getElapsedTime();
+
+			ANKI_TEST_LOGI("Inserting bench: STL %f HashMap %f FlatHashMap %f", stlTime, oldTime, akTime);
+		}
+
+		// Search
+		{
+			I64 count = 0; // To avoid compiler opts
+			randomShuffle(vals.begin(), vals.end());
+
+			timer.start();
+			for(U32 i = 0; i < COUNT; ++i)
+			{
+				count += *akMap.find(vals[i]);
+			}
+			timer.stop();
+			const Second akTime = timer.getElapsedTime();
+
+			timer.start();
+			for(U32 i = 0; i < COUNT; ++i)
+			{
+				count += *oldMap.find(vals[i]);
+			}
+			timer.stop();
+			const Second oldTime = timer.getElapsedTime();
+
+			timer.start();
+			for(U32 i = 0; i < COUNT; ++i)
+			{
+				count += stdMap.find(vals[i])->second;
+			}
+			timer.stop();
+			const Second stlTime = timer.getElapsedTime();
+
+			ANKI_TEST_LOGI("Find bench: STL %f HashMap %f FlatHashMap %f (%ld)", stlTime, oldTime, akTime, count);
+		}
+
+		akMap.destroy(alloc);
+		oldMap.destroy(alloc);
+	}
+}
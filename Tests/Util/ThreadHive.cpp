@@ -131,6 +131,36 @@ ANKI_TEST(Util, ThreadHive)
 		ANKI_TEST_EXPECT_EQ(ctx.m_countAtomic.getNonAtomically(), DEP_TASKS * 2 + 10);
 	}
 
+	// Chain test. Every task waits on the previous one
+	if(1)
+	{
+		ThreadHiveTestContext ctx;
+		ctx.m_count = 0;
+
+		const U CHAIN_LENGTH = 1000;
+		ThreadHiveSemaphore* sem = nullptr;
+		for(U i = 0; i < CHAIN_LENGTH; ++i)
+		{
+			ThreadHiveTask task;
+			task.m_callback = [](void* arg, [[maybe_unused]] U32 threadId, [[maybe_unused]] ThreadHive& hive,
+								 [[maybe_unused]] ThreadHiveSemaphore* sem) {
+				ThreadHiveTestContext* ctx = static_cast<ThreadHiveTestContext*>(arg);
+				++ctx->m_count;
+			};
+			task.m_argument = &ctx;
+			task.m_waitSemaphore = sem;
+			task.m_signalSemaphore = hive.newSemaphore(1);
+
+			hive.submitTasks(&task, 1);
+
+			sem = task.m_signalSemaphore;
+		}
+
+		hive.waitAllTasks();
+
+		ANKI_TEST_EXPECT_EQ(ctx.m_count, I32(CHAIN_LENGTH));
+	}
+
 	// Fuzzy test
 	if(1)
 	{
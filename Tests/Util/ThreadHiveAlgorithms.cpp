@@ -0,0 +1,87 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <Tests/Framework/Framework.h>
+#include <AnKi/Util/ThreadHiveAlgorithms.h>
+
+using namespace anki;
+
+ANKI_TEST(Util, ParallelFor)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+	ThreadHive hive(8, alloc);
+
+	const U32 count = 10000;
+	DynamicArrayAuto<U32> visited(alloc, count, 0);
+	U32* pvisited = visited.getBegin();
+
+	parallelFor(hive, count, 16, [pvisited](U32 begin, U32 end, [[maybe_unused]] U32 threadId) {
+		for(U32 i = begin; i < end; ++i)
+		{
+			++pvisited[i];
+		}
+	});
+	hive.waitAllTasks();
+
+	for(U32 i = 0; i < count; ++i)
+	{
+		ANKI_TEST_EXPECT_EQ(visited[i], 1);
+	}
+
+	const U64 sum = parallelReduce(
+		hive, count, 0, U64(0),
+		[](U32 begin, U32 end, [[maybe_unused]] U32 threadId) {
+			U64 s = 0;
+			for(U32 i = begin; i < end; ++i)
+			{
+				s += i;
+			}
+			return s;
+		},
+		[](U64 a, U64 b) {
+			return a + b;
+		});
+
+	ANKI_TEST_EXPECT_EQ(sum, U64(count) * (count - 1) / 2);
+}
+
+ANKI_TEST(Util, ThreadHiveTaskGraph)
+{
+	HeapAllocator<U8> alloc(allocAligned, nullptr);
+	ThreadHive hive(8, alloc);
+
+	// Diamond: a -> (b, c) -> d
+	Atomic<U32> order = {0};
+	Array<U32, 4> finished = {};
+	Atomic<U32>* porder = &order;
+	U32* pfinished = &finished[0];
+
+	ThreadHiveTaskGraph graph(hive, alloc);
+	const U32 a = graph.newNode("a", [porder, pfinished]([[maybe_unused]] U32 threadId) {
+		pfinished[0] = porder->fetchAdd(1);
+	});
+	const U32 b = graph.newNode("b", [porder, pfinished]([[maybe_unused]] U32 threadId) {
+		pfinished[1] = porder->fetchAdd(1);
+	});
+	const U32 c = graph.newNode("c", [porder, pfinished]([[maybe_unused]] U32 threadId) {
+		pfinished[2] = porder->fetchAdd(1);
+	});
+	const U32 d = graph.newNode("d", [porder, pfinished]([[maybe_unused]] U32 threadId) {
+		pfinished[3] = porder->fetchAdd(1);
+	});
+	graph.addDependency(b, a);
+	graph.addDependency(c, a);
+	graph.addDependency(d, b);
+	graph.addDependency(d, c);
+
+	ThreadHiveSemaphore* sem = graph.submit();
+	ANKI_TEST_EXPECT_NEQ(sem, nullptr);
+	hive.waitAllTasks();
+
+	ANKI_TEST_EXPECT_EQ(finished[0], 0);
+	ANKI_TEST_EXPECT_LEQ(finished[1], 2);
+	ANKI_TEST_EXPECT_LEQ(finished[2], 2);
+	ANKI_TEST_EXPECT_EQ(finished[3], 3);
+}
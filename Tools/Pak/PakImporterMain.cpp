@@ -0,0 +1,141 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/Importer/PakImporter.h>
+#include <AnKi/Util/DynamicArray.h>
+
+using namespace anki;
+
+namespace {
+
+class Cleanup
+{
+public:
+	HeapAllocator<U8> m_alloc{allocAligned, nullptr};
+	DynamicArrayAuto<CString> m_excludedStrings{m_alloc};
+	StringAuto m_outFilename{m_alloc};
+	StringAuto m_inputDirectory{m_alloc};
+};
+
+} // namespace
+
+static const char* USAGE = R"(Usage: %s [options] in_directory
+Options:
+-o <filename>          : Output filename. Should have the .ankipak extension
+-x <string>            : Exclude the files that contain that string. Can be used more than once
+-block-size <KB>       : The size of the compression blocks in KB. Default is 64
+-no-compress           : Store everything uncompressed
+-v                     : Verbose log
+)";
+
+static Error parseCommandLineArgs(int argc, char** argv, PakImporterConfig& config, Cleanup& cleanup)
+{
+	// Parse config
+	if(argc < 2)
+	{
+		// Need at least 1 input
+		return Error::USER_DATA;
+	}
+
+	I i;
+	for(i = 1; i < argc; i++)
+	{
+		CString arg = argv[i];
+
+		if(arg == "-o")
+		{
+			++i;
+			if(i >= argc)
+			{
+				return Error::USER_DATA;
+			}
+
+			cleanup.m_outFilename = argv[i];
+		}
+		else if(arg == "-x")
+		{
+			++i;
+			if(i >= argc)
+			{
+				return Error::USER_DATA;
+			}
+
+			cleanup.m_excludedStrings.emplaceBack(argv[i]);
+		}
+		else if(arg == "-block-size")
+		{
+			++i;
+			if(i >= argc)
+			{
+				return Error::USER_DATA;
+			}
+
+			U32 kb;
+			ANKI_CHECK(CString(argv[i]).toNumber(kb));
+			if(kb == 0 || kb > 16 * 1024)
+			{
+				return Error::USER_DATA;
+			}
+
+			config.m_blockSize = kb * 1024;
+		}
+		else if(arg == "-no-compress")
+		{
+			config.m_compress = false;
+		}
+		else if(arg == "-v")
+		{
+			LoggerSingleton::get().enableVerbosity(true);
+		}
+		else
+		{
+			// Probably input, break
+			break;
+		}
+	}
+
+	// Input
+	if(i != argc - 1)
+	{
+		return Error::USER_DATA;
+	}
+
+	cleanup.m_inputDirectory = argv[i];
+
+	if(cleanup.m_outFilename.getLength() == 0)
+	{
+		return Error::USER_DATA;
+	}
+
+	config.m_inputDirectory = cleanup.m_inputDirectory;
+	config.m_outFilename = cleanup.m_outFilename;
+	config.m_excludedStrings = ConstWeakArray<CString>(cleanup.m_excludedStrings);
+
+	return Error::NONE;
+}
+
+int main(int argc, char** argv)
+{
+	PakImporterConfig config;
+	Cleanup cleanup;
+	config.m_allocator = cleanup.m_alloc;
+	if(parseCommandLineArgs(argc, argv, config, cleanup))
+	{
+		ANKI_IMPORTER_LOGE(USAGE, argv[0]);
+		return 1;
+	}
+
+	ANKI_IMPORTER_LOGI("Packing started: %s", config.m_outFilename.cstr());
+
+	if(importPak(config))
+	{
+		ANKI_IMPORTER_LOGE("Packing failed");
+		return 1;
+	}
+
+	ANKI_IMPORTER_LOGI("Packing completed: %s", config.m_outFilename.cstr());
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+// Copyright (C) 2009-2022, Panagiotis Christopoulos Charitos and contributors.
+// All rights reserved.
+// Code licensed under the BSD License.
+// http://www.anki3d.org/LICENSE
+
+#include <AnKi/AnKi.h>
+
+using namespace anki;
+
+static const char* USAGE = R"(Bake the static reflection and GI probes of a scene
+Usage: %s scene_script output_directory [config arguments]
+The probes are written to output_directory/<baked image filename of the probe>. The engine loads them from the
+RsrcDataPaths so output_directory should be one of the data paths of the game (or copy the files to one of them)
+)";
+
+/// Loads a scene, visits every static probe that has a baked image filename and waits until the renderer stores it.
+class MyApp : public App
+{
+public:
+	class Probe
+	{
+	public:
+		Vec3 m_position;
+		String m_filename;
+	};
+
+	HeapAllocator<U8> m_alloc = {allocAligned, nullptr};
+	DynamicArrayAuto<Probe> m_probes = {m_alloc};
+	U32 m_crntProbe = 0;
+	U32 m_crntProbeFrameCount = 0;
+	String m_outDir;
+
+	static constexpr U32 MAX_FRAMES_PER_PROBE = 10000;
+
+	~MyApp()
+	{
+		for(Probe& probe : m_probes)
+		{
+			probe.m_filename.destroy(m_alloc);
+		}
+
+		m_outDir.destroy(m_alloc);
+	}
+
+	Error init(ConfigSet* config, int argc, char** argv)
+	{
+		if(argc < 3)
+		{
+			ANKI_LOGE(USAGE, argv[0]);
+			return Error::USER_DATA;
+		}
+
+		HeapAllocator<U8> alloc = m_alloc;
+		StringAuto mainDataPath(alloc, ANKI_SOURCE_DIRECTORY);
+
+		config->setWindowFullscreen(false);
+		config->setRsrcDataPaths(mainDataPath);
+		ANKI_CHECK(config->setFromCommandLineArguments(argc - 3, argv + 3));
+		config->setRProbeBakeDirectory(argv[2]);
+		m_outDir.create(alloc, argv[2]);
+
+		ANKI_CHECK(App::init(config, allocAligned, nullptr));
+
+		// Load the scene
+		ScriptResourcePtr script;
+		ANKI_CHECK(getResourceManager().loadResource(argv[1], script));
+		ANKI_CHECK(getScriptManager().evalString(script->getSource()));
+
+		// Gather the probes to bake
+		ANKI_CHECK(getSceneGraph().iterateSceneNodes([&](SceneNode& node) {
+			const ReflectionProbeComponent* reflComp = node.tryGetFirstComponentOfType<ReflectionProbeComponent>();
+			if(reflComp && !reflComp->getDynamic() && !reflComp->getBakedImageFilename().isEmpty())
+			{
+				Probe& probe = *m_probes.emplaceBack();
+				probe.m_position = reflComp->getWorldPosition();
+				probe.m_filename.create(alloc, reflComp->getBakedImageFilename());
+			}
+
+			const GlobalIlluminationProbeComponent* giComp =
+				node.tryGetFirstComponentOfType<GlobalIlluminationProbeComponent>();
+			if(giComp && !giComp->getDynamic() && !giComp->getBakedImageFilename().isEmpty())
+			{
+				Probe& probe = *m_probes.emplaceBack();
+				const Aabb box = giComp->getAabbWorldSpace();
+				probe.m_position = ((box.getMin() + box.getMax()) / 2.0f).xyz();
+				probe.m_filename.create(alloc, giComp->getBakedImageFilename());
+			}
+
+			return Error::NONE;
+		}));
+
+		ANKI_LOGI("Will bake %u probes", m_probes.getSize());
+
+		return Error::NONE;
+	}
+
+	Error userMainLoop(Bool& quit, [[maybe_unused]] Second elapsedTime) override
+	{
+		const ProbeBaker& baker = getMainRenderer().getOffscreenRenderer().getProbeBaker();
+
+		if(m_crntProbe >= m_probes.getSize())
+		{
+			// All probes are rendered, wait for the GPU to finish with the last of them
+			quit = baker.getPendingReadbackCount() == 0;
+			return Error::NONE;
+		}
+
+		const Probe& probe = m_probes[m_crntProbe];
+
+		StringAuto fname(m_alloc);
+		fname.sprintf("%s/%s", m_outDir.cstr(), probe.m_filename.cstr());
+		if(fileExists(fname))
+		{
+			// Done, move to the next
+			++m_crntProbe;
+			m_crntProbeFrameCount = 0;
+			return Error::NONE;
+		}
+
+		if(m_crntProbeFrameCount == MAX_FRAMES_PER_PROBE)
+		{
+			ANKI_LOGE("Probe wasn't baked after %u frames: %s", MAX_FRAMES_PER_PROBE, probe.m_filename.cstr());
+			return Error::FUNCTION_FAILED;
+		}
+
+		// Move the camera inside the probe to have it visible
+		if(m_crntProbeFrameCount == 0)
+		{
+			getSceneGraph().getActiveCameraNode().getFirstComponentOfType<MoveComponent>().setLocalOrigin(
+				probe.m_position.xyz0());
+		}
+
+		++m_crntProbeFrameCount;
+		return Error::NONE;
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	Error err = Error::NONE;
+
+	ConfigSet config(allocAligned, nullptr);
+	MyApp* app = new MyApp;
+	err = app->init(&config, argc, argv);
+	if(!err)
+	{
+		err = app->mainLoop();
+	}
+
+	delete app;
+	if(err)
+	{
+		ANKI_LOGE("Error reported. Bye!!");
+		return 1;
+	}
+
+	ANKI_LOGI("Bye!!");
+	return 0;
+}